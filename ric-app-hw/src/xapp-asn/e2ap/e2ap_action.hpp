@@ -77,7 +77,7 @@ public:
 					 mdclog_write(MDCLOG_ERR, "Error during encode: %s",e2smObj.get_error());
 
 				 } else {
-					 mdclog_write(MDCLOG_INFO, "Successfully encoded: %s","RIC Action Definition");
+					 mdclog_write(MDCLOG_DEBUG, "Successfully encoded: %s","RIC Action Definition");
 				 }
 				 this->is_ricActionDefinition = true;
 				 return *this;
@@ -89,7 +89,7 @@ public:
 	    			mdclog_write(MDCLOG_ERR, "Failed to encode: %s","RIC Control Header");
 	    			mdclog_write(MDCLOG_ERR, "Error during encode: %s",headerObj.get_error());
 	    	} else {
-	    			mdclog_write(MDCLOG_INFO, "Successfully encoded: %s","RIC Control Header");
+	    			mdclog_write(MDCLOG_DEBUG, "Successfully encoded: %s","RIC Control Header");
 	    	}
 
 	        return *this;
@@ -100,7 +100,7 @@ public:
 	    		     mdclog_write(MDCLOG_ERR, "Failed to encode: %s","RIC Control Message");
 	    		     mdclog_write(MDCLOG_ERR, "Error during encode: %s",msgObj.get_error());
 	    		} else {
-	    		     mdclog_write(MDCLOG_INFO, "Successfully encoded: %s","RIC Control Message");
+	    		     mdclog_write(MDCLOG_DEBUG, "Successfully encoded: %s","RIC Control Message");
 	    	}
 	    		return *this;
 	    }
@@ -204,7 +204,8 @@ bool E2APControlMessage<T1,T2>::encode(unsigned char *buf, size_t *size){
     return false;
   }
 
-  xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
 
   asn_enc_rval_t retval = asn_encode_to_buffer(0, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj, buf, *size);
 
@@ -125,7 +125,8 @@ bool E2APControlAcknowledge::encode(unsigned char *buf, size_t *size){
 	}
 
 	*size = retval.encoded;
-	xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
+	if(mdclog_level_get() >= MDCLOG_DEBUG)
+		xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
 
 	return true;
 
@@ -212,7 +213,7 @@ bool E2APControlAcknowledge::decode(unsigned char *buf, size_t *size)
 				 mdclog_write(MDCLOG_ERR, "Failed to decode: %s","RIC Control Ack Message");
 				 return false;
 	} else {
-				 mdclog_write(MDCLOG_INFO, "Successfully decoded: %s","RIC Control Ack Message");
+				 mdclog_write(MDCLOG_DEBUG, "Successfully decoded: %s","RIC Control Ack Message");
 	}
 
 	  _successMsg = _e2ap_pdu_obj->choice.successfulOutcome;
@@ -65,6 +65,7 @@ RICindication-IEs E2AP-PROTOCOL-IES ::= {
 #include <mdclog/mdclog.h>
 #include <sstream>
 #include <memory>
+#include <algorithm>
 
 #include "e2ap_consts.hpp"
 
@@ -105,38 +106,42 @@ public:
 			bool get_is_ricIndicationSN(){return this->is_ricIndicationSN;};
 			bool get_is_callProcessID(){return this->is_callProcessID;};
 
-			IndicationIEs& set_ricIndicationHeader(E2SMIndicationHeader e2smObj){
+			IndicationIEs& set_ricIndicationHeader(E2SMIndicationHeader &e2smObj){
 				bool res = e2smObj.encode(&(this->ricIndicationHeader)[0],&this->ricIndicationHeader_size);
 				if(!res){
 						mdclog_write(MDCLOG_ERR, "Failed to encode: %s","RIC Indication Header");
 						mdclog_write(MDCLOG_ERR, "Error during encode: %s",e2smObj.get_error());
 
 					} else {
-						 mdclog_write(MDCLOG_INFO, "Successfully encoded: %s","RIC Indication Header");
+						 mdclog_write(MDCLOG_DEBUG, "Successfully encoded: %s","RIC Indication Header");
 				}
 					return *this;
 			}
-			IndicationIEs& set_ricIndicationMessage(E2SMIndicationMessage e2smObj){
+			IndicationIEs& set_ricIndicationMessage(E2SMIndicationMessage &e2smObj){
 				bool res = e2smObj.encode(&(this->ricIndicationMessage)[0],&this->ricIndicationMessage_size);
 				if(!res){
 							mdclog_write(MDCLOG_ERR, "Failed to encode: %s","RIC Indication Message");
 							mdclog_write(MDCLOG_ERR, "Error during encode: %s",e2smObj.get_error());
 						} else {
-   						    mdclog_write(MDCLOG_INFO, "Successfully encoded: %s","RIC Indication Message");
+   						    mdclog_write(MDCLOG_DEBUG, "Successfully encoded: %s","RIC Indication Message");
 						}
 
 				return *this;
 
 			}
 
+			//octet strings longer than IE_SIZE are cut short rather than overrunning the buffers.
 			IndicationIEs& set_ricIndicationHeader(unsigned char* header, size_t header_size){
+							header_size = std::min(header_size, sizeof(ricIndicationHeader));
 							memcpy(ricIndicationHeader,header,header_size); ricIndicationHeader_size = header_size; return *this;
 						}
 			IndicationIEs& set_ricIndicationMessage(unsigned char* message, size_t message_size){
-							memcpy(ricIndicationHeader,message,message_size); ricIndicationMessage_size = message_size; return *this;}
+							message_size = std::min(message_size, sizeof(ricIndicationMessage));
+							memcpy(ricIndicationMessage,message,message_size); ricIndicationMessage_size = message_size; return *this;}
 
 			IndicationIEs& set_ricCallProcessID(unsigned char* callproc, size_t callproc_size){
 				is_callProcessID = true;
+				callproc_size = std::min(callproc_size, sizeof(ricCallProcessId));
 				memcpy(ricCallProcessId, callproc, callproc_size); ricCallProcessId_size = callproc_size;
 				return *this;
 			}
@@ -213,6 +218,13 @@ template<typename T1, typename T2>
 E2APIndication<T1,T2>::~E2APIndication(void){
 
   mdclog_write(MDCLOG_DEBUG, "Freeing E2AP Indication object memory");
+
+  //a decoded PDU belongs to the asn1c decoder as a whole.
+  if(IE_array == 0){
+    ASN_STRUCT_FREE(asn_DEF_E2AP_PDU, e2ap_pdu_obj);
+    return;
+  }
+
   RICindication_t *ricIndication  = &(initMsg->value.choice.RICindication);
   for(int i = 0; i < ricIndication->protocolIEs.list.size; i++){
     ricIndication->protocolIEs.list.array[i] = 0;
@@ -226,6 +238,8 @@ E2APIndication<T1,T2>::~E2APIndication(void){
 
   free(IE_array);
   free(initMsg);
+  e2ap_pdu_obj->choice.initiatingMessage = 0;
+
   ASN_STRUCT_FREE(asn_DEF_E2AP_PDU, e2ap_pdu_obj);
   mdclog_write(MDCLOG_DEBUG, "Freed E2AP Indication object memory");
 }
@@ -233,13 +247,20 @@ E2APIndication<T1,T2>::~E2APIndication(void){
 template<typename T1, typename T2>
 bool E2APIndication<T1, T2>::decode(unsigned char *buf, size_t *size)
 {
+	//the same object can decode one indication after another: the previous PDU is
+	//released but its top level structure is kept for the decoder to fill again.
+	if(IE_array == 0 && e2ap_pdu_obj != 0){
+		ASN_STRUCT_RESET(asn_DEF_E2AP_PDU, e2ap_pdu_obj);
+		*_indicationIEs = IndicationIEs();
+		initMsg = 0;
+	}
 
 	asn_dec_rval_t dec_res  = asn_decode(0,ATS_ALIGNED_BASIC_PER, &asn_DEF_E2AP_PDU, (void**)&(e2ap_pdu_obj), buf, *size);
 	if(dec_res.code != RC_OK){
 			 mdclog_write(MDCLOG_ERR, "Failed to decode: %s","RIC Indication Message");
 			 return false;
 	} else {
-			 mdclog_write(MDCLOG_INFO, "Successfully decoded: %s","RIC Indication Message");
+			 mdclog_write(MDCLOG_DEBUG, "Successfully decoded: %s","RIC Indication Message");
 	}
 
   initMsg = e2ap_pdu_obj->choice.initiatingMessage;
@@ -335,7 +356,8 @@ bool E2APIndication<T1,T2>::encode(unsigned char *buf, size_t *size){
   }
 
   *size = retval.encoded;
-  xer_fprint(stdout, &asn_DEF_E2AP_PDU, e2ap_pdu_obj);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2AP_PDU, e2ap_pdu_obj);
 
   return true;
 
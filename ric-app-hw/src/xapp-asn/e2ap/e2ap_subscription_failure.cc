@@ -111,7 +111,8 @@ bool E2APSubscriptionFailure::encode(unsigned char *buf, size_t *size){
   }
 
   *size = res.encoded;
-  xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
   return true;
 
 }
@@ -278,7 +279,7 @@ bool E2APSubscriptionFailure::decode(unsigned char *buf, size_t *size)
 			return false;
 	} else {
 
-		mdclog_write(MDCLOG_INFO, "Successfully decoded: %s","RIC Subscription Failure");
+		mdclog_write(MDCLOG_DEBUG, "Successfully decoded: %s","RIC Subscription Failure");
 	}
 
 	 _unsuccessMsg = _e2ap_pdu_obj->choice.unsuccessfulOutcome;
@@ -81,7 +81,7 @@ public:
 						mdclog_write(MDCLOG_ERR, "Failed to encode: %s","RIC Event Trigger Definition");
 						mdclog_write(MDCLOG_ERR, "Error during encode: %s",eventObj.get_error());
 					} else {
-						mdclog_write(MDCLOG_INFO, "Successfully encoded: %s of size: %d","RIC Event Trigger Definition",ricEventTriggerDefinition_size);
+						mdclog_write(MDCLOG_DEBUG, "Successfully encoded: %s of size: %d","RIC Event Trigger Definition",ricEventTriggerDefinition_size);
 					}
 
 		    return *this;
@@ -248,7 +248,8 @@ bool E2APSubscriptionRequest<T1,T2>::encode(unsigned char *buf, size_t *size){
   }
 
   *size = retval.encoded;
-  xer_fprint(stdout, &asn_DEF_E2AP_PDU, e2ap_pdu_obj);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2AP_PDU, e2ap_pdu_obj);
 
   return true;
 
@@ -113,7 +113,8 @@ bool E2APSubscriptionResponse::encode(unsigned char *buf, size_t *size){
   }
 
   *size = res.encoded;
-  xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
   return true;
 
 }
@@ -261,7 +262,7 @@ bool E2APSubscriptionResponse:: decode(unsigned char *buf, size_t *size)
 			return false;
 	} else {
 
-		mdclog_write(MDCLOG_INFO, "Successfully decoded: %s","RIC Subscription Response");
+		mdclog_write(MDCLOG_DEBUG, "Successfully decoded: %s","RIC Subscription Response");
 	}
 
 	 _successMsg = _e2ap_pdu_obj->choice.successfulOutcome;
@@ -114,7 +114,8 @@ bool E2APSubscriptionDeleteRequest::encode(unsigned char *buf, size_t *size){
   }
 
   *size = res.encoded;
-  xer_fprint(stdout, &asn_DEF_E2AP_PDU, e2ap_pdu_obj);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2AP_PDU, e2ap_pdu_obj);
 
   return true;
 
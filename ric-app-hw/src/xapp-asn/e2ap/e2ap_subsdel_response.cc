@@ -66,7 +66,7 @@ bool E2APSubscriptionDeleteResponse::decode(unsigned char *buf, size_t *size)
 				 mdclog_write(MDCLOG_ERR, "Failed to decode: %s","RIC Subscription Delete Response");
 				 return false;
 	} else {
-				 mdclog_write(MDCLOG_INFO, "Successfully decoded: %s","RIC Subscription Delete Response");
+				 mdclog_write(MDCLOG_DEBUG, "Successfully decoded: %s","RIC Subscription Delete Response");
 	}
 
     _successMsg = _e2ap_pdu_obj->choice.successfulOutcome;
@@ -166,7 +166,8 @@ bool E2APSubscriptionDeleteResponse::encode(unsigned char *buf, size_t *size){
   }
 
   *size = res.encoded;
-  xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2AP_PDU, _e2ap_pdu_obj);
 
   return true;
 
@@ -77,7 +77,9 @@
  HWIndicationMessage::~HWIndicationMessage(void){
 
   mdclog_write(MDCLOG_DEBUG, "Freeing event trigger object memory");
-  _message->choice.indicationMessage_Format1 = 0;
+  //only the format set for encoding is a member; a decoded one is freed with the rest.
+  if(_message != 0 && _message->choice.indicationMessage_Format1 == &_message_fmt1)
+	  _message->choice.indicationMessage_Format1 = 0;
 
   ASN_STRUCT_FREE(asn_DEF_E2SM_HelloWorld_IndicationMessage, _message);
 
@@ -86,12 +88,16 @@
  HWIndicationHeader::~HWIndicationHeader(void){
 
    mdclog_write(MDCLOG_DEBUG, "Freeing event trigger object memory");
-   _header->choice.indicationHeader_Format1 = 0;
+   if(_header != 0 && _header->choice.indicationHeader_Format1 == &_header_fmt1)
+	   _header->choice.indicationHeader_Format1 = 0;
    ASN_STRUCT_FREE(asn_DEF_E2SM_HelloWorld_IndicationHeader, _header);
  };
 
 bool HWIndicationHeader::encode(unsigned char *buf, size_t *size){
 
+  //the format is a member, it must not be freed when the object encodes again
+  if(_header->choice.indicationHeader_Format1 == &_header_fmt1)
+	  _header->choice.indicationHeader_Format1 = 0;
   ASN_STRUCT_RESET(asn_DEF_E2SM_HelloWorld_IndicationHeader, _header);
 
   bool res;
@@ -107,7 +113,8 @@ bool HWIndicationHeader::encode(unsigned char *buf, size_t *size){
     return false;
   }
 
-  xer_fprint(stdout, &asn_DEF_E2SM_HelloWorld_IndicationHeader, _header);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2SM_HelloWorld_IndicationHeader, _header);
 
   asn_enc_rval_t retval = asn_encode_to_buffer(0, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_HelloWorld_IndicationHeader, _header, buf, *size);
 
@@ -130,6 +137,8 @@ bool HWIndicationHeader::encode(unsigned char *buf, size_t *size){
 
 bool HWIndicationMessage::encode(unsigned char *buf, size_t *size){
 
+  if(_message->choice.indicationMessage_Format1 == &_message_fmt1)
+	  _message->choice.indicationMessage_Format1 = 0;
   ASN_STRUCT_RESET(asn_DEF_E2SM_HelloWorld_IndicationMessage, _message);
 
   bool res;
@@ -144,7 +153,8 @@ bool HWIndicationMessage::encode(unsigned char *buf, size_t *size){
     return false;
   }
 
-  xer_fprint(stdout, &asn_DEF_E2SM_HelloWorld_IndicationMessage, _message);
+  if(mdclog_level_get() >= MDCLOG_DEBUG)
+  	xer_fprint(stdout, &asn_DEF_E2SM_HelloWorld_IndicationMessage, _message);
 
   asn_enc_rval_t retval = asn_encode_to_buffer(0, ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_HelloWorld_IndicationMessage, _message, buf, *size);
 
@@ -194,6 +204,10 @@ bool HWIndicationMessage::setfields(E2SM_HelloWorld_IndicationMessage_t * _messa
 };
 
 bool HWIndicationHeader::decode(unsigned char *buf, size_t *size){
+	//release what an earlier decode left, so that one object can be reused
+	if(_header != 0 && _header->choice.indicationHeader_Format1 == &_header_fmt1)
+		_header->choice.indicationHeader_Format1 = 0;
+	ASN_STRUCT_FREE(asn_DEF_E2SM_HelloWorld_IndicationHeader, _header);
 	_header = 0;
 
 	asn_dec_rval_t dec_res  = asn_decode(0,ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_HelloWorld_IndicationHeader, (void**)&(_header), buf, *size);
@@ -203,7 +217,7 @@ bool HWIndicationHeader::decode(unsigned char *buf, size_t *size){
 		 _error_string = "Failed to decode HW-E2SM RIC Indication Header";
 		 return false;
 	 } else {
-		 mdclog_write(MDCLOG_INFO, "Successfully decoded: %s","HW-E2SM RIC Indication Header");
+		 mdclog_write(MDCLOG_DEBUG, "Successfully decoded: %s","HW-E2SM RIC Indication Header");
 	 }
 
 	 if (_header == 0){
@@ -216,13 +230,18 @@ bool HWIndicationHeader::decode(unsigned char *buf, size_t *size){
 }
 
 bool HWIndicationMessage::decode(unsigned char *buf, size_t *size){
+	//release what an earlier decode left, so that one object can be reused
+	if(_message != 0 && _message->choice.indicationMessage_Format1 == &_message_fmt1)
+		_message->choice.indicationMessage_Format1 = 0;
+	ASN_STRUCT_FREE(asn_DEF_E2SM_HelloWorld_IndicationMessage, _message);
+	_message = 0;
 
 	asn_dec_rval_t dec_res  = asn_decode(0,ATS_ALIGNED_BASIC_PER, &asn_DEF_E2SM_HelloWorld_IndicationMessage, (void**)&(_message), buf, *size);
 	if(dec_res.code != RC_OK){
 			 mdclog_write(MDCLOG_ERR, "Failed to decode: %s","HW-E2SM RIC Indication Message");
 			 return false;
 	} else {
-			 mdclog_write(MDCLOG_INFO, "Successfully decoded: %s","HW-E2SM RIC Indication Message");
+			 mdclog_write(MDCLOG_DEBUG, "Successfully decoded: %s","HW-E2SM RIC Indication Message");
 	}
 
 	  if (_message == 0){
@@ -108,28 +108,20 @@ void XappMsgHandler::operator()(rmr_mbuf_t *message, bool *resend){
 
 		case (RIC_SUB_RESP):
         		mdclog_write(MDCLOG_INFO, "Received subscription message of type = %d", message->mtype);
-				unsigned char *me_id;
-				if( (me_id = (unsigned char *) malloc( sizeof( unsigned char ) * RMR_MAX_MEID )) == NULL ) {
-					mdclog_write(MDCLOG_ERR, "Error :  %s, %d : malloc failed for me_id", __FILE__, __LINE__);
-					me_id = rmr_get_meid(message, NULL);
-				} else {
-					rmr_get_meid(message, me_id);
-				}
-				if(me_id == NULL){
-					mdclog_write(MDCLOG_ERR, " Error :: %s, %d : rmr_get_meid failed me_id is NULL", __FILE__, __LINE__);
-					break;
-				}
-				mdclog_write(MDCLOG_INFO,"RMR Received MEID: %s",me_id);
-				if(_ref_sub_handler !=NULL){
-					_ref_sub_handler->manage_subscription_response(message->mtype, reinterpret_cast< char const* >(me_id));
-				} else {
-					mdclog_write(MDCLOG_ERR, " Error :: %s, %d : Subscription handler not assigned in message processor !", __FILE__, __LINE__);
+				{
+					unsigned char me_id[RMR_MAX_MEID] = {};
+					if(rmr_get_meid(message, me_id) == NULL){
+						mdclog_write(MDCLOG_ERR, " Error :: %s, %d : rmr_get_meid failed me_id is NULL", __FILE__, __LINE__);
+						break;
+					}
+					mdclog_write(MDCLOG_INFO,"RMR Received MEID: %s",me_id);
+					if(_ref_sub_handler !=NULL){
+						_ref_sub_handler->manage_subscription_response(message->mtype, reinterpret_cast< char const* >(me_id));
+					} else {
+						mdclog_write(MDCLOG_ERR, " Error :: %s, %d : Subscription handler not assigned in message processor !", __FILE__, __LINE__);
+					}
 				}
 				*resend = false;
-				if (me_id != NULL) {
-					mdclog_write(MDCLOG_INFO, "Free RMR Received MEID memory: %s(0x%x)", me_id, me_id);
-					free(me_id);
-				}
 				break;
 
 	case A1_POLICY_REQ:
@@ -146,7 +138,7 @@ void XappMsgHandler::operator()(rmr_mbuf_t *message, bool *resend){
 			break;
 	case RIC_INDICATION:
 
-		mdclog_write(MDCLOG_INFO, "Received Indication message of type = %d", message->mtype);
+		mdclog_write(MDCLOG_DEBUG, "Received Indication message of type = %d", message->mtype);
 		//pick the relevant decoding code from test_e2sm.h, section(E2SM, IndicationMessageDecode)
 		break;
 
@@ -82,20 +82,21 @@ bool XappRmr::rmr_header(xapp_rmr_header *hdr){
 //RMR Send with payload and header.
 bool XappRmr::xapp_rmr_send(xapp_rmr_header *hdr, void *payload){
 
-	// Get the thread id
-	std::thread::id my_id = std::this_thread::get_id();
-	std::stringstream thread_id;
-	std::stringstream ss;
-
-	thread_id << my_id;
-	mdclog_write(MDCLOG_INFO, "Sending thread %s",  thread_id.str().c_str());
-
+	mdclog_write(MDCLOG_DEBUG, "Sending message of type %d, length %d", hdr->message_type, hdr->payload_length);
 
 	int rmr_attempts = _nattempts;
 
+	// the send buffer is kept from one send to the next; it only grows for a larger payload
 	if( _xapp_send_buff == NULL ) {
 		_xapp_send_buff = rmr_alloc_msg(_xapp_rmr_ctx, RMR_DEF_SIZE);
 	}
+	if( rmr_payload_size(_xapp_send_buff) < hdr->payload_length ) {
+		_xapp_send_buff = rmr_realloc_payload(_xapp_send_buff, hdr->payload_length, 0, 0);
+		if( _xapp_send_buff == NULL ) {
+			mdclog_write(MDCLOG_ERR,"Error allocating %d byte RMR payload, file= %s, line=%d",hdr->payload_length,__FILE__,__LINE__);
+			return false;
+		}
+	}
 
 	bool res = rmr_header(hdr);
 	if(!res){
@@ -119,9 +120,8 @@ bool XappRmr::xapp_rmr_send(xapp_rmr_header *hdr, void *payload){
 			rmr_attempts--;
 		}
 		else if (_xapp_send_buff->state == RMR_OK){
-			mdclog_write(MDCLOG_INFO,"Message Sent: RMR State = RMR_OK");
+			mdclog_write(MDCLOG_DEBUG,"Message Sent: RMR State = RMR_OK");
 			rmr_attempts = 0;
-			_xapp_send_buff = NULL;
 			return true;
 		}
 		else
@@ -131,7 +131,9 @@ bool XappRmr::xapp_rmr_send(xapp_rmr_header *hdr, void *payload){
 				usleep(1);			}
 				rmr_attempts--;
 		}
-		sleep(1);
+		// a full queue (retry) clears quickly; only back off on a real failure
+		if(_xapp_send_buff == NULL || _xapp_send_buff->state != RMR_ERR_RETRY)
+			sleep(1);
 	}
 	return false;
 }
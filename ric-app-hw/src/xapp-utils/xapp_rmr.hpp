@@ -46,6 +46,8 @@
 #include <mdclog/mdclog.h>
 #include <vector>
 
+#define RMR_RCV_TIMEOUT_MS 1000 // how long a receive waits before the listen flag is looked at again
+
 typedef struct{
 	struct timespec ts;
 	int32_t message_type;
@@ -89,16 +91,17 @@ public:
 
 };
 
+void init_logger(const char *AppName, mdclog_severity_t log_level);
+
 
 // main workhorse thread which does the listen->process->respond loop
 template <class MsgHandler>
 void XappRmr::xapp_rmr_receive(MsgHandler&& msgproc, XappRmr *parent){
 
-	bool* resend = new bool(false);
+	bool resend = false;
 	// Get the thread id
 	std::thread::id my_id = std::this_thread::get_id();
 	std::stringstream thread_id;
-	std::stringstream ss;
 
 	thread_id << my_id;
 
@@ -110,53 +113,62 @@ void XappRmr::xapp_rmr_receive(MsgHandler&& msgproc, XappRmr *parent){
 	void *rmr_context = parent->get_rmr_context();
 	assert(rmr_context != NULL);
 
-	// Get buffer specific to this thread
-	this->_xapp_received_buff = NULL;
-	this->_xapp_received_buff = rmr_alloc_msg(rmr_context, RMR_DEF_SIZE);
-	assert(this->_xapp_received_buff != NULL);
+	// Get buffer specific to this thread. It is reused for every message received and
+	// for the reply, so nothing is allocated per message.
+	rmr_mbuf_t *rcv_buff = rmr_alloc_msg(rmr_context, RMR_DEF_SIZE);
+	assert(rcv_buff != NULL);
 
 	mdclog_write(MDCLOG_INFO, "Starting receiver thread %s",  thread_id.str().c_str());
 
 	while(parent->get_listen()) {
-		mdclog_write(MDCLOG_INFO, "Listening at Thread: %s",  thread_id.str().c_str());
 
-		this->_xapp_received_buff = rmr_rcv_msg( rmr_context, this->_xapp_received_buff );
-		//this->_xapp_received_buff = rmr_call( rmr_context, this->_xapp_received_buff);
-
-		if( this->_xapp_received_buff->mtype < 0 || this->_xapp_received_buff->state != RMR_OK ) {
-			mdclog_write(MDCLOG_ERR, "bad msg:  state=%d  errno=%d, file= %s, line=%d", this->_xapp_received_buff->state, errno, __FILE__,__LINE__ );
-			return;
+		// wait a bounded time, so that the thread sees the listen flag going down
+		rcv_buff = rmr_torcv_msg( rmr_context, rcv_buff, RMR_RCV_TIMEOUT_MS );
+		if(unlikely(rcv_buff == NULL)){
+			mdclog_write(MDCLOG_ERR, "RMR returned no buffer, errno=%d, file= %s, line=%d", errno, __FILE__,__LINE__ );
+			break;
 		}
-		else
-		{
-			mdclog_write(MDCLOG_INFO,"RMR Received Message of Type: %d",this->_xapp_received_buff->mtype);
-			mdclog_write(MDCLOG_INFO,"RMR Received Message: %s",(char*)this->_xapp_received_buff->payload);
-
-		    //in case message handler returns true, need to resend the message.
-			msgproc(this->_xapp_received_buff, resend);
-
-			if(*resend){
-				mdclog_write(MDCLOG_INFO,"RMR Return to Sender Message of Type: %d",this->_xapp_received_buff->mtype);
-				mdclog_write(MDCLOG_INFO,"RMR Return to Sender Message: %s",(char*)this->_xapp_received_buff->payload);
-				rmr_rts_msg(rmr_context, this->_xapp_received_buff );
-				sleep(1);
-				*resend = false;
+
+		if(unlikely(rcv_buff->mtype < 0 || rcv_buff->state != RMR_OK)) {
+			if(rcv_buff->state != RMR_ERR_TIMEOUT){
+				mdclog_write(MDCLOG_ERR, "bad msg:  state=%d  errno=%d, file= %s, line=%d", rcv_buff->state, errno, __FILE__,__LINE__ );
 			}
 			continue;
-
 		}
 
+		// payloads are binary (ASN.1), only their length is logged
+		mdclog_write(MDCLOG_DEBUG,"RMR Received Message of Type: %d, length: %d",rcv_buff->mtype, rcv_buff->len);
+
+		//in case message handler returns true, need to resend the message.
+		msgproc(rcv_buff, &resend);
+
+		if(resend){
+			resend = false;
+			mdclog_write(MDCLOG_DEBUG,"RMR Return to Sender Message of Type: %d, length: %d",rcv_buff->mtype, rcv_buff->len);
+
+			// RMR hands back the buffer to use next, which need not be the one sent
+			int rts_attempts = parent->_nattempts;
+			rcv_buff = rmr_rts_msg(rmr_context, rcv_buff );
+			while(rcv_buff != NULL && rcv_buff->state == RMR_ERR_RETRY && --rts_attempts > 0){
+				rcv_buff = rmr_rts_msg(rmr_context, rcv_buff );
+			}
+
+			if(rcv_buff == NULL){
+				mdclog_write(MDCLOG_ERR, "Error In Return to Sender, no buffer returned, file= %s, line=%d",__FILE__,__LINE__);
+				rcv_buff = rmr_alloc_msg(rmr_context, RMR_DEF_SIZE);
+				assert(rcv_buff != NULL);
+			}
+			else if(rcv_buff->state != RMR_OK){
+				mdclog_write(MDCLOG_ERR, "Error In Return to Sender, state=%d, file= %s, line=%d",rcv_buff->state,__FILE__,__LINE__);
+			}
+		}
 	}
+
 	// Clean up
-	try{
-		delete resend;
-		rmr_free_msg(this->_xapp_received_buff);
-	}
-	catch(std::runtime_error &e){
-		std::string identifier = __FILE__ +  std::string(", Line: ") + std::to_string(__LINE__) ;
-		std::string error_string = identifier = " Error freeing RMR message ";
-		mdclog_write(MDCLOG_ERR, error_string.c_str(), "");
+	if(rcv_buff != NULL){
+		rmr_free_msg(rcv_buff);
 	}
+	mdclog_write(MDCLOG_INFO, "Stopping receiver thread %s",  thread_id.str().c_str());
 
 	return;
 }
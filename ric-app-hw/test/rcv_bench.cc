@@ -0,0 +1,242 @@
+/*
+==================================================================================
+
+        Copyright (c) 2019-2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+/*
+ * rcv_bench.cc
+ *
+ * Indications per second through the xApp receive loop. A sender context
+ * sends encoded RIC indications over RMR to a receiver context on the same
+ * host; each receive thread runs XappRmr::xapp_rmr_receive() with a handler
+ * that decodes the E2AP indication and its E2SM header and message, reusing
+ * its decoders, and optionally returns every indication to the sender.
+ *
+ * Usage: rcv_bench [-t threads] [-n indications] [-p port] [-r] [-v]
+ *    -r  return each indication to the sender (rmr_rts_msg)
+ *    -v  run with the log level at debug, to see what debug logging costs
+ *
+ *  Oct, 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xapp_rmr.hpp"
+#include "e2ap_indication.hpp"
+#include "e2sm_indication.hpp"
+
+using namespace std;
+
+typedef E2APIndication<HWIndicationHeader,HWIndicationMessage> Indication;
+
+static atomic<long> received(0);
+static atomic<long> decode_errors(0);
+
+// one per receive thread; the decoders are made on the first indication and reused
+class IndicationCounter{
+public:
+	IndicationCounter(long *count, bool reply) : _count(count), _reply(reply) {};
+
+	void operator() (rmr_mbuf_t *message, bool *resend){
+		if(message->mtype != RIC_INDICATION){
+			return;
+		}
+
+		size_t size = message->len;
+		bool ok = true;
+		try{
+			if(!_indication){
+				_indication = make_unique<Indication>(message->payload, &size);
+			} else {
+				ok = _indication->decode(message->payload, &size);
+			}
+			if(ok){
+				Indication::IndicationIEs ies = _indication->getIndicationIEs();
+
+				size_t hsize = ies.get_ricIndicationHeader_size();
+				size_t msize = ies.get_ricIndicationMessage_size();
+				unsigned char *hvalue = (unsigned char*)ies.get_ricIndicationHeader();
+				unsigned char *mvalue = (unsigned char*)ies.get_ricIndicationMessage();
+				if(!_header){
+					_header = make_unique<HWIndicationHeader>(hvalue, &hsize);
+					_message = make_unique<HWIndicationMessage>(mvalue, &msize);
+				} else {
+					ok = _header->decode(hvalue, &hsize) && _message->decode(mvalue, &msize);
+				}
+			}
+		} catch(...){
+			ok = false;
+		}
+		if(!ok){
+			decode_errors++;
+		}
+
+		(*_count)++;
+		received++;
+		*resend = _reply;
+	}
+
+private:
+	long *_count;
+	bool _reply;
+	unique_ptr<Indication> _indication;
+	unique_ptr<HWIndicationHeader> _header;
+	unique_ptr<HWIndicationMessage> _message;
+};
+
+// encodes the indication the sender repeats, as in test_indc.h
+static size_t encode_indication(unsigned char *buf, size_t len){
+	HWIndicationHeader headerObj;
+	headerObj.set_ricIndicationHeader(1);
+
+	HWIndicationMessage messageObj;
+	messageObj.set_hw_message("HelloWorld-E2SM");
+
+	Indication::IndicationIEs infoObj;
+	infoObj.set_ranFunctionID(1);
+	infoObj.set_ricActionID(1);
+	infoObj.set_ricRequestorID(1);
+	infoObj.set_ricIndicationHeader(headerObj);
+	infoObj.set_ricIndicationMessage(messageObj);
+
+	Indication e2obj(infoObj);
+	if(!e2obj.encode(buf, &len)){
+		fprintf(stderr, "[FAIL] cannot encode the indication: %s\n", e2obj.get_error().c_str());
+		exit(1);
+	}
+	return len;
+}
+
+int main(int argc, char *argv[]){
+	int nthreads = 1;
+	long total = 100000;
+	int port = 4590;
+	bool reply = false;
+	bool verbose = false;
+	int opt;
+
+	while((opt = getopt(argc, argv, "t:n:p:rv")) != -1){
+		switch(opt){
+			case 't': nthreads = atoi(optarg); break;
+			case 'n': total = atol(optarg); break;
+			case 'p': port = atoi(optarg); break;
+			case 'r': reply = true; break;
+			case 'v': verbose = true; break;
+			default:
+				fprintf(stderr, "usage: %s [-t threads] [-n indications] [-p port] [-r] [-v]\n", argv[0]);
+				exit(1);
+		}
+	}
+	if(nthreads < 1 || total < 1){
+		fprintf(stderr, "[FAIL] threads and indications must be positive\n");
+		exit(1);
+	}
+
+	init_logger("rcv_bench", verbose ? MDCLOG_DEBUG : MDCLOG_ERR);
+
+	// static routes only: indications go to the receiver
+	char rt_name[] = "/tmp/rcv_bench_rt.XXXXXX";
+	int fd = mkstemp(rt_name);
+	string rt = "newrt|start\nrte|" + to_string(RIC_INDICATION) + "|127.0.0.1:" + to_string(port) + "\nnewrt|end\n";
+	if(fd < 0 || write(fd, rt.c_str(), rt.size()) != (ssize_t)rt.size()){
+		perror("route table");
+		exit(1);
+	}
+	close(fd);
+	setenv("RMR_SEED_RT", rt_name, 1);
+	setenv("RMR_RTG_SVC", "-1", 1);
+
+	XappRmr receiver(to_string(port));
+	receiver.xapp_rmr_init(true);
+	XappRmr sender(to_string(port + 1));
+	sender.xapp_rmr_init(false);
+	unlink(rt_name);
+
+	unsigned char buf[4096];
+	size_t len = encode_indication(buf, sizeof(buf));
+
+	vector<long> counts(nthreads, 0);
+	vector<thread> threads;
+	for(int i = 0; i < nthreads; i++){
+		long *count = &counts[i];
+		threads.emplace_back([&receiver, count, reply](){
+			receiver.xapp_rmr_receive(IndicationCounter(count, reply), &receiver);
+		});
+	}
+
+	xapp_rmr_header hdr;
+	hdr.message_type = RIC_INDICATION;
+	hdr.payload_length = len;
+
+	// keep no more than a window of indications in flight, so that none are dropped
+	const long window = 512;
+	long sent = 0;
+	auto start = chrono::steady_clock::now();
+	while(sent < total){
+		if(sent - received.load() >= window){
+			this_thread::yield();
+			continue;
+		}
+		if(sender.xapp_rmr_send(&hdr, buf)){
+			sent++;
+		}
+	}
+
+	// wait for the last ones, giving up when nothing arrives for a while
+	long last = -1;
+	auto idle = chrono::steady_clock::now();
+	while(received.load() < sent){
+		if(received.load() != last){
+			last = received.load();
+			idle = chrono::steady_clock::now();
+		} else if(chrono::steady_clock::now() - idle > chrono::seconds(5)){
+			break;
+		}
+		this_thread::yield();
+	}
+	double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	receiver.set_listen(false);
+	for(auto &th : threads){
+		th.join();
+	}
+
+	printf("%ld indications of %d bytes, %d receive thread(s)%s: %.2f s\n",
+			received.load(), (int)len, nthreads, reply ? ", returned to sender" : "", elapsed);
+	printf("total       %10.0f indications/s\n", received.load() / elapsed);
+	for(int i = 0; i < nthreads; i++){
+		printf("thread %-4d %10.0f indications/s  (%ld)\n", i, counts[i] / elapsed, counts[i]);
+	}
+
+	if(decode_errors.load() > 0){
+		fprintf(stderr, "[FAIL] %ld indications could not be decoded\n", decode_errors.load());
+		return 1;
+	}
+	if(received.load() != sent){
+		fprintf(stderr, "[FAIL] %ld of %ld indications lost\n", sent - received.load(), sent);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,100 @@
+# -------------------------------------------------------------------------------
+#    Copyright (c) 2018-2019 AT&T Intellectual Property.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+# -------------------------------------------------------------------------------
+
+# Generate pb_keep.h: for each process_buffer_<interface> handler in
+# rts_proto.c the sub-message fields that the handler reads. Only these
+# sub-messages are unpacked (see pb_arena.h); the handlers are generated
+# from the query schemas, so a sub-message they never touch is one that
+# no query references. Rerun whenever rts_proto.c is regenerated:
+#
+#	python3 gen_pb_keep.py >pb_keep.h
+
+import glob
+import os
+import re
+import sys
+
+src_dir = os.path.dirname(os.path.abspath(__file__))
+
+# member types of each message struct, and the descriptor for each message type
+members = {}		# c type -> { member: c type of sub-message (or None) }
+descriptors = {}	# c type -> descriptor variable
+field_ids = {}		# (c type, member) -> field number; members of a oneof share an offset so the number is used
+
+for fn in glob.glob(os.path.join(src_dir, "*.pb-c.h")) + glob.glob(os.path.join(src_dir, "google/protobuf/*.pb-c.h")):
+	with open(fn) as f:
+		text = f.read()
+	for m in re.finditer(r"struct\s+_(\w+)\s*\{(.*?)\n\};", text, re.S):
+		mem = {}
+		for ml in re.finditer(r"^\s*(\w+)\s+(\**)(\w+);", m.group(2), re.M):
+			ctype, stars, name = ml.groups()
+			mem[name] = ctype if stars else None
+		members[m.group(1)] = mem
+
+for fn in glob.glob(os.path.join(src_dir, "*.pb-c.c")) + glob.glob(os.path.join(src_dir, "google/protobuf/*.pb-c.c")):
+	with open(fn) as f:
+		text = f.read()
+	for m in re.finditer(r"const ProtobufCMessageDescriptor (\w+) =\s*\{\s*PROTOBUF_C__MESSAGE_DESCRIPTOR_MAGIC,\s*\"[^\"]*\",\s*\"[^\"]*\",\s*\"(\w+)\"", text):
+		descriptors[m.group(2)] = m.group(1)
+	for m in re.finditer(r"\{\s*\"\w+\",\s*(\d+),[^{}]*?offsetof\((\w+), (\w+)\),\s*(?:&\w+|NULL),", text):
+		field_ids[(m.group(2), m.group(3))] = int(m.group(1))
+
+with open(os.path.join(src_dir, "rts_proto.c")) as f:
+	rts = f.read()
+
+handlers = []
+for m in re.finditer(r"^gs_uint32_t process_buffer_(\w+)\(.*?\)\{(.*?)^\}", rts, re.S | re.M):
+	iface, body = m.groups()
+	vtypes = { "hdr": "StreamingProtobufs__X2APStreaming" }
+	for d in re.finditer(r"(StreamingProtobufs__\w+)\s*\*(\w+)\s*=", body):
+		vtypes[d.group(2)] = d.group(1)
+
+	keep = set()
+	for a in re.finditer(r"\b(\w+)((?:->\w+(?:\[[^\]]*\])?)+)", body):
+		ctype = vtypes.get(a.group(1))
+		for name in re.findall(r"->(\w+)", a.group(2)):
+			if ctype is None or ctype not in members:
+				break
+			mem = members[ctype]
+			if name not in mem and name.startswith("n_") and name[2:] in mem:
+				name = name[2:]				# count of a repeated field
+			if name not in mem:
+				sys.stderr.write("%s: %s has no member %s\n" % (iface, ctype, name))
+				sys.exit(1)
+			sub = mem[name]
+			if sub is None or sub not in descriptors:
+				break						# scalar; nothing below it to keep
+			keep.add((ctype, name))
+			ctype = sub
+
+	handlers.append((iface, sorted(keep)))
+
+print("// generated by gen_pb_keep.py from rts_proto.c; do not edit")
+print("// For each interface, the sub-message fields that its handler reads.")
+print("")
+for iface, keep in handlers:
+	print("static const pb_keep_t pb_keep_%s[] = {" % iface)
+	for ctype, name in keep:
+		print("\t{ &%s, %d },\t// %s" % (descriptors[ctype], field_ids[(ctype, name)], name))
+	print("\t{ NULL, 0 }")
+	print("};")
+	print("")
+
+print("static const struct { const char* iface; const pb_keep_t* keep; } pb_keep_tab[] = {")
+for iface, keep in handlers:
+	print("\t{ \"%s\", pb_keep_%s }," % (iface, iface))
+print("\t{ NULL, NULL }")
+print("};")
@@ -0,0 +1,331 @@
+// vim: ts=4 sw=4 noet:
+/*
+ --------------------------------------------------------------------------------
+	Copyright (c) 2018-2019 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+	   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ --------------------------------------------------------------------------------
+*/
+
+/*
+	Mnemonic:	mcl_ring.h
+	Abstract:	A single producer, single consumer ring in a shared memory
+				(mmap'd) file. The listener can write the messages of a
+				type to a ring, rather than to a FIFO, and the reader takes
+				them directly from the mapped memory; no bytes go through
+				the kernel and the reader does not copy them.
+
+				The ring file has a header page followed by the data area
+				(a power of two bytes). Records in the data area are:
+					<len:4><mtype:4><timestamp-ms:8><payload><pad to 8>
+
+				all in host byte order. A record never wraps; if one does
+				not fit at the end of the data area the producer marks the
+				rest of the area unused (len == MCLR_PAD) and starts again
+				at the front.
+
+				Head and tail are byte counts that never wrap (the position
+				is the count masked by the size). The producer alone moves
+				head, the consumer alone moves tail. When the ring is full the
+				message is dropped, as it is when a FIFO is full.
+
+				The consumer spins briefly when the ring is empty and then
+				sleeps on a futex in the header; the producer makes the wake
+				system call only when the consumer has said it is asleep.
+
+				This file is header only so that it can be dropped into the
+				reader's build (the GS-lite data source in mc-core carries a
+				copy which must be kept in step with this one).
+
+	Date:		18 October 2026
+*/
+
+#ifndef mcl_ring_h
+#define mcl_ring_h
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define MCLR_MAGIC		0x524c434d		// "MCLR"
+#define MCLR_VERSION	1
+#define MCLR_HDR_PAGE	4096			// data area starts here
+#define MCLR_REC_HDR	16				// len, mtype, timestamp
+#define MCLR_PAD		0xffffffff		// record length marking unused space at the end of the data area
+#define MCLR_DEF_SIZE	(4 * 1024 * 1024)
+#define MCLR_MIN_SIZE	4096
+#define MCLR_SPIN		200				// checks before the consumer goes to sleep
+
+/*
+	The header at the front of the file. Producer and consumer fields are
+	on separate cache lines.
+*/
+typedef struct {
+	uint32_t	magic;				// set last when the producer initialises the ring
+	uint32_t	version;
+	uint64_t	size;				// bytes in the data area
+	char		pad1[48];
+
+	uint64_t	head;				// producer: bytes written
+	uint64_t	drops;				// producer: messages dropped because the ring was full
+	char		pad2[48];
+
+	uint64_t	tail;				// consumer: bytes consumed
+	uint32_t	waiting;			// consumer is, or is about to be, asleep
+	uint32_t	seq;				// futex word; bumped by the producer to wake the consumer
+	char		pad3[48];
+} mclr_hdr_t;
+
+/*
+	Process local handle.
+*/
+typedef struct {
+	mclr_hdr_t*	hdr;
+	char*		data;				// the data area
+	uint64_t	mask;
+	size_t		maplen;
+	int			fd;
+	uint32_t	pending;			// consumer: size of the record returned by mclr_next()
+} mclr_t;
+
+// ------------------------------------------------------------------------------------------------
+
+static inline int mclr_futex( uint32_t* addr, int op, uint32_t val, const struct timespec* to ) {
+	return syscall( SYS_futex, addr, op, val, to, NULL, 0 );		// not private: the word is shared between processes
+}
+
+/*
+	Open (and map) the ring file. The producer passes create as true and
+	the data area size; an existing ring of the same size is reused so that
+	a reader which is attached keeps working across a producer restart.
+	The consumer passes create as false and size is ignored; nil is returned
+	with errno set to EAGAIN if the producer has not yet initialised the ring.
+*/
+static inline mclr_t* mclr_open( const char* path, uint64_t size, int create ) {
+	mclr_t*		r;
+	mclr_hdr_t	h;
+	struct stat	sb;
+	void*		map;
+	uint64_t	sz;
+	int			fd;
+
+	if( create ) {
+		for( sz = MCLR_MIN_SIZE; sz < size; sz <<= 1 );			// power of two
+		if( (fd = open( path, O_RDWR | O_CREAT, 0660 )) < 0 ) {
+			return NULL;
+		}
+		if( fstat( fd, &sb ) != 0 || sb.st_size != (off_t) (MCLR_HDR_PAGE + sz)
+			|| pread( fd, &h, sizeof( h ), 0 ) != sizeof( h ) || h.magic != MCLR_MAGIC || h.version != MCLR_VERSION || h.size != sz ) {
+
+			if( ftruncate( fd, 0 ) != 0 || ftruncate( fd, MCLR_HDR_PAGE + sz ) != 0 ) {		// new, or not ours: start clean
+				close( fd );
+				return NULL;
+			}
+		}
+	} else {
+		if( (fd = open( path, O_RDWR )) < 0 ) {
+			return NULL;
+		}
+		if( pread( fd, &h, sizeof( h ), 0 ) != sizeof( h ) || h.magic != MCLR_MAGIC ) {
+			close( fd );
+			errno = EAGAIN;
+			return NULL;
+		}
+		if( h.version != MCLR_VERSION || h.size < MCLR_MIN_SIZE || (h.size & (h.size - 1)) != 0 ) {
+			close( fd );
+			errno = EINVAL;
+			return NULL;
+		}
+		sz = h.size;
+	}
+
+	if( (map = mmap( NULL, MCLR_HDR_PAGE + sz, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 )) == MAP_FAILED ) {
+		close( fd );
+		return NULL;
+	}
+
+	if( (r = (mclr_t *) malloc( sizeof( *r ) )) == NULL ) {
+		munmap( map, MCLR_HDR_PAGE + sz );
+		close( fd );
+		return NULL;
+	}
+	memset( r, 0, sizeof( *r ) );
+	r->hdr = (mclr_hdr_t *) map;
+	r->data = (char *) map + MCLR_HDR_PAGE;
+	r->mask = sz - 1;
+	r->maplen = MCLR_HDR_PAGE + sz;
+	r->fd = fd;
+
+	if( create && r->hdr->magic != MCLR_MAGIC ) {
+		r->hdr->version = MCLR_VERSION;
+		r->hdr->size = sz;
+		__atomic_store_n( &r->hdr->magic, MCLR_MAGIC, __ATOMIC_RELEASE );
+	}
+
+	return r;
+}
+
+static inline void mclr_close( mclr_t* r ) {
+	if( r != NULL ) {
+		munmap( r->hdr, r->maplen );
+		close( r->fd );
+		free( r );
+	}
+}
+
+/*
+	Producer: add a message. Returns 1 if it was added, 0 if the ring was
+	full (or the message can never fit) and the message was dropped. The
+	consumer is not woken; call mclr_wake() after adding a batch.
+*/
+static inline int mclr_put( mclr_t* r, int mtype, uint64_t ts, const void* payload, uint32_t len ) {
+	mclr_hdr_t*	h;
+	uint64_t	head;
+	uint64_t	tail;
+	uint64_t	need;
+	uint64_t	room;					// contiguous bytes to the end of the data area
+	char*		rec;
+
+	h = r->hdr;
+	need = (MCLR_REC_HDR + (uint64_t) len + 7) & ~(uint64_t) 7;
+	head = h->head;
+	tail = __atomic_load_n( &h->tail, __ATOMIC_ACQUIRE );
+	room = (r->mask + 1) - (head & r->mask);
+
+	if( need > room ) {									// won't fit at the end; skip to the front
+		if( need > (r->mask + 1) / 2 || head + room + need - tail > r->mask + 1 ) {
+			h->drops++;
+			return 0;
+		}
+		*((uint32_t *) (r->data + (head & r->mask))) = MCLR_PAD;
+		head += room;
+	} else {
+		if( head + need - tail > r->mask + 1 ) {
+			h->drops++;
+			return 0;
+		}
+	}
+
+	rec = r->data + (head & r->mask);
+	*((uint32_t *) rec) = len;
+	*((int32_t *) (rec + 4)) = mtype;
+	*((uint64_t *) (rec + 8)) = ts;
+	memcpy( rec + MCLR_REC_HDR, payload, len );
+
+	__atomic_store_n( &h->head, head + need, __ATOMIC_RELEASE );
+	return 1;
+}
+
+/*
+	Producer: wake the consumer if it is asleep. Returns 1 if a system call
+	was made.
+*/
+static inline int mclr_wake( mclr_t* r ) {
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );						// head store must be seen before waiting is read
+	if( __atomic_load_n( &r->hdr->waiting, __ATOMIC_SEQ_CST ) ) {
+		__atomic_add_fetch( &r->hdr->seq, 1, __ATOMIC_SEQ_CST );
+		mclr_futex( &r->hdr->seq, FUTEX_WAKE, 1, NULL );
+		return 1;
+	}
+
+	return 0;
+}
+
+/*
+	Consumer: return the length of the next message, pointing data at it in
+	the ring, or 0 if the ring is empty. The message stays in the ring (and
+	data remains valid) until mclr_release() is called. Mtype and ts may be
+	nil.
+*/
+static inline int mclr_next( mclr_t* r, int* mtype, uint64_t* ts, char** data ) {
+	mclr_hdr_t*	h;
+	uint64_t	tail;
+	uint64_t	head;
+	uint32_t	len;
+	char*		rec;
+
+	h = r->hdr;
+	tail = h->tail;
+	head = __atomic_load_n( &h->head, __ATOMIC_ACQUIRE );
+
+	while( tail != head ) {
+		rec = r->data + (tail & r->mask);
+		if( (len = *((uint32_t *) rec)) == MCLR_PAD ) {
+			tail += (r->mask + 1) - (tail & r->mask);
+			__atomic_store_n( &h->tail, tail, __ATOMIC_RELEASE );
+			continue;
+		}
+
+		if( mtype != NULL ) {
+			*mtype = *((int32_t *) (rec + 4));
+		}
+		if( ts != NULL ) {
+			*ts = *((uint64_t *) (rec + 8));
+		}
+		*data = rec + MCLR_REC_HDR;
+		r->pending = (MCLR_REC_HDR + len + 7) & ~7;
+		return (int) len;
+	}
+
+	return 0;
+}
+
+/*
+	Consumer: give the space used by the message last returned by mclr_next()
+	back to the producer.
+*/
+static inline void mclr_release( mclr_t* r ) {
+	if( r->pending ) {
+		__atomic_store_n( &r->hdr->tail, r->hdr->tail + r->pending, __ATOMIC_RELEASE );
+		r->pending = 0;
+	}
+}
+
+/*
+	Consumer: wait up to timeout_ms for something to arrive (a negative
+	timeout waits forever). Returns 1 if the ring is not empty.
+*/
+static inline int mclr_wait( mclr_t* r, int timeout_ms ) {
+	mclr_hdr_t*	h;
+	struct timespec	to;
+	uint32_t	seq;
+	int			i;
+
+	h = r->hdr;
+	for( i = 0; i < MCLR_SPIN; i++ ) {
+		if( __atomic_load_n( &h->head, __ATOMIC_ACQUIRE ) != h->tail ) {
+			return 1;
+		}
+	}
+
+	seq = __atomic_load_n( &h->seq, __ATOMIC_SEQ_CST );
+	__atomic_store_n( &h->waiting, 1, __ATOMIC_SEQ_CST );
+	if( __atomic_load_n( &h->head, __ATOMIC_SEQ_CST ) == h->tail ) {		// producer did not slip one in
+		to.tv_sec = timeout_ms / 1000;
+		to.tv_nsec = (timeout_ms % 1000) * 1000000;
+		mclr_futex( &h->seq, FUTEX_WAIT, seq, timeout_ms < 0 ? NULL : &to );
+	}
+	__atomic_store_n( &h->waiting, 0, __ATOMIC_SEQ_CST );
+
+	return __atomic_load_n( &h->head, __ATOMIC_ACQUIRE ) != h->tail;
+}
+
+#endif
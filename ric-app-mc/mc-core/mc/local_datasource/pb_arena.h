@@ -0,0 +1,272 @@
+/*
+==============================================================================
+
+        Copyright (c) 2018-2019 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+=============================================================================
+*/
+
+/*
+	Protobuf unpacking support for the data source.
+
+	pb_arena_t is a bump allocator for protobuf-c. Everything a message
+	unpacks into is carved from one block, nothing is freed individually
+	(the *__free_unpacked() functions must not be called), and the whole
+	lot is given back with pb_arena_reset() once the message has been
+	processed. If a message does not fit, overflow blocks are malloc'd
+	and on reset the block is grown so that the next one will.
+
+	pb_prune() returns a copy of a message descriptor, and of the
+	descriptors below it, that lists only the sub-message fields in the
+	keep list (scalar fields are always kept). Sub-messages which are not
+	kept are not unpacked: protobuf-c leaves them as unknown fields (a
+	single copy of their bytes). The keep lists for the data source are
+	generated from the handlers in rts_proto.c (gen_pb_keep.py).
+
+	Header only so that the benchmark can use it as is.
+*/
+
+#ifndef PB_ARENA_H
+#define PB_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <protobuf-c/protobuf-c.h>
+
+#define PB_ARENA_DEF_SIZE	(64 * 1024)
+#define PB_ARENA_ALIGN		16
+
+typedef struct pb_arena_blk {
+	struct pb_arena_blk *next;
+	size_t	size;				// bytes in data
+	size_t	used;
+	char	*data;
+} pb_arena_blk_t;
+
+typedef struct {
+	ProtobufCAllocator allocator;	// give &arena.allocator to the unpack functions
+	pb_arena_blk_t	blk;			// the block that is used for every message
+	pb_arena_blk_t	*extra;			// overflow blocks for this message
+	size_t	need;					// bytes used by this message, across blocks
+	unsigned long	nallocs;		// allocations since init
+	unsigned long	nmallocs;		// of those, ones which went to malloc()
+} pb_arena_t;
+
+/*
+	An entry in a keep list: the sub-message field with the number id in
+	messages described by desc. Lists end with a nil desc.
+*/
+typedef struct {
+	const ProtobufCMessageDescriptor *desc;
+	uint32_t id;
+} pb_keep_t;
+
+static void *pb_arena_alloc(void *ad, size_t size) {
+	pb_arena_t *a = (pb_arena_t *) ad;
+	pb_arena_blk_t *b;
+	void *p;
+
+	size = (size + PB_ARENA_ALIGN - 1) & ~((size_t) PB_ARENA_ALIGN - 1);
+	a->nallocs++;
+	a->need += size;
+
+	if (a->blk.used + size <= a->blk.size) {
+		p = a->blk.data + a->blk.used;
+		a->blk.used += size;
+		return p;
+	}
+
+	b = a->extra;
+	if (b == NULL || b->used + size > b->size) {
+		a->nmallocs++;
+		if ((b = (pb_arena_blk_t *) malloc(sizeof(*b))) == NULL) {
+			return NULL;
+		}
+		b->size = size > a->blk.size ? size : a->blk.size;
+		if ((b->data = (char *) malloc(b->size)) == NULL) {
+			free(b);
+			return NULL;
+		}
+		b->used = 0;
+		b->next = a->extra;
+		a->extra = b;
+	}
+
+	p = b->data + b->used;
+	b->used += size;
+	return p;
+}
+
+static void pb_arena_nofree(void *ad, void *p) {
+	(void) ad;
+	(void) p;					// given back all at once by pb_arena_reset()
+}
+
+/*
+	Set up the arena with a block of size bytes (0 gives the default).
+*/
+static void pb_arena_init(pb_arena_t *a, size_t size) {
+	memset(a, 0, sizeof(*a));
+	a->allocator.alloc = pb_arena_alloc;
+	a->allocator.free = pb_arena_nofree;
+	a->allocator.allocator_data = a;
+
+	a->blk.size = size > 0 ? size : PB_ARENA_DEF_SIZE;
+	if ((a->blk.data = (char *) malloc(a->blk.size)) == NULL) {
+		a->blk.size = 0;		// every allocation will go to an overflow block
+	}
+}
+
+/*
+	Give back everything unpacked since the last reset. If overflow blocks
+	were needed the block is grown to hold what the message needed.
+*/
+static void pb_arena_reset(pb_arena_t *a) {
+	pb_arena_blk_t *b;
+	char *nd;
+
+	if (a->extra != NULL) {
+		while ((b = a->extra) != NULL) {
+			a->extra = b->next;
+			free(b->data);
+			free(b);
+		}
+
+		if ((nd = (char *) malloc(a->need)) != NULL) {
+			free(a->blk.data);
+			a->blk.data = nd;
+			a->blk.size = a->need;
+		}
+	}
+
+	a->blk.used = 0;
+	a->need = 0;
+}
+
+static int pb_keep_field(const pb_keep_t *keep, const ProtobufCMessageDescriptor *desc, uint32_t id) {
+	for (; keep->desc != NULL; keep++) {
+		if (keep->desc == desc && keep->id == id) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+typedef struct {
+	const ProtobufCMessageDescriptor **orig;
+	ProtobufCMessageDescriptor **pruned;
+	int n;
+	int alloc;
+} pb_prune_memo_t;
+
+static ProtobufCMessageDescriptor *pb_prune_one(const ProtobufCMessageDescriptor *d, const pb_keep_t *keep, pb_prune_memo_t *memo) {
+	ProtobufCMessageDescriptor *nd;
+	ProtobufCFieldDescriptor *fields;
+	ProtobufCIntRange *ranges;
+	unsigned *by_name;
+	unsigned n = 0;
+	unsigned nr = 0;
+	unsigned i;
+	unsigned j;
+	unsigned t;
+
+	for (i = 0; i < (unsigned) memo->n; i++) {			// already done (messages may recurse)
+		if (memo->orig[i] == d) {
+			return memo->pruned[i];
+		}
+	}
+
+	nd = (ProtobufCMessageDescriptor *) malloc(sizeof(*nd));
+	fields = (ProtobufCFieldDescriptor *) malloc(sizeof(*fields) * (d->n_fields + 1));
+	ranges = (ProtobufCIntRange *) malloc(sizeof(*ranges) * (d->n_fields + 1));
+	by_name = (unsigned *) malloc(sizeof(*by_name) * (d->n_fields + 1));
+	if (nd == NULL || fields == NULL || ranges == NULL || by_name == NULL) {
+		free(nd); free(fields); free(ranges); free(by_name);
+		return (ProtobufCMessageDescriptor *) d;		// no memory; don't prune this one
+	}
+
+	if (memo->n >= memo->alloc) {
+		memo->alloc = memo->alloc ? memo->alloc * 2 : 64;
+		memo->orig = (const ProtobufCMessageDescriptor **) realloc(memo->orig, sizeof(*memo->orig) * memo->alloc);
+		memo->pruned = (ProtobufCMessageDescriptor **) realloc(memo->pruned, sizeof(*memo->pruned) * memo->alloc);
+	}
+	memo->orig[memo->n] = d;
+	memo->pruned[memo->n] = nd;
+	memo->n++;
+
+	*nd = *d;
+	for (i = 0; i < d->n_fields; i++) {
+		if (d->fields[i].type == PROTOBUF_C_TYPE_MESSAGE && !pb_keep_field(keep, d, d->fields[i].id)) {
+			continue;
+		}
+		fields[n++] = d->fields[i];
+	}
+	for (i = 0; i < n; i++) {
+		if (fields[i].type == PROTOBUF_C_TYPE_MESSAGE) {
+			fields[i].descriptor = pb_prune_one((const ProtobufCMessageDescriptor *) fields[i].descriptor, keep, memo);
+		}
+	}
+
+	for (i = 0; i < n; i++) {							// fields are in id order; ranges are runs of consecutive ids
+		if (i == 0 || fields[i].id != fields[i-1].id + 1) {
+			ranges[nr].start_value = fields[i].id;
+			ranges[nr].orig_index = i;
+			nr++;
+		}
+	}
+	ranges[nr].start_value = 0;
+	ranges[nr].orig_index = n;
+
+	for (i = 0; i < n; i++) {							// small lists; insertion sort
+		by_name[i] = i;
+		for (j = i; j > 0 && strcmp(fields[by_name[j-1]].name, fields[by_name[j]].name) > 0; j--) {
+			t = by_name[j];
+			by_name[j] = by_name[j-1];
+			by_name[j-1] = t;
+		}
+	}
+
+	nd->n_fields = n;
+	nd->fields = fields;
+	nd->fields_sorted_by_name = by_name;
+	nd->n_field_ranges = nr;
+	nd->field_ranges = ranges;
+	nd->message_init = NULL;		// generated init would set the original descriptor in the message
+
+	return nd;
+}
+
+/*
+	Return the pruned copy of desc. A nil keep list returns desc itself.
+	The copies are never freed; this is done once at start up.
+*/
+static const ProtobufCMessageDescriptor *pb_prune(const ProtobufCMessageDescriptor *desc, const pb_keep_t *keep) {
+	pb_prune_memo_t memo;
+	const ProtobufCMessageDescriptor *nd;
+
+	if (keep == NULL) {
+		return desc;
+	}
+
+	memset(&memo, 0, sizeof(memo));
+	nd = pb_prune_one(desc, keep, &memo);
+	free(memo.orig);
+	free(memo.pruned);
+
+	return nd;
+}
+
+#endif
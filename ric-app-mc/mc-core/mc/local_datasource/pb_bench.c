@@ -0,0 +1,225 @@
+/*
+==============================================================================
+
+        Copyright (c) 2018-2019 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+=============================================================================
+*/
+
+/*
+	Decode benchmark for the data source. Reads records in the format the
+	listener writes to a fifo (28 byte header then the X2APStreaming
+	message) and unpacks each one, several times over, three ways:
+
+		malloc	the default allocator, then *__free_unpacked() (the old way)
+		arena	the pb_arena allocator, reset after each message
+		pruned	the arena and the descriptor pruned for the interface
+
+	Records can be captured from the data_gen generators by reading the
+	fifo they write, e.g. for the RRCXFER interface:
+
+		python rrcx_gen.py &
+		cat /tmp/mcl/fifos/MT_000010350 >rrcx.dat		(interrupt after a while)
+		pb_bench -i RRCXFER rrcx.dat
+
+	Usage: pb_bench [-i interface] [-p passes] file
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "x2ap_streaming.pb-c.h"
+#include "ue_context_release.pb-c.h"
+#include "secondary_rat_data_usage_report.pb-c.h"
+#include "sgnb_reconfiguration_complete.pb-c.h"
+#include "sgnb_release_confirm.pb-c.h"
+#include "sgnb_release_request.pb-c.h"
+#include "sgnb_release_request_acknowledge.pb-c.h"
+#include "sgnb_release_required.pb-c.h"
+#include "rrctransfer.pb-c.h"
+#include "sgnb_addition_request_reject.pb-c.h"
+#include "sgnb_addition_request_acknowledge.pb-c.h"
+#include "sgnb_addition_request.pb-c.h"
+#include "sgnb_modification_confirm.pb-c.h"
+#include "sgnb_modification_request.pb-c.h"
+#include "sgnb_modification_request_acknowledge.pb-c.h"
+#include "sgnb_modification_request_reject.pb-c.h"
+#include "sgnb_modification_required.pb-c.h"
+#include "sgnb_modification_refuse.pb-c.h"
+#include "sn_status_transfer.pb-c.h"
+
+#include "pb_arena.h"
+#include "pb_keep.h"
+
+#define HDR_LEN	28
+
+typedef struct {
+	unsigned char *data;
+	size_t len;
+} rec_t;
+
+static unsigned long nmalloc = 0;
+
+static void *count_alloc(void *ad, size_t size) {
+	nmalloc++;
+	return malloc(size);
+}
+
+static void count_free(void *ad, void *p) {
+	free(p);
+}
+
+static double mono_sec() {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+/*
+	Read the records in the file; returns the number read.
+*/
+static int load(const char *fname, rec_t **recs) {
+	FILE *f;
+	char hdr[HDR_LEN];
+	rec_t *r = NULL;
+	int n = 0;
+	int alloc = 0;
+	int len;
+
+	if ((f = fopen(fname, "r")) == NULL) {
+		perror(fname);
+		exit(1);
+	}
+
+	while (fread(hdr, HDR_LEN, 1, f) == 1) {
+		if (strncmp(hdr, "@MCL", 4) != 0 || (len = atoi(hdr + 4)) <= 0) {
+			fprintf(stderr, "record %d: bad header; stopping\n", n);
+			break;
+		}
+		if (n >= alloc) {
+			alloc = alloc ? alloc * 2 : 1024;
+			r = (rec_t *) realloc(r, sizeof(*r) * alloc);
+		}
+		r[n].len = len;
+		r[n].data = (unsigned char *) malloc(len);
+		if (fread(r[n].data, len, 1, f) != 1) {
+			fprintf(stderr, "record %d: short; stopping\n", n);
+			break;
+		}
+		n++;
+	}
+
+	fclose(f);
+	*recs = r;
+	return n;
+}
+
+static void report(const char *what, long nmsgs, double elapsed, unsigned long nallocs, unsigned long nmallocs, long nfail) {
+	fprintf(stdout, "%-8s %8ld msgs  %8.0f ns/msg  %6.1f allocs/msg  %6.2f mallocs/msg  %ld failed\n",
+		what, nmsgs, (elapsed * 1000000000.0) / (double) nmsgs, (double) nallocs / nmsgs, (double) nmallocs / nmsgs, nfail);
+}
+
+int main(int argc, char **argv) {
+	ProtobufCAllocator counting = { count_alloc, count_free, NULL };
+	const ProtobufCMessageDescriptor *full = &streaming_protobufs__x2_apstreaming__descriptor;
+	const ProtobufCMessageDescriptor *pruned = NULL;
+	pb_arena_t arena;
+	ProtobufCMessage *m;
+	rec_t *recs;
+	char *iface = "RRCXFER";
+	int passes = 100;
+	int nrecs;
+	int opt;
+	int p;
+	int i;
+	long nfail;
+	double start;
+
+	while ((opt = getopt(argc, argv, "i:p:")) != -1) {
+		switch (opt) {
+			case 'i':	iface = optarg; break;
+			case 'p':	passes = atoi(optarg); break;
+			default:
+				fprintf(stderr, "usage: %s [-i interface] [-p passes] file\n", argv[0]);
+				exit(1);
+		}
+	}
+	if (optind >= argc) {
+		fprintf(stderr, "usage: %s [-i interface] [-p passes] file\n", argv[0]);
+		exit(1);
+	}
+
+	if ((nrecs = load(argv[optind], &recs)) <= 0) {
+		fprintf(stderr, "no records in %s\n", argv[optind]);
+		exit(1);
+	}
+
+	for (i = 0; pb_keep_tab[i].iface != NULL; i++) {
+		if (strcmp(pb_keep_tab[i].iface, iface) == 0) {
+			pruned = pb_prune(full, pb_keep_tab[i].keep);
+		}
+	}
+	if (pruned == NULL) {
+		fprintf(stderr, "unknown interface: %s\n", iface);
+		exit(1);
+	}
+
+	fprintf(stdout, "%d records from %s, %d passes, interface %s\n", nrecs, argv[optind], passes, iface);
+
+	nfail = 0;
+	start = mono_sec();
+	for (p = 0; p < passes; p++) {
+		for (i = 0; i < nrecs; i++) {
+			if ((m = protobuf_c_message_unpack(full, &counting, recs[i].len, recs[i].data)) == NULL) {
+				nfail++;
+				continue;
+			}
+			protobuf_c_message_free_unpacked(m, &counting);
+		}
+	}
+	report("malloc", (long) passes * nrecs, mono_sec() - start, nmalloc, nmalloc, nfail);
+
+	pb_arena_init(&arena, 0);
+	nfail = 0;
+	start = mono_sec();
+	for (p = 0; p < passes; p++) {
+		for (i = 0; i < nrecs; i++) {
+			if (protobuf_c_message_unpack(full, &arena.allocator, recs[i].len, recs[i].data) == NULL) {
+				nfail++;
+			}
+			pb_arena_reset(&arena);
+		}
+	}
+	report("arena", (long) passes * nrecs, mono_sec() - start, arena.nallocs, arena.nmallocs, nfail);
+
+	free(arena.blk.data);
+	pb_arena_init(&arena, 0);
+	nfail = 0;
+	start = mono_sec();
+	for (p = 0; p < passes; p++) {
+		for (i = 0; i < nrecs; i++) {
+			if (protobuf_c_message_unpack(pruned, &arena.allocator, recs[i].len, recs[i].data) == NULL) {
+				nfail++;
+			}
+			pb_arena_reset(&arena);
+		}
+	}
+	report("pruned", (long) passes * nrecs, mono_sec() - start, arena.nallocs, arena.nmallocs, nfail);
+
+	return 0;
+}
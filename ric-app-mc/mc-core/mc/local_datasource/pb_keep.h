@@ -0,0 +1,352 @@
+// generated by gen_pb_keep.py from rts_proto.c; do not edit
+// For each interface, the sub-message fields that its handler reads.
+
+static const pb_keep_t pb_keep_CONRELEASE[] = {
+	{ &streaming_protobufs__uecontext_release__descriptor, 4 },	// id_new_enb_ue_x2ap_id_extension
+	{ &streaming_protobufs__uecontext_release__descriptor, 3 },	// id_old_enb_ue_x2ap_id_extension
+	{ &streaming_protobufs__uecontext_release__descriptor, 6 },	// id_sgnb_ue_x2ap_id
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 18 },	// uecontextrelease
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_RATDATAUSAGE[] = {
+	{ &streaming_protobufs__e__rabusage_report__item_ies__descriptor, 1 },	// id_e_rabusagereport_item
+	{ &streaming_protobufs__e__rabusage_report_list__descriptor, 1 },	// items
+	{ &streaming_protobufs__secondary_ratdata_usage_report__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__secondary_ratdata_usage_report__ies__descriptor, 4 },	// id_menb_ue_x2ap_id_extension
+	{ &streaming_protobufs__secondary_ratdata_usage_report__ies__descriptor, 3 },	// id_secondaryratusagereportlist
+	{ &streaming_protobufs__secondary_ratusage_report__item__descriptor, 3 },	// e_rabusagereportlist
+	{ &streaming_protobufs__secondary_ratusage_report__item_ies__descriptor, 1 },	// id_secondaryratusagereport_item
+	{ &streaming_protobufs__secondary_ratusage_report_list__descriptor, 1 },	// items
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 19 },	// secondaryratdatausagereport
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_RECONCOMPLETE[] = {
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__response_information_sg_nbreconf_comp__descriptor, 2 },	// reject_by_menb_sgnbreconfcomp
+	{ &streaming_protobufs__response_information_sg_nbreconf_comp__reject_by_me_nbitem__descriptor, 1 },	// cause
+	{ &streaming_protobufs__sg_nbreconfiguration_complete__descriptor, 4 },	// id_menb_ue_x2ap_id_extension
+	{ &streaming_protobufs__sg_nbreconfiguration_complete__descriptor, 3 },	// id_responseinformationsgnbreconfcomp
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 12 },	// sgnbreconfigurationcomplete
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_RELCONF[] = {
+	{ &streaming_protobufs__e__rabs__to_be_released__sg_nbrel_conf__item__descriptor, 2 },	// en_dc_resourceconfiguration
+	{ &streaming_protobufs__e__rabs__to_be_released__sg_nbrel_conf__item__descriptor, 3 },	// sgnbpdcppresent
+	{ &streaming_protobufs__e__rabs__to_be_released__sg_nbrel_conf_list__descriptor, 1 },	// id_e_rabs_tobereleased_sgnbrelconf_item
+	{ &streaming_protobufs__e__rabs__to_be_released__sg_nbrel_conf__sg_nbpdcppresent__descriptor, 2 },	// dl_gtptunnelendpoint
+	{ &streaming_protobufs__sg_nbrelease_confirm__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbrelease_confirm__ies__descriptor, 3 },	// id_e_rabs_tobereleased_sgnbrelconflist
+	{ &streaming_protobufs__sg_nbrelease_confirm__ies__descriptor, 5 },	// id_menb_ue_x2ap_id_extension
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 16 },	// sgnbreleaseconfirm
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_RELREQ[] = {
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__sg_nbrelease_request__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbrelease_request__ies__descriptor, 3 },	// id_cause
+	{ &streaming_protobufs__sg_nbrelease_request__ies__descriptor, 6 },	// id_menb_ue_x2ap_id_extension
+	{ &streaming_protobufs__sg_nbrelease_request__ies__descriptor, 2 },	// id_sgnb_ue_x2ap_id
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 13 },	// sgnbreleaserequest
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_RELREQACK[] = {
+	{ &streaming_protobufs__sg_nbrelease_request_acknowledge__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbrelease_request_acknowledge__ies__descriptor, 4 },	// id_menb_ue_x2ap_id_extension
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 14 },	// sgnbreleaserequestacknowledge
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNBRELEASERQD[] = {
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__e__rabs__to_be_released__sg_nbrel_reqd_list__descriptor, 1 },	// id_e_rabs_tobereleased_sgnbrelreqd_item
+	{ &streaming_protobufs__sg_nbrelease_required__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbrelease_required__ies__descriptor, 3 },	// id_cause
+	{ &streaming_protobufs__sg_nbrelease_required__ies__descriptor, 5 },	// id_e_rabs_tobereleased_sgnbrelreqdlist
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 15 },	// sgnbreleaserequired
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_RRCXFER[] = {
+	{ &streaming_protobufs__cell_results__descriptor, 1 },	// resultsssb_cell
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 1 },	// rsrp
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 2 },	// rsrq
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 3 },	// sinr
+	{ &streaming_protobufs__meas_result__descriptor, 1 },	// cellresults
+	{ &streaming_protobufs__meas_result__descriptor, 2 },	// rsindexresults
+	{ &streaming_protobufs__meas_result_list_nr__descriptor, 1 },	// items
+	{ &streaming_protobufs__meas_result_nr__descriptor, 2 },	// measresult
+	{ &streaming_protobufs__meas_result_nr__descriptor, 1 },	// physcellid
+	{ &streaming_protobufs__meas_result_serv_mo__descriptor, 2 },	// measresultservingcell
+	{ &streaming_protobufs__meas_result_serv_molist__descriptor, 1 },	// items
+	{ &streaming_protobufs__meas_results__descriptor, 3 },	// measresultlistnr
+	{ &streaming_protobufs__meas_results__descriptor, 2 },	// measresultservingmolist
+	{ &streaming_protobufs__measurement_report__descriptor, 1 },	// measurementreport
+	{ &streaming_protobufs__measurement_report__ies__descriptor, 1 },	// measresults
+	{ &streaming_protobufs__rrccontainer__descriptor, 1 },	// ul_dcch_message
+	{ &streaming_protobufs__rrctransfer__descriptor, 1 },	// rrctransfer_ies
+	{ &streaming_protobufs__rrctransfer__ies__descriptor, 4 },	// id_uenrmeasurement
+	{ &streaming_protobufs__results_per_csi__rs__index__descriptor, 2 },	// csi_rs_results
+	{ &streaming_protobufs__results_per_csi__rs__index_list__descriptor, 1 },	// items
+	{ &streaming_protobufs__results_per_ssb__index__descriptor, 2 },	// ssb_results
+	{ &streaming_protobufs__results_per_ssb__index_list__descriptor, 1 },	// items
+	{ &streaming_protobufs__rs_index_results__descriptor, 2 },	// resultscsi_rs_indexes
+	{ &streaming_protobufs__rs_index_results__descriptor, 1 },	// resultsssb_indexes
+	{ &streaming_protobufs__uenrmeasurement__descriptor, 1 },	// uenrmeasurements
+	{ &streaming_protobufs__ul__dcch__message_type__descriptor, 1 },	// measurementreport
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 2 },	// rrctransfer
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_ADDREQREJECT[] = {
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__sg_nbaddition_request_reject__descriptor, 3 },	// id_cause
+	{ &streaming_protobufs__sg_nbaddition_request_reject__descriptor, 2 },	// id_sgnb_ue_x2ap_id
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 5 },	// sgnbadditionrequestreject
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNB_ADDITION_REQ_ACK[] = {
+	{ &streaming_protobufs__cg__config__descriptor, 1 },	// criticalextensionschoice1
+	{ &streaming_protobufs__cg__config_critical_extensions_choice1__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__cg__config__ies__descriptor, 5 },	// candidatecellinfolistsn
+	{ &streaming_protobufs__cg__config__ies__descriptor, 9 },	// candidateservingfreqlistnr
+	{ &streaming_protobufs__cg__config__ies__descriptor, 6 },	// measconfigsn
+	{ &streaming_protobufs__cg__config__ies__descriptor, 1 },	// scg_cellgroupconfig
+	{ &streaming_protobufs__cg__config__ies__descriptor, 2 },	// scg_rb_config
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__cell_group_config__descriptor, 6 },	// spcellconfig
+	{ &streaming_protobufs__cell_results__descriptor, 2 },	// resultscsi_rs_cell
+	{ &streaming_protobufs__drb__to_add_mod__descriptor, 5 },	// recoverpdcp
+	{ &streaming_protobufs__drb__to_add_mod__descriptor, 4 },	// reestablishpdcp
+	{ &streaming_protobufs__drb__to_add_mod_list__descriptor, 1 },	// items
+	{ &streaming_protobufs__e__rab__item__descriptor, 2 },	// cause
+	{ &streaming_protobufs__e__rab__item_ies__descriptor, 1 },	// id_e_rab_item
+	{ &streaming_protobufs__e__rab__level__qo_s__parameters__descriptor, 2 },	// allocationandretentionpriority
+	{ &streaming_protobufs__e__rab__list__descriptor, 1 },	// items
+	{ &streaming_protobufs__e__rabs__admitted__to_be_added__sg_nbadd_req_ack__item__descriptor, 2 },	// en_dc_resourceconfiguration
+	{ &streaming_protobufs__e__rabs__admitted__to_be_added__sg_nbadd_req_ack__item__descriptor, 3 },	// sgnbpdcppresent
+	{ &streaming_protobufs__e__rabs__admitted__to_be_added__sg_nbadd_req_ack_list__descriptor, 1 },	// id_e_rabs_admitted_tobeadded_sgnbaddreqack_item
+	{ &streaming_protobufs__e__rabs__admitted__to_be_added__sg_nbadd_req_ack__sg_nbpdcppresent__descriptor, 4 },	// dl_forwarding_gtptunnelendpoint
+	{ &streaming_protobufs__e__rabs__admitted__to_be_added__sg_nbadd_req_ack__sg_nbpdcppresent__descriptor, 6 },	// mcg_e_rab_level_qos_parameters
+	{ &streaming_protobufs__meas_config_sn__descriptor, 1 },	// measuredfrequenciessn
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 1 },	// rsrp
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 2 },	// rsrq
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 3 },	// sinr
+	{ &streaming_protobufs__meas_result__descriptor, 1 },	// cellresults
+	{ &streaming_protobufs__meas_result__descriptor, 2 },	// rsindexresults
+	{ &streaming_protobufs__meas_result2_nr__descriptor, 3 },	// measresultservingcell
+	{ &streaming_protobufs__meas_result2_nr__descriptor, 2 },	// reffreqcsi_rs
+	{ &streaming_protobufs__meas_result2_nr__descriptor, 1 },	// ssbfrequency
+	{ &streaming_protobufs__meas_result_list2_nr__descriptor, 1 },	// items
+	{ &streaming_protobufs__meas_result_nr__descriptor, 2 },	// measresult
+	{ &streaming_protobufs__meas_result_nr__descriptor, 1 },	// physcellid
+	{ &streaming_protobufs__nr__freq_info__descriptor, 1 },	// measuredfrequency
+	{ &streaming_protobufs__rrcreconfiguration__descriptor, 2 },	// rrcreconfiguration
+	{ &streaming_protobufs__rrcreconfiguration__ies__descriptor, 2 },	// secondarycellgroup
+	{ &streaming_protobufs__radio_bearer_config__descriptor, 3 },	// drb_toaddmodlist
+	{ &streaming_protobufs__radio_bearer_config__descriptor, 4 },	// drb_toreleaselist
+	{ &streaming_protobufs__reconfiguration_with_sync__descriptor, 1 },	// spcellconfigcommon
+	{ &streaming_protobufs__results_per_csi__rs__index__descriptor, 2 },	// csi_rs_results
+	{ &streaming_protobufs__results_per_csi__rs__index_list__descriptor, 1 },	// items
+	{ &streaming_protobufs__results_per_ssb__index__descriptor, 2 },	// ssb_results
+	{ &streaming_protobufs__results_per_ssb__index_list__descriptor, 1 },	// items
+	{ &streaming_protobufs__rs_index_results__descriptor, 2 },	// resultscsi_rs_indexes
+	{ &streaming_protobufs__rs_index_results__descriptor, 1 },	// resultsssb_indexes
+	{ &streaming_protobufs__serving_cell_config_common__descriptor, 1 },	// physcellid
+	{ &streaming_protobufs__sg_nbaddition_request_acknowledge__descriptor, 3 },	// id_e_rabs_admitted_tobeadded_sgnbaddreqacklist
+	{ &streaming_protobufs__sg_nbaddition_request_acknowledge__descriptor, 4 },	// id_e_rabs_notadmitted_list
+	{ &streaming_protobufs__sg_nbaddition_request_acknowledge__descriptor, 7 },	// id_menb_ue_x2ap_id_extension
+	{ &streaming_protobufs__sg_nbaddition_request_acknowledge__descriptor, 5 },	// id_sgnbtomenbcontainer
+	{ &streaming_protobufs__sp_cell_config__descriptor, 2 },	// reconfigurationwithsync
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 4 },	// sgnbadditionrequestacknowledge
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNB_ADDITION_REQ[] = {
+	{ &streaming_protobufs__allocation_and_retention_priority__descriptor, 2 },	// pre_emptioncapability
+	{ &streaming_protobufs__allocation_and_retention_priority__descriptor, 3 },	// pre_emptionvulnerability
+	{ &streaming_protobufs__cg__config_info__descriptor, 1 },	// criticalextensionschoice1
+	{ &streaming_protobufs__cg__config_info_critical_extensions_choice1__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__cg__config_info__ies__descriptor, 2 },	// candidatecellinfolistmn
+	{ &streaming_protobufs__cg__config_info__ies__descriptor, 3 },	// candidatecellinfolistsn
+	{ &streaming_protobufs__cell_results__descriptor, 2 },	// resultscsi_rs_cell
+	{ &streaming_protobufs__cell_results__descriptor, 1 },	// resultsssb_cell
+	{ &streaming_protobufs__e__rab__level__qo_s__parameters__descriptor, 2 },	// allocationandretentionpriority
+	{ &streaming_protobufs__e__rab__level__qo_s__parameters__descriptor, 3 },	// gbrqosinformation
+	{ &streaming_protobufs__e__rabs__to_be_added__sg_nbadd_req__item__descriptor, 3 },	// en_dc_resourceconfiguration
+	{ &streaming_protobufs__e__rabs__to_be_added__sg_nbadd_req__item__descriptor, 4 },	// sgnbpdcppresent
+	{ &streaming_protobufs__e__rabs__to_be_added__sg_nbadd_req__item_ies__descriptor, 1 },	// id_e_rabs_tobeadded_sgnbaddreq_item
+	{ &streaming_protobufs__e__rabs__to_be_added__sg_nbadd_req_list__descriptor, 1 },	// items
+	{ &streaming_protobufs__e__rabs__to_be_added__sg_nbadd_req__sg_nbpdcppresent__descriptor, 1 },	// full_e_rab_level_qos_parameters
+	{ &streaming_protobufs__e__rabs__to_be_added__sg_nbadd_req__sg_nbpdcppresent__descriptor, 2 },	// max_mcg_admit_e_rab_level_qos_parameters
+	{ &streaming_protobufs__e__rabs__to_be_added__sg_nbadd_req__sg_nbpdcppresent__descriptor, 4 },	// menb_dl_gtp_teidatmcg
+	{ &streaming_protobufs__e__rabs__to_be_added__sg_nbadd_req__sg_nbpdcppresent__descriptor, 5 },	// s1_ul_gtptunnelendpoint
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 1 },	// rsrp
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 2 },	// rsrq
+	{ &streaming_protobufs__meas_quantity_results__descriptor, 3 },	// sinr
+	{ &streaming_protobufs__meas_result__descriptor, 1 },	// cellresults
+	{ &streaming_protobufs__meas_result2_nr__descriptor, 4 },	// measresultneighcelllistnr
+	{ &streaming_protobufs__meas_result2_nr__descriptor, 3 },	// measresultservingcell
+	{ &streaming_protobufs__meas_result_list2_nr__descriptor, 1 },	// items
+	{ &streaming_protobufs__meas_result_list_nr__descriptor, 1 },	// items
+	{ &streaming_protobufs__meas_result_nr__descriptor, 2 },	// measresult
+	{ &streaming_protobufs__meas_result_nr__descriptor, 1 },	// physcellid
+	{ &streaming_protobufs__sg_nbaddition_request__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbaddition_request__ies__descriptor, 7 },	// id_e_rabs_tobeadded_sgnbaddreqlist
+	{ &streaming_protobufs__sg_nbaddition_request__ies__descriptor, 11 },	// id_menb_ue_x2ap_id_extension
+	{ &streaming_protobufs__sg_nbaddition_request__ies__descriptor, 16 },	// id_menbcell_id
+	{ &streaming_protobufs__sg_nbaddition_request__ies__descriptor, 8 },	// id_menbtosgnbcontainer
+	{ &streaming_protobufs__sg_nbaddition_request__ies__descriptor, 4 },	// id_sgnbueaggregatemaximumbitrate
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 3 },	// sgnbadditionrequest
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNBMODCONF[] = {
+	{ &streaming_protobufs__sg_nbmodification_confirm__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 10 },	// sgnbmodificationconfirm
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNBMODREQ[] = {
+	{ &streaming_protobufs__cg__config_info__descriptor, 1 },	// criticalextensionschoice1
+	{ &streaming_protobufs__cg__config_info_critical_extensions_choice1__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__cg__config_info__ies__descriptor, 5 },	// scgfailureinfo
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__sg_nbmodification_request__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbmodification_request__ies__descriptor, 3 },	// id_cause
+	{ &streaming_protobufs__sg_nbmodification_request__ies__descriptor, 8 },	// id_menbtosgnbcontainer
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 6 },	// sgnbmodificationrequest
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNBMODREQACK[] = {
+	{ &streaming_protobufs__sg_nbmodification_request_acknowledge__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 7 },	// sgnbmodificationrequestacknowledge
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNBMODREQREJECT[] = {
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__sg_nbmodification_request_reject__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbmodification_request_reject__ies__descriptor, 3 },	// id_cause
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 8 },	// sgnbmodificationrequestreject
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNBMODREQUIRED[] = {
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__sg_nbmodification_required__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbmodification_required__ies__descriptor, 3 },	// id_cause
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 9 },	// sgnbmodificationrequired
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SGNBMODREFUSE[] = {
+	{ &streaming_protobufs__cause__descriptor, 4 },	// misc
+	{ &streaming_protobufs__cause__descriptor, 3 },	// protocol
+	{ &streaming_protobufs__cause__descriptor, 1 },	// radionetwork
+	{ &streaming_protobufs__cause__descriptor, 2 },	// transport
+	{ &streaming_protobufs__sg_nbmodification_refuse__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__sg_nbmodification_refuse__ies__descriptor, 3 },	// id_cause
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 11 },	// sgnbmodificationrefuse
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const pb_keep_t pb_keep_SNSTATUSXFER[] = {
+	{ &streaming_protobufs__e__rabs__subject_to_status_transfer__item__descriptor, 5 },	// ie_extensions
+	{ &streaming_protobufs__e__rabs__subject_to_status_transfer__item_ext_ies__descriptor, 6 },	// id_dlcountvaluepdcp_snlength18
+	{ &streaming_protobufs__e__rabs__subject_to_status_transfer__item_ies__descriptor, 1 },	// id_e_rabs_subjecttostatustransfer_item
+	{ &streaming_protobufs__e__rabs__subject_to_status_transfer__list__descriptor, 1 },	// items
+	{ &streaming_protobufs__snstatus_transfer__descriptor, 1 },	// protocolies
+	{ &streaming_protobufs__snstatus_transfer__ies__descriptor, 3 },	// id_e_rabs_subjecttostatustransfer_list
+	{ &streaming_protobufs__snstatus_transfer__ies__descriptor, 6 },	// id_sgnb_ue_x2ap_id
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 1 },	// header
+	{ &streaming_protobufs__x2_apstreaming__descriptor, 17 },	// snstatustransfer
+	{ &streaming_protobufs__x2_apstreaming_header__descriptor, 2 },	// gnbid
+	{ NULL, 0 }
+};
+
+static const struct { const char* iface; const pb_keep_t* keep; } pb_keep_tab[] = {
+	{ "CONRELEASE", pb_keep_CONRELEASE },
+	{ "RATDATAUSAGE", pb_keep_RATDATAUSAGE },
+	{ "RECONCOMPLETE", pb_keep_RECONCOMPLETE },
+	{ "RELCONF", pb_keep_RELCONF },
+	{ "RELREQ", pb_keep_RELREQ },
+	{ "RELREQACK", pb_keep_RELREQACK },
+	{ "SGNBRELEASERQD", pb_keep_SGNBRELEASERQD },
+	{ "RRCXFER", pb_keep_RRCXFER },
+	{ "ADDREQREJECT", pb_keep_ADDREQREJECT },
+	{ "SGNB_ADDITION_REQ_ACK", pb_keep_SGNB_ADDITION_REQ_ACK },
+	{ "SGNB_ADDITION_REQ", pb_keep_SGNB_ADDITION_REQ },
+	{ "SGNBMODCONF", pb_keep_SGNBMODCONF },
+	{ "SGNBMODREQ", pb_keep_SGNBMODREQ },
+	{ "SGNBMODREQACK", pb_keep_SGNBMODREQACK },
+	{ "SGNBMODREQREJECT", pb_keep_SGNBMODREQREJECT },
+	{ "SGNBMODREQUIRED", pb_keep_SGNBMODREQUIRED },
+	{ "SGNBMODREFUSE", pb_keep_SGNBMODREFUSE },
+	{ "SNSTATUSXFER", pb_keep_SNSTATUSXFER },
+	{ NULL, NULL }
+};
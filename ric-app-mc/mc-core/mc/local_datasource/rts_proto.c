@@ -42,6 +42,7 @@
 #include "packet.h"
 #include "schemaparser.h"
 #include "lfta/rts.h"
+#include "mcl_ring.h"		// copy of the listener's ring; keep in step with sidecars/listener/src
 
 void rts_fta_process_packet(struct packet * p);
 void rts_fta_done();
@@ -59,6 +60,9 @@ static gs_uint32_t verbose=0;
 static gs_uint32_t startupdelay=0;
 static gs_uint32_t singlefile=0;
 static gs_uint32_t fifo=0;
+static gs_uint32_t ring=0;		// read the listener's shared memory ring (<filename>.ring) rather than the fifo
+static mclr_t* rring=NULL;
+static gs_uint32_t fullunpack=0;	// don't prune sub-messages that no query uses
 static gs_uint32_t gshub=0;
 static int socket_desc=0;
 
@@ -129,6 +133,16 @@ static unsigned long long timestamp; // extract from input header
 #include "lfta/local/sgnb_mod_refuse.h"
 #include "sn_status_transfer.pb-c.h"
 #include "lfta/local/sn_status_transfer.h"
+
+// Messages are unpacked into an arena which is reset after each one, and
+// only the sub-messages that this interface's handler reads are unpacked
+// (pb_keep.h is generated from the handlers below by gen_pb_keep.py).
+#include "pb_arena.h"
+#include "pb_keep.h"
+
+static pb_arena_t pb_arena;
+static const ProtobufCMessageDescriptor *x2ap_desc = &streaming_protobufs__x2_apstreaming__descriptor;
+
 gs_uint32_t process_buffer_CONRELEASE(gs_uint8_t * buffer, gs_uint32_t buflen){
 	char *empty_string = "";
 unsigned long long int ts_lo, ts_hi;
@@ -144,7 +158,7 @@ unsigned long long int ts_lo, ts_hi;
 	dc_release = (struct _dc_release *)(cur_packet.record.packed.values);
 	cur_packet.schema = 201;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->uecontextrelease;
@@ -177,7 +191,6 @@ unsigned long long int ts_lo, ts_hi;
 	}
 	dc_release->id_Old_eNB_UE_X2AP_ID = node_0_0->id_old_enb_ue_x2ap_id;
 	rts_fta_process_packet(&cur_packet);
-	streaming_protobufs__uecontext_release__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -205,7 +218,7 @@ unsigned long long int ts_lo, ts_hi;
 	rat_data_usage = (struct _rat_data_usage *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1501;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->secondaryratdatausagereport;
@@ -254,7 +267,6 @@ unsigned long long int ts_lo, ts_hi;
 			}
 		}
 	}
-	streaming_protobufs__secondary_ratdata_usage_report__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -285,7 +297,7 @@ unsigned long long int ts_lo, ts_hi;
 	reconfig_all = (struct _reconfig_all *)(cur_packet.record.packed.values);
 	cur_packet.schema = 103;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbreconfigurationcomplete;
@@ -388,7 +400,6 @@ unsigned long long int ts_lo, ts_hi;
 			rts_fta_process_packet(&cur_packet);
 		}
 	}
-	streaming_protobufs__sg_nbreconfiguration_complete__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -418,7 +429,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_release_confirm_from_menb_erabs = (struct _sgnb_release_confirm_from_menb_erabs *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1101;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbreleaseconfirm;
@@ -499,7 +510,6 @@ unsigned long long int ts_lo, ts_hi;
 		}
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbrelease_confirm__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -519,7 +529,7 @@ unsigned long long int ts_lo, ts_hi;
 	release_req = (struct _release_req *)(cur_packet.record.packed.values);
 	cur_packet.schema = 801;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbreleaserequest;
@@ -569,7 +579,6 @@ unsigned long long int ts_lo, ts_hi;
 		}
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbrelease_request__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -589,7 +598,7 @@ unsigned long long int ts_lo, ts_hi;
 	release_req_ack = (struct _release_req_ack *)(cur_packet.record.packed.values);
 	cur_packet.schema = 901;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbreleaserequestacknowledge;
@@ -615,7 +624,6 @@ unsigned long long int ts_lo, ts_hi;
 		}
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbrelease_request_acknowledge__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -635,7 +643,7 @@ unsigned long long int ts_lo, ts_hi;
 	SgNB_release_rqd = (struct _SgNB_release_rqd *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1001;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbreleaserequired;
@@ -724,7 +732,6 @@ unsigned long long int ts_lo, ts_hi;
 		}
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbrelease_required__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -856,7 +863,7 @@ unsigned long long int ts_lo, ts_hi;
 	serv_nr_cell = (struct _serv_nr_cell *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->rrctransfer;
@@ -1359,7 +1366,6 @@ unsigned long long int ts_lo, ts_hi;
 			}
 		}
 	}
-	streaming_protobufs__rrctransfer__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -1379,7 +1385,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_add_req_reject = (struct _sgnb_add_req_reject *)(cur_packet.record.packed.values);
 	cur_packet.schema = 701;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbadditionrequestreject;
@@ -1425,7 +1431,6 @@ unsigned long long int ts_lo, ts_hi;
 		}
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbaddition_request_reject__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -1534,7 +1539,7 @@ unsigned long long int ts_lo, ts_hi;
 	eRABs_notadmitted_for_ue = (struct _eRABs_notadmitted_for_ue *)(cur_packet.record.packed.values);
 	cur_packet.schema = 501;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbadditionrequestacknowledge;
@@ -2185,7 +2190,6 @@ unsigned long long int ts_lo, ts_hi;
 			}
 		}
 	}
-	streaming_protobufs__sg_nbaddition_request_acknowledge__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -2354,7 +2358,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_addreq_gtp_teid = (struct _sgnb_addreq_gtp_teid *)(cur_packet.record.packed.values);
 	cur_packet.schema = 10001;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbadditionrequest;
@@ -3131,7 +3135,6 @@ unsigned long long int ts_lo, ts_hi;
 			}
 		}
 	}
-	streaming_protobufs__sg_nbaddition_request__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -3151,7 +3154,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_mod_conf = (struct _sgnb_mod_conf *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1301;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbmodificationconfirm;
@@ -3172,7 +3175,6 @@ unsigned long long int ts_lo, ts_hi;
 		sgnb_mod_conf->id_SgNB_UE_X2AP_ID = node_0_1->id_sgnb_ue_x2ap_id;
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbmodification_confirm__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -3192,7 +3194,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_mod_req = (struct _sgnb_mod_req *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1201;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbmodificationrequest;
@@ -3238,7 +3240,6 @@ unsigned long long int ts_lo, ts_hi;
 		}
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbmodification_request__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -3258,7 +3259,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_mod_req_ack = (struct _sgnb_mod_req_ack *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1701;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbmodificationrequestacknowledge;
@@ -3279,7 +3280,6 @@ unsigned long long int ts_lo, ts_hi;
 		sgnb_mod_req_ack->id_SgNB_UE_X2AP_ID = node_0_1->id_sgnb_ue_x2ap_id;
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbmodification_request_acknowledge__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -3299,7 +3299,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_mod_req_reject = (struct _sgnb_mod_req_reject *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1801;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbmodificationrequestreject;
@@ -3340,7 +3340,6 @@ unsigned long long int ts_lo, ts_hi;
 		}
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbmodification_request_reject__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -3360,7 +3359,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_mod_required = (struct _sgnb_mod_required *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1901;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbmodificationrequired;
@@ -3401,7 +3400,6 @@ unsigned long long int ts_lo, ts_hi;
 		}
 		rts_fta_process_packet(&cur_packet);
 	}
-	streaming_protobufs__sg_nbmodification_required__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -3422,7 +3420,7 @@ unsigned long long int ts_lo, ts_hi;
 	sgnb_mod_refuse = (struct _sgnb_mod_refuse *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1401;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->sgnbmodificationrefuse;
@@ -3466,7 +3464,6 @@ unsigned long long int ts_lo, ts_hi;
 			rts_fta_process_packet(&cur_packet);
 		}
 	}
-	streaming_protobufs__sg_nbmodification_refuse__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -3493,7 +3490,7 @@ unsigned long long int ts_lo, ts_hi;
 	sn_status_transfer = (struct _sn_status_transfer *)(cur_packet.record.packed.values);
 	cur_packet.schema = 1601;
 
-	hdr = streaming_protobufs__x2_apstreaming__unpack(NULL, buflen, buffer);
+	hdr = (StreamingProtobufs__X2APStreaming *) protobuf_c_message_unpack(x2ap_desc, &pb_arena.allocator, buflen, buffer);
 	if(hdr==NULL) return -1;
 
 	node_0_0 = hdr->snstatustransfer;
@@ -3535,7 +3532,6 @@ unsigned long long int ts_lo, ts_hi;
 			}
 		}
 	}
-	streaming_protobufs__snstatus_transfer__free_unpacked(node_0_0,NULL);
 	return 0;
 }
 
@@ -3682,6 +3678,26 @@ static void next_file() {
 	}
 }
 
+//	Wait for the listener to create the ring for this interface and map it.
+//	The ring replaces the fifo named by Filename; the listener writes it when
+//	the message type is in MCL_RING_TYPES.
+static void next_ring() {
+	char rname[1024];
+
+	snprintf(rname, sizeof(rname), "%s.ring", name);
+	if (verbose) {
+		fprintf(stderr,"Opening ring %s\n",rname);
+	}
+	while ((rring=mclr_open(rname,0,0))==NULL) {
+		if (errno!=ENOENT && errno!=EAGAIN) {
+			print_error("dproto::unable to open ring");
+			exit(10);
+		}
+		dproto_replay_check_messages();
+		usleep(10000);
+	}
+}
+
 //	Perform initialization when reading from a file
 static gs_retval_t dproto_replay_init(gs_sp_t device) {
     gs_sp_t  verbosetmp;
@@ -3690,6 +3706,8 @@ static gs_retval_t dproto_replay_init(gs_sp_t device) {
     gs_sp_t  tempdel;
     gs_sp_t  singlefiletmp;
     gs_sp_t  fifotmp;	
+    gs_sp_t  ringtmp;
+    gs_sp_t  fulltmp;
     
     if ((name=get_iface_properties(device,"filename"))==0) {
 		print_error("dproto_init::No protobuf \"Filename\" defined");
@@ -3725,6 +3743,23 @@ static gs_retval_t dproto_replay_init(gs_sp_t device) {
         }
     }	
     
+    if ((ringtmp=get_iface_properties(device,"ring"))!=0) {
+        if (strncmp(ringtmp,"TRUE",4)==0) {
+            ring=1;
+            if (verbose)
+                fprintf(stderr,"RING ENABLED\n");
+        }
+    }
+
+    // unpack every sub-message; needed only if the handlers are changed without rerunning gen_pb_keep.py
+    if ((fulltmp=get_iface_properties(device,"fullunpack"))!=0) {
+        if (strncmp(fulltmp,"TRUE",4)==0) {
+            fullunpack=1;
+            if (verbose)
+                fprintf(stderr,"FULL UNPACK ENABLED\n");
+        }
+    }
+
     if ((delaytmp=get_iface_properties(device,"startupdelay"))!=0) {
         if (verbose) {
             fprintf(stderr,"Startup delay of %u seconds\n",atoi(get_iface_properties(device,"startupdelay")));
@@ -3763,6 +3798,7 @@ static gs_retval_t dproto_read_socket()
 
 	cur_packet.systemTime=time(0);
 	ret = process_buffer(line, pkg_len);
+	pb_arena_reset(&pb_arena);
 	if(ret < 0){
             fprintf(stderr,"proto rejected by device %s, err=%d\n",this_device, ret);
         }
@@ -3770,6 +3806,36 @@ static gs_retval_t dproto_read_socket()
     return 0;
 }
     
+// read one message from the listener's ring; the message is handed to the
+// parser where it sits in the ring, and released once it has been processed.
+// The ring never ends, so there is no eof (-2) return.
+static gs_retval_t dproto_read_ring(){
+	char *data;
+	int len;
+	gs_retval_t ret;
+
+	if (rring==NULL) next_ring();
+
+	if ((len=mclr_next(rring,NULL,NULL,&data))<=0) {
+		if (!mclr_wait(rring,10)) {		// use 10ms timeout like the fifo
+			return -1;
+		}
+		if ((len=mclr_next(rring,NULL,NULL,&data))<=0) {
+			return -1;
+		}
+	}
+
+	cur_packet.systemTime=time(0);
+	ret = process_buffer((gs_uint8_t *)data, len);
+	pb_arena_reset(&pb_arena);
+	if(ret < 0){
+		fprintf(stderr,"proto rejected by device %s, err=%d\n",this_device, ret);
+	}
+	mclr_release(rring);
+
+	return 0;
+}
+
 // read one message from a file
 static gs_retval_t dproto_read_tuple(){
     gs_uint32_t retlen=0;
@@ -3780,6 +3846,7 @@ static gs_retval_t dproto_read_tuple(){
 	char *timestamp_s;
 	gs_retval_t ret;
 
+    if (ring) return dproto_read_ring();
     if (fd==-1) next_file();
 
 	retlen = read_fifo(&pfd, line, 28, 10);	// use 10ms timeout
@@ -3812,6 +3879,7 @@ static gs_retval_t dproto_read_tuple(){
 		if(eof==0){
 			cur_packet.systemTime=time(0);
 			ret = process_buffer(line, pkg_len);
+			pb_arena_reset(&pb_arena);
 			if(ret < 0){
             	fprintf(stderr,"proto rejected by device %s, err=%d\n",this_device, ret);
         	}
@@ -3869,6 +3937,7 @@ static gs_retval_t dproto_process_file(){
 //	Entry for processing this interface
 gs_retval_t main_dproto(gs_int32_t devicenum, gs_sp_t device, gs_int32_t mapcnt, gs_sp_t map[]) {
     gs_uint32_t cont;
+    gs_uint32_t i;
     endpoint mygshub;
         
     dproto_replay_init(device); // will call init_cur_packet
@@ -3946,6 +4015,13 @@ gs_retval_t main_dproto(gs_int32_t devicenum, gs_sp_t device, gs_int32_t mapcnt,
 	}
 //--------------------------------------------
 
+	pb_arena_init(&pb_arena, 0);
+	for (i=0; fullunpack==0 && pb_keep_tab[i].iface!=NULL; i++) {
+		if (strcmp(device,pb_keep_tab[i].iface)==0) {
+			x2ap_desc = pb_prune(&streaming_protobufs__x2_apstreaming__descriptor, pb_keep_tab[i].keep);
+		}
+	}
+
         
     fta_init(device); /*xxx probably should get error code back put Ted doesn't give me one*/
         
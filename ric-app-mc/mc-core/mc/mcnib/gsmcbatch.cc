@@ -0,0 +1,514 @@
+/* ------------------------------------------------
+ Copyright 2014 AT&T Intellectual Property
+ Licensed under the Apache License, Version 2.0 (the "License");
+ you may not use this file except in compliance with the License.
+ You may obtain a copy of the License at
+
+ http://www.apache.org/licenses/LICENSE-2.0
+
+ Unless required by applicable law or agreed to in writing, software
+ distributed under the License is distributed on an "AS IS" BASIS,
+ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ See the License for the specific language governing permissions and
+ limitations under the License.
+ ------------------------------------------- */
+
+/*
+ * Collect the results of a query into columnar batches (mc_colbatch.h)
+ * and ship each batch with a single write: to the MC-NIB (the default),
+ * appended to a file (-f), or to a tcp client (-p).  A batch is shipped
+ * when it holds -b rows, or when a temporal tuple arrives and the batch
+ * is older than -F milliseconds.
+ *
+ * In the MC-NIB only the last -K batches are kept: the batch with
+ * sequence number seq goes to key <query>:_batch:<seq mod K>, replacing
+ * the batch that was there.  A reader finds the batches by the prefix
+ * <query>:_batch: and orders them by the seq in their headers (the
+ * largest is the newest; seq starts from the time of day in
+ * microseconds, so it also grows across restarts).
+ * Based on gsmcnib.cc.
+*/
+
+#include <app.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/time.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+
+#include "gsconfig.h"
+#include "gstypes.h"
+#include "gshub.h"
+
+#include <schemaparser.h>
+
+#include <sdl/syncstorage.hpp>
+
+#include "mc_colbatch.h"
+
+using namespace std;
+using namespace mc_colbatch;
+
+//	data type definitions from sdl
+using Namespace = std::string;
+using Key = std::string;
+using Data = std::vector<uint8_t>;
+using DataMap = std::map<Key, Data>;
+using Keys = std::set<Key>;
+
+
+
+static unsigned tcpport=0;
+int listensockfd=0;
+int fd=0;
+int outfd=-1;
+
+static colbatch_writer *cbw = NULL;
+static std::unique_ptr<shareddatalayer::SyncStorage> sdl;
+static string key_base;
+static unsigned batch_keys = 64;
+
+static volatile sig_atomic_t stop_signal = 0;
+
+// Not all systems have timersub defined so make sure its ther
+#ifndef timersub
+
+#define timersub(tvp, uvp, vvp)                                         \
+do {                                                            \
+(vvp)->tv_sec = (tvp)->tv_sec - (uvp)->tv_sec;          \
+(vvp)->tv_usec = (tvp)->tv_usec - (uvp)->tv_usec;       \
+if ((vvp)->tv_usec < 0) {                               \
+(vvp)->tv_sec--;                                \
+(vvp)->tv_usec += 1000000;                      \
+}                                                       \
+} while (0)
+
+#endif
+
+static void wait_for_client() {
+    struct sockaddr_in serv_addr,cli_addr;
+    socklen_t clilen;
+    if (listensockfd==0) {
+		gs_int32_t on = 1;
+		listensockfd=socket(AF_INET, SOCK_STREAM, 0);
+        if (listensockfd < 0) {
+			gslog(LOG_EMERG,"Error:Could not create socket for tcp data stream");
+			exit(1);
+		}
+		bzero((char *) &serv_addr, sizeof(serv_addr));
+		serv_addr.sin_family = AF_INET;
+		serv_addr.sin_addr.s_addr = INADDR_ANY;
+		serv_addr.sin_port = htons(tcpport);
+#ifndef __linux__
+        /* make sure we can reuse the common port rapidly */
+        if (setsockopt(listensockfd, SOL_SOCKET, SO_REUSEPORT,
+                       (gs_sp_t )&on, sizeof(on)) != 0) {
+            gslog(LOG_EMERG,"Error::could not set socket option\n");
+            exit(1);
+        }
+#endif
+        if (setsockopt(listensockfd, SOL_SOCKET, SO_REUSEADDR,
+                       (gs_sp_t )&on, sizeof(on)) != 0) {
+            gslog(LOG_EMERG,"Error::could not set socket option\n");
+            exit(1);
+		}
+
+		if (bind(listensockfd, (struct sockaddr *) &serv_addr,
+                 sizeof(serv_addr)) < 0) {
+			gslog(LOG_EMERG,"Error:Could not bind socket for tcp data stream");
+            exit(1);
+        }
+	}
+
+	do {
+		listen(listensockfd,5);
+		clilen = sizeof(cli_addr);
+		fd=accept(listensockfd, (struct sockaddr *) &cli_addr, &clilen);
+		if (fd<0) {
+            gslog(LOG_EMERG,"Error:Could not accept connection on tcp socket");
+		}
+	} while (fd==0);
+}
+
+static void emit_socket(const char *buf, unsigned l) {
+	unsigned o;
+	int w;
+	o=0;
+	do {
+		if((w=write(fd,&buf[o],l-o))<=0) {
+			close(fd);
+			wait_for_client();
+			o=0;			// the client gets whole batches only
+			continue;
+		}
+		o=o+w;
+	} while (o<l);
+}
+
+static void emit_file(const char *buf, unsigned l) {
+	unsigned o;
+	int w;
+	o=0;
+	do {
+		if((w=write(outfd,&buf[o],l-o))<=0) {
+			gslog(LOG_WARNING,"Error writing batch: %s",strerror(errno));
+			return;
+		}
+		o=o+w;
+	} while (o<l);
+}
+
+// ship the batch, if it has anything in it, and start the next
+static void flush_batch() {
+	const char *buf;
+	unsigned int len;
+
+	if (cbw==NULL || cbw->get_num_rows()==0)
+		return;
+	buf=cbw->finish(&len);
+	if (tcpport!=0) {
+		emit_socket(buf, len);
+	} else if (outfd>=0) {
+		emit_file(buf, len);
+	} else {
+		Namespace ns("mcnib");
+		DataMap D;
+		D[key_base+":_batch:"+to_string(cbw->get_seq()%batch_keys)] = Data((const uint8_t *)buf, (const uint8_t *)buf+len);
+		sdl->set(ns, D);
+	}
+	cbw->reset();
+}
+
+static void stop_and_exit(int iv) {
+	flush_batch();
+    ftaapp_exit();
+    fprintf(stderr, "exiting via signal handler %d...\n", iv);
+    exit(1);
+}
+
+// the batch is shipped from the main loop, as neither the sdl nor the
+// writer may be used here; a second signal exits at once
+void hand(int iv) {
+	if (stop_signal)
+		_exit(1);
+	stop_signal = iv;
+}
+
+int main(int argc, char* argv[]) {
+    gs_sp_t me = argv[0];
+    FTAID fta_id;
+    gs_int32_t schema, ch;
+
+    FTAID rfta_id;
+    gs_uint32_t rsize;
+    gs_uint32_t bufsz=8*1024*1024;
+    gs_int8_t rbuf[2*MAXTUPLESZ];
+
+    gs_int32_t numberoffields;
+    gs_int32_t verbose=0;
+    gs_int32_t y, lcv;
+
+    void *pblk;
+    gs_int32_t pblklen;
+	gs_int32_t n_actual_param;
+	gs_int32_t n_expected_param;
+    gs_int32_t xit = 0;
+    gs_int32_t dump = 0;
+    struct timeval tvs, tve, tvd;
+    gs_retval_t code;
+    endpoint gshub;
+    endpoint dummyep;
+    gs_uint32_t tip1,tip2,tip3,tip4;
+    gs_sp_t instance_name;
+
+	gs_int32_t batch_rows = MC_CB_DEF_ROWS;
+	gs_int32_t flush_ms = 1000;
+	gs_sp_t outflnm = NULL;
+	struct timeval batch_start;
+
+    gs_uint32_t tlimit = 0;     // time limit in seconds
+    time_t start_time, curr_time;
+
+	gsopenlog(argv[0]);
+
+    while ((ch = getopt(argc, argv, "l:p:r:vXDb:F:f:K:")) != -1) {
+        switch (ch) {
+            case 'r':
+                bufsz=atoi(optarg);
+                break;
+            case 'p':
+                tcpport=atoi(optarg);
+                break;
+            case 'v':
+                verbose++;
+                break;
+            case 'X':
+                xit++;
+                break;
+            case 'D':
+                dump++;
+                break;
+            case 'l':
+                tlimit = atoi(optarg);
+                break;
+			case 'b':
+				batch_rows = atoi(optarg);
+				break;
+			case 'F':
+				flush_ms = atoi(optarg);
+				break;
+			case 'f':
+				outflnm = strdup(optarg);
+				break;
+			case 'K':
+				batch_keys = atoi(optarg);
+				break;
+            default:
+            usage:
+                fprintf(stderr, "usage: %s [-r <bufsz>] [-p <port>] [-f <file>] [-b <batch_rows>] [-F <flush_ms>] [-K <batch_keys>] [-l <time_limit>] [-v] [-X] [-D] <gshub-hostname>:<gshub-port> <gsinstance_name>  query param1 param2...\n", *argv);
+                exit(1);
+        }
+    }
+    argc -= optind;
+    argv += optind;
+    if (argc<3) goto usage;
+	if (batch_rows<=0) {
+		fprintf(stderr,"%s::error:the batch size must be positive\n", me);
+		exit(1);
+	}
+	if ((gs_int32_t)batch_keys<=0) {
+		fprintf(stderr,"%s::error:the number of batch keys must be positive\n", me);
+		exit(1);
+	}
+
+    if (sscanf(argv[0],"%u.%u.%u.%u:%hu",&tip1,&tip2,&tip3,&tip4,&(gshub.port))!= 5 ) {
+        gslog(LOG_EMERG,"HUB IP NOT DEFINED");
+        exit(1);
+    }
+    gshub.ip=htonl(tip1<<24|tip2<<16|tip3<<8|tip4);
+    gshub.port=htons(gshub.port);
+    instance_name=strdup(argv[1]);
+    if (set_hub(gshub)!=0) {
+        gslog(LOG_EMERG,"Could not set hub");
+        exit(1);
+    }
+    if (set_instance_name(instance_name)!=0) {
+        gslog(LOG_EMERG,"Could not set instance name");
+        exit(1);
+    }
+
+    if (get_initinstance(gshub,instance_name,&dummyep,1)!=0) {
+        gslog(LOG_EMERG,"Did not receive signal that GS is initiated\n");
+    }
+
+    gettimeofday(&tvs, 0);
+    argc -=2;
+    argv +=2;
+    if (argc < 1)
+        goto usage;
+
+    /* initialize host library and the sgroup  */
+
+    if (verbose>=2) fprintf(stderr,"Inializin gscp\n");
+
+    if (ftaapp_init(bufsz)!=0) {
+        fprintf(stderr,"%s::error:could not initialize gscp\n", me);
+        exit(1);
+    }
+
+    signal(SIGTERM, hand);
+    signal(SIGINT, hand);
+
+	key_base = argv[0];
+
+    schema = ftaapp_get_fta_schema_by_name(argv[0]);
+    if (schema < 0) {
+        fprintf(stderr,"%s::error:could not get fta '%s' schema\n",
+                me ,argv[0]);
+        exit(1);
+    }
+	n_expected_param = ftaschema_parameter_len(schema);
+    if (n_expected_param == 0) {
+        pblk = 0;
+        pblklen = 0;
+    } else {
+        /* parse the params */
+		n_actual_param = argc-1;
+		if(n_actual_param < n_expected_param){
+			fprintf(stderr,"Error, %d query parameters expected, %d provided.\n",n_expected_param, n_actual_param);
+			exit(1);
+		}
+        for (lcv = 1 ; lcv < argc ; lcv++) {
+            char *k, *e;
+            int rv;
+            k = argv[lcv];
+            e = k;
+            while (*e && *e != '=') e++;
+            if (*e == 0) {
+                fprintf(stderr,"param parse error '%s' (fmt 'key=val')\n",
+                        argv[lcv]);
+                exit(1);
+            }
+            *e = 0;
+            rv = ftaschema_setparam_by_name(schema, k, e+1, strlen(e+1));
+            *e = '=';
+            if (rv < 0) {
+                fprintf(stderr,"param setparam error '%s' (fmt 'key=val')\n",
+                        argv[lcv]);
+                exit(1);
+            }
+        }
+        if (ftaschema_create_param_block(schema, &pblk, &pblklen) < 0) {
+            fprintf(stderr, "ftaschema_create_param_block failed!\n");
+            exit(1);
+        }
+    }
+    ftaschema_free(schema); /* XXXCDC */
+
+
+    if (verbose>=2) fprintf(stderr,"Initalize FTA\n");
+
+    fta_id=ftaapp_add_fta(argv[0],0,0,0,pblklen,pblk);
+    if (fta_id.streamid==0) {
+        fprintf(stderr,"%s::error:could not initialize fta %s\n",
+                me, argv[0]);
+        exit(1);
+    }
+    /* XXXCDC: pblk is malloc'd, should we free it? */
+
+    if (verbose>=2) fprintf(stderr,"Get schema handle\n");
+
+    if ((schema=ftaapp_get_fta_schema(fta_id))<0) {
+        fprintf(stderr,"%s::error:could not get schema\n", me);
+        exit(1);
+    }
+
+    if ((numberoffields=ftaschema_tuple_len(schema))<0) {
+        fprintf(stderr,"%s::error:could not get number of fields in schema\n",
+                me);
+        exit(1);
+    }
+
+    if (verbose>=1) {
+        for(y=0; y<numberoffields;y++) {
+            printf("%s",ftaschema_field_name(schema,y));
+            if (y<numberoffields-1) printf("|");
+        }
+        printf("\n");
+    }
+    if (xit) {
+        gettimeofday(&tve, 0);
+        timersub(&tve, &tvs, &tvd);
+        printf("TIME= %ld.%06ld sec\n", tvd.tv_sec, tvd.tv_usec);
+        stop_and_exit(0);
+    }
+
+// The batch has a column for each field; the type comes from the first tuple
+	cbw = new colbatch_writer(batch_rows);
+
+    if (tcpport!=0) {
+    	wait_for_client();
+    } else if (outflnm != NULL) {
+		if ((outfd=open(outflnm, O_WRONLY|O_CREAT|O_APPEND, 0644))<0) {
+			fprintf(stderr,"%s::error:could not open %s: %s\n", me, outflnm, strerror(errno));
+			exit(1);
+		}
+	} else {
+		sdl = shareddatalayer::SyncStorage::create();
+	}
+
+    start_time = time(NULL);
+	gettimeofday(&batch_start, 0);
+	cbw->set_seq(((gs_uint64_t)batch_start.tv_sec)*1000000+batch_start.tv_usec);	// distinct across restarts
+
+    // wait at most a second for a tuple, so that a signal is seen without data
+    while((code=ftaapp_get_tuple(&rfta_id,&rsize,rbuf,2*MAXTUPLESZ,1))>=0) {
+        if (stop_signal)
+            stop_and_exit(stop_signal);
+        if (dump || code==1)	// 1: timed out
+            continue;
+        if (ftaschema_is_eof_tuple(schema, rbuf)) {
+            /* initiate shutdown or something of that nature */
+			flush_batch();
+            printf("#All data proccessed\n");
+            exit(0);
+        }
+
+        // on a temporal tuple ship the batch if it has been waiting long enough
+        if (code==2 && cbw->get_num_rows()>0) {
+			gettimeofday(&tve, 0);
+			timersub(&tve, &batch_start, &tvd);
+			if (tvd.tv_sec*1000+tvd.tv_usec/1000 >= flush_ms) {
+				flush_batch();
+			}
+		}
+
+        if (!rsize)
+            continue;
+
+        if ((code==0)&&(rfta_id.streamid == fta_id.streamid)) {
+			if (cbw->get_num_cols()==0) {
+				for(y=0; y<numberoffields;y++) {
+                	access_result ar=ftaschema_get_field_by_index(schema,y,rbuf,rsize);
+					if (!cbw->add_column(ftaschema_field_name(schema,y), ar.field_data_type)) {
+						fprintf(stderr,"%s::error:field %s has a type (%d) which can't be batched\n",
+							me, ftaschema_field_name(schema,y), ar.field_data_type);
+						exit(1);
+					}
+				}
+			}
+			if (cbw->get_num_rows()==0) {
+				gettimeofday(&batch_start, 0);
+			}
+
+			// the column type was fixed by the first tuple; a field which can't be
+			// read (or reads as another type) gets an empty value so the row stays whole
+			for(y=0; y<numberoffields;y++) {
+                access_result ar=ftaschema_get_field_by_index(schema,y,rbuf,rsize);
+				if (ar.field_data_type != cbw->get_col_type(y)) {
+					cbw->put_empty(y);
+					continue;
+				}
+                switch (cbw->get_col_type(y)) {
+                    case VSTR_TYPE:
+						cbw->put_string(y, (char *)ar.r.vs.offset, ar.r.vs.length);
+                        break;
+                    case TIMEVAL_TYPE:
+						cbw->put_timeval(y, ar.r.t.tv_sec, ar.r.t.tv_usec);
+                        break;
+                    case IPV6_TYPE:
+						cbw->put(y, &ar.r.ip6);
+                        break;
+                    default:
+						cbw->put(y, &ar.r);
+                        break;
+                }
+            }
+			cbw->end_row();
+			if (cbw->is_full()) {
+				flush_batch();
+			}
+        } else {
+            if (rfta_id.streamid != fta_id.streamid)
+                fprintf(stderr,"Got unkown streamid %llu \n",rfta_id.streamid);
+        }
+
+        // whenever we receive a temp tuple check if we reached time limit
+        if ((code==2)  && tlimit && (time(NULL)-start_time)>=tlimit) {
+            fprintf(stderr,"Reached time limit of %d seconds\n",tlimit);
+			flush_batch();
+            ftaapp_exit();
+            exit(0);
+        }
+    }
+	flush_batch();
+}
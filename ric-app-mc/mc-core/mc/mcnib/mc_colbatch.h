@@ -0,0 +1,391 @@
+/* ------------------------------------------------
+Copyright 2020 AT&T Intellectual Property
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ ------------------------------------------- */
+
+//		Columnar batches of query results.
+//
+//		A batch holds up to a fixed number of result rows of one query,
+//		stored a column at a time, behind a header which describes the
+//		columns, so that a batch can be read without the schema.  A batch
+//		is written with one write (or one SDL set) rather than a line of
+//		text for each row.
+//
+//		Layout, in host byte order:
+//			mc_cb_header
+//			mc_cb_column, n_cols of them
+//			column names, nul terminated
+//			column data, each starting on an 8 byte boundary
+//		Fixed width columns are n_rows values of cb_type_width() bytes
+//		(a TIMEVAL is two 8 byte integers, seconds and microseconds).
+//		A string column is n_rows+1 unsigned int offsets into the
+//		bytes which follow them; string r is from offs[r] to offs[r+1].
+//
+//		total_len in the header is the size of the whole batch, so that
+//		batches can be read back to back from a file or socket: read
+//		the header, then the rest.
+//
+//		This file is header only so that it can be used by the gs-lite
+//		tools in mc-core (gsmcbatch), which carry a copy that must be
+//		kept in step with this one.
+
+#ifndef __MC_COLBATCH_INCLUDED__
+#define __MC_COLBATCH_INCLUDED__
+
+#include<string.h>
+#include<string>
+#include<vector>
+
+#ifndef UINT_TYPE
+#define UNDEFINED_TYPE 0
+#define UINT_TYPE 1
+#define INT_TYPE 2
+#define ULLONG_TYPE 3
+#define LLONG_TYPE 4
+#define USHORT_TYPE 5
+#define FLOAT_TYPE 6
+#define BOOL_TYPE 7
+#define VSTR_TYPE 8
+#define TIMEVAL_TYPE 9
+#define IP_TYPE 10
+#define FSTRING_TYPE 11
+#define IPV6_TYPE 12
+#endif
+
+#define MC_CB_MAGIC 0x4243434d		// "MCCB"
+#define MC_CB_VERSION 1
+#define MC_CB_DEF_ROWS 1024
+
+namespace mc_colbatch{
+
+struct mc_cb_header{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int total_len;		// bytes in the batch, this header included
+	unsigned int n_rows;
+	unsigned int n_cols;
+	unsigned int reserved;
+	unsigned long long seq;		// batch number, set by the writer
+};
+
+struct mc_cb_column{
+	unsigned int type;
+	unsigned int name_off;		// from the start of the batch
+	unsigned int data_off;		// from the start of the batch
+	unsigned int data_len;
+};
+
+//		a string in a batch; not nul terminated
+struct cb_string{
+	unsigned int length;
+	const char *data;
+};
+
+//		Bytes of one value in a fixed width column, 0 for a string.
+//		-1 if the type can't be stored.
+inline int cb_type_width(int type){
+	switch(type){
+	case UINT_TYPE:
+	case INT_TYPE:
+	case USHORT_TYPE:
+	case BOOL_TYPE:
+	case IP_TYPE:
+		return 4;
+	case ULLONG_TYPE:
+	case LLONG_TYPE:
+	case FLOAT_TYPE:
+		return 8;
+	case TIMEVAL_TYPE:
+	case IPV6_TYPE:
+		return 16;
+	case VSTR_TYPE:
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+inline unsigned int cb_align(unsigned int n){
+	return (n+7) & ~7U;
+}
+
+
+////////////////////////////////////////////
+//		Build batches.  Add the columns, then for each row put every
+//		column's value and end the row.  When is_full(), or whenever
+//		the caller wants to flush, finish() the batch, send it, and
+//		reset() for the next one.
+class colbatch_writer{
+public:
+	colbatch_writer(int capacity = MC_CB_DEF_ROWS){
+		this->capacity = capacity>0 ? capacity : MC_CB_DEF_ROWS;
+		n_rows = 0;
+		seq = 0;
+	}
+
+//		false if the type can't be stored
+	bool add_column(const std::string &name, int type){
+		int w = cb_type_width(type);
+		if(w<0)
+			return false;
+		cols.push_back(wcol());
+		cols.back().name = name;
+		cols.back().type = type;
+		cols.back().width = w;
+		cols.back().data.reserve(w>0 ? w*capacity : 16*capacity);
+		if(w==0){
+			cols.back().offs.reserve(capacity+1);
+			cols.back().offs.push_back(0);
+		}
+		return true;
+	}
+
+	int get_num_cols(){ return cols.size(); }
+	int get_col_type(int c){ return cols[c].type; }
+	int get_num_rows(){ return n_rows; }
+	bool is_full(){ return n_rows >= capacity; }
+	void set_seq(unsigned long long s){ seq = s; }
+	unsigned long long get_seq(){ return seq; }
+
+//		A fixed width value, cb_type_width() bytes at v.
+	void put(int c, const void *v){
+		wcol &wc = cols[c];
+		const char *p = (const char *)v;
+		wc.data.insert(wc.data.end(), p, p+wc.width);
+	}
+	void put_timeval(int c, long long sec, long long usec){
+		long long tv[2] = {sec, usec};
+		put(c, tv);
+	}
+	void put_string(int c, const char *s, unsigned int len){
+		wcol &wc = cols[c];
+		wc.data.insert(wc.data.end(), s, s+len);
+		wc.offs.push_back(wc.data.size());
+	}
+//		An empty string or a zero value, for a field which could not be read.
+	void put_empty(int c){
+		wcol &wc = cols[c];
+		if(wc.width==0)
+			wc.offs.push_back(wc.data.size());
+		else
+			wc.data.insert(wc.data.end(), wc.width, 0);
+	}
+	void end_row(){
+		n_rows++;
+	}
+
+//		Lay out the batch; returns a pointer to it and sets len.  Valid
+//		until the next call to finish() or reset().
+	const char *finish(unsigned int *len){
+		unsigned int pos = sizeof(mc_cb_header) + cols.size()*sizeof(mc_cb_column);
+		std::vector<mc_cb_column> cdesc(cols.size());
+		for(int c=0;c<cols.size();++c){
+			cdesc[c].type = cols[c].type;
+			cdesc[c].name_off = pos;
+			pos += cols[c].name.size()+1;
+		}
+		for(int c=0;c<cols.size();++c){
+			pos = cb_align(pos);
+			cdesc[c].data_off = pos;
+			cdesc[c].data_len = cols[c].data.size();
+			if(cols[c].width==0)
+				cdesc[c].data_len += cols[c].offs.size()*sizeof(unsigned int);
+			pos += cdesc[c].data_len;
+		}
+		pos = cb_align(pos);
+
+		out.resize(pos);
+		char *b = out.data();
+		memset(b, 0, pos);
+		mc_cb_header hdr;
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.magic = MC_CB_MAGIC;
+		hdr.version = MC_CB_VERSION;
+		hdr.total_len = pos;
+		hdr.n_rows = n_rows;
+		hdr.n_cols = cols.size();
+		hdr.seq = seq;
+		memcpy(b, &hdr, sizeof(hdr));
+		if(cols.size()>0)
+			memcpy(b+sizeof(hdr), cdesc.data(), cols.size()*sizeof(mc_cb_column));
+		for(int c=0;c<cols.size();++c){
+			memcpy(b+cdesc[c].name_off, cols[c].name.c_str(), cols[c].name.size()+1);
+			char *d = b+cdesc[c].data_off;
+			if(cols[c].width==0){
+				memcpy(d, cols[c].offs.data(), cols[c].offs.size()*sizeof(unsigned int));
+				d += cols[c].offs.size()*sizeof(unsigned int);
+			}
+			if(cols[c].data.size()>0)
+				memcpy(d, cols[c].data.data(), cols[c].data.size());
+		}
+
+		*len = pos;
+		return b;
+	}
+
+//		Empty the batch and advance the sequence number.
+	void reset(){
+		for(int c=0;c<cols.size();++c){
+			cols[c].data.clear();
+			if(cols[c].width==0){
+				cols[c].offs.clear();
+				cols[c].offs.push_back(0);
+			}
+		}
+		n_rows = 0;
+		seq++;
+	}
+
+private:
+	struct wcol{
+		std::string name;
+		int type;
+		int width;
+		std::vector<char> data;				// values, or the string bytes
+		std::vector<unsigned int> offs;		// string offsets
+	};
+	std::vector<wcol> cols;
+	std::vector<char> out;
+	int capacity;
+	int n_rows;
+	unsigned long long seq;
+};
+
+
+////////////////////////////////////////////
+//		Read a batch.  init() checks it and points into it, so the
+//		batch must outlive the reader's use of it.
+class colbatch_reader{
+public:
+	colbatch_reader(){
+		base = NULL;
+		memset(&hdr, 0, sizeof(hdr));
+	}
+
+//		Bytes in the batch whose header is at data, 0 if it isn't one.
+	static unsigned int batch_len(const char *data, unsigned int len){
+		mc_cb_header h;
+		if(len < sizeof(h))
+			return 0;
+		memcpy(&h, data, sizeof(h));
+		if(h.magic!=MC_CB_MAGIC)
+			return 0;
+		return h.total_len;
+	}
+
+//		false (see get_error) if data isn't a good batch.
+	bool init(const char *data, unsigned int len){
+		base = NULL;
+		cols.clear();
+		err = "";
+		if(len < sizeof(hdr)){
+			err = "Error, batch shorter than its header";
+			return false;
+		}
+		memcpy(&hdr, data, sizeof(hdr));
+		if(hdr.magic!=MC_CB_MAGIC || hdr.version!=MC_CB_VERSION){
+			err = "Error, not a batch (or not this version)";
+			return false;
+		}
+		if(hdr.total_len > len){
+			err = "Error, batch is truncated";
+			return false;
+		}
+		if(sizeof(hdr) + (unsigned long long)hdr.n_cols*sizeof(mc_cb_column) > hdr.total_len){
+			err = "Error, column descriptions overrun the batch";
+			return false;
+		}
+		cols.resize(hdr.n_cols);
+		if(hdr.n_cols>0)
+			memcpy(cols.data(), data+sizeof(hdr), hdr.n_cols*sizeof(mc_cb_column));
+		for(int c=0;c<cols.size();++c){
+			int w = cb_type_width(cols[c].type);
+			unsigned long long need = w>0 ? (unsigned long long)w*hdr.n_rows : ((unsigned long long)hdr.n_rows+1)*sizeof(unsigned int);
+			if(w<0 || cols[c].name_off >= hdr.total_len
+					|| memchr(data+cols[c].name_off, '\0', hdr.total_len-cols[c].name_off)==NULL
+					|| (unsigned long long)cols[c].data_off + cols[c].data_len > hdr.total_len
+					|| cols[c].data_len < need){
+				err = "Error, bad description of column "+std::to_string(c);
+				cols.clear();
+				return false;
+			}
+			if(w==0){
+				const char *d = data+cols[c].data_off;
+				unsigned int heap = cols[c].data_len - need;
+				unsigned int prev = 0;
+				for(unsigned int r=0;r<=hdr.n_rows;++r){
+					unsigned int o;
+					memcpy(&o, d+r*sizeof(unsigned int), sizeof(o));
+					if(o<prev || o>heap){
+						err = "Error, bad string offsets in column "+std::to_string(c);
+						cols.clear();
+						return false;
+					}
+					prev = o;
+				}
+			}
+		}
+		base = data;
+		return true;
+	}
+
+	std::string get_error(){ return err; }
+	int get_num_rows(){ return hdr.n_rows; }
+	int get_num_cols(){ return cols.size(); }
+	unsigned long long get_seq(){ return hdr.seq; }
+	std::string get_col_name(int c){ return base+cols[c].name_off; }
+	int get_col_type(int c){ return cols[c].type; }
+//		-1 if not found
+	int get_index_of_col(const std::string &name){
+		for(int c=0;c<cols.size();++c){
+			if(name==base+cols[c].name_off)
+				return c;
+		}
+		return -1;
+	}
+
+//		The values of a fixed width column, n_rows of cb_type_width()
+//		bytes.  The column is 8 byte aligned.
+	const void *get_column(int c){ return base+cols[c].data_off; }
+
+	unsigned int get_uint(int c, int r){ return get_val<unsigned int>(c, r); }
+	int get_int(int c, int r){ return get_val<int>(c, r); }
+	unsigned long long get_ullong(int c, int r){ return get_val<unsigned long long>(c, r); }
+	long long get_llong(int c, int r){ return get_val<long long>(c, r); }
+	double get_float(int c, int r){ return get_val<double>(c, r); }
+	cb_string get_string(int c, int r){
+		const char *d = base+cols[c].data_off;
+		unsigned int o[2];
+		memcpy(o, d+r*sizeof(unsigned int), sizeof(o));
+		cb_string ret;
+		ret.length = o[1]-o[0];
+		ret.data = d + (hdr.n_rows+1)*sizeof(unsigned int) + o[0];
+		return ret;
+	}
+
+private:
+	template<class T> T get_val(int c, int r){
+		T v;
+		memcpy(&v, base+cols[c].data_off+r*sizeof(T), sizeof(T));
+		return v;
+	}
+
+	const char *base;
+	mc_cb_header hdr;
+	std::vector<mc_cb_column> cols;
+	std::string err;
+};
+
+}
+
+#endif
@@ -0,0 +1,265 @@
+/* ------------------------------------------------
+Copyright 2020 AT&T Intellectual Property
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ ------------------------------------------- */
+
+//		Compare the per-field access functions with a field_plan.
+//		Synthetic tuples are built for a schema in nib.json and every
+//		field is extracted from each of them
+//			string:	get_field_string() per field (as mc_extract does)
+//			handle:	get_field_by_handle() per field
+//			rows:	field_plan::decode_rows() a batch at a time
+//			cols:	field_plan::decode_columns() a batch at a time
+//		The plan's results are checked against get_field_by_handle().
+//		Does not need the MC-NIB.
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+
+#include<string>
+#include<vector>
+#include<iostream>
+#include<fstream>
+
+#include"schemaparser.h"
+
+#define BATCH 1024
+
+struct vstring32 {
+    unsigned int length;
+    unsigned int offset;
+    unsigned int reserved;
+};
+
+using namespace std;
+using namespace mc_schema;
+
+static double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ((double)ts.tv_nsec)/1000000000.0;
+}
+
+static void report(const char *what, double elapsed, long n_tuples, int n_fields, unsigned long long sum){
+	printf("%-8s %8.1f ns/tuple  %6.2f ns/field  (sum %llx)\n", what,
+		elapsed*1000000000.0/n_tuples, elapsed*1000000000.0/n_tuples/n_fields, sum);
+}
+
+int main(int argc, char **argv){
+	string schema("");
+	string directory = ".";
+	int n_tuples = 100000;
+	if(argc>1)
+		schema = argv[1];
+	if(argc>2)
+		directory = argv[2];
+	if(argc>3)
+		n_tuples = atoi(argv[3]);
+	if(n_tuples<=0){
+		fprintf(stderr,"Error, usage is %s [schema] [directory] [n_tuples]\n", argv[0]);
+		exit(1);
+	}
+
+//		Get the nib.json file
+	string inflnm = directory + "/" + string("nib.json");
+	ifstream infl(inflnm);
+	if(!infl){
+		cerr << "Error, can't open " << inflnm << endl;
+		exit(1);
+	}
+	string line;
+	string nib_str;
+	while(getline(infl, line)){
+		nib_str += line;
+	}
+	infl.close();
+
+	mc_schemas *mcs = new_mc_schemas(nib_str);
+	if(mcs->has_errors()){
+		fprintf(stderr, "Errors loading the schemas:\n%s\n",mcs->get_errors().c_str());
+		exit(1);
+	}
+
+//		default to the widest schema
+	if(schema==""){
+		vector<string> streams = mcs->get_streams();
+		int most = 0;
+		for(int i=0;i<streams.size();++i){
+			int nf = mcs->get_query_rep(streams[i])->get_num_fields();
+			if(nf>most){
+				most = nf;
+				schema = streams[i];
+			}
+		}
+	}
+	query_rep *qr = mcs->get_query_rep(schema);
+	if(qr==NULL){
+		fprintf(stderr,"Error, schema %s not found\n",schema.c_str());
+		exit(1);
+	}
+
+	int n_fields = qr->get_num_fields();
+	vector<field_handle> handles;
+	int fixed_len = 0;
+	for(int i=0;i<n_fields;++i){
+		handles.push_back(qr->get_handle(i));
+		int end = qr->get_offset(i) + type_size(qr->get_type(i));
+		if(end>fixed_len)
+			fixed_len = end;
+	}
+
+	field_plan plan;
+	if(!plan.compile(handles)){
+		fprintf(stderr,"Error, can't compile a plan for %s\n",schema.c_str());
+		exit(1);
+	}
+
+//		Build the tuples: the fixed part, then the strings
+	vector<void *> tuples(n_tuples);
+	vector<int> lens(n_tuples);
+	for(int t=0;t<n_tuples;++t){
+		string strs;
+		char buf[fixed_len];
+		memset(buf, 0, fixed_len);
+		for(int i=0;i<n_fields;++i){
+			char *p = buf + qr->get_offset(i);
+			unsigned long long v = (unsigned long long)t*31 + i;
+			switch(qr->get_type(i)){
+			case VSTR_TYPE:{
+				string s = "gnb_" + to_string(v % 997);
+				vstring32 vs;
+				vs.length = s.size();
+				vs.offset = fixed_len + strs.size();
+				vs.reserved = 0;
+				memcpy(p, &vs, sizeof(vstring32));
+				strs += s;
+				break;
+			}
+			case FLOAT_TYPE:{
+				double d = v / 4.0;
+				memcpy(p, &d, sizeof(double));
+				break;
+			}
+			case ULLONG_TYPE:
+			case LLONG_TYPE:
+				memcpy(p, &v, sizeof(unsigned long long));
+				break;
+			default:
+				memcpy(p, &v, type_size(qr->get_type(i)) < sizeof(v) ? type_size(qr->get_type(i)) : sizeof(v));
+				break;
+			}
+		}
+		lens[t] = fixed_len + strs.size();
+		tuples[t] = malloc(lens[t]);
+		memcpy(tuples[t], buf, fixed_len);
+		memcpy((char *)tuples[t]+fixed_len, strs.data(), strs.size());
+	}
+
+	printf("%s: %d fields, %d tuples of %d+ bytes, plan has %d fields in a %d byte row\n",
+		schema.c_str(), n_fields, n_tuples, fixed_len, plan.get_num_fields(), plan.get_row_size());
+
+	int row_size = plan.get_row_size();
+	vector<char> rows((size_t)BATCH*row_size);
+	vector<vector<unsigned long long> > col_store(n_fields, vector<unsigned long long>(BATCH*2));
+	vector<void *> cols(n_fields);
+	for(int i=0;i<n_fields;++i)
+		cols[i] = col_store[i].data();		// 16 bytes a value is enough for every type
+	unsigned char ok[BATCH];
+
+//		check the plan against the per-field functions
+	int errs = 0;
+	for(int b=0;b<n_tuples;b+=BATCH){
+		int n = n_tuples-b < BATCH ? n_tuples-b : BATCH;
+		plan.decode_rows(&tuples[b], &lens[b], n, rows.data(), row_size, ok);
+		for(int t=0;t<n;++t){
+			for(int i=0;i<n_fields;++i){
+				access_result a = get_field_by_handle(handles[i], tuples[b+t], lens[b+t]);
+				char *r = rows.data() + (size_t)t*row_size + plan.get_offset(i);
+				if(!ok[t] || a.field_data_type!=handles[i].type){
+					errs++;
+				}else if(handles[i].type==VSTR_TYPE){
+					mc_string vs;
+					memcpy(&vs, r, sizeof(mc_string));
+					if(vs.length!=a.r.vs.length || vs.data!=a.r.vs.data)
+						errs++;
+				}else if(memcmp(r, &a.r, type_size(handles[i].type))!=0){
+					errs++;
+				}
+			}
+		}
+	}
+	if(errs){
+		fprintf(stderr,"Error, %d fields decoded by the plan differ\n", errs);
+		exit(1);
+	}
+
+	unsigned long long sum = 0;
+	double start = now();
+	for(int t=0;t<n_tuples;++t){
+		for(int i=0;i<n_fields;++i){
+			string s = get_field_string(handles[i], tuples[t], lens[t]);
+			sum += s.size();
+		}
+	}
+	report("string", now()-start, n_tuples, n_fields, sum);
+
+	sum = 0;
+	start = now();
+	for(int t=0;t<n_tuples;++t){
+		for(int i=0;i<n_fields;++i){
+			access_result a = get_field_by_handle(handles[i], tuples[t], lens[t]);
+			sum += a.r.ui;
+		}
+	}
+	report("handle", now()-start, n_tuples, n_fields, sum);
+
+	vector<int> offsets(n_fields);
+	for(int i=0;i<n_fields;++i)
+		offsets[i] = plan.get_offset(i);
+	sum = 0;
+	start = now();
+	for(int b=0;b<n_tuples;b+=BATCH){
+		int n = n_tuples-b < BATCH ? n_tuples-b : BATCH;
+		plan.decode_rows(&tuples[b], &lens[b], n, rows.data(), row_size, NULL);
+		for(int t=0;t<n;++t){
+			for(int i=0;i<n_fields;++i){
+				unsigned int v;
+				memcpy(&v, rows.data() + (size_t)t*row_size + offsets[i], sizeof(v));
+				sum += v;
+			}
+		}
+	}
+	report("rows", now()-start, n_tuples, n_fields, sum);
+
+	sum = 0;
+	start = now();
+	for(int b=0;b<n_tuples;b+=BATCH){
+		int n = n_tuples-b < BATCH ? n_tuples-b : BATCH;
+		plan.decode_columns(&tuples[b], &lens[b], n, cols.data(), NULL);
+		for(int i=0;i<n_fields;++i){
+			int sz = type_size(plan.get_type(i));
+			for(int t=0;t<n;++t){
+				unsigned int v;
+				memcpy(&v, (char *)cols[i] + (size_t)t*sz, sizeof(v));
+				sum += v;
+			}
+		}
+	}
+	report("cols", now()-start, n_tuples, n_fields, sum);
+
+	for(int t=0;t<n_tuples;++t)
+		free(tuples[t]);
+	delete mcs;
+}
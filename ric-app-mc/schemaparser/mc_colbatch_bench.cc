@@ -0,0 +1,386 @@
+/* ------------------------------------------------
+Copyright 2020 AT&T Intellectual Property
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+ ------------------------------------------- */
+
+//		Compare the output paths for query results.
+//		Synthetic result tuples are built for a schema in nib.json, then
+//			text:	each row is formatted as a VES (v7) json record, as
+//					gsprintconsole_ves does, and written on its own
+//			batch:	rows are added to columnar batches (mc_colbatch.h)
+//					and each batch is written with one write
+//			read:	the batches are read back and every value visited
+//		Output goes to /dev/null unless a file is given.
+//		Does not need the MC-NIB.
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<time.h>
+#include<unistd.h>
+#include<fcntl.h>
+
+#include<string>
+#include<vector>
+#include<iostream>
+#include<fstream>
+
+#include"schemaparser.h"
+#include"mc_colbatch.h"
+
+#define MAXLINE 100000
+
+struct vstring32 {
+    unsigned int length;
+    unsigned int offset;
+    unsigned int reserved;
+};
+
+using namespace std;
+using namespace mc_schema;
+using namespace mc_colbatch;
+
+static double now(){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ((double)ts.tv_nsec)/1000000000.0;
+}
+
+static void report(const char *what, double elapsed, long n_rows, long long bytes, long writes){
+	printf("%-6s %10.0f rows/s  %8.1f ns/row  %7.1f bytes/row  %8ld writes\n", what,
+		n_rows/elapsed, elapsed*1000000000.0/n_rows, (double)bytes/n_rows, writes);
+}
+
+static void write_all(int fd, const char *buf, unsigned int len){
+	while(len>0){
+		int w = write(fd, buf, len);
+		if(w<=0){
+			perror("write");
+			exit(1);
+		}
+		buf += w;
+		len -= w;
+	}
+}
+
+int main(int argc, char **argv){
+	string schema("");
+	string directory = ".";
+	int n_tuples = 200000;
+	int batch_rows = MC_CB_DEF_ROWS;
+	const char *outfl = "/dev/null";
+	int ch;
+
+	while((ch = getopt(argc, argv, "b:n:o:")) != -1){
+		switch(ch){
+		case 'b':
+			batch_rows = atoi(optarg);
+			break;
+		case 'n':
+			n_tuples = atoi(optarg);
+			break;
+		case 'o':
+			outfl = optarg;
+			break;
+		default:
+			fprintf(stderr,"Error, usage is %s [-b batch_rows] [-n n_tuples] [-o output_file] [schema] [directory]\n", argv[0]);
+			exit(1);
+		}
+	}
+	if(optind<argc)
+		schema = argv[optind++];
+	if(optind<argc)
+		directory = argv[optind++];
+	if(n_tuples<=0 || batch_rows<=0){
+		fprintf(stderr,"Error, the number of tuples and the batch size must be positive\n");
+		exit(1);
+	}
+
+//		Get the nib.json file
+	string inflnm = directory + "/" + string("nib.json");
+	ifstream infl(inflnm);
+	if(!infl){
+		cerr << "Error, can't open " << inflnm << endl;
+		exit(1);
+	}
+	string line;
+	string nib_str;
+	while(getline(infl, line)){
+		nib_str += line;
+	}
+	infl.close();
+
+	mc_schemas *mcs = new_mc_schemas(nib_str);
+	if(mcs->has_errors()){
+		fprintf(stderr, "Errors loading the schemas:\n%s\n",mcs->get_errors().c_str());
+		exit(1);
+	}
+	if(schema=="")
+		schema = "throughput_ue";
+	query_rep *qr = mcs->get_query_rep(schema);
+	if(qr==NULL){
+		fprintf(stderr,"Error, schema %s not found\n",schema.c_str());
+		exit(1);
+	}
+
+	int n_fields = qr->get_num_fields();
+	vector<field_handle> handles;
+	vector<string> names;
+	int fixed_len = 0;
+	for(int i=0;i<n_fields;++i){
+		handles.push_back(qr->get_handle(i));
+		names.push_back(qr->get_field_name(i));
+		int end = qr->get_offset(i) + type_size(qr->get_type(i));
+		if(end>fixed_len)
+			fixed_len = end;
+	}
+
+//		Build the tuples: the fixed part, then the strings
+	vector<void *> tuples(n_tuples);
+	vector<int> lens(n_tuples);
+	for(int t=0;t<n_tuples;++t){
+		string strs;
+		char buf[fixed_len];
+		memset(buf, 0, fixed_len);
+		for(int i=0;i<n_fields;++i){
+			char *p = buf + qr->get_offset(i);
+			unsigned long long v = (unsigned long long)t*31 + i;
+			switch(qr->get_type(i)){
+			case VSTR_TYPE:{
+				string s = "gnb_" + to_string(v % 997);
+				vstring32 vs;
+				vs.length = s.size();
+				vs.offset = fixed_len + strs.size();
+				vs.reserved = 0;
+				memcpy(p, &vs, sizeof(vstring32));
+				strs += s;
+				break;
+			}
+			case FLOAT_TYPE:{
+				double d = v / 4.0;
+				memcpy(p, &d, sizeof(double));
+				break;
+			}
+			case ULLONG_TYPE:
+			case LLONG_TYPE:
+				memcpy(p, &v, sizeof(unsigned long long));
+				break;
+			default:
+				memcpy(p, &v, type_size(qr->get_type(i)) < sizeof(v) ? type_size(qr->get_type(i)) : sizeof(v));
+				break;
+			}
+		}
+		lens[t] = fixed_len + strs.size();
+		tuples[t] = malloc(lens[t]);
+		memcpy(tuples[t], buf, fixed_len);
+		memcpy((char *)tuples[t]+fixed_len, strs.data(), strs.size());
+	}
+
+	int fd = open(outfl, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd<0){
+		perror(outfl);
+		exit(1);
+	}
+
+	printf("%s: %d fields, %d rows, batches of %d rows, output to %s\n",
+		schema.c_str(), n_fields, n_tuples, batch_rows, outfl);
+
+//		text: one VES record per row, as gsprintconsole_ves
+	static char linebuf[MAXLINE];
+	long long bytes = 0;
+	long writes = 0;
+	double start = now();
+	for(int t=0;t<n_tuples;++t){
+		int pos = snprintf(linebuf, MAXLINE,
+  "{\"event\": { \"commonEventHeader\": { "
+        "\"domain\": \"measurement\", "
+        "\"eventId\": \"%s%u\", "
+        "\"eventType\": \"%s\", "
+        "\"eventName\": \"Measurement_MC_%s\", "
+        "\"lastEpochMicrosec\": %s, "
+        "\"priority\": \"Normal\", "
+        "\"reportingEntityName\": \"GS-LITE MC\", "
+        "\"sequence\": %u, "
+        "\"sourceName\": \"meas_cmpgn_xapp\", "
+        "\"startEpochMicrosec\": %s, "
+        "\"version\": \"4.0.1\", "
+        "\"vesEventListenerVersion\": \"7.0.1\" "
+      "}, "
+      "\"measurementFields\": { "
+	  	"\"additionalFields\": {"
+			, schema.c_str(), t, schema.c_str(), schema.c_str(), "1600000000000000", t, "1600000000000000");
+		for(int i=0;i<n_fields;++i){
+			if(i>0)
+				linebuf[pos++] = ',';
+			access_result ar = get_field_by_handle(handles[i], tuples[t], lens[t]);
+			switch(ar.field_data_type){
+			case INT_TYPE:
+				pos += snprintf(linebuf+pos, MAXLINE-pos, " \"%s\": \"%d\"", names[i].c_str(), ar.r.i);
+				break;
+			case UINT_TYPE:
+			case USHORT_TYPE:
+			case BOOL_TYPE:
+			case IP_TYPE:
+				pos += snprintf(linebuf+pos, MAXLINE-pos, " \"%s\": \"%u\"", names[i].c_str(), ar.r.ui);
+				break;
+			case ULLONG_TYPE:
+				pos += snprintf(linebuf+pos, MAXLINE-pos, "\"%s\": \"%llu\"", names[i].c_str(), ar.r.ul);
+				break;
+			case LLONG_TYPE:
+				pos += snprintf(linebuf+pos, MAXLINE-pos, "\"%s\": \"%lld\"", names[i].c_str(), ar.r.l);
+				break;
+			case FLOAT_TYPE:
+				pos += snprintf(linebuf+pos, MAXLINE-pos, "\"%s\": \"%f\"", names[i].c_str(), ar.r.f);
+				break;
+			case VSTR_TYPE:
+				pos += snprintf(linebuf+pos, MAXLINE-pos, "\"%s\": \"%.*s\"", names[i].c_str(), ar.r.vs.length, ar.r.vs.data);
+				break;
+			default:
+				break;
+			}
+		}
+		pos += snprintf(linebuf+pos, MAXLINE-pos,
+	  	"}, \"measurementInterval\": %f, \"measurementFieldsVersion\": \"4.0\""
+		"}}}\n", 10.0);
+		write_all(fd, linebuf, pos);
+		bytes += pos;
+		writes++;
+	}
+	report("text", now()-start, n_tuples, bytes, writes);
+
+//		batch: one write per batch; the batches are kept to be read back
+	colbatch_writer cbw(batch_rows);
+	for(int i=0;i<n_fields;++i){
+		if(!cbw.add_column(names[i], handles[i].type)){
+			fprintf(stderr,"Error, field %s can't be batched\n",names[i].c_str());
+			exit(1);
+		}
+	}
+	vector<string> batches;
+	bytes = 0;
+	writes = 0;
+	start = now();
+	for(int t=0;t<n_tuples;++t){
+		for(int i=0;i<n_fields;++i){
+			access_result ar = get_field_by_handle(handles[i], tuples[t], lens[t]);
+			switch(ar.field_data_type){
+			case VSTR_TYPE:
+				cbw.put_string(i, ar.r.vs.data, ar.r.vs.length);
+				break;
+			case TIMEVAL_TYPE:
+				cbw.put_timeval(i, ar.r.t.tv_sec, ar.r.t.tv_usec);
+				break;
+			default:
+				cbw.put(i, &ar.r);
+				break;
+			}
+		}
+		cbw.end_row();
+		if(cbw.is_full() || t==n_tuples-1){
+			unsigned int len;
+			const char *b = cbw.finish(&len);
+			write_all(fd, b, len);
+			batches.push_back(string(b, len));
+			bytes += len;
+			writes++;
+			cbw.reset();
+		}
+	}
+	report("batch", now()-start, n_tuples, bytes, writes);
+	close(fd);
+
+//		read the batches back, visiting every value
+	unsigned long long sum = 0;
+	long n_read = 0;
+	start = now();
+	for(int b=0;b<batches.size();++b){
+		colbatch_reader cbr;
+		if(!cbr.init(batches[b].data(), batches[b].size())){
+			fprintf(stderr,"%s\n",cbr.get_error().c_str());
+			exit(1);
+		}
+		int nr = cbr.get_num_rows();
+		for(int c=0;c<cbr.get_num_cols();++c){
+			switch(cbr.get_col_type(c)){
+			case VSTR_TYPE:
+				for(int r=0;r<nr;++r)
+					sum += cbr.get_string(c, r).length;
+				break;
+			case ULLONG_TYPE:
+			case LLONG_TYPE:
+				for(int r=0;r<nr;++r)
+					sum += cbr.get_ullong(c, r);
+				break;
+			case FLOAT_TYPE:
+				for(int r=0;r<nr;++r)
+					sum += (unsigned long long)cbr.get_float(c, r);
+				break;
+			case TIMEVAL_TYPE:
+			case IPV6_TYPE:
+				break;
+			default:
+				for(int r=0;r<nr;++r)
+					sum += cbr.get_uint(c, r);
+				break;
+			}
+		}
+		n_read += nr;
+	}
+	report("read", now()-start, n_read, bytes, 0);
+
+//		and check them against the tuples
+	int errs = 0;
+	int t = 0;
+	for(int b=0;b<batches.size();++b){
+		colbatch_reader cbr;
+		cbr.init(batches[b].data(), batches[b].size());
+		for(int r=0;r<cbr.get_num_rows();++r, ++t){
+			for(int c=0;c<n_fields;++c){
+				access_result ar = get_field_by_handle(handles[c], tuples[t], lens[t]);
+				switch(ar.field_data_type){
+				case VSTR_TYPE:{
+					cb_string s = cbr.get_string(c, r);
+					if(s.length!=ar.r.vs.length || memcmp(s.data, ar.r.vs.data, s.length)!=0)
+						errs++;
+					break;
+				}
+				case ULLONG_TYPE:
+				case LLONG_TYPE:
+					if(cbr.get_ullong(c, r)!=ar.r.ul)
+						errs++;
+					break;
+				case FLOAT_TYPE:
+					if(cbr.get_float(c, r)!=ar.r.f)
+						errs++;
+					break;
+				case TIMEVAL_TYPE:
+				case IPV6_TYPE:
+					break;
+				default:
+					if(cbr.get_uint(c, r)!=ar.r.ui)
+						errs++;
+					break;
+				}
+			}
+		}
+	}
+	if(errs || t!=n_tuples){
+		fprintf(stderr,"Error, %d values (or %d of %d rows) read back differ\n", errs, t, n_tuples);
+		exit(1);
+	}
+	printf("read back %d rows, sum %llx\n", t, sum);
+
+	for(int t=0;t<n_tuples;++t)
+		free(tuples[t]);
+	delete mcs;
+}
@@ -1164,6 +1164,240 @@ std::string get_field_string(field_handle f, void * data, int len){
 	return "";
 }
 		
+
+////////////////////////////////////////////
+//			Batch access.
+
+field_plan::field_plan(){
+	row_size = 0;
+	min_tuple_size = 0;
+}
+
+bool field_plan::compile(const std::vector<field_handle> &handles,
+			const std::vector<int> &dst_offsets){
+	fields.clear();
+	copies.clear();
+	strs.clear();
+	row_size = 0;
+	min_tuple_size = 0;
+
+	if(dst_offsets.size()>0 && dst_offsets.size()!=handles.size())
+		return false;
+
+	int pos = 0;
+	for(int i=0;i<handles.size();++i){
+		plan_field pf;
+		pf.type = handles[i].type;
+		pf.src = handles[i].offset;
+		pf.size = type_size(pf.type);
+		if(pf.src<0 || pf.size==0){
+			fields.clear();
+			return false;
+		}
+		if(dst_offsets.size()>0){
+			pf.dst = dst_offsets[i];
+		}else{
+			int align = pf.size<8 ? pf.size : 8;
+			pos = (pos+align-1) & ~(align-1);
+			pf.dst = pos;
+			pos += pf.size;
+		}
+		fields.push_back(pf);
+
+		int src_end = pf.src + (pf.type==VSTR_TYPE ? sizeof(vstring32) : pf.size);
+		if(src_end > min_tuple_size)
+			min_tuple_size = src_end;
+		if(pf.dst+pf.size > row_size)
+			row_size = pf.dst+pf.size;
+
+		if(pf.type==VSTR_TYPE){
+			strs.push_back(i);
+			continue;
+		}
+//			merge with the previous copy if both ends are adjacent
+		if(copies.size()>0){
+			plan_copy &pc = copies.back();
+			if(pc.src+pc.size==pf.src && pc.dst+pc.size==pf.dst){
+				pc.size += pf.size;
+				continue;
+			}
+		}
+		plan_copy pc;
+		pc.src = pf.src;
+		pc.dst = pf.dst;
+		pc.size = pf.size;
+		copies.push_back(pc);
+	}
+	return true;
+}
+
+bool field_plan::compile(query_rep *qr, const std::vector<std::string> &names){
+	std::vector<field_handle> handles;
+	for(int i=0;i<names.size();++i){
+		field_handle fh = qr->get_handle_of_field(names[i]);
+		if(fh.offset<0)
+			return false;
+		handles.push_back(fh);
+	}
+	return compile(handles);
+}
+
+int field_plan::get_num_fields(){
+	return fields.size();
+}
+
+int field_plan::get_type(int i){
+	if(i<0 || i>=fields.size())
+		return UNDEFINED_TYPE;
+	return fields[i].type;
+}
+
+int field_plan::get_offset(int i){
+	if(i<0 || i>=fields.size())
+		return 0;
+	return fields[i].dst;
+}
+
+int field_plan::get_row_size(){
+	return row_size;
+}
+
+int field_plan::get_min_tuple_size(){
+	return min_tuple_size;
+}
+
+//		the checks of unpack_*, once for the tuple
+bool field_plan::check_tuple(const char *data, int len){
+	if(len < min_tuple_size)
+		return false;
+	for(int s=0;s<strs.size();++s){
+		vstring32 vs;
+		memcpy(&vs, data+fields[strs[s]].src, sizeof(vstring32));
+		if((unsigned long long)vs.offset + vs.length > (unsigned long long)len)
+			return false;
+	}
+	return true;
+}
+
+static inline mc_string plan_vstr(const char *data, int offset){
+	vstring32 vs;
+	mc_string ret;
+	memcpy(&vs, data+offset, sizeof(vstring32));
+	ret.length = vs.length;
+	ret.data = (char *)data + vs.offset;
+	return ret;
+}
+
+int field_plan::decode_rows(void * const *tuples, const int *lens, int n,
+			void *rows, int row_size, unsigned char *ok){
+	if(row_size < this->row_size)
+		return -1;
+
+//		locals, as the stores into the rows could alias the vectors
+	const plan_copy *cp = copies.data();
+	const int nc = copies.size();
+	const plan_field *fp = fields.data();
+	const int *sp = strs.data();
+	const int ns = strs.size();
+
+	int n_ok = 0;
+	for(int t=0;t<n;++t){
+		const char *data = (const char *)tuples[t];
+		char *row = (char *)rows + (size_t)t*row_size;
+
+		if(!check_tuple(data, lens[t])){
+			for(int i=0;i<fields.size();++i)
+				memset(row+fp[i].dst, 0, fp[i].size);
+			if(ok) ok[t] = 0;
+			continue;
+		}
+
+//			constant sizes let the compiler turn each into a move
+		for(int c=0;c<nc;++c){
+			switch(cp[c].size){
+			case 4:
+				memcpy(row+cp[c].dst, data+cp[c].src, 4);
+				break;
+			case 8:
+				memcpy(row+cp[c].dst, data+cp[c].src, 8);
+				break;
+			case 16:
+				memcpy(row+cp[c].dst, data+cp[c].src, 16);
+				break;
+			default:
+				memcpy(row+cp[c].dst, data+cp[c].src, cp[c].size);
+				break;
+			}
+		}
+		for(int s=0;s<ns;++s){
+			mc_string vs = plan_vstr(data, fp[sp[s]].src);
+			memcpy(row+fp[sp[s]].dst, &vs, sizeof(mc_string));
+		}
+		if(ok) ok[t] = 1;
+		n_ok++;
+	}
+	return n_ok;
+}
+
+template<class T> static void plan_column(void * const *tuples, int n, int src,
+			const unsigned char *ok, T *col){
+	for(int t=0;t<n;++t){
+		if(ok[t])
+			memcpy(&col[t], (const char *)tuples[t]+src, sizeof(T));
+		else
+			memset(&col[t], 0, sizeof(T));
+	}
+}
+
+int field_plan::decode_columns(void * const *tuples, const int *lens, int n,
+			void * const *cols, unsigned char *ok){
+	if(ok==NULL){
+		if(scratch.size() < n)
+			scratch.resize(n);
+		ok = scratch.data();
+	}
+
+	int n_ok = 0;
+	for(int t=0;t<n;++t){
+		ok[t] = check_tuple((const char *)tuples[t], lens[t]);
+		n_ok += ok[t];
+	}
+
+//		a field at a time, so that each column is written in order
+	for(int i=0;i<fields.size();++i){
+		const plan_field &pf = fields[i];
+		switch(pf.type){
+		case VSTR_TYPE:{
+			mc_string *col = (mc_string *)cols[i];
+			for(int t=0;t<n;++t){
+				if(ok[t]){
+					col[t] = plan_vstr((const char *)tuples[t], pf.src);
+				}else{
+					col[t].length = 0;
+					col[t].data = NULL;
+				}
+			}
+			break;
+		}
+		case TIMEVAL_TYPE:
+			plan_column(tuples, n, pf.src, ok, (timeval *)cols[i]);
+			break;
+		case IPV6_TYPE:
+			plan_column(tuples, n, pf.src, ok, (mc_ipv6_str *)cols[i]);
+			break;
+		case ULLONG_TYPE:
+		case LLONG_TYPE:
+		case FLOAT_TYPE:
+			plan_column(tuples, n, pf.src, ok, (unsigned long long int *)cols[i]);
+			break;
+		default:
+			plan_column(tuples, n, pf.src, ok, (unsigned int *)cols[i]);
+			break;
+		}
+	}
+	return n_ok;
+}
+
 }
 
 
@@ -186,7 +186,84 @@ double get_field_float(field_handle f, void * data, int len);
 timeval get_field_timeval(field_handle f, void * data, int len);
 mc_ipv6_str get_field_ipv6(field_handle f, void * data, int len);
 std::string get_field_string(field_handle f, void * data, int len);
-		
+
+
+////////////////////////////////////////////
+//			Batch access.
+//			A field_plan is compiled once from a list of field handles,
+//			then extracts all of those fields from a whole batch of tuples
+//			in one call.  The type dispatch and the bounds checks of the
+//			per-field functions are done once per plan, and once per tuple,
+//			rather than once per field.
+//
+//			No casting is done: each field is delivered in its own type,
+//			taking type_size() bytes (unsigned int for UINT, USHORT, BOOL
+//			and IP, double for FLOAT, ...).  A string is delivered as an
+//			mc_string pointing into the tuple, so the tuples must outlive
+//			the decoded values.
+//
+//			A tuple which is too short for the fields, or whose string
+//			points outside of it, is bad: its fields are zeroed and its
+//			ok flag is cleared.
+
+//		internally used by field_plan
+struct plan_field{
+	int type;
+	int src;		// offset in the tuple
+	int dst;		// offset in the decoded row
+	int size;		// bytes in the decoded row
+};
+struct plan_copy{
+	int src;
+	int dst;
+	int size;
+};
+
+class field_plan{
+public:
+	field_plan();
+
+//		Compile the plan for the fields, in order.  dst_offsets gives,
+//		for each field, its byte offset in the caller's row struct; if
+//		empty the fields are laid out in order, each aligned to its
+//		size (up to 8 bytes).  false if a handle is not valid.
+	bool compile(const std::vector<field_handle> &handles,
+			const std::vector<int> &dst_offsets = std::vector<int>());
+//		Compile the plan for the named fields.  false if one is not found.
+	bool compile(query_rep *qr, const std::vector<std::string> &names);
+
+//		Number of fields
+	int get_num_fields();
+//		type and row offset of the ith field
+	int get_type(int i);
+	int get_offset(int i);
+//		bytes in a row (at least the end of the last field)
+	int get_row_size();
+//		shortest tuple which can hold the fields
+	int get_min_tuple_size();
+
+//		Decode n tuples (tuples[t] is lens[t] bytes) into n rows, the
+//		tth at rows + t*row_size.  ok, if not NULL, gets 1 for each
+//		good tuple and 0 for each bad one.  Returns the number of good
+//		tuples, -1 if row_size is less than get_row_size().
+	int decode_rows(void * const *tuples, const int *lens, int n,
+			void *rows, int row_size, unsigned char *ok);
+//		Decode n tuples into columns: cols[i] is an array of n values of
+//		the ith field's type.
+	int decode_columns(void * const *tuples, const int *lens, int n,
+			void * const *cols, unsigned char *ok);
+
+private:
+	std::vector<plan_field> fields;
+	std::vector<plan_copy> copies;		// fixed size fields, runs merged
+	std::vector<int> strs;				// indices of the string fields
+	std::vector<unsigned char> scratch;	// ok flags if the caller has none
+	int row_size;
+	int min_tuple_size;
+
+	bool check_tuple(const char *data, int len);
+};
+
 }	
 
 #endif
@@ -63,6 +63,12 @@ char* usage_str =
 		"  MCL_RDC_SUFFIX: the suffix written on each raw data capture file; must include '.'. (.rdc)\n"
 		"  MCL_RDC_SOURCE: a short string used as source identification in rdc file names.\n"
 		"  MCL_RDC_FREQ: the amount of time (seconds) that raw capture files are rolled. (300)\n"
+		"  MCL_RDC_BLOCK: the size (bytes) of the blocks that captured messages are written in. (1048576)\n"
+		"  MCL_RDC_COMPRESS: if set to 1, capture files are written as (compressed) blocks with an index.\n"
+		"  MCL_BATCH: the max number of queued messages received before writing to the FIFOs. (64)\n"
+		"  MCL_FIFO_SIZE: if set, FIFOs are resized to this many bytes (F_SETPIPE_SZ).\n"
+		"  MCL_RING_TYPES: message types (comma separated, or all) written to shared memory rings rather than FIFOs.\n"
+		"  MCL_RING_SIZE: the size (bytes) of each shared memory ring. (4194304)\n"
 		"\nIf either final or staging directories are defined by environment vars, they MUST exist.\n";
 
 /*
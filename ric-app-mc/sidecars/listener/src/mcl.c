@@ -23,10 +23,16 @@
 				should start with mcl_ and all stderr messages should have
 				(mcl) as the first token following the severity indicator.
 
+				Messages are written to a FIFO per message type, or for the
+				types listed in MCL_RING_TYPES, to a shared memory ring
+				(see mcl_ring.h) which the reader maps.
+
 	Date:		22 August 2019
 	Author:		E. Scott Daniels
 */
 
+#define _GNU_SOURCE				// F_SETPIPE_SZ/F_GETPIPE_SZ
+
 #include <unistd.h>
 #include <errno.h>
 #include <stdio.h>
@@ -37,6 +43,7 @@
 #include <signal.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 
 
 #include <rmr/rmr.h>
@@ -44,6 +51,7 @@
 #include <rmr/RIC_message_types.h>
 
 #include "mcl.h"
+#include "mcl_ring.h"
 
 #ifndef FOREVER
 #define FOREVER 1
@@ -55,6 +63,11 @@
 #define TRUE	1
 #define FALSE	0
 
+#define BATCH_MAX	256			// most messages drained in one go (2x must not exceed IOV_MAX)
+#define DEF_BATCH	64			// default drain size; MCL_BATCH overrides
+#define DEF_PIPE_CAP 65536		// assumed pipe capacity if the system can't tell us
+#define HDR_SLOT	32			// space for one header (extended or short) in the batch
+
 /*
 	Information about one file descriptor. This is pointed to by the hash
 	such that the message type can be used as a key to look up the fifo's
@@ -68,6 +81,8 @@ typedef struct {
 
 	long long wcount_rp;	// number of writes during last reporting period
 	long long drops_rp;		// number dropped during last reporting period
+	int	cap;				// pipe capacity (bytes); most we put in one writev
+	mclr_t*	ring;			// shared memory ring written in place of the fifo (writer only)
 } fifo_t;
 
 /*
@@ -79,9 +94,27 @@ typedef struct {
 	void*	wr_hash;			// symtable to look up pipe info based on mt for writing
 	void*	rd_hash;			// we support reading from pipes, but need a different FD for that
 	char*	fifo_dir;			// directory where we open fifos
+	int		pipe_size;			// if >0 fifos opened for writing are resized to this
+	int		batch;				// max messages drained before writing fifos
+	long long wcalls;			// write system calls made on fifos (fanout)
+	char*	ring_types;			// message types written to rings rather than fifos; "all" or a list
+	uint64_t ring_size;			// data bytes in each ring
 
 } mcl_ctx_t;
 
+/*
+	Messages for one fifo in a batch; indexes into the batch are chained
+	through the next array so that receive order is kept.
+*/
+typedef struct {
+	int		mtype;
+	int		fd;
+	fifo_t*	fifo;
+	int		first;				// first and last message index
+	int		last;
+	int		n;
+} fgroup_t;
+
 // -------- private -------------------------------------------------------
 
 
@@ -235,6 +268,72 @@ static int open_fifo( mcl_ctx_t* ctx, int mtype, int io_dir ) {
 	return fd;
 }
 
+/*
+	Returns true if the message type is to be written to a ring rather than
+	to a fifo.
+*/
+static int ring_wanted( mcl_ctx_t* ctx, int mtype ) {
+	char*	tok;
+
+	if( ctx->ring_types == NULL ) {
+		return FALSE;
+	}
+	if( strcmp( ctx->ring_types, "all" ) == 0 ) {
+		return TRUE;
+	}
+
+	for( tok = ctx->ring_types; *tok; ) {
+		if( atoi( tok ) == mtype ) {
+			return TRUE;
+		}
+		tok += strcspn( tok, ", " );
+		tok += strspn( tok, ", " );
+	}
+
+	return FALSE;
+}
+
+/*
+	Create (or attach to) the ring for the message type. The ring file is
+	created alongside the fifo that it replaces: <fifo-dir>/MT_<mtype>.ring.
+	Returns the ring file's fd, or -1 on error.
+*/
+static int open_ring( mcl_ctx_t* ctx, int mtype, fifo_t* fifo ) {
+	char	wbuf[1024];
+
+	snprintf( wbuf, sizeof( wbuf ), "%s/MT_%09d.ring", ctx->fifo_dir, mtype );
+	if( (fifo->ring = mclr_open( wbuf, ctx->ring_size, TRUE )) == NULL ) {
+		logit(  LOG_ERR, "(mcl) unable to create shared memory ring: %s: %s", wbuf, strerror( errno ) );
+		return -1;
+	}
+
+	logit( LOG_INFO, "(mcl) mtype %d is written to ring %s", mtype, wbuf );
+	return fifo->ring->fd;
+}
+
+/*
+	Set the capacity of a pipe we opened for writing if the user asked for a
+	larger (or smaller) one, and return the capacity. The system may cap the
+	size (see /proc/sys/fs/pipe-max-size) so we always ask what we got.
+*/
+static int size_pipe( mcl_ctx_t* ctx, int fd ) {
+	int cap = DEF_PIPE_CAP;
+
+#ifdef F_GETPIPE_SZ
+	if( ctx->pipe_size > 0 ) {
+		if( fcntl( fd, F_SETPIPE_SZ, ctx->pipe_size ) < 0 ) {
+			logit(  LOG_WARN, "(mcl) unable to set fifo size to %d: %s", ctx->pipe_size, strerror( errno ) );
+		}
+	}
+
+	if( (cap = fcntl( fd, F_GETPIPE_SZ )) <= 0 ) {
+		cap = DEF_PIPE_CAP;
+	}
+#endif
+
+	return cap;
+}
+
 /*
 	Given a message type, return the file des of the fifo that
 	the payload should be written to.	 Returns the file des, or -1
@@ -267,8 +366,15 @@ static int suss_fifo( mcl_ctx_t* ctx, int mtype, int io_dir, fifo_t** fref ) {
 		if( fifo != NULL ) {
 			memset( fifo, 0, sizeof( *fifo ) );
 			fifo->key = mtype;
-			fifo->fd = open_fifo( ctx, mtype, io_dir );
+			if( io_dir == WRITER && ring_wanted( ctx, mtype ) ) {
+				fifo->fd = open_ring( ctx, mtype, fifo );
+			} else {
+				fifo->fd = open_fifo( ctx, mtype, io_dir );
+			}
 			if( fifo->fd >= 0 ) {					// save only on good open
+				if( io_dir == WRITER && fifo->ring == NULL ) {
+					fifo->cap = size_pipe( ctx, fifo->fd );
+				}
 				rmr_sym_map( hash, mtype, fifo );
 			} else {
 				free( fifo );
@@ -277,7 +383,14 @@ static int suss_fifo( mcl_ctx_t* ctx, int mtype, int io_dir, fifo_t** fref ) {
 		}
 	} else {
 		if( fifo->fd < 0 ) {				// it existed, but was closed; reopen
-			fifo->fd = open_fifo( ctx, mtype, io_dir );
+			if( io_dir == WRITER && ring_wanted( ctx, mtype ) ) {
+				fifo->fd = open_ring( ctx, mtype, fifo );
+			} else {
+				fifo->fd = open_fifo( ctx, mtype, io_dir );
+			}
+			if( fifo->fd >= 0 && io_dir == WRITER && fifo->ring == NULL ) {
+				fifo->cap = size_pipe( ctx, fifo->fd );
+			}
 		}
 	}
 
@@ -307,6 +420,11 @@ static void close_fifo( mcl_ctx_t* ctx, int mtype, int io_dir ) {
 	}
 
 	if( (fifo = (fifo_t *) rmr_sym_pull( hash, mtype )) != NULL ) {
+		if( fifo->ring != NULL ) {
+			mclr_close( fifo->ring );			// closes the fd too
+			fifo->ring = NULL;
+			fifo->fd = -1;
+		}
 		if( fifo->fd >= 0 ) {
 			close( fifo->fd );
 			fifo->fd = -1;
@@ -365,66 +483,147 @@ static void wr_stats( void* st, void* entry, char const* name, void* thing, void
 }
 
 /*
-	Writes the indicated bytes (n2write) from buf onto the fd. Returns only after
-	full buffer is written, or there is a hard error (not eagain or eintr).
-	Returns the number written; if less than n2write the caller may assume
-	that there was a hard error and errno should reflect.
+	Write everything described by the iovec, after skipping the first skip
+	bytes (already written), looping until done or a hard error (not eagain
+	or eintr). The iovec is modified. Returns 1 if all was written, 0 on
+	error with errno set.
 */
-static inline int write_all( int fd, char const* buf, int n2write ) {
-	ssize_t remain = 0;			// number of bytes remaining to write
-	ssize_t wrote = 0;			// number of bytes written thus far
-	ssize_t state = 0;
-
-	if( fd < 0 ) {
-		errno = EBADFD;
-		return 0;
+static int writev_all( mcl_ctx_t* ctx, int fd, struct iovec* iov, int niov, size_t skip ) {
+	ssize_t state;
+
+	while( niov > 0 ) {
+		while( niov > 0 && skip >= iov->iov_len ) {		// step over what has been written
+			skip -= iov->iov_len;
+			iov++;
+			niov--;
+		}
+		if( niov <= 0 ) {
+			break;
+		}
+		iov->iov_base = (char *) iov->iov_base + skip;
+		iov->iov_len -= skip;
+
+		errno = 0;
+		ctx->wcalls++;
+		if( (state = writev( fd, iov, niov )) < 0 ) {
+			if( errno != EINTR && errno != EAGAIN ) {
+				return 0;
+			}
+			state = 0;
+		}
+		skip = state;
 	}
 
-	errno = 0;
-	remain = n2write;
-	do {
-		if( (state = write( fd, buf + wrote, remain )) > 0 ) {
-			wrote += state;
-			remain = n2write - wrote;
+	return 1;
+}
+
+/*
+	Write a group of messages to a fifo. The iovec has a header and payload
+	pair for each of the nmsgs messages. As many whole messages as the pipe
+	can hold are given to each writev, so usually the group goes in one
+	system call.
+
+	The rules are those of writing a single message: if a writev puts
+	nothing into the pipe (no reader, or the reader isn't keeping up) the
+	messages not yet written are dropped; if it stops part way through a
+	message the rest of that message is written no matter how long it
+	takes so that a header is never left in the pipe without its payload.
+
+	Written, dropped and error counts are added to the caller's counters.
+*/
+static void fifo_writev( mcl_ctx_t* ctx, fifo_t* fifo, int mtype, struct iovec* iov, int nmsgs, long* nok, long* ndrops, long* nerrs ) {
+	ssize_t	state;
+	size_t	bytes;				// bytes in this writev
+	size_t	mlen;				// bytes in one message (header + payload)
+	int		done = 0;			// messages completely written
+	int		end;				// first message not in this writev
+	int		i;
+
+	while( done < nmsgs ) {
+		bytes = iov[done*2].iov_len + iov[(done*2)+1].iov_len;					// always at least one message
+		for( end = done + 1; end < nmsgs; end++ ) {
+			mlen = iov[end*2].iov_len + iov[(end*2)+1].iov_len;
+			if( bytes + mlen > (size_t) fifo->cap ) {
+				break;
+			}
+			bytes += mlen;
 		}
-	} while( remain > 0 && (errno == EINTR || errno == EAGAIN) ) ;
 
-	return wrote;
+		errno = 0;
+		ctx->wcalls++;
+		state = writev( fifo->fd, iov + (done*2), (end - done) * 2 );
+		if( state <= 0 ) {
+			if( state < 0 && errno != EPIPE && errno != EAGAIN ) {
+				logit( LOG_ERR, "(mcl): error writing to fifo; mt=%d: %s", mtype, strerror( errno ) );
+				*nerrs += nmsgs - done;
+				close_fifo( ctx, mtype, WRITER );
+			} else {
+				*ndrops += nmsgs - done;						// no reader, or full; drop silently
+			}
+
+			for( i = done; i < nmsgs; i++ ) {
+				chalk_error( fifo );
+			}
+			return;
+		}
+
+		while( done < end ) {									// count the whole messages written
+			mlen = iov[done*2].iov_len + iov[(done*2)+1].iov_len;
+			if( (size_t) state < mlen ) {
+				break;
+			}
+			state -= mlen;
+			chalk_ok( fifo );
+			(*nok)++;
+			done++;
+		}
+
+		if( done < end && state > 0 ) {						// short in the middle of a message; must finish it
+			if( ! writev_all( ctx, fifo->fd, iov + (done*2), 2, state ) ) {
+				logit( LOG_ERR, "(mcl): error writing payload to fifo; mt=%d: %s", mtype, strerror( errno ) );
+				*nerrs += nmsgs - done;
+				for( i = done; i < nmsgs; i++ ) {
+					chalk_error( fifo );
+				}
+				close_fifo( ctx, mtype, WRITER );
+				return;
+			}
+
+			chalk_ok( fifo );
+			(*nok)++;
+			done++;
+		}
+	}
 }
 
 /*
-	Similar to write_all, this will write all bytes in the buffer, but
-	will return failure if the first write attempt fails with 0 written
-	(assuming that the pipe has no reader). We use this when writing the
-	header bytes; we want to drop the message if we can't even write one
-	byte, but if we write one, we must loop until all are written.
-
-	Returns the number written. If that value is less than n2write, then
-	the caller may assume a hard error occurred and errno should reflect.
-	If 0 is returned it can be assumed that the FIFO would block/has no
-	reader.
+	Put a group of messages into the fifo's ring. The iovec is the same as
+	for fifo_writev(); headers are not needed as the ring has its own. The
+	reader is woken, if it is asleep, once for the group; the wake is the
+	only system call and is counted as a write call. Messages which don't
+	fit are dropped.
 */
-static inline int write_all_nb( int fd, char const* buf, int n2write ) {
-	ssize_t remain = 0;			// number of bytes remaining to write
-	ssize_t wrote = 0;			// number of bytes written
+static void ring_writev( mcl_ctx_t* ctx, fifo_t* fifo, struct iovec* iov, int mtype, int nmsgs, long* nok, long* ndrops ) {
+	struct timespec ts;
+	uint64_t	ms;
+	int		i;
 
-	if( fd < 0 ) {
-		errno = EBADFD;
-		return 0;
-	}
+	clock_gettime( CLOCK_REALTIME, &ts );
+	ms = ((uint64_t) ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
 
-	errno = 0;
-	remain = n2write;
-	wrote = write( fd, buf, remain );
-	if( wrote < 0 ) {								// report error with exception for broken pipe
-		return errno == EPIPE ? 0 : -1;				// broken pipe we assume no reader and return 0 since nothing written
+	for( i = 0; i < nmsgs; i++ ) {
+		if( mclr_put( fifo->ring, mtype, ms, iov[(i*2)+1].iov_base, iov[(i*2)+1].iov_len ) ) {
+			chalk_ok( fifo );
+			(*nok)++;
+		} else {
+			chalk_error( fifo );
+			(*ndrops)++;
+		}
 	}
 
-	if( wrote < n2write  &&  wrote > 0 ) {			// if we wrote anything, we must tough it out and write all if it was short
-		wrote +=  write_all( fd, buf + wrote, n2write - wrote );
+	if( mclr_wake( fifo->ring ) ) {
+		ctx->wcalls++;
 	}
-
-	return wrote;
 }
 
 // ---------- public ------------------------------------------------------
@@ -496,14 +695,42 @@ extern rmr_mbuf_t* mcl_get_msg( void* vctx, rmr_mbuf_t* msg, int timeout ) {
 }
 
 /*
-	Create the context.
+	Create the context. The fifo size and the number of messages batched by
+	fanout are picked up from the environment (MCL_FIFO_SIZE, MCL_BATCH), as
+	are the message types written to rings and the ring size (MCL_RING_TYPES,
+	MCL_RING_SIZE).
 */
 extern	void* mcl_mk_context( const char* dir ) {
 	mcl_ctx_t*	ctx;
+	char*		ep;
 
 	if( (ctx = (mcl_ctx_t *) malloc( sizeof( *ctx ) )) != NULL ) {
 		memset( ctx, 0, sizeof( *ctx ) );
 		ctx->fifo_dir = strdup( dir );
+
+		ctx->batch = DEF_BATCH;
+		if( (ep = getenv( "MCL_BATCH" )) != NULL ) {
+			ctx->batch = atoi( ep );
+			if( ctx->batch < 1 ) {
+				ctx->batch = 1;
+			}
+			if( ctx->batch > BATCH_MAX ) {
+				ctx->batch = BATCH_MAX;
+			}
+		}
+
+		if( (ep = getenv( "MCL_FIFO_SIZE" )) != NULL ) {
+			ctx->pipe_size = atoi( ep );
+		}
+
+		if( (ep = getenv( "MCL_RING_TYPES" )) != NULL && *ep ) {
+			ctx->ring_types = strdup( ep );
+		}
+		ctx->ring_size = MCLR_DEF_SIZE;
+		if( (ep = getenv( "MCL_RING_SIZE" )) != NULL && atol( ep ) > 0 ) {
+			ctx->ring_size = (uint64_t) atol( ep );
+		}
+
 		ctx->wr_hash = rmr_sym_alloc( 1001 );
 		ctx->rd_hash = rmr_sym_alloc( 1001 );
 
@@ -679,22 +906,41 @@ extern int mcl_fifo_tsread1( void *vctx, int mtype, char* ubuf, int ublen, int l
 	The one message which is NOT pushed into a FIFO is the RIC_HEALTH_CHECK_REQ
 	message.  When the health check message is received it is responded to
 	with the current state of processing (ok or err).
+
+	Messages are processed in batches: once a message has arrived, whatever else
+	RMR has already queued (up to the batch size) is received without waiting.
+	The messages are grouped by fifo and each group is written with a single
+	writev (more only if the group is larger than the pipe can hold) rather than
+	a write for the header and another for the payload of every message. Order is
+	kept within each fifo; nothing is ever held back waiting for a batch to fill.
 */
 extern void mcl_fifo_fanout( void* vctx, int report, int long_hdr ) {
 	mcl_ctx_t*	ctx;					// our context; mostly for the rmr context reference and symtable
 	fifo_t*		fifo;					// fifo to chalk counts on
-	rmr_mbuf_t*	mbuf = NULL;			// received message buffer; recycled on each call
-	char		header[128];			// header we'll pop in front of the payload
+	rmr_mbuf_t*	mbuf;					// message being processed
+	rmr_mbuf_t*	mbufs[BATCH_MAX];		// received message buffers; recycled on each pass
+	char		hdrs[BATCH_MAX][HDR_SLOT];	// header we'll pop in front of each payload
+	int			next[BATCH_MAX];		// chains the messages of a group
+	fgroup_t	groups[BATCH_MAX];		// messages grouped by destination fifo
+	struct iovec iov[BATCH_MAX*2];		// header/payload pairs for one group
+	int			nmsgs;					// messages in the batch
+	int			ngroups;
 	int			fd;						// file des to write to
+	int			g;
+	int			i;
+	int			j;
+	long		ok;						// counts from a group write
+	long		gdrops;
+	long		gerrs;
 	long long	total = 0;				// total messages received and written
 	long long	total_drops = 0;		// total messages received and written
+	long long	wcalls_rp = 0;			// fifo write calls at the start of the reporting period
 	long		count = 0;				// messages received and written during last reporting period
 	long		errors = 0;				// unsuccessful payload writes
 	long		drops = 0;				// number of drops
 	time_t		next_report = 0;		// we'll report every 2 seconds if report is true
 	time_t		now;
 	size_t		hwlen;					// write len for header
-	size_t		wrote;					// number of bytes actually written
 	void*		rdc_ctx = NULL;			// raw data capture context
 	void*		rdc_buf = NULL;			// capture buffer
 
@@ -708,75 +954,117 @@ extern void mcl_fifo_fanout( void* vctx, int report, int long_hdr ) {
 		report = 0;
 	}
 
+	if( ctx->batch < 1 || ctx->batch > BATCH_MAX ) {
+		ctx->batch = ctx->batch < 1 ? 1 : BATCH_MAX;
+	}
+	memset( mbufs, 0, sizeof( mbufs ) );
+	hwlen = long_hdr ? MCL_EXHDR_SIZE : MCL_LEN_SIZE;
+
 	rdc_ctx = setup_rdc( );				// pull rdc directories from enviornment and initialise
 
 	do {
-		mbuf = mcl_get_msg( ctx, mbuf, report );			// wait up to report sec for msg (0 == block until message)
+		nmsgs = 0;
+		mbufs[0] = mcl_get_msg( ctx, mbufs[0], report );			// wait up to report sec for msg (0 == block until message)
+		if( mbufs[0] != NULL && mbufs[0]->state == RMR_OK ) {
+			nmsgs = 1;
+			while( nmsgs < ctx->batch ) {							// pick up anything else already queued, no waiting
+				mbufs[nmsgs] = rmr_torcv_msg( ctx->mrc, mbufs[nmsgs], 0 );
+				if( mbufs[nmsgs] == NULL || mbufs[nmsgs]->state != RMR_OK ) {
+					break;
+				}
+				nmsgs++;
+			}
+		} else {
+			if( rdc_ctx != NULL ) {
+				rdc_flush( rdc_ctx );						// idle; don't leave captured records buffered
+			}
+		}
+
+		ngroups = 0;
+		for( i = 0; i < nmsgs; i++ ) {
+			mbuf = mbufs[i];
 
-		if( mbuf != NULL && mbuf->state == RMR_OK ) {
 			if( mbuf->mtype == RIC_HEALTH_CHECK_REQ ) {
 				mbuf->mtype = RIC_HEALTH_CHECK_RESP;		// if we're here we are running and all is ok
 				mbuf->sub_id = -1;
 				mbuf = rmr_realloc_payload( mbuf, 128, FALSE, FALSE );	// ensure payload is large enough
 				if( mbuf->payload != NULL ) {
 					strncpy( mbuf->payload, "OK\n", rmr_payload_size( mbuf) );
-					rmr_rts_msg( ctx->mrc, mbuf );
+					mbuf = rmr_rts_msg( ctx->mrc, mbuf );
 				}
+				mbufs[i] = mbuf;
 				continue;
 			}
 
 			if( mbuf->len > 0  ) {
 				if( long_hdr ) {
-					build_hdr( mbuf->len, header, sizeof( header ) );
-					hwlen = MCL_EXHDR_SIZE;
+					build_hdr( mbuf->len, hdrs[i], HDR_SLOT );
 				} else {
-					snprintf( header, sizeof( header ), "%07d", mbuf->len );			// size of payload CAUTION: 7d is MCL_LEN_SIZE-1
-					hwlen = MCL_LEN_SIZE;
+					snprintf( hdrs[i], HDR_SLOT, "%07d", mbuf->len );			// size of payload CAUTION: 7d is MCL_LEN_SIZE-1
 				}
 
-				fd = suss_fifo( ctx, mbuf->mtype, WRITER, &fifo );					// map the message type to an open fd
-				if( fd >= 0 ) {
-					if( (wrote = write_all_nb( fd, header, hwlen )) == 0 ) {		// write header; 0 indicates no reader, drop silently
-						drops++;
-						total_drops++;
-						chalk_error( fifo );
-					} else {
-						if( wrote != hwlen ) {
-							logit( LOG_ERR, "(mcl): error writing header to fifo; mt=%d wrote=%d tried=%d: %s", mbuf->mtype, wrote, hwlen, strerror( errno ) );
-							errors++;
-							chalk_error( fifo );
-							close_fifo( ctx, mbuf->mtype, WRITER );
-						} else {
-							if( write_all( fd, mbuf->payload, mbuf->len ) != mbuf->len ) {		// we wrote a header, so we must write all; no drop at this point
-								logit( LOG_ERR, "(mcl): error writing payload to fifo; mt=%d: %s\n", mbuf->mtype, strerror( errno ) );
-								close_fifo( ctx, mbuf->mtype, WRITER );
-							} else {
-								chalk_ok( fifo );
-								count++;
-								total++;
-							}
-						}
-					}
+				for( g = ngroups - 1; g >= 0 && groups[g].mtype != mbuf->mtype; g-- );		// few types in a batch; recent is likely
+				if( g < 0 ) {
+					g = ngroups++;
+					groups[g].mtype = mbuf->mtype;
+					groups[g].fd = suss_fifo( ctx, mbuf->mtype, WRITER, &groups[g].fifo );	// map the message type to an open fd
+					groups[g].first = i;
+					groups[g].n = 0;
+				} else {
+					next[groups[g].last] = i;
 				}
+				groups[g].last = i;
+				groups[g].n++;
 
-				if( rdc_ctx != NULL ) {						// always put the message to the rdc files if collecting; eve if pipe write failed
-					rdc_buf = rdc_init_buf( mbuf->mtype, header, hwlen, rdc_buf );			// set up for write
+				if( rdc_ctx != NULL ) {						// always put the message to the rdc files if collecting; even if pipe write fails
+					rdc_buf = rdc_init_buf( mbuf->mtype, hdrs[i], hwlen, rdc_buf );			// set up for write
 					rdc_write( rdc_ctx, rdc_buf, mbuf->payload, mbuf->len );				// write the raw data
 				}
 			}
 		}
 
+		for( g = 0; g < ngroups; g++ ) {
+			if( (fd = groups[g].fd) < 0 ) {
+				continue;
+			}
+
+			for( i = groups[g].first, j = 0; j < groups[g].n; i = next[i], j++ ) {
+				iov[j*2].iov_base = hdrs[i];
+				iov[j*2].iov_len = hwlen;
+				iov[(j*2)+1].iov_base = mbufs[i]->payload;
+				iov[(j*2)+1].iov_len = mbufs[i]->len;
+			}
+
+			fifo = groups[g].fifo;
+			ok = gdrops = gerrs = 0;
+			if( fifo->ring != NULL ) {
+				ring_writev( ctx, fifo, iov, groups[g].mtype, groups[g].n, &ok, &gdrops );
+			} else {
+				if( fifo->cap <= 0 ) {
+					fifo->cap = DEF_PIPE_CAP;
+				}
+				fifo_writev( ctx, fifo, groups[g].mtype, iov, groups[g].n, &ok, &gdrops, &gerrs );
+			}
+			count += ok;
+			total += ok;
+			drops += gdrops;
+			total_drops += gdrops;
+			errors += gerrs;
+		}
+
 		if( report ) {
 			if( (now = time( NULL ) ) > next_report ) {
 				rmr_sym_foreach_class( ctx->wr_hash, 0, wr_stats, &report );        // run endpoints in the active table
 				fflush( stdout );
 
-				logit( LOG_STAT, "(mcl) total writes=%lld total drops=%lld; during last %ds writes=%ld drops=%ld errs=%ld errors",
-					total, total_drops, report, count, drops, errors );
+				logit( LOG_STAT, "(mcl) total writes=%lld total drops=%lld; during last %ds writes=%ld drops=%ld errs=%ld errors; fifo syscalls/msg=%.2f",
+					total, total_drops, report, count, drops, errors,
+					count + drops > 0 ? (double) (ctx->wcalls - wcalls_rp) / (double) (count + drops) : 0.0 );
 				next_report = now + report;
 				count = 0;
 				drops = 0;
 				errors = 0;
+				wcalls_rp = ctx->wcalls;
 
 				fflush( stdout );
 			}
@@ -784,6 +1072,11 @@ extern void mcl_fifo_fanout( void* vctx, int report, int long_hdr ) {
 
 		if( ! FOREVER ) {			// allow escape during unit tests; compiled out othewise, but sonar won't see that
 			free( rdc_buf );
+			for( i = 0; i < BATCH_MAX; i++ ) {
+				if( mbufs[i] != NULL ) {
+					rmr_free_msg( mbufs[i] );
+				}
+			}
 			break;					// sonar grumbles if we put FOREVER into the while; maddening
 		}
 	} while( 1 );
@@ -811,7 +1104,12 @@ extern int mcl_fifo_one( void* vctx, const char* payload, int plen, int mtype )
 
 	fd = suss_fifo( ctx, mtype, WRITER, &fifo );		// map the message type to an open fd
 	if( fd >= 0 ) {
-		state = write( fd, payload, plen );
+		if( fifo->ring != NULL ) {
+			state = mclr_put( fifo->ring, mtype, 0, payload, plen ) ? plen : 0;
+			mclr_wake( fifo->ring );
+		} else {
+			state = write( fd, payload, plen );
+		}
 	}
 
 	return state == (size_t) plen;
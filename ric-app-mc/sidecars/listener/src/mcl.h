@@ -70,6 +70,13 @@ extern void* rdc_init_buf( int mtype, const char* uheader, int uhlen, void* capt
 extern void rdc_close( void* rdl_ctx );
 extern void rdc_set_freq( void* rdl_ctx, int freq );
 extern int rdc_write( void* rdl_ctx, void* rdc_buffer, const char* payload, int len );
+extern void rdc_flush( void* rdl_ctx );
+
+// ---- reading capture files (either format) ----
+extern void* rdc_reader( int fd );
+extern int rdc_read_rec( void* reader, int* mtype, char** data );
+extern int rdc_seek_rec( void* reader, long long n );
+extern void rdc_free_reader( void* reader );
 
 
 #endif
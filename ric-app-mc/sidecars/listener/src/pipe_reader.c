@@ -23,6 +23,10 @@
 				programme is primarily for verification or example of how to use the
 				read1() function in the mc-listener library.
 
+				With -R the shared memory ring for the message type (see
+				mcl_ring.h) is read rather than the FIFO; the listener must
+				have been started with the type in MCL_RING_TYPES.
+
 	Date:		22 August 2019
 	Author:		E. Scott Daniels
 */
@@ -37,6 +41,7 @@
 
 
 #include "mcl.h"
+#include "mcl_ring.h"
 
 //---- support -----------------------------------------------------------------------------
 
@@ -45,11 +50,12 @@ static void bad_arg( char* what ) {
 }
 
 static void usage( char* argv0 ) {
-	fprintf( stderr, "usage: %s [-d fifo-dir] [-e] [-m msg-type] [-s]\n", argv0 );
+	fprintf( stderr, "usage: %s [-d fifo-dir] [-e] [-m msg-type] [-R] [-s]\n", argv0 );
 	fprintf( stderr, "   -d  dir (default is /tmp/mcl/fifos)\n" );
 	fprintf( stderr, "   -e  disable extended headers expectation in FIFO data\n" );
 	fprintf( stderr, "   -m  msg-type (default is 0)\n" );
 	fprintf( stderr, "   -M  max msg to read (default is all)\n" );
+	fprintf( stderr, "   -R  read the shared memory ring rather than the FIFO\n" );
 	fprintf( stderr, "   -s  stats only mode\n" );
 }
 
@@ -62,6 +68,53 @@ static void sigh( int sig ) {
 	exit( 0 );
 }
 
+/*
+	Wait for the listener to create the ring for the message type and attach.
+*/
+static mclr_t* ring_attach( char* dname, int mtype ) {
+	char	wbuf[1024];
+	mclr_t*	ring;
+
+	snprintf( wbuf, sizeof( wbuf ), "%s/MT_%09d.ring", dname, mtype );
+	while( (ring = mclr_open( wbuf, 0, 0 )) == NULL ) {
+		if( errno != ENOENT && errno != EAGAIN ) {
+			fprintf( stderr, "[FAIL] unable to open ring %s: %s\n", wbuf, strerror( errno ) );
+			exit( 1 );
+		}
+		sleep( 1 );
+	}
+
+	fprintf( stderr, "[INFO] reading ring %s\n", wbuf );
+	return ring;
+}
+
+/*
+	Read one message from the ring, waiting up to a second for one to arrive.
+	The timestamp is formatted like the one in the FIFO extended header.
+	Returns the number of bytes placed into buf, 0 if nothing arrived.
+*/
+static int ring_read1( mclr_t* ring, char* buf, int blen, char* timestamp ) {
+	char*	data;
+	uint64_t ts;
+	int		len;
+
+	if( (len = mclr_next( ring, NULL, &ts, &data )) <= 0 ) {
+		mclr_wait( ring, 1000 );
+		if( (len = mclr_next( ring, NULL, &ts, &data )) <= 0 ) {
+			return 0;
+		}
+	}
+
+	if( len > blen ) {
+		len = blen;									// truncate like a short user buffer on read1()
+	}
+	memcpy( buf, data, len );
+	mclr_release( ring );
+
+	snprintf( timestamp, MCL_TSTAMP_SIZE, "%llu", (unsigned long long) ts );
+	return len;
+}
+
 //------------------------------------------------------------------------------------------
 int main( int argc,  char** argv ) {
 	void*	ctx;							// the mc listener library context
@@ -77,7 +130,11 @@ int main( int argc,  char** argv ) {
 	char	timestamp[MCL_TSTAMP_SIZE];		// we'll get the timestamp from this
 	long	count = 0;
 	int		blabber = 0;
+	long	last_count = 0;					// count at the last stats line
+	time_t	last_blabber = 0;
 	int		max = 0;						// we'll force one reader down early to simulate MC going away
+	int		use_ring = 0;
+	mclr_t*	ring = NULL;
 
 	dname = strdup( "/tmp/mcl/fifos" );		// default to this so we can blindly free in 'd' to keep sonar happy
 	signal( SIGINT, sigh );
@@ -126,6 +183,10 @@ int main( int argc,  char** argv ) {
 				}
 				break;
 
+			case 'R':
+				use_ring = 1;
+				break;
+
 			case 's':
 				stats_only = 1;
 				break;
@@ -155,13 +216,28 @@ int main( int argc,  char** argv ) {
 		exit( 1 );
 	}
 
+	if( use_ring ) {
+		ring = ring_attach( dname, mtype );
+	}
+
 	fprintf( stderr, "[INFO] max = %d\n", max );
 	while( max == 0 || count < max ) {
-		len = mcl_fifo_tsread1( ctx, mtype, buf, sizeof( buf ) -1, long_hdrs, timestamp );
+		if( ring != NULL ) {
+			len = ring_read1( ring, buf, sizeof( buf ) -1, timestamp );
+		} else {
+			len = mcl_fifo_tsread1( ctx, mtype, buf, sizeof( buf ) -1, long_hdrs, timestamp );
+		}
 		if( len > 0 ) {
 			if( stats_only ) {
 				if( time( NULL ) > blabber ) {
-					fprintf( stdout, "[%d] %ld messages received\n", mtype, count );
+					if( last_blabber > 0 ) {
+						fprintf( stdout, "[%d] %ld messages received  %.0f msgs/sec\n", mtype, count,
+							(double) (count - last_count) / (double) (time( NULL ) - last_blabber) );
+					} else {
+						fprintf( stdout, "[%d] %ld messages received\n", mtype, count );
+					}
+					last_count = count;
+					last_blabber = time( NULL );
 					blabber = time( NULL ) + 2;
 				}
 			} else {
@@ -174,7 +250,9 @@ int main( int argc,  char** argv ) {
 
 			count++;
 		} else {
-			sleep( 1 );
+			if( ring == NULL ) {
+				sleep( 1 );							// ring read has already waited
+			}
 		}
 	}
 	free(dname);	// lets keep SONAR happy
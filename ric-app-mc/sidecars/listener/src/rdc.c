@@ -30,6 +30,21 @@
 				Where <mtype> is the message type of the message received and
 				<len> is the length of the data that was written to the FIFO.
 
+				Records are not written as they arrive. They are packed into
+				large blocks which are handed to a writer thread; that thread
+				owns the file and does the writing, rolling and moving so that
+				none of it happens on the listener's receive thread. Blocks are
+				written as they are (the file is a stream of @RDC records, as
+				it always was) unless compression is enabled, in which case
+				each block is written as a frame:
+					@RDB<codec><raw-len><stored-len><nrecs>
+
+				followed by the (compressed) block. When the file is closed an
+				index of the blocks (offset and number of the first record in
+				each) and a footer pointing at the index are added so that a
+				reader can seek to a record without decompressing everything
+				before it. The reader functions at the end of this module
+				handle both formats.
 
 	Date:		06 Oct 2019
 	Author:		E. Scott Daniels
@@ -43,7 +58,13 @@
 #include <stdlib.h>
 #include <time.h>
 #include <string.h>
+#include <pthread.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+
+#ifdef RDC_ZLIB
+#include <zlib.h>
+#endif
 
 #include "mcl.h"
 
@@ -59,21 +80,79 @@ typedef struct {
 	int		mtype;			// message type
 } cap_buf_t;
 
+/*
+	A block of records. Blocks are filled by the receive thread and queued
+	for the writer; a close request is queued as a block too so that it
+	is processed in order with the data.
+*/
+typedef struct rdc_blk {
+	struct rdc_blk* next;	// queue/free list
+	char*	data;			// aligned buffer
+	size_t	cap;			// size of data
+	size_t	len;			// bytes used
+	int		nrec;			// records in the block
+	int		kind;			// BLK_* constant
+	time_t	period;			// start of the file period that the records belong to
+	time_t	first;			// time the first record was added
+} rdc_blk_t;
+
 typedef struct {
 	int		flags;			// DFFL_* constatnts
 	int		frequency;		// the frequency at which files are rolled
-	int		fd;				// current open write file
+	int		fd;				// current open write file (writer thread)
 	char*	sdir;			// staging directory
 	char*	fdir;			// final directory
 	char*	suffix;			// suffix for final file (must include . if needed)
 	char*	dsuffix;		// suffix for done file
 	char*	basename;		// base name of the file being written to
 	char*	openname;		// full filename that is open for writing
+	char*	lastname;		// final name of the last file closed and moved
 	char*	source;			// added to output file names to differentiate the source
 	time_t	next_roll;		// time we should roll the file
+	time_t	period;			// start of the current period (receive thread)
+
+	size_t	bsize;			// block size
+	int		compress;		// blocks are written as compressed frames
+	rdc_blk_t*	cur;		// block being filled by the receive thread
+	rdc_blk_t	cblk;		// close request
+
+	int		running;		// writer thread has been started
+	pthread_t	writer;
+	pthread_mutex_t gate;	// protects the queue, free list and the counters below
+	pthread_cond_t	wake;	// writer waits for work
+	pthread_cond_t	done;	// receive thread waits for a free block, or the queue to drain
+	rdc_blk_t*	qhead;		// blocks to write, in order
+	rdc_blk_t*	qtail;
+	rdc_blk_t*	free_list;
+	int		nalloc;			// blocks allocated
+	int		busy;			// writer is working on a block it has taken from the queue
+	int		last_err;		// errno from a failed write not yet passed back to rdc_write()
+	long	werrors;		// write failures
+	long	stalls;			// waits for a free block
+
+	off_t	offset;			// writer thread only: where the next block goes
+	time_t	fperiod;		// period of the open file
+	long long	nrec;		// records in the open file
+	long long*	idx;		// block index: offset, first record number pairs
+	int		nidx;
+	int		aidx;			// entries allocated (pairs)
+	int		noindex;		// file was appended to; its index would be wrong
+	char*	zbuf;			// compression buffer
+	size_t	zcap;
 } rdc_ctx_t;
 
 #define RDC_DELIM	"@RDC"		// delimeter used in our file
+#define RDC_HDR_SIZE	20		// record header: @RDC<mtype><len>
+#define RDC_FRAME_SIZE	32		// block, index and footer headers
+
+#define BLK_DATA	0
+#define BLK_CLOSE	1
+
+#define DEF_BLOCK	(1024 * 1024)	// default block size; MCL_RDC_BLOCK overrides
+#define MIN_BLOCK	4096
+#define RDC_ALIGN	4096			// block buffer alignment
+#define NBLOCKS		4				// blocks in flight before the receive thread must wait
+#define MAX_AGE		2				// seconds a partial block may wait for more records
 
 // -------------------------------------------------------------------------------------------
 
@@ -193,27 +272,20 @@ static int mvocp( char* old, char* new ) {
 }
 
 /*
-	Opens a new file for writing. Returns the fd. The context fname field will
-	in the context point to the basename (no suffix) on return.
+	Opens a new file for writing records belonging to the period that
+	starts at ts. Returns the fd. The context basename field will point
+	to the basename (no suffix) on return. Called only by the writer.
 */
-static int rdc_open( void* vctx ) {
+static int rdc_open( rdc_ctx_t* ctx, time_t ts ) {
 	char	fname[2048];
 	char	basename[2048];
+	struct stat	sb;
 	int		fd;
-	time_t	ts;				// time stamp, rounded to previous frequency
-	rdc_ctx_t* ctx;
-
-	ctx = (rdc_ctx_t *) vctx;
-
 
 	if( ctx == NULL ) {
 		return -1;
 	}
 
-	ts = time( NULL );
-	ts = ts - (ts % ctx->frequency);			// round to previous frequency
-	ctx->next_roll = ts + ctx->frequency;		// set next time to roll the file
-
 	snprintf( basename, sizeof( fname ), "MCLT%s_%ld", ctx->source, ts );		// basename needed to build final file name at close
 	snprintf( fname, sizeof( fname ), "%s/MCLT_%ld", ctx->sdir, ts );
 	fd = open( fname, O_WRONLY | O_CREAT, 0200 );		// open in w-- mode so that it should not be readable
@@ -222,15 +294,384 @@ static int rdc_open( void* vctx ) {
 		return fd;										// leave errno set by open attempt
 	}
 
-	lseek( fd, 0, SEEK_END );							// if file existed, continue appending to it
+	ctx->offset = 0;
+	ctx->noindex = 0;
+	if( fstat( fd, &sb ) == 0 && sb.st_size > 0 ) {		// if file existed, continue appending to it
+		ctx->offset = sb.st_size;
+		ctx->noindex = 1;								// record numbers in an index would not start at 0
+	}
+	ctx->nrec = 0;
+	ctx->nidx = 0;
+
 	logit( LOG_INFO, "(rdf) now writing to: %s", fname );
 	ctx->openname = strdup( fname );
 	ctx->basename = strdup( basename );
+	ctx->fperiod = ts;
 	ctx->fd = fd;
 
 	return fd;
 }
 
+/*
+	Write the vector at the offset, riding over short writes and interrupts.
+	The iovec is modified. Returns 0 on success, -1 with errno set.
+*/
+static int rdc_pwritev( int fd, struct iovec* iov, int niov, off_t off ) {
+	ssize_t	wlen;
+
+	while( niov > 0 ) {
+		if( (wlen = pwritev( fd, iov, niov, off )) < 0 ) {
+			if( errno == EINTR ) {
+				continue;
+			}
+			return -1;
+		}
+
+		off += wlen;
+		while( niov > 0 && wlen >= (ssize_t) iov->iov_len ) {		// skip what was completely written
+			wlen -= iov->iov_len;
+			iov++;
+			niov--;
+		}
+		if( niov > 0 ) {
+			iov->iov_base = (char *) iov->iov_base + wlen;
+			iov->iov_len -= wlen;
+		}
+	}
+
+	return 0;
+}
+
+/*
+	Note a write failure. It is logged unless an earlier one has not yet been
+	passed back; the receive thread is told on its next rdc_write() call.
+*/
+static void rdc_werror( rdc_ctx_t* ctx, const char* what ) {
+	int		err;
+
+	err = errno;
+	pthread_mutex_lock( &ctx->gate );
+	if( ctx->last_err == 0 ) {
+		logit( LOG_ERR, "(rdc) %s failed: %s: %s", what, ctx->openname != NULL ? ctx->openname : "", strerror( err ) );
+	}
+	ctx->last_err = err;
+	ctx->werrors++;
+	pthread_mutex_unlock( &ctx->gate );
+}
+
+/*
+	Write one block to the open file. In compressed mode the block is
+	written as a frame and added to the index. If compression does not
+	make the block smaller it is stored as is (codec 'n').
+*/
+static void rdc_write_blk( rdc_ctx_t* ctx, rdc_blk_t* blk ) {
+	struct iovec	iov[2];
+	char	frame[RDC_FRAME_SIZE+1];
+	char*	stored;
+	size_t	slen;
+	int		codec = 'n';
+	long long*	ni;
+
+	if( ! ctx->compress ) {
+		iov[0].iov_base = blk->data;
+		iov[0].iov_len = blk->len;
+		if( rdc_pwritev( ctx->fd, iov, 1, ctx->offset ) < 0 ) {
+			rdc_werror( ctx, "write" );
+			return;
+		}
+		ctx->offset += blk->len;
+		ctx->nrec += blk->nrec;
+		return;
+	}
+
+	stored = blk->data;
+	slen = blk->len;
+#ifdef RDC_ZLIB
+	{
+		uLongf	zlen;
+
+		zlen = compressBound( blk->len );
+		if( zlen > ctx->zcap ) {
+			free( ctx->zbuf );
+			ctx->zcap = zlen;
+			ctx->zbuf = (char *) malloc( ctx->zcap );
+		}
+		if( ctx->zbuf != NULL && compress2( (Bytef *) ctx->zbuf, &zlen, (Bytef *) blk->data, blk->len, 1 ) == Z_OK && zlen < blk->len ) {
+			stored = ctx->zbuf;
+			slen = zlen;
+			codec = 'z';
+		}
+	}
+#endif
+
+	snprintf( frame, sizeof( frame ), "@RDB%c%010ld%010ld%07d", codec, (long) blk->len, (long) slen, blk->nrec );
+	iov[0].iov_base = frame;
+	iov[0].iov_len = RDC_FRAME_SIZE;
+	iov[1].iov_base = stored;
+	iov[1].iov_len = slen;
+	if( rdc_pwritev( ctx->fd, iov, 2, ctx->offset ) < 0 ) {
+		rdc_werror( ctx, "write" );
+		return;
+	}
+
+	if( ctx->nidx >= ctx->aidx ) {
+		ni = (long long *) realloc( ctx->idx, sizeof( *ni ) * 2 * (ctx->aidx + 1024) );
+		if( ni == NULL ) {
+			ctx->noindex = 1;				// readers can still walk the file
+		} else {
+			ctx->idx = ni;
+			ctx->aidx += 1024;
+		}
+	}
+	if( ctx->nidx < ctx->aidx ) {
+		ctx->idx[ctx->nidx*2] = ctx->offset;
+		ctx->idx[(ctx->nidx*2)+1] = ctx->nrec;
+		ctx->nidx++;
+	}
+
+	ctx->offset += RDC_FRAME_SIZE + slen;
+	ctx->nrec += blk->nrec;
+}
+
+/*
+	Write the block index and the footer which points at it. The index is
+	a frame header followed by one 32 byte entry for each block: the offset
+	of the block and the number (0 based) of its first record.
+		@RDI <nblocks><nrecs>
+		@RDX<index-offset><nblocks>
+*/
+static void rdc_write_idx( rdc_ctx_t* ctx ) {
+	struct iovec	iov[3];
+	char	frame[RDC_FRAME_SIZE+1];
+	char	footer[RDC_FRAME_SIZE+1];
+	char*	entries;
+	int		i;
+
+	if( ! ctx->compress || ctx->noindex || ctx->nidx == 0 ) {
+		return;
+	}
+
+	if( (entries = (char *) malloc( (ctx->nidx * RDC_FRAME_SIZE) + 1 )) == NULL ) {
+		return;
+	}
+	for( i = 0; i < ctx->nidx; i++ ) {
+		snprintf( entries + (i * RDC_FRAME_SIZE), RDC_FRAME_SIZE+1, "%016lld%016lld", ctx->idx[i*2], ctx->idx[(i*2)+1] );
+	}
+
+	snprintf( frame, sizeof( frame ), "@RDI %010d%010lld0000000", ctx->nidx, ctx->nrec );
+	snprintf( footer, sizeof( footer ), "@RDX%016lld%012d", (long long) ctx->offset, ctx->nidx );
+	iov[0].iov_base = frame;
+	iov[0].iov_len = RDC_FRAME_SIZE;
+	iov[1].iov_base = entries;
+	iov[1].iov_len = ctx->nidx * RDC_FRAME_SIZE;
+	iov[2].iov_base = footer;
+	iov[2].iov_len = RDC_FRAME_SIZE;
+	if( rdc_pwritev( ctx->fd, iov, 3, ctx->offset ) < 0 ) {
+		rdc_werror( ctx, "index write" );
+	} else {
+		ctx->offset += (2 + ctx->nidx) * RDC_FRAME_SIZE;
+	}
+
+	free( entries );
+}
+
+/*
+	Close the currently open file and move it to it's final resting place in fdir.
+	If the done suffix in the context is not nil, then we touch a done file which
+	has the same basename with the done suffix; this is also placed into the final
+	dir. Called only by the writer thread; a move which must copy across
+	filesystems does not hold up the listener.
+*/
+static void rdc_finish( rdc_ctx_t* ctx ) {
+	char	target[2048];
+	char*	t_suffix;
+	int		fd;
+
+	if( ctx->fd < 0 ) {
+		return;
+	}
+
+	rdc_write_idx( ctx );
+	if( close( ctx->fd ) < 0 ) {
+		rdc_werror( ctx, "close" );
+	}
+	ctx->fd = -1;
+
+	t_suffix =  ctx->suffix != NULL  ? ctx->suffix : "";
+	snprintf( target, sizeof( target ), "%s/%s%s", ctx->fdir, ctx->basename, t_suffix );		// final target name
+	if( mvocp( ctx->openname, target ) < 0 ) {
+		logit( LOG_ERR, "(rdf) unable to move file '%s' to '%s': %s", ctx->openname, target, strerror( errno ) );
+	} else {
+		logit( LOG_INFO, "capture file closed and moved to: %s", target );
+		free( ctx->lastname );
+		ctx->lastname = strdup( target );
+		if( ctx->dsuffix != NULL ) {				// must also create a done file
+			snprintf( target, sizeof( target ), "%s/%s%s", ctx->fdir, ctx->basename, ctx->dsuffix );
+			if( (fd = open( target, O_CREAT, 0664 )) >= 0 ) {
+				close( fd );
+				logit( LOG_INFO, "created done file: %s", target );
+			} else {
+				logit( LOG_ERR, "unable to create done file: %s", target, strerror( errno ) );
+			}
+		}
+	}
+
+	free( ctx->basename );
+	free( ctx->openname );
+	ctx->basename = NULL;
+	ctx->openname = NULL;
+}
+
+/*
+	The writer thread. Takes blocks from the queue in order, opening and
+	rolling files as the period of the blocks changes, and returns them to
+	the free list.
+*/
+static void* rdc_writer( void* vctx ) {
+	rdc_ctx_t*	ctx;
+	rdc_blk_t*	blk;
+
+	ctx = (rdc_ctx_t *) vctx;
+
+	pthread_mutex_lock( &ctx->gate );
+	while( 1 ) {
+		while( ctx->qhead == NULL ) {
+			pthread_cond_wait( &ctx->wake, &ctx->gate );
+		}
+
+		blk = ctx->qhead;
+		if( (ctx->qhead = blk->next) == NULL ) {
+			ctx->qtail = NULL;
+		}
+		ctx->busy = 1;
+		pthread_mutex_unlock( &ctx->gate );
+
+		if( blk->kind == BLK_CLOSE ) {
+			rdc_finish( ctx );
+		} else {
+			if( ctx->fd >= 0 && blk->period != ctx->fperiod ) {
+				rdc_finish( ctx );						// roll
+			}
+			if( ctx->fd >= 0 || rdc_open( ctx, blk->period ) >= 0 ) {
+				rdc_write_blk( ctx, blk );
+			} else {
+				rdc_werror( ctx, "open" );
+			}
+		}
+
+		pthread_mutex_lock( &ctx->gate );
+		if( blk->kind != BLK_CLOSE ) {
+			blk->next = ctx->free_list;
+			ctx->free_list = blk;
+		}
+		ctx->busy = 0;
+		pthread_cond_broadcast( &ctx->done );
+	}
+
+	return NULL;
+}
+
+/*
+	Queue a block for the writer, starting the writer if it is not running.
+*/
+static void rdc_submit( rdc_ctx_t* ctx, rdc_blk_t* blk ) {
+	pthread_mutex_lock( &ctx->gate );
+	blk->next = NULL;
+	if( ctx->qtail != NULL ) {
+		ctx->qtail->next = blk;
+	} else {
+		ctx->qhead = blk;
+	}
+	ctx->qtail = blk;
+	pthread_cond_signal( &ctx->wake );
+	pthread_mutex_unlock( &ctx->gate );
+}
+
+/*
+	Get an empty block with room for at least need bytes. If all blocks
+	are queued the caller waits for the writer to finish one; memory is
+	bounded and the capture is not lossy. Returns nil if memory could not
+	be allocated.
+*/
+static rdc_blk_t* rdc_get_blk( rdc_ctx_t* ctx, size_t need ) {
+	rdc_blk_t*	blk = NULL;
+	void*	data;
+	size_t	cap;
+
+	pthread_mutex_lock( &ctx->gate );
+	while( ctx->free_list == NULL && ctx->nalloc >= NBLOCKS ) {
+		ctx->stalls++;
+		pthread_cond_wait( &ctx->done, &ctx->gate );
+	}
+	if( ctx->free_list != NULL ) {
+		blk = ctx->free_list;
+		ctx->free_list = blk->next;
+	} else {
+		if( (blk = (rdc_blk_t *) malloc( sizeof( *blk ) )) != NULL ) {
+			memset( blk, 0, sizeof( *blk ) );
+			ctx->nalloc++;
+		}
+	}
+	pthread_mutex_unlock( &ctx->gate );
+
+	if( blk == NULL ) {
+		return NULL;
+	}
+
+	if( blk->cap < need ) {									// new, or a record larger than a block
+		cap = need > ctx->bsize ? need : ctx->bsize;
+		cap = (cap + RDC_ALIGN - 1) & ~((size_t) RDC_ALIGN - 1);
+		if( posix_memalign( &data, RDC_ALIGN, cap ) != 0 ) {
+			pthread_mutex_lock( &ctx->gate );
+			blk->next = ctx->free_list;
+			ctx->free_list = blk;
+			pthread_mutex_unlock( &ctx->gate );
+			return NULL;
+		}
+		free( blk->data );
+		blk->data = (char *) data;
+		blk->cap = cap;
+	}
+
+	blk->len = 0;
+	blk->nrec = 0;
+	blk->kind = BLK_DATA;
+	blk->period = ctx->period;
+	blk->first = 0;
+
+	return blk;
+}
+
+/*
+	Hand the block being filled, if it has anything in it, to the writer.
+*/
+static void rdc_push( rdc_ctx_t* ctx ) {
+	if( ctx->cur != NULL && ctx->cur->nrec > 0 ) {
+		rdc_submit( ctx, ctx->cur );
+		ctx->cur = NULL;
+	}
+}
+
+/*
+	Start the writer thread if it's not running. Returns -1 on failure.
+*/
+static int rdc_start( rdc_ctx_t* ctx ) {
+	int		state;
+
+	if( ctx->running ) {
+		return 0;
+	}
+
+	if( (state = pthread_create( &ctx->writer, NULL, rdc_writer, ctx )) != 0 ) {
+		logit( LOG_ERR, "(rdc) unable to start the capture writer thread: %s", strerror( state ) );
+		return -1;
+	}
+	pthread_detach( ctx->writer );
+	ctx->running = 1;
+
+	return 0;
+}
+
 // ------------------ public things -------------------------------------------------------
 
 /*
@@ -332,8 +773,29 @@ extern void* rdc_init( const char* sdir, const char* fdir, const char* suffix, c
 		ctx->source = strdup( "" );
 	}
 
+	ctx->bsize = DEF_BLOCK;
+	if( (ep = getenv( "MCL_RDC_BLOCK" )) != NULL ) {
+		ctx->bsize = (size_t) atol( ep );
+		if( ctx->bsize < MIN_BLOCK ) {
+			ctx->bsize = MIN_BLOCK;
+		}
+	}
+
+	if( (ep = getenv( "MCL_RDC_COMPRESS" )) != NULL && atoi( ep ) != 0 ) {
+#ifdef RDC_ZLIB
+		ctx->compress = 1;
+#else
+		logit( LOG_WARN, "(rdc) compression requested (MCL_RDC_COMPRESS) but not built with zlib; blocks are written framed but not compressed" );
+		ctx->compress = 1;
+#endif
+	}
+
 	ctx->frequency = 300;			// default to 5 min roll
 	ctx->fd = -1;
+	ctx->cblk.kind = BLK_CLOSE;
+	pthread_mutex_init( &ctx->gate, NULL );
+	pthread_cond_init( &ctx->wake, NULL );
+	pthread_cond_init( &ctx->done, NULL );
 
 	return (void *) ctx;
 }
@@ -357,79 +819,109 @@ extern void rdc_set_freq( void* vctx, int freq ) {
 }
 
 /*
-	Close the currently open file and move it to it's final resting place in fdir.
-	If the done suffix in the context is not nil, then we touch a done file which
-	has the same basename with the done suffix; this is also placed into the final
-	dir.
+	Close the currently open file and move it to it's final resting place in fdir
+	(see rdc_finish()). Anything buffered is written first, and the caller waits
+	until the writer has finished; this is for shutdown. Rolling files as time
+	passes is done by the writer without waiting.
 */
 extern void rdc_close( void* vctx ) {
-	char	target[2048];
-	char*	t_suffix;
-	int		fd;
 	rdc_ctx_t* ctx;
 
 	ctx = (rdc_ctx_t *) vctx;
-	if( ctx == NULL || ctx->fd < 0 ) {
+	if( ctx == NULL || ! ctx->running ) {
 		return;
 	}
 
-	close( ctx->fd );		// future -- check for error
-	ctx->fd = -1;
+	rdc_push( ctx );
+	rdc_submit( ctx, &ctx->cblk );
 
-	t_suffix =  ctx->suffix != NULL  ? ctx->suffix : "";
-	snprintf( target, sizeof( target ), "%s/%s%s", ctx->fdir, ctx->basename, t_suffix );		// final target name
-	if( mvocp( ctx->openname, target ) < 0 ) {
-		logit( LOG_ERR, "(rdf) unable to move file '%s' to '%s': %s", ctx->openname, target, strerror( errno ) );
-	} else {
-		logit( LOG_INFO, "capture file closed and moved to: %s", target );
-		if( ctx->dsuffix != NULL ) {				// must also create a done file
-			snprintf( target, sizeof( target ), "%s/%s%s", ctx->fdir, ctx->basename, ctx->dsuffix );
-			if( (fd = open( target, O_CREAT, 0664 )) >= 0 ) {
-				close( fd );
-				logit( LOG_INFO, "created done file: %s", target );
-			} else {
-				logit( LOG_ERR, "unable to create done file: %s", target, strerror( errno ) );
-			}
-		}
+	pthread_mutex_lock( &ctx->gate );
+	while( ctx->qhead != NULL || ctx->busy ) {
+		pthread_cond_wait( &ctx->done, &ctx->gate );
 	}
+	pthread_mutex_unlock( &ctx->gate );
+}
 
-	free( ctx->basename );
-	free( ctx->openname );
-	ctx->basename = NULL;
-	ctx->openname = NULL;
+/*
+	Pass a partially filled block to the writer. The listener calls this when
+	it is idle so that records do not sit in memory waiting for more to arrive.
+*/
+extern void rdc_flush( void* vctx ) {
+	rdc_ctx_t* ctx;
+
+	if( (ctx = (rdc_ctx_t *) vctx) != NULL ) {
+		rdc_push( ctx );
+	}
 }
 
 /*
-	Writes the payload using the previously initialised capture buffer.
-	If it's time to roll the file, or the file isn't opened, the needed housekeeping
-	is done first.
+	Adds the record (header, the user header from the previously initialised
+	capture buffer, and the payload) to the current block; the block is given
+	to the writer when full, when the file period changes, or when it has been
+	waiting more than a couple of seconds for more. Returns 0 on success and -1
+	with errno set on failure. A failure of the writer (e.g. disk full) is
+	reported on the next call after it happens.
 */
 extern int rdc_write( void* vctx, void* vcb, const char* payload, int len ) {
 	const cap_buf_t* cb;
 	char	header[100];					// our header
 	rdc_ctx_t* ctx;
+	rdc_blk_t*	blk;
+	size_t	need;
+	time_t	now;
+	int		err;
 
 	cb = (cap_buf_t *) vcb;
 	ctx = (rdc_ctx_t *) vctx;
-	if( ctx == NULL || cb == NULL) {
+	if( ctx == NULL || cb == NULL || len < 0 ) {
 		errno = EINVAL;
 		return -1;
 	}
 
-	if( time( NULL ) >= ctx->next_roll ) {
-		rdc_close( ctx );					// close up the current one
+	if( rdc_start( ctx ) < 0 ) {
+		errno = EAGAIN;
+		return -1;
 	}
 
-	if( ctx->fd < 0 ) {
-		rdc_open( ctx );					// need a file, get it open
+	now = time( NULL );
+	if( now >= ctx->next_roll ) {						// records from here on go to the next file
+		rdc_push( ctx );
+		ctx->period = now - (now % ctx->frequency);		// round to previous frequency
+		ctx->next_roll = ctx->period + ctx->frequency;
+	}
+
+	need = RDC_HDR_SIZE + cb->uhlen + len;
+	if( (blk = ctx->cur) != NULL && (blk->len + need > blk->cap || now - blk->first >= MAX_AGE) ) {
+		rdc_push( ctx );
+		blk = NULL;
+	}
+	if( blk == NULL ) {
+		if( (blk = ctx->cur = rdc_get_blk( ctx, need )) == NULL ) {
+			errno = ENOMEM;
+			return -1;
+		}
+		blk->first = now;
 	}
 
 	snprintf( header, sizeof( header ), "@RDC%07d*%07d", cb->mtype, cb->uhlen + len );
-	write( ctx->fd, header, 20 );
-	write( ctx->fd, cb->uheader, cb->uhlen );
-	write( ctx->fd, payload, len );
+	memcpy( blk->data + blk->len, header, RDC_HDR_SIZE );
+	memcpy( blk->data + blk->len + RDC_HDR_SIZE, cb->uheader, cb->uhlen );
+	memcpy( blk->data + blk->len + RDC_HDR_SIZE + cb->uhlen, payload, len );
+	blk->len += need;
+	blk->nrec++;
+
+	if( ctx->last_err != 0 ) {							// unlocked peek; rarely set
+		pthread_mutex_lock( &ctx->gate );
+		err = ctx->last_err;
+		ctx->last_err = 0;
+		pthread_mutex_unlock( &ctx->gate );
+		if( err != 0 ) {
+			errno = err;
+			return -1;
+		}
+	}
 
-	return 0;		// future -- check and return error
+	return 0;
 }
 
 /*
@@ -459,6 +951,334 @@ extern void* rdc_init_buf( int mtype, const char* uheader, int uhlen, void* vcb
 	return (void *) cb;
 }
 
+// ------------------ reading ----------------------------------------------------------------
+
+/*
+	Reader state. Bytes read from the file are kept in buf; a block frame
+	is decoded into blk and records are returned from there until it is
+	used up.
+*/
+typedef struct {
+	int		fd;
+	char*	buf;			// bytes read from the file
+	size_t	bcap;
+	size_t	blen;			// bytes in buf
+	size_t	bpos;			// next unparsed byte in buf
+	char*	blk;			// current decoded block
+	size_t	kcap;
+	size_t	klen;
+	size_t	kpos;
+	long long	nrec;		// records returned so far
+} rdc_reader_t;
+
+/*
+	Convert a fixed width, unterminated, number.
+*/
+static long long fixed_num( const char* p, int width ) {
+	long long	v = 0;
+
+	while( width-- > 0 ) {
+		if( *p >= '0' && *p <= '9' ) {
+			v = (v * 10) + (*p - '0');
+		}
+		p++;
+	}
+
+	return v;
+}
+
+/*
+	Ensure that at least need bytes are buffered past bpos, reading more
+	as needed. Returns 0 if the file ends first.
+*/
+static int rdr_fill( rdc_reader_t* r, size_t need ) {
+	char*	nb;
+	ssize_t	rlen;
+
+	if( r->blen - r->bpos >= need ) {
+		return 1;
+	}
+
+	if( r->bpos > 0 ) {										// shift what's left to the front
+		memmove( r->buf, r->buf + r->bpos, r->blen - r->bpos );
+		r->blen -= r->bpos;
+		r->bpos = 0;
+	}
+
+	if( need > r->bcap ) {
+		if( (nb = (char *) realloc( r->buf, need + 4096 )) == NULL ) {
+			return 0;
+		}
+		r->buf = nb;
+		r->bcap = need + 4096;
+	}
+
+	while( r->blen < need ) {
+		if( (rlen = read( r->fd, r->buf + r->blen, r->bcap - r->blen )) < 0 ) {
+			if( errno == EINTR ) {
+				continue;
+			}
+			return 0;
+		}
+		if( rlen == 0 ) {
+			return 0;
+		}
+		r->blen += rlen;
+	}
+
+	return 1;
+}
+
+/*
+	Decode the block frame at the front of the buffer into the block buffer.
+	Returns -1 on error.
+*/
+static int rdr_decode( rdc_reader_t* r ) {
+	char*	p;
+	char*	nb;
+	size_t	raw;
+	size_t	slen;
+	int		codec;
+
+	p = r->buf + r->bpos;
+	codec = p[4];
+	raw = (size_t) fixed_num( p + 5, 10 );
+	slen = (size_t) fixed_num( p + 15, 10 );
+	if( ! rdr_fill( r, RDC_FRAME_SIZE + slen ) ) {
+		errno = EBADMSG;
+		return -1;
+	}
+	p = r->buf + r->bpos;
+
+	if( raw > r->kcap ) {
+		if( (nb = (char *) realloc( r->blk, raw )) == NULL ) {
+			return -1;
+		}
+		r->blk = nb;
+		r->kcap = raw;
+	}
+
+	switch( codec ) {
+		case 'n':
+			if( slen != raw ) {
+				errno = EBADMSG;
+				return -1;
+			}
+			memcpy( r->blk, p + RDC_FRAME_SIZE, raw );
+			break;
+
+#ifdef RDC_ZLIB
+		case 'z':
+			{
+				uLongf	zlen;
+
+				zlen = raw;
+				if( uncompress( (Bytef *) r->blk, &zlen, (Bytef *) p + RDC_FRAME_SIZE, slen ) != Z_OK || zlen != raw ) {
+					errno = EBADMSG;
+					return -1;
+				}
+			}
+			break;
+#endif
+
+		default:
+			errno = ENOTSUP;					// unknown codec, or not built with zlib
+			return -1;
+	}
+
+	r->bpos += RDC_FRAME_SIZE + slen;
+	r->klen = raw;
+	r->kpos = 0;
+
+	return 0;
+}
+
+/*
+	Create a reader for the already open capture file (or pipe). The file
+	may be either a plain record stream, or the block format. Returns nil
+	on error.
+*/
+extern void* rdc_reader( int fd ) {
+	rdc_reader_t*	r;
+
+	if( fd < 0 || (r = (rdc_reader_t *) malloc( sizeof( *r ) )) == NULL ) {
+		return NULL;
+	}
+	memset( r, 0, sizeof( *r ) );
+	r->fd = fd;
+
+	return (void *) r;
+}
+
+/*
+	Free the reader. The caller closes the file.
+*/
+extern void rdc_free_reader( void* vr ) {
+	rdc_reader_t*	r;
+
+	if( (r = (rdc_reader_t *) vr) != NULL ) {
+		free( r->buf );
+		free( r->blk );
+		free( r );
+	}
+}
+
+/*
+	Return the next record. Mtype is set, and data is pointed at the record
+	(what was written to the FIFO); it is valid until the next call. The length
+	is returned (records always carry the FIFO header so are never empty), 0 at
+	the end of the file, or -1 with errno set if the file is not recognised,
+	truncated, or damaged.
+*/
+extern int rdc_read_rec( void* vr, int* mtype, char** data ) {
+	rdc_reader_t*	r;
+	char*	p;
+	int		mlen;
+
+	if( (r = (rdc_reader_t *) vr) == NULL || mtype == NULL || data == NULL ) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	while( 1 ) {
+		if( r->kpos < r->klen ) {							// records from the current block
+			p = r->blk + r->kpos;
+			if( r->klen - r->kpos < RDC_HDR_SIZE || strncmp( p, RDC_DELIM, 4 ) != 0 ) {
+				errno = EBADMSG;
+				return -1;
+			}
+			*mtype = atoi( p+4 );
+			mlen = atoi( p+12 );
+			if( mlen < 0 || r->klen - r->kpos - RDC_HDR_SIZE < (size_t) mlen ) {
+				errno = EBADMSG;
+				return -1;
+			}
+			*data = p + RDC_HDR_SIZE;
+			r->kpos += RDC_HDR_SIZE + mlen;
+			r->nrec++;
+			return mlen;
+		}
+
+		if( ! rdr_fill( r, 4 ) ) {
+			if( r->blen > r->bpos ) {					// bytes left that cannot be a record
+				errno = EBADMSG;
+				return -1;
+			}
+			return 0;
+		}
+
+		p = r->buf + r->bpos;
+		if( strncmp( p, RDC_DELIM, 4 ) == 0 ) {				// plain record
+			if( ! rdr_fill( r, RDC_HDR_SIZE ) ) {
+				errno = EBADMSG;
+				return -1;
+			}
+			p = r->buf + r->bpos;
+			*mtype = atoi( p+4 );
+			mlen = atoi( p+12 );
+			if( mlen < 0 || ! rdr_fill( r, RDC_HDR_SIZE + mlen ) ) {
+				errno = EBADMSG;
+				return -1;
+			}
+			p = r->buf + r->bpos;
+			*data = p + RDC_HDR_SIZE;
+			r->bpos += RDC_HDR_SIZE + mlen;
+			r->nrec++;
+			return mlen;
+		}
+
+		if( ! rdr_fill( r, RDC_FRAME_SIZE ) ) {
+			errno = EBADMSG;
+			return -1;
+		}
+		p = r->buf + r->bpos;
+		if( strncmp( p, "@RDB", 4 ) == 0 ) {
+			if( rdr_decode( r ) < 0 ) {
+				return -1;
+			}
+		} else {
+			if( strncmp( p, "@RDI", 4 ) == 0 ) {			// index; only used when seeking
+				if( ! rdr_fill( r, RDC_FRAME_SIZE * (1 + fixed_num( p + 5, 10 )) ) ) {
+					errno = EBADMSG;
+					return -1;
+				}
+				p = r->buf + r->bpos;
+				r->bpos += RDC_FRAME_SIZE * (1 + fixed_num( p + 5, 10 ));
+			} else {
+				if( strncmp( p, "@RDX", 4 ) == 0 ) {		// footer
+					r->bpos += RDC_FRAME_SIZE;
+				} else {
+					errno = EBADMSG;
+					return -1;
+				}
+			}
+		}
+	}
+}
+
+/*
+	Position the reader so that the next record returned is record n (0 based).
+	If the file has a block index, the reader jumps to the block holding the
+	record; otherwise records are skipped. Returns 0 on success, -1 if the file
+	has fewer records (the reader is then at the end), or the file cannot be
+	repositioned.
+*/
+extern int rdc_seek_rec( void* vr, long long n ) {
+	rdc_reader_t*	r;
+	struct stat	sb;
+	char	frame[RDC_FRAME_SIZE];
+	char*	entries = NULL;
+	char*	data;
+	off_t	ioff;
+	long long	nblks;
+	long long	first;
+	long long	i;
+	int		mtype;
+
+	if( (r = (rdc_reader_t *) vr) == NULL || n < 0 ) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if( fstat( r->fd, &sb ) == 0 && S_ISREG( sb.st_mode ) && sb.st_size >= RDC_FRAME_SIZE * 3
+		&& pread( r->fd, frame, RDC_FRAME_SIZE, sb.st_size - RDC_FRAME_SIZE ) == RDC_FRAME_SIZE
+		&& strncmp( frame, "@RDX", 4 ) == 0 ) {
+
+		ioff = (off_t) fixed_num( frame + 4, 16 );
+		nblks = fixed_num( frame + 20, 12 );
+		if( nblks > 0 && ioff + (nblks + 2) * RDC_FRAME_SIZE == sb.st_size
+			&& (entries = (char *) malloc( nblks * RDC_FRAME_SIZE )) != NULL
+			&& pread( r->fd, entries, nblks * RDC_FRAME_SIZE, ioff + RDC_FRAME_SIZE ) == nblks * RDC_FRAME_SIZE ) {
+
+			for( i = nblks - 1; i > 0 && fixed_num( entries + (i * RDC_FRAME_SIZE) + 16, 16 ) > n; i-- );	// last block starting at or before n
+			first = fixed_num( entries + (i * RDC_FRAME_SIZE) + 16, 16 );
+			if( lseek( r->fd, (off_t) fixed_num( entries + (i * RDC_FRAME_SIZE), 16 ), SEEK_SET ) >= 0 ) {
+				r->blen = r->bpos = 0;
+				r->klen = r->kpos = 0;
+				r->nrec = first;
+			}
+		}
+		free( entries );
+	}
+
+	if( n < r->nrec ) {										// no index and already past it; start over
+		if( lseek( r->fd, 0, SEEK_SET ) < 0 ) {
+			return -1;
+		}
+		r->blen = r->bpos = 0;
+		r->klen = r->kpos = 0;
+		r->nrec = 0;
+	}
+
+	while( r->nrec < n ) {
+		if( rdc_read_rec( r, &mtype, &data ) <= 0 ) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
 #ifdef SELF_TEST
 /*
 	Run some quick checks which require the directories in /tmp to exist, and some
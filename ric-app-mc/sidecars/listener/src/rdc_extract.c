@@ -21,6 +21,9 @@
 				For capture mode, a file MT_<mtype> is created for the extracted
 				records.
 
+				Both the plain record stream and block framed (optionally
+				compressed) capture files are read; see rdc.c.
+
 	Date:		11 October 2019
 	Author:		E. Scott Daniels
 */
@@ -32,15 +35,15 @@
 #include <unistd.h>
 #include <string.h>
 
+#include "mcl.h"
+
 int main( int argc, char** argv ) {
-	char rbuf[1024 * 5];
 	int fd;
 	int wfd = 1;		// write file des; default to stdout
 	int mtype;
 	int mlen;
-	char*	nxt;
-	int	remain = 0;
-	int	need = 20;
+	char*	data;
+	void*	reader;
 	int desired;
 	int captured = 0;
 	int	wlen = 0;
@@ -59,61 +62,39 @@ int main( int argc, char** argv ) {
 	desired = atoi( argv[2] );
 
 	if( argc > 3 ) {
-		wfd = open( argv[4], O_WRONLY | O_CREAT | O_TRUNC, 0644 );
-	} 
-
-	remain = read( fd, rbuf, sizeof( rbuf ) );
-	nxt = rbuf;
-	while( remain > 0 ) {
-		if( remain < 20 ) {					// not enough stuff
-			memcpy( rbuf, nxt, remain );	// copy remaining up front
-			nxt = rbuf;
-			remain += read( fd, nxt + remain, sizeof( rbuf ) - remain );
-		}
-
-		if( remain < 20 ) {					// truncated or a record > rbuf
-			fprintf( stderr, "abort: @header check, truncated file, or record > read buffer size\n" );
+		if( (wfd = open( argv[3], O_WRONLY | O_CREAT | O_TRUNC, 0644 )) < 0 ) {
+			fprintf( stderr, "bad open: %s: %s\n", argv[3], strerror(errno) );
 			exit( 1 );
 		}
-	
-		if( strncmp( nxt, "@RDC", 4 ) == 0 ) {
-			mtype = atoi( nxt+4 );
-			mlen = atoi( nxt+12 );
-			nxt += 20;
-			remain -= 20;
-
-			if( remain < mlen ) {				// not enough stuff
-				memcpy( rbuf, nxt, remain );	// copy remaining up front
-				nxt = rbuf;
-				remain += read( fd, nxt + remain, sizeof( rbuf ) - remain );
-			}
+	}
 
-			if( remain < mlen ) {		// truncated or a record > rbuf
-				fprintf( stderr, "abort: truncated file, or record > read buffer size\n" );
-				exit( 1 );
-			}
-			
-			if( desired == 0 ) {				// just dump mtypes
-				captured++;
-				fprintf( stdout, "%d\n", mtype );
-			} else {
+	if( (reader = rdc_reader( fd )) == NULL ) {
+		fprintf( stderr, "abort: cannot allocate a reader: %s\n", strerror( errno ) );
+		exit( 1 );
+	}
 
-				if( mtype == desired ) {
-					wlen += mlen;
-					write( wfd, nxt, mlen );
-					captured++;
+	while( (mlen = rdc_read_rec( reader, &mtype, &data )) > 0 ) {
+		if( desired == 0 ) {				// just dump mtypes
+			captured++;
+			fprintf( stdout, "%d\n", mtype );
+		} else {
+			if( mtype == desired ) {
+				if( write( wfd, data, mlen ) != mlen ) {
+					fprintf( stderr, "abort: write to output failed: %s\n", strerror( errno ) );
+					exit( 1 );
 				}
+				wlen += mlen;
+				captured++;
 			}
-
-			nxt += mlen;
-			remain -= mlen;
-		} else {
-			fprintf( stderr, "didn't find rdc header!?! @ %ld\n", (long) (nxt - rbuf) );
-			exit( 1 );
 		}
 	}
 
+	if( mlen < 0 ) {
+		fprintf( stderr, "abort: truncated or damaged file, or not an rdc file: %s\n", strerror( errno ) );
+		exit( 1 );
+	}
+
 	fprintf( stderr, "done, captured %d messages (%d bytes)\n", captured, wlen );
+	rdc_free_reader( reader );
 	close( fd );
 }
-
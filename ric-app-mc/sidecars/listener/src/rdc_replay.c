@@ -21,6 +21,11 @@
 							:
 							:
 
+				Files written with block framing (MCL_RDC_COMPRESS) are also read;
+				see rdc.c. With -s the replay starts at the nth record (0 based);
+				the block index in such files is used to get there without
+				reading everything before it.
+
 				This is a very quick and dirty thing, so it might be flakey.
 
 				Parms from command line are file to read, and the msg type to extract.
@@ -49,16 +54,14 @@ static void invalid_arg( char* arg ) {
 }
 
 int main( int argc, char** argv ) {
-	char rbuf[1024 * 5];
 	int state;					// processing state
 	int fd;						// input file des
 	int mtype;					// msg type for current buffer
 	int mlen;					// len of raw data
-	char*	nxt;				// pointer at next bytes to process
-	int	remain = 0;				// number of bytes remaining to parse
-	int	need = 20;				// number of bytes needed before having enough to work with
+	char*	data;				// the raw data (what was written to the fifo)
+	void*	reader;				// capture file reader
 	int desired = -1;			// all mtypes; -t overrides and susses out one type
-	int	wlen = 0;
+	long long start = 0;		// first record to replay; -s overrides
 	void*	mcl_ctx;			// mcl library context
 	long	ok_count = 0;
 	long	err_count = 0;
@@ -95,6 +98,16 @@ int main( int argc, char** argv ) {
 				}
 				break;
 
+			case 's':
+				if( i < argc-1 ) {
+					start = atoll( argv[i+1] );
+					i++;
+				} else {
+					invalid_arg( arg );
+					err_count++;
+				}
+				break;
+
 			case 't':
 				if( i < argc-1 ) {
 					desired = atoi( argv[i+1] );
@@ -115,7 +128,7 @@ int main( int argc, char** argv ) {
 	}
 
 	if( err_count ) {
-		fprintf( stderr, "usage: %s [-d fifo-dir] [-f input-file] [-t msg-type]\n", argv[0] );
+		fprintf( stderr, "usage: %s [-d fifo-dir] [-f input-file] [-s start-record] [-t msg-type]\n", argv[0] );
 		fprintf( stderr, "if -f not given, then standard input is read\n" );
 		exit( 1 );
 	}
@@ -133,55 +146,34 @@ int main( int argc, char** argv ) {
 	mcl_ctx = mcl_mk_context( fifo_path );
 	mcl_set_sigh();							// ignore pipe related signals
 
-	remain = read( fd, rbuf, sizeof( rbuf ) );
-	nxt = rbuf;
-	while( remain > 0 ) {
-		if( remain < 20 ) {					// not enough stuff
-			memcpy( rbuf, nxt, remain );	// copy remaining up front
-			nxt = rbuf;
-			remain += read( fd, nxt + remain, sizeof( rbuf ) - remain );
-		}
-
-		if( remain < 20 ) {					// truncated or a record > rbuf
-			fprintf( stderr, "abort: @header check, truncated file, or record > read buffer size\n" );
-			exit( 1 );
-		}
-
-		if( strncmp( nxt, "@RDC", 4 ) == 0 ) {
-			mtype = atoi( nxt+4 );
-			mlen = atoi( nxt+12 );
-			nxt += 20;
-			remain -= 20;
-
-			if( remain < mlen ) {				// not enough stuff
-				memcpy( rbuf, nxt, remain );	// copy remaining up front
-				nxt = rbuf;
-				remain += read( fd, nxt + remain, sizeof( rbuf ) - remain );
-			}
+	if( (reader = rdc_reader( fd )) == NULL ) {
+		fprintf( stderr, "abort: cannot allocate a reader: %s\n", strerror( errno ) );
+		exit( 1 );
+	}
 
-			if( remain < mlen ) {				// truncated or a record > rbuf
-				fprintf( stderr, "abort: truncated file, or record > read buffer size\n" );
-				exit( 1 );
-			}
+	if( start > 0 && rdc_seek_rec( reader, start ) < 0 ) {
+		fprintf( stderr, "abort: cannot position to record %lld: file has fewer records, or is not seekable\n", start );
+		exit( 1 );
+	}
 
-			if( desired < 0 || mtype == desired ) {				// all mtypes, or specific
-				state = mcl_fifo_one( mcl_ctx, nxt, mlen, mtype );
-				if( state ) {
-					ok_count++;
-				} else {
-					err_count++;
-				}
+	while( (mlen = rdc_read_rec( reader, &mtype, &data )) > 0 ) {
+		if( desired < 0 || mtype == desired ) {				// all mtypes, or specific
+			state = mcl_fifo_one( mcl_ctx, data, mlen, mtype );
+			if( state ) {
+				ok_count++;
+			} else {
+				err_count++;
 			}
-
-			nxt += mlen;
-			remain -= mlen;
-		} else {
-			fprintf( stderr, "abort: didn't find rdc header!?! @ %ld\n", (long) (nxt - rbuf) );
-			exit( 1 );
 		}
 	}
 
+	if( mlen < 0 ) {
+		fprintf( stderr, "abort: truncated or damaged file, or not an rdc file: %s\n", strerror( errno ) );
+		exit( 1 );
+	}
+
 	fprintf( stderr, "done, captured %ld messages; %ld errors\n", ok_count, err_count );
+	rdc_free_reader( reader );
 	close( fd );
 }
 
@@ -0,0 +1,139 @@
+#!/usr/bin/env bash
+# vim: ts=4 sw=4 noet:
+#----------------------------------------------------------------------------------
+#
+#	Copyright (c) 2018-2019 AT&T Intellectual Property.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#	   http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+#---------------------------------------------------------------------------------
+
+
+# ----------------------------------------------------------------------
+# Mnemonic:	run_bench.sh
+# Abstract: Fanout benchmark. Starts a listener, pipe readers (stats
+#			only) for message types 1-6, and a sender which sends
+#			as fast as it can to types 1-8 (7 and 8 have no reader
+#			and are dropped). This is repeated for each batch size
+#			given (MCL_BATCH); a batch size of 1 is the old one
+#			message at a time behaviour. For each run the send rate,
+#			the rate seen by the readers, and the fifo write system
+#			calls per message reported by the listener are shown.
+#
+#			With -R the messages types 1-6 are written to shared
+#			memory rings (MCL_RING_TYPES) and the readers read the
+#			rings; run with and without -R to compare the transports.
+#			The syscalls/msg reported for a ring run is the number of
+#			reader wake-ups.
+#
+#			Like verify.sh, binaries are expected in /playpen/bin if
+#			it exists, otherwise in the current directory.
+#
+#			Usage: run_bench.sh [-b "batch-sizes"] [-f fifo-size] [-n msgs] [-R]
+#
+# Date:		18 October 2026
+# ----------------------------------------------------------------------
+
+# generate a dummy route table that the sender needs
+function gen_rt {
+	cat <<endKat >/tmp/local.rt
+	newrt|start
+	mse | 1 | -1 | localhost:4560
+	mse | 2 | -1 | localhost:4560
+	mse | 3 | -1 | localhost:4560
+	mse | 4 | -1 | localhost:4560
+	mse | 5 | -1 | localhost:4560
+	mse | 6 | -1 | localhost:4560
+	mse | 7 | -1 | localhost:4560
+	mse | 8 | -1 | localhost:4560
+	newrt|end
+endKat
+}
+
+# run one benchmark with the batch size in $1
+function run_one {
+	typeset prpids=""
+
+	MCL_BATCH=$1 $bin_dir/mc_listener -r 1 -d $fifo_dir >/tmp/bench_listen.log 2>&1 &
+	lpid=$!
+	sleep 2
+
+	for p in 1 2 3 4 5 6
+	do
+		$bin_dir/pipe_reader $ring_opt -s -m $p -d $fifo_dir >/tmp/bench_pr.$p.log 2>&1 &
+		prpids+="$! "
+	done
+	sleep 1
+
+	RMR_SEED_RT=/tmp/local.rt RMR_RTG_SVC=9989 $bin_dir/sender 43086 0 1 $nmsgs >/tmp/bench_sender.log 2>&1
+	sleep 3							# let the readers drain
+
+	kill -15 $prpids $lpid
+	wait >/dev/null 2>&1
+
+	printf "batch %4d%s  " $1 "${ring_opt:+ ring}"
+	grep "msgs/sec" /tmp/bench_sender.log | tail -1 | sed 's/^<SNDR> //'
+	for p in 1 2 3 4 5 6
+	do
+		printf "            reader %d: " $p
+		awk '/msgs\/sec/ { if( $(NF-1)+0 > best ) best = $(NF-1)+0; n = $2 } END { printf( "%d received, best %d msgs/sec\n", n, best ) }' /tmp/bench_pr.$p.log
+	done
+	printf "            listener: "
+	grep "syscalls/msg" /tmp/bench_listen.log | awk '
+		{
+			split( $NF, a, "=" )
+			if( a[2]+0 > 0 ) { sum += a[2]; n++ }
+		}
+		END { printf( "%.2f fifo syscalls/msg (mean of %d reports)\n", n ? sum/n : 0, n ) }'
+}
+
+# ---------------------------------------------------------------------------------
+
+batches="1 16 64 256"
+nmsgs=1000000
+ring_opt=""
+while [[ $1 == -* ]]
+do
+	case $1 in
+		-b)	batches="$2"; shift;;
+		-f)	export MCL_FIFO_SIZE=$2; shift;;
+		-n)	nmsgs=$2; shift;;
+		-R)	export MCL_RING_TYPES="1,2,3,4,5,6"
+			ring_opt="-R"
+			;;
+		*)	echo "$1 is not a recognised option"
+			echo "usage: $0 [-b \"batch-sizes\"] [-f fifo-size] [-n msgs] [-R]"
+			exit 1
+			;;
+	esac
+
+	shift
+done
+
+if [[ -d /playpen/bin ]]
+then
+	bin_dir=/playpen/bin
+else
+	bin_dir="."
+fi
+
+export MCL_RDC_ENABLE=0				# measure the fanout, not the capture
+fifo_dir=/tmp/bench_fifos
+mkdir -p $fifo_dir
+rm -f $fifo_dir/*.ring				# sizes may differ from the last run
+
+gen_rt
+for b in $batches
+do
+	run_one $b
+done
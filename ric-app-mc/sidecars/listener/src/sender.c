@@ -24,13 +24,17 @@
 				don't clog the queue.
 
 	Parms:		The following positional parameters are recognised on the command line:
-					[listen_port [delay [stats-freq] [msg-type]]]]
+					[listen_port [delay [msg-type [count]]]]
 
 					Defaults:
 						listen_port 43086
 						delay (mu-sec) 1000000 (1 sec)
-						stats-freq 10
 						msg-type 0
+						count 0 (forever)
+
+				When a count is given the sender is quiet, stops after sending that
+				many messages, and writes the send rate; with a delay of 0 this is
+				the load generator for run_bench.sh.
 
 	Date:		1 April 2019
 */
@@ -43,6 +47,7 @@
 #include <sys/epoll.h>
 #include <time.h>
 #include <signal.h>
+#include <sys/time.h>
 
 #include <rmr/rmr.h>
 
@@ -70,6 +75,10 @@ int main( int argc, char** argv ) {
 	int		delay = 1000000;						// mu-sec delay between messages
 	int		mtype = 0;
 	int		stats_freq = 100;
+	long	nmsgs = 0;								// number to send; 0 is forever
+	struct timeval	start;
+	struct timeval	end;
+	double	elapsed;
 
 	signal( SIGINT, sigh );
 	signal( SIGTERM, sigh );
@@ -83,6 +92,9 @@ int main( int argc, char** argv ) {
 	if( argc > 3 ) {
 		mtype = atoi( argv[3] );
 	}
+	if( argc > 4 ) {
+		nmsgs = atol( argv[4] );
+	}
 
 	fprintf( stderr, "<DEMO> listen port: %s; mtype: %d; delay: %d\n", listen_port, mtype, delay );
 
@@ -116,8 +128,8 @@ int main( int argc, char** argv ) {
 	}
 	fprintf( stderr, "<DEMO> rmr is ready\n" );
 
-
-	while( 1 ) {										// send messages until the cows come home
+	gettimeofday( &start, NULL );
+	while( nmsgs == 0 || count < nmsgs ) {				// send messages until the cows come home (or count reached)
 		snprintf( sbuf->payload, 200, "count=%d received= %d ts=%lld %d stand up and cheer!\n",		// create the payload
 			count, rcvd_count, (long long) time( NULL ), rand() );
 
@@ -129,13 +141,22 @@ int main( int argc, char** argv ) {
 			sbuf = rmr_send_msg( mrc, sbuf );			// retry send until it's good (simple test; real programmes should do better)
 		}
 		count++;
-		fprintf( stderr, "<SNDR> sent message type=%d\n", mtype );
+		if( nmsgs == 0 ) {
+			fprintf( stderr, "<SNDR> sent message type=%d\n", mtype );
+		}
 
-		usleep( delay );
+		if( delay > 0 ) {
+			usleep( delay );
+		}
 		mtype++;
 		if( mtype > 8 ) {			// ensure we send a mt that doesn't have a fifo reader to ensure we don't block
 			mtype = 1;
 		}
 	}
+
+	gettimeofday( &end, NULL );
+	elapsed = (double) (end.tv_sec - start.tv_sec) + ((double) (end.tv_usec - start.tv_usec) / 1000000.0);
+	fprintf( stderr, "<SNDR> sent %d messages in %.3fs  %.0f msgs/sec\n", count, elapsed, elapsed > 0 ? count / elapsed : 0.0 );
+	return 0;
 }
 
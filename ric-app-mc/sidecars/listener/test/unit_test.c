@@ -24,6 +24,7 @@
 	Author:		E. Scott Daniels
 */
 
+#define _GNU_SOURCE			// before any include, so that mcl.c gets F_GETPIPE_SZ/F_SETPIPE_SZ
 #define FOREVER 0			// allows forever loops in mcl code to escape after one loop
 
 #include <unistd.h>
@@ -56,6 +57,237 @@ static void set_env() {
 	setenv( "MCL_RDC_FREQ", "10", 1 );
 }
 
+/*
+	Fill a test payload for record i so that it can be verified when read back.
+*/
+static void fill_payload( char* buf, int i, int len ) {
+	int		j;
+
+	for( j = 0; j < len; j++ ) {
+		buf[j] = (char) ((i * 31) + j);
+	}
+}
+
+/*
+	Write records through the capture writer, with small blocks so that there
+	are many, close the file and read it back with the reader functions. With
+	compress set the block (framed) format is written. Returns the number of
+	errors.
+*/
+static int rdc_round_trip( int compress ) {
+	rdc_ctx_t*	rctx;
+	void*	cb = NULL;
+	void*	rdr;
+	char	uheader[32];
+	char	payload[16 * 1024];
+	char	first[4];
+	char*	data;
+	int		nrec = 2000;
+	int		errors = 0;
+	int		mtype;
+	int		len;
+	int		plen;
+	int		fd;
+	int		i;
+
+	setenv( "MCL_RDC_BLOCK", "4096", 1 );
+	setenv( "MCL_RDC_COMPRESS", compress ? "1" : "0", 1 );
+	rctx = (rdc_ctx_t *) rdc_init( "/tmp/mc_listener_test/stage", "/tmp/mc_listener_test/final", compress ? ".rtz" : ".rt", NULL );
+	unsetenv( "MCL_RDC_BLOCK" );
+	unsetenv( "MCL_RDC_COMPRESS" );
+	if( rctx == NULL ) {
+		fprintf( stderr, "[FAIL] round trip: rdc_init did not return a context\n" );
+		return 1;
+	}
+	rdc_set_freq( rctx, 86400 );
+
+	for( i = 0; i < nrec; i++ ) {
+		plen = i == 1000 ? 10000 : 1 + ((i * 37) % 900);			// one record larger than a block
+		snprintf( uheader, sizeof( uheader ), "%07d", plen );
+		fill_payload( payload, i, plen );
+		cb = rdc_init_buf( 100 + (i % 7), uheader, MCL_LEN_SIZE, cb );
+		if( rdc_write( rctx, cb, payload, plen ) != 0 ) {
+			fprintf( stderr, "[FAIL] round trip: rdc_write failed for record %d: %s\n", i, strerror( errno ) );
+			errors++;
+			break;
+		}
+	}
+	rdc_close( rctx );
+	free( cb );
+
+	if( rctx->lastname == NULL || (fd = open( rctx->lastname, O_RDONLY )) < 0 ) {
+		fprintf( stderr, "[FAIL] round trip: capture file was not closed and moved\n" );
+		return errors + 1;
+	}
+
+	if( pread( fd, first, 4, 0 ) != 4 || strncmp( first, compress ? "@RDB" : "@RDC", 4 ) != 0 ) {		// read() is the short read emulation
+		fprintf( stderr, "[FAIL] round trip: capture file does not start with the expected delimiter (compress=%d)\n", compress );
+		errors++;
+	}
+
+	rdr = rdc_reader( fd );
+	for( i = 0; (len = rdc_read_rec( rdr, &mtype, &data )) > 0; i++ ) {
+		plen = i == 1000 ? 10000 : 1 + ((i * 37) % 900);
+		fill_payload( payload, i, plen );
+		if( mtype != 100 + (i % 7) || len != MCL_LEN_SIZE + plen || atoi( data ) != plen || memcmp( data + MCL_LEN_SIZE, payload, plen ) != 0 ) {
+			fprintf( stderr, "[FAIL] round trip: record %d read back does not match (mtype=%d len=%d)\n", i, mtype, len );
+			errors++;
+			break;
+		}
+	}
+	if( len < 0 || i != nrec ) {
+		fprintf( stderr, "[FAIL] round trip: read back %d records, expected %d; last state %d\n", i, nrec, len );
+		errors++;
+	}
+
+	if( rdc_seek_rec( rdr, 1234 ) != 0 || rdc_read_rec( rdr, &mtype, &data ) <= 0 || mtype != 100 + (1234 % 7) ) {
+		fprintf( stderr, "[FAIL] round trip: seek to record 1234 did not position the reader\n" );
+		errors++;
+	}
+	if( rdc_seek_rec( rdr, 10 ) != 0 || rdc_read_rec( rdr, &mtype, &data ) <= 0 || mtype != 100 + (10 % 7) || atoi( data ) != 1 + ((10 * 37) % 900) ) {
+		fprintf( stderr, "[FAIL] round trip: seek back to record 10 did not position the reader\n" );
+		errors++;
+	}
+	if( rdc_seek_rec( rdr, nrec + 1 ) == 0 ) {
+		fprintf( stderr, "[FAIL] round trip: seek past the last record did not fail\n" );
+		errors++;
+	}
+
+	rdc_free_reader( rdr );
+	close( fd );
+	unlink( rctx->lastname );
+
+	return errors;
+}
+
+/*
+	Write to a small shared memory ring through the library (suss_fifo(),
+	ring_writev() and mcl_fifo_one()) and read it back as a reader would.
+	The ring is small enough that records wrap, and that it fills and
+	drops. Returns the number of errors.
+*/
+static int ring_test( char* dname ) {
+	mcl_ctx_t*	rctx;
+	fifo_t*	rref = NULL;
+	mclr_t*	rdr;
+	struct iovec iov[8];
+	char	path[1024];
+	char	payload[1024];
+	char*	data;
+	uint64_t ts;
+	long	nok;
+	long	ndrops;
+	int		errors = 0;
+	int		mtype;
+	int		len;
+	int		fd;
+	int		i;
+	int		j;
+
+	setenv( "MCL_RING_TYPES", "1003, 1004", 1 );
+	setenv( "MCL_RING_SIZE", "100", 1 );						// rounded up to the minimum
+	rctx = (mcl_ctx_t *) mcl_mk_context( dname );
+	unsetenv( "MCL_RING_TYPES" );
+	unsetenv( "MCL_RING_SIZE" );
+	if( rctx == NULL ) {
+		fprintf( stderr, "[FAIL] ring: unable to make context\n" );
+		return 1;
+	}
+
+	if( ring_wanted( rctx, TEST_MTYPE+2 ) || ! ring_wanted( rctx, TEST_MTYPE+4 ) ) {
+		fprintf( stderr, "[FAIL] ring: type list not parsed correctly\n" );
+		errors++;
+	}
+
+	snprintf( path, sizeof( path ), "%s/MT_%09d.ring", dname, TEST_MTYPE+3 );
+	unlink( path );
+	if( (rdr = mclr_open( path, 0, 0 )) != NULL ) {
+		fprintf( stderr, "[FAIL] ring: reader opened a ring which does not exist\n" );
+		errors++;
+	}
+
+	fd = suss_fifo( rctx, TEST_MTYPE+3, WRITER, &rref );
+	if( fd < 0 || rref == NULL || rref->ring == NULL ) {
+		fprintf( stderr, "[FAIL] ring: writer did not create the ring\n" );
+		return errors + 1;
+	}
+	if( (rdr = mclr_open( path, 0, 0 )) == NULL || rdr->mask + 1 != MCLR_MIN_SIZE ) {
+		fprintf( stderr, "[FAIL] ring: reader could not open the ring, or size is wrong\n" );
+		return errors + 1;
+	}
+
+	if( mclr_wait( rdr, 10 ) ) {
+		fprintf( stderr, "[FAIL] ring: wait on an empty ring did not time out\n" );
+		errors++;
+	}
+
+	for( j = 0; j < 20; j++ ) {									// 3 x ~300 bytes per pass; wraps several times
+		for( i = 0; i < 3; i++ ) {
+			fill_payload( payload + (i * 300), (j * 3) + i, 290 + i );
+			iov[(i*2)+1].iov_base = payload + (i * 300);
+			iov[(i*2)+1].iov_len = 290 + i;
+		}
+		nok = ndrops = 0;
+		ring_writev( rctx, rref, iov, TEST_MTYPE+3, 3, &nok, &ndrops );
+		if( nok != 3 || ndrops != 0 ) {
+			fprintf( stderr, "[FAIL] ring: pass %d expected 3/0 ok/drops, got %ld/%ld\n", j, nok, ndrops );
+			errors++;
+			break;
+		}
+
+		for( i = 0; i < 3; i++ ) {
+			len = mclr_next( rdr, &mtype, &ts, &data );
+			fill_payload( path, (j * 3) + i, 290 + i );
+			if( len != 290 + i || mtype != TEST_MTYPE+3 || ts == 0 || memcmp( data, path, len ) != 0 ) {
+				fprintf( stderr, "[FAIL] ring: pass %d record %d read back does not match (len=%d mtype=%d)\n", j, i, len, mtype );
+				errors++;
+				break;
+			}
+			mclr_release( rdr );
+		}
+	}
+	if( mclr_next( rdr, NULL, NULL, &data ) != 0 ) {
+		fprintf( stderr, "[FAIL] ring: ring not empty after all records were read\n" );
+		errors++;
+	}
+
+	nok = ndrops = 0;
+	for( i = 0; i < 20; i++ ) {									// reader does nothing; ring fills and the rest drop
+		if( mcl_fifo_one( rctx, payload, 290, TEST_MTYPE+3 ) ) {
+			nok++;
+		} else {
+			ndrops++;
+		}
+	}
+	if( nok == 0 || ndrops == 0 || rdr->hdr->drops != (uint64_t) ndrops ) {
+		fprintf( stderr, "[FAIL] ring: full ring did not drop (ok=%ld drops=%ld)\n", nok, ndrops );
+		errors++;
+	}
+	for( i = 0; mclr_next( rdr, NULL, NULL, &data ) == 290; i++ ) {
+		mclr_release( rdr );
+	}
+	if( i != nok ) {
+		fprintf( stderr, "[FAIL] ring: read %d records from the full ring, expected %ld\n", i, nok );
+		errors++;
+	}
+
+	if( ! mcl_fifo_one( rctx, payload, 290, TEST_MTYPE+3 ) || ! mclr_wait( rdr, 10 ) ) {
+		fprintf( stderr, "[FAIL] ring: write to a drained ring was not seen by the reader\n" );
+		errors++;
+	}
+
+	close_fifo( rctx, TEST_MTYPE+3, WRITER );
+	if( rref->ring != NULL || rref->fd >= 0 ) {
+		fprintf( stderr, "[FAIL] ring: close did not release the ring\n" );
+		errors++;
+	}
+	mclr_close( rdr );
+	snprintf( path, sizeof( path ), "%s/MT_%09d.ring", dname, TEST_MTYPE+3 );
+	unlink( path );
+
+	return errors;
+}
+
 /*
 	Parms:	[fifo-dir-name]
 */
@@ -84,6 +316,7 @@ int main( int argc,  char** argv ) {
 	setup_rdc( );
 
 	set_env();							// set env that setup_rdc() looks for
+	setenv( "MCL_FIFO_SIZE", "262144", 1 );		// fifos opened for writing are resized
 
 	ctx = mcl_mk_context( dname );			// allocate the context
 	if( ctx == NULL ) {
@@ -112,6 +345,10 @@ int main( int argc,  char** argv ) {
 	} else {
 		chalk_ok( fref );
 		chalk_error( fref );
+		if( fref->cap != 262144 ) {
+			fprintf( stderr, "[FAIL] fifo capacity expected to be 262144 (MCL_FIFO_SIZE), was %d\n", fref->cap );
+			errors++;
+		}
 	}
 
 	fd2= suss_fifo( ctx, TEST_MTYPE, 0, NULL );				// should open the file file for reading and return a different fd
@@ -159,6 +396,72 @@ int main( int argc,  char** argv ) {
 	mcl_fifo_fanout( ctx, 5, 0 );					// test with writing short header
 	mcl_fifo_fanout( ctx, 5, 0 );
 
+	// ------ batched (writev) fifo writes --------------------------
+	{
+		struct iovec	iov[6];
+		char	hdrs[3][HDR_SLOT];
+		char*	msgs[3] = { "batch one", "batch two is longer", "batch three" };
+		fifo_t*	bref = NULL;
+		long	nok = 0;
+		long	ndrops = 0;
+		long	nerrs = 0;
+		long long wc;
+		int		i;
+		int		j;
+
+		open_fifo( ctx, TEST_MTYPE+1, WRITER );					// dummy so the reader open won't block
+		suss_fifo( ctx, TEST_MTYPE+1, WRITER, &bref );
+		suss_fifo( ctx, TEST_MTYPE+1, READER, NULL );
+		if( bref == NULL || bref->cap <= 0 ) {
+			fprintf( stderr, "[FAIL] writer fifo for batch test not opened, or capacity not set\n" );
+			errors++;
+		} else {
+			for( j = 0; j < 2; j++ ) {							// second pass with a tiny capacity: one message per writev
+				for( i = 0; i < 3; i++ ) {
+					build_hdr( strlen( msgs[i] ), hdrs[i], HDR_SLOT );
+					iov[i*2].iov_base = hdrs[i];
+					iov[i*2].iov_len = MCL_EXHDR_SIZE;
+					iov[(i*2)+1].iov_base = msgs[i];
+					iov[(i*2)+1].iov_len = strlen( msgs[i] );
+				}
+
+				wc = ((mcl_ctx_t *) ctx)->wcalls;
+				nok = ndrops = nerrs = 0;
+				fifo_writev( ctx, bref, TEST_MTYPE+1, iov, 3, &nok, &ndrops, &nerrs );
+				if( nok != 3 || ndrops != 0 || nerrs != 0 ) {
+					fprintf( stderr, "[FAIL] batch write expected 3/0/0 ok/drops/errs got %ld/%ld/%ld\n", nok, ndrops, nerrs );
+					errors++;
+				}
+				if( ((mcl_ctx_t *) ctx)->wcalls - wc != (j == 0 ? 1 : 3) ) {
+					fprintf( stderr, "[FAIL] batch write pass %d expected %d write calls, got %lld\n", j, j == 0 ? 1 : 3, ((mcl_ctx_t *) ctx)->wcalls - wc );
+					errors++;
+				}
+
+				for( i = 0; i < 3; i++ ) {
+					memset( payload, 0, sizeof( payload ) );
+					state = mcl_fifo_read1( ctx, TEST_MTYPE+1, payload, sizeof( payload ), TRUE );
+					if( state != (int) strlen( msgs[i] ) || strcmp( payload, msgs[i] ) != 0 ) {
+						fprintf( stderr, "[FAIL] batch read %d expected (%s) got (%s)\n", i, msgs[i], payload );
+						errors++;
+					}
+				}
+
+				bref->cap = 40;
+			}
+		}
+
+		bref = NULL;
+		suss_fifo( ctx, TEST_MTYPE+2, WRITER, &bref );			// no reader; everything must be dropped
+		if( bref != NULL ) {
+			nok = ndrops = nerrs = 0;
+			fifo_writev( ctx, bref, TEST_MTYPE+2, iov, 3, &nok, &ndrops, &nerrs );
+			if( nok != 0 || ndrops != 3 || bref->drops != 3 ) {
+				fprintf( stderr, "[FAIL] batch write without a reader expected 3 drops, got ok=%ld drops=%ld\n", nok, ndrops );
+				errors++;
+			}
+		}
+	}
+
 	// ------ some error/coverage testing ---------------------------
 	logit( LOG_CRIT, "critical message" );
 	logit( LOG_ERR, "error message" );
@@ -253,6 +556,14 @@ int main( int argc,  char** argv ) {
 	rdc_write( ctx, bp, payload, sizeof( payload ) );
 
 
+	// ---- capture writer and reader round trip, both formats ----
+	errors += rdc_round_trip( 0 );
+	errors += rdc_round_trip( 1 );
+
+	// ---- shared memory ring in place of a fifo ----
+	errors += ring_test( dname );
+
+
 	// CAUTION:  filenames need to match those expected in the run script as it creates src, and will validate, destination files
 	state = copy_unlink( "/tmp/mc_listener_test/no-such-copy_src", "/tmp/mc_listener_test/copy_dest", 0664 );  // first couple drive for error and coverage
 	if( state >= 0 ) {
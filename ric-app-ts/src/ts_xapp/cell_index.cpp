@@ -0,0 +1,454 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+    Mnemonic:	cell_index.cpp
+    Abstract:	Implements the cell to nodeb index.
+
+                A refresh fetches the nodeb list from E2 Manager. If it is
+                the same as the last one applied nothing else is done;
+                otherwise only the nodebs that are new, or whose connection
+                status changed, are fetched again, and those no longer
+                listed are dropped. Every resync-th refresh fetches all of
+                them regardless. A new snapshot is published only when
+                something was fetched or dropped.
+
+                Refreshes run on their own thread every refresh_secs, or
+                sooner when request_refresh() is called (e.g. on a lookup
+                of an unknown cell). An early refresh fetches every nodeb
+                again, and early refreshes are at least
+                max(1, refresh_secs/10) seconds apart.
+
+    Date:       19 October 2026
+*/
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+
+#include <rapidjson/reader.h>
+
+#include "cell_index.hpp"
+
+using namespace std;
+using namespace rapidjson;
+
+namespace cells {
+
+//https://stackoverflow.com/a/34571089/15098882
+
+static std::string base64_decode(const std::string &in) {
+
+	std::string out;
+
+	std::vector<int> T(256, -1);
+	for (int i = 0; i < 64; i++) T["ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i]] = i;
+
+	int val = 0, valb = -8;
+	for (unsigned char c : in) {
+		if (T[c] == -1) break;
+		val = (val << 6) + T[c];
+		valb += 6;
+		if (valb >= 0) {
+			out.push_back(char((val >> valb) & 0xFF));
+			valb -= 8;
+		}
+	}
+	return out;
+}
+
+/*
+	Parses the nodeb list, e.g.
+		[{"inventoryName":"gnb_734_733_b5c67788","globalNbId":{...},"connectionStatus":"CONNECTED"}]
+*/
+struct NodebListHandler : public BaseReaderHandler<UTF8<>, NodebListHandler> {
+	vector<pair<string, string>> nodeb_list;	// name and connection status
+	string curr_key = "";
+
+	bool Key(const Ch* str, SizeType length, bool copy) {
+		curr_key.assign( str, length );
+		return true;
+	}
+
+	bool String(const Ch* str, SizeType length, bool copy) {
+		if( curr_key.compare( "inventoryName" ) == 0 ) {
+			nodeb_list.emplace_back( string( str, length ), "" );
+		} else if( curr_key.compare( "connectionStatus" ) == 0 && !nodeb_list.empty() ) {
+			nodeb_list.back().second.assign( str, length );
+		}
+		return true;
+	}
+};
+
+struct NodebHandler : public BaseReaderHandler<UTF8<>, NodebHandler> {
+	string curr_key = "";
+	shared_ptr<nodeb_t> nodeb = make_shared<nodeb_t>();
+	std::string meid;
+	std::vector<string> cells;
+
+	bool Key(const Ch* str, SizeType length, bool copy) {
+		curr_key = str;
+		return true;
+	}
+
+	bool String(const Ch* str, SizeType length, bool copy) {
+
+		if (curr_key.compare("ranName") == 0) {
+			nodeb->ran_name = str;
+			meid= str;
+		}
+		else if (curr_key.compare("plmnId") == 0) {
+			nodeb->global_nb_id.plmn_id = str;
+		}
+		else if (curr_key.compare("nbId") == 0) {
+			nodeb->global_nb_id.nb_id = str;
+		}
+		else if (curr_key.compare("e2nodeComponentRequestPart") == 0) {
+			auto message = base64_decode(str);
+			int len = meid.length();
+			int counter = 0;
+				for (int i = 0; i <len; i++ ){
+					if (meid[i] == '_') {
+						counter++;
+					}
+					if( counter == 3) {
+						counter = i + 1;
+						break;
+					}
+				}
+				std::string last_matching_bits = meid.substr(counter, meid.length());
+				len = last_matching_bits.size();
+				char b;
+
+				for (int i = 0; i < len; i++) {
+					b = last_matching_bits[i];
+					b = toupper(b);
+					last_matching_bits[i] = b;
+				}
+				len = message.length();
+				int matching_len = last_matching_bits.length();;
+
+					for (int i = 0; i <= len - matching_len; i++ ){
+
+						if (message.substr(i,matching_len)== last_matching_bits){
+							cells.push_back(message.substr(i,10));//cell id is 36 bit long , last  4 bit unused
+
+						}
+					}
+
+		}
+		return true;
+	}
+
+};
+
+/*
+	The index is empty until the first refresh; base_url is E2 Manager's
+	scheme://domain[:port].
+*/
+CellIndex::CellIndex( string base_url, int refresh_secs, int resync ) :
+	base_url( base_url ),
+	refresh_secs( refresh_secs > 0 ? refresh_secs : 30 ),
+	resync( resync > 0 ? resync : 1 ),
+	current( make_shared<const snapshot>() )
+{ }
+
+CellIndex::~CellIndex( ) {
+	stop();
+}
+
+shared_ptr<const CellIndex::snapshot> CellIndex::get_snapshot( ) const {
+	return atomic_load( &current );
+}
+
+/*
+	Fetches the details of a nodeb into ns. Returns false, leaving ns
+	as it was, if they cannot be had.
+*/
+bool CellIndex::fetch_nodeb( const string &name, node_state &ns ) {
+	string full_path = string("/v1/nodeb/") + name;
+
+	counts.node_fetches++;
+	restclient::response_t response = client->do_get( full_path );
+	if( response.status_code != 200 ) {
+		if( response.body.empty() ) {
+			cout << "[ERROR] Unexpected HTTP code " << response.status_code << " from " << \
+					client->getBaseUrl() + full_path << endl;
+		} else {
+			cout << "[ERROR] Unexpected HTTP code " << response.status_code << " from " << \
+					client->getBaseUrl() + full_path << ". HTTP payload is " << response.body.c_str() << endl;
+		}
+		return false;
+	}
+
+	NodebHandler handler;
+	Reader reader;
+	StringStream ss( response.body.c_str() );
+	if( reader.Parse( ss, handler ).IsError() ) {
+		cout << "[ERROR] unable to parse nodeb " << name << ", error " << reader.GetParseErrorCode() << endl;
+		return false;
+	}
+
+	ns.nodeb = handler.nodeb;
+	ns.cells = std::move( handler.cells );
+
+	return true;
+}
+
+/*
+	Builds a snapshot from the nodebs and makes it the current one. Cells
+	keep the ids they had; new ones are given the next.
+*/
+void CellIndex::publish( ) {
+	shared_ptr<const snapshot> old = get_snapshot();
+	shared_ptr<snapshot> next = make_shared<snapshot>();
+
+	next->ids = old->ids;
+	next->by_id.assign( old->by_id.size(), nullptr );
+	next->generation = old->generation + 1;
+
+	for( auto &n : nodes ) {
+		for( const string &cell : n.second.cells ) {
+			auto id = next->ids.emplace( cell, (cell_id_t) next->ids.size() );
+			if( id.second ) {
+				next->by_id.push_back( nullptr );
+			}
+			if( next->by_id[id.first->second] == nullptr ) {
+				next->n_cells++;
+			}
+			next->by_id[id.first->second] = n.second.nodeb;
+		}
+	}
+
+	atomic_store( &current, shared_ptr<const snapshot>( next ) );
+	counts.swaps++;
+}
+
+/*
+	One refresh pass. Returns false if E2 Manager could not be reached or
+	some nodeb could not be fetched; what could be fetched is published and
+	the rest is tried again on the next pass.
+
+	Only the nodebs that were added or changed their connection status are
+	fetched, unless full is set (or the pass is a resync one): cells added
+	to a nodeb that stayed connected (an E2 configuration update) leave the
+	list as it was and are only seen by a full pass.
+*/
+bool CellIndex::refresh( bool full ) {
+	const lock_guard<mutex> lock( refresh_mtx );
+	bool all = true;
+	bool changed = false;
+
+	counts.refreshes++;
+	full = full || counts.refreshes % resync == 0;
+
+	try {
+		if( !client ) {
+			client.reset( new restclient::RestClient( base_url ) );
+		}
+
+		counts.list_fetches++;
+		restclient::response_t response = client->do_get( "/v1/nodeb/states" );
+		if( response.status_code != 200 ) {
+			if( response.body.empty() ) {
+				cout << "[ERROR] Unexpected HTTP code " << response.status_code << " from " << client->getBaseUrl() << endl;
+			} else {
+				cout << "[ERROR] Unexpected HTTP code " << response.status_code << " from " << client->getBaseUrl() <<
+						". HTTP payload is " << response.body.c_str() << endl;
+			}
+			counts.errors++;
+			return false;
+		}
+
+		if( !full && response.body == last_list ) {
+			counts.unchanged++;
+			return true;
+		}
+
+		NodebListHandler handler;
+		Reader reader;
+		StringStream ss( response.body.c_str() );
+		if( reader.Parse( ss, handler ).IsError() ) {
+			cout << "[ERROR] unable to parse the nodeb list, error " << reader.GetParseErrorCode() << endl;
+			counts.errors++;
+			return false;
+		}
+
+		unordered_map<string, node_state> listed;
+		for( auto &nb : handler.nodeb_list ) {
+			auto known = nodes.find( nb.first );
+			if( !full && known != nodes.end() && known->second.status == nb.second ) {
+				listed[nb.first] = std::move( known->second );
+				continue;
+			}
+
+			node_state ns;
+			if( fetch_nodeb( nb.first, ns ) ) {
+				ns.status = nb.second;
+				listed[nb.first] = std::move( ns );
+				changed = true;
+			} else {
+				all = false;
+				if( known != nodes.end() ) {		// keep what we had; the list is not marked applied, so it is tried again
+					listed[nb.first] = std::move( known->second );
+				}
+			}
+		}
+		if( listed.size() != nodes.size() ) {
+			changed = true;						// some were dropped (or added, already counted)
+		}
+		nodes = std::move( listed );
+
+		if( all ) {
+			last_list = std::move( response.body );
+		} else {
+			last_list.clear();
+			counts.errors++;
+		}
+
+	} catch( const restclient::RestClientException &e ) {
+		cout << "[ERROR] " << e.what() << endl;
+		counts.errors++;
+		return false;
+	}
+
+	if( changed ) {
+		publish();
+		cout << "[INFO] cell index updated, " << nodes.size() << " nodebs, " << size() << " cells" << endl;
+	}
+
+	return all;
+}
+
+/*
+	Refreshes every refresh_secs. A refresh asked for by request_refresh()
+	comes sooner and is a full one, as the cell that was looked up may
+	be new on a nodeb whose state did not change; as every lookup of an
+	unknown cell asks for one, they are kept apart by min_gap.
+*/
+void CellIndex::refresh_loop( ) {
+	auto min_gap = chrono::seconds( max( 1, refresh_secs / 10 ) );
+	auto last = chrono::steady_clock::now() - min_gap;
+
+	while( true ) {
+		bool full = false;
+		{
+			unique_lock<mutex> lock( wake_mtx );
+			wake.wait_until( lock, last + chrono::seconds( refresh_secs ), [this] { return !running || early; } );
+			if( !running ) {
+				return;
+			}
+			if( early ) {
+				if( chrono::steady_clock::now() - last < min_gap ) {	// too soon, wait out the gap
+					wake.wait_until( lock, last + min_gap, [this] { return !running; } );
+					if( !running ) {
+						return;
+					}
+				}
+				early = false;
+				full = true;
+			}
+		}
+
+		last = chrono::steady_clock::now();
+		refresh( full );
+	}
+}
+
+/*
+	Starts refreshing in the background. The first refresh is done by
+	the caller, if it wants the index filled before going on.
+*/
+void CellIndex::start( ) {
+	const lock_guard<mutex> lock( wake_mtx );
+
+	if( running ) {
+		return;
+	}
+	running = true;
+	refresher = thread( &CellIndex::refresh_loop, this );
+}
+
+void CellIndex::stop( ) {
+	{
+		const lock_guard<mutex> lock( wake_mtx );
+		running = false;
+	}
+	wake.notify_all();
+
+	if( refresher.joinable() ) {
+		refresher.join();
+	}
+}
+
+/*
+	Asks the refresher for a full refresh before the next one is due.
+*/
+void CellIndex::request_refresh( ) {
+	{
+		const lock_guard<mutex> lock( wake_mtx );
+		early = true;
+	}
+	wake.notify_all();
+}
+
+/*
+	Returns the interned id of a cell, or NO_CELL if it was never seen.
+*/
+cell_id_t CellIndex::get_id( const string &cell_id ) const {
+	shared_ptr<const snapshot> s = get_snapshot();
+
+	auto id = s->ids.find( cell_id );
+	return id == s->ids.end() ? NO_CELL : id->second;
+}
+
+/*
+	Returns the nodeb serving a cell, or nil if none does.
+*/
+shared_ptr<const nodeb_t> CellIndex::find( cell_id_t id ) const {
+	shared_ptr<const snapshot> s = get_snapshot();
+
+	return id < s->by_id.size() ? s->by_id[id] : nullptr;
+}
+
+shared_ptr<const nodeb_t> CellIndex::find( const string &cell_id ) const {
+	shared_ptr<const snapshot> s = get_snapshot();
+
+	auto id = s->ids.find( cell_id );
+	return id == s->ids.end() ? nullptr : s->by_id[id->second];
+}
+
+size_t CellIndex::size( ) const {
+	return get_snapshot()->n_cells;
+}
+
+unsigned long CellIndex::get_generation( ) const {
+	return get_snapshot()->generation;
+}
+
+index_stats_t CellIndex::get_stats( ) {
+	const lock_guard<mutex> lock( refresh_mtx );
+
+	return counts;
+}
+
+} // namespace
@@ -0,0 +1,131 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+    Mnemonic:	cell_index.hpp
+    Abstract:	Header for the index of cells to the nodeb (E2 node) serving
+                them, built from E2 Manager and kept up to date by a
+                refresher thread. Readers get an immutable snapshot which the
+                refresher replaces atomically when the topology changes.
+
+    Date:       19 October 2026
+*/
+
+#ifndef _CELL_INDEX_HPP
+#define _CELL_INDEX_HPP
+
+#include <stdint.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/restclient.hpp"
+
+namespace cells {
+
+typedef struct nodeb {
+    std::string ran_name;
+    struct {
+        std::string plmn_id;
+        std::string nb_id;
+    } global_nb_id;
+} nodeb_t;
+
+/*
+    Cell ids are interned: a cell keeps its number for the life of the
+    index, across refreshes, so it can be held and looked up without
+    hashing the string again.
+*/
+typedef uint32_t cell_id_t;
+const cell_id_t NO_CELL = UINT32_MAX;
+
+typedef struct index_stats {
+    unsigned long refreshes = 0;        // refresh passes
+    unsigned long unchanged = 0;        // passes that found the nodeb list as it was
+    unsigned long list_fetches = 0;
+    unsigned long node_fetches = 0;     // nodeb details fetched
+    unsigned long swaps = 0;            // new snapshots published
+    unsigned long errors = 0;
+} index_stats_t;
+
+class CellIndex {
+    private:
+        // what readers see; never changed once published
+        struct snapshot {
+            std::unordered_map<std::string, cell_id_t> ids;         // every cell ever seen
+            std::vector<std::shared_ptr<const nodeb_t>> by_id;      // nil for cells no longer served
+            size_t n_cells = 0;
+            unsigned long generation = 0;
+        };
+
+        // the refresher's view of a nodeb
+        struct node_state {
+            std::string status;             // connectionStatus when its details were fetched
+            std::shared_ptr<const nodeb_t> nodeb;
+            std::vector<std::string> cells;
+        };
+
+        std::string base_url;
+        int refresh_secs;
+        int resync;                         // every resync-th refresh fetches every nodeb again
+
+        std::shared_ptr<const snapshot> current;     // accessed with std::atomic_load/store
+
+        std::mutex refresh_mtx;             // one refresh at a time; guards what follows
+        std::unique_ptr<restclient::RestClient> client;
+        std::unordered_map<std::string, node_state> nodes;
+        std::string last_list;              // body of the last nodeb list fully applied
+        index_stats_t counts;
+
+        std::mutex wake_mtx;
+        std::condition_variable wake;
+        bool running = false;
+        bool early = false;                 // a refresh was asked for before it was due
+        std::thread refresher;
+
+        std::shared_ptr<const snapshot> get_snapshot( ) const;
+        bool fetch_nodeb( const std::string &name, node_state &ns );
+        void publish( );
+        void refresh_loop( );
+
+    public:
+        CellIndex( std::string base_url, int refresh_secs = 30, int resync = 10 );
+        ~CellIndex( );
+
+        bool refresh( bool full = false );
+        void start( );
+        void stop( );
+        void request_refresh( );
+
+        cell_id_t get_id( const std::string &cell_id ) const;
+        std::shared_ptr<const nodeb_t> find( cell_id_t id ) const;
+        std::shared_ptr<const nodeb_t> find( const std::string &cell_id ) const;
+        size_t size( ) const;
+        unsigned long get_generation( ) const;
+        index_stats_t get_stats( );
+};
+
+} // namespace
+
+#endif
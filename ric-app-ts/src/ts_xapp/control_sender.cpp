@@ -0,0 +1,380 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+    Mnemonic:	control_sender.cpp
+    Abstract:	Implements the asynchronous CONTROL request sender.
+
+                Decisions are queued per UE: a decision for a UE that is
+                already waiting replaces the waiting one, and a decision
+                for the target a UE is already being moved to is dropped.
+                A UE has at most one request on the wire, so requests for
+                the same UE are never reordered.
+
+                gRPC requests are started by a dispatcher thread and
+                finished by a completion thread reading the CompletionQueue.
+                REST requests are posted by a pool of worker threads, each
+                keeping its own RestClient (and so its connection) open.
+                Both are bounded by max_inflight.
+
+    Date:       19 October 2026
+*/
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+#include "control_sender.hpp"
+#include "utils/restclient.hpp"
+
+using namespace std;
+
+namespace control {
+
+static const int lat_bounds[LAT_BUCKETS-1] = { 1, 5, 10, 50, 100, 500, 1000 };
+
+static double ms_between( sclock::time_point from, sclock::time_point to ) {
+    return chrono::duration<double, milli>( to - from ).count();
+}
+
+/*
+    Sends gRPC requests to the RC xApp on the given channel.
+*/
+ControlSender::ControlSender( shared_ptr<grpc::Channel> channel, grpc_builder_t builder, const options_t &opts ) :
+    opts( opts ),
+    stub( rc::MsgComm::NewStub( channel, grpc::StubOptions() ) ),
+    grpc_build( builder )
+{
+    last_report = sclock::now();
+    threads.emplace_back( &ControlSender::grpc_dispatcher, this );
+    threads.emplace_back( &ControlSender::grpc_completer, this );
+}
+
+/*
+    Posts REST requests to the given endpoint (full url).
+*/
+ControlSender::ControlSender( string endpoint, rest_builder_t builder, const options_t &opts ) :
+    opts( opts ),
+    endpoint( endpoint ),
+    rest_build( builder )
+{
+    last_report = sclock::now();
+    for( int i = 0; i < opts.max_inflight; i++ ) {
+        threads.emplace_back( &ControlSender::rest_worker, this );
+    }
+}
+
+ControlSender::~ControlSender( ) {
+    stop();
+}
+
+/*
+    Hands a decision to the sender; never blocks on the network.
+    Returns false if the decision was dropped.
+*/
+bool ControlSender::submit( const string &ue_id, const string &serving_cell_id, const string &target_cell_id ) {
+    unique_lock<mutex> lock( mtx );
+
+    if( !running ) {
+        return false;
+    }
+    counts.submitted++;
+
+    auto p = pending.find( ue_id );
+    if( p != pending.end() ) {          // not sent yet, the latest decision wins
+        p->second.serving_cell_id = serving_cell_id;
+        p->second.target_cell_id = target_cell_id;
+        counts.coalesced++;
+        return true;
+    }
+
+    auto f = inflight.find( ue_id );
+    if( f != inflight.end() && f->second == target_cell_id ) {      // already on the way
+        counts.coalesced++;
+        return true;
+    }
+
+    if( (int) pending.size() >= opts.max_pending ) {
+        counts.dropped++;
+        return false;
+    }
+
+    pending[ue_id] = { ue_id, serving_cell_id, target_cell_id, sclock::now() };
+    if( f == inflight.end() ) {         // otherwise it is queued when the UE's request completes
+        order.push_back( ue_id );
+        lock.unlock();
+        ready.notify_one();
+    }
+
+    return true;
+}
+
+/*
+    Waits for the next request that can be sent and marks its UE in flight.
+    Returns false when the sender is stopping.
+*/
+bool ControlSender::next( request_t &req ) {
+    unique_lock<mutex> lock( mtx );
+
+    ready.wait( lock, [this] {
+        return !running || ( !order.empty() && (int) inflight.size() < opts.max_inflight );
+    } );
+    if( !running ) {
+        return false;
+    }
+
+    auto p = pending.find( order.front() );
+    order.pop_front();
+    req = p->second;
+    pending.erase( p );
+    inflight[req.ue_id] = req.target_cell_id;
+
+    return true;
+}
+
+/*
+    Records the outcome of a request, releases its UE, and queues the
+    decision that arrived for the UE while it was in flight, if any.
+*/
+void ControlSender::complete( const request_t &req, Outcome outcome, sclock::time_point sent, sclock::time_point done ) {
+    stats_t snap;
+    bool report = false;
+
+    {
+        const lock_guard<mutex> lock( mtx );
+
+        inflight.erase( req.ue_id );
+        if( pending.find( req.ue_id ) != pending.end() ) {
+            order.push_front( req.ue_id );
+        }
+
+        switch( outcome ) {
+            case Outcome::SUCCEEDED:    counts.succeeded++; break;
+            case Outcome::REJECTED:     counts.rejected++; break;
+            case Outcome::FAILED:       counts.failed++; break;
+            case Outcome::SKIPPED:      counts.skipped++; break;
+        }
+
+        if( outcome != Outcome::SKIPPED ) {
+            double ms = ms_between( req.queued, done );
+            int b = 0;
+            while( b < LAT_BUCKETS-1 && ms >= lat_bounds[b] ) {
+                b++;
+            }
+            counts.sent++;
+            counts.lat_hist[b]++;
+            counts.total_ms += ms;
+            counts.wire_sum_ms += ms_between( sent, done );
+            if( ms > counts.max_ms ) {
+                counts.max_ms = ms;
+            }
+        }
+
+        if( opts.stats_interval > 0 && done - last_report >= chrono::seconds( opts.stats_interval ) ) {
+            last_report = done;
+            snap = counts;
+            snap.pending = pending.size();
+            snap.in_flight = inflight.size();
+            report = true;
+        }
+    }
+
+    ready.notify_one();
+    idle.notify_all();
+
+    if( report ) {
+        cout << "[INFO] Control sender " << format_stats( snap ) << endl;
+    }
+}
+
+/*
+    Starts gRPC calls, at most max_inflight at a time. The call is
+    finished by grpc_completer().
+*/
+void ControlSender::grpc_dispatcher( ) {
+    request_t req;
+    rc::RicControlGrpcReq msg;
+
+    while( next( req ) ) {
+        bool built = false;
+        msg.Clear();
+        try {
+            built = grpc_build( req, msg );
+        } catch( const exception &e ) {     // e.g. stoi() on a UE id that is not a number
+            cout << "[ERROR] unable to build a Control Request for UE " << req.ue_id << ": " << e.what() << endl;
+        }
+        if( !built ) {
+            sclock::time_point now = sclock::now();
+            complete( req, Outcome::SKIPPED, now, now );
+            continue;
+        }
+
+        grpc_call *call = new grpc_call;
+        call->req = req;
+        call->sent = sclock::now();
+        call->context.set_deadline( chrono::system_clock::now() + chrono::milliseconds( opts.timeout_ms ) );
+        call->reader = stub->PrepareAsyncSendRICControlReqServiceGrpc( &call->context, msg, &cq );
+        call->reader->StartCall();
+        call->reader->Finish( &call->response, &call->status, (void *) call );
+    }
+}
+
+void ControlSender::grpc_completer( ) {
+    void *tag;
+    bool ok;
+
+    while( cq.Next( &tag, &ok ) ) {
+        grpc_call *call = (grpc_call *) tag;
+        sclock::time_point done = sclock::now();
+        Outcome outcome;
+
+        if( call->status.ok() ) {
+            if( call->response.rspcode() == 0 ) {
+                outcome = Outcome::SUCCEEDED;
+                if( opts.log_each ) {
+                    cout << "[INFO] Control Request for UE " << call->req.ue_id << " succeeded with code=0, description="
+                         << call->response.description() << endl;
+                }
+            } else {
+                outcome = Outcome::REJECTED;
+                cout << "[ERROR] Control Request for UE " << call->req.ue_id << " failed with code=" << call->response.rspcode()
+                     << ", description=" << call->response.description() << endl;
+            }
+        } else {
+            outcome = Outcome::FAILED;
+            cout << "[ERROR] failed to send a RIC Control Request message to RC xApp, error_code="
+                 << call->status.error_code() << ", error_msg=" << call->status.error_message() << endl;
+        }
+
+        complete( call->req, outcome, call->sent, done );
+        delete call;
+    }
+}
+
+/*
+    One of the pool of REST senders. The client is kept across requests
+    so that libcurl reuses the connection.
+*/
+void ControlSender::rest_worker( ) {
+    unique_ptr<restclient::RestClient> client;
+    request_t req;
+
+    while( next( req ) ) {
+        sclock::time_point sent = sclock::now();
+        Outcome outcome;
+
+        try {
+            string msg = rest_build( req );
+            if( !client ) {
+                client.reset( new restclient::RestClient( endpoint ) );
+            }
+            restclient::response_t resp = client->do_post( "", msg ); // we already have the full path in endpoint
+
+            if( resp.status_code == 200 ) {
+                outcome = Outcome::SUCCEEDED;
+                if( opts.log_each ) {
+                    cout << "[INFO] HandOff reply is " << resp.body << endl;
+                }
+            } else {
+                outcome = Outcome::REJECTED;
+                cout << "[ERROR] Unexpected HTTP code " << resp.status_code << " from " << endpoint <<
+                        "\n[ERROR] HTTP payload is " << resp.body << endl;
+            }
+
+        } catch( const restclient::RestClientException &e ) {
+            outcome = Outcome::FAILED;
+            cout << "[ERROR] " << e.what() << endl;
+        } catch( const exception &e ) {     // from the builder or libcurl setup; the worker must carry on
+            outcome = Outcome::FAILED;
+            cout << "[ERROR] unable to send a Control Request for UE " << req.ue_id << ": " << e.what() << endl;
+        }
+
+        complete( req, outcome, sent, sclock::now() );
+    }
+}
+
+/*
+    Waits until nothing is pending or in flight. Returns false on timeout.
+*/
+bool ControlSender::drain( int timeout_ms ) {
+    unique_lock<mutex> lock( mtx );
+
+    return idle.wait_for( lock, chrono::milliseconds( timeout_ms ), [this] {
+        return pending.empty() && inflight.empty();
+    } );
+}
+
+/*
+    Stops the sender. Requests not yet sent are discarded; gRPC calls in
+    flight finish (or reach their deadline) before this returns.
+*/
+void ControlSender::stop( ) {
+    {
+        const lock_guard<mutex> lock( mtx );
+        if( !running ) {
+            return;
+        }
+        running = false;
+    }
+    ready.notify_all();
+
+    if( stub ) {
+        threads[0].join();          // no more calls are started
+        cq.Shutdown();              // the completer returns once those in flight are done
+    }
+    for( auto &t : threads ) {
+        if( t.joinable() ) {
+            t.join();
+        }
+    }
+}
+
+stats_t ControlSender::get_stats( ) {
+    const lock_guard<mutex> lock( mtx );
+
+    stats_t s = counts;
+    s.pending = pending.size();
+    s.in_flight = inflight.size();
+
+    return s;
+}
+
+string ControlSender::format_stats( const stats_t &s ) {
+    stringstream ss;
+
+    ss << fixed << setprecision( 2 );
+    ss << "submitted=" << s.submitted << " coalesced=" << s.coalesced << " dropped=" << s.dropped <<
+          " skipped=" << s.skipped << " sent=" << s.sent << " ok=" << s.succeeded << " rejected=" << s.rejected <<
+          " failed=" << s.failed << " pending=" << s.pending << " in_flight=" << s.in_flight;
+    if( s.sent > 0 ) {
+        ss << " latency_ms(avg=" << s.total_ms / s.sent << " wire_avg=" << s.wire_sum_ms / s.sent <<
+              " max=" << s.max_ms << ") hist_ms(";
+        for( int b = 0; b < LAT_BUCKETS; b++ ) {
+            if( b < LAT_BUCKETS-1 ) {
+                ss << "<" << lat_bounds[b] << ":" << s.lat_hist[b] << " ";
+            } else {
+                ss << ">=" << lat_bounds[b-1] << ":" << s.lat_hist[b] << ")";
+            }
+        }
+    }
+
+    return ss.str();
+}
+
+} // namespace
@@ -0,0 +1,160 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+    Mnemonic:	control_sender.hpp
+    Abstract:	Header for the asynchronous CONTROL request sender. Handover
+                decisions are submitted from the RMR callbacks and sent from
+                the sender's own threads, either as gRPC calls completed on a
+                CompletionQueue or as REST posts from a pool of keep-alive
+                clients.
+
+    Date:       19 October 2026
+*/
+
+#ifndef _CONTROL_SENDER_HPP
+#define _CONTROL_SENDER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <grpcpp/channel.h>
+#include <grpcpp/client_context.h>
+#include <grpcpp/completion_queue.h>
+
+#include "protobuf/rc.grpc.pb.h"
+
+namespace control {
+
+typedef std::chrono::steady_clock sclock;
+
+/*
+    A handover decision for a UE.
+*/
+typedef struct request {
+    std::string ue_id;
+    std::string serving_cell_id;
+    std::string target_cell_id;
+    sclock::time_point queued;      // when the first decision still pending for the UE was submitted
+} request_t;
+
+/*
+    Builds the gRPC message for a request; returns false if the request
+    cannot be sent (e.g. the target cell is not mapped to a nodeb).
+*/
+typedef std::function<bool( const request_t &, rc::RicControlGrpcReq & )> grpc_builder_t;
+
+/*
+    Builds the json body of the REST message for a request.
+*/
+typedef std::function<std::string( const request_t & )> rest_builder_t;
+
+typedef struct options {
+    int max_inflight = 16;          // requests on the wire at once (REST: clients in the pool)
+    int max_pending = 4096;         // UEs waiting to be sent; further decisions are dropped
+    int timeout_ms = 5000;          // gRPC deadline
+    int stats_interval = 10;        // seconds between stats lines in the log; 0 disables
+    bool log_each = true;           // log the outcome of every request
+} options_t;
+
+#define LAT_BUCKETS	8               // < 1, 5, 10, 50, 100, 500, 1000 ms, and the rest
+
+typedef struct stats {
+    unsigned long submitted = 0;    // decisions handed to the sender
+    unsigned long coalesced = 0;    // decisions merged into a pending or in flight request for the same UE
+    unsigned long dropped = 0;      // decisions refused because too many UEs were pending
+    unsigned long skipped = 0;      // requests the builder refused to build
+    unsigned long sent = 0;
+    unsigned long succeeded = 0;
+    unsigned long rejected = 0;     // delivered, but refused by the peer (rspCode or http status)
+    unsigned long failed = 0;       // transport errors and timeouts
+    unsigned long pending = 0;      // UEs waiting, at the time of the snapshot
+    unsigned long in_flight = 0;    // requests on the wire, at the time of the snapshot
+    double total_ms = 0;            // sum of the submit-to-completion latencies
+    double max_ms = 0;
+    double wire_sum_ms = 0;         // sum of the send-to-completion latencies
+    unsigned long lat_hist[LAT_BUCKETS] = { 0 };
+} stats_t;
+
+class ControlSender {
+    private:
+        enum class Outcome { SUCCEEDED, REJECTED, FAILED, SKIPPED };
+
+        // a gRPC call in flight; its address is the CompletionQueue tag
+        struct grpc_call {
+            request_t req;
+            sclock::time_point sent;
+            grpc::ClientContext context;
+            rc::RicControlGrpcRsp response;
+            grpc::Status status;
+            std::unique_ptr<grpc::ClientAsyncResponseReader<rc::RicControlGrpcRsp>> reader;
+        };
+
+        options_t opts;
+        bool running = true;
+
+        std::mutex mtx;
+        std::condition_variable ready;          // a UE can be sent, or stopping
+        std::condition_variable idle;           // nothing pending and nothing in flight
+        std::deque<std::string> order;          // UEs that can be sent now, oldest first
+        std::unordered_map<std::string, request_t> pending;     // latest decision per UE not yet sent
+        std::unordered_map<std::string, std::string> inflight;  // target cell of the request on the wire per UE
+        stats_t counts;
+        sclock::time_point last_report;
+
+        // gRPC
+        std::unique_ptr<rc::MsgComm::Stub> stub;
+        grpc::CompletionQueue cq;
+        grpc_builder_t grpc_build;
+
+        // REST
+        std::string endpoint;
+        rest_builder_t rest_build;
+
+        std::vector<std::thread> threads;
+
+        bool next( request_t &req );
+        void complete( const request_t &req, Outcome outcome, sclock::time_point sent, sclock::time_point done );
+        void grpc_dispatcher( );
+        void grpc_completer( );
+        void rest_worker( );
+
+    public:
+        ControlSender( std::shared_ptr<grpc::Channel> channel, grpc_builder_t builder, const options_t &opts );
+        ControlSender( std::string endpoint, rest_builder_t builder, const options_t &opts );
+        ~ControlSender( );
+
+        bool submit( const std::string &ue_id, const std::string &serving_cell_id, const std::string &target_cell_id );
+        bool drain( int timeout_ms );
+        void stop( );
+        stats_t get_stats( );
+        static std::string format_stats( const stats_t &s );
+};
+
+} // namespace
+
+#endif
@@ -0,0 +1,166 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	ts_json.hpp
+	Abstract:	JSON handling for the messages TS exchanges over RMR with the
+				QP and AD xApps: SAX handlers that can be reset and reused
+				from one message to the next, parsing of a payload in place,
+				and the encoder of prediction requests.
+
+	Date:		19 October 2026
+*/
+
+#ifndef _TS_JSON_HPP
+#define _TS_JSON_HPP
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <rapidjson/reader.h>
+#include <rapidjson/writer.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/memorystream.h>
+
+/*
+  Parses a prediction from the QP xApp, e.g.
+    {"Car-1":{"c6/B2":[12650,12721],"c6/N77":[12663,12739],"c1/B13":[12576,12655]}}
+  The key of the outer object is the UE, the arrays hold the downlink and
+  uplink predictions of each cell, and the first cell is the serving one.
+  Only the downlink is kept: the serving cell's and the highest one.
+*/
+struct PredictionHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, PredictionHandler> {
+  std::string ue_id;
+  bool ue_id_found = false;
+  std::string curr_key;
+  std::string serving_cell_id;
+  int serving_cell_throughput = 0;
+  std::string best_cell_id;           // cell with the highest downlink prediction
+  int best_throughput = 0;
+  bool down_val = true;
+
+  // ready for the next message; the strings keep their capacity
+  void Reset() {
+    ue_id.clear();
+    ue_id_found = false;
+    curr_key.clear();
+    serving_cell_id.clear();
+    serving_cell_throughput = 0;
+    best_cell_id.clear();
+    best_throughput = 0;
+    down_val = true;
+  }
+
+  bool Uint(unsigned u) {
+    if (down_val) {
+      // Currently, we assume the first cell in the prediction message is the serving cell
+      if ( serving_cell_id.empty() ) {
+        serving_cell_id = curr_key;
+        serving_cell_throughput = u;
+      }
+      if ( best_throughput < (int) u ) {
+        best_throughput = u;
+        best_cell_id = curr_key;
+      }
+      down_val = false;
+    } else {
+      down_val = true;
+    }
+
+    return true;
+  }
+
+  bool Key(const Ch* str, rapidjson::SizeType length, bool copy) {
+    if (!ue_id_found) {
+      ue_id.assign( str, length );
+      ue_id_found = true;
+    } else {
+      curr_key.assign( str, length );
+    }
+    return true;
+  }
+};
+
+struct AnomalyHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, AnomalyHandler> {
+  /*
+    Assuming we receive the following payload from AD
+    [{"du-id": 1010, "ue-id": "Train passenger 2", "measTimeStampRf": 1620835470108, "Degradation": "RSRP RSSINR"}]
+  */
+  std::vector<std::string> prediction_ues;
+  bool in_ue_id = false;            // the last key was "ue-id"
+
+  void Reset() {
+    prediction_ues.clear();
+    in_ue_id = false;
+  }
+
+  bool Key(const Ch* str, rapidjson::SizeType len, bool copy) {
+    in_ue_id = ( len == 5 && memcmp( str, "ue-id", 5 ) == 0 );
+    return true;
+  }
+
+  bool String(const Ch* str, rapidjson::SizeType len, bool copy) {
+    // We are only interested in the "ue-id"
+    if ( in_ue_id ) {
+      prediction_ues.emplace_back( str, len );
+    }
+    return true;
+  }
+};
+
+/*
+  Parses an RMR payload of len bytes with the handler. When the payload has
+  room for a nil after the message (avail > len) it is parsed in place, and
+  is changed by the parse; otherwise, or when keep is set, the payload is
+  read as is. Neither way copies the payload.
+*/
+template <typename Handler>
+bool parse_payload( rapidjson::Reader &reader, Handler &handler, char *payload, int len, int avail, bool keep = false ) {
+  if ( !keep && len < avail ) {
+    payload[len] = 0;
+    rapidjson::InsituStringStream ss( payload );
+    return !reader.Parse<rapidjson::kParseInsituFlag>( ss, handler ).IsError();
+  }
+
+  rapidjson::MemoryStream ms( payload, len );
+  return !reader.Parse( ms, handler ).IsError();
+}
+
+/*
+  Encodes the prediction request for the QP xApp into buf, replacing what
+  it held, e.g.
+    {"UEPredictionSet":["Car-1","Car-2"]}
+*/
+inline void encode_prediction_request( rapidjson::StringBuffer &buf, const std::vector<std::string> &ues ) {
+  buf.Clear();
+  rapidjson::Writer<rapidjson::StringBuffer> writer( buf );
+
+  writer.StartObject();
+  writer.Key( "UEPredictionSet" );
+  writer.StartArray();
+  for ( const std::string &ue : ues ) {
+    writer.String( ue.data(), (rapidjson::SizeType) ue.size() );
+  }
+  writer.EndArray();
+  writer.EndObject();
+}
+
+#endif
@@ -33,6 +33,9 @@
             Update for traffic steering use case in release D.
             07 Dec 2021 (Alexandre Huff)
             Update for traffic steering use case in release E.
+            19 Oct 2026
+            CONTROL requests are handed to an asynchronous sender (control_sender)
+            instead of being sent from the RMR callback.
 */
 
 #include <stdio.h>
@@ -40,6 +43,7 @@
 #include <unistd.h>
 
 #include <thread>
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <algorithm>
@@ -76,6 +80,9 @@
 #include "protobuf/rc.grpc.pb.h"
 
 #include "utils/restclient.hpp"
+#include "control_sender.hpp"
+#include "ts_json.hpp"
+#include "cell_index.hpp"
 
 
 using namespace rapidjson;
@@ -91,7 +98,7 @@ using Keys = std::set<Key>;
 
 // ----------------------------------------------------------
 std::unique_ptr<Xapp> xfw;
-std::unique_ptr<rc::MsgComm::Stub> rc_stub;
+std::unique_ptr<control::ControlSender> control_sender;
 
 int downlink_threshold = 0;  // A1 policy type 20008 (in percentage)
 
@@ -100,15 +107,7 @@ enum class TsControlApi { REST, gRPC };
 TsControlApi ts_control_api;  // api to send control messages
 string ts_control_ep;         // api target endpoint
 
-typedef struct nodeb {
-  string ran_name;
-  struct {
-    string plmn_id;
-    string nb_id;
-  } global_nb_id;
-} nodeb_t;
-
-unordered_map<string, shared_ptr<nodeb_t>> cell_map; // maps each cell to its nodeb
+std::unique_ptr<cells::CellIndex> cell_index;  // maps each cell to its nodeb, refreshed from E2 Manager
 
 /* struct UEData {
   string serving_cell;
@@ -116,28 +115,6 @@ unordered_map<string, shared_ptr<nodeb_t>> cell_map; // maps each cell to its no
 }; */
 
 
-//https://stackoverflow.com/a/34571089/15098882
-
-static std::string base64_decode(const std::string &in) {
-
-	std::string out;
-
-	std::vector<int> T(256, -1);
-	for (int i = 0; i < 64; i++) T["ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"[i]] = i;
-
-	int val = 0, valb = -8;
-	for (unsigned char c : in) {
-		if (T[c] == -1) break;
-		val = (val << 6) + T[c];
-		valb += 6;
-		if (valb >= 0) {
-			out.push_back(char((val >> valb) & 0xFF));
-			valb -= 8;
-		}
-	}
-	return out;
-}
-
 struct PolicyHandler : public BaseReaderHandler<UTF8<>, PolicyHandler> {
   /*
     Assuming we receive the following payload from A1 Mediator
@@ -209,175 +186,6 @@ struct PolicyHandler : public BaseReaderHandler<UTF8<>, PolicyHandler> {
 
 };
 
-struct PredictionHandler : public BaseReaderHandler<UTF8<>, PredictionHandler> {
-  unordered_map<string, int> cell_pred_down;
-  unordered_map<string, int> cell_pred_up;
-  std::string ue_id;
-  bool ue_id_found = false;
-  string curr_key = "";
-  string curr_value = "";
-  string serving_cell_id;
-  bool down_val = true;
-  bool Null() {  return true; }
-  bool Bool(bool b) {  return true; }
-  bool Int(int i) {  return true; }
-  bool Uint(unsigned u) {
-    // Currently, we assume the first cell in the prediction message is the serving cell
-    if ( serving_cell_id.empty() ) {
-      serving_cell_id = curr_key;
-    }
-
-    if (down_val) {
-      cell_pred_down[curr_key] = u;
-      down_val = false;
-    } else {
-      cell_pred_up[curr_key] = u;
-      down_val = true;
-    }
-
-    return true;
-
-  }
-  bool Int64(int64_t i) {  return true; }
-  bool Uint64(uint64_t u) {  return true; }
-  bool Double(double d) {  return true; }
-  bool String(const char* str, SizeType length, bool copy) {
-
-    return true;
-  }
-  bool StartObject() {  return true; }
-  bool Key(const char* str, SizeType length, bool copy) {
-    if (!ue_id_found) {
-
-      ue_id = str;
-      ue_id_found = true;
-    } else {
-      curr_key = str;
-    }
-    return true;
-  }
-  bool EndObject(SizeType memberCount) {  return true; }
-  bool StartArray() {  return true; }
-  bool EndArray(SizeType elementCount) {  return true; }
-};
-
-struct AnomalyHandler : public BaseReaderHandler<UTF8<>, AnomalyHandler> {
-  /*
-    Assuming we receive the following payload from AD
-    [{"du-id": 1010, "ue-id": "Train passenger 2", "measTimeStampRf": 1620835470108, "Degradation": "RSRP RSSINR"}]
-  */
-  vector<string> prediction_ues;
-  string curr_key = "";
-
-  bool Key(const Ch* str, SizeType len, bool copy) {
-    curr_key = str;
-    return true;
-  }
-
-  bool String(const Ch* str, SizeType len, bool copy) {
-    // We are only interested in the "ue-id"
-    if ( curr_key.compare( "ue-id") == 0 ) {
-      prediction_ues.push_back( str );
-    }
-    return true;
-  }
-};
-
-struct NodebListHandler : public BaseReaderHandler<UTF8<>, NodebListHandler> {
-  vector<string> nodeb_list;
-  string curr_key = "";
-
-  bool Key(const Ch* str, SizeType length, bool copy) {
-    curr_key = str;
-    return true;
-  }
-
-  bool String(const Ch* str, SizeType length, bool copy) {
-    if( curr_key.compare( "inventoryName" ) == 0 ) {
-      nodeb_list.push_back( str );
-    }
-    return true;
-  }
-};
-
-struct NodebHandler : public BaseReaderHandler<UTF8<>, NodebHandler> {
-	string curr_key = "";
-	shared_ptr<nodeb_t> nodeb = make_shared<nodeb_t>();
-	std::string meid;
-	std::vector<string> cells;
-
-	bool Key(const Ch* str, SizeType length, bool copy) {
-		curr_key = str;
-		return true;
-	}
-
-	bool String(const Ch* str, SizeType length, bool copy) {
-
-		if (curr_key.compare("ranName") == 0) {
-			//std::cout << str << "\n";
-			nodeb->ran_name = str;
-			meid= str;
-			//std::cout << "\n meid = " << meid;
-
-		}
-		else if (curr_key.compare("plmnId") == 0) {
-			//std::cout << str << "\n";
-			nodeb->global_nb_id.plmn_id = str;
-		}
-		else if (curr_key.compare("nbId") == 0) {
-			//std::cout <<str<< "\n";
-			nodeb->global_nb_id.nb_id = str;
-		}
-		else if (curr_key.compare("e2nodeComponentRequestPart") == 0) {
-			//std::cout << str<<"\n";
-			auto message = base64_decode(str);
-			//std::cout << message<<"\n";
-			int len = meid.length();
-			//std::cout << "\n meid = " << meid;
-			int counter = 0;
-				for (int i = 0; i <len; i++ ){
-					if (meid[i] == '_') {
-						counter++;
-					}
-					if( counter == 3) {
-						counter = i + 1;
-						break;
-					}
-				}
-				std::string last_matching_bits = meid.substr(counter, meid.length());
-				len = last_matching_bits.size();
-				char b;
-
-				for (int i = 0; i < len; i++) {
-					b = last_matching_bits[i];
-					b = toupper(b);
-					// b = to lower(b); //alternately
-					last_matching_bits[i] = b;
-				}
-				len = message.length();
-				//std::cout << "\nlast_matching_bits = " << last_matching_bits;
-				int matching_len = last_matching_bits.length();;
-
-					for (int i = 0; i <= len - matching_len; i++ ){
-						//std::cout << "\n" << message.substr(i, matching_len);
-
-						if (message.substr(i,matching_len)== last_matching_bits){
-							//std::cout << "\nmatched!\n";
-							cells.push_back(message.substr(i,10));//cell id is 36 bit long , last  4 bit unused
-
-						}
-					}
-					len = cells.size();
-					for (int i = 0; i < len; i++) {
-						cell_map[cells[i]] = nodeb;
-					}
-
-		}
-		return true;
-	}
-
-};
-
 /* struct UEDataHandler : public BaseReaderHandler<UTF8<>, UEDataHandler> {
   unordered_map<string, string> cell_pred;
   std::string serving_cell_id;
@@ -525,32 +333,30 @@ void policy_callback( Message& mbuf, int mtype, int subid, int len, Msg_componen
 
 }
 
-// sends a handover message through REST
-void send_rest_control_request( string ue_id, string serving_cell_id, string target_cell_id ) {
+// builds the json body of a handover message sent through REST
+string build_rest_control_request( const control::request_t &req ) {
   time_t now;
   string str_now;
-  static unsigned int seq_number = 0; // static counter, not thread-safe
+  static atomic<unsigned int> seq_number( 0 ); // shared by the sender's pool of clients
 
   // building a handoff control message
   now = time( nullptr );
   str_now = ctime( &now );
   str_now.pop_back(); // removing the \n character
 
-  seq_number++;       // static counter, not thread-safe
-
   rapidjson::StringBuffer s;
   rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
   writer.StartObject();
   writer.Key( "command" );
   writer.String( "HandOff" );
   writer.Key( "seqNo" );
-  writer.Int( seq_number );
+  writer.Int( ++seq_number );
   writer.Key( "ue" );
-  writer.String( ue_id.c_str() );
+  writer.String( req.ue_id.c_str() );
   writer.Key( "fromCell" );
-  writer.String( serving_cell_id.c_str() );
+  writer.String( req.serving_cell_id.c_str() );
   writer.Key( "toCell" );
-  writer.String( target_cell_id.c_str() );
+  writer.String( req.target_cell_id.c_str() );
   writer.Key( "timestamp" );
   writer.String( str_now.c_str() );
   writer.Key( "reason" );
@@ -575,46 +381,19 @@ void send_rest_control_request( string ue_id, string serving_cell_id, string tar
   cout << "[INFO] Sending a HandOff CONTROL message to \"" << ts_control_ep << "\"\n";
   cout << "[INFO] HandOff request is " << msg << endl;
 
-  try {
-    // sending request
-    restclient::RestClient client( ts_control_ep );
-    restclient::response_t resp = client.do_post( "", msg ); // we already have the full path in ts_control_ep
-
-    if( resp.status_code == 200 ) {
-        // ============== DO SOMETHING USEFUL HERE ===============
-        // Currently, we only print out the HandOff reply
-        rapidjson::Document document;
-        document.Parse( resp.body.c_str() );
-        rapidjson::StringBuffer s;
-        rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
-        document.Accept( writer );
-        cout << "[INFO] HandOff reply is " << s.GetString() << endl;
-
-    } else {
-        cout << "[ERROR] Unexpected HTTP code " << resp.status_code << " from " << \
-                client.getBaseUrl() << \
-                "\n[ERROR] HTTP payload is " << resp.body.c_str() << endl;
-    }
-
-  } catch( const restclient::RestClientException &e ) {
-    cout << "[ERROR] " << e.what() << endl;
-
-  }
-
+  return msg;
 }
 
-// sends a handover message to RC xApp through gRPC
-void send_grpc_control_request( string ue_id, string target_cell_id ) {
-  grpc::ClientContext context;
-
-  rc::RicControlGrpcRsp response;
-  shared_ptr<rc::RicControlGrpcReq> request = make_shared<rc::RicControlGrpcReq>();
+// builds a handover message sent to RC xApp through gRPC; false if the target cell is unknown
+bool build_grpc_control_request( const control::request_t &req, rc::RicControlGrpcReq &request ) {
+  const string &ue_id = req.ue_id;
+  const string &target_cell_id = req.target_cell_id;
 
-  rc::RICE2APHeader *apHeader = request->mutable_rice2apheaderdata();
+  rc::RICE2APHeader *apHeader = request.mutable_rice2apheaderdata();
   apHeader->set_ranfuncid(3);
   apHeader->set_ricrequestorid( 1 );
 
-  rc::RICControlHeader *ctrlHeader = request->mutable_riccontrolheaderdata();
+  rc::RICControlHeader *ctrlHeader = request.mutable_riccontrolheaderdata();
   ctrlHeader->set_controlstyle( 3 );
   ctrlHeader->set_controlactionid( 1 );
   rc::UeId *ueid =  ctrlHeader->mutable_ueid();
@@ -630,90 +409,62 @@ void send_grpc_control_request( string ue_id, string target_cell_id ) {
   
   //ctrlHeader->set_ueid( ue_id );
 
-  rc::RICControlMessage *ctrlMsg = request->mutable_riccontrolmessagedata();
+  rc::RICControlMessage *ctrlMsg = request.mutable_riccontrolmessagedata();
   ctrlMsg->set_riccontrolcelltypeval( rc::RICControlCellTypeEnum::RIC_CONTROL_CELL_UNKWON );
   //ctrlMsg->set_riccontrolcelltypeval( api::RIC_CONTROL_CELL_UNKWON);
     
     ctrlMsg->set_targetcellid( target_cell_id);
 
-  auto data = cell_map.find(target_cell_id);
-  if( data != cell_map.end() ) {
-    request->set_e2nodeid( data->second->global_nb_id.nb_id );
-    request->set_plmnid( data->second->global_nb_id.plmn_id );
-    request->set_ranname( data->second->ran_name );
-    gumi->set_plmnidentity(data->second->global_nb_id.plmn_id);
+  // one hash of the name against a single snapshot; an interned id taken at decision time
+  // would be NO_CELL for a cell learned by a refresh while the request was queued
+  shared_ptr<const cells::nodeb_t> nodeb = cell_index->find( target_cell_id );
+  if( nodeb ) {
+    request.set_e2nodeid( nodeb->global_nb_id.nb_id );
+    request.set_plmnid( nodeb->global_nb_id.plmn_id );
+    request.set_ranname( nodeb->ran_name );
+    gumi->set_plmnidentity( nodeb->global_nb_id.plmn_id );
   } else {
     cout << "[INFO] Cannot find RAN name corresponding to cell id = "<<target_cell_id<<endl;
-    return;
-    request->set_e2nodeid( "unknown_e2nodeid" );
-    request->set_plmnid( "unknown_plmnid" );
-    request->set_ranname( "unknown_ranname" );
-    gumi->set_plmnidentity("unknown_plmnid");
-  }
-  request->set_riccontrolackreqval( rc::RICControlAckEnum::RIC_CONTROL_ACK_UNKWON );
-  //request->set_riccontrolackreqval( api::RIC_CONTROL_ACK_UNKWON);  // not yet used in api.proto
- cout<<"\nin ts xapp grpc message content \n"<< request->DebugString()<<"\n"; 
-  grpc::Status status = rc_stub->SendRICControlReqServiceGrpc( &context, *request, &response );
-
-  if( status.ok() ) {
-    if( response.rspcode() == 0 ) {
-      cout << "[INFO] Control Request succeeded with code=0, description=" << response.description() << endl;
-    } else {
-      cout << "[ERROR] Control Request failed with code=" << response.rspcode()
-           << ", description=" << response.description() << endl;
-    }
-
-  } else {
-    cout << "[ERROR] failed to send a RIC Control Request message to RC xApp, error_code="
-         << status.error_code() << ", error_msg=" << status.error_message() << endl;
+    cell_index->request_refresh();  // the cell may be new, even on a known nodeb; refetch them all now
+    return false;
   }
+  request.set_riccontrolackreqval( rc::RICControlAckEnum::RIC_CONTROL_ACK_UNKWON );
+  //request.set_riccontrolackreqval( api::RIC_CONTROL_ACK_UNKWON);  // not yet used in api.proto
 
+  return true;
 }
 
 void prediction_callback( Message& mbuf, int mtype, int subid, int len, Msg_component payload,  void* data ) {
-  string json ((char *)payload.get(), len); // RMR payload might not have a nil terminanted char
+  static thread_local PredictionHandler handler;  // reused, as is the reader's stack
+  static thread_local Reader reader;
 
   cout << "[INFO] Prediction Callback got a message, type=" << mtype << ", length=" << len << "\n";
-  cout << "[INFO] Payload is " << json << endl;
-
-  PredictionHandler handler;
-  try {
-    Reader reader;
-    StringStream ss(json.c_str());
-    reader.Parse(ss,handler);
-  } catch (...) {
-    cout << "[ERROR] Got an exception on stringstream read parse\n";
+#if DEBUG
+  cout << "[INFO] Payload is " << string( (char *) payload.get(), len ) << endl;  // RMR payload might not have a nil terminanted char
+#endif
+
+  // parsed in place, nothing else uses this payload
+  handler.Reset();
+  if ( !parse_payload( reader, handler, (char *) payload.get(), len, mbuf.Get_available_size() ) ) {
+    cout << "[ERROR] unable to parse the prediction, error " << reader.GetParseErrorCode()
+         << " at offset " << reader.GetErrorOffset() << endl;
+    return;
+  }
+  if ( handler.serving_cell_id.empty() ) {
+    cout << "[ERROR] prediction for UE \"" << handler.ue_id << "\" has no cells" << endl;
+    return;
   }
-
-  // We are only considering download throughput
-  unordered_map<string, int> throughput_map = handler.cell_pred_down;
 
   // Decision about CONTROL message
   // (1) Identify UE Id in Prediction message
   // (2) Iterate through Prediction message.
   //     If one of the cells has a higher throughput prediction than serving cell, send a CONTROL request
   //     We assume the first cell in the prediction message is the serving cell
+  // The handler keeps the serving cell and the highest downlink (we are only considering download throughput)
 
-  int serving_cell_throughput = 0;
-  int highest_throughput = 0;
-  string highest_throughput_cell_id;
-
-  // Getting the current serving cell throughput prediction
-  auto cell = throughput_map.find( handler.serving_cell_id );
-  serving_cell_throughput = cell->second;
-
-   // Iterating to identify the highest throughput prediction
-  for (auto map_iter = throughput_map.begin(); map_iter != throughput_map.end(); map_iter++) {
-
-    string curr_cellid = map_iter->first;
-    int curr_throughput = map_iter->second;
-
-    if ( highest_throughput < curr_throughput ) {
-      highest_throughput = curr_throughput;
-      highest_throughput_cell_id = curr_cellid;
-    }
-
-  }
+  int serving_cell_throughput = handler.serving_cell_throughput;
+  int highest_throughput = handler.best_throughput;
+  const string &highest_throughput_cell_id = handler.best_cell_id;
 
   float thresh = 0;
   if( downlink_threshold > 0 ) {  // we also take into account the threshold in A1 policy type 20008
@@ -722,11 +473,9 @@ void prediction_callback( Message& mbuf, int mtype, int subid, int len, Msg_comp
 
   if ( highest_throughput > ( serving_cell_throughput + thresh ) ) {
 
-    // sending a control request message
-    if ( ts_control_api == TsControlApi::REST ) {
-      send_rest_control_request( handler.ue_id, handler.serving_cell_id, highest_throughput_cell_id );
-    } else {
-      send_grpc_control_request( handler.ue_id, highest_throughput_cell_id );
+    // handing the control request to the sender, this thread does not wait for the reply
+    if ( !control_sender->submit( handler.ue_id, handler.serving_cell_id, highest_throughput_cell_id ) ) {
+      cout << "[ERROR] too many pending control requests, dropping the one for UE " << handler.ue_id << endl;
     }
 
   } else {
@@ -735,44 +484,32 @@ void prediction_callback( Message& mbuf, int mtype, int subid, int len, Msg_comp
 
 }
 
-void send_prediction_request( vector<string> ues_to_predict ) {
+void send_prediction_request( const vector<string> &ues_to_predict ) {
+  static thread_local StringBuffer body;    // keeps its capacity between requests
   std::unique_ptr<Message> msg;
-  Msg_component payload;           // special type of unique pointer to the payload
-
-  int sz;
-  int i;
   size_t plen;
-  Msg_component send_payload;
 
-  msg = xfw->Alloc_msg( 2048 );
-
-  sz = msg->Get_available_size();  // we'll reuse a message if we received one back; ensure it's big enough
-  if( sz < 2048 ) {
-    fprintf( stderr, "[ERROR] message returned did not have enough size: %d [%d]\n", sz, i );
-    exit( 1 );
+  if ( ues_to_predict.empty() ) {
+    return;
   }
 
-  string ues_list = "[";
+  encode_prediction_request( body, ues_to_predict );
+  plen = body.GetSize();
 
-  for (int i = 0; i < ues_to_predict.size(); i++) {
-    if (i == ues_to_predict.size() - 1) {
-      ues_list = ues_list + "\"" + ues_to_predict.at(i) + "\"]";
-    } else {
-      ues_list = ues_list + "\"" + ues_to_predict.at(i) + "\"" + ",";
-    }
+  // sized to the request, so a large set of UEs is not cut short
+  msg = xfw->Alloc_msg( plen );
+  if( msg->Get_available_size() < (int) plen ) {
+    fprintf( stderr, "[ERROR] message returned did not have enough size: %d [%d]\n", msg->Get_available_size(), (int) plen );
+    return;
   }
 
-  string message_body = "{\"UEPredictionSet\": " + ues_list + "}";
+  cout << "[INFO] Prediction Request length=" << plen << ", UEs=" << ues_to_predict.size() << endl;
+#if DEBUG
+  cout << "[INFO] Prediction Request payload=" << body.GetString() << endl;
+#endif
 
-  send_payload = msg->Get_payload(); // direct access to payload
-  snprintf( (char *) send_payload.get(), 2048, "%s", message_body.c_str() );
-
-  plen = strlen( (char *)send_payload.get() );
-
-  cout << "[INFO] Prediction Request length=" << plen << ", payload=" << send_payload.get() << endl;
-
-  // payload updated in place, nothing to copy from, so payload parm is nil
-  if ( ! msg->Send_msg( TS_UE_LIST, Message::NO_SUBID, plen, NULL )) { // msg type 30000
+  // the payload is copied into the message
+  if ( ! msg->Send_msg( TS_UE_LIST, Message::NO_SUBID, plen, (unsigned char *) body.GetString() )) { // msg type 30000
     fprintf( stderr, "[ERROR] send failed: %d\n", msg->Get_state() );
   }
 
@@ -783,15 +520,20 @@ void send_prediction_request( vector<string> ues_to_predict ) {
  * sends a prediction request to the QP Driver xApp.
  */
 void ad_callback( Message& mbuf, int mtype, int subid, int len, Msg_component payload, void* data ) {
-  string json ((char *)payload.get(), len); // RMR payload might not have a nil terminanted char
+  static thread_local AnomalyHandler handler;
+  static thread_local Reader reader;
 
   cout << "[INFO] AD Callback got a message, type=" << mtype << ", length=" << len << "\n";
-  cout << "[INFO] Payload is " << json << "\n";
+#if DEBUG
+  cout << "[INFO] Payload is " << string( (char *) payload.get(), len ) << "\n";
+#endif
 
-  AnomalyHandler handler;
-  Reader reader;
-  StringStream ss(json.c_str());
-  reader.Parse(ss,handler);
+  // the payload is echoed back as the ACK, so it is read without being changed
+  handler.Reset();
+  if ( !parse_payload( reader, handler, (char *) payload.get(), len, mbuf.Get_available_size(), true ) ) {
+    cout << "[ERROR] unable to parse the anomaly message, error " << reader.GetParseErrorCode()
+         << " at offset " << reader.GetErrorOffset() << endl;
+  }
 
   // just sending ACK to the AD xApp
   mbuf.Send_response( TS_ANOMALY_ACK, Message::NO_SUBID, len, nullptr );  // msg type 30004
@@ -799,77 +541,6 @@ void ad_callback( Message& mbuf, int mtype, int subid, int len, Msg_component pa
   send_prediction_request(handler.prediction_ues);
 }
 
-vector<string> get_nodeb_list( restclient::RestClient& client ) {
-
-  restclient::response_t response = client.do_get( "/v1/nodeb/states" );
-
-  NodebListHandler handler;
-  if( response.status_code == 200 ) {
-    Reader reader;
-    StringStream ss( response.body.c_str() );
-    reader.Parse( ss, handler );
-
-    cout << "[INFO] nodeb list is " << response.body.c_str() << endl;
-
-  } else {
-    if( response.body.empty() ) {
-      cout << "[ERROR] Unexpected HTTP code " << response.status_code << " from " << client.getBaseUrl() << endl;
-    } else {
-      cout << "[ERROR] Unexpected HTTP code " << response.status_code << " from " << client.getBaseUrl() <<
-              ". HTTP payload is " << response.body.c_str() << endl;
-    }
-  }
-
-  return handler.nodeb_list;
-}
-
-bool build_cell_mapping() {
-  string base_url;
-  char *data = getenv( "SERVICE_E2MGR_HTTP_BASE_URL" );
-  if ( data == NULL ) {
-    base_url = "http://service-ricplt-e2mgr-http.ricplt:3800";
-  } else {
-    base_url = string( data );
-  }
-
-  try {
-    restclient::RestClient client( base_url );
-
-    vector<string> nb_list = get_nodeb_list( client );
-
-    for( string nb : nb_list ) {
-      string full_path = string("/v1/nodeb/") + nb;
-      restclient::response_t response = client.do_get( full_path );
-      if( response.status_code != 200 ) {
-        if( response.body.empty() ) {
-          cout << "[ERROR] Unexpected HTTP code " << response.status_code << " from " << \
-                  client.getBaseUrl() + full_path << endl;
-        } else {
-          cout << "[ERROR] Unexpected HTTP code " << response.status_code << " from " << \
-                client.getBaseUrl() + full_path << ". HTTP payload is " << response.body.c_str() << endl;
-        }
-        return false;
-      }
-
-      try {
-        NodebHandler handler;
-        Reader reader;
-        StringStream ss( response.body.c_str() );
-        reader.Parse( ss, handler );
-      } catch (...) {
-        cout << "[ERROR] Got an exception on parsing nodeb (stringstream read parse)\n";
-        return false;
-      }
-    }
-
-  } catch( const restclient::RestClientException &e ) {
-    cout << "[ERROR] " << e.what() << endl;
-    return false;
-  }
-
-  return true;
-}
-
 extern int main( int argc, char** argv ) {
   int nthreads = 1;
   char*	port = (char *) "4560";
@@ -882,17 +553,38 @@ extern int main( int argc, char** argv ) {
     cout << "[ERROR] a control api (rest/grpc) is required in xApp descriptor\n";
     exit(1);
   }
+  control::options_t ctrl_opts;
+  ctrl_opts.max_inflight = config->Get_control_value( "ts_control_max_inflight", ctrl_opts.max_inflight );
+  ctrl_opts.timeout_ms = config->Get_control_value( "ts_control_timeout_ms", ctrl_opts.timeout_ms );
+  if ( ctrl_opts.max_inflight < 1 ) {
+    ctrl_opts.max_inflight = 1;
+  }
+
   if ( api.compare("rest") == 0 ) {
     ts_control_api = TsControlApi::REST;
+    control_sender = std::unique_ptr<control::ControlSender>(
+        new control::ControlSender( ts_control_ep, build_rest_control_request, ctrl_opts ) );
   } else {
     ts_control_api = TsControlApi::gRPC;
 
-    if( !build_cell_mapping() ) {
+    string e2mgr_url;
+    char *data = getenv( "SERVICE_E2MGR_HTTP_BASE_URL" );
+    if ( data == NULL ) {
+      e2mgr_url = "http://service-ricplt-e2mgr-http.ricplt:3800";
+    } else {
+      e2mgr_url = string( data );
+    }
+
+    cell_index = std::unique_ptr<cells::CellIndex>(
+        new cells::CellIndex( e2mgr_url, config->Get_control_value( "ts_cell_refresh_secs", 30 ) ) );
+    if( !cell_index->refresh() ) {
       cout << "[ERROR] unable to map cells to nodeb\n";
     }
+    cell_index->start();
 
     channel = grpc::CreateChannel(ts_control_ep, grpc::InsecureChannelCredentials());
-    rc_stub = rc::MsgComm::NewStub(channel, grpc::StubOptions());
+    control_sender = std::unique_ptr<control::ControlSender>(
+        new control::ControlSender( channel, build_grpc_control_request, ctrl_opts ) );
   }
 
   fprintf( stderr, "[INFO] listening on port %s\n", port );
@@ -904,4 +596,9 @@ extern int main( int argc, char** argv ) {
 
   xfw->Run( nthreads );
 
+  control_sender->stop();
+  if ( cell_index ) {
+    cell_index->stop();
+  }
+
 }
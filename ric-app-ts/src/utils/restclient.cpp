@@ -89,6 +89,11 @@ void RestClient::init( ) {
             throw RestClientException( "unable to set CURLOPT_TIMEOUT" );
         }
 
+        // the handle is reused across requests, keep its connection from being silently dropped
+        if( curl_easy_setopt( curl, CURLOPT_TCP_KEEPALIVE, 1L ) != CURLE_OK ) {
+            throw RestClientException( "unable to set CURLOPT_TCP_KEEPALIVE" );
+        }
+
         /* provide a buffer to store errors in */
         if( curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errbuf) != CURLE_OK ) {
             throw RestClientException( "unable to set CURLOPT_ERRORBUFFER" );
@@ -0,0 +1,311 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2021 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	cell_index_test.cpp
+	Abstract:   Drives the TS xApp cell index against a stand-in for E2 Manager
+                running in process. The stand-in serves a nodeb list that is
+                changed between refreshes (nodebs added, reconnected, removed),
+                and counts the requests so that the test can check that only
+                the changed nodebs are fetched again. Exits non-zero on the
+                first failed check.
+
+                Usage: cell_index_test [port]
+
+	Date:		19 October 2026
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../../src/ts_xapp/cell_index.hpp"
+
+using namespace std;
+
+// ------------------ E2 Manager stand-in ---------------------------------------
+static mutex srv_mtx;
+static map<string, string> bodies;          // path -> json served
+static map<string, int> hits;               // path -> requests served
+static atomic<bool> srv_running( true );
+
+static void set_body( const string &path, const string &body ) {
+    const lock_guard<mutex> lock( srv_mtx );
+    if( body.empty() ) {
+        bodies.erase( path );
+    } else {
+        bodies[path] = body;
+    }
+}
+
+static int get_hits( const string &path ) {
+    const lock_guard<mutex> lock( srv_mtx );
+    return hits[path];
+}
+
+// one connection; requests are read until the client closes it (libcurl keeps it open)
+static void serve_conn( int fd ) {
+    string in;
+    char buf[4096];
+    ssize_t n;
+
+    while( (n = read( fd, buf, sizeof( buf ) )) > 0 ) {
+        in.append( buf, n );
+
+        size_t end;
+        while( (end = in.find( "\r\n\r\n" )) != string::npos ) {
+            size_t sp = in.find( ' ' );
+            string path = in.substr( sp + 1, in.find( ' ', sp + 1 ) - sp - 1 );
+            in.erase( 0, end + 4 );
+
+            string body;
+            int code = 404;
+            {
+                const lock_guard<mutex> lock( srv_mtx );
+                hits[path]++;
+                auto b = bodies.find( path );
+                if( b != bodies.end() ) {
+                    body = b->second;
+                    code = 200;
+                }
+            }
+
+            string rsp = "HTTP/1.1 " + to_string( code ) + ( code == 200 ? " OK" : " Not Found" ) +
+                         "\r\nContent-Type: application/json\r\nContent-Length: " + to_string( body.size() ) +
+                         "\r\n\r\n" + body;
+            if( write( fd, rsp.data(), rsp.size() ) != (ssize_t) rsp.size() ) {
+                close( fd );
+                return;
+            }
+        }
+    }
+    close( fd );
+}
+
+static void serve( int lfd ) {
+    while( srv_running ) {
+        int fd = accept( lfd, NULL, NULL );
+        if( fd < 0 ) {
+            continue;
+        }
+        thread( serve_conn, fd ).detach();
+    }
+}
+
+// ------------------ canned E2 Manager content ---------------------------------
+static const char *b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static string base64_encode( const string &in ) {
+    string out;
+    int val = 0, valb = -6;
+    for( unsigned char c : in ) {
+        val = (val << 8) + c;
+        valb += 8;
+        while( valb >= 0 ) {
+            out.push_back( b64[(val >> valb) & 0x3F] );
+            valb -= 6;
+        }
+    }
+    if( valb > -6 ) {
+        out.push_back( b64[((val << 8) >> (valb + 8)) & 0x3F] );
+    }
+    while( out.size() % 4 ) {
+        out.push_back( '=' );
+    }
+    return out;
+}
+
+/*
+    A nodeb named gnb_311_048_<id> serving cells <ID>01 .. <ID><n>, the way
+    the cells are found in e2nodeComponentRequestPart.
+*/
+static void put_nodeb( const string &id, int n_cells ) {
+    string name = "gnb_311_048_" + id;
+    string upper = id;
+    for( char &c : upper ) {
+        c = toupper( c );
+    }
+
+    string part = "3082";
+    for( int c = 1; c <= n_cells; c++ ) {
+        char cell[3];
+        snprintf( cell, sizeof( cell ), "%02d", c );
+        part += "0a" + upper + cell + "ff";
+    }
+
+    set_body( "/v1/nodeb/" + name,
+        "{\"ranName\":\"" + name + "\",\"connectionStatus\":\"CONNECTED\",\"globalNbId\":{\"plmnId\":\"13F184\",\"nbId\":\"" +
+        id + "\"},\"gnb\":{\"nodeConfigs\":[{\"e2nodeComponentInterfaceType\":\"ng\",\"e2nodeComponentRequestPart\":\"" +
+        base64_encode( part ) + "\"}]}}" );
+}
+
+static void put_list( const map<string, string> &nodebs ) {      // id -> connection status
+    string list = "[";
+    for( auto &nb : nodebs ) {
+        if( list.size() > 1 ) {
+            list += ",";
+        }
+        list += "{\"inventoryName\":\"gnb_311_048_" + nb.first + "\",\"globalNbId\":{\"plmnId\":\"13F184\",\"nbId\":\"" +
+                nb.first + "\"},\"connectionStatus\":\"" + nb.second + "\"}";
+    }
+    set_body( "/v1/nodeb/states", list + "]" );
+}
+
+// ------------------ checks ----------------------------------------------------
+static int errors = 0;
+
+#define CHECK( cond, what ) do { \
+        if( !(cond) ) { cout << "[FAIL] " << what << endl; errors++; } \
+        else { cout << "[OK] " << what << endl; } \
+    } while( 0 )
+
+static bool serves( cells::CellIndex &idx, const string &cell, const string &ran ) {
+    shared_ptr<const cells::nodeb_t> nb = idx.find( cell );
+    return nb && nb->ran_name == ran;
+}
+
+static string fetches( const string &id ) {
+    return "/v1/nodeb/gnb_311_048_" + id;
+}
+
+int main( int argc, char **argv ) {
+    int port = argc > 1 ? atoi( argv[1] ) : 38001;
+
+    int lfd = socket( AF_INET, SOCK_STREAM, 0 );
+    int on = 1;
+    setsockopt( lfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof( on ) );
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons( port );
+    addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+    if( bind( lfd, (struct sockaddr *) &addr, sizeof( addr ) ) != 0 || listen( lfd, 16 ) != 0 ) {
+        perror( "stand-in server" );
+        exit( 1 );
+    }
+    thread( serve, lfd ).detach();
+
+    string url = "http://127.0.0.1:" + to_string( port );
+    cells::CellIndex idx( url, 1, 1000 );      // background refreshes every second, no full resync
+
+    // two nodebs
+    put_nodeb( "0000000a", 2 );
+    put_nodeb( "0000000b", 3 );
+    put_list( { { "0000000a", "CONNECTED" }, { "0000000b", "CONNECTED" } } );
+
+    CHECK( idx.refresh(), "first refresh" );
+    CHECK( idx.size() == 5, "five cells indexed" );
+    CHECK( serves( idx, "0000000A01", "gnb_311_048_0000000a" ), "cell A01 is served by nodeb a" );
+    CHECK( serves( idx, "0000000B03", "gnb_311_048_0000000b" ), "cell B03 is served by nodeb b" );
+    CHECK( !idx.find( "0000000C01" ), "unknown cell is not found" );
+    cells::cell_id_t a01 = idx.get_id( "0000000A01" );
+    CHECK( a01 != cells::NO_CELL && idx.find( a01 ) == idx.find( "0000000A01" ), "interned id finds the same nodeb" );
+    unsigned long gen = idx.get_generation();
+
+    // nothing changed: only the list is fetched, nothing is published
+    CHECK( idx.refresh(), "unchanged refresh" );
+    CHECK( get_hits( fetches( "0000000a" ) ) == 1 && get_hits( fetches( "0000000b" ) ) == 1, "no nodeb fetched again" );
+    CHECK( idx.get_generation() == gen, "no new snapshot" );
+
+    // a third nodeb appears: only it is fetched
+    put_nodeb( "0000000c", 1 );
+    put_list( { { "0000000a", "CONNECTED" }, { "0000000b", "CONNECTED" }, { "0000000c", "CONNECTED" } } );
+    CHECK( idx.refresh(), "refresh with a new nodeb" );
+    CHECK( get_hits( fetches( "0000000c" ) ) == 1 && get_hits( fetches( "0000000a" ) ) == 1, "only the new nodeb fetched" );
+    CHECK( serves( idx, "0000000C01", "gnb_311_048_0000000c" ), "new cell C01 is served" );
+    CHECK( idx.get_id( "0000000A01" ) == a01, "cell ids are kept across refreshes" );
+
+    // nodeb b reconnects with one cell fewer: only it is fetched
+    put_nodeb( "0000000b", 2 );
+    put_list( { { "0000000a", "CONNECTED" }, { "0000000b", "DISCONNECTED" }, { "0000000c", "CONNECTED" } } );
+    CHECK( idx.refresh(), "refresh with a reconnected nodeb" );
+    CHECK( get_hits( fetches( "0000000b" ) ) == 2 && get_hits( fetches( "0000000a" ) ) == 1, "only the changed nodeb fetched" );
+    CHECK( !idx.find( "0000000B03" ) && serves( idx, "0000000B02", "gnb_311_048_0000000b" ), "dropped cell is gone" );
+
+    // nodeb a is removed
+    put_list( { { "0000000b", "DISCONNECTED" }, { "0000000c", "CONNECTED" } } );
+    CHECK( idx.refresh(), "refresh with a removed nodeb" );
+    CHECK( !idx.find( a01 ) && idx.size() == 3, "cells of the removed nodeb are gone" );
+
+    // a nodeb that cannot be fetched is tried again on the next refresh
+    put_list( { { "0000000b", "DISCONNECTED" }, { "0000000c", "CONNECTED" }, { "0000000d", "CONNECTED" } } );
+    CHECK( !idx.refresh(), "refresh with a missing nodeb fails" );
+    put_nodeb( "0000000d", 1 );
+    CHECK( idx.refresh() && serves( idx, "0000000D01", "gnb_311_048_0000000d" ), "missing nodeb picked up on the next refresh" );
+
+    // a cell added to a nodeb that stays connected: the list is unchanged, only a full refresh sees it
+    put_nodeb( "0000000c", 2 );
+    CHECK( idx.refresh() && !idx.find( "0000000C02" ), "new cell of a connected nodeb not seen by a delta refresh" );
+    CHECK( idx.refresh( true ) && serves( idx, "0000000C02", "gnb_311_048_0000000c" ), "new cell seen by a full refresh" );
+
+    // E2 Manager down: the index is kept
+    set_body( "/v1/nodeb/states", "" );
+    size_t before = idx.size();
+    CHECK( !idx.refresh() && idx.size() == before, "index kept while E2 Manager fails" );
+
+    // the background refresher picks up a change, readers keep going meanwhile
+    put_nodeb( "0000000e", 2 );
+    put_list( { { "0000000c", "CONNECTED" }, { "0000000d", "CONNECTED" }, { "0000000e", "CONNECTED" } } );
+    idx.start();
+    idx.request_refresh();
+    long lookups = 0;
+    auto deadline = chrono::steady_clock::now() + chrono::seconds( 5 );
+    while( !serves( idx, "0000000E02", "gnb_311_048_0000000e" ) && chrono::steady_clock::now() < deadline ) {
+        idx.find( "0000000C01" );
+        lookups++;
+    }
+    CHECK( serves( idx, "0000000E02", "gnb_311_048_0000000e" ), "background refresh applied the change" );
+    CHECK( !idx.find( "0000000B01" ), "background refresh dropped nodeb b" );
+
+    // a lookup for a cell new on a connected nodeb: the refresh it asks for must fetch the nodeb again
+    put_nodeb( "0000000d", 2 );
+    int d_fetches = get_hits( fetches( "0000000d" ) );
+    deadline = chrono::steady_clock::now() + chrono::seconds( 5 );
+    while( !serves( idx, "0000000D02", "gnb_311_048_0000000d" ) && chrono::steady_clock::now() < deadline ) {
+        idx.request_refresh();
+        this_thread::sleep_for( chrono::milliseconds( 10 ) );
+    }
+    CHECK( serves( idx, "0000000D02", "gnb_311_048_0000000d" ), "requested refresh picked up a cell of a connected nodeb" );
+    CHECK( get_hits( fetches( "0000000d" ) ) - d_fetches <= 3, "repeated requests are kept apart" );
+    idx.stop();
+
+    cells::index_stats_t s = idx.get_stats();
+    cout << "[INFO] refreshes=" << s.refreshes << " unchanged=" << s.unchanged << " list_fetches=" << s.list_fetches <<
+            " node_fetches=" << s.node_fetches << " swaps=" << s.swaps << " errors=" << s.errors <<
+            " lookups_during_refresh=" << lookups << endl;
+
+    srv_running = false;
+    if( errors ) {
+        cout << "[FAIL] " << errors << " checks failed" << endl;
+        return 1;
+    }
+    cout << "[OK] all checks passed" << endl;
+    return 0;
+}
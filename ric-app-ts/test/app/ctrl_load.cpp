@@ -0,0 +1,197 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2021 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	ctrl_load.cpp
+	Abstract:   Load test for the TS xApp control sender. Starts a stub RC
+                gRPC server in process (each reply is delayed to stand in for
+                the network and the RC xApp), then sends the same handover
+                decisions two ways:
+
+                    sync    one blocking call at a time, as the RMR callback used to
+                    async   submitted to control::ControlSender
+
+                and reports how long the submitting thread was held and the
+                completed requests per second. A last pass submits repeated
+                decisions for a few UEs to show them being coalesced.
+
+                Usage: ctrl_load [-n decisions] [-u ues] [-d delay_ms] [-i max_inflight] [-p port]
+
+	Date:		19 October 2026
+*/
+
+#include <unistd.h>
+#include <stdlib.h>
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <grpc/grpc.h>
+#include <grpcpp/create_channel.h>
+#include <grpcpp/security/credentials.h>
+#include <grpcpp/security/server_credentials.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include "../../ext/protobuf/rc.grpc.pb.h"
+#include "../../src/ts_xapp/control_sender.hpp"
+
+using namespace std;
+
+static int delay_ms = 2;
+static atomic<long> served( 0 );
+
+class StubServiceImpl : public rc::MsgComm::Service {
+    ::grpc::Status SendRICControlReqServiceGrpc(::grpc::ServerContext* context, const ::rc::RicControlGrpcReq* request,
+                                                ::rc::RicControlGrpcRsp* response) override {
+        if( delay_ms > 0 ) {
+            this_thread::sleep_for( chrono::milliseconds( delay_ms ) );
+        }
+        served++;
+        response->set_rspcode(0);
+        response->set_description("ACK");
+
+        return ::grpc::Status::OK;
+    }
+};
+
+static bool build( const control::request_t &req, rc::RicControlGrpcReq &msg ) {
+    msg.set_ranname( "stub_ran" );
+    msg.mutable_riccontrolheaderdata()->mutable_ueid()->mutable_gnbueid()->set_amfuengapid( stoi( req.ue_id ) );
+    msg.mutable_riccontrolmessagedata()->set_targetcellid( req.target_cell_id );
+
+    return true;
+}
+
+static double secs_since( chrono::steady_clock::time_point start ) {
+    return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+int main( int argc, char **argv ) {
+    int n = 2000;
+    int ues = 1000;
+    int port = 50071;
+    control::options_t opts;
+    int opt;
+
+    while( (opt = getopt( argc, argv, "n:u:d:i:p:" )) != -1 ) {
+        switch( opt ) {
+            case 'n':   n = atoi( optarg ); break;
+            case 'u':   ues = atoi( optarg ); break;
+            case 'd':   delay_ms = atoi( optarg ); break;
+            case 'i':   opts.max_inflight = atoi( optarg ); break;
+            case 'p':   port = atoi( optarg ); break;
+            default:
+                cerr << "usage: " << argv[0] << " [-n decisions] [-u ues] [-d delay_ms] [-i max_inflight] [-p port]\n";
+                exit( 1 );
+        }
+    }
+    if( n < 1 || ues < 1 || opts.max_inflight < 1 ) {
+        cerr << "[ERROR] decisions, ues, and max_inflight must be positive\n";
+        exit( 1 );
+    }
+
+    string address = "127.0.0.1:" + to_string( port );
+    StubServiceImpl service;
+    grpc::ServerBuilder builder;
+    builder.AddListeningPort( address, grpc::InsecureServerCredentials() );
+    builder.RegisterService( &service );
+    unique_ptr<grpc::Server> server( builder.BuildAndStart() );
+    if( !server ) {
+        cerr << "[ERROR] unable to start the stub server on " << address << endl;
+        exit( 1 );
+    }
+
+    shared_ptr<grpc::Channel> channel = grpc::CreateChannel( address, grpc::InsecureChannelCredentials() );
+    if( !channel->WaitForConnected( chrono::system_clock::now() + chrono::seconds( 5 ) ) ) {
+        cerr << "[ERROR] unable to connect to the stub server on " << address << endl;
+        exit( 1 );
+    }
+
+    cout << "[INFO] " << n << " decisions for " << ues << " UEs, server delay " << delay_ms << " ms, max in flight "
+         << opts.max_inflight << endl;
+
+    // -------- blocking, one call at a time ---------------------------------
+    unique_ptr<rc::MsgComm::Stub> stub = rc::MsgComm::NewStub( channel );
+    int errs = 0;
+    auto start = chrono::steady_clock::now();
+    for( int i = 0; i < n; i++ ) {
+        control::request_t req = { to_string( i % ues ), "cell0", "cell" + to_string( 1 + i % 9 ), control::sclock::now() };
+        rc::RicControlGrpcReq msg;
+        rc::RicControlGrpcRsp rsp;
+        grpc::ClientContext context;
+        build( req, msg );
+        if( !stub->SendRICControlReqServiceGrpc( &context, msg, &rsp ).ok() ) {
+            errs++;
+        }
+    }
+    double elapsed = secs_since( start );
+    cout << "sync    caller held " << elapsed * 1000.0 << " ms, " << (n - errs) / elapsed << " req/s, "
+         << errs << " failed" << endl;
+
+    // -------- handed to the control sender ----------------------------------
+    opts.log_each = false;
+    opts.stats_interval = 0;
+    {
+        control::ControlSender sender( channel, build, opts );
+
+        start = chrono::steady_clock::now();
+        for( int i = 0; i < n; i++ ) {
+            sender.submit( to_string( i % ues ), "cell0", "cell" + to_string( 1 + i % 9 ) );
+        }
+        double held = secs_since( start );
+        if( !sender.drain( 60000 ) ) {
+            cerr << "[ERROR] the sender did not drain in 60 seconds\n";
+            exit( 1 );
+        }
+        elapsed = secs_since( start );
+
+        control::stats_t s = sender.get_stats();
+        cout << "async   caller held " << held * 1000.0 << " ms, " << s.sent / elapsed << " req/s\n"
+             << "        " << control::ControlSender::format_stats( s ) << endl;
+        if( s.failed || s.rejected || s.sent + s.coalesced + s.dropped != s.submitted ) {
+            cerr << "[ERROR] unexpected outcome\n";
+            exit( 1 );
+        }
+    }
+
+    // -------- repeated decisions for a few UEs ------------------------------
+    {
+        control::ControlSender sender( channel, build, opts );
+
+        for( int i = 0; i < n; i++ ) {
+            sender.submit( to_string( i % 10 ), "cell0", "cell" + to_string( 1 + (i / 10) % 3 ) );
+        }
+        sender.drain( 60000 );
+
+        control::stats_t s = sender.get_stats();
+        cout << "repeat  " << control::ControlSender::format_stats( s ) << endl;
+        if( s.sent + s.coalesced + s.dropped != s.submitted ) {
+            cerr << "[ERROR] unexpected outcome\n";
+            exit( 1 );
+        }
+    }
+
+    server->Shutdown();
+
+    return 0;
+}
@@ -0,0 +1,258 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2021 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	json_bench.cpp
+	Abstract:   Throughput of the TS xApp JSON handling. Builds synthetic
+                prediction messages (one per UE, each with every cell) and
+                takes the handover decision for each of them two ways:
+
+                    string  copy to a std::string, parse into maps, scan the maps
+                            (as prediction_callback used to)
+                    insitu  parse_payload() with a reused PredictionHandler
+
+                Both start from a copy of the message in an RMR sized payload
+                buffer, as the callback would get it. Then encodes the
+                prediction request for an anomaly batch of all the UEs by
+                string concatenation into a 2048 byte payload (as before)
+                and with encode_prediction_request().
+
+                Usage: json_bench [-u ues] [-c cells] [-p passes]
+
+	Date:		19 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <rapidjson/document.h>
+
+#include "../../src/ts_xapp/ts_json.hpp"
+
+using namespace std;
+using namespace rapidjson;
+
+// the handler prediction_callback used before, kept to compare against
+struct MapPredictionHandler : public BaseReaderHandler<UTF8<>, MapPredictionHandler> {
+  unordered_map<string, int> cell_pred_down;
+  unordered_map<string, int> cell_pred_up;
+  std::string ue_id;
+  bool ue_id_found = false;
+  string curr_key = "";
+  string serving_cell_id;
+  bool down_val = true;
+
+  bool Uint(unsigned u) {
+    if ( serving_cell_id.empty() ) {
+      serving_cell_id = curr_key;
+    }
+    if (down_val) {
+      cell_pred_down[curr_key] = u;
+      down_val = false;
+    } else {
+      cell_pred_up[curr_key] = u;
+      down_val = true;
+    }
+    return true;
+  }
+  bool Key(const char* str, SizeType length, bool copy) {
+    if (!ue_id_found) {
+      ue_id = str;
+      ue_id_found = true;
+    } else {
+      curr_key = str;
+    }
+    return true;
+  }
+};
+
+static double secs_since( chrono::steady_clock::time_point start ) {
+    return chrono::duration<double>( chrono::steady_clock::now() - start ).count();
+}
+
+int main( int argc, char **argv ) {
+    int n_ues = 1000;
+    int n_cells = 10;
+    int passes = 20;
+    int opt;
+
+    while( (opt = getopt( argc, argv, "u:c:p:" )) != -1 ) {
+        switch( opt ) {
+            case 'u':   n_ues = atoi( optarg ); break;
+            case 'c':   n_cells = atoi( optarg ); break;
+            case 'p':   passes = atoi( optarg ); break;
+            default:
+                cerr << "usage: " << argv[0] << " [-u ues] [-c cells] [-p passes]\n";
+                exit( 1 );
+        }
+    }
+    if( n_ues < 1 || n_cells < 1 || passes < 1 ) {
+        cerr << "[ERROR] ues, cells, and passes must be positive\n";
+        exit( 1 );
+    }
+
+    // {"Car-17":{"310-680-200-555001":[12650,12721],...}}, every throughput is distinct
+    vector<string> msgs;
+    vector<string> ues;
+    size_t max_len = 0;
+    for( int u = 0; u < n_ues; u++ ) {
+        string m = "{\"Car-" + to_string( u ) + "\":{";
+        for( int c = 0; c < n_cells; c++ ) {
+            int cell = ( u + c ) % n_cells;
+            if( c > 0 ) {
+                m += ",";
+            }
+            m += "\"310-680-200-" + to_string( 555001 + cell ) + "\":[" +
+                 to_string( 10000 + ( u * 7919 + cell * 104729 ) % 50000 * n_cells + cell ) + "," +
+                 to_string( 5000 + cell ) + "]";
+        }
+        m += "}}";
+        msgs.push_back( m );
+        ues.push_back( "Car-" + to_string( u ) );
+        if( m.size() > max_len ) {
+            max_len = m.size();
+        }
+    }
+
+    int avail = max_len + 64;       // RMR payloads are allocated larger than the message
+    vector<char> payload( avail );
+
+    printf( "%d UEs, %d cells, %d passes, messages up to %d bytes\n", n_ues, n_cells, passes, (int) max_len );
+
+    // -------- the decisions both ways must agree ----------------------------
+    vector<string> expect( n_ues );
+    Reader reader;
+    PredictionHandler handler;
+    for( int u = 0; u < n_ues; u++ ) {
+        MapPredictionHandler mh;
+        StringStream ss( msgs[u].c_str() );
+        reader.Parse( ss, mh );
+        int best = 0;
+        for( auto it = mh.cell_pred_down.begin(); it != mh.cell_pred_down.end(); it++ ) {
+            if( best < it->second ) {
+                best = it->second;
+                expect[u] = it->first;
+            }
+        }
+
+        memcpy( payload.data(), msgs[u].data(), msgs[u].size() );
+        handler.Reset();
+        if( !parse_payload( reader, handler, payload.data(), msgs[u].size(), avail ) ||
+            handler.ue_id != mh.ue_id || handler.serving_cell_id != mh.serving_cell_id ||
+            handler.serving_cell_throughput != mh.cell_pred_down[mh.serving_cell_id] ||
+            handler.best_cell_id != expect[u] ) {
+            fprintf( stderr, "[ERROR] decision differs for UE %d\n", u );
+            exit( 1 );
+        }
+    }
+
+    // -------- copy to a string, parse into maps ------------------------------
+    long handovers = 0;
+    auto start = chrono::steady_clock::now();
+    for( int p = 0; p < passes; p++ ) {
+        for( int u = 0; u < n_ues; u++ ) {
+            int len = msgs[u].size();
+            memcpy( payload.data(), msgs[u].data(), len );
+
+            string json( payload.data(), len );
+            MapPredictionHandler mh;
+            Reader r;
+            StringStream ss( json.c_str() );
+            r.Parse( ss, mh );
+
+            unordered_map<string, int> throughput_map = mh.cell_pred_down;
+            int serving = throughput_map.find( mh.serving_cell_id )->second;
+            int best = 0;
+            string best_cell;
+            for( auto it = throughput_map.begin(); it != throughput_map.end(); it++ ) {
+                if( best < it->second ) {
+                    best = it->second;
+                    best_cell = it->first;
+                }
+            }
+            handovers += best > serving;
+        }
+    }
+    double elapsed = secs_since( start );
+    printf( "string  %10.0f msgs/s  %7.2f us/msg  (%ld handovers)\n",
+            (double) passes * n_ues / elapsed, elapsed * 1000000.0 / ( (double) passes * n_ues ), handovers );
+
+    // -------- in place, reused handler and reader ---------------------------
+    handovers = 0;
+    start = chrono::steady_clock::now();
+    for( int p = 0; p < passes; p++ ) {
+        for( int u = 0; u < n_ues; u++ ) {
+            int len = msgs[u].size();
+            memcpy( payload.data(), msgs[u].data(), len );
+
+            handler.Reset();
+            parse_payload( reader, handler, payload.data(), len, avail );
+            handovers += handler.best_throughput > handler.serving_cell_throughput;
+        }
+    }
+    elapsed = secs_since( start );
+    printf( "insitu  %10.0f msgs/s  %7.2f us/msg  (%ld handovers)\n",
+            (double) passes * n_ues / elapsed, elapsed * 1000000.0 / ( (double) passes * n_ues ), handovers );
+
+    // -------- prediction request for all the UEs -----------------------------
+    char old_payload[2048];
+    size_t old_len = 0;
+    start = chrono::steady_clock::now();
+    for( int p = 0; p < passes; p++ ) {
+        string ues_list = "[";
+        for( int i = 0; i < (int) ues.size(); i++ ) {
+            if( i == (int) ues.size() - 1 ) {
+                ues_list = ues_list + "\"" + ues.at(i) + "\"]";
+            } else {
+                ues_list = ues_list + "\"" + ues.at(i) + "\"" + ",";
+            }
+        }
+        string message_body = "{\"UEPredictionSet\": " + ues_list + "}";
+        snprintf( old_payload, sizeof( old_payload ), "%s", message_body.c_str() );
+        old_len = strlen( old_payload );
+    }
+    elapsed = secs_since( start );
+    printf( "concat  %10.2f us/request  %7d bytes sent%s\n", elapsed * 1000000.0 / passes, (int) old_len,
+            old_len == sizeof( old_payload ) - 1 ? " (truncated)" : "" );
+
+    StringBuffer body;
+    start = chrono::steady_clock::now();
+    for( int p = 0; p < passes; p++ ) {
+        encode_prediction_request( body, ues );
+    }
+    elapsed = secs_since( start );
+
+    Document d;                 // what was encoded must read back as every UE
+    d.Parse( body.GetString(), body.GetSize() );
+    if( d.HasParseError() || !d["UEPredictionSet"].IsArray() || d["UEPredictionSet"].Size() != ues.size() ) {
+        fprintf( stderr, "[ERROR] the prediction request does not hold every UE\n" );
+        exit( 1 );
+    }
+    printf( "writer  %10.2f us/request  %7d bytes sent\n", elapsed * 1000000.0 / passes, (int) body.GetSize() );
+
+    return 0;
+}
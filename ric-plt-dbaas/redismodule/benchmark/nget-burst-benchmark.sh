@@ -0,0 +1,69 @@
+#!/bin/bash
+#
+#   Copyright (c) 2018-2020 Nokia.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+
+#
+# Sends a burst of concurrent nget.noatomic commands to a local redis-server
+# and reports the latency, the CPU time used by the server and the worker pool
+# statistics.
+#
+# Usage: nget-burst-benchmark.sh [MODULE_PATH] [CLIENTS] [REQUESTS] [module arguments]
+#
+
+set -e
+
+MODULE=${1:-$(dirname "$0")/../.libs/libredismodule.so}
+CLIENTS=${2:-500}
+REQUESTS=${3:-200000}
+shift 3 || true
+PORT=${PORT:-26501}
+WORKDIR=$(mktemp -d)
+PID=
+
+cleanup()
+{
+    [ -n "$PID" ] && kill "$PID" 2>/dev/null || true
+    rm -rf "$WORKDIR"
+}
+trap cleanup EXIT
+
+cli()
+{
+    redis-cli -p "$PORT" "$@"
+}
+
+cpu_ticks()
+{
+    awk '{ print $14 + $15 }' "/proc/$PID/stat"
+}
+
+redis-server --port "$PORT" --save "" --appendonly no --dir "$WORKDIR" \
+             --maxclients $((CLIENTS + 32)) \
+             --loadmodule "$(readlink -f "$MODULE")" "$@" > "$WORKDIR/redis.log" 2>&1 &
+PID=$!
+until cli ping > /dev/null 2>&1; do sleep 0.1; done
+
+for i in $(seq 0 99); do
+    echo "SET {burst},key$i value$i"
+done | cli > /dev/null
+
+before=$(cpu_ticks)
+redis-benchmark -p "$PORT" -c "$CLIENTS" -n "$REQUESTS" nget.noatomic "{burst},*"
+after=$(cpu_ticks)
+
+echo "server cpu time: $(( (after - before) * 1000 / $(getconf CLK_TCK) )) ms"
+echo "server threads: $(ls "/proc/$PID/task" | wc -l)"
+cli ngetpool.info | paste - -
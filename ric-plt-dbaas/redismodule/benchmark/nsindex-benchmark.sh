@@ -0,0 +1,90 @@
+#!/bin/bash
+#
+#   Copyright (c) 2018-2020 Nokia.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+
+#
+# Compares nget and ndel of a small namespace next to a large neighbouring
+# namespace with and without the namespace index, and reports the memory
+# used by the index.
+#
+# Usage: nsindex-benchmark.sh [MODULE_PATH] [NEIGHBOUR_KEYS] [SMALL_KEYS] [REQUESTS]
+#
+
+set -e
+
+MODULE=${1:-$(dirname "$0")/../.libs/libredismodule.so}
+NEIGHBOUR_KEYS=${2:-10000000}
+SMALL_KEYS=${3:-100}
+REQUESTS=${4:-100}
+PORT=${PORT:-26500}
+WORKDIR=$(mktemp -d)
+PID=
+
+cleanup()
+{
+    [ -n "$PID" ] && kill "$PID" 2>/dev/null || true
+    rm -rf "$WORKDIR"
+}
+trap cleanup EXIT
+
+cli()
+{
+    redis-cli -p "$PORT" "$@"
+}
+
+used_memory()
+{
+    cli info memory | tr -d '\r' | awk -F: '/^used_memory:/ { print $2 }'
+}
+
+fill()
+{
+    awk -v ns="$1" -v n="$2" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            key = "{" ns "},key" i
+            printf "*3\r\n$3\r\nSET\r\n$%d\r\n%s\r\n$5\r\nvalue\r\n", length(key), key
+        }
+    }' | cli --pipe > /dev/null
+}
+
+run()
+{
+    local args=$1
+
+    redis-server --port "$PORT" --save "" --appendonly no --dir "$WORKDIR" \
+                 --loadmodule "$(readlink -f "$MODULE")" $args > "$WORKDIR/redis.log" 2>&1 &
+    PID=$!
+    until cli ping > /dev/null 2>&1; do sleep 0.1; done
+
+    fill neighbour "$NEIGHBOUR_KEYS"
+    fill small "$SMALL_KEYS"
+    local before
+    before=$(used_memory)
+    cli nget.atomic "{small},*" > /dev/null
+    echo "module arguments: ${args:-none}"
+    echo "  memory used by the index: $(( $(used_memory) - before )) bytes"
+    [ -n "$args" ] && cli nsindex.info | paste - - | sed 's/^/  /'
+    redis-benchmark -p "$PORT" -n "$REQUESTS" -c 1 -q nget.atomic "{small},*"
+    redis-benchmark -p "$PORT" -n "$REQUESTS" -c 1 -q nget.noatomic "{small},*"
+    redis-benchmark -p "$PORT" -n "$REQUESTS" -c 1 -q ndel.atomic "{small},*"
+
+    kill "$PID"
+    wait "$PID" 2>/dev/null || true
+    PID=
+}
+
+run ""
+run "NSINDEX"
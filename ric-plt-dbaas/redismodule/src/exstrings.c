@@ -19,12 +19,15 @@
  * platform project (RICP).
  */
 
+#define _POSIX_C_SOURCE 200809L
+
 #include "redismodule.h"
 #include <pthread.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <time.h>
 
 #ifdef __UT__
 #include "exstringsStub.h"
@@ -53,6 +56,19 @@ sends the error to the client and exit the current function if its */
 #define COUNT_STR     "COUNT"
 #define SCANARGC      5
 
+#define NSINDEX_ARG          "NSINDEX"
+#define NSINDEX_SCAN_PATTERN "{*},*"
+#define NSINDEX_BUILD_COUNT  1000
+/* Rough estimate of the radix tree bytes per indexed key in addition to the
+ * key itself, only used in the NSINDEX.INFO memory report. */
+#define NSINDEX_KEY_OVERHEAD 32
+
+#define NGET_WORKERS_ARG     "NGET_WORKERS"
+#define NGET_QUEUE_ARG       "NGET_QUEUE"
+#define DEF_NGET_WORKERS     4
+#define MAX_NGET_WORKERS     64
+#define DEF_NGET_QUEUE       1024
+
 RedisModuleString *def_count_str = NULL, *match_str = NULL, *count_str = NULL, *zero_str = NULL;
 
 typedef struct _NgetArgs {
@@ -63,8 +79,63 @@ typedef struct _NgetArgs {
 typedef struct RedisModuleBlockedClientArgs {
     RedisModuleBlockedClient *bc;
     NgetArgs nget_args;
+    long long queued_us;
 } RedisModuleBlockedClientArgs;
 
+/* nget.noatomic requests are executed by a fixed number of worker threads,
+ * which are started on the first request. The requests wait for a free worker
+ * in a bounded queue, and the requests that do not fit in the queue are
+ * rejected with an error. */
+typedef struct _NgetWorkerPoolStats {
+    long long queue_len_max;
+    unsigned long long requests;
+    unsigned long long rejected;
+    unsigned long long latency_total_us;
+    long long latency_max_us;
+} NgetWorkerPoolStats;
+
+typedef struct _NgetWorkerPool {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    long long workers;
+    long long running_workers;
+    RedisModuleBlockedClientArgs **queue;
+    long long queue_size;
+    long long queue_head;
+    long long queue_len;
+    NgetWorkerPoolStats stats;
+} NgetWorkerPool;
+
+NgetWorkerPool nget_pool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .workers = DEF_NGET_WORKERS,
+    .queue_size = DEF_NGET_QUEUE
+};
+
+/* Optional per namespace key index. SDL keys are of the form "{ns},key", and
+ * when the index is enabled the keys of database zero are kept in a dictionary
+ * per "{ns}" prefix, so that nget and ndel with a "{ns},*" pattern do not need
+ * to scan through the whole keyspace. The index is maintained from keyspace
+ * events and built with a full SCAN on the first use (or NSINDEX.REBUILD).
+ * Flushing, swapping or loading database zero does not send keyspace events
+ * for its keys, so the index is dropped then and built again on the next use. */
+typedef struct _NsIndexEntry {
+    RedisModuleDict *keys;
+    unsigned long long key_bytes;
+} NsIndexEntry;
+
+typedef struct _NsIndex {
+    bool enabled;
+    bool ready;
+    RedisModuleDict *namespaces;
+    unsigned long long keys;
+    unsigned long long key_bytes;
+    long long build_time_ms;
+} NsIndex;
+
+NsIndex ns_index = { false, false, NULL, 0, 0, 0 };
+
 void InitStaticVariable()
 {
     if (def_count_str == NULL)
@@ -210,8 +281,30 @@ typedef struct _ScanSomeState {
     RedisModuleString *key;
     RedisModuleString *count;
     long long cursor;
+    /* Set when the keys are read from the namespace index instead of SCAN */
+    size_t index_ns_len;
+    char *index_last_key;
+    size_t index_last_key_len;
 } ScanSomeState;
 
+void initScanSomeState(ScanSomeState *state, RedisModuleString *key, RedisModuleString *count)
+{
+    state->key = key;
+    state->count = count;
+    state->cursor = 0;
+    state->index_ns_len = 0;
+    state->index_last_key = NULL;
+    state->index_last_key_len = 0;
+}
+
+void freeScanSomeState(ScanSomeState *state)
+{
+    if (state->index_last_key) {
+        RedisModule_Free(state->index_last_key);
+        state->index_last_key = NULL;
+    }
+}
+
 ScannedKeys *scanSome(RedisModuleCtx* ctx, ScanSomeState* state, ExstringsStatus* status)
 {
     RedisModuleString *scanargv[SCANARGC] = {NULL};
@@ -271,6 +364,277 @@ inline void lockThreadsafeContext(RedisModuleCtx *ctx, bool using_threadsafe_con
         RedisModule_ThreadSafeContextLock(ctx);
 }
 
+/* Returns the length of the "{ns}" prefix of a key or a pattern of the form
+ * "{ns},...", or zero if there is no such prefix. */
+size_t nsIndexNamespaceLen(const char *str, size_t len)
+{
+    size_t i;
+
+    if (str == NULL || len < 3 || str[0] != '{')
+        return 0;
+    for (i = 1; i + 1 < len; i++) {
+        if (str[i] == '}' && str[i+1] == ',')
+            return i + 1;
+    }
+    return 0;
+}
+
+/* Returns the namespace prefix length if the pattern matches exactly the keys
+ * of one namespace ("{ns},*" without glob characters in ns), otherwise zero. */
+size_t nsIndexPatternNamespaceLen(RedisModuleString *pattern)
+{
+    size_t len = 0, ns_len, i;
+    const char *str = RedisModule_StringPtrLen(pattern, &len);
+
+    ns_len = nsIndexNamespaceLen(str, len);
+    if (ns_len == 0 || len != ns_len + 2 || str[len-1] != '*')
+        return 0;
+    for (i = 1; i < ns_len - 1; i++) {
+        if (str[i] == '\0' || strchr("*?[]\\", str[i]))
+            return 0;
+    }
+    return ns_len;
+}
+
+NsIndexEntry *nsIndexGetEntry(const char *ns, size_t ns_len)
+{
+    if (ns_index.namespaces == NULL)
+        return NULL;
+    return RedisModule_DictGetC(ns_index.namespaces, (void *)ns, ns_len, NULL);
+}
+
+void nsIndexAdd(const char *key, size_t len)
+{
+    size_t ns_len = nsIndexNamespaceLen(key, len);
+    if (ns_len == 0 || ns_index.namespaces == NULL)
+        return;
+
+    NsIndexEntry *entry = nsIndexGetEntry(key, ns_len);
+    if (entry == NULL) {
+        entry = RedisModule_Alloc(sizeof(NsIndexEntry));
+        if (entry == NULL)
+            return;
+        entry->keys = RedisModule_CreateDict(NULL);
+        entry->key_bytes = 0;
+        RedisModule_DictSetC(ns_index.namespaces, (void *)key, ns_len, entry);
+    }
+    if (RedisModule_DictSetC(entry->keys, (void *)key, len, NULL) == REDISMODULE_OK) {
+        entry->key_bytes += len;
+        ns_index.keys++;
+        ns_index.key_bytes += len;
+    }
+}
+
+void nsIndexFreeEntry(const char *ns, size_t ns_len, NsIndexEntry *entry)
+{
+    ns_index.keys -= RedisModule_DictSize(entry->keys);
+    ns_index.key_bytes -= entry->key_bytes;
+    RedisModule_DictDelC(ns_index.namespaces, (void *)ns, ns_len, NULL);
+    RedisModule_FreeDict(NULL, entry->keys);
+    RedisModule_Free(entry);
+}
+
+void nsIndexRemove(const char *key, size_t len)
+{
+    size_t ns_len = nsIndexNamespaceLen(key, len);
+    if (ns_len == 0)
+        return;
+
+    NsIndexEntry *entry = nsIndexGetEntry(key, ns_len);
+    if (entry == NULL)
+        return;
+    if (RedisModule_DictDelC(entry->keys, (void *)key, len, NULL) == REDISMODULE_OK) {
+        entry->key_bytes -= len;
+        ns_index.keys--;
+        ns_index.key_bytes -= len;
+    }
+    if (RedisModule_DictSize(entry->keys) == 0)
+        nsIndexFreeEntry(key, ns_len, entry);
+}
+
+void nsIndexClear(void)
+{
+    ns_index.ready = false;
+    if (ns_index.namespaces == NULL)
+        return;
+
+    RedisModuleDictIter *iter = RedisModule_DictIteratorStartC(ns_index.namespaces, "^", NULL, 0);
+    NsIndexEntry *entry;
+    while (RedisModule_DictNextC(iter, NULL, (void **)&entry) != NULL) {
+        RedisModule_FreeDict(NULL, entry->keys);
+        RedisModule_Free(entry);
+    }
+    RedisModule_DictIteratorStop(iter);
+    RedisModule_FreeDict(NULL, ns_index.namespaces);
+    ns_index.namespaces = NULL;
+    ns_index.keys = 0;
+    ns_index.key_bytes = 0;
+}
+
+/* Builds the index from scratch with a full SCAN. Keyspace events are not
+ * tracked while the index is not ready, so this needs to be executed
+ * atomically (in the main thread or with the thread safe context locked). */
+void nsIndexBuild(RedisModuleCtx *ctx, ExstringsStatus *status)
+{
+    ScanSomeState scan_state;
+    ScannedKeys *scanned_keys;
+    long long start = RedisModule_Milliseconds();
+
+    nsIndexClear();
+    ns_index.namespaces = RedisModule_CreateDict(NULL);
+    initScanSomeState(&scan_state,
+                      RedisModule_CreateString(ctx, NSINDEX_SCAN_PATTERN, strlen(NSINDEX_SCAN_PATTERN)),
+                      RedisModule_CreateStringFromLongLong(ctx, NSINDEX_BUILD_COUNT));
+    do {
+        *status = EXSTRINGS_STATUS_NOT_SET;
+        scanned_keys = scanSome(ctx, &scan_state, status);
+        if (*status != EXSTRINGS_STATUS_NO_ERRORS)
+            break;
+        else if (scanned_keys == NULL)
+            continue;
+
+        size_t i, len;
+        for (i = 0; i < scanned_keys->len; i++) {
+            const char *key = RedisModule_StringPtrLen(scanned_keys->keys[i], &len);
+            nsIndexAdd(key, len);
+        }
+        freeScannedKeys(ctx, scanned_keys);
+    } while (scan_state.cursor != 0);
+
+    RedisModule_FreeString(ctx, scan_state.key);
+    RedisModule_FreeString(ctx, scan_state.count);
+    if (*status == EXSTRINGS_STATUS_NO_ERRORS) {
+        ns_index.ready = true;
+        ns_index.build_time_ms = RedisModule_Milliseconds() - start;
+    }
+}
+
+/* Switches the scan state to read the keys from the namespace index if the
+ * index is enabled and the pattern selects exactly one namespace. */
+void nsIndexPrepareScan(RedisModuleCtx *ctx, ScanSomeState *state, ExstringsStatus *status)
+{
+    *status = EXSTRINGS_STATUS_NO_ERRORS;
+    if (!ns_index.enabled || RedisModule_GetSelectedDb(ctx) != 0)
+        return;
+
+    size_t ns_len = nsIndexPatternNamespaceLen(state->key);
+    if (ns_len == 0)
+        return;
+
+    if (!ns_index.ready) {
+        nsIndexBuild(ctx, status);
+        if (*status != EXSTRINGS_STATUS_NO_ERRORS)
+            return;
+    }
+    state->index_ns_len = ns_len;
+}
+
+/* Index counterpart of scanSome(). Reads the next COUNT keys of the namespace
+ * following the last returned key, which keeps the iteration valid even when
+ * the index is modified between the calls. */
+ScannedKeys *nsIndexScanSome(RedisModuleCtx *ctx, ScanSomeState *state, ExstringsStatus *status)
+{
+    const char *ns = RedisModule_StringPtrLen(state->key, NULL);
+    NsIndexEntry *entry = nsIndexGetEntry(ns, state->index_ns_len);
+    long long count = DEF_COUNT;
+    uint64_t size;
+
+    *status = EXSTRINGS_STATUS_NO_ERRORS;
+    state->cursor = 0;
+    if (entry == NULL || (size = RedisModule_DictSize(entry->keys)) == 0)
+        return NULL;
+
+    RedisModule_StringToLongLong(state->count, &count);
+    if ((uint64_t)count > size)
+        count = size;
+
+    ScannedKeys *scanned_keys = allocScannedKeys(count);
+    if (scanned_keys == NULL) {
+        RedisModule_ReplyWithError(ctx,"-ERR Out of memory");
+        *status = EXSTRINGS_STATUS_ERROR_AND_REPLY_SENT;
+        return NULL;
+    }
+
+    RedisModuleDictIter *iter;
+    if (state->index_last_key)
+        iter = RedisModule_DictIteratorStartC(entry->keys, ">", state->index_last_key, state->index_last_key_len);
+    else
+        iter = RedisModule_DictIteratorStartC(entry->keys, "^", NULL, 0);
+
+    size_t len = 0, keylen;
+    char *key;
+    while (len < (size_t)count && (key = RedisModule_DictNextC(iter, &keylen, NULL)) != NULL)
+        scanned_keys->keys[len++] = RedisModule_CreateString(ctx, key, keylen);
+    RedisModule_DictIteratorStop(iter);
+
+    scanned_keys->len = len;
+    if (len == 0) {
+        freeScannedKeys(ctx, scanned_keys);
+        return NULL;
+    }
+
+    const char *last_key = RedisModule_StringPtrLen(scanned_keys->keys[len-1], &keylen);
+    if (state->index_last_key)
+        RedisModule_Free(state->index_last_key);
+    state->index_last_key = RedisModule_Alloc(keylen);
+    if (state->index_last_key == NULL) {
+        freeScannedKeys(ctx, scanned_keys);
+        RedisModule_ReplyWithError(ctx,"-ERR Out of memory");
+        *status = EXSTRINGS_STATUS_ERROR_AND_REPLY_SENT;
+        return NULL;
+    }
+    memcpy(state->index_last_key, last_key, keylen);
+    state->index_last_key_len = keylen;
+    if (len == (size_t)count)
+        state->cursor = 1;
+    return scanned_keys;
+}
+
+ScannedKeys *scanSomeKeys(RedisModuleCtx* ctx, ScanSomeState* state, ExstringsStatus* status)
+{
+    if (state->index_ns_len)
+        return nsIndexScanSome(ctx, state, status);
+    return scanSome(ctx, state, status);
+}
+
+int NsIndex_KeyspaceEvent(RedisModuleCtx *ctx, int type, const char *event, RedisModuleString *key)
+{
+    REDISMODULE_NOT_USED(type);
+    size_t len;
+
+    if (!ns_index.ready || RedisModule_GetSelectedDb(ctx) != 0)
+        return REDISMODULE_OK;
+
+    const char *keystr = RedisModule_StringPtrLen(key, &len);
+    if (!strcmp(event, "del") ||
+        !strcmp(event, "expired") ||
+        !strcmp(event, "evicted") ||
+        !strcmp(event, "rename_from") ||
+        !strcmp(event, "move_from"))
+        nsIndexRemove(keystr, len);
+    else
+        nsIndexAdd(keystr, len);
+    return REDISMODULE_OK;
+}
+
+void NsIndex_ServerEvent(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent, void *data)
+{
+    REDISMODULE_NOT_USED(ctx);
+
+    if (eid.id == REDISMODULE_EVENT_FLUSHDB) {
+        RedisModuleFlushInfo *fi = data;
+        if (subevent != REDISMODULE_SUBEVENT_FLUSHDB_START || (fi->dbnum != -1 && fi->dbnum != 0))
+            return;
+    } else if (eid.id == REDISMODULE_EVENT_SWAPDB) {
+        RedisModuleSwapDbInfo *si = data;
+        if (si->dbnum_first != 0 && si->dbnum_second != 0)
+            return;
+    } else if (eid.id != REDISMODULE_EVENT_LOADING) {
+        return;
+    }
+    nsIndexClear();
+}
+
 void multiPubCommand(RedisModuleCtx *ctx, PubParams* pubParams)
 {
     RedisModuleCallReply *reply = NULL;
@@ -719,16 +1083,22 @@ int Nget_RedisCommand(RedisModuleCtx *ctx, NgetArgs* nget_args, bool using_threa
     ScanSomeState scan_state;
     ScannedKeys *scanned_keys;
 
-    scan_state.key = nget_args->key;
-    scan_state.count = nget_args->count;
-    scan_state.cursor = 0;
+    initScanSomeState(&scan_state, nget_args->key, nget_args->count);
+
+    if (ns_index.enabled) {
+        lockThreadsafeContext(ctx, using_threadsafe_context);
+        nsIndexPrepareScan(ctx, &scan_state, &status);
+        unlockThreadsafeContext(ctx, using_threadsafe_context);
+        if (status != EXSTRINGS_STATUS_NO_ERRORS)
+            return REDISMODULE_ERR;
+    }
 
     RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
     do {
         lockThreadsafeContext(ctx, using_threadsafe_context);
 
         status = EXSTRINGS_STATUS_NOT_SET;
-        scanned_keys = scanSome(ctx, &scan_state, &status);
+        scanned_keys = scanSomeKeys(ctx, &scan_state, &status);
 
         if (status != EXSTRINGS_STATUS_NO_ERRORS) {
             unlockThreadsafeContext(ctx, using_threadsafe_context);
@@ -765,17 +1135,21 @@ int Nget_RedisCommand(RedisModuleCtx *ctx, NgetArgs* nget_args, bool using_threa
         freeScannedKeys(ctx, scanned_keys);
     } while (scan_state.cursor != 0);
 
+    freeScanSomeState(&scan_state);
     RedisModule_ReplySetArrayLength(ctx,replylen);
     return ret;
 }
 
-/* The thread entry point that actually executes the blocking part
- * of the command nget.noatomic
- */
-void *NGet_NoAtomic_ThreadMain(void *arg)
+long long monotonicMicroseconds(void)
 {
-    pthread_detach(pthread_self());
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
 
+/* Executes the blocking part of the command nget.noatomic */
+void NGet_NoAtomic_Execute(void *arg)
+{
     RedisModuleBlockedClientArgs *bca = arg;
     RedisModuleBlockedClient *bc = bca->bc;
     RedisModuleCtx *ctx = RedisModule_GetThreadSafeContext(bc);
@@ -784,13 +1158,114 @@ void *NGet_NoAtomic_ThreadMain(void *arg)
     RedisModule_FreeThreadSafeContext(ctx);
     RedisModule_UnblockClient(bc, NULL);
     RedisModule_Free(bca);
+}
+
+/* Configures the worker pool. Must be called before the first request. */
+void ngetWorkerPoolInit(long long workers, long long queue_size)
+{
+    pthread_mutex_lock(&nget_pool.lock);
+    nget_pool.workers = workers;
+    nget_pool.queue_size = queue_size;
+    if (nget_pool.queue) {
+        RedisModule_Free(nget_pool.queue);
+        nget_pool.queue = NULL;
+    }
+    nget_pool.running_workers = 0;
+    nget_pool.queue_head = 0;
+    nget_pool.queue_len = 0;
+    memset(&nget_pool.stats, 0, sizeof(nget_pool.stats));
+    pthread_mutex_unlock(&nget_pool.lock);
+}
+
+/* Takes the oldest queued request. If 'wait' is set, waits until there is
+ * one, otherwise returns NULL when the queue is empty. */
+RedisModuleBlockedClientArgs *ngetWorkerPoolPop(bool wait)
+{
+    RedisModuleBlockedClientArgs *bca = NULL;
+
+    pthread_mutex_lock(&nget_pool.lock);
+    while (wait && nget_pool.queue_len == 0)
+        pthread_cond_wait(&nget_pool.cond, &nget_pool.lock);
+    if (nget_pool.queue_len > 0) {
+        bca = nget_pool.queue[nget_pool.queue_head];
+        nget_pool.queue_head = (nget_pool.queue_head + 1) % nget_pool.queue_size;
+        nget_pool.queue_len--;
+    }
+    pthread_mutex_unlock(&nget_pool.lock);
+    return bca;
+}
+
+void ngetWorkerPoolRequestDone(long long queued_us)
+{
+    long long latency_us = monotonicMicroseconds() - queued_us;
+
+    pthread_mutex_lock(&nget_pool.lock);
+    nget_pool.stats.requests++;
+    nget_pool.stats.latency_total_us += latency_us;
+    if (latency_us > nget_pool.stats.latency_max_us)
+        nget_pool.stats.latency_max_us = latency_us;
+    pthread_mutex_unlock(&nget_pool.lock);
+}
+
+/* The worker thread entry point */
+void *NGet_NoAtomic_WorkerMain(void *arg)
+{
+    REDISMODULE_NOT_USED(arg);
+    pthread_detach(pthread_self());
+
+    for (;;) {
+        RedisModuleBlockedClientArgs *bca = ngetWorkerPoolPop(true);
+        long long queued_us = bca->queued_us;
+        NGet_NoAtomic_Execute(bca);
+        ngetWorkerPoolRequestDone(queued_us);
+    }
     return NULL;
 }
 
+/* Starts the worker threads when called the first time. Called only from
+ * the main thread. */
+int ngetWorkerPoolStart(void)
+{
+    pthread_t tid;
+
+    if (nget_pool.running_workers > 0)
+        return REDISMODULE_OK;
+
+    if (nget_pool.queue == NULL) {
+        nget_pool.queue = RedisModule_Alloc(sizeof(RedisModuleBlockedClientArgs *) * nget_pool.queue_size);
+        if (nget_pool.queue == NULL)
+            return REDISMODULE_ERR;
+    }
+    while (nget_pool.running_workers < nget_pool.workers &&
+           pthread_create(&tid, NULL, NGet_NoAtomic_WorkerMain, NULL) == 0)
+        nget_pool.running_workers++;
+
+    return nget_pool.running_workers > 0 ? REDISMODULE_OK : REDISMODULE_ERR;
+}
+
+int ngetWorkerPoolPush(RedisModuleBlockedClientArgs *bca)
+{
+    int ret = REDISMODULE_ERR;
+
+    bca->queued_us = monotonicMicroseconds();
+    pthread_mutex_lock(&nget_pool.lock);
+    if (nget_pool.queue_len < nget_pool.queue_size) {
+        nget_pool.queue[(nget_pool.queue_head + nget_pool.queue_len) % nget_pool.queue_size] = bca;
+        nget_pool.queue_len++;
+        if (nget_pool.queue_len > nget_pool.stats.queue_len_max)
+            nget_pool.stats.queue_len_max = nget_pool.queue_len;
+        pthread_cond_signal(&nget_pool.cond);
+        ret = REDISMODULE_OK;
+    } else {
+        nget_pool.stats.rejected++;
+    }
+    pthread_mutex_unlock(&nget_pool.lock);
+    return ret;
+}
+
 int NGet_NoAtomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 {
     RedisModule_AutoMemory(ctx);
-    pthread_t tid;
 
     InitStaticVariable();
 
@@ -815,17 +1290,86 @@ int NGet_NoAtomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, in
     bca->bc = bc;
 
     /* Now that we setup a blocking client, we need to pass the control
-     * to the thread. However we need to pass arguments to the thread:
+     * to a worker thread. However we need to pass arguments to the thread:
      * the reference to the blocked client handle. */
-    if (pthread_create(&tid,NULL,NGet_NoAtomic_ThreadMain,bca) != 0) {
+    if (ngetWorkerPoolStart() != REDISMODULE_OK) {
         RedisModule_AbortBlock(bc);
         RedisModule_Free(bca);
         return RedisModule_ReplyWithError(ctx,"-ERR Can't start thread");
     }
+    if (ngetWorkerPoolPush(bca) != REDISMODULE_OK) {
+        RedisModule_AbortBlock(bc);
+        RedisModule_Free(bca);
+        return RedisModule_ReplyWithError(ctx,"-BUSY nget.noatomic queue is full");
+    }
 
     return REDISMODULE_OK;
 }
 
+static void ngetWorkerPoolSnapshot(long long *queue_len, NgetWorkerPoolStats *stats)
+{
+    pthread_mutex_lock(&nget_pool.lock);
+    *queue_len = nget_pool.queue_len;
+    *stats = nget_pool.stats;
+    pthread_mutex_unlock(&nget_pool.lock);
+}
+
+int NGetPoolInfo_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
+{
+    REDISMODULE_NOT_USED(argv);
+    if (argc != 1)
+        return RedisModule_WrongArity(ctx);
+
+    long long queue_len;
+    NgetWorkerPoolStats stats;
+    ngetWorkerPoolSnapshot(&queue_len, &stats);
+
+    RedisModule_ReplyWithArray(ctx, 16);
+    RedisModule_ReplyWithSimpleString(ctx, "workers");
+    RedisModule_ReplyWithLongLong(ctx, nget_pool.running_workers);
+    RedisModule_ReplyWithSimpleString(ctx, "queue_size");
+    RedisModule_ReplyWithLongLong(ctx, nget_pool.queue_size);
+    RedisModule_ReplyWithSimpleString(ctx, "queue_depth");
+    RedisModule_ReplyWithLongLong(ctx, queue_len);
+    RedisModule_ReplyWithSimpleString(ctx, "queue_depth_max");
+    RedisModule_ReplyWithLongLong(ctx, stats.queue_len_max);
+    RedisModule_ReplyWithSimpleString(ctx, "requests");
+    RedisModule_ReplyWithLongLong(ctx, stats.requests);
+    RedisModule_ReplyWithSimpleString(ctx, "rejected");
+    RedisModule_ReplyWithLongLong(ctx, stats.rejected);
+    RedisModule_ReplyWithSimpleString(ctx, "latency_avg_us");
+    RedisModule_ReplyWithLongLong(ctx, stats.requests ? stats.latency_total_us / stats.requests : 0);
+    RedisModule_ReplyWithSimpleString(ctx, "latency_max_us");
+    RedisModule_ReplyWithLongLong(ctx, stats.latency_max_us);
+    return REDISMODULE_OK;
+}
+
+/* INFO callback, the same figures as NGETPOOL.INFO in the exstrings_ngetpool
+ * section of INFO (INFO exstrings, INFO modules or INFO everything). In a
+ * crash report the pool lock is not taken, the crashing thread may hold it. */
+void Exstrings_InfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report)
+{
+    long long queue_len;
+    NgetWorkerPoolStats stats;
+
+    if (for_crash_report) {
+        queue_len = nget_pool.queue_len;
+        stats = nget_pool.stats;
+    } else {
+        ngetWorkerPoolSnapshot(&queue_len, &stats);
+    }
+
+    RedisModule_InfoAddSection(ctx, "ngetpool");
+    RedisModule_InfoAddFieldLongLong(ctx, "workers", nget_pool.running_workers);
+    RedisModule_InfoAddFieldLongLong(ctx, "queue_size", nget_pool.queue_size);
+    RedisModule_InfoAddFieldLongLong(ctx, "queue_depth", queue_len);
+    RedisModule_InfoAddFieldLongLong(ctx, "queue_depth_max", stats.queue_len_max);
+    RedisModule_InfoAddFieldLongLong(ctx, "requests", stats.requests);
+    RedisModule_InfoAddFieldLongLong(ctx, "rejected", stats.rejected);
+    RedisModule_InfoAddFieldLongLong(ctx, "latency_avg_us", stats.requests ? stats.latency_total_us / stats.requests : 0);
+    RedisModule_InfoAddFieldLongLong(ctx, "latency_max_us", stats.latency_max_us);
+}
+
 int NGet_Atomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
 {
     RedisModule_AutoMemory(ctx);
@@ -856,13 +1400,14 @@ int NDel_Atomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     if (argc != 2)
         return RedisModule_WrongArity(ctx);
 
-    scan_state.key = argv[1];
-    scan_state.count = def_count_str;
-    scan_state.cursor = 0;
+    initScanSomeState(&scan_state, argv[1], def_count_str);
+    nsIndexPrepareScan(ctx, &scan_state, &status);
+    if (status != EXSTRINGS_STATUS_NO_ERRORS)
+        return REDISMODULE_ERR;
 
     do {
         status = EXSTRINGS_STATUS_NOT_SET;
-        scanned_keys = scanSome(ctx, &scan_state, &status);
+        scanned_keys = scanSomeKeys(ctx, &scan_state, &status);
 
         if (status != EXSTRINGS_STATUS_NO_ERRORS) {
             ret = REDISMODULE_ERR;
@@ -886,6 +1431,17 @@ int NDel_Atomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
         freeScannedKeys(ctx, scanned_keys);
     } while (scan_state.cursor != 0);
 
+    /* The keyspace events of UNLINK remove the deleted keys from the index, but
+     * the keys that did not exist anymore (for example after FLUSHALL) are
+     * still there. Everything in the namespace is gone now, so drop it. */
+    if (ret == REDISMODULE_OK && scan_state.index_ns_len) {
+        const char *ns = RedisModule_StringPtrLen(scan_state.key, NULL);
+        NsIndexEntry *entry = nsIndexGetEntry(ns, scan_state.index_ns_len);
+        if (entry)
+            nsIndexFreeEntry(ns, scan_state.index_ns_len, entry);
+    }
+    freeScanSomeState(&scan_state);
+
     if (ret == REDISMODULE_OK) {
         RedisModule_ReplyWithLongLong(ctx, replylen);
     }
@@ -893,15 +1449,108 @@ int NDel_Atomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int
     return ret;
 }
 
-/* This function must be present on each Redis module. It is used in order to
- * register the commands into the Redis server. */
-int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
+int NsIndexInfo_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
+{
+    REDISMODULE_NOT_USED(argv);
+    if (argc != 1)
+        return RedisModule_WrongArity(ctx);
+
+    unsigned long long namespaces = ns_index.namespaces ? RedisModule_DictSize(ns_index.namespaces) : 0;
+
+    RedisModule_ReplyWithArray(ctx, 14);
+    RedisModule_ReplyWithSimpleString(ctx, "enabled");
+    RedisModule_ReplyWithLongLong(ctx, ns_index.enabled);
+    RedisModule_ReplyWithSimpleString(ctx, "ready");
+    RedisModule_ReplyWithLongLong(ctx, ns_index.ready);
+    RedisModule_ReplyWithSimpleString(ctx, "namespaces");
+    RedisModule_ReplyWithLongLong(ctx, namespaces);
+    RedisModule_ReplyWithSimpleString(ctx, "keys");
+    RedisModule_ReplyWithLongLong(ctx, ns_index.keys);
+    RedisModule_ReplyWithSimpleString(ctx, "key_bytes");
+    RedisModule_ReplyWithLongLong(ctx, ns_index.key_bytes);
+    RedisModule_ReplyWithSimpleString(ctx, "estimated_memory_bytes");
+    RedisModule_ReplyWithLongLong(ctx, ns_index.key_bytes +
+                                       (ns_index.keys + namespaces) * NSINDEX_KEY_OVERHEAD +
+                                       namespaces * sizeof(NsIndexEntry));
+    RedisModule_ReplyWithSimpleString(ctx, "build_time_ms");
+    RedisModule_ReplyWithLongLong(ctx, ns_index.build_time_ms);
+    return REDISMODULE_OK;
+}
+
+int NsIndexRebuild_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
+{
     REDISMODULE_NOT_USED(argv);
-    REDISMODULE_NOT_USED(argc);
+    ExstringsStatus status = EXSTRINGS_STATUS_NOT_SET;
 
+    if (argc != 1)
+        return RedisModule_WrongArity(ctx);
+    if (!ns_index.enabled)
+        return RedisModule_ReplyWithError(ctx, "ERR namespace index is not enabled");
+
+    InitStaticVariable();
+    nsIndexBuild(ctx, &status);
+    if (status != EXSTRINGS_STATUS_NO_ERRORS)
+        return REDISMODULE_ERR;
+    return RedisModule_ReplyWithSimpleString(ctx, "OK");
+}
+
+int readModuleArgs(RedisModuleString **argv, int argc)
+{
+    int i;
+    long long workers = DEF_NGET_WORKERS, queue_size = DEF_NGET_QUEUE;
+
+    ns_index.enabled = false;
+    for (i = 0; i < argc; i++) {
+        const char *arg = RedisModule_StringPtrLen(argv[i], NULL);
+        if (arg == NULL) {
+            return REDISMODULE_ERR;
+        } else if (!strcasecmp(arg, NSINDEX_ARG)) {
+            ns_index.enabled = true;
+        } else if (!strcasecmp(arg, NGET_WORKERS_ARG) && i + 1 < argc) {
+            if (RedisModule_StringToLongLong(argv[++i], &workers) != REDISMODULE_OK ||
+                workers < 1 || workers > MAX_NGET_WORKERS)
+                return REDISMODULE_ERR;
+        } else if (!strcasecmp(arg, NGET_QUEUE_ARG) && i + 1 < argc) {
+            if (RedisModule_StringToLongLong(argv[++i], &queue_size) != REDISMODULE_OK ||
+                queue_size < 1)
+                return REDISMODULE_ERR;
+        } else {
+            return REDISMODULE_ERR;
+        }
+    }
+    ngetWorkerPoolInit(workers, queue_size);
+    return REDISMODULE_OK;
+}
+
+/* This function must be present on each Redis module. It is used in order to
+ * register the commands into the Redis server.
+ *
+ * Module arguments:
+ *   NSINDEX           maintain the per namespace key index used by nget and ndel
+ *   NGET_WORKERS <n>  number of nget.noatomic worker threads (default 4)
+ *   NGET_QUEUE <n>    maximum number of queued nget.noatomic requests (default 1024) */
+int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
     if (RedisModule_Init(ctx,"exstrings",1,REDISMODULE_APIVER_1)
         == REDISMODULE_ERR) return REDISMODULE_ERR;
 
+    nsIndexClear();
+    if (readModuleArgs(argv, argc) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (ns_index.enabled &&
+        (RedisModule_SubscribeToKeyspaceEvents(ctx, REDISMODULE_NOTIFY_ALL,
+         NsIndex_KeyspaceEvent) == REDISMODULE_ERR ||
+         RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_FlushDB,
+         NsIndex_ServerEvent) == REDISMODULE_ERR ||
+         RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_Loading,
+         NsIndex_ServerEvent) == REDISMODULE_ERR ||
+         RedisModule_SubscribeToServerEvent(ctx, RedisModuleEvent_SwapDB,
+         NsIndex_ServerEvent) == REDISMODULE_ERR))
+        return REDISMODULE_ERR;
+
+    if (RedisModule_RegisterInfoFunc(ctx, Exstrings_InfoFunc) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
     if (RedisModule_CreateCommand(ctx,"setie",
         SetIE_RedisCommand,"write deny-oom",1,1,1) == REDISMODULE_ERR)
         return REDISMODULE_ERR;
@@ -982,5 +1631,17 @@ int RedisModule_OnLoad(RedisModuleCtx *ctx, RedisModuleString **argv, int argc)
         DelNEPub_RedisCommand,"write deny-oom",1,1,1) == REDISMODULE_ERR)
         return REDISMODULE_ERR;
 
+    if (RedisModule_CreateCommand(ctx,"ngetpool.info",
+        NGetPoolInfo_RedisCommand,"readonly fast",0,0,0) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx,"nsindex.info",
+        NsIndexInfo_RedisCommand,"readonly fast",0,0,0) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
+    if (RedisModule_CreateCommand(ctx,"nsindex.rebuild",
+        NsIndexRebuild_RedisCommand,"readonly",0,0,0) == REDISMODULE_ERR)
+        return REDISMODULE_ERR;
+
     return REDISMODULE_OK;
 }
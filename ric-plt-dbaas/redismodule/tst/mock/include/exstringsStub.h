@@ -24,6 +24,9 @@
 
 
 #include "redismodule.h"
+#include <stdbool.h>
+
+struct RedisModuleBlockedClientArgs;
 
 int setStringGenericCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc, const int flag);
 int SetIE_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
@@ -48,6 +51,14 @@ int DelNEPub_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int arg
 int NDel_Atomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int NGet_Atomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int NGet_NoAtomic_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
-void *NGet_NoAtomic_ThreadMain(void *arg);
+void NGet_NoAtomic_Execute(void *arg);
+void ngetWorkerPoolInit(long long workers, long long queue_size);
+struct RedisModuleBlockedClientArgs *ngetWorkerPoolPop(bool wait);
+int NGetPoolInfo_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+void Exstrings_InfoFunc(RedisModuleInfoCtx *ctx, int for_crash_report);
+int NsIndexInfo_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int NsIndexRebuild_RedisCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int NsIndex_KeyspaceEvent(RedisModuleCtx *ctx, int type, const char *event, RedisModuleString *key);
+void NsIndex_ServerEvent(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent, void *data);
 
 #endif
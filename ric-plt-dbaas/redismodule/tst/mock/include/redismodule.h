@@ -54,6 +54,18 @@
 #define REDISMODULE_REPLY_ARRAY 3
 #define REDISMODULE_REPLY_NULL 4
 
+/* Keyspace changes notification classes. */
+#define REDISMODULE_NOTIFY_GENERIC (1<<2)     /* g */
+#define REDISMODULE_NOTIFY_STRING (1<<3)      /* $ */
+#define REDISMODULE_NOTIFY_LIST (1<<4)        /* l */
+#define REDISMODULE_NOTIFY_SET (1<<5)         /* s */
+#define REDISMODULE_NOTIFY_HASH (1<<6)        /* h */
+#define REDISMODULE_NOTIFY_ZSET (1<<7)        /* z */
+#define REDISMODULE_NOTIFY_EXPIRED (1<<8)     /* x */
+#define REDISMODULE_NOTIFY_EVICTED (1<<9)     /* e */
+#define REDISMODULE_NOTIFY_STREAM (1<<10)     /* t */
+#define REDISMODULE_NOTIFY_ALL (REDISMODULE_NOTIFY_GENERIC | REDISMODULE_NOTIFY_STRING | REDISMODULE_NOTIFY_LIST | REDISMODULE_NOTIFY_SET | REDISMODULE_NOTIFY_HASH | REDISMODULE_NOTIFY_ZSET | REDISMODULE_NOTIFY_EXPIRED | REDISMODULE_NOTIFY_EVICTED | REDISMODULE_NOTIFY_STREAM)      /* A */
+
 /* Postponed array length. */
 #define REDISMODULE_POSTPONED_ARRAY_LEN -1
 
@@ -62,6 +74,42 @@
 
 #define REDISMODULE_NOT_USED(V) ((void) V)
 
+/* Server events */
+#define REDISMODULE_EVENT_FLUSHDB 2
+#define REDISMODULE_EVENT_LOADING 3
+#define REDISMODULE_EVENT_SWAPDB 11
+
+typedef struct RedisModuleEvent {
+    uint64_t id;
+    uint64_t dataver;
+} RedisModuleEvent;
+
+static const RedisModuleEvent
+    RedisModuleEvent_FlushDB = { REDISMODULE_EVENT_FLUSHDB, 1 },
+    RedisModuleEvent_Loading = { REDISMODULE_EVENT_LOADING, 1 },
+    RedisModuleEvent_SwapDB = { REDISMODULE_EVENT_SWAPDB, 1 };
+
+#define REDISMODULE_SUBEVENT_LOADING_RDB_START 0
+#define REDISMODULE_SUBEVENT_LOADING_AOF_START 1
+#define REDISMODULE_SUBEVENT_LOADING_REPL_START 2
+#define REDISMODULE_SUBEVENT_LOADING_ENDED 3
+#define REDISMODULE_SUBEVENT_LOADING_FAILED 4
+
+#define REDISMODULE_SUBEVENT_FLUSHDB_START 0
+#define REDISMODULE_SUBEVENT_FLUSHDB_END 1
+
+typedef struct RedisModuleFlushInfo {
+    uint64_t version;
+    int32_t sync;
+    int32_t dbnum;
+} RedisModuleFlushInfo;
+
+typedef struct RedisModuleSwapDbInfo {
+    uint64_t version;
+    int32_t dbnum_first;
+    int32_t dbnum_second;
+} RedisModuleSwapDbInfo;
+
 typedef long long mstime_t;
 
 /* UT dummy definitions for opaque redis types */
@@ -73,6 +121,9 @@ typedef struct { int dummy; } RedisModuleIO;
 typedef struct { int dummy; } RedisModuleType;
 typedef struct { int dummy; } RedisModuleDigest;
 typedef struct { int dummy; } RedisModuleBlockedClient;
+typedef struct { int dummy; } RedisModuleInfoCtx;
+typedef struct RedisModuleDict RedisModuleDict;
+typedef struct RedisModuleDictIter RedisModuleDictIter;
 
 typedef void *(*RedisModuleTypeLoadFunc)(RedisModuleIO *rdb, int encver);
 typedef void (*RedisModuleTypeSaveFunc)(RedisModuleIO *rdb, void *value);
@@ -82,6 +133,9 @@ typedef void (*RedisModuleTypeDigestFunc)(RedisModuleDigest *digest, void *value
 typedef void (*RedisModuleTypeFreeFunc)(void *value);
 
 typedef int (*RedisModuleCmdFunc) (RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+typedef int (*RedisModuleNotificationFunc)(RedisModuleCtx *ctx, int type, const char *event, RedisModuleString *key);
+typedef void (*RedisModuleEventCallback)(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t subevent, void *data);
+typedef void (*RedisModuleInfoFunc)(RedisModuleInfoCtx *ctx, int for_crash_report);
 
 int RedisModule_CreateCommand(RedisModuleCtx *ctx, const char *name, RedisModuleCmdFunc cmdfunc, const char *strflags, int firstkey, int lastkey, int keystep);
 int RedisModule_WrongArity(RedisModuleCtx *ctx);
@@ -122,5 +176,23 @@ RedisModuleString *RedisModule_CreateStringFromLongLong(RedisModuleCtx *ctx, lon
 void RedisModule_AutoMemory(RedisModuleCtx *ctx);
 void *RedisModule_Alloc(size_t bytes);
 void RedisModule_Free(void *ptr);
+int RedisModule_ReplyWithSimpleString(RedisModuleCtx *ctx, const char *msg);
+int RedisModule_GetSelectedDb(RedisModuleCtx *ctx);
+long long RedisModule_Milliseconds(void);
+int RedisModule_SubscribeToKeyspaceEvents(RedisModuleCtx *ctx, int types, RedisModuleNotificationFunc cb);
+int RedisModule_SubscribeToServerEvent(RedisModuleCtx *ctx, RedisModuleEvent event, RedisModuleEventCallback callback);
+int RedisModule_RegisterInfoFunc(RedisModuleCtx *ctx, RedisModuleInfoFunc cb);
+int RedisModule_InfoAddSection(RedisModuleInfoCtx *ctx, char *name);
+int RedisModule_InfoAddFieldLongLong(RedisModuleInfoCtx *ctx, char *field, long long value);
+
+RedisModuleDict *RedisModule_CreateDict(RedisModuleCtx *ctx);
+void RedisModule_FreeDict(RedisModuleCtx *ctx, RedisModuleDict *d);
+uint64_t RedisModule_DictSize(RedisModuleDict *d);
+int RedisModule_DictSetC(RedisModuleDict *d, void *key, size_t keylen, void *ptr);
+void *RedisModule_DictGetC(RedisModuleDict *d, void *key, size_t keylen, int *nokey);
+int RedisModule_DictDelC(RedisModuleDict *d, void *key, size_t keylen, void *oldval);
+RedisModuleDictIter *RedisModule_DictIteratorStartC(RedisModuleDict *d, const char *op, void *key, size_t keylen);
+void RedisModule_DictIteratorStop(RedisModuleDictIter *di);
+void *RedisModule_DictNextC(RedisModuleDictIter *di, size_t *keylen, void **dataptr);
 
 #endif /* REDISMODULE_H */
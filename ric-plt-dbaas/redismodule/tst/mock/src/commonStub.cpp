@@ -36,23 +36,13 @@ extern "C" {
 #include <CppUTestExt/MockSupport.h>
 #include <CppUTest/MemoryLeakDetectorMallocMacros.h>
 
-typedef struct RedisModuleBlockedClientArgs {
-    RedisModuleBlockedClient *bc;
-    RedisModuleString **argv;
-    int argc;
-} RedisModuleBlockedClientArgs;
-
 int pthread_create(pthread_t *thread, const pthread_attr_t *attr,
                    void *(*start_routine) (void *), void *arg)
 {
     (void)thread;
     (void)attr;
     (void)start_routine;
-    if (mock().getData("pthread_create_free_block_client_args").getIntValue()) {
-        RedisModuleBlockedClientArgs* bca = (RedisModuleBlockedClientArgs*)arg;
-        free(bca->bc);
-        free(bca);
-    }
+    (void)arg;
 
     return mock()
         .actualCall("pthread_create")
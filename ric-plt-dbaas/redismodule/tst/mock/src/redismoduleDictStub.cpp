@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2018-2020 Nokia.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+ */
+
+/* Working std::map based replacement of the redis module dictionary API, so
+ * that the namespace index can be tested through its real contents. */
+
+#include <map>
+#include <string>
+#include <string.h>
+
+extern "C" {
+#include "redismodule.h"
+}
+
+struct RedisModuleDict
+{
+    std::map<std::string, void *> entries;
+};
+
+struct RedisModuleDictIter
+{
+    RedisModuleDict *dict;
+    std::map<std::string, void *>::iterator next;
+    std::string current;
+};
+
+RedisModuleDict *RedisModule_CreateDict(RedisModuleCtx *ctx)
+{
+    (void)ctx;
+    return new RedisModuleDict();
+}
+
+void RedisModule_FreeDict(RedisModuleCtx *ctx, RedisModuleDict *d)
+{
+    (void)ctx;
+    delete d;
+}
+
+uint64_t RedisModule_DictSize(RedisModuleDict *d)
+{
+    return d->entries.size();
+}
+
+int RedisModule_DictSetC(RedisModuleDict *d, void *key, size_t keylen, void *ptr)
+{
+    if (d->entries.insert(std::make_pair(std::string(static_cast<char *>(key), keylen), ptr)).second)
+        return REDISMODULE_OK;
+    return REDISMODULE_ERR;
+}
+
+void *RedisModule_DictGetC(RedisModuleDict *d, void *key, size_t keylen, int *nokey)
+{
+    auto i(d->entries.find(std::string(static_cast<char *>(key), keylen)));
+    if (nokey)
+        *nokey = i == d->entries.end();
+    return i == d->entries.end() ? NULL : i->second;
+}
+
+int RedisModule_DictDelC(RedisModuleDict *d, void *key, size_t keylen, void *oldval)
+{
+    auto i(d->entries.find(std::string(static_cast<char *>(key), keylen)));
+    if (i == d->entries.end())
+        return REDISMODULE_ERR;
+    if (oldval)
+        *static_cast<void **>(oldval) = i->second;
+    d->entries.erase(i);
+    return REDISMODULE_OK;
+}
+
+RedisModuleDictIter *RedisModule_DictIteratorStartC(RedisModuleDict *d, const char *op, void *key, size_t keylen)
+{
+    RedisModuleDictIter *di = new RedisModuleDictIter();
+    di->dict = d;
+    if (!strcmp(op, ">"))
+        di->next = d->entries.upper_bound(std::string(static_cast<char *>(key), keylen));
+    else if (!strcmp(op, ">="))
+        di->next = d->entries.lower_bound(std::string(static_cast<char *>(key), keylen));
+    else
+        di->next = d->entries.begin();
+    return di;
+}
+
+void RedisModule_DictIteratorStop(RedisModuleDictIter *di)
+{
+    delete di;
+}
+
+void *RedisModule_DictNextC(RedisModuleDictIter *di, size_t *keylen, void **dataptr)
+{
+    if (di->next == di->dict->entries.end())
+        return NULL;
+    di->current = di->next->first;
+    if (keylen)
+        *keylen = di->current.size();
+    if (dataptr)
+        *dataptr = di->next->second;
+    ++di->next;
+    return &di->current[0];
+}
@@ -358,3 +358,75 @@ void RedisModule_Free(void *ptr)
     mock()
         .actualCall("RedisModule_Free");
 }
+
+int RedisModule_ReplyWithSimpleString(RedisModuleCtx *ctx, const char *msg)
+{
+    (void)ctx;
+    return mock()
+        .actualCall("RedisModule_ReplyWithSimpleString")
+        .withParameter("msg", msg)
+        .returnIntValueOrDefault(REDISMODULE_OK);
+}
+
+int RedisModule_GetSelectedDb(RedisModuleCtx *ctx)
+{
+    (void)ctx;
+    return mock()
+        .actualCall("RedisModule_GetSelectedDb")
+        .returnIntValueOrDefault(0);
+}
+
+long long RedisModule_Milliseconds(void)
+{
+    return mock()
+        .actualCall("RedisModule_Milliseconds")
+        .returnIntValueOrDefault(0);
+}
+
+int RedisModule_SubscribeToKeyspaceEvents(RedisModuleCtx *ctx, int types, RedisModuleNotificationFunc cb)
+{
+    (void)ctx;
+    (void)cb;
+    return mock()
+        .actualCall("RedisModule_SubscribeToKeyspaceEvents")
+        .withParameter("types", types)
+        .returnIntValueOrDefault(REDISMODULE_OK);
+}
+
+int RedisModule_SubscribeToServerEvent(RedisModuleCtx *ctx, RedisModuleEvent event, RedisModuleEventCallback callback)
+{
+    (void)ctx;
+    (void)callback;
+    return mock()
+        .actualCall("RedisModule_SubscribeToServerEvent")
+        .withParameter("id", (int)event.id)
+        .returnIntValueOrDefault(REDISMODULE_OK);
+}
+
+int RedisModule_RegisterInfoFunc(RedisModuleCtx *ctx, RedisModuleInfoFunc cb)
+{
+    (void)ctx;
+    (void)cb;
+    return mock()
+        .actualCall("RedisModule_RegisterInfoFunc")
+        .returnIntValueOrDefault(REDISMODULE_OK);
+}
+
+int RedisModule_InfoAddSection(RedisModuleInfoCtx *ctx, char *name)
+{
+    (void)ctx;
+    return mock()
+        .actualCall("RedisModule_InfoAddSection")
+        .withParameter("name", (const char *)name)
+        .returnIntValueOrDefault(REDISMODULE_OK);
+}
+
+int RedisModule_InfoAddFieldLongLong(RedisModuleInfoCtx *ctx, char *field, long long value)
+{
+    (void)ctx;
+    return mock()
+        .actualCall("RedisModule_InfoAddFieldLongLong")
+        .withParameter("field", (const char *)field)
+        .withParameter("value", (int)value)
+        .returnIntValueOrDefault(REDISMODULE_OK);
+}
@@ -435,3 +435,62 @@ void RedisModule_Free(void *ptr)
         .actualCall("RedisModule_Free");
     free(ptr);
 }
+
+int RedisModule_ReplyWithSimpleString(RedisModuleCtx *ctx, const char *msg)
+{
+    (void)ctx;
+    (void)msg;
+    return REDISMODULE_OK;
+}
+
+int RedisModule_GetSelectedDb(RedisModuleCtx *ctx)
+{
+    (void)ctx;
+    return 0;
+}
+
+long long RedisModule_Milliseconds(void)
+{
+    return 0;
+}
+
+int RedisModule_SubscribeToKeyspaceEvents(RedisModuleCtx *ctx, int types, RedisModuleNotificationFunc cb)
+{
+    (void)ctx;
+    (void)types;
+    (void)cb;
+    mock().setData("RedisModule_SubscribeToKeyspaceEvents", 1);
+    return REDISMODULE_OK;
+}
+
+int RedisModule_SubscribeToServerEvent(RedisModuleCtx *ctx, RedisModuleEvent event, RedisModuleEventCallback callback)
+{
+    (void)ctx;
+    (void)event;
+    (void)callback;
+    mock().setData("RedisModule_SubscribeToServerEvent", 1);
+    return REDISMODULE_OK;
+}
+
+int RedisModule_RegisterInfoFunc(RedisModuleCtx *ctx, RedisModuleInfoFunc cb)
+{
+    (void)ctx;
+    (void)cb;
+    mock().setData("RedisModule_RegisterInfoFunc", 1);
+    return REDISMODULE_OK;
+}
+
+int RedisModule_InfoAddSection(RedisModuleInfoCtx *ctx, char *name)
+{
+    (void)ctx;
+    (void)name;
+    return REDISMODULE_OK;
+}
+
+int RedisModule_InfoAddFieldLongLong(RedisModuleInfoCtx *ctx, char *field, long long value)
+{
+    (void)ctx;
+    (void)field;
+    (void)value;
+    return REDISMODULE_OK;
+}
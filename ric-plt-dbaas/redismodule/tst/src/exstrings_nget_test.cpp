@@ -31,28 +31,34 @@ extern "C" {
 
 #include "ut_helpers.hpp"
 
+typedef struct RedisModuleBlockedClientArgs {
+    RedisModuleBlockedClient *bc;
+    RedisModuleString **argv;
+    int argc;
+} RedisModuleBlockedClientArgs;
+
 TEST_GROUP(exstrings_nget)
 {
     void setup()
     {
         mock().enable();
         mock().ignoreOtherCalls();
+        ngetWorkerPoolInit(2, 2);
     }
 
     void teardown()
     {
+        RedisModuleBlockedClientArgs *bca;
+        while ((bca = ngetWorkerPoolPop(false)) != NULL) {
+            free(bca->bc);
+            free(bca);
+        }
         mock().clear();
         mock().disable();
     }
 
 };
 
-void threadDetachedSuccess()
-{
-    mock().expectOneCall("pthread_detach")
-        .andReturnValue(0);
-}
-
 void nKeysFoundMget(long keys)
 {
     for (long i = 0 ; i < keys ; i++) {
@@ -273,8 +279,6 @@ TEST(exstrings_nget, nget_noatomic_automemory_enabled)
     RedisModuleCtx ctx;
     RedisModuleString ** redisStrVec = createRedisStrVec(2);
 
-    mock().setData("pthread_create_free_block_client_args", 1);
-
     mock().ignoreOtherCalls();
     mock().expectOneCall("RedisModule_AutoMemory");
 
@@ -290,11 +294,9 @@ TEST(exstrings_nget, nget_noatomic_thread_create_success)
     RedisModuleCtx ctx;
     RedisModuleString ** redisStrVec = createRedisStrVec(2);
 
-    mock().setData("pthread_create_free_block_client_args", 1);
-
     mock().ignoreOtherCalls();
     mock().expectOneCall("RedisModule_BlockClient");
-    mock().expectOneCall("pthread_create");
+    mock().expectNCalls(2, "pthread_create");
     mock().expectNoCall("RedisModule_AbortBlock");
 
     int ret = NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2);
@@ -338,7 +340,7 @@ TEST(exstrings_nget, nget_noatomic_parameter_number_incorrect)
     delete []redisStrVec;
 }
 
-TEST(exstrings_nget, nget_noatomic_threadmain_3rd_parameter_was_not_equal_to_COUNT)
+TEST(exstrings_nget, nget_noatomic_execute_3rd_parameter_was_not_equal_to_COUNT)
 {
     RedisModuleCtx ctx;
     RedisModuleString ** redisStrVec = createRedisStrVec(4);
@@ -386,13 +388,7 @@ TEST(exstrings_nget, nget_noatomic_4th_parameter_was_not_integer)
     delete []redisStrVec;
 }
 
-typedef struct RedisModuleBlockedClientArgs {
-    RedisModuleBlockedClient *bc;
-    RedisModuleString **argv;
-    int argc;
-} RedisModuleBlockedClientArgs;
-
-TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_3_keys_mget)
+TEST(exstrings_nget, nget_noatomic_execute_3_keys_scanned_3_keys_mget)
 {
     RedisModuleCtx ctx;
     RedisModuleBlockedClientArgs *bca =
@@ -405,7 +401,6 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_3_keys_mget)
     bca->argc = 2;
 
     mock().ignoreOtherCalls();
-    threadDetachedSuccess();
     mock().expectOneCall("RedisModule_ReplyWithArray")
           .withParameter("len", (long)REDISMODULE_POSTPONED_ARRAY_LEN);
     mock().expectOneCall("RedisModule_Call")
@@ -420,7 +415,7 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_3_keys_mget)
     mock().expectOneCall("RedisModule_FreeThreadSafeContext");
     mock().expectOneCall("RedisModule_UnblockClient");
 
-    NGet_NoAtomic_ThreadMain((void*)bca);
+    NGet_NoAtomic_Execute((void*)bca);
 
     mock().checkExpectations();
     threadSafeContextLockedAndUnlockedEqualTimes();
@@ -428,7 +423,7 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_3_keys_mget)
     delete []redisStrVec;
 }
 
-TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_0_keys_mget)
+TEST(exstrings_nget, nget_noatomic_execute_3_keys_scanned_0_keys_mget)
 {
     RedisModuleCtx ctx;
     RedisModuleBlockedClientArgs *bca = (RedisModuleBlockedClientArgs*)malloc(sizeof(RedisModuleBlockedClientArgs));
@@ -440,7 +435,6 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_0_keys_mget)
     bca->argc = 2;
 
     mock().ignoreOtherCalls();
-    threadDetachedSuccess();
     mock().expectOneCall("RedisModule_ReplyWithArray")
           .withParameter("len", (long)REDISMODULE_POSTPONED_ARRAY_LEN);
     mock().expectOneCall("RedisModule_Call")
@@ -455,7 +449,7 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_0_keys_mget)
     mock().expectOneCall("RedisModule_FreeThreadSafeContext");
     mock().expectOneCall("RedisModule_UnblockClient");
 
-    NGet_NoAtomic_ThreadMain((void*)bca);
+    NGet_NoAtomic_Execute((void*)bca);
 
     mock().checkExpectations();
     threadSafeContextLockedAndUnlockedEqualTimes();
@@ -463,7 +457,7 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_0_keys_mget)
     delete []redisStrVec;
 }
 
-TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_2_keys_mget)
+TEST(exstrings_nget, nget_noatomic_execute_3_keys_scanned_2_keys_mget)
 {
     RedisModuleCtx ctx;
     RedisModuleBlockedClientArgs *bca = (RedisModuleBlockedClientArgs*)malloc(sizeof(RedisModuleBlockedClientArgs));
@@ -475,7 +469,6 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_2_keys_mget)
     bca->argc = 2;
 
     mock().ignoreOtherCalls();
-    threadDetachedSuccess();
     mock().expectOneCall("RedisModule_ReplyWithArray")
           .withParameter("len", (long)REDISMODULE_POSTPONED_ARRAY_LEN);
     mock().expectOneCall("RedisModule_Call")
@@ -491,7 +484,7 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_2_keys_mget)
     mock().expectOneCall("RedisModule_FreeThreadSafeContext");
     mock().expectOneCall("RedisModule_UnblockClient");
 
-    NGet_NoAtomic_ThreadMain((void*)bca);
+    NGet_NoAtomic_Execute((void*)bca);
 
     mock().checkExpectations();
     threadSafeContextLockedAndUnlockedEqualTimes();
@@ -499,7 +492,7 @@ TEST(exstrings_nget, nget_noatomic_threadmain_3_keys_scanned_2_keys_mget)
     delete []redisStrVec;
 }
 
-TEST(exstrings_nget, nget_noatomic_threadmain_scan_returned_zero_keys)
+TEST(exstrings_nget, nget_noatomic_execute_scan_returned_zero_keys)
 {
     RedisModuleCtx ctx;
     RedisModuleBlockedClientArgs *bca = (RedisModuleBlockedClientArgs*)malloc(sizeof(RedisModuleBlockedClientArgs));
@@ -511,7 +504,6 @@ TEST(exstrings_nget, nget_noatomic_threadmain_scan_returned_zero_keys)
     bca->argc = 2;
 
     mock().ignoreOtherCalls();
-    threadDetachedSuccess();
     mock().expectOneCall("RedisModule_ReplyWithArray")
           .withParameter("len", (long)REDISMODULE_POSTPONED_ARRAY_LEN);
     mock().expectOneCall("RedisModule_Call")
@@ -522,7 +514,7 @@ TEST(exstrings_nget, nget_noatomic_threadmain_scan_returned_zero_keys)
     mock().expectOneCall("RedisModule_FreeThreadSafeContext");
     mock().expectOneCall("RedisModule_UnblockClient");
 
-    NGet_NoAtomic_ThreadMain((void*)bca);
+    NGet_NoAtomic_Execute((void*)bca);
 
     mock().checkExpectations();
     threadSafeContextLockedAndUnlockedEqualTimes();
@@ -530,23 +522,131 @@ TEST(exstrings_nget, nget_noatomic_threadmain_scan_returned_zero_keys)
     delete []redisStrVec;
 }
 
-TEST(exstrings_nget, nget_noatomic_threadmain_thread_detached)
+TEST(exstrings_nget, nget_noatomic_worker_threads_are_started_only_once)
 {
     RedisModuleCtx ctx;
-    RedisModuleBlockedClientArgs *bca = (RedisModuleBlockedClientArgs*)malloc(sizeof(RedisModuleBlockedClientArgs));
-    RedisModuleBlockedClient *bc = RedisModule_BlockClient(&ctx,NULL,NULL,NULL,0);
     RedisModuleString ** redisStrVec = createRedisStrVec(2);
 
-    bca->bc = bc;
-    bca->argv = redisStrVec;
-    bca->argc = 2;
+    mock().ignoreOtherCalls();
+    mock().expectNCalls(2, "pthread_create");
+
+    CHECK_EQUAL(NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2), REDISMODULE_OK);
+    CHECK_EQUAL(NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2), REDISMODULE_OK);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nget, nget_noatomic_requests_are_queued_in_order)
+{
+    RedisModuleCtx ctx;
+    RedisModuleString ** redisStrVec = createRedisStrVec(2);
+    void *bc1 = malloc(UT_DUMMY_BUFFER_SIZE);
+    void *bc2 = malloc(UT_DUMMY_BUFFER_SIZE);
 
     mock().ignoreOtherCalls();
-    threadDetachedSuccess();
+    mock().expectOneCall("RedisModule_BlockClient")
+          .andReturnValue(bc1);
+    mock().expectOneCall("RedisModule_BlockClient")
+          .andReturnValue(bc2);
 
-    NGet_NoAtomic_ThreadMain((void*)bca);
+    CHECK_EQUAL(NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2), REDISMODULE_OK);
+    CHECK_EQUAL(NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2), REDISMODULE_OK);
+    mock().checkExpectations();
+
+    RedisModuleBlockedClientArgs *bca = ngetWorkerPoolPop(false);
+    POINTERS_EQUAL(bc1, bca->bc);
+    NGet_NoAtomic_Execute((void*)bca);
+    bca = ngetWorkerPoolPop(false);
+    POINTERS_EQUAL(bc2, bca->bc);
+    NGet_NoAtomic_Execute((void*)bca);
+    POINTERS_EQUAL(NULL, ngetWorkerPoolPop(false));
 
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nget, nget_noatomic_request_is_rejected_when_queue_is_full)
+{
+    RedisModuleCtx ctx;
+    RedisModuleString ** redisStrVec = createRedisStrVec(2);
+
+    ngetWorkerPoolInit(1, 1);
+    mock().ignoreOtherCalls();
+    mock().expectNCalls(2, "RedisModule_BlockClient");
+    mock().expectOneCall("RedisModule_AbortBlock");
+    mock().expectOneCall("RedisModule_ReplyWithError");
+
+    CHECK_EQUAL(NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2), REDISMODULE_OK);
+    CHECK_EQUAL(NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2), REDISMODULE_OK);
     mock().checkExpectations();
 
     delete []redisStrVec;
 }
+
+TEST(exstrings_nget, ngetpool_info_reports_queue_depth_and_rejected_requests)
+{
+    RedisModuleCtx ctx;
+    RedisModuleString ** redisStrVec = createRedisStrVec(2);
+
+    ngetWorkerPoolInit(1, 1);
+    NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2);
+    NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2);
+
+    mock().expectOneCall("RedisModule_ReplyWithArray")
+          .withParameter("len", (long)16);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 1);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 1);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 1);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 1);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 0);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 1);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 0);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 0);
+    CHECK_EQUAL(NGetPoolInfo_RedisCommand(&ctx, redisStrVec, 1), REDISMODULE_OK);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nget, info_callback_reports_pool_section)
+{
+    RedisModuleCtx ctx;
+    RedisModuleInfoCtx info_ctx;
+    RedisModuleString ** redisStrVec = createRedisStrVec(2);
+
+    ngetWorkerPoolInit(1, 1);
+    NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2);
+    NGet_NoAtomic_RedisCommand(&ctx, redisStrVec,  2);
+
+    mock().expectOneCall("RedisModule_InfoAddSection")
+          .withParameter("name", "ngetpool");
+    mock().expectOneCall("RedisModule_InfoAddFieldLongLong")
+          .withParameter("field", "workers").withParameter("value", 1);
+    mock().expectOneCall("RedisModule_InfoAddFieldLongLong")
+          .withParameter("field", "queue_size").withParameter("value", 1);
+    mock().expectOneCall("RedisModule_InfoAddFieldLongLong")
+          .withParameter("field", "queue_depth").withParameter("value", 1);
+    mock().expectOneCall("RedisModule_InfoAddFieldLongLong")
+          .withParameter("field", "queue_depth_max").withParameter("value", 1);
+    mock().expectOneCall("RedisModule_InfoAddFieldLongLong")
+          .withParameter("field", "requests").withParameter("value", 0);
+    mock().expectOneCall("RedisModule_InfoAddFieldLongLong")
+          .withParameter("field", "rejected").withParameter("value", 1);
+    mock().expectOneCall("RedisModule_InfoAddFieldLongLong")
+          .withParameter("field", "latency_avg_us").withParameter("value", 0);
+    mock().expectOneCall("RedisModule_InfoAddFieldLongLong")
+          .withParameter("field", "latency_max_us").withParameter("value", 0);
+    Exstrings_InfoFunc(&info_ctx, 0);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nget, onload_registers_info_callback)
+{
+    RedisModuleCtx ctx;
+
+    mock().expectOneCall("RedisModule_RegisterInfoFunc");
+    CHECK_EQUAL(RedisModule_OnLoad(&ctx, NULL, 0), REDISMODULE_OK);
+    mock().checkExpectations();
+}
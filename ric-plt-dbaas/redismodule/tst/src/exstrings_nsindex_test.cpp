@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2018-2020 Nokia.
+ *
+ *   Licensed under the Apache License, Version 2.0 (the "License");
+ *   you may not use this file except in compliance with the License.
+ *   You may obtain a copy of the License at
+ *
+ *       http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *   Unless required by applicable law or agreed to in writing, software
+ *   distributed under the License is distributed on an "AS IS" BASIS,
+ *   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *   See the License for the specific language governing permissions and
+ *   limitations under the License.
+ */
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+ */
+
+extern "C" {
+#include "exstringsStub.h"
+#include "redismodule.h"
+}
+
+#include <list>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+#include "ut_helpers.hpp"
+
+TEST_GROUP(exstrings_nsindex)
+{
+    RedisModuleCtx ctx;
+    std::list<size_t> lengths;
+
+    void setup()
+    {
+        mock().enable();
+        mock().ignoreOtherCalls();
+    }
+
+    void teardown()
+    {
+        /* Loading the module without arguments frees the index */
+        RedisModule_OnLoad(&ctx, NULL, 0);
+        mock().clear();
+        mock().disable();
+    }
+
+    void expectStringPtrLen(const char *str)
+    {
+        lengths.push_back(strlen(str));
+        mock().expectOneCall("RedisModule_StringPtrLen")
+              .withOutputParameterReturning("len", &lengths.back(), sizeof(size_t))
+              .andReturnValue((void*)str);
+    }
+
+    void expectStringPtr(const char *str)
+    {
+        mock().expectOneCall("RedisModule_StringPtrLen")
+              .andReturnValue((void*)str);
+    }
+
+    void loadWithIndex()
+    {
+        RedisModuleString ** redisStrVec = createRedisStrVec(1);
+        expectStringPtr("nsindex");
+        CHECK_EQUAL(RedisModule_OnLoad(&ctx, redisStrVec, 1), REDISMODULE_OK);
+        delete []redisStrVec;
+    }
+
+    void buildEmptyIndex()
+    {
+        RedisModuleString ** redisStrVec = createRedisStrVec(1);
+        mock().expectOneCall("RedisModule_Call")
+              .withParameter("cmdname", "SCAN");
+        returnNKeysFromScanSome(0);
+        mock().expectOneCall("RedisModule_ReplyWithSimpleString")
+              .withParameter("msg", "OK");
+        CHECK_EQUAL(NsIndexRebuild_RedisCommand(&ctx, redisStrVec, 1), REDISMODULE_OK);
+        mock().checkExpectations();
+        mock().clear();
+        mock().ignoreOtherCalls();
+        delete []redisStrVec;
+    }
+
+    void keyspaceEvent(const char *event, const char *key)
+    {
+        RedisModuleString *keystr = (RedisModuleString *)UT_DUMMY_PTR_ADDRESS;
+        expectStringPtrLen(key);
+        NsIndex_KeyspaceEvent(&ctx, REDISMODULE_NOTIFY_GENERIC, event, keystr);
+    }
+
+    void expectInfo(long long namespaces, long long keys, long long key_bytes)
+    {
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 1);
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 1);
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", (int)namespaces);
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", (int)keys);
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", (int)key_bytes);
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").ignoreOtherParameters();
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 0);
+    }
+
+    void expectInfoNotReady()
+    {
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").withParameter("ll", 1);
+        mock().expectNCalls(5, "RedisModule_ReplyWithLongLong").withParameter("ll", 0);
+        mock().expectOneCall("RedisModule_ReplyWithLongLong").ignoreOtherParameters();
+    }
+};
+
+TEST(exstrings_nsindex, onload_with_nsindex_argument_subscribes_to_keyspace_events)
+{
+    mock().expectOneCall("RedisModule_SubscribeToKeyspaceEvents")
+          .withParameter("types", REDISMODULE_NOTIFY_ALL);
+    loadWithIndex();
+    mock().checkExpectations();
+}
+
+TEST(exstrings_nsindex, onload_with_nsindex_argument_subscribes_to_flushdb_loading_and_swapdb_events)
+{
+    mock().expectOneCall("RedisModule_SubscribeToServerEvent")
+          .withParameter("id", REDISMODULE_EVENT_FLUSHDB);
+    mock().expectOneCall("RedisModule_SubscribeToServerEvent")
+          .withParameter("id", REDISMODULE_EVENT_LOADING);
+    mock().expectOneCall("RedisModule_SubscribeToServerEvent")
+          .withParameter("id", REDISMODULE_EVENT_SWAPDB);
+    loadWithIndex();
+    mock().checkExpectations();
+}
+
+TEST(exstrings_nsindex, onload_without_arguments_does_not_subscribe_to_keyspace_events)
+{
+    mock().expectNoCall("RedisModule_SubscribeToKeyspaceEvents");
+    CHECK_EQUAL(RedisModule_OnLoad(&ctx, NULL, 0), REDISMODULE_OK);
+    mock().checkExpectations();
+}
+
+TEST(exstrings_nsindex, onload_with_unknown_argument_fails)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(1);
+
+    expectStringPtr("unknown");
+    CHECK_EQUAL(RedisModule_OnLoad(&ctx, redisStrVec, 1), REDISMODULE_ERR);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, rebuild_fails_when_index_is_not_enabled)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(1);
+
+    mock().expectOneCall("RedisModule_ReplyWithError");
+    mock().expectNoCall("RedisModule_Call");
+    NsIndexRebuild_RedisCommand(&ctx, redisStrVec, 1);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, keyspace_events_add_and_remove_keys)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(1);
+
+    loadWithIndex();
+    buildEmptyIndex();
+    keyspaceEvent("set", "{ns1},a");
+    keyspaceEvent("set", "{ns1},b");
+    keyspaceEvent("set", "{ns1},b");
+    keyspaceEvent("set", "{ns2},c");
+    keyspaceEvent("set", "no namespace");
+    keyspaceEvent("del", "{ns1},a");
+    keyspaceEvent("expired", "{ns2},c");
+    expectInfo(1, 1, strlen("{ns1},b"));
+    NsIndexInfo_RedisCommand(&ctx, redisStrVec, 1);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, keyspace_events_of_other_databases_are_ignored)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(1);
+
+    loadWithIndex();
+    buildEmptyIndex();
+    mock().expectOneCall("RedisModule_GetSelectedDb")
+          .andReturnValue(1);
+    mock().expectNoCall("RedisModule_StringPtrLen");
+    NsIndex_KeyspaceEvent(&ctx, REDISMODULE_NOTIFY_STRING, "set", (RedisModuleString *)UT_DUMMY_PTR_ADDRESS);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, nget_atomic_reads_namespace_keys_from_index_without_scan)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(2);
+
+    loadWithIndex();
+    buildEmptyIndex();
+    keyspaceEvent("set", "{ns1},a");
+    keyspaceEvent("set", "{ns1},b");
+    keyspaceEvent("set", "{ns2},c");
+
+    expectStringPtrLen("{ns1},*");
+    expectStringPtr("{ns1},*");
+    expectStringPtrLen("{ns1},b");
+    mock().expectOneCall("RedisModule_Call")
+          .withParameter("cmdname", "MGET");
+    for (int i = 0 ; i < 2 ; i++) {
+        mock().expectOneCall("RedisModule_CreateStringFromCallReply")
+              .andReturnValue(malloc(UT_DUMMY_BUFFER_SIZE));
+    }
+    mock().expectNCalls(4, "RedisModule_ReplyWithString");
+    mock().expectOneCall("RedisModule_ReplySetArrayLength")
+          .withParameter("len", 4);
+    int ret = NGet_Atomic_RedisCommand(&ctx, redisStrVec, 2);
+    CHECK_EQUAL(ret, REDISMODULE_OK);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, nget_atomic_with_glob_namespace_pattern_uses_scan)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(2);
+
+    loadWithIndex();
+    buildEmptyIndex();
+
+    expectStringPtrLen("{ns*},*");
+    mock().expectOneCall("RedisModule_Call")
+          .withParameter("cmdname", "SCAN");
+    returnNKeysFromScanSome(0);
+    mock().expectOneCall("RedisModule_ReplySetArrayLength")
+          .withParameter("len", 0);
+    int ret = NGet_Atomic_RedisCommand(&ctx, redisStrVec, 2);
+    CHECK_EQUAL(ret, REDISMODULE_OK);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, ndel_atomic_unlinks_namespace_keys_from_index_and_drops_namespace)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(2);
+
+    loadWithIndex();
+    buildEmptyIndex();
+    keyspaceEvent("set", "{ns1},a");
+    keyspaceEvent("set", "{ns1},b");
+    keyspaceEvent("set", "{ns2},c");
+
+    expectStringPtrLen("{ns1},*");
+    expectStringPtr("{ns1},*");
+    expectStringPtrLen("{ns1},b");
+    expectStringPtr("{ns1},*");
+    mock().expectOneCall("RedisModule_Call")
+          .withParameter("cmdname", "UNLINK");
+    mock().expectOneCall("RedisModule_CallReplyInteger")
+          .andReturnValue(2);
+    mock().expectOneCall("RedisModule_ReplyWithLongLong")
+          .withParameter("ll", 2);
+    int ret = NDel_Atomic_RedisCommand(&ctx, redisStrVec, 2);
+    CHECK_EQUAL(ret, REDISMODULE_OK);
+    mock().checkExpectations();
+
+    expectInfo(1, 1, strlen("{ns2},c"));
+    NsIndexInfo_RedisCommand(&ctx, redisStrVec, 1);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, nget_after_flushall_rebuilds_index)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(2);
+    RedisModuleFlushInfo fi = { 1, 1, -1 };
+
+    loadWithIndex();
+    buildEmptyIndex();
+    keyspaceEvent("set", "{ns1},a");
+    NsIndex_ServerEvent(&ctx, RedisModuleEvent_FlushDB, REDISMODULE_SUBEVENT_FLUSHDB_START, &fi);
+
+    expectStringPtrLen("{ns1},*");
+    mock().expectOneCall("RedisModule_Call")
+          .withParameter("cmdname", "SCAN");
+    returnNKeysFromScanSome(0);
+    expectStringPtr("{ns1},*");
+    mock().expectOneCall("RedisModule_ReplySetArrayLength")
+          .withParameter("len", 0);
+    int ret = NGet_Atomic_RedisCommand(&ctx, redisStrVec, 2);
+    CHECK_EQUAL(ret, REDISMODULE_OK);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, flushdb_of_other_database_keeps_index)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(1);
+    RedisModuleFlushInfo fi = { 1, 1, 1 };
+
+    loadWithIndex();
+    buildEmptyIndex();
+    keyspaceEvent("set", "{ns1},a");
+    NsIndex_ServerEvent(&ctx, RedisModuleEvent_FlushDB, REDISMODULE_SUBEVENT_FLUSHDB_START, &fi);
+    expectInfo(1, 1, strlen("{ns1},a"));
+    NsIndexInfo_RedisCommand(&ctx, redisStrVec, 1);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, swapdb_with_database_zero_drops_index)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(1);
+    RedisModuleSwapDbInfo si = { 1, 3, 0 };
+
+    loadWithIndex();
+    buildEmptyIndex();
+    keyspaceEvent("set", "{ns1},a");
+    NsIndex_ServerEvent(&ctx, RedisModuleEvent_SwapDB, 0, &si);
+    expectInfoNotReady();
+    NsIndexInfo_RedisCommand(&ctx, redisStrVec, 1);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
+
+TEST(exstrings_nsindex, replica_full_sync_drops_index)
+{
+    RedisModuleString ** redisStrVec = createRedisStrVec(1);
+
+    loadWithIndex();
+    buildEmptyIndex();
+    keyspaceEvent("set", "{ns1},a");
+    NsIndex_ServerEvent(&ctx, RedisModuleEvent_Loading, REDISMODULE_SUBEVENT_LOADING_REPL_START, NULL);
+    expectInfoNotReady();
+    NsIndexInfo_RedisCommand(&ctx, redisStrVec, 1);
+    mock().checkExpectations();
+
+    delete []redisStrVec;
+}
@@ -65,6 +65,10 @@ namespace shareddatalayer
 
         void removeAllAsync(const Namespace& ns, const ModifyAck& modifyAck) override;
 
+        void subscribeChannelAsync(const Namespace& ns, const NotificationCb& notificationCb, const ModifyAck& modifyAck) override;
+
+        void unsubscribeChannel(const Namespace& ns) override;
+
     private:
         using Callback = std::function<void()>;
 
@@ -0,0 +1,131 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+#ifndef SHAREDDATALAYER_ASYNCSHARDEDSTORAGE_HPP_
+#define SHAREDDATALAYER_ASYNCSHARDEDSTORAGE_HPP_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <sdl/asyncstorage.hpp>
+#include "private/databaseconfiguration.hpp"
+
+namespace shareddatalayer
+{
+    class Engine;
+
+    /**
+     * Routes the operations to a set of shards, each of which has a pool of
+     * parallel connections (one AsyncStorage instance per connection).
+     *
+     * In ShardingMode::NAMESPACE the shard is selected like before, by hashing
+     * the namespace over the shard count. In ShardingMode::KEY the shard is
+     * selected per key from a consistent hash ring, so adding a shard moves only
+     * the keys that fall on the new shard. If the key contains a non-empty
+     * "{...}" section, only that section is hashed, which allows grouping keys
+     * with a common prefix to the same shard.
+     *
+     * Within a shard the connection is selected by hashing the key, so
+     * operations on the same key are always handled in order by the same
+     * connection. Multi-key operations are split per connection and the
+     * results are merged before the acknowledgement is called. Such operations
+     * are not atomic across the connections. Operations on the whole namespace
+     * (findKeys, listKeys and removeAll) are sent on every connection of the
+     * namespace's shards, so that they are ordered after every operation
+     * issued before them.
+     */
+    class AsyncShardedStorage: public AsyncStorage
+    {
+    public:
+        using Connections = std::vector<std::shared_ptr<AsyncStorage>>;
+
+        struct Shard
+        {
+            /* Identifies the shard in the hash ring, for example server address. */
+            std::string id;
+            Connections connections;
+        };
+
+        using Shards = std::vector<Shard>;
+
+        static const std::size_t VIRTUAL_NODES_PER_SHARD;
+
+        AsyncShardedStorage(std::shared_ptr<Engine> engine,
+                            const Shards& shards,
+                            DatabaseConfiguration::ShardingMode shardingMode);
+
+        AsyncShardedStorage(const AsyncShardedStorage&) = delete;
+
+        AsyncShardedStorage& operator = (const AsyncShardedStorage&) = delete;
+
+        AsyncShardedStorage(AsyncShardedStorage&&) = delete;
+
+        AsyncShardedStorage& operator = (AsyncShardedStorage&&) = delete;
+
+        int fd() const override;
+
+        void handleEvents() override;
+
+        void waitReadyAsync(const Namespace& ns, const ReadyAck& readyAck) override;
+
+        void setAsync(const Namespace& ns, const DataMap& dataMap, const ModifyAck& modifyAck) override;
+
+        void setIfAsync(const Namespace& ns, const Key& key, const Data& oldData, const Data& newData, const ModifyIfAck& modifyIfAck) override;
+
+        void setIfNotExistsAsync(const Namespace& ns, const Key& key, const Data& data, const ModifyIfAck& modifyIfAck) override;
+
+        void getAsync(const Namespace& ns, const Keys& keys, const GetAck& getAck) override;
+
+        void removeAsync(const Namespace& ns, const Keys& keys, const ModifyAck& modifyAck) override;
+
+        void removeIfAsync(const Namespace& ns, const Key& key, const Data& data, const ModifyIfAck& modifyIfAck) override;
+
+        void findKeysAsync(const Namespace& ns, const std::string& keyPrefix, const FindKeysAck& findKeysAck) override;
+
+        void listKeys(const Namespace& ns, const std::string& pattern, const FindKeysAck& findKeysAck) override;
+
+        void removeAllAsync(const Namespace& ns, const ModifyAck& modifyAck) override;
+
+        void subscribeChannelAsync(const Namespace& ns, const NotificationCb& notificationCb, const ModifyAck& modifyAck) override;
+
+        void unsubscribeChannel(const Namespace& ns) override;
+
+        //public for UT
+        std::size_t getShardIndex(const Namespace& ns, const Key& key) const;
+
+    private:
+        /* Shard index and connection index within the shard */
+        using Route = std::pair<std::size_t, std::size_t>;
+
+        std::shared_ptr<Engine> engine;
+        Shards shards;
+        DatabaseConfiguration::ShardingMode shardingMode;
+        std::vector<std::pair<std::uint32_t, std::size_t>> ring;
+
+        Route getRoute(const Namespace& ns, const Key& key) const;
+        AsyncStorage& getConnection(const Route& route) const;
+        AsyncStorage& getDefaultConnection(const Namespace& ns) const;
+        std::vector<std::size_t> getShardIndexes(const Namespace& ns) const;
+        Connections getConnections(const Namespace& ns) const;
+    };
+}
+
+#endif
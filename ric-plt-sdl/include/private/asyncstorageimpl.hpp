@@ -25,6 +25,7 @@
 #include <functional>
 #include <sdl/asyncstorage.hpp>
 #include <sdl/publisherid.hpp>
+#include "private/asyncshardedstorage.hpp"
 #include "private/configurationreader.hpp"
 #include "private/databaseconfigurationimpl.hpp"
 #include "private/logger.hpp"
@@ -89,6 +90,10 @@ namespace shareddatalayer
 
         void removeAllAsync(const Namespace& ns, const ModifyAck& modifyAck) override;
 
+        void subscribeChannelAsync(const Namespace& ns, const NotificationCb& notificationCb, const ModifyAck& modifyAck) override;
+
+        void unsubscribeChannel(const Namespace& ns) override;
+
         //public for UT
         AsyncStorage& getOperationHandler(const std::string& ns);
     private:
@@ -100,12 +105,16 @@ namespace shareddatalayer
         AsyncDatabaseDiscoveryCreator asyncDatabaseDiscoveryCreator;
 
         std::vector<std::shared_ptr<AsyncRedisStorage>> asyncStorages;
+        std::shared_ptr<AsyncShardedStorage> asyncShardedStorage;
 
         AsyncStorage& getRedisHandler(const std::string& ns);
         AsyncStorage& getDummyHandler();
 
         void setAsyncRedisStorageHandlers(const std::string& ns);
         void setAsyncRedisStorageHandlersForCluster(const std::string& ns);
+        void setAsyncShardedStorageHandler(const std::string& ns);
+        bool isShardedStorageUsed() const;
+        bool isSdlCluster() const;
         AsyncStorage& getAsyncRedisStorageHandler(const std::string& ns);
     };
 }
@@ -0,0 +1,89 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+#ifndef SHAREDDATALAYER_BENCHMARK_LATENCYHISTOGRAM_HPP_
+#define SHAREDDATALAYER_BENCHMARK_LATENCYHISTOGRAM_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+namespace shareddatalayer
+{
+    namespace benchmark
+    {
+        /**
+         * HDR style latency histogram with log-linear buckets. Values below
+         * 2 * SUB_BUCKETS are recorded exactly, larger values are recorded
+         * with relative precision of 1 / SUB_BUCKETS (about 1.6%). Recording
+         * a value is a couple of arithmetic operations and does not allocate,
+         * so a histogram can be updated from the benchmark hot path. Each
+         * benchmark thread uses its own histogram and the histograms are
+         * merged at the end.
+         */
+        class LatencyHistogram
+        {
+        public:
+            static const unsigned int SUB_BUCKET_BITS;
+            static const std::uint64_t SUB_BUCKETS;
+
+            LatencyHistogram();
+
+            void record(std::uint64_t value);
+
+            void merge(const LatencyHistogram& other);
+
+            std::uint64_t count() const { return totalCount; }
+
+            std::uint64_t min() const;
+
+            std::uint64_t max() const { return maxValue; }
+
+            double mean() const;
+
+            /**
+             * Returns the highest value which is equivalent (falls to the same
+             * bucket) to the value at the given percentile (0.0 - 100.0).
+             */
+            std::uint64_t valueAtPercentile(double percentile) const;
+
+            /**
+             * Writes the percentile distribution in the same format as
+             * HdrHistogram outputPercentileDistribution(), values divided by
+             * the given scale.
+             */
+            void printPercentileDistribution(std::ostream& out, double scale) const;
+
+            static std::size_t bucketIndex(std::uint64_t value);
+            static std::uint64_t bucketHighestEquivalentValue(std::size_t index);
+
+        private:
+            std::vector<std::uint64_t> counts;
+            std::uint64_t totalCount;
+            std::uint64_t minValue;
+            std::uint64_t maxValue;
+            long double sum;
+        };
+    }
+}
+
+#endif
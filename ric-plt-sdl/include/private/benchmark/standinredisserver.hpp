@@ -0,0 +1,103 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+#ifndef SHAREDDATALAYER_BENCHMARK_STANDINREDISSERVER_HPP_
+#define SHAREDDATALAYER_BENCHMARK_STANDINREDISSERVER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace shareddatalayer
+{
+    namespace benchmark
+    {
+        /**
+         * Minimal in-process stand-in for a redis-server with the DBaaS
+         * module commands. Speaks RESP over TCP on the loopback interface,
+         * so SDL is used unmodified through hiredis, and implements just the
+         * commands SDL issues (COMMAND, MSET(PUB), MGET, SETIE(PUB),
+         * SETNX(PUB), DEL(PUB), DELIE(PUB), KEYS). Published notifications
+         * are not delivered anywhere.
+         *
+         * The server is single threaded and keeps the data in memory. The
+         * time it spends executing commands is accounted, so the benchmark
+         * can tell how much of the observed latency is spent in the client.
+         */
+        class StandInRedisServer
+        {
+        public:
+            struct Statistics
+            {
+                std::uint64_t commands;
+                std::uint64_t busyNanoseconds;
+            };
+
+            /* Starts listening on 127.0.0.1 with a kernel selected port. */
+            StandInRedisServer();
+
+            ~StandInRedisServer();
+
+            StandInRedisServer(const StandInRedisServer&) = delete;
+            StandInRedisServer(StandInRedisServer&&) = delete;
+            StandInRedisServer& operator = (const StandInRedisServer&) = delete;
+            StandInRedisServer& operator = (StandInRedisServer&&) = delete;
+
+            std::uint16_t getPort() const { return port; }
+
+            Statistics getStatistics() const;
+
+            void resetStatistics();
+
+            static bool globMatch(const char* pattern, std::size_t patternLength,
+                                  const char* string, std::size_t stringLength);
+
+        private:
+            using Arguments = std::vector<std::string>;
+
+            struct Client
+            {
+                int fd;
+                std::string input;
+                std::string output;
+            };
+
+            int listenFd;
+            int wakeupFds[2];
+            std::uint16_t port;
+            std::map<std::string, std::string> data;
+            std::atomic<std::uint64_t> commands;
+            std::atomic<std::uint64_t> busyNanoseconds;
+            std::thread thread;
+
+            void run();
+            bool readFromClient(Client& client);
+            bool writeToClient(Client& client);
+            bool handleInput(Client& client);
+            void execute(const Arguments& arguments, std::string& output);
+        };
+    }
+}
+
+#endif
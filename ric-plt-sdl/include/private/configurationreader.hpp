@@ -27,6 +27,8 @@
 #define SENTINEL_PORT_ENV_VAR_NAME "DBAAS_SERVICE_SENTINEL_PORT"
 #define SENTINEL_MASTER_NAME_ENV_VAR_NAME "DBAAS_MASTER_NAME"
 #define DB_CLUSTER_ADDR_LIST_ENV_VAR_NAME "DBAAS_CLUSTER_ADDR_LIST"
+#define DB_SHARDING_MODE_ENV_VAR_NAME "DBAAS_SHARDING_MODE"
+#define DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME "DBAAS_CONNECTIONS_PER_SHARD"
 
 #include <iosfwd>
 #include <string>
@@ -75,6 +77,10 @@ namespace shareddatalayer
         std::string sentinelMasterNameEnvVariableValue;
         const std::string dbClusterAddrListEnvVariableName;
         std::string dbClusterAddrListEnvVariableValue;
+        const std::string dbShardingModeEnvVariableName;
+        std::string dbShardingModeEnvVariableValue;
+        const std::string dbConnectionsPerShardEnvVariableName;
+        std::string dbConnectionsPerShardEnvVariableValue;
         boost::optional<boost::property_tree::ptree> jsonDatabaseConfiguration;
         std::string sourceForDatabaseConfiguration;
         std::unordered_map<std::string, std::pair<boost::property_tree::ptree, std::string>> jsonNamespaceConfigurations;
@@ -33,6 +33,8 @@ namespace shareddatalayer
     {
     public:
         class InvalidDbType;
+        class InvalidShardingMode;
+        class InvalidConnectionsPerShard;
         using Addresses = std::vector<HostAndPort>;
         using SentinelPorts = std::vector<uint16_t>;
         using SentinelMasterNames = std::vector<std::string>;
@@ -45,18 +47,28 @@ namespace shareddatalayer
             SDL_STANDALONE_CLUSTER,
             SDL_SENTINEL_CLUSTER
         };
+        enum class ShardingMode
+        {
+            NAMESPACE = 0,
+            KEY
+        };
+        static constexpr std::size_t MAX_CONNECTIONS_PER_SHARD = 64U;
 
         virtual ~DatabaseConfiguration() = default;
         virtual void checkAndApplyDbType(const std::string& type) = 0;
         virtual void checkAndApplyServerAddress(const std::string& address) = 0;
         virtual void checkAndApplySentinelPorts(const std::string& sentinelPortsEnvStr) = 0;
         virtual void checkAndApplySentinelMasterNames(const std::string& sentinelMasterNamesEnvStr) = 0;
+        virtual void checkAndApplyShardingMode(const std::string& mode) = 0;
+        virtual void checkAndApplyConnectionsPerShard(const std::string& connections) = 0;
         virtual DatabaseConfiguration::DbType getDbType() const = 0;
         virtual DatabaseConfiguration::Addresses getServerAddresses() const = 0;
         virtual DatabaseConfiguration::Addresses getServerAddresses(const boost::optional<std::size_t>& addressIndex) const = 0;
         virtual DatabaseConfiguration::Addresses getDefaultServerAddresses() const = 0;
         virtual boost::optional<HostAndPort> getSentinelAddress(const boost::optional<std::size_t>& addressIndex) const = 0;
         virtual std::string getSentinelMasterName(const boost::optional<std::size_t>& addressIndex) const = 0;
+        virtual DatabaseConfiguration::ShardingMode getShardingMode() const = 0;
+        virtual std::size_t getConnectionsPerShard() const = 0;
         virtual bool isEmpty() const = 0;
 
         DatabaseConfiguration(DatabaseConfiguration&&) = delete;
@@ -75,6 +87,22 @@ namespace shareddatalayer
 
         explicit InvalidDbType(const std::string& type);
     };
+
+    class DatabaseConfiguration::InvalidShardingMode: public Exception
+    {
+    public:
+        InvalidShardingMode() = delete;
+
+        explicit InvalidShardingMode(const std::string& mode);
+    };
+
+    class DatabaseConfiguration::InvalidConnectionsPerShard: public Exception
+    {
+    public:
+        InvalidConnectionsPerShard() = delete;
+
+        explicit InvalidConnectionsPerShard(const std::string& connections);
+    };
 }
 
 #endif
@@ -41,6 +41,10 @@ namespace shareddatalayer
 
         void checkAndApplySentinelMasterNames(const std::string& sentinelMasterNamesEnvStr) override;
 
+        void checkAndApplyShardingMode(const std::string& mode) override;
+
+        void checkAndApplyConnectionsPerShard(const std::string& connections) override;
+
         DatabaseConfiguration::DbType getDbType() const override;
 
         DatabaseConfigurationImpl::Addresses getServerAddresses() const override;
@@ -53,6 +57,10 @@ namespace shareddatalayer
 
         std::string getSentinelMasterName(const boost::optional<std::size_t>& addressIndex) const override;
 
+        DatabaseConfiguration::ShardingMode getShardingMode() const override;
+
+        std::size_t getConnectionsPerShard() const override;
+
         bool isEmpty() const override;
 
     private:
@@ -60,6 +68,8 @@ namespace shareddatalayer
         Addresses serverAddresses;
         SentinelPorts sentinelPorts;
         SentinelMasterNames sentinelMasterNames;
+        ShardingMode shardingMode;
+        std::size_t connectionsPerShard;
     };
 }
 
@@ -23,6 +23,7 @@
 #define SHAREDDATALAYER_REDIS_ASYNCREDISSTORAGE_HPP_
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <queue>
 #include <boost/optional.hpp>
@@ -83,6 +84,15 @@ namespace shareddatalayer
                           std::shared_ptr<redis::ContentsBuilder> contentsBuilder,
                           std::shared_ptr<Logger> logger);
 
+        AsyncRedisStorage(std::shared_ptr<Engine> engine,
+                          std::shared_ptr<redis::AsyncDatabaseDiscovery> discovery,
+                          const boost::optional<PublisherId>& pId,
+                          std::shared_ptr<NamespaceConfigurations> namespaceConfigurations,
+                          const AsyncCommandDispatcherCreator& asyncCommandDispatcherCreator,
+                          const AsyncCommandDispatcherCreator& asyncSubscriberCreator,
+                          std::shared_ptr<redis::ContentsBuilder> contentsBuilder,
+                          std::shared_ptr<Logger> logger);
+
         ~AsyncRedisStorage() override;
 
         int fd() const override;
@@ -109,6 +119,10 @@ namespace shareddatalayer
 
         void removeAllAsync(const Namespace& ns, const ModifyAck& modifyAck) override;
 
+        void subscribeChannelAsync(const Namespace& ns, const NotificationCb& notificationCb, const ModifyAck& modifyAck) override;
+
+        void unsubscribeChannel(const Namespace& ns) override;
+
         redis::DatabaseInfo& getDatabaseInfo();
 
         std::string buildKeyPrefixSearchPattern(const Namespace& ns, const std::string& keyPrefix) const;
@@ -116,12 +130,22 @@ namespace shareddatalayer
         std::string buildNamespaceKeySearchPattern(const Namespace& ns, const std::string& pattern) const;
 
     private:
+        struct Subscription
+        {
+            NotificationCb notificationCb;
+            ModifyAck subscribeAck;
+        };
+
         std::shared_ptr<Engine> engine;
         std::shared_ptr<redis::AsyncCommandDispatcher> dispatcher;
+        std::shared_ptr<redis::AsyncCommandDispatcher> subscriber;
+        bool subscriberConnected;
+        std::map<Namespace, Subscription> subscriptions;
         std::shared_ptr<redis::AsyncDatabaseDiscovery> discovery;
         const boost::optional<PublisherId> publisherId;
         ReadyAck readyAck;
         AsyncCommandDispatcherCreator asyncCommandDispatcherCreator;
+        AsyncCommandDispatcherCreator asyncSubscriberCreator;
         std::shared_ptr<redis::ContentsBuilder> contentsBuilder;
         redis::DatabaseInfo dbInfo;
         std::shared_ptr<NamespaceConfigurations> namespaceConfigurations;
@@ -138,6 +162,14 @@ namespace shareddatalayer
         void conditionalCommandCallback(const std::error_code& error, const redis::Reply&, const ModifyIfAck&);
 
         void findKeys(const std::string& ns, const std::string& keyPattern, const FindKeysAck& findKeysAck);
+
+        void createSubscriber();
+
+        void subscriberConnectedCallback();
+
+        void subscribe(const Namespace& ns);
+
+        void subscribeCommandCallback(const std::error_code& error, const redis::Reply& reply, const Namespace& ns);
     };
 
     AsyncRedisStorage::ErrorCode& operator++ (AsyncRedisStorage::ErrorCode& ecEnum);
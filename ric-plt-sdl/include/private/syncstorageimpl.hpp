@@ -61,6 +61,12 @@ namespace shareddatalayer
 
         virtual void setOperationTimeout(const std::chrono::steady_clock::duration& timeout) override;
 
+        virtual void subscribeChannel(const Namespace& ns, const NotificationCb& notificationCb) override;
+
+        virtual void unsubscribeChannel(const Namespace& ns) override;
+
+        virtual void handleNotifications(const std::chrono::steady_clock::duration& timeout) override;
+
         static constexpr int NO_TIMEOUT = -1;
 
     private:
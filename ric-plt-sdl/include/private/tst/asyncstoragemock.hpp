@@ -50,6 +50,10 @@ namespace shareddatalayer
 
             MOCK_METHOD2(removeAllAsync, void(const Namespace& ns, const ModifyAck& modifyAck));
 
+            MOCK_METHOD3(subscribeChannelAsync, void(const Namespace& ns, const NotificationCb& notificationCb, const ModifyAck& modifyAck));
+
+            MOCK_METHOD1(unsubscribeChannel, void(const Namespace& ns));
+
             MOCK_METHOD2(waitReadyAsync, void(const Namespace& ns, const ReadyAck& readyAck));
 
             MOCK_CONST_METHOD0(fd, int());
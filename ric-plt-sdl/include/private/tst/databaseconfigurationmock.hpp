@@ -42,6 +42,10 @@ namespace shareddatalayer
             MOCK_CONST_METHOD0(isEmpty, bool());
             MOCK_CONST_METHOD1(getSentinelAddress, boost::optional<HostAndPort>(const boost::optional<std::size_t>& addressIndex));
             MOCK_CONST_METHOD1(getSentinelMasterName, std::string(const boost::optional<std::size_t>& addressIndex));
+            MOCK_METHOD1(checkAndApplyShardingMode, void(const std::string& mode));
+            MOCK_METHOD1(checkAndApplyConnectionsPerShard, void(const std::string& connections));
+            MOCK_CONST_METHOD0(getShardingMode, DatabaseConfiguration::ShardingMode());
+            MOCK_CONST_METHOD0(getConnectionsPerShard, std::size_t());
         };
     }
 }
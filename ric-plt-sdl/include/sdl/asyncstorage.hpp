@@ -340,6 +340,53 @@ namespace shareddatalayer
         virtual void removeAllAsync(const Namespace& ns,
                                     const ModifyAck& modifyAck) = 0;
 
+        /**
+         * Notification callback to be called when a change notification is received from a
+         * subscribed namespace.
+         *
+         * @param ns Namespace in which the data was modified.
+         * @param message Notification message. For modifications done via shareddatalayer API the
+         *                message is the publisher ID of the modifying client, or
+         *                <code>shareddatalayer::NO_PUBLISHER</code> if the client did not set one.
+         */
+        using NotificationCb = std::function<void(const Namespace& ns, const std::string& message)>;
+
+        /**
+         * Subscribe to change notifications of a namespace. Notifications are published by
+         * shareddatalayer whenever data of the namespace is modified and notifications have
+         * been enabled for the namespace in the namespace configuration.
+         *
+         * Notifications are received via a dedicated connection to the backend data storage.
+         * The connection is monitored via the same file descriptor as all other operations
+         * (see fd()). If the connection is lost or the backend data storage fails over to
+         * another instance, the subscription is restored automatically. Notifications
+         * published while the connection is down are not delivered, thus once the subscription
+         * has been restored the notification callback is called with
+         * <code>shareddatalayer::NO_PUBLISHER</code> message. Client is advised to refresh its
+         * data from shared data layer storage when receiving it.
+         *
+         * Subscribing again to an already subscribed namespace replaces the notification
+         * callback.
+         *
+         * @param ns Namespace whose change notifications are subscribed.
+         * @param notificationCb The callback to be called for every received notification.
+         *                       The given function is called in the context of handleEvents() function.
+         * @param modifyAck The acknowledgement to be called once the subscription is active.
+         *                  The given function is called in the context of handleEvents() function.
+         */
+        virtual void subscribeChannelAsync(const Namespace& ns,
+                                           const NotificationCb& notificationCb,
+                                           const ModifyAck& modifyAck) = 0;
+
+        /**
+         * Unsubscribe change notifications of a namespace. The notification callback given to
+         * subscribeChannelAsync() is not called for the namespace after this function returns.
+         * Unsubscribing a namespace which is not subscribed has no effect.
+         *
+         * @param ns Namespace whose change notifications are unsubscribed.
+         */
+        virtual void unsubscribeChannel(const Namespace& ns) = 0;
+
         /**
          * Create a new instance of AsyncStorage.
          *
@@ -330,6 +330,59 @@ namespace shareddatalayer
          */
          virtual void setOperationTimeout(const std::chrono::steady_clock::duration& timeout) = 0;
 
+        /**
+         * Notification callback to be called when a change notification is received from a
+         * subscribed namespace.
+         *
+         * @param ns Namespace in which the data was modified.
+         * @param message Notification message. For modifications done via shareddatalayer API the
+         *                message is the publisher ID of the modifying client, or
+         *                <code>shareddatalayer::NO_PUBLISHER</code> if the client did not set one
+         *                or if notifications may have been lost due to a connection break.
+         */
+        using NotificationCb = std::function<void(const Namespace& ns, const std::string& message)>;
+
+        /**
+         * Subscribe to change notifications of a namespace. Function returns once the
+         * subscription is active. Received notifications are delivered from within
+         * handleNotifications() function and from within any other SyncStorage function call.
+         * The subscription is restored automatically after a connection break or a failover
+         * of the backend data storage.
+         *
+         * Exceptions thrown (excluding standard exceptions such as std::bad_alloc) are all derived from
+         * shareddatalayer::Exception base class. Client can catch only that exception if separate handling
+         * for different shareddatalayer error situations is not needed.
+         *
+         * @param ns Namespace whose change notifications are subscribed.
+         * @param notificationCb The callback to be called for every received notification.
+         *
+         * @throw BackendError if the backend data storage fails to process the request.
+         * @throw NotConnected if shareddatalayer is not connected to the backend data storage.
+         * @throw OperationInterrupted if shareddatalayer does not receive a reply from the backend data storage.
+         * @throw InvalidNamespace if given namespace does not meet the namespace format restrictions.
+         *
+         * @see AsyncStorage::subscribeChannelAsync
+         */
+        virtual void subscribeChannel(const Namespace& ns,
+                                      const NotificationCb& notificationCb) = 0;
+
+        /**
+         * Unsubscribe change notifications of a namespace. The notification callback given to
+         * subscribeChannel() is not called for the namespace after this function returns.
+         *
+         * @param ns Namespace whose change notifications are unsubscribed.
+         */
+        virtual void unsubscribeChannel(const Namespace& ns) = 0;
+
+        /**
+         * Wait for change notifications of the subscribed namespaces and call their
+         * notification callbacks. Function returns after the given timeout has expired.
+         *
+         * @param timeout Maximum time to wait for notifications. Value 0 handles only the
+         *                notifications which have already been received.
+         */
+        virtual void handleNotifications(const std::chrono::steady_clock::duration& timeout) = 0;
+
         /**
          * Create a new instance of SyncStorage.
          *
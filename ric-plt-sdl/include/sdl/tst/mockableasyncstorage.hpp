@@ -70,6 +70,10 @@ namespace shareddatalayer
 
             virtual void removeAllAsync(const Namespace&, const ModifyAck&) override { logAndAbort(__PRETTY_FUNCTION__); }
 
+            virtual void subscribeChannelAsync(const Namespace&, const NotificationCb&, const ModifyAck&) override { logAndAbort(__PRETTY_FUNCTION__); }
+
+            virtual void unsubscribeChannel(const Namespace&) override { logAndAbort(__PRETTY_FUNCTION__); }
+
         private:
             static void logAndAbort(const char* function) noexcept __attribute__ ((__noreturn__))
             {
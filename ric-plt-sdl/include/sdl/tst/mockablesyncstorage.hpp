@@ -68,6 +68,12 @@ namespace shareddatalayer
 
             virtual void setOperationTimeout(const std::chrono::steady_clock::duration&) override { logAndAbort(__PRETTY_FUNCTION__); }
 
+            virtual void subscribeChannel(const Namespace&, const NotificationCb&) override { logAndAbort(__PRETTY_FUNCTION__); }
+
+            virtual void unsubscribeChannel(const Namespace&) override { logAndAbort(__PRETTY_FUNCTION__); }
+
+            virtual void handleNotifications(const std::chrono::steady_clock::duration&) override { logAndAbort(__PRETTY_FUNCTION__); }
+
         private:
             static void logAndAbort(const char* function) noexcept __attribute__ ((__noreturn__))
             {
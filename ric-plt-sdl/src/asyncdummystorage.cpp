@@ -94,3 +94,12 @@ void AsyncDummyStorage::removeAllAsync(const Namespace&, const ModifyAck& modify
 {
     postCallback(std::bind(modifyAck, std::error_code()));
 }
+
+void AsyncDummyStorage::subscribeChannelAsync(const Namespace&, const NotificationCb&, const ModifyAck& modifyAck)
+{
+    postCallback(std::bind(modifyAck, std::error_code()));
+}
+
+void AsyncDummyStorage::unsubscribeChannel(const Namespace&)
+{
+}
@@ -0,0 +1,373 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+#include "private/asyncshardedstorage.hpp"
+#include <algorithm>
+#include <map>
+#include <boost/crc.hpp>
+#include "private/abort.hpp"
+#include "private/engine.hpp"
+
+using namespace shareddatalayer;
+
+const std::size_t AsyncShardedStorage::VIRTUAL_NODES_PER_SHARD(160U);
+
+namespace
+{
+    std::uint32_t crc32(const std::string& s)
+    {
+        boost::crc_32_type result;
+        result.process_bytes(s.data(), s.size());
+        return result.checksum();
+    }
+
+    std::string getHashedPartOfKey(const AsyncStorage::Key& key)
+    {
+        auto start(key.find('{'));
+        if (start != std::string::npos)
+        {
+            auto end(key.find('}', start + 1));
+            if (end != std::string::npos && end > start + 1)
+                return key.substr(start + 1, end - start - 1);
+        }
+        return key;
+    }
+
+    struct ModifyAckState
+    {
+        std::size_t pending;
+        std::error_code error;
+        AsyncStorage::ModifyAck modifyAck;
+    };
+
+    AsyncStorage::ModifyAck mergeModifyAcks(std::size_t count, const AsyncStorage::ModifyAck& modifyAck)
+    {
+        auto state(std::make_shared<ModifyAckState>(ModifyAckState { count, std::error_code(), modifyAck }));
+        return [state](const std::error_code& error)
+               {
+                   if (error && !state->error)
+                       state->error = error;
+                   if (--state->pending == 0)
+                       state->modifyAck(state->error);
+               };
+    }
+
+    struct GetAckState
+    {
+        std::size_t pending;
+        std::error_code error;
+        AsyncStorage::DataMap dataMap;
+        AsyncStorage::GetAck getAck;
+    };
+
+    AsyncStorage::GetAck mergeGetAcks(std::size_t count, const AsyncStorage::GetAck& getAck)
+    {
+        auto state(std::make_shared<GetAckState>(GetAckState { count, std::error_code(), AsyncStorage::DataMap(), getAck }));
+        return [state](const std::error_code& error, const AsyncStorage::DataMap& dataMap)
+               {
+                   if (error && !state->error)
+                       state->error = error;
+                   else if (!error)
+                       state->dataMap.insert(dataMap.begin(), dataMap.end());
+                   if (--state->pending == 0)
+                   {
+                       if (state->error)
+                           state->getAck(state->error, AsyncStorage::DataMap());
+                       else
+                           state->getAck(state->error, state->dataMap);
+                   }
+               };
+    }
+
+    struct FindKeysAckState
+    {
+        std::size_t pending;
+        std::error_code error;
+        AsyncStorage::Keys keys;
+        AsyncStorage::FindKeysAck findKeysAck;
+    };
+
+    AsyncStorage::FindKeysAck mergeFindKeysAcks(std::size_t count, const AsyncStorage::FindKeysAck& findKeysAck)
+    {
+        auto state(std::make_shared<FindKeysAckState>(FindKeysAckState { count, std::error_code(), AsyncStorage::Keys(), findKeysAck }));
+        return [state](const std::error_code& error, const AsyncStorage::Keys& keys)
+               {
+                   if (error && !state->error)
+                       state->error = error;
+                   else if (!error)
+                       state->keys.insert(keys.begin(), keys.end());
+                   if (--state->pending == 0)
+                   {
+                       if (state->error)
+                           state->findKeysAck(state->error, AsyncStorage::Keys());
+                       else
+                           state->findKeysAck(state->error, state->keys);
+                   }
+               };
+    }
+}
+
+AsyncShardedStorage::AsyncShardedStorage(std::shared_ptr<Engine> engine,
+                                         const Shards& shards,
+                                         DatabaseConfiguration::ShardingMode shardingMode):
+    engine(engine),
+    shards(shards),
+    shardingMode(shardingMode)
+{
+    if (shards.empty())
+        SHAREDDATALAYER_ABORT("At least one shard is required");
+
+    for (std::size_t shardIndex = 0; shardIndex < shards.size(); ++shardIndex)
+    {
+        if (shards[shardIndex].connections.empty())
+            SHAREDDATALAYER_ABORT("At least one connection per shard is required");
+
+        for (std::size_t node = 0; node < VIRTUAL_NODES_PER_SHARD; ++node)
+            ring.emplace_back(crc32(shards[shardIndex].id + '-' + std::to_string(node)), shardIndex);
+    }
+    std::sort(ring.begin(), ring.end());
+}
+
+int AsyncShardedStorage::fd() const
+{
+    return engine->fd();
+}
+
+void AsyncShardedStorage::handleEvents()
+{
+    engine->handleEvents();
+}
+
+std::size_t AsyncShardedStorage::getShardIndex(const Namespace& ns, const Key& key) const
+{
+    if (shardingMode == DatabaseConfiguration::ShardingMode::NAMESPACE)
+        return crc32(ns) % shards.size();
+
+    const std::pair<std::uint32_t, std::size_t> node(crc32(ns + ',' + getHashedPartOfKey(key)), 0U);
+    auto i(std::lower_bound(ring.begin(), ring.end(), node));
+    if (i == ring.end())
+        i = ring.begin();
+    return i->second;
+}
+
+AsyncShardedStorage::Route AsyncShardedStorage::getRoute(const Namespace& ns, const Key& key) const
+{
+    const auto shardIndex(getShardIndex(ns, key));
+    const auto connectionCount(shards[shardIndex].connections.size());
+    if (connectionCount == 1)
+        return Route(shardIndex, 0U);
+    return Route(shardIndex, crc32(getHashedPartOfKey(key)) % connectionCount);
+}
+
+AsyncStorage& AsyncShardedStorage::getConnection(const Route& route) const
+{
+    return *shards[route.first].connections[route.second];
+}
+
+AsyncStorage& AsyncShardedStorage::getDefaultConnection(const Namespace& ns) const
+{
+    if (shardingMode == DatabaseConfiguration::ShardingMode::NAMESPACE)
+        return getConnection(Route(getShardIndex(ns, Key()), 0U));
+    return getConnection(Route(0U, 0U));
+}
+
+std::vector<std::size_t> AsyncShardedStorage::getShardIndexes(const Namespace& ns) const
+{
+    if (shardingMode == DatabaseConfiguration::ShardingMode::NAMESPACE)
+        return { getShardIndex(ns, Key()) };
+
+    std::vector<std::size_t> indexes(shards.size());
+    for (std::size_t i = 0; i < indexes.size(); ++i)
+        indexes[i] = i;
+    return indexes;
+}
+
+AsyncShardedStorage::Connections AsyncShardedStorage::getConnections(const Namespace& ns) const
+{
+    Connections connections;
+    for (auto shardIndex : getShardIndexes(ns))
+        connections.insert(connections.end(), shards[shardIndex].connections.begin(), shards[shardIndex].connections.end());
+    return connections;
+}
+
+void AsyncShardedStorage::waitReadyAsync(const Namespace& ns,
+                                         const ReadyAck& readyAck)
+{
+    const auto connections(getConnections(ns));
+    const auto mergedAck(mergeModifyAcks(connections.size(), readyAck));
+    for (auto& connection : connections)
+        connection->waitReadyAsync(ns, mergedAck);
+}
+
+void AsyncShardedStorage::setAsync(const Namespace& ns,
+                                   const DataMap& dataMap,
+                                   const ModifyAck& modifyAck)
+{
+    if (dataMap.empty())
+    {
+        getDefaultConnection(ns).setAsync(ns, dataMap, modifyAck);
+        return;
+    }
+
+    std::map<Route, DataMap> dataMaps;
+    for (const auto& i : dataMap)
+        dataMaps[getRoute(ns, i.first)].insert(i);
+
+    if (dataMaps.size() == 1)
+    {
+        getConnection(dataMaps.begin()->first).setAsync(ns, dataMap, modifyAck);
+        return;
+    }
+
+    const auto mergedAck(mergeModifyAcks(dataMaps.size(), modifyAck));
+    for (const auto& i : dataMaps)
+        getConnection(i.first).setAsync(ns, i.second, mergedAck);
+}
+
+void AsyncShardedStorage::setIfAsync(const Namespace& ns,
+                                     const Key& key,
+                                     const Data& oldData,
+                                     const Data& newData,
+                                     const ModifyIfAck& modifyIfAck)
+{
+    getConnection(getRoute(ns, key)).setIfAsync(ns, key, oldData, newData, modifyIfAck);
+}
+
+void AsyncShardedStorage::setIfNotExistsAsync(const Namespace& ns,
+                                              const Key& key,
+                                              const Data& data,
+                                              const ModifyIfAck& modifyIfAck)
+{
+    getConnection(getRoute(ns, key)).setIfNotExistsAsync(ns, key, data, modifyIfAck);
+}
+
+void AsyncShardedStorage::getAsync(const Namespace& ns,
+                                   const Keys& keys,
+                                   const GetAck& getAck)
+{
+    if (keys.empty())
+    {
+        getDefaultConnection(ns).getAsync(ns, keys, getAck);
+        return;
+    }
+
+    std::map<Route, Keys> keySets;
+    for (const auto& key : keys)
+        keySets[getRoute(ns, key)].insert(key);
+
+    if (keySets.size() == 1)
+    {
+        getConnection(keySets.begin()->first).getAsync(ns, keys, getAck);
+        return;
+    }
+
+    const auto mergedAck(mergeGetAcks(keySets.size(), getAck));
+    for (const auto& i : keySets)
+        getConnection(i.first).getAsync(ns, i.second, mergedAck);
+}
+
+void AsyncShardedStorage::removeAsync(const Namespace& ns,
+                                      const Keys& keys,
+                                      const ModifyAck& modifyAck)
+{
+    if (keys.empty())
+    {
+        getDefaultConnection(ns).removeAsync(ns, keys, modifyAck);
+        return;
+    }
+
+    std::map<Route, Keys> keySets;
+    for (const auto& key : keys)
+        keySets[getRoute(ns, key)].insert(key);
+
+    if (keySets.size() == 1)
+    {
+        getConnection(keySets.begin()->first).removeAsync(ns, keys, modifyAck);
+        return;
+    }
+
+    const auto mergedAck(mergeModifyAcks(keySets.size(), modifyAck));
+    for (const auto& i : keySets)
+        getConnection(i.first).removeAsync(ns, i.second, mergedAck);
+}
+
+void AsyncShardedStorage::removeIfAsync(const Namespace& ns,
+                                        const Key& key,
+                                        const Data& data,
+                                        const ModifyIfAck& modifyIfAck)
+{
+    getConnection(getRoute(ns, key)).removeIfAsync(ns, key, data, modifyIfAck);
+}
+
+void AsyncShardedStorage::findKeysAsync(const Namespace& ns,
+                                        const std::string& keyPrefix,
+                                        const FindKeysAck& findKeysAck)
+{
+    /* Sent on every connection, so that keys set by any operation issued before
+     * this one are found. Keys are merged, so duplicates are reported once.
+     */
+    const auto connections(getConnections(ns));
+    const auto mergedAck(mergeFindKeysAcks(connections.size(), findKeysAck));
+    for (auto& connection : connections)
+        connection->findKeysAsync(ns, keyPrefix, mergedAck);
+}
+
+void AsyncShardedStorage::listKeys(const Namespace& ns,
+                                   const std::string& pattern,
+                                   const FindKeysAck& findKeysAck)
+{
+    const auto connections(getConnections(ns));
+    const auto mergedAck(mergeFindKeysAcks(connections.size(), findKeysAck));
+    for (auto& connection : connections)
+        connection->listKeys(ns, pattern, mergedAck);
+}
+
+void AsyncShardedStorage::removeAllAsync(const Namespace& ns,
+                                         const ModifyAck& modifyAck)
+{
+    /* Sent on every connection, so that keys set by any operation issued before
+     * this one are removed; a connection only removes what is left when it
+     * gets its turn, so the extra removals are cheap.
+     */
+    const auto connections(getConnections(ns));
+    const auto mergedAck(mergeModifyAcks(connections.size(), modifyAck));
+    for (auto& connection : connections)
+        connection->removeAllAsync(ns, mergedAck);
+}
+
+void AsyncShardedStorage::subscribeChannelAsync(const Namespace& ns,
+                                                const NotificationCb& notificationCb,
+                                                const ModifyAck& modifyAck)
+{
+    /* Modifications are published by the shard which stores the key, so
+     * subscription is needed from every shard the namespace is spread to.
+     */
+    const auto shardIndexes(getShardIndexes(ns));
+    const auto mergedAck(mergeModifyAcks(shardIndexes.size(), modifyAck));
+    for (auto shardIndex : shardIndexes)
+        getConnection(Route(shardIndex, 0U)).subscribeChannelAsync(ns, notificationCb, mergedAck);
+}
+
+void AsyncShardedStorage::unsubscribeChannel(const Namespace& ns)
+{
+    for (auto shardIndex : getShardIndexes(ns))
+        getConnection(Route(shardIndex, 0U)).unsubscribeChannel(ns);
+}
@@ -115,10 +115,63 @@ void AsyncStorageImpl::setAsyncRedisStorageHandlersForCluster(const std::string&
     }
 }
 
+bool AsyncStorageImpl::isSdlCluster() const
+{
+    return DatabaseConfiguration::DbType::SDL_STANDALONE_CLUSTER == databaseConfiguration->getDbType() ||
+           DatabaseConfiguration::DbType::SDL_SENTINEL_CLUSTER == databaseConfiguration->getDbType();
+}
+
+bool AsyncStorageImpl::isShardedStorageUsed() const
+{
+    if (DatabaseConfiguration::DbType::REDIS_CLUSTER == databaseConfiguration->getDbType())
+        return false;
+
+    return DatabaseConfiguration::ShardingMode::KEY == databaseConfiguration->getShardingMode() ||
+           databaseConfiguration->getConnectionsPerShard() > 1;
+}
+
+void AsyncStorageImpl::setAsyncShardedStorageHandler(const std::string& ns)
+{
+    const auto serverCount(isSdlCluster() ? databaseConfiguration->getServerAddresses().size() : 1U);
+    const auto connectionsPerShard(databaseConfiguration->getConnectionsPerShard());
+    AsyncShardedStorage::Shards shards;
+    for (std::size_t addrIndex = 0; addrIndex < serverCount; addrIndex++)
+    {
+        boost::optional<std::size_t> addressIndex;
+        if (isSdlCluster())
+            addressIndex = addrIndex;
+        AsyncShardedStorage::Shard shard;
+        shard.id = databaseConfiguration->getServerAddresses(addressIndex).front().getString();
+        for (std::size_t connection = 0; connection < connectionsPerShard; connection++)
+        {
+            auto redisHandler = std::make_shared<AsyncRedisStorage>(engine,
+                                                                    asyncDatabaseDiscoveryCreator(
+                                                                            engine,
+                                                                            ns,
+                                                                            std::ref(*databaseConfiguration),
+                                                                            addressIndex,
+                                                                            logger),
+                                                                    publisherId,
+                                                                    namespaceConfigurations,
+                                                                    logger);
+            asyncStorages.push_back(redisHandler);
+            shard.connections.push_back(redisHandler);
+        }
+        shards.push_back(shard);
+    }
+    asyncShardedStorage = std::make_shared<AsyncShardedStorage>(engine,
+                                                                shards,
+                                                                databaseConfiguration->getShardingMode());
+}
+
 void AsyncStorageImpl::setAsyncRedisStorageHandlers(const std::string& ns)
 {
-    if (DatabaseConfiguration::DbType::SDL_STANDALONE_CLUSTER == databaseConfiguration->getDbType() ||
-        DatabaseConfiguration::DbType::SDL_SENTINEL_CLUSTER == databaseConfiguration->getDbType())
+    if (isShardedStorageUsed())
+    {
+            setAsyncShardedStorageHandler(ns);
+            return;
+    }
+    if (isSdlCluster())
     {
             setAsyncRedisStorageHandlersForCluster(ns);
             return;
@@ -138,9 +191,11 @@ void AsyncStorageImpl::setAsyncRedisStorageHandlers(const std::string& ns)
 
 AsyncStorage& AsyncStorageImpl::getAsyncRedisStorageHandler(const std::string& ns)
 {
+    if (asyncShardedStorage)
+        return *asyncShardedStorage;
+
     std::size_t handlerIndex{0};
-    if (DatabaseConfiguration::DbType::SDL_STANDALONE_CLUSTER == databaseConfiguration->getDbType() ||
-        DatabaseConfiguration::DbType::SDL_SENTINEL_CLUSTER == databaseConfiguration->getDbType())
+    if (isSdlCluster())
         handlerIndex = getClusterHashIndex(ns, databaseConfiguration->getServerAddresses().size());
     return *asyncStorages.at(handlerIndex);
 }
@@ -253,3 +308,15 @@ void AsyncStorageImpl::removeAllAsync(const Namespace& ns,
 {
     getOperationHandler(ns).removeAllAsync(ns, modifyAck);
 }
+
+void AsyncStorageImpl::subscribeChannelAsync(const Namespace& ns,
+                                             const NotificationCb& notificationCb,
+                                             const ModifyAck& modifyAck)
+{
+    getOperationHandler(ns).subscribeChannelAsync(ns, notificationCb, modifyAck);
+}
+
+void AsyncStorageImpl::unsubscribeChannel(const Namespace& ns)
+{
+    getOperationHandler(ns).unsubscribeChannel(ns);
+}
@@ -0,0 +1,157 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+#include "private/benchmark/latencyhistogram.hpp"
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <boost/io/ios_state.hpp>
+
+using namespace shareddatalayer::benchmark;
+
+namespace
+{
+    unsigned int highestBit(std::uint64_t value)
+    {
+        return 63U - static_cast<unsigned int>(__builtin_clzll(value));
+    }
+}
+
+const unsigned int LatencyHistogram::SUB_BUCKET_BITS(6U);
+const std::uint64_t LatencyHistogram::SUB_BUCKETS(1ULL << LatencyHistogram::SUB_BUCKET_BITS);
+
+LatencyHistogram::LatencyHistogram():
+    counts(bucketIndex(std::numeric_limits<std::uint64_t>::max()) + 1U, 0U),
+    totalCount(0U),
+    minValue(std::numeric_limits<std::uint64_t>::max()),
+    maxValue(0U),
+    sum(0.0L)
+{
+}
+
+std::size_t LatencyHistogram::bucketIndex(std::uint64_t value)
+{
+    /* Values below 2 * SUB_BUCKETS have a bucket of their own. After that
+     * every power of two range is split to SUB_BUCKETS linear buckets. */
+    if (value < 2U * SUB_BUCKETS)
+        return static_cast<std::size_t>(value);
+    const auto magnitude(highestBit(value));
+    const auto shift(magnitude - SUB_BUCKET_BITS);
+    const auto subBucket((value >> shift) - SUB_BUCKETS);
+    return static_cast<std::size_t>(2U * SUB_BUCKETS + (magnitude - SUB_BUCKET_BITS - 1U) * SUB_BUCKETS + subBucket);
+}
+
+std::uint64_t LatencyHistogram::bucketHighestEquivalentValue(std::size_t index)
+{
+    if (index < 2U * SUB_BUCKETS)
+        return index;
+    const auto group((index - 2U * SUB_BUCKETS) / SUB_BUCKETS);
+    const auto shift(group + 1U);
+    const auto subBucket(SUB_BUCKETS + (index - 2U * SUB_BUCKETS) % SUB_BUCKETS);
+    return (subBucket << shift) + ((1ULL << shift) - 1U);
+}
+
+void LatencyHistogram::record(std::uint64_t value)
+{
+    ++counts[bucketIndex(value)];
+    ++totalCount;
+    if (value < minValue)
+        minValue = value;
+    if (value > maxValue)
+        maxValue = value;
+    sum += value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (std::size_t i = 0; i < counts.size(); ++i)
+        counts[i] += other.counts[i];
+    totalCount += other.totalCount;
+    if (other.minValue < minValue)
+        minValue = other.minValue;
+    if (other.maxValue > maxValue)
+        maxValue = other.maxValue;
+    sum += other.sum;
+}
+
+std::uint64_t LatencyHistogram::min() const
+{
+    return totalCount ? minValue : 0U;
+}
+
+double LatencyHistogram::mean() const
+{
+    return totalCount ? static_cast<double>(sum / totalCount) : 0.0;
+}
+
+std::uint64_t LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (!totalCount)
+        return 0U;
+    if (percentile >= 100.0)
+        return maxValue;
+    auto target(static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * totalCount)));
+    if (target == 0U)
+        target = 1U;
+    std::uint64_t accumulated(0U);
+    for (std::size_t i = 0; i < counts.size(); ++i)
+    {
+        accumulated += counts[i];
+        if (accumulated >= target)
+        {
+            const auto value(bucketHighestEquivalentValue(i));
+            return value < maxValue ? value : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+void LatencyHistogram::printPercentileDistribution(std::ostream& out, double scale) const
+{
+    boost::io::ios_all_saver guard(out);
+    out << std::setw(12) << "Value" << ' '
+        << std::setw(14) << "Percentile" << ' '
+        << std::setw(10) << "TotalCount" << ' '
+        << std::setw(14) << "1/(1-Percentile)" << "\n\n";
+    out << std::fixed;
+    std::uint64_t accumulated(0U);
+    for (std::size_t i = 0; i < counts.size() && accumulated < totalCount; ++i)
+    {
+        if (!counts[i])
+            continue;
+        accumulated += counts[i];
+        const auto fraction(static_cast<double>(accumulated) / totalCount);
+        const auto value(accumulated == totalCount ? maxValue : bucketHighestEquivalentValue(i));
+        out << std::setw(12) << std::setprecision(3) << value / scale << ' '
+            << std::setw(14) << std::setprecision(12) << fraction << ' '
+            << std::setw(10) << accumulated;
+        if (accumulated < totalCount)
+            out << ' ' << std::setw(14) << std::setprecision(2) << 1.0 / (1.0 - fraction);
+        out << '\n';
+    }
+    out << "#[Mean    = " << std::setprecision(3) << mean() / scale
+        << ", Min           = " << min() / scale << "]\n"
+        << "#[Max     = " << max() / scale
+        << ", Total count   = " << totalCount << "]\n"
+        << "#[Buckets = " << counts.size()
+        << ", SubBuckets    = " << SUB_BUCKETS << "]\n";
+}
@@ -0,0 +1,62 @@
+#!/bin/bash
+#
+#   Copyright (c) 2018-2022 Nokia.
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+#
+
+#
+# Starts local redis-server instances and runs sdlshardingbenchmark with
+# 1..MAX_SHARDS shards in key sharding mode. Throughput should grow nearly
+# linearly with the shard count as long as the client is not the bottleneck.
+#
+# Usage: run-sharding-benchmark.sh [MAX_SHARDS] [CONNECTIONS_PER_SHARD] [benchmark options]
+#
+
+set -e
+
+MAX_SHARDS=${1:-4}
+CONNECTIONS_PER_SHARD=${2:-2}
+shift 2 || true
+BASE_PORT=${BASE_PORT:-26400}
+BENCHMARK=${BENCHMARK:-$(dirname "$0")/../../sdlshardingbenchmark}
+WORKDIR=$(mktemp -d)
+PIDS=()
+
+cleanup()
+{
+    for pid in "${PIDS[@]}"; do
+        kill "$pid" 2>/dev/null || true
+    done
+    rm -rf "$WORKDIR"
+}
+trap cleanup EXIT
+
+for ((i = 0; i < MAX_SHARDS; i++)); do
+    redis-server --port $((BASE_PORT + i)) --save "" --appendonly no --dir "$WORKDIR" --daemonize no > "$WORKDIR/redis-$i.log" 2>&1 &
+    PIDS+=($!)
+done
+sleep 1
+
+for ((shards = 1; shards <= MAX_SHARDS; shards++)); do
+    addresses=""
+    for ((i = 0; i < shards; i++)); do
+        addresses="${addresses:+$addresses,}127.0.0.1:$((BASE_PORT + i))"
+    done
+    echo -n "shards: $shards connections per shard: $CONNECTIONS_PER_SHARD "
+    DBAAS_SERVICE_HOST=127.0.0.1 \
+    DBAAS_CLUSTER_ADDR_LIST=$addresses \
+    DBAAS_SHARDING_MODE=key \
+    DBAAS_CONNECTIONS_PER_SHARD=$CONNECTIONS_PER_SHARD \
+        "$BENCHMARK" "$@"
+done
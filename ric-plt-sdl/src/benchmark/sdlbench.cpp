@@ -0,0 +1,540 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+/*
+ * AsyncStorage benchmark with set, get, multi-key set/get, key search
+ * (listKeys) and setIf workloads. Each benchmark thread has its own SDL instance (and thus its own
+ * DB connection) and keeps a configurable number of operations in flight, so
+ * requests are pipelined on the connection. Latency of every operation is
+ * recorded to a histogram.
+ *
+ * With "--backend redis" the database configuration is read the normal way
+ * (DBAAS_* environment variables or configuration files). With
+ * "--backend standin" (the default) an in-process Redis protocol stand-in is
+ * started and SDL is pointed to it, so the benchmark runs without a
+ * redis-server and the time the stand-in spends executing the commands is
+ * reported separately from the latency seen by the client.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/optional.hpp>
+#include <boost/program_options.hpp>
+#include <sdl/asyncstorage.hpp>
+#include <sdl/exception.hpp>
+#include "private/benchmark/latencyhistogram.hpp"
+#include "private/benchmark/standinredisserver.hpp"
+
+using namespace shareddatalayer;
+using namespace shareddatalayer::benchmark;
+
+namespace
+{
+    namespace po = boost::program_options;
+
+    enum class Workload
+    {
+        SET,
+        GET,
+        MULTI_SET,
+        MULTI_GET,
+        FIND_KEYS,
+        SET_IF,
+    };
+
+    const struct
+    {
+        const char* name;
+        Workload workload;
+    } workloadNames[] =
+    {
+        { "set", Workload::SET },
+        { "get", Workload::GET },
+        { "mset", Workload::MULTI_SET },
+        { "mget", Workload::MULTI_GET },
+        { "findkeys", Workload::FIND_KEYS },
+        { "setif", Workload::SET_IF },
+    };
+
+    const std::size_t PRELOAD_KEYS_PER_OPERATION(100U);
+
+    const char* getWorkloadName(Workload workload)
+    {
+        for (const auto& i : workloadNames)
+            if (i.workload == workload)
+                return i.name;
+        return "unknown";
+    }
+
+    std::vector<Workload> parseWorkloads(const std::string& list)
+    {
+        std::vector<std::string> names;
+        boost::split(names, list, boost::is_any_of(","), boost::token_compress_on);
+        std::vector<Workload> workloads;
+        for (const auto& name : names)
+        {
+            if (name.empty())
+                continue;
+            const auto it(std::find_if(std::begin(workloadNames), std::end(workloadNames),
+                                       [&name](decltype(workloadNames[0]) i) { return name == i.name; }));
+            if (it == std::end(workloadNames))
+                throw po::validation_error(po::validation_error::invalid_option_value, "workloads", name);
+            workloads.push_back(it->workload);
+        }
+        return workloads;
+    }
+
+    struct Options
+    {
+        std::string ns;
+        std::vector<Workload> workloads;
+        std::size_t duration;
+        std::size_t threads;
+        std::size_t depth;
+        std::size_t keyCount;
+        std::size_t keysPerOperation;
+        std::size_t valueSize;
+        bool printHistogram;
+    };
+
+    /* Reusable barrier for synchronizing the workload phases of the threads. */
+    class Barrier
+    {
+    public:
+        explicit Barrier(std::size_t count): count(count), waiting(0), generation(0) { }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            const auto currentGeneration(generation);
+            if (++waiting == count)
+            {
+                waiting = 0;
+                ++generation;
+                cv.notify_all();
+                return;
+            }
+            cv.wait(lock, [this, currentGeneration]() { return generation != currentGeneration; });
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        const std::size_t count;
+        std::size_t waiting;
+        std::size_t generation;
+    };
+
+    struct Result
+    {
+        std::size_t completed;
+        std::size_t failed;
+        std::size_t notModified;
+        LatencyHistogram histogram;
+
+        Result(): completed(0), failed(0), notModified(0) { }
+    };
+
+    class Worker
+    {
+    public:
+        Worker(const Options& options, std::size_t index);
+
+        void run(Barrier& barrier);
+
+        const Result& getResult(Workload workload) const { return results[static_cast<std::size_t>(workload)]; }
+
+        bool hasFailed() const { return failed; }
+
+    private:
+        const Options& options;
+        const std::size_t index;
+        const std::string keyPrefix;
+        const AsyncStorage::Data valueA;
+        const AsyncStorage::Data valueB;
+        std::unique_ptr<AsyncStorage> storage;
+        std::vector<Result> results;
+        /* setIf workload: true if the key currently has valueB */
+        std::vector<bool> hasValueB;
+        Workload workload;
+        std::chrono::steady_clock::time_point end;
+        std::size_t nextKey;
+        std::size_t inFlight;
+        bool failed;
+
+        AsyncStorage::Key getKey(std::size_t keyIndex) const;
+        void handleEventsUntil(const std::function<bool()>& done);
+        void preload();
+        void issueOperation();
+        void operationDone(std::chrono::steady_clock::time_point start, const std::error_code& error, bool modified);
+    };
+
+    Worker::Worker(const Options& options, std::size_t index):
+        options(options),
+        index(index),
+        keyPrefix("t" + std::to_string(index) + "-key"),
+        valueA(options.valueSize, 0xA5),
+        valueB(options.valueSize, 0x5A),
+        results(sizeof(workloadNames) / sizeof(workloadNames[0])),
+        hasValueB(options.keyCount, false),
+        workload(Workload::SET),
+        nextKey(0),
+        inFlight(0),
+        failed(false)
+    {
+    }
+
+    AsyncStorage::Key Worker::getKey(std::size_t keyIndex) const
+    {
+        /* Zero padded, so that the findkeys pattern (key with the last digit
+         * replaced with "*") matches at most ten keys of this thread. */
+        static const std::size_t width(8U);
+        std::ostringstream os;
+        os << keyPrefix << std::setw(width) << std::setfill('0') << keyIndex;
+        return os.str();
+    }
+
+    void Worker::handleEventsUntil(const std::function<bool()>& done)
+    {
+        struct pollfd events { storage->fd(), POLLIN, 0 };
+        while (!done())
+        {
+            if (poll(&events, 1, 1000) > 0 && (events.revents & POLLIN))
+                storage->handleEvents();
+        }
+    }
+
+    void Worker::run(Barrier& barrier)
+    {
+        try
+        {
+            storage = AsyncStorage::create();
+            bool ready(false);
+            storage->waitReadyAsync(options.ns, [&ready](const std::error_code&) { ready = true; });
+            handleEventsUntil([&ready]() { return ready; });
+        }
+        catch (const Exception& error)
+        {
+            std::cerr << "Creating SDL instance failed: " << error.what() << std::endl;
+            failed = true;
+        }
+
+        for (const auto w : options.workloads)
+        {
+            workload = w;
+            if (!failed && workload != Workload::SET && workload != Workload::MULTI_SET)
+                preload();
+            barrier.wait();
+            if (!failed)
+            {
+                end = std::chrono::steady_clock::now() + std::chrono::seconds(options.duration);
+                for (std::size_t i = 0; i < options.depth; ++i)
+                    issueOperation();
+                handleEventsUntil([this]() { return inFlight == 0; });
+            }
+            barrier.wait();
+        }
+
+        if (!failed && index == 0)
+        {
+            bool removed(false);
+            storage->removeAllAsync(options.ns, [&removed](const std::error_code&) { removed = true; });
+            handleEventsUntil([&removed]() { return removed; });
+        }
+    }
+
+    void Worker::preload()
+    {
+        /* Writes valueA to all keys of this thread, outside of the measured
+         * period. */
+        std::size_t pending(0);
+        for (std::size_t i = 0; i < options.keyCount; i += PRELOAD_KEYS_PER_OPERATION)
+        {
+            AsyncStorage::DataMap dataMap;
+            for (std::size_t j = i; j < std::min(options.keyCount, i + PRELOAD_KEYS_PER_OPERATION); ++j)
+                dataMap[getKey(j)] = valueA;
+            ++pending;
+            storage->setAsync(options.ns,
+                              dataMap,
+                              [this, &pending](const std::error_code& error)
+                              {
+                                  --pending;
+                                  if (error)
+                                  {
+                                      std::cerr << "Preloading keys failed: " << error.message() << std::endl;
+                                      failed = true;
+                                  }
+                              });
+            if (pending >= options.depth)
+                handleEventsUntil([&pending, this]() { return pending < options.depth; });
+        }
+        handleEventsUntil([&pending]() { return pending == 0; });
+        std::fill(hasValueB.begin(), hasValueB.end(), false);
+    }
+
+    void Worker::operationDone(std::chrono::steady_clock::time_point start, const std::error_code& error, bool modified)
+    {
+        auto& result(results[static_cast<std::size_t>(workload)]);
+        const auto now(std::chrono::steady_clock::now());
+        --inFlight;
+        if (error)
+            ++result.failed;
+        else
+        {
+            ++result.completed;
+            if (!modified)
+                ++result.notModified;
+            result.histogram.record(static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count()));
+        }
+        if (now < end)
+            issueOperation();
+    }
+
+    void Worker::issueOperation()
+    {
+        ++inFlight;
+        const auto start(std::chrono::steady_clock::now());
+        switch (workload)
+        {
+            case Workload::SET:
+            case Workload::MULTI_SET:
+            {
+                const auto count(workload == Workload::SET ? 1U : options.keysPerOperation);
+                AsyncStorage::DataMap dataMap;
+                for (std::size_t i = 0; i < count; ++i)
+                    dataMap[getKey(nextKey++ % options.keyCount)] = valueA;
+                storage->setAsync(options.ns,
+                                  dataMap,
+                                  [this, start](const std::error_code& error)
+                                  {
+                                      operationDone(start, error, true);
+                                  });
+                break;
+            }
+            case Workload::GET:
+            case Workload::MULTI_GET:
+            {
+                const auto count(workload == Workload::GET ? 1U : options.keysPerOperation);
+                AsyncStorage::Keys keys;
+                for (std::size_t i = 0; i < count; ++i)
+                    keys.insert(getKey(nextKey++ % options.keyCount));
+                storage->getAsync(options.ns,
+                                  keys,
+                                  [this, start](const std::error_code& error, const AsyncStorage::DataMap&)
+                                  {
+                                      operationDone(start, error, true);
+                                  });
+                break;
+            }
+            case Workload::FIND_KEYS:
+            {
+                auto pattern(getKey(nextKey++ % options.keyCount));
+                pattern.back() = '*';
+                storage->listKeys(options.ns,
+                                  pattern,
+                                  [this, start](const std::error_code& error, const AsyncStorage::Keys&)
+                                  {
+                                      operationDone(start, error, true);
+                                  });
+                break;
+            }
+            case Workload::SET_IF:
+            {
+                const auto index(nextKey++ % options.keyCount);
+                const bool toB(!hasValueB[index]);
+                storage->setIfAsync(options.ns,
+                                    getKey(index),
+                                    toB ? valueA : valueB,
+                                    toB ? valueB : valueA,
+                                    [this, start, index, toB](const std::error_code& error, bool status)
+                                    {
+                                        if (!error && status)
+                                            hasValueB[index] = toB;
+                                        operationDone(start, error, status);
+                                    });
+                break;
+            }
+        }
+    }
+
+    void printResult(std::ostream& out, const Options& options, Workload workload, const Result& result,
+                     double elapsed, const boost::optional<StandInRedisServer::Statistics>& serverStatistics)
+    {
+        const auto& histogram(result.histogram);
+        const double us(1000.0);
+        std::size_t keysPerOperation(1U);
+        if (workload == Workload::MULTI_SET || workload == Workload::MULTI_GET)
+            keysPerOperation = options.keysPerOperation;
+        out << std::fixed << std::setprecision(1)
+            << "workload: " << getWorkloadName(workload)
+            << " threads: " << options.threads
+            << " depth: " << options.depth
+            << " keys/op: " << keysPerOperation
+            << " value size: " << options.valueSize << '\n'
+            << "  operations: " << result.completed
+            << " failed: " << result.failed;
+        if (workload == Workload::SET_IF)
+            out << " not modified: " << result.notModified;
+        out << " ops/s: " << static_cast<std::size_t>(result.completed / elapsed)
+            << " keys/s: " << static_cast<std::size_t>(result.completed * keysPerOperation / elapsed) << '\n'
+            << "  latency us: min " << histogram.min() / us
+            << " mean " << histogram.mean() / us
+            << " p50 " << histogram.valueAtPercentile(50.0) / us
+            << " p90 " << histogram.valueAtPercentile(90.0) / us
+            << " p99 " << histogram.valueAtPercentile(99.0) / us
+            << " p99.9 " << histogram.valueAtPercentile(99.9) / us
+            << " max " << histogram.max() / us << '\n';
+        if (serverStatistics && serverStatistics->commands)
+        {
+            /* All workloads issue one command per operation. The rest of the
+             * latency is spent in SDL, hiredis, the kernel and in waiting
+             * for the operations ahead in the pipeline. */
+            const double serverUs(static_cast<double>(serverStatistics->busyNanoseconds) / serverStatistics->commands / us);
+            out << "  stand-in server us/op: " << serverUs
+                << " client and transport us/op: " << std::max(0.0, histogram.mean() / us - serverUs)
+                << " server busy: " << std::setprecision(1)
+                << 100.0 * serverStatistics->busyNanoseconds / (elapsed * 1e9) << "%\n";
+        }
+        if (options.printHistogram)
+            histogram.printPercentileDistribution(out, us);
+        out << std::flush;
+    }
+
+    void useStandInServer(const StandInRedisServer& server)
+    {
+        setenv("DBAAS_SERVICE_HOST", "127.0.0.1", 1);
+        setenv("DBAAS_SERVICE_PORT", std::to_string(server.getPort()).c_str(), 1);
+        unsetenv("DBAAS_SERVICE_SENTINEL_PORT");
+        unsetenv("DBAAS_MASTER_NAME");
+        unsetenv("DBAAS_CLUSTER_ADDR_LIST");
+        unsetenv("DBAAS_SHARDING_MODE");
+        unsetenv("DBAAS_CONNECTIONS_PER_SHARD");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    std::string backend;
+    std::string workloads;
+
+    po::options_description desc("Options");
+    desc.add_options()
+        ("help", "Show help")
+        ("backend", po::value<std::string>(&backend)->default_value("standin"),
+         "Database backend: standin (in-process Redis protocol stand-in) or redis (configured DB service)")
+        ("workloads", po::value<std::string>(&workloads)->default_value("set,get,mset,mget,findkeys,setif"),
+         "Comma separated list of workloads to run: set, get, mset, mget, findkeys, setif")
+        ("ns", po::value<std::string>(&options.ns)->default_value("sdlbench"), "Namespace used in the benchmark")
+        ("duration", po::value<std::size_t>(&options.duration)->default_value(5), "Duration of each workload in seconds")
+        ("threads", po::value<std::size_t>(&options.threads)->default_value(1), "Number of threads, each with its own SDL instance")
+        ("depth", po::value<std::size_t>(&options.depth)->default_value(1), "Operations in flight (pipelining depth) per thread")
+        ("keys", po::value<std::size_t>(&options.keyCount)->default_value(10000), "Number of distinct keys per thread")
+        ("keys-per-op", po::value<std::size_t>(&options.keysPerOperation)->default_value(10), "Keys per mset/mget operation")
+        ("value-size", po::value<std::size_t>(&options.valueSize)->default_value(100), "Value size in bytes")
+        ("histogram", po::bool_switch(&options.printHistogram), "Print the full latency percentile distribution");
+
+    po::variables_map map;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), map);
+        po::notify(map);
+        options.workloads = parseWorkloads(workloads);
+        if (backend != "standin" && backend != "redis")
+            throw po::validation_error(po::validation_error::invalid_option_value, "backend", backend);
+    }
+    catch (const po::error& e)
+    {
+        std::cerr << e.what() << std::endl << desc << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (map.count("help") || options.workloads.empty() || options.threads == 0 || options.depth == 0 ||
+        options.keyCount == 0 || options.keysPerOperation == 0)
+    {
+        std::cout << desc << std::endl;
+        return map.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::unique_ptr<StandInRedisServer> server;
+    if (backend == "standin")
+    {
+        server.reset(new StandInRedisServer());
+        useStandInServer(*server);
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    Barrier barrier(options.threads + 1);
+    for (std::size_t i = 0; i < options.threads; ++i)
+        workers.emplace_back(new Worker(options, i));
+    for (auto& worker : workers)
+        threads.emplace_back(&Worker::run, worker.get(), std::ref(barrier));
+
+    for (const auto workload : options.workloads)
+    {
+        /* Workers preload the keys before the first wait. */
+        barrier.wait();
+        if (server)
+            server->resetStatistics();
+        const auto start(std::chrono::steady_clock::now());
+        barrier.wait();
+        const std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - start);
+
+        Result total;
+        for (const auto& worker : workers)
+        {
+            const auto& result(worker->getResult(workload));
+            total.completed += result.completed;
+            total.failed += result.failed;
+            total.notModified += result.notModified;
+            total.histogram.merge(result.histogram);
+        }
+        boost::optional<StandInRedisServer::Statistics> serverStatistics;
+        if (server)
+            serverStatistics = server->getStatistics();
+        printResult(std::cout, options, workload, total, elapsed.count(), serverStatistics);
+    }
+
+    bool failed(false);
+    for (std::size_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i].join();
+        for (const auto workload : options.workloads)
+            if (workers[i]->getResult(workload).failed)
+                failed = true;
+        if (workers[i]->hasFailed())
+            failed = true;
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
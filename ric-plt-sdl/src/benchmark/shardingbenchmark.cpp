@@ -0,0 +1,182 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+/*
+ * Measures AsyncStorage set/get throughput of a single SDL instance with a
+ * configurable number of operations in flight. Database configuration is
+ * read the normal way (DBAAS_* environment variables or configuration files),
+ * so the same binary can be run against different sharding configurations.
+ * See run-sharding-benchmark.sh.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <poll.h>
+#include <boost/program_options.hpp>
+#include <sdl/asyncstorage.hpp>
+#include <sdl/exception.hpp>
+
+using namespace shareddatalayer;
+
+namespace
+{
+    namespace po = boost::program_options;
+
+    struct BenchmarkState
+    {
+        AsyncStorage& storage;
+        const AsyncStorage::Namespace ns;
+        const std::size_t keyCount;
+        const std::size_t keysPerOperation;
+        const AsyncStorage::Data value;
+        std::chrono::steady_clock::time_point end;
+        std::size_t nextKey;
+        std::size_t inFlight;
+        std::size_t completed;
+        std::size_t failed;
+        bool getNext;
+    };
+
+    void issueOperation(BenchmarkState& state);
+
+    void operationDone(BenchmarkState& state, const std::error_code& error)
+    {
+        --state.inFlight;
+        if (error)
+            ++state.failed;
+        else
+            ++state.completed;
+        if (std::chrono::steady_clock::now() < state.end)
+            issueOperation(state);
+    }
+
+    void issueOperation(BenchmarkState& state)
+    {
+        ++state.inFlight;
+        state.getNext = !state.getNext;
+        if (state.getNext)
+        {
+            AsyncStorage::Keys keys;
+            for (std::size_t i = 0; i < state.keysPerOperation; ++i)
+                keys.insert("key" + std::to_string(state.nextKey++ % state.keyCount));
+            state.storage.getAsync(state.ns,
+                                   keys,
+                                   [&state](const std::error_code& error, const AsyncStorage::DataMap&)
+                                   {
+                                       operationDone(state, error);
+                                   });
+        }
+        else
+        {
+            AsyncStorage::DataMap dataMap;
+            for (std::size_t i = 0; i < state.keysPerOperation; ++i)
+                dataMap["key" + std::to_string(state.nextKey++ % state.keyCount)] = state.value;
+            state.storage.setAsync(state.ns,
+                                   dataMap,
+                                   [&state](const std::error_code& error)
+                                   {
+                                       operationDone(state, error);
+                                   });
+        }
+    }
+
+    void handleEventsUntil(AsyncStorage& storage, const std::function<bool()>& done)
+    {
+        struct pollfd events { storage.fd(), POLLIN, 0 };
+        while (!done())
+        {
+            if (poll(&events, 1, 1000) > 0 && (events.revents & POLLIN))
+                storage.handleEvents();
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::string ns;
+    std::size_t duration;
+    std::size_t depth;
+    std::size_t keyCount;
+    std::size_t keysPerOperation;
+    std::size_t valueSize;
+
+    po::options_description desc("Options");
+    desc.add_options()
+        ("help", "Show help")
+        ("ns", po::value<std::string>(&ns)->default_value("sdlshardingbenchmark"), "Namespace used in the benchmark")
+        ("duration", po::value<std::size_t>(&duration)->default_value(10), "Benchmark duration in seconds")
+        ("depth", po::value<std::size_t>(&depth)->default_value(64), "Operations in flight")
+        ("keys", po::value<std::size_t>(&keyCount)->default_value(10000), "Number of distinct keys")
+        ("keys-per-op", po::value<std::size_t>(&keysPerOperation)->default_value(1), "Keys per set/get operation")
+        ("value-size", po::value<std::size_t>(&valueSize)->default_value(100), "Value size in bytes");
+
+    po::variables_map map;
+    try
+    {
+        po::store(po::parse_command_line(argc, argv, desc), map);
+        po::notify(map);
+    }
+    catch (const po::error& e)
+    {
+        std::cerr << e.what() << std::endl << desc << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (map.count("help") || depth == 0 || keyCount == 0 || keysPerOperation == 0)
+    {
+        std::cout << desc << std::endl;
+        return map.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    try
+    {
+        auto storage(AsyncStorage::create());
+        bool ready(false);
+        storage->waitReadyAsync(ns, [&ready](const std::error_code&) { ready = true; });
+        handleEventsUntil(*storage, [&ready]() { return ready; });
+
+        BenchmarkState state { *storage, ns, keyCount, keysPerOperation, AsyncStorage::Data(valueSize, 0xA5),
+                               std::chrono::steady_clock::now() + std::chrono::seconds(duration),
+                               0, 0, 0, 0, true };
+        const auto start(std::chrono::steady_clock::now());
+        for (std::size_t i = 0; i < depth; ++i)
+            issueOperation(state);
+        handleEventsUntil(*storage, [&state]() { return state.inFlight == 0; });
+        const std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - start);
+
+        std::cout << "operations: " << state.completed
+                  << " failed: " << state.failed
+                  << " ops/s: " << static_cast<std::size_t>(state.completed / elapsed.count())
+                  << " keys/s: " << static_cast<std::size_t>(state.completed * keysPerOperation / elapsed.count())
+                  << std::endl;
+
+        bool removed(false);
+        storage->removeAllAsync(ns, [&removed](const std::error_code&) { removed = true; });
+        handleEventsUntil(*storage, [&removed]() { return removed; });
+        return state.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    catch (const Exception& error)
+    {
+        std::cerr << "Benchmark failed: " << error.what() << std::endl;
+    }
+    return EXIT_FAILURE;
+}
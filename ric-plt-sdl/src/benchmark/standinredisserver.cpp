@@ -0,0 +1,554 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+#include "private/benchmark/standinredisserver.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <system_error>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace shareddatalayer::benchmark;
+
+namespace
+{
+    /* SDL verifies at connect time that these are listed in COMMAND reply. */
+    const char* const supportedCommands[] =
+    {
+        "command", "ping", "mset", "msetpub", "mget", "setie", "setiepub", "setnx", "setnxpub",
+        "del", "delpub", "delie", "deliepub", "keys", "subscribe", "unsubscribe",
+    };
+
+    const std::size_t READ_SIZE(16384U);
+
+    void throwSystemError(const char* what)
+    {
+        throw std::system_error(errno, std::system_category(), what);
+    }
+
+    void setNonBlocking(int fd)
+    {
+        const int flags(fcntl(fd, F_GETFL, 0));
+        if (flags == -1 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1)
+            throwSystemError("fcntl");
+    }
+
+    void appendSimpleString(std::string& output, const char* string)
+    {
+        output += '+';
+        output += string;
+        output += "\r\n";
+    }
+
+    void appendError(std::string& output, const std::string& error)
+    {
+        output += "-ERR ";
+        output += error;
+        output += "\r\n";
+    }
+
+    void appendInteger(std::string& output, long long value)
+    {
+        output += ':';
+        output += std::to_string(value);
+        output += "\r\n";
+    }
+
+    void appendBulkString(std::string& output, const std::string& string)
+    {
+        output += '$';
+        output += std::to_string(string.size());
+        output += "\r\n";
+        output += string;
+        output += "\r\n";
+    }
+
+    void appendNil(std::string& output)
+    {
+        output += "$-1\r\n";
+    }
+
+    void appendArrayHeader(std::string& output, std::size_t size)
+    {
+        output += '*';
+        output += std::to_string(size);
+        output += "\r\n";
+    }
+
+    /* Parses "<prefix><number>\r\n" at pos. Returns false if the line is not complete yet. */
+    bool parseLength(const std::string& input, std::size_t& pos, char prefix, long long& length, bool& error)
+    {
+        if (pos >= input.size())
+            return false;
+        if (input[pos] != prefix)
+        {
+            error = true;
+            return false;
+        }
+        const auto end(input.find("\r\n", pos));
+        if (end == std::string::npos)
+            return false;
+        char* parsedEnd(nullptr);
+        length = std::strtoll(input.c_str() + pos + 1, &parsedEnd, 10);
+        if (parsedEnd != input.c_str() + end)
+        {
+            error = true;
+            return false;
+        }
+        pos = end + 2;
+        return true;
+    }
+}
+
+StandInRedisServer::StandInRedisServer():
+    listenFd(-1),
+    wakeupFds{-1, -1},
+    port(0),
+    commands(0),
+    busyNanoseconds(0)
+{
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd == -1)
+        throwSystemError("socket");
+    const int one(1);
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t addressLength(sizeof(address));
+    if (bind(listenFd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == -1 ||
+        listen(listenFd, SOMAXCONN) == -1 ||
+        getsockname(listenFd, reinterpret_cast<struct sockaddr*>(&address), &addressLength) == -1)
+    {
+        const int savedErrno(errno);
+        close(listenFd);
+        errno = savedErrno;
+        throwSystemError("bind");
+    }
+    port = ntohs(address.sin_port);
+    setNonBlocking(listenFd);
+    if (pipe2(wakeupFds, O_CLOEXEC | O_NONBLOCK) == -1)
+    {
+        const int savedErrno(errno);
+        close(listenFd);
+        errno = savedErrno;
+        throwSystemError("pipe2");
+    }
+    thread = std::thread(&StandInRedisServer::run, this);
+}
+
+StandInRedisServer::~StandInRedisServer()
+{
+    const char byte(0);
+    if (write(wakeupFds[1], &byte, 1) == -1)
+    {
+        /* Nothing to do, the server thread is stopped anyway with the pipe. */
+    }
+    thread.join();
+    close(wakeupFds[0]);
+    close(wakeupFds[1]);
+    close(listenFd);
+}
+
+StandInRedisServer::Statistics StandInRedisServer::getStatistics() const
+{
+    return Statistics { commands.load(), busyNanoseconds.load() };
+}
+
+void StandInRedisServer::resetStatistics()
+{
+    commands = 0;
+    busyNanoseconds = 0;
+}
+
+bool StandInRedisServer::globMatch(const char* pattern, std::size_t patternLength,
+                                   const char* string, std::size_t stringLength)
+{
+    /* Same semantics as Redis stringmatchlen() (case sensitive). */
+    while (patternLength && stringLength)
+    {
+        switch (*pattern)
+        {
+            case '*':
+                while (patternLength > 1 && pattern[1] == '*')
+                {
+                    ++pattern;
+                    --patternLength;
+                }
+                if (patternLength == 1)
+                    return true;
+                while (stringLength)
+                {
+                    if (globMatch(pattern + 1, patternLength - 1, string, stringLength))
+                        return true;
+                    ++string;
+                    --stringLength;
+                }
+                return false;
+            case '?':
+                ++string;
+                --stringLength;
+                break;
+            case '[':
+            {
+                ++pattern;
+                --patternLength;
+                const bool negate(patternLength && *pattern == '^');
+                if (negate)
+                {
+                    ++pattern;
+                    --patternLength;
+                }
+                bool match(false);
+                while (patternLength && *pattern != ']')
+                {
+                    if (*pattern == '\\' && patternLength >= 2)
+                    {
+                        ++pattern;
+                        --patternLength;
+                        if (*pattern == *string)
+                            match = true;
+                    }
+                    else if (patternLength >= 3 && pattern[1] == '-')
+                    {
+                        auto start(static_cast<unsigned char>(pattern[0]));
+                        auto end(static_cast<unsigned char>(pattern[2]));
+                        if (start > end)
+                            std::swap(start, end);
+                        const auto c(static_cast<unsigned char>(*string));
+                        if (c >= start && c <= end)
+                            match = true;
+                        pattern += 2;
+                        patternLength -= 2;
+                    }
+                    else if (*pattern == *string)
+                        match = true;
+                    ++pattern;
+                    --patternLength;
+                }
+                if (!patternLength)
+                {
+                    /* Unterminated class, match the "]" that is not there. */
+                    ++patternLength;
+                    --pattern;
+                }
+                if (match == negate)
+                    return false;
+                ++string;
+                --stringLength;
+                break;
+            }
+            case '\\':
+                if (patternLength >= 2)
+                {
+                    ++pattern;
+                    --patternLength;
+                }
+                /* fall through */
+            default:
+                if (*pattern != *string)
+                    return false;
+                ++string;
+                --stringLength;
+                break;
+        }
+        ++pattern;
+        --patternLength;
+    }
+    while (patternLength && *pattern == '*')
+    {
+        ++pattern;
+        --patternLength;
+    }
+    return !patternLength && !stringLength;
+}
+
+void StandInRedisServer::run()
+{
+    std::list<Client> clients;
+    std::vector<struct pollfd> fds;
+    std::vector<std::list<Client>::iterator> fdClients;
+    while (true)
+    {
+        fds.clear();
+        fdClients.clear();
+        fds.push_back({ wakeupFds[0], POLLIN, 0 });
+        fds.push_back({ listenFd, POLLIN, 0 });
+        for (auto i = clients.begin(); i != clients.end(); ++i)
+        {
+            fds.push_back({ i->fd, static_cast<short>(i->output.empty() ? POLLIN : (POLLIN | POLLOUT)), 0 });
+            fdClients.push_back(i);
+        }
+        if (poll(fds.data(), fds.size(), -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[0].revents)
+            break;
+        if (fds[1].revents & POLLIN)
+        {
+            int fd;
+            while ((fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)) != -1)
+            {
+                const int one(1);
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                clients.push_back(Client { fd, std::string(), std::string() });
+            }
+        }
+        for (std::size_t i = 2; i < fds.size(); ++i)
+        {
+            auto client(fdClients[i - 2]);
+            bool alive(true);
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR))
+                alive = readFromClient(*client);
+            if (alive && !client->output.empty())
+                alive = writeToClient(*client);
+            if (!alive)
+            {
+                close(client->fd);
+                clients.erase(client);
+            }
+        }
+    }
+    for (const auto& client : clients)
+        close(client.fd);
+}
+
+bool StandInRedisServer::readFromClient(Client& client)
+{
+    char buffer[READ_SIZE];
+    while (true)
+    {
+        const auto count(read(client.fd, buffer, sizeof(buffer)));
+        if (count > 0)
+        {
+            client.input.append(buffer, static_cast<std::size_t>(count));
+            continue;
+        }
+        if (count == -1 && errno == EINTR)
+            continue;
+        if (count == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        return false;
+    }
+    const auto start(std::chrono::steady_clock::now());
+    const bool valid(handleInput(client));
+    busyNanoseconds += static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    return valid;
+}
+
+bool StandInRedisServer::writeToClient(Client& client)
+{
+    std::size_t written(0U);
+    while (written < client.output.size())
+    {
+        const auto count(write(client.fd, client.output.data() + written, client.output.size() - written));
+        if (count >= 0)
+        {
+            written += static_cast<std::size_t>(count);
+            continue;
+        }
+        if (errno == EINTR)
+            continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            break;
+        return false;
+    }
+    client.output.erase(0, written);
+    return true;
+}
+
+bool StandInRedisServer::handleInput(Client& client)
+{
+    /* Executes every complete command in the input buffer, so pipelined
+     * requests are answered with a single write. Returns false on protocol
+     * error, in which case the connection is closed. */
+    std::size_t consumed(0U);
+    Arguments arguments;
+    while (true)
+    {
+        std::size_t pos(consumed);
+        long long count(0);
+        bool error(false);
+        if (!parseLength(client.input, pos, '*', count, error))
+        {
+            if (error)
+                return false;
+            break;
+        }
+        arguments.clear();
+        bool complete(true);
+        for (long long i = 0; i < count; ++i)
+        {
+            long long length(0);
+            if (!parseLength(client.input, pos, '$', length, error) || length < 0 ||
+                client.input.size() < pos + static_cast<std::size_t>(length) + 2U)
+            {
+                complete = false;
+                break;
+            }
+            arguments.emplace_back(client.input, pos, static_cast<std::size_t>(length));
+            pos += static_cast<std::size_t>(length) + 2U;
+        }
+        if (error)
+            return false;
+        if (!complete)
+            break;
+        consumed = pos;
+        if (!arguments.empty())
+        {
+            execute(arguments, client.output);
+            ++commands;
+        }
+    }
+    client.input.erase(0, consumed);
+    return true;
+}
+
+void StandInRedisServer::execute(const Arguments& arguments, std::string& output)
+{
+    std::string command(arguments[0]);
+    std::transform(command.begin(), command.end(), command.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    /* The *PUB variants take channel and message as the last two arguments. */
+    const bool publish(command.size() > 3 && command.compare(command.size() - 3, 3, "PUB") == 0);
+    const std::size_t end(arguments.size() - (publish ? 2U : 0U));
+    if (publish && arguments.size() < 3U)
+    {
+        appendError(output, "wrong number of arguments for '" + arguments[0] + "' command");
+        return;
+    }
+
+    if (command == "COMMAND")
+    {
+        appendArrayHeader(output, sizeof(supportedCommands) / sizeof(supportedCommands[0]));
+        for (const auto name : supportedCommands)
+        {
+            appendArrayHeader(output, 1U);
+            appendBulkString(output, name);
+        }
+    }
+    else if (command == "PING")
+        appendSimpleString(output, "PONG");
+    else if ((command == "MSET" || command == "MSETPUB") && end > 1U && (end - 1U) % 2U == 0U)
+    {
+        for (std::size_t i = 1; i < end; i += 2)
+            data[arguments[i]] = arguments[i + 1];
+        appendSimpleString(output, "OK");
+    }
+    else if (command == "MGET" && end > 1U)
+    {
+        appendArrayHeader(output, end - 1U);
+        for (std::size_t i = 1; i < end; ++i)
+        {
+            const auto it(data.find(arguments[i]));
+            if (it == data.end())
+                appendNil(output);
+            else
+                appendBulkString(output, it->second);
+        }
+    }
+    else if ((command == "SETIE" || command == "SETIEPUB") && end == 4U)
+    {
+        const auto it(data.find(arguments[1]));
+        if (it != data.end() && it->second == arguments[3])
+        {
+            it->second = arguments[2];
+            appendSimpleString(output, "OK");
+        }
+        else
+            appendNil(output);
+    }
+    else if (command == "SETNX" && end == 3U)
+        appendInteger(output, data.emplace(arguments[1], arguments[2]).second ? 1 : 0);
+    else if (command == "SETNXPUB" && end == 3U)
+    {
+        if (data.emplace(arguments[1], arguments[2]).second)
+            appendSimpleString(output, "OK");
+        else
+            appendNil(output);
+    }
+    else if ((command == "DEL" || command == "DELPUB") && end > 1U)
+    {
+        long long removed(0);
+        for (std::size_t i = 1; i < end; ++i)
+            removed += static_cast<long long>(data.erase(arguments[i]));
+        appendInteger(output, removed);
+    }
+    else if ((command == "DELIE" || command == "DELIEPUB") && end == 3U)
+    {
+        const auto it(data.find(arguments[1]));
+        if (it != data.end() && it->second == arguments[2])
+        {
+            data.erase(it);
+            appendInteger(output, 1);
+        }
+        else
+            appendInteger(output, 0);
+    }
+    else if (command == "KEYS" && end == 2U)
+    {
+        const auto& pattern(arguments[1]);
+        /* SDL patterns start with the literal "{namespace}," prefix, use it
+         * to skip the keys of other namespaces. */
+        std::string prefix;
+        for (std::size_t i = 0; i < pattern.size() && !std::strchr("*?[", pattern[i]); ++i)
+        {
+            if (pattern[i] == '\\' && i + 1 < pattern.size())
+                ++i;
+            prefix += pattern[i];
+        }
+        std::vector<const std::string*> keys;
+        for (auto it = data.lower_bound(prefix); it != data.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            if (globMatch(pattern.data(), pattern.size(), it->first.data(), it->first.size()))
+                keys.push_back(&it->first);
+        appendArrayHeader(output, keys.size());
+        for (const auto key : keys)
+            appendBulkString(output, *key);
+    }
+    else if (command == "SUBSCRIBE" || command == "UNSUBSCRIBE")
+    {
+        for (std::size_t i = 1; i < arguments.size(); ++i)
+        {
+            appendArrayHeader(output, 3U);
+            appendBulkString(output, command == "SUBSCRIBE" ? "subscribe" : "unsubscribe");
+            appendBulkString(output, arguments[i]);
+            appendInteger(output, command == "SUBSCRIBE" ? static_cast<long long>(i) : 0);
+        }
+    }
+    else
+        appendError(output, "unknown command or wrong number of arguments for '" + arguments[0] + "' command");
+}
@@ -74,6 +74,38 @@ namespace
         }
     }
 
+    void validateAndSetShardingMode(const std::string& mode, DatabaseConfiguration& databaseConfiguration,
+                                    const std::string& sourceName)
+    {
+        try
+        {
+            databaseConfiguration.checkAndApplyShardingMode(mode);
+        }
+        catch (const std::exception& e)
+        {
+            std::ostringstream os;
+            os << "Configuration error in " << sourceName << ": "
+               << e.what();
+            throw Exception(os.str());
+        }
+    }
+
+    void validateAndSetConnectionsPerShard(const std::string& connections, DatabaseConfiguration& databaseConfiguration,
+                                           const std::string& sourceName)
+    {
+        try
+        {
+            databaseConfiguration.checkAndApplyConnectionsPerShard(connections);
+        }
+        catch (const std::exception& e)
+        {
+            std::ostringstream os;
+            os << "Configuration error in " << sourceName << ": "
+               << e.what();
+            throw Exception(os.str());
+        }
+    }
+
     void validateAndSetDbServerAddress(const std::string& address, DatabaseConfiguration& databaseConfiguration,
                                        const std::string& sourceName)
     {
@@ -123,6 +155,14 @@ namespace
         validateAndSetDbType(type, databaseConfiguration, sourceName);
 
         parseDatabaseServersConfiguration(databaseConfiguration, ptree, sourceName);
+
+        const auto shardingMode(ptree.get_optional<std::string>("shardingMode"));
+        if (shardingMode)
+            validateAndSetShardingMode(*shardingMode, databaseConfiguration, sourceName);
+
+        const auto connectionsPerShard(ptree.get_optional<std::string>("connectionsPerShard"));
+        if (connectionsPerShard)
+            validateAndSetConnectionsPerShard(*connectionsPerShard, databaseConfiguration, sourceName);
     }
 
     void parseDatabaseConfigurationTree(DatabaseConfiguration& databaseConfiguration,
@@ -237,6 +277,10 @@ ConfigurationReader::ConfigurationReader(const Directories& directories,
     sentinelMasterNameEnvVariableValue({}),
     dbClusterAddrListEnvVariableName(DB_CLUSTER_ADDR_LIST_ENV_VAR_NAME),
     dbClusterAddrListEnvVariableValue({}),
+    dbShardingModeEnvVariableName(DB_SHARDING_MODE_ENV_VAR_NAME),
+    dbShardingModeEnvVariableValue({}),
+    dbConnectionsPerShardEnvVariableName(DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME),
+    dbConnectionsPerShardEnvVariableValue({}),
     jsonDatabaseConfiguration(boost::none),
     logger(logger)
 {
@@ -257,6 +301,12 @@ ConfigurationReader::ConfigurationReader(const Directories& directories,
         envStr = system.getenv(dbClusterAddrListEnvVariableName.c_str());
         if (envStr)
             dbClusterAddrListEnvVariableValue = envStr;
+        envStr = system.getenv(dbShardingModeEnvVariableName.c_str());
+        if (envStr)
+            dbShardingModeEnvVariableValue = envStr;
+        envStr = system.getenv(dbConnectionsPerShardEnvVariableName.c_str());
+        if (envStr)
+            dbConnectionsPerShardEnvVariableValue = envStr;
     }
 
     readConfigurationFromDirectories(directories);
@@ -369,6 +419,14 @@ void ConfigurationReader::readDatabaseConfiguration(DatabaseConfiguration& datab
                 databaseConfiguration.checkAndApplySentinelPorts(sentinelPortEnvVariableValue);
                 databaseConfiguration.checkAndApplySentinelMasterNames(sentinelMasterNameEnvVariableValue);
             }
+            if (!dbShardingModeEnvVariableValue.empty())
+                validateAndSetShardingMode(dbShardingModeEnvVariableValue,
+                                           databaseConfiguration,
+                                           sourceForDatabaseConfiguration);
+            if (!dbConnectionsPerShardEnvVariableValue.empty())
+                validateAndSetConnectionsPerShard(dbConnectionsPerShardEnvVariableValue,
+                                                  databaseConfiguration,
+                                                  sourceForDatabaseConfiguration);
         }
         else
             parseDatabaseConfigurationTree(databaseConfiguration, jsonDatabaseConfiguration, sourceForDatabaseConfiguration);
@@ -33,6 +33,22 @@ namespace
         os << "Allowed types are: 'redis-standalone', 'redis-cluster', 'redis-sentinel' or 'sdl-cluster'";
         return os.str();
     }
+
+    std::string buildInvalidShardingModeError(const std::string& mode)
+    {
+        std::ostringstream os;
+        os << "invalid sharding mode: '" << mode << "'. ";
+        os << "Allowed modes are: 'namespace' or 'key'";
+        return os.str();
+    }
+
+    std::string buildInvalidConnectionsPerShardError(const std::string& connections)
+    {
+        std::ostringstream os;
+        os << "invalid connections per shard: '" << connections << "'. ";
+        os << "Allowed values are integers from 1 to " << DatabaseConfiguration::MAX_CONNECTIONS_PER_SHARD;
+        return os.str();
+    }
 }
 
 DatabaseConfiguration::InvalidDbType::InvalidDbType(const std::string& type):
@@ -40,3 +56,13 @@ DatabaseConfiguration::InvalidDbType::InvalidDbType(const std::string& type):
 {
 }
 
+DatabaseConfiguration::InvalidShardingMode::InvalidShardingMode(const std::string& mode):
+    Exception(buildInvalidShardingModeError(mode))
+{
+}
+
+DatabaseConfiguration::InvalidConnectionsPerShard::InvalidConnectionsPerShard(const std::string& connections):
+    Exception(buildInvalidConnectionsPerShardError(connections))
+{
+}
+
@@ -41,7 +41,9 @@ namespace
 }
 
 DatabaseConfigurationImpl::DatabaseConfigurationImpl():
-    dbType(DbType::UNKNOWN)
+    dbType(DbType::UNKNOWN),
+    shardingMode(ShardingMode::NAMESPACE),
+    connectionsPerShard(1U)
 {
 }
 
@@ -135,3 +137,39 @@ std::string DatabaseConfigurationImpl::getSentinelMasterName(const boost::option
     std::size_t index(addressIndex ? *addressIndex : 0);
     return ((sentinelMasterNames.size() > 0 && index < sentinelMasterNames.size()) ? sentinelMasterNames.at(index) : DEFAULT_SENTINEL_MASTER_GROUP_NAME);
 }
+
+void DatabaseConfigurationImpl::checkAndApplyShardingMode(const std::string& mode)
+{
+    if (mode == "namespace")
+        shardingMode = DatabaseConfiguration::ShardingMode::NAMESPACE;
+    else if (mode == "key")
+        shardingMode = DatabaseConfiguration::ShardingMode::KEY;
+    else
+        throw DatabaseConfiguration::InvalidShardingMode(mode);
+}
+
+DatabaseConfiguration::ShardingMode DatabaseConfigurationImpl::getShardingMode() const
+{
+    return shardingMode;
+}
+
+void DatabaseConfigurationImpl::checkAndApplyConnectionsPerShard(const std::string& connections)
+{
+    std::size_t value(0U);
+    try
+    {
+        value = boost::lexical_cast<std::size_t>(connections);
+    }
+    catch (const boost::bad_lexical_cast&)
+    {
+        throw DatabaseConfiguration::InvalidConnectionsPerShard(connections);
+    }
+    if (value < 1U || value > MAX_CONNECTIONS_PER_SHARD)
+        throw DatabaseConfiguration::InvalidConnectionsPerShard(connections);
+    connectionsPerShard = value;
+}
+
+std::size_t DatabaseConfigurationImpl::getConnectionsPerShard() const
+{
+    return connectionsPerShard;
+}
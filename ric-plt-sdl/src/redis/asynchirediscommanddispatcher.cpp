@@ -24,6 +24,7 @@
 #include <cstring>
 #include <cerrno>
 #include <sstream>
+#include <strings.h>
 #include <arpa/inet.h>
 #include "private/abort.hpp"
 #include "private/createlogger.hpp"
@@ -78,6 +79,26 @@ namespace
         if (instance->isClientCallbacksEnabled())
             instance->handleReply(*cb, getRedisError(ac->err, ac->errstr, reply), reply);
     }
+
+    bool isUnsubscribeCommand(const Contents& contents)
+    {
+        return !contents.stack.empty() &&
+               (strcasecmp(contents.stack[0].c_str(), "UNSUBSCRIBE") == 0 ||
+                strcasecmp(contents.stack[0].c_str(), "PUNSUBSCRIBE") == 0);
+    }
+
+    /* The (p)unsubscribe reply is the last one hiredis delivers to a subscribe callback; after
+     * it hiredis forgets the callback. Subscribe commands are expected to name one channel each,
+     * as AsyncRedisStorage does.
+     */
+    bool isUnsubscribeReply(const redisReply* rr)
+    {
+        if (rr == nullptr || rr->type != REDIS_REPLY_ARRAY || rr->elements == 0)
+            return false;
+        const redisReply* kind(rr->element[0]);
+        return kind->type == REDIS_REPLY_STRING &&
+               (strcasecmp(kind->str, "unsubscribe") == 0 || strcasecmp(kind->str, "punsubscribe") == 0);
+    }
 }
 
 AsyncHiredisCommandDispatcher::AsyncHiredisCommandDispatcher(Engine& engine,
@@ -238,10 +259,24 @@ void AsyncHiredisCommandDispatcher::dispatchAsync(const CommandCb& commandCb,
                                        std::error_code(AsyncRedisCommandDispatcherErrorCode::NOT_CONNECTED)));
         return;
     }
-    cbs.push_back(commandCb);
     std::vector<const char*> chars;
     std::transform(contents.stack.begin(), contents.stack.end(),
                    std::back_inserter(chars), [](const std::string& str){ return str.c_str(); });
+    if (isUnsubscribeCommand(contents))
+    {
+        /* hiredis never calls the callback of an unsubscribe command, its replies go to the
+         * callback of the subscribe command. Thus no callback is given to hiredis and the
+         * client is acked as soon as the command is queued.
+         */
+        auto ret(hiredisSystem.redisAsyncCommandArgv(ac, nullptr, nullptr, static_cast<int>(contents.stack.size()),
+                                                     &chars[0], &contents.sizes[0]));
+        engine.postCallback(std::bind(&AsyncHiredisCommandDispatcher::callCommandCbWithError,
+                                       this,
+                                       commandCb,
+                                       ret != REDIS_OK ? getRedisError(ac->err, ac->errstr, nullptr) : std::error_code()));
+        return;
+    }
+    cbs.push_back(commandCb);
     if (hiredisSystem.redisAsyncCommandArgv(ac, cb, &cbs.back(), static_cast<int>(contents.stack.size()),
                                             &chars[0], &contents.sizes[0]) != REDIS_OK)
     {
@@ -296,7 +331,10 @@ void AsyncHiredisCommandDispatcher::handleReply(const CommandCb& commandCb,
         commandCb(error, AsyncRedisReply());
     else
         commandCb(error, AsyncRedisReply(*rr));
-    if (!usePermanentCommandCallbacks)
+    /* With permanent callbacks a subscribe callback stays until its unsubscribe reply. An error
+     * reply is the last one in any case.
+     */
+    if (!usePermanentCommandCallbacks || error || isUnsubscribeReply(rr))
         removeCb(commandCb);
 }
 
@@ -62,6 +62,23 @@ namespace
                                               false);
     }
 
+    std::shared_ptr<AsyncCommandDispatcher> asyncSubscriberCreator(Engine& engine,
+                                                                   const DatabaseInfo& databaseInfo,
+                                                                   std::shared_ptr<ContentsBuilder> contentsBuilder,
+                                                                   std::shared_ptr<Logger> logger)
+    {
+        /* Subscriber connection uses permanent command callbacks, because replies for all
+         * published messages of the subscribed channel are delivered to the SUBSCRIBE
+         * command callback.
+         */
+        return AsyncCommandDispatcher::create(engine,
+                                              databaseInfo,
+                                              contentsBuilder,
+                                              true,
+                                              logger,
+                                              false);
+    }
+
     class AsyncRedisStorageErrorCategory: public std::error_category
     {
     public:
@@ -156,6 +173,23 @@ namespace
         return keys;
     }
 
+    bool parseSubscribeReply(const Reply& reply, std::string& kind, std::string& message)
+    {
+        // refer to: https://redis.io/topics/pubsub#format-of-pushed-messages
+        if (reply.getType() != Reply::Type::ARRAY)
+            return false;
+        const auto& replyVector(*reply.getArray());
+        if (replyVector.size() < 3 || replyVector[0]->getType() != Reply::Type::STRING)
+            return false;
+        kind = replyVector[0]->getString()->str;
+        if (replyVector[2]->getType() == Reply::Type::STRING)
+        {
+            auto dataItem(replyVector[2]->getString());
+            message = std::string(dataItem->str.c_str(), static_cast<size_t>(dataItem->len));
+        }
+        return true;
+    }
+
     void escapeRedisSearchPatternCharacters(std::string& stringToProcess)
     {
         const std::string redisSearchPatternCharacters = R"(*?[]\)";
@@ -199,6 +233,7 @@ AsyncRedisStorage::AsyncRedisStorage(std::shared_ptr<Engine> engine,
                       pId,
                       namespaceConfigurations,
                       ::asyncCommandDispatcherCreator,
+                      ::asyncSubscriberCreator,
                       std::make_shared<redis::ContentsBuilder>(SEPARATOR),
                       logger)
 {
@@ -211,11 +246,33 @@ AsyncRedisStorage::AsyncRedisStorage(std::shared_ptr<Engine> engine,
                                      const AsyncCommandDispatcherCreator& asyncCommandDispatcherCreator,
                                      std::shared_ptr<redis::ContentsBuilder> contentsBuilder,
                                      std::shared_ptr<Logger> logger):
+    AsyncRedisStorage(engine,
+                      discovery,
+                      pId,
+                      namespaceConfigurations,
+                      asyncCommandDispatcherCreator,
+                      ::asyncSubscriberCreator,
+                      contentsBuilder,
+                      logger)
+{
+}
+
+AsyncRedisStorage::AsyncRedisStorage(std::shared_ptr<Engine> engine,
+                                     std::shared_ptr<redis::AsyncDatabaseDiscovery> discovery,
+                                     const boost::optional<PublisherId>& pId,
+                                     std::shared_ptr<NamespaceConfigurations> namespaceConfigurations,
+                                     const AsyncCommandDispatcherCreator& asyncCommandDispatcherCreator,
+                                     const AsyncCommandDispatcherCreator& asyncSubscriberCreator,
+                                     std::shared_ptr<redis::ContentsBuilder> contentsBuilder,
+                                     std::shared_ptr<Logger> logger):
     engine(engine),
     dispatcher(nullptr),
+    subscriber(nullptr),
+    subscriberConnected(false),
     discovery(discovery),
     publisherId(pId),
     asyncCommandDispatcherCreator(asyncCommandDispatcherCreator),
+    asyncSubscriberCreator(asyncSubscriberCreator),
     contentsBuilder(contentsBuilder),
     namespaceConfigurations(namespaceConfigurations),
     logger(logger)
@@ -237,6 +294,8 @@ AsyncRedisStorage::~AsyncRedisStorage()
         discovery->clearStateChangedCb();
     if (dispatcher)
         dispatcher->disableCommandCallbacks();
+    if (subscriber)
+        subscriber->disableCommandCallbacks();
 }
 
 redis::DatabaseInfo& AsyncRedisStorage::getDatabaseInfo()
@@ -257,6 +316,8 @@ void AsyncRedisStorage::serviceStateChanged(const redis::DatabaseInfo& newDataba
                                            readyAck = ReadyAck();
                                        });
     dbInfo = newDatabaseInfo;
+    if (subscriber)
+        createSubscriber();
 }
 
 int AsyncRedisStorage::fd() const
@@ -598,3 +659,145 @@ std::string AsyncRedisStorage::buildNamespaceKeySearchPattern(const Namespace& n
     oss << '{' << ns << '}' << SEPARATOR << pattern;
     return oss.str();
 }
+
+void AsyncRedisStorage::subscribeChannelAsync(const Namespace& ns,
+                                              const NotificationCb& notificationCb,
+                                              const ModifyAck& modifyAck)
+{
+    std::error_code ec;
+
+    if (!canOperationBePerformed(ns, boost::none, ec))
+    {
+        engine->postCallback(std::bind(modifyAck, ec));
+        return;
+    }
+
+    auto i(subscriptions.find(ns));
+    if (i != subscriptions.end())
+    {
+        i->second.notificationCb = notificationCb;
+        if (i->second.subscribeAck)
+        {
+            auto pendingAck(i->second.subscribeAck);
+            i->second.subscribeAck = [pendingAck, modifyAck](const std::error_code& error)
+                                     {
+                                         pendingAck(error);
+                                         modifyAck(error);
+                                     };
+        }
+        else
+            engine->postCallback(std::bind(modifyAck, std::error_code()));
+        return;
+    }
+
+    subscriptions.insert({ ns, { notificationCb, modifyAck } });
+    if (!subscriber)
+        createSubscriber();
+    else if (subscriberConnected)
+        subscribe(ns);
+}
+
+void AsyncRedisStorage::unsubscribeChannel(const Namespace& ns)
+{
+    if (!subscriptions.erase(ns))
+        return;
+    if (subscriberConnected)
+        subscriber->dispatchAsync([](const std::error_code&, const Reply&) { },
+                                  ns,
+                                  contentsBuilder->build("UNSUBSCRIBE", ns));
+}
+
+void AsyncRedisStorage::createSubscriber()
+{
+    if (subscriber)
+        subscriber->disableCommandCallbacks();
+    subscriberConnected = false;
+    auto newSubscriber(asyncSubscriberCreator(*engine,
+                                              dbInfo,
+                                              contentsBuilder,
+                                              logger));
+    /* Disconnect callback of a replaced subscriber may still be called while it is being
+     * destroyed, thus only callbacks of the current subscriber are handled.
+     */
+    auto newSubscriberPtr(newSubscriber.get());
+    newSubscriber->registerDisconnectCb([this, newSubscriberPtr]()
+                                        {
+                                            if (subscriber.get() != newSubscriberPtr)
+                                                return;
+                                            subscriberConnected = false;
+                                            subscriber->waitConnectedAsync(std::bind(&AsyncRedisStorage::subscriberConnectedCallback,
+                                                                                     this));
+                                        });
+    newSubscriber->waitConnectedAsync(std::bind(&AsyncRedisStorage::subscriberConnectedCallback, this));
+    subscriber = newSubscriber;
+}
+
+void AsyncRedisStorage::subscriberConnectedCallback()
+{
+    subscriberConnected = true;
+    for (const auto& i : subscriptions)
+        subscribe(i.first);
+}
+
+void AsyncRedisStorage::subscribe(const Namespace& ns)
+{
+    subscriber->dispatchAsync(std::bind(&AsyncRedisStorage::subscribeCommandCallback,
+                                        this,
+                                        std::placeholders::_1,
+                                        std::placeholders::_2,
+                                        ns),
+                              ns,
+                              contentsBuilder->build("SUBSCRIBE", ns));
+}
+
+void AsyncRedisStorage::subscribeCommandCallback(const std::error_code& error,
+                                                 const Reply& reply,
+                                                 const Namespace& ns)
+{
+    auto i(subscriptions.find(ns));
+    if (i == subscriptions.end())
+        return;
+
+    if (error)
+    {
+        /* Already active subscriptions are restored when the subscriber connection is
+         * re-established, only a failure of a new subscription is reported to the client.
+         */
+        if (i->second.subscribeAck)
+        {
+            auto subscribeAck(i->second.subscribeAck);
+            subscriptions.erase(i);
+            subscribeAck(error);
+        }
+        return;
+    }
+
+    std::string kind;
+    std::string message;
+    if (!parseSubscribeReply(reply, kind, message))
+    {
+        logger->error() << "AsyncRedisStorage: invalid SUBSCRIBE reply for namespace: " << ns;
+        return;
+    }
+
+    if (kind == "subscribe")
+    {
+        if (i->second.subscribeAck)
+        {
+            auto subscribeAck(i->second.subscribeAck);
+            i->second.subscribeAck = ModifyAck();
+            subscribeAck(std::error_code());
+        }
+        else
+        {
+            // Subscription was restored, notifications may have been lost meanwhile.
+            auto notificationCb(i->second.notificationCb);
+            notificationCb(ns, NO_PUBLISHER);
+        }
+    }
+    else if (kind == "message")
+    {
+        auto notificationCb(i->second.notificationCb);
+        notificationCb(ns, message);
+    }
+}
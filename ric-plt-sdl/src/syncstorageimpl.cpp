@@ -312,6 +312,38 @@ void SyncStorageImpl::removeAll(const Namespace& ns)
     verifyBackendResponse();
 }
 
+void SyncStorageImpl::subscribeChannel(const Namespace& ns, const NotificationCb& notificationCb)
+{
+    handlePendingEvents();
+    waitSdlToBeReady(ns);
+    synced = false;
+    asyncStorage->subscribeChannelAsync(ns,
+                                        notificationCb,
+                                        std::bind(&shareddatalayer::SyncStorageImpl::modifyAck,
+                                                  this,
+                                                  std::placeholders::_1));
+    waitForOperationCallback();
+    verifyBackendResponse();
+}
+
+void SyncStorageImpl::unsubscribeChannel(const Namespace& ns)
+{
+    asyncStorage->unsubscribeChannel(ns);
+}
+
+void SyncStorageImpl::handleNotifications(const std::chrono::steady_clock::duration& timeout)
+{
+    handlePendingEvents();
+    auto end(std::chrono::steady_clock::now() + timeout);
+    auto now(std::chrono::steady_clock::now());
+    while (now < end)
+    {
+        auto timeout_ms(std::chrono::duration_cast<std::chrono::milliseconds>(end - now).count());
+        pollAndHandleEvents(timeout_ms > 0 ? static_cast<int>(timeout_ms) : 1);
+        now = std::chrono::steady_clock::now();
+    }
+}
+
 void SyncStorageImpl::handlePendingEvents()
 {
     int pollRetVal = system.poll(&events, 1, 0);
@@ -405,6 +405,8 @@ namespace
 
     using AsyncHiredisCommandDispatcherDeathTest = AsyncHiredisCommandDispatcherConnectedTest;
 
+    using AsyncHiredisCommandDispatcherWithPermanentCommandCallbacksDeathTest = AsyncHiredisCommandDispatcherWithPermanentCommandCallbacksTest;
+
     class AsyncHiredisCommandDispatcherForSentinelTest: public AsyncHiredisCommandDispatcherBaseTest
     {
     public:
@@ -934,6 +936,106 @@ TEST_F(AsyncHiredisCommandDispatcherWithPermanentCommandCallbacksTest, CanHandle
     savedCb(&ac, &rr, savedPd);
 }
 
+TEST_F(AsyncHiredisCommandDispatcherWithPermanentCommandCallbacksTest, UnsubscribeIsDispatchedWithoutCallbackAndAckedOnceQueued)
+{
+    InSequence dummy;
+    Engine::Callback storedCallback;
+    Contents contents({ { "UNSUBSCRIBE", "channel" }, { 11, 7 } });
+    expectCommandListQuery();
+    connected(&ac, 0);
+    EXPECT_CALL(hiredisSystemMock, redisAsyncCommandArgv(&ac, nullptr, nullptr, 2, _, _))
+        .Times(1)
+        .WillOnce(Return(REDIS_OK));
+    EXPECT_CALL(engineMock, postCallback(_))
+        .Times(1)
+        .WillOnce(SaveArg<0>(&storedCallback));
+    dispatcher->dispatchAsync(std::bind(&AsyncHiredisCommandDispatcherConnectedTest::ack,
+                                        this,
+                                        std::placeholders::_1,
+                                        std::placeholders::_2),
+                                        defaultNamespace,
+                                        contents);
+    EXPECT_CALL(*this, ack(std::error_code(), _))
+        .Times(1);
+    storedCallback();
+}
+
+TEST_F(AsyncHiredisCommandDispatcherWithPermanentCommandCallbacksDeathTest, CbRemovedAfterUnsubscribeReply)
+{
+    InSequence dummy;
+    redisCallbackFn* savedCb;
+    void* savedPd;
+    Contents contents({ { "SUBSCRIBE", "channel" }, { 9, 7 } });
+    expectCommandListQuery();
+    connected(&ac, 0);
+    EXPECT_CALL(hiredisSystemMock, redisAsyncCommandArgv(&ac, _, _, _, _, _))
+        .Times(1)
+        .WillOnce(Invoke([&savedCb, &savedPd](redisAsyncContext*, redisCallbackFn* cb, void* pd,
+                                              int, const char**, const size_t*)
+                         {
+                             savedCb = cb;
+                             savedPd = pd;
+                             return REDIS_OK;
+                         }));
+    dispatcher->dispatchAsync(std::bind(&AsyncHiredisCommandDispatcherConnectedTest::ack,
+                                        this,
+                                        std::placeholders::_1,
+                                        std::placeholders::_2),
+                                        defaultNamespace,
+                                        contents);
+    redisReply kind { };
+    kind.type = REDIS_REPLY_STRING;
+    redisReply channel { };
+    channel.type = REDIS_REPLY_STRING;
+    channel.str = const_cast<char*>("channel");
+    channel.len = 7;
+    redisReply count { };
+    count.type = REDIS_REPLY_INTEGER;
+    redisReply* elements[] = { &kind, &channel, &count };
+    redisReply rr { };
+    rr.type = REDIS_REPLY_ARRAY;
+    rr.elements = 3;
+    rr.element = elements;
+    EXPECT_CALL(*this, ack(std::error_code(), _))
+            .Times(2);
+    kind.str = const_cast<char*>("subscribe");
+    kind.len = 9;
+    savedCb(&ac, &rr, savedPd);
+    kind.str = const_cast<char*>("unsubscribe");
+    kind.len = 11;
+    savedCb(&ac, &rr, savedPd);
+    EXPECT_EXIT(savedCb(&ac, &rr, savedPd), KilledBySignal(SIGABRT), "");
+}
+
+TEST_F(AsyncHiredisCommandDispatcherWithPermanentCommandCallbacksDeathTest, CbRemovedAfterErrorReply)
+{
+    InSequence dummy;
+    redisCallbackFn* savedCb;
+    void* savedPd;
+    Contents contents({ { "SUBSCRIBE", "channel" }, { 9, 7 } });
+    expectCommandListQuery();
+    connected(&ac, 0);
+    EXPECT_CALL(hiredisSystemMock, redisAsyncCommandArgv(&ac, _, _, _, _, _))
+        .Times(1)
+        .WillOnce(Invoke([&savedCb, &savedPd](redisAsyncContext*, redisCallbackFn* cb, void* pd,
+                                              int, const char**, const size_t*)
+                         {
+                             savedCb = cb;
+                             savedPd = pd;
+                             return REDIS_OK;
+                         }));
+    dispatcher->dispatchAsync(std::bind(&AsyncHiredisCommandDispatcherConnectedTest::ack,
+                                        this,
+                                        std::placeholders::_1,
+                                        std::placeholders::_2),
+                                        defaultNamespace,
+                                        contents);
+    EXPECT_CALL(*this, ack(std::error_code(AsyncRedisCommandDispatcherErrorCode::UNKNOWN_ERROR), _))
+            .Times(1);
+    savedCb(&ac, &redisReplyBuilder.buildErrorReply("ERR something"), savedPd);
+    EXPECT_EXIT(savedCb(&ac, &redisReplyBuilder.buildNilReply(), savedPd), KilledBySignal(SIGABRT), "");
+}
+
 TEST_F(AsyncHiredisCommandDispatcherDeathTest, CbRemovedAfterHiredisCb)
 {
     redisCallbackFn* savedCb;
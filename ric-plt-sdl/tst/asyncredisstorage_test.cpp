@@ -74,6 +74,7 @@ namespace
         std::shared_ptr<StrictMock<EngineMock>> engineMock;
         std::shared_ptr<StrictMock<AsyncDatabaseDiscoveryMock>> discoveryMock;
         std::shared_ptr<StrictMock<AsyncCommandDispatcherMock>> dispatcherMock;
+        std::shared_ptr<StrictMock<AsyncCommandDispatcherMock>> subscriberMock;
         std::unique_ptr<AsyncRedisStorage> sdlStorage;
         AsyncStorage::Namespace ns;
         std::shared_ptr<StrictMock<ContentsBuilderMock>> contentsBuilderMock;
@@ -87,6 +88,9 @@ namespace
         Engine::EventHandler savedDispatcherEventHandler;
         AsyncDatabaseDiscovery::StateChangedCb stateChangedCb;
         AsyncCommandDispatcher::ConnectAck dispatcherConnectAck;
+        AsyncCommandDispatcher::ConnectAck subscriberConnectAck;
+        AsyncCommandDispatcher::DisconnectCb subscriberDisconnectCb;
+        AsyncCommandDispatcher::CommandCb savedSubscribeCommandCb;
         Engine::Callback storedCallback;
         AsyncCommandDispatcher::CommandCb savedCommandCb;
         AsyncCommandDispatcher::CommandCb savedPublishCommandCb;
@@ -95,6 +99,13 @@ namespace
         Reply::ReplyVector replyVector;
         Reply::ReplyVector commandListReplyVector;
         Reply::ReplyVector commandListReplyElementVector;
+        NiceMock<ReplyMock> subscribeReplyMock;
+        std::shared_ptr<NiceMock<ReplyMock>> subscribeReplyArrayElement0;
+        std::shared_ptr<NiceMock<ReplyMock>> subscribeReplyArrayElement1;
+        std::shared_ptr<NiceMock<ReplyMock>> subscribeReplyArrayElement2;
+        Reply::ReplyVector subscribeReplyVector;
+        Reply::DataItem subscribeKindDataItem;
+        Reply::DataItem subscribeMessageDataItem;
         std::string expectedStr1;
         std::string expectedStr2;
         AsyncStorage::Key key1;
@@ -111,6 +122,7 @@ namespace
             engineMock(std::make_shared<StrictMock<EngineMock>>()),
             discoveryMock(std::make_shared<StrictMock<AsyncDatabaseDiscoveryMock>>()),
             dispatcherMock(std::make_shared<StrictMock<AsyncCommandDispatcherMock>>()),
+            subscriberMock(std::make_shared<StrictMock<AsyncCommandDispatcherMock>>()),
             ns("tag1"),
             contentsBuilderMock(std::make_shared<StrictMock<ContentsBuilderMock>>(AsyncStorage::SEPARATOR)),
             namespaceConfigurationsMock(std::make_shared<StrictMock<NamespaceConfigurationsMock>>()),
@@ -119,6 +131,10 @@ namespace
             fd(10),
             discoveryFd(20),
             dispatcherFd(30),
+            subscribeReplyArrayElement0(std::make_shared<NiceMock<ReplyMock>>()),
+            subscribeReplyArrayElement1(std::make_shared<NiceMock<ReplyMock>>()),
+            subscribeReplyArrayElement2(std::make_shared<NiceMock<ReplyMock>>()),
+            subscribeReplyVector({ subscribeReplyArrayElement0, subscribeReplyArrayElement1, subscribeReplyArrayElement2 }),
             key1("key1"),
             key2("key2"),
             keys({key1,key2}),
@@ -143,6 +159,18 @@ namespace
 
         MOCK_METHOD0(newDispatcherCreated, void());
 
+        std::shared_ptr<AsyncCommandDispatcher> asyncSubscriberCreator(Engine&,
+                                                                       const DatabaseInfo&,
+                                                                       std::shared_ptr<ContentsBuilder>)
+        {
+            newSubscriberCreated();
+            return subscriberMock;
+        }
+
+        MOCK_METHOD0(newSubscriberCreated, void());
+
+        MOCK_METHOD2(notificationCb, void(const AsyncStorage::Namespace&, const std::string&));
+
         MOCK_METHOD1(readyAck, void(const std::error_code&));
 
         MOCK_METHOD1(modifyAck, void(const std::error_code&));
@@ -254,6 +282,11 @@ namespace
                                                              std::placeholders::_1,
                                                              std::placeholders::_2,
                                                              std::placeholders::_3),
+                                                   std::bind(&AsyncRedisStorageTestBase::asyncSubscriberCreator,
+                                                             this,
+                                                             std::placeholders::_1,
+                                                             std::placeholders::_2,
+                                                             std::placeholders::_3),
                                                    contentsBuilderMock,
                                                    logger));
         }
@@ -404,6 +437,79 @@ namespace
                 .Times(1)
                 .WillOnce(Return(contents));
         }
+
+        void expectSubscriberCreation()
+        {
+            EXPECT_CALL(*this, newSubscriberCreated())
+                .Times(1);
+            EXPECT_CALL(*subscriberMock, registerDisconnectCb(_))
+                .Times(1)
+                .WillOnce(SaveArg<0>(&subscriberDisconnectCb));
+            expectSubscriberWaitConnectedAsync();
+        }
+
+        void expectSubscriberWaitConnectedAsync()
+        {
+            EXPECT_CALL(*subscriberMock, waitConnectedAsync(_))
+                .Times(1)
+                .WillOnce(SaveArg<0>(&subscriberConnectAck));
+        }
+
+        void expectSubscribeDispatch()
+        {
+            expectContentsBuild("SUBSCRIBE", ns);
+            EXPECT_CALL(*subscriberMock, dispatchAsync(_, ns, contents))
+                .Times(1)
+                .WillOnce(SaveArg<0>(&savedSubscribeCommandCb));
+        }
+
+        void expectNotificationCb(const std::string& message)
+        {
+            EXPECT_CALL(*this, notificationCb(ns, message))
+                .Times(1);
+        }
+
+        void setSubscribeReply(const std::string& kind, const std::string& message)
+        {
+            subscribeKindDataItem = { kind, ReplyStringLength(kind.size()) };
+            subscribeMessageDataItem = { message, ReplyStringLength(message.size()) };
+            ON_CALL(subscribeReplyMock, getType())
+                .WillByDefault(Return(Reply::Type::ARRAY));
+            ON_CALL(subscribeReplyMock, getArray())
+                .WillByDefault(Return(&subscribeReplyVector));
+            ON_CALL(*subscribeReplyArrayElement0, getType())
+                .WillByDefault(Return(Reply::Type::STRING));
+            ON_CALL(*subscribeReplyArrayElement0, getString())
+                .WillByDefault(Return(&subscribeKindDataItem));
+            ON_CALL(*subscribeReplyArrayElement2, getType())
+                .WillByDefault(Return(Reply::Type::STRING));
+            ON_CALL(*subscribeReplyArrayElement2, getString())
+                .WillByDefault(Return(&subscribeMessageDataItem));
+        }
+
+        void subscribeChannel()
+        {
+            sdlStorage->subscribeChannelAsync(ns,
+                                              std::bind(&AsyncRedisStorageTestBase::notificationCb,
+                                                        this,
+                                                        std::placeholders::_1,
+                                                        std::placeholders::_2),
+                                              std::bind(&AsyncRedisStorageTestBase::modifyAck,
+                                                        this,
+                                                        std::placeholders::_1));
+        }
+
+        void subscribeChannelAndConnectSubscriber()
+        {
+            InSequence dummy;
+            expectSubscriberCreation();
+            subscribeChannel();
+            expectSubscribeDispatch();
+            subscriberConnectAck();
+            setSubscribeReply("subscribe", ns);
+            expectModifyAck(std::error_code());
+            savedSubscribeCommandCb(std::error_code(), subscribeReplyMock);
+        }
     };
 
     class AsyncRedisStorageTest: public AsyncRedisStorageTestBase
@@ -427,6 +533,21 @@ namespace
     };
 
 
+    class AsyncRedisStorageSubscriptionTest: public AsyncRedisStorageTest
+    {
+    public:
+        AsyncRedisStorageSubscriptionTest()
+        {
+            subscribeChannelAndConnectSubscriber();
+        }
+
+        ~AsyncRedisStorageSubscriptionTest()
+        {
+            EXPECT_CALL(*subscriberMock, disableCommandCallbacks())
+                .Times(1);
+        }
+    };
+
     class AsyncRedisStorageTestNotificationsDisabled: public AsyncRedisStorageTestBase
     {
     public:
@@ -1080,3 +1201,107 @@ TEST_F(AsyncRedisStorageTestDispatcherNotCreated, RemoveAllAsyncWithoutDispatche
     expectModifyAck(std::error_code(AsyncRedisStorage::ErrorCode::REDIS_NOT_YET_DISCOVERED));
     storedCallback();
 }
+
+TEST_F(AsyncRedisStorageTestDispatcherNotCreated, SubscribeChannelAsyncWithoutDispatcherInstanceNacksWithREDIS_NOT_YET_DISCOVERED)
+{
+    InSequence dummy;
+    expectPostCallback();
+    subscribeChannel();
+    expectModifyAck(std::error_code(AsyncRedisStorage::ErrorCode::REDIS_NOT_YET_DISCOVERED));
+    storedCallback();
+}
+
+TEST_F(AsyncRedisStorageTest, PassingInvalidNamespaceToSubscribeChannelAsyncNacks)
+{
+    InSequence dummy;
+    expectPostCallback();
+    sdlStorage->subscribeChannelAsync("ns1,2",
+                                      std::bind(&AsyncRedisStorageTest::notificationCb,
+                                                this,
+                                                std::placeholders::_1,
+                                                std::placeholders::_2),
+                                      std::bind(&AsyncRedisStorageTest::modifyAck,
+                                                this,
+                                                std::placeholders::_1));
+    expectModifyAck(std::error_code(AsyncRedisStorage::ErrorCode::INVALID_NAMESPACE));
+    storedCallback();
+}
+
+TEST_F(AsyncRedisStorageTest, SubscribeChannelAsyncErrorIsForwarded)
+{
+    InSequence dummy;
+    expectSubscriberCreation();
+    subscribeChannel();
+    expectSubscribeDispatch();
+    subscriberConnectAck();
+    expectModifyAck(getWellKnownErrorCode());
+    savedSubscribeCommandCb(getWellKnownErrorCode(), subscribeReplyMock);
+    EXPECT_CALL(*subscriberMock, disableCommandCallbacks())
+        .Times(1);
+}
+
+TEST_F(AsyncRedisStorageSubscriptionTest, NotificationIsForwardedToNotificationCb)
+{
+    InSequence dummy;
+    setSubscribeReply("message", "somePublisher");
+    expectNotificationCb("somePublisher");
+    savedSubscribeCommandCb(std::error_code(), subscribeReplyMock);
+}
+
+TEST_F(AsyncRedisStorageSubscriptionTest, ErrorOfActiveSubscriptionIsNotForwarded)
+{
+    EXPECT_CALL(*this, modifyAck(_))
+        .Times(0);
+    EXPECT_CALL(*this, notificationCb(_, _))
+        .Times(0);
+    savedSubscribeCommandCb(getWellKnownErrorCode(), subscribeReplyMock);
+}
+
+TEST_F(AsyncRedisStorageSubscriptionTest, SubscribingAlreadySubscribedNamespaceReplacesNotificationCbAndAckIsScheduled)
+{
+    InSequence dummy;
+    expectPostCallback();
+    subscribeChannel();
+    expectModifyAck(std::error_code());
+    storedCallback();
+}
+
+TEST_F(AsyncRedisStorageSubscriptionTest, SubscriptionIsRestoredAfterReconnection)
+{
+    InSequence dummy;
+    expectSubscriberWaitConnectedAsync();
+    subscriberDisconnectCb();
+    expectSubscribeDispatch();
+    subscriberConnectAck();
+    setSubscribeReply("subscribe", ns);
+    expectNotificationCb(shareddatalayer::NO_PUBLISHER);
+    savedSubscribeCommandCb(std::error_code(), subscribeReplyMock);
+}
+
+TEST_F(AsyncRedisStorageSubscriptionTest, SubscriptionIsRestoredAfterFailover)
+{
+    InSequence dummy;
+    expectNewDispatcherCreated();
+    EXPECT_CALL(*subscriberMock, disableCommandCallbacks())
+        .Times(1);
+    expectSubscriberCreation();
+    stateChangedCb(getDatabaseInfo(DatabaseInfo::Type::SINGLE, DatabaseInfo::Discovery::SENTINEL, "address2", 4444));
+    expectSubscribeDispatch();
+    subscriberConnectAck();
+    setSubscribeReply("subscribe", ns);
+    expectNotificationCb(shareddatalayer::NO_PUBLISHER);
+    savedSubscribeCommandCb(std::error_code(), subscribeReplyMock);
+}
+
+TEST_F(AsyncRedisStorageSubscriptionTest, NotificationsAreNotForwardedAfterUnsubscribe)
+{
+    InSequence dummy;
+    expectContentsBuild("UNSUBSCRIBE", ns);
+    EXPECT_CALL(*subscriberMock, dispatchAsync(_, ns, contents))
+        .Times(1);
+    sdlStorage->unsubscribeChannel(ns);
+    EXPECT_CALL(*this, notificationCb(_, _))
+        .Times(0);
+    setSubscribeReply("message", "somePublisher");
+    savedSubscribeCommandCb(std::error_code(), subscribeReplyMock);
+}
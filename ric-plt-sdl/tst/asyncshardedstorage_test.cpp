@@ -0,0 +1,384 @@
+/*
+   Copyright (c) 2018-2022 Nokia.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+/*
+ * This source code is part of the near-RT RIC (RAN Intelligent Controller)
+ * platform project (RICP).
+*/
+
+#include <gtest/gtest.h>
+#include <type_traits>
+#include <memory>
+#include "private/asyncshardedstorage.hpp"
+#include "private/tst/asyncstoragemock.hpp"
+#include "private/tst/enginemock.hpp"
+#include "private/tst/wellknownerrorcode.hpp"
+
+using namespace shareddatalayer;
+using namespace shareddatalayer::tst;
+using namespace testing;
+
+namespace
+{
+    class AsyncShardedStorageTest: public testing::Test
+    {
+    public:
+        const std::size_t shardCount;
+        const std::size_t connectionsPerShard;
+        std::shared_ptr<StrictMock<EngineMock>> engineMock;
+        std::vector<std::shared_ptr<StrictMock<AsyncStorageMock>>> connectionMocks;
+        AsyncStorage::Namespace ns;
+        std::vector<std::pair<AsyncStorage::DataMap, AsyncStorage::ModifyAck>> savedSets;
+        std::vector<std::pair<AsyncStorage::Keys, AsyncStorage::GetAck>> savedGets;
+        std::vector<AsyncStorage::FindKeysAck> savedFindKeysAcks;
+        std::vector<AsyncStorage::ModifyAck> savedModifyAcks;
+        std::unique_ptr<AsyncShardedStorage> shardedStorage;
+
+        AsyncShardedStorageTest():
+            shardCount(3),
+            connectionsPerShard(2),
+            engineMock(std::make_shared<StrictMock<EngineMock>>()),
+            ns("someKnownNamespace")
+        {
+            for (std::size_t i = 0; i < shardCount * connectionsPerShard; ++i)
+                connectionMocks.push_back(std::make_shared<StrictMock<AsyncStorageMock>>());
+            shardedStorage = createShardedStorage(shardCount, DatabaseConfiguration::ShardingMode::KEY);
+        }
+
+        std::unique_ptr<AsyncShardedStorage> createShardedStorage(std::size_t shards, DatabaseConfiguration::ShardingMode mode)
+        {
+            AsyncShardedStorage::Shards shardList;
+            for (std::size_t shard = 0; shard < shards; ++shard)
+            {
+                AsyncShardedStorage::Shard s;
+                s.id = "server" + std::to_string(shard) + ".local:6379";
+                for (std::size_t connection = 0; connection < connectionsPerShard; ++connection)
+                    s.connections.push_back(connectionMocks.at((shard * connectionsPerShard + connection) % connectionMocks.size()));
+                shardList.push_back(s);
+            }
+            return std::unique_ptr<AsyncShardedStorage>(new AsyncShardedStorage(engineMock, shardList, mode));
+        }
+
+        MOCK_METHOD1(modifyAck, void(const std::error_code&));
+
+        MOCK_METHOD2(modifyIfAck, void(const std::error_code&, bool));
+
+        MOCK_METHOD2(getAck, void(const std::error_code&, const AsyncStorage::DataMap&));
+
+        MOCK_METHOD2(findKeysAck, void(const std::error_code&, const AsyncStorage::Keys&));
+
+        MOCK_METHOD2(notificationCb, void(const AsyncStorage::Namespace&, const std::string&));
+
+        AsyncStorage::Keys createKeys(std::size_t count)
+        {
+            AsyncStorage::Keys keys;
+            for (std::size_t i = 0; i < count; ++i)
+                keys.insert("key" + std::to_string(i));
+            return keys;
+        }
+
+        void expectSetAsyncToAnyConnection()
+        {
+            for (auto& connectionMock : connectionMocks)
+                EXPECT_CALL(*connectionMock, setAsync(ns, _, _))
+                    .Times(AtMost(1))
+                    .WillRepeatedly(Invoke([this](const AsyncStorage::Namespace&,
+                                                  const AsyncStorage::DataMap& dataMap,
+                                                  const AsyncStorage::ModifyAck& ack)
+                                           {
+                                               savedSets.emplace_back(dataMap, ack);
+                                           }));
+        }
+
+        void expectGetAsyncToAnyConnection()
+        {
+            for (auto& connectionMock : connectionMocks)
+                EXPECT_CALL(*connectionMock, getAsync(ns, _, _))
+                    .Times(AtMost(1))
+                    .WillRepeatedly(Invoke([this](const AsyncStorage::Namespace&,
+                                                  const AsyncStorage::Keys& keys,
+                                                  const AsyncStorage::GetAck& ack)
+                                           {
+                                               savedGets.emplace_back(keys, ack);
+                                           }));
+        }
+
+        void expectFindKeysAsyncToAllConnectionsOfShard(std::size_t shard)
+        {
+            for (std::size_t connection = 0; connection < connectionsPerShard; ++connection)
+                EXPECT_CALL(*connectionMocks.at(shard * connectionsPerShard + connection), findKeysAsync(ns, "prefix", _))
+                    .Times(1)
+                    .WillOnce(Invoke([this](const AsyncStorage::Namespace&,
+                                            const std::string&,
+                                            const AsyncStorage::FindKeysAck& ack)
+                                     {
+                                         savedFindKeysAcks.push_back(ack);
+                                     }));
+        }
+
+        void expectRemoveAllAsyncToAllConnectionsOfShard(std::size_t shard)
+        {
+            for (std::size_t connection = 0; connection < connectionsPerShard; ++connection)
+                EXPECT_CALL(*connectionMocks.at(shard * connectionsPerShard + connection), removeAllAsync(ns, _))
+                    .Times(1)
+                    .WillOnce(Invoke([this](const AsyncStorage::Namespace&,
+                                            const AsyncStorage::ModifyAck& ack)
+                                     {
+                                         savedModifyAcks.push_back(ack);
+                                     }));
+        }
+
+        void expectSubscribeChannelAsyncToFirstConnectionOfShard(std::size_t shard)
+        {
+            EXPECT_CALL(*connectionMocks.at(shard * connectionsPerShard), subscribeChannelAsync(ns, _, _))
+                .Times(1)
+                .WillOnce(Invoke([this](const AsyncStorage::Namespace&,
+                                        const AsyncStorage::NotificationCb&,
+                                        const AsyncStorage::ModifyAck& ack)
+                                 {
+                                     savedModifyAcks.push_back(ack);
+                                 }));
+        }
+    };
+}
+
+TEST_F(AsyncShardedStorageTest, IsNotCopyableAndIsNotMovable)
+{
+    EXPECT_FALSE(std::is_copy_assignable<AsyncShardedStorage>::value);
+    EXPECT_FALSE(std::is_move_assignable<AsyncShardedStorage>::value);
+    EXPECT_FALSE(std::is_copy_constructible<AsyncShardedStorage>::value);
+    EXPECT_FALSE(std::is_move_constructible<AsyncShardedStorage>::value);
+}
+
+TEST_F(AsyncShardedStorageTest, ImplementsAsyncStorage)
+{
+    EXPECT_TRUE((std::is_base_of<AsyncStorage, AsyncShardedStorage>::value));
+}
+
+TEST_F(AsyncShardedStorageTest, CanGetFd)
+{
+    EXPECT_CALL(*engineMock, fd())
+        .Times(1)
+        .WillOnce(Return(10));
+    EXPECT_EQ(10, shardedStorage->fd());
+}
+
+TEST_F(AsyncShardedStorageTest, KeysAreDistributedOverAllShards)
+{
+    std::vector<std::size_t> keysPerShard(shardCount);
+    for (const auto& key : createKeys(3000))
+        ++keysPerShard.at(shardedStorage->getShardIndex(ns, key));
+    for (auto count : keysPerShard)
+        EXPECT_LT(600U, count);
+}
+
+TEST_F(AsyncShardedStorageTest, AddingShardMovesKeysOnlyToTheNewShard)
+{
+    auto extendedStorage(createShardedStorage(shardCount + 1, DatabaseConfiguration::ShardingMode::KEY));
+    std::size_t movedKeys(0);
+    for (const auto& key : createKeys(3000))
+    {
+        const auto newShard(extendedStorage->getShardIndex(ns, key));
+        if (newShard == shardCount)
+            ++movedKeys;
+        else
+            EXPECT_EQ(shardedStorage->getShardIndex(ns, key), newShard);
+    }
+    EXPECT_GT(1500U, movedKeys);
+}
+
+TEST_F(AsyncShardedStorageTest, KeysWithSameHashTagAreRoutedToSameShard)
+{
+    const auto shard(shardedStorage->getShardIndex(ns, "{cell1}"));
+    for (const auto& key : createKeys(100))
+        EXPECT_EQ(shard, shardedStorage->getShardIndex(ns, "{cell1}," + key));
+}
+
+TEST_F(AsyncShardedStorageTest, NamespaceShardingModeRoutesAllKeysToSameShard)
+{
+    auto namespaceStorage(createShardedStorage(shardCount, DatabaseConfiguration::ShardingMode::NAMESPACE));
+    const auto shard(namespaceStorage->getShardIndex(ns, ""));
+    for (const auto& key : createKeys(100))
+        EXPECT_EQ(shard, namespaceStorage->getShardIndex(ns, key));
+}
+
+TEST_F(AsyncShardedStorageTest, SingleKeyOperationsOfSameKeyUseSameConnection)
+{
+    AsyncStorage::ModifyIfAck ack(std::bind(&AsyncShardedStorageTest::modifyIfAck,
+                                            this,
+                                            std::placeholders::_1,
+                                            std::placeholders::_2));
+    std::vector<AsyncStorage*> usedConnections;
+    for (auto& connectionMock : connectionMocks)
+    {
+        AsyncStorage* connection(connectionMock.get());
+        EXPECT_CALL(*connectionMock, setIfNotExistsAsync(ns, "key1", _, _))
+            .Times(AtMost(1))
+            .WillRepeatedly(InvokeWithoutArgs([&usedConnections, connection]() { usedConnections.push_back(connection); }));
+        EXPECT_CALL(*connectionMock, removeIfAsync(ns, "key1", _, _))
+            .Times(AtMost(1))
+            .WillRepeatedly(InvokeWithoutArgs([&usedConnections, connection]() { usedConnections.push_back(connection); }));
+    }
+    shardedStorage->setIfNotExistsAsync(ns, "key1", { 1 }, ack);
+    shardedStorage->removeIfAsync(ns, "key1", { 1 }, ack);
+    ASSERT_EQ(2U, usedConnections.size());
+    EXPECT_EQ(usedConnections.at(0), usedConnections.at(1));
+}
+
+TEST_F(AsyncShardedStorageTest, MultiKeySetIsSplitAndAckIsCalledWhenAllPartsAreAcked)
+{
+    AsyncStorage::DataMap dataMap;
+    for (const auto& key : createKeys(100))
+        dataMap[key] = { 1, 2, 3 };
+    expectSetAsyncToAnyConnection();
+    shardedStorage->setAsync(ns, dataMap, std::bind(&AsyncShardedStorageTest::modifyAck, this, std::placeholders::_1));
+    EXPECT_EQ(connectionMocks.size(), savedSets.size());
+
+    AsyncStorage::DataMap mergedDataMap;
+    for (const auto& savedSet : savedSets)
+        mergedDataMap.insert(savedSet.first.begin(), savedSet.first.end());
+    EXPECT_EQ(dataMap, mergedDataMap);
+
+    for (std::size_t i = 0; i < savedSets.size() - 1; ++i)
+        savedSets.at(i).second(std::error_code());
+    EXPECT_CALL(*this, modifyAck(std::error_code()))
+        .Times(1);
+    savedSets.back().second(std::error_code());
+}
+
+TEST_F(AsyncShardedStorageTest, ErrorOfAnyPartOfMultiKeySetIsForwarded)
+{
+    AsyncStorage::DataMap dataMap;
+    for (const auto& key : createKeys(100))
+        dataMap[key] = { 1 };
+    expectSetAsyncToAnyConnection();
+    shardedStorage->setAsync(ns, dataMap, std::bind(&AsyncShardedStorageTest::modifyAck, this, std::placeholders::_1));
+    savedSets.front().second(getWellKnownErrorCode());
+    for (std::size_t i = 1; i < savedSets.size() - 1; ++i)
+        savedSets.at(i).second(std::error_code());
+    EXPECT_CALL(*this, modifyAck(getWellKnownErrorCode()))
+        .Times(1);
+    savedSets.back().second(std::error_code());
+}
+
+TEST_F(AsyncShardedStorageTest, MultiKeyGetIsSplitAndResultsAreMerged)
+{
+    const auto keys(createKeys(100));
+    expectGetAsyncToAnyConnection();
+    shardedStorage->getAsync(ns, keys, std::bind(&AsyncShardedStorageTest::getAck,
+                                                 this,
+                                                 std::placeholders::_1,
+                                                 std::placeholders::_2));
+    EXPECT_EQ(connectionMocks.size(), savedGets.size());
+
+    AsyncStorage::DataMap expectedDataMap;
+    for (const auto& key : keys)
+        expectedDataMap[key] = { 1 };
+    EXPECT_CALL(*this, getAck(std::error_code(), expectedDataMap))
+        .Times(1);
+    for (const auto& savedGet : savedGets)
+    {
+        AsyncStorage::DataMap partialDataMap;
+        for (const auto& key : savedGet.first)
+            partialDataMap[key] = { 1 };
+        savedGet.second(std::error_code(), partialDataMap);
+    }
+}
+
+TEST_F(AsyncShardedStorageTest, EmptyMultiKeySetIsForwardedToSingleConnection)
+{
+    EXPECT_CALL(*connectionMocks.front(), setAsync(ns, IsEmpty(), _))
+        .Times(1);
+    shardedStorage->setAsync(ns, AsyncStorage::DataMap(), std::bind(&AsyncShardedStorageTest::modifyAck, this, std::placeholders::_1));
+}
+
+TEST_F(AsyncShardedStorageTest, FindKeysIsSentToAllConnectionsAndResultsAreMerged)
+{
+    for (std::size_t shard = 0; shard < shardCount; ++shard)
+        expectFindKeysAsyncToAllConnectionsOfShard(shard);
+    shardedStorage->findKeysAsync(ns, "prefix", std::bind(&AsyncShardedStorageTest::findKeysAck,
+                                                          this,
+                                                          std::placeholders::_1,
+                                                          std::placeholders::_2));
+    EXPECT_CALL(*this, findKeysAck(std::error_code(), AsyncStorage::Keys({ "a", "b", "c" })))
+        .Times(1);
+    savedFindKeysAcks.at(0)(std::error_code(), { "a" });
+    savedFindKeysAcks.at(1)(std::error_code(), { "a" });
+    savedFindKeysAcks.at(2)(std::error_code(), { "b", "c" });
+    savedFindKeysAcks.at(3)(std::error_code(), { "b" });
+    savedFindKeysAcks.at(4)(std::error_code(), { });
+    savedFindKeysAcks.at(5)(std::error_code(), { });
+}
+
+TEST_F(AsyncShardedStorageTest, RemoveAllIsSentToAllConnectionsSoThatEarlierSetsOnAnyConnectionAreRemoved)
+{
+    for (std::size_t shard = 0; shard < shardCount; ++shard)
+        expectRemoveAllAsyncToAllConnectionsOfShard(shard);
+    shardedStorage->removeAllAsync(ns, std::bind(&AsyncShardedStorageTest::modifyAck, this, std::placeholders::_1));
+    for (std::size_t i = 0; i + 1 < savedModifyAcks.size(); ++i)
+        savedModifyAcks.at(i)(std::error_code());
+    EXPECT_CALL(*this, modifyAck(std::error_code()))
+        .Times(1);
+    savedModifyAcks.back()(std::error_code());
+}
+
+TEST_F(AsyncShardedStorageTest, FindKeysIsSentOnlyToNamespaceShardInNamespaceShardingMode)
+{
+    auto namespaceStorage(createShardedStorage(shardCount, DatabaseConfiguration::ShardingMode::NAMESPACE));
+    expectFindKeysAsyncToAllConnectionsOfShard(namespaceStorage->getShardIndex(ns, ""));
+    namespaceStorage->findKeysAsync(ns, "prefix", std::bind(&AsyncShardedStorageTest::findKeysAck,
+                                                            this,
+                                                            std::placeholders::_1,
+                                                            std::placeholders::_2));
+    EXPECT_CALL(*this, findKeysAck(std::error_code(), AsyncStorage::Keys({ "a", "b" })))
+        .Times(1);
+    savedFindKeysAcks.at(0)(std::error_code(), { "a" });
+    savedFindKeysAcks.at(1)(std::error_code(), { "b" });
+}
+
+TEST_F(AsyncShardedStorageTest, SubscribeChannelIsSentToAllShards)
+{
+    for (std::size_t shard = 0; shard < shardCount; ++shard)
+        expectSubscribeChannelAsyncToFirstConnectionOfShard(shard);
+    shardedStorage->subscribeChannelAsync(ns,
+                                          std::bind(&AsyncShardedStorageTest::notificationCb,
+                                                    this,
+                                                    std::placeholders::_1,
+                                                    std::placeholders::_2),
+                                          std::bind(&AsyncShardedStorageTest::modifyAck, this, std::placeholders::_1));
+    savedModifyAcks.at(0)(std::error_code());
+    savedModifyAcks.at(1)(std::error_code());
+    EXPECT_CALL(*this, modifyAck(std::error_code()))
+        .Times(1);
+    savedModifyAcks.at(2)(std::error_code());
+}
+
+TEST_F(AsyncShardedStorageTest, WaitReadyIsSentToAllConnections)
+{
+    for (auto& connectionMock : connectionMocks)
+        EXPECT_CALL(*connectionMock, waitReadyAsync(ns, _))
+            .Times(1)
+            .WillOnce(Invoke([this](const AsyncStorage::Namespace&,
+                                    const AsyncStorage::ReadyAck& ack)
+                             {
+                                 savedModifyAcks.push_back(ack);
+                             }));
+    shardedStorage->waitReadyAsync(ns, std::bind(&AsyncShardedStorageTest::modifyAck, this, std::placeholders::_1));
+    EXPECT_CALL(*this, modifyAck(std::error_code()))
+        .Times(1);
+    for (auto& ack : savedModifyAcks)
+        ack(std::error_code());
+}
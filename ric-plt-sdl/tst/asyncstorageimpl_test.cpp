@@ -152,3 +152,19 @@ TEST_F(AsyncStorageImplTest, CorrectSdlClusterHandlerIsUsedBasedOnConfiguration)
     AsyncStorage& returnedHandler = asyncStorageImpl->getOperationHandler(ns);
     EXPECT_EQ(typeid(AsyncRedisStorage&), typeid(returnedHandler));
 }
+
+TEST_F(AsyncStorageImplTest, ShardedHandlerIsUsedWhenKeyShardingIsConfigured)
+{
+    expectNamespaceConfigurationIsDbBackendUseEnabled_returnTrue();
+    dummyDatabaseConfiguration->checkAndApplyShardingMode("key");
+    AsyncStorage& returnedHandler = asyncStorageImpl->getOperationHandler(ns);
+    EXPECT_EQ(typeid(AsyncShardedStorage&), typeid(returnedHandler));
+}
+
+TEST_F(AsyncStorageImplTest, ShardedHandlerIsUsedWhenMultipleConnectionsPerShardAreConfigured)
+{
+    expectNamespaceConfigurationIsDbBackendUseEnabled_returnTrue();
+    dummyDatabaseConfiguration->checkAndApplyConnectionsPerShard("4");
+    AsyncStorage& returnedHandler = asyncStorageImpl->getOperationHandler(ns);
+    EXPECT_EQ(typeid(AsyncShardedStorage&), typeid(returnedHandler));
+}
@@ -83,6 +83,16 @@ namespace
             EXPECT_CALL(databaseConfigurationMock, checkAndApplySentinelMasterNames(address));
         }
 
+        void expectShardingModeConfigurationCheckAndApply(const std::string& mode)
+        {
+            EXPECT_CALL(databaseConfigurationMock, checkAndApplyShardingMode(mode));
+        }
+
+        void expectConnectionsPerShardConfigurationCheckAndApply(const std::string& connections)
+        {
+            EXPECT_CALL(databaseConfigurationMock, checkAndApplyConnectionsPerShard(connections));
+        }
+
         void expectDatabaseConfigurationIsEmpty_returnFalse()
         {
             EXPECT_CALL(databaseConfigurationMock, isEmpty()).
@@ -398,6 +408,63 @@ TEST_F(ConfigurationReaderInputStreamTest, CanReadJSONDatabaseConfigurationWithM
     configurationReader->readDatabaseConfiguration(databaseConfigurationMock);
 }
 
+TEST_F(ConfigurationReaderInputStreamTest, CanReadJSONDatabaseConfigurationWithShardingParameters)
+{
+    InSequence dummy;
+    std::istringstream is(R"JSON(
+        {
+            "database":
+            {
+                "type": "sdl-standalone-cluster",
+                "servers":
+                [
+                    {
+                        "address": "10.20.30.40:50000"
+                    },
+                    {
+                        "address": "10.20.30.50:50001"
+                    }
+                ],
+                "shardingMode": "key",
+                "connectionsPerShard": 4
+            }
+        })JSON");
+
+    expectDbTypeConfigurationCheckAndApply("sdl-standalone-cluster");
+    expectDBServerAddressConfigurationCheckAndApply("10.20.30.40:50000");
+    expectDBServerAddressConfigurationCheckAndApply("10.20.30.50:50001");
+    expectShardingModeConfigurationCheckAndApply("key");
+    expectConnectionsPerShardConfigurationCheckAndApply("4");
+    configurationReader->readConfigurationFromInputStream(is);
+    configurationReader->readDatabaseConfiguration(databaseConfigurationMock);
+}
+
+TEST_F(ConfigurationReaderInputStreamTest, CanCatchAndThrowDatabaseConfigurationShardingModeError)
+{
+    InSequence dummy;
+    std::istringstream is(R"JSON(
+        {
+            "database":
+            {
+                "type": "sdl-standalone-cluster",
+                "servers":
+                [
+                    {
+                        "address": "10.20.30.40:50000"
+                    }
+                ],
+                "shardingMode": "someBadMode"
+            }
+        })JSON");
+
+    expectDbTypeConfigurationCheckAndApply("sdl-standalone-cluster");
+    expectDBServerAddressConfigurationCheckAndApply("10.20.30.40:50000");
+    EXPECT_CALL(databaseConfigurationMock, checkAndApplyShardingMode("someBadMode"))
+        .WillOnce(Throw(DatabaseConfiguration::InvalidShardingMode("someBadMode")));
+    configurationReader->readConfigurationFromInputStream(is);
+    EXPECT_THROW(configurationReader->readDatabaseConfiguration(databaseConfigurationMock), Exception);
+}
+
 TEST_F(ConfigurationReaderInputStreamTest, CanCatchAndThrowMisingMandatoryDatabaseTypeParameter)
 {
     InSequence dummy;
@@ -747,6 +814,8 @@ public:
     std::string sentinelPortEnvVariableValue;
     std::string sentinelMasterNameEnvVariableValue;
     std::string dbClusterAddrListEnvVariableValue;
+    std::string dbShardingModeEnvVariableValue;
+    std::string dbConnectionsPerShardEnvVariableValue;
     std::istringstream is{R"JSON(
         {
             "database":
@@ -783,11 +852,13 @@ public:
             try
             {
                 EXPECT_CALL(systemMock, getenv(_))
-                    .Times(5)
+                    .Times(7)
                     .WillOnce(Return(dbHostEnvVariableValue.c_str()))
                     .WillOnce(Return(nullptr))
                     .WillOnce(Return(nullptr))
                     .WillOnce(Return(nullptr))
+                    .WillOnce(Return(nullptr))
+                    .WillOnce(Return(nullptr))
                     .WillOnce(Return(nullptr));
                 initializeReaderWithoutDirectories();
                 configurationReader->readDatabaseConfiguration(databaseConfigurationMock);
@@ -811,6 +882,8 @@ TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationCanOv
     expectGetEnvironmentString(nullptr); //SENTINEL_PORT_ENV_VAR_NAME
     expectGetEnvironmentString(nullptr); //SENTINEL_MASTER_NAME_ENV_VAR_NAME
     expectGetEnvironmentString(nullptr); //DB_CLUSTER_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_SHARDING_MODE_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME
 
     expectDbTypeConfigurationCheckAndApply("redis-standalone");
     expectDBServerAddressConfigurationCheckAndApply("unknownAddress.local:12345");
@@ -829,6 +902,8 @@ TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationWitho
     expectGetEnvironmentString(nullptr); //SENTINEL_PORT_ENV_VAR_NAME
     expectGetEnvironmentString(nullptr); //SENTINEL_MASTER_NAME_ENV_VAR_NAME
     expectGetEnvironmentString(nullptr); //DB_CLUSTER_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_SHARDING_MODE_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME
 
     expectDbTypeConfigurationCheckAndApply("redis-standalone");
     expectDBServerAddressConfigurationCheckAndApply("server.local");
@@ -859,6 +934,8 @@ TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationAccep
     expectGetEnvironmentString(nullptr); //SENTINEL_PORT_ENV_VAR_NAME
     expectGetEnvironmentString(nullptr); //SENTINEL_MASTER_NAME_ENV_VAR_NAME
     expectGetEnvironmentString(nullptr); //DB_CLUSTER_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_SHARDING_MODE_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME
 
     expectDbTypeConfigurationCheckAndApply("redis-standalone");
     expectDBServerAddressConfigurationCheckAndApply("[2001::123]:12345");
@@ -879,6 +956,8 @@ TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationWithS
     sentinelMasterNameEnvVariableValue = "mymaster";
     expectGetEnvironmentString(sentinelMasterNameEnvVariableValue.c_str());
     expectGetEnvironmentString(nullptr); //DB_CLUSTER_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_SHARDING_MODE_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME
 
     expectDbTypeConfigurationCheckAndApply("redis-sentinel");
     expectDBServerAddressConfigurationCheckAndApply("sentinelAddress.local:1111");
@@ -901,6 +980,8 @@ TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationWithS
     expectGetEnvironmentString(sentinelMasterNameEnvVariableValue.c_str());
     dbClusterAddrListEnvVariableValue = "address-0.local,address-1.local,address-2.local";
     expectGetEnvironmentString(dbClusterAddrListEnvVariableValue.c_str());
+    expectGetEnvironmentString(nullptr); //DB_SHARDING_MODE_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME
 
     expectDbTypeConfigurationCheckAndApply("sdl-sentinel-cluster");
     expectDBServerAddressConfigurationCheckAndApply("address-0.local");
@@ -923,6 +1004,8 @@ TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationWitho
     expectGetEnvironmentString(nullptr); //SENTINEL_MASTER_NAME_ENV_VAR_NAME
     dbClusterAddrListEnvVariableValue = "address-0.local,address-1.local,address-2.local";
     expectGetEnvironmentString(dbClusterAddrListEnvVariableValue.c_str());
+    expectGetEnvironmentString(nullptr); //DB_SHARDING_MODE_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME
 
     expectDbTypeConfigurationCheckAndApply("sdl-standalone-cluster");
     expectDBServerAddressConfigurationCheckAndApply("address-0.local");
@@ -944,6 +1027,8 @@ TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationWitho
     expectGetEnvironmentString(nullptr); //SENTINEL_MASTER_NAME_ENV_VAR_NAME
     dbClusterAddrListEnvVariableValue = "address-0.local,address-1.local,address-2.local";
     expectGetEnvironmentString(dbClusterAddrListEnvVariableValue.c_str());
+    expectGetEnvironmentString(nullptr); //DB_SHARDING_MODE_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //DB_CONNECTIONS_PER_SHARD_ENV_VAR_NAME
 
     expectDbTypeConfigurationCheckAndApply("sdl-standalone-cluster");
     expectDBServerAddressConfigurationCheckAndApply("address-0.local:1111");
@@ -953,3 +1038,28 @@ TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationWitho
     initializeReaderWithoutDirectories();
     configurationReader->readDatabaseConfiguration(databaseConfigurationMock);
 }
+
+TEST_F(ConfigurationReaderEnvironmentVariableTest, EnvironmentConfigurationWithClusterAndShardingConfiguration)
+{
+    InSequence dummy;
+    dbHostEnvVariableValue = "address-0.local";
+    expectGetEnvironmentString(dbHostEnvVariableValue.c_str());
+    expectGetEnvironmentString(nullptr); //DB_PORT_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //SENTINEL_PORT_ENV_VAR_NAME
+    expectGetEnvironmentString(nullptr); //SENTINEL_MASTER_NAME_ENV_VAR_NAME
+    dbClusterAddrListEnvVariableValue = "address-0.local,address-1.local";
+    expectGetEnvironmentString(dbClusterAddrListEnvVariableValue.c_str());
+    dbShardingModeEnvVariableValue = "key";
+    expectGetEnvironmentString(dbShardingModeEnvVariableValue.c_str());
+    dbConnectionsPerShardEnvVariableValue = "4";
+    expectGetEnvironmentString(dbConnectionsPerShardEnvVariableValue.c_str());
+
+    expectDbTypeConfigurationCheckAndApply("sdl-standalone-cluster");
+    expectDBServerAddressConfigurationCheckAndApply("address-0.local");
+    expectDBServerAddressConfigurationCheckAndApply("address-1.local");
+    expectGetDbTypeAndWillOnceReturn(DatabaseConfiguration::DbType::SDL_STANDALONE_CLUSTER);
+    expectShardingModeConfigurationCheckAndApply(dbShardingModeEnvVariableValue);
+    expectConnectionsPerShardConfigurationCheckAndApply(dbConnectionsPerShardEnvVariableValue);
+    initializeReaderWithoutDirectories();
+    configurationReader->readDatabaseConfiguration(databaseConfigurationMock);
+}
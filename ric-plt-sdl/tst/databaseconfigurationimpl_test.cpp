@@ -256,3 +256,36 @@ TEST_F(DatabaseConfigurationImplTest, CanReturnDefaultSentinelPortForSDLClusterA
     EXPECT_EQ("cluster-0.local", address->getHost());
     EXPECT_EQ(26379, ntohs(address->getPort()));
 }
+
+TEST_F(DatabaseConfigurationImplTest, DefaultShardingModeIsNamespaceWithOneConnectionPerShard)
+{
+    EXPECT_EQ(DatabaseConfiguration::ShardingMode::NAMESPACE, databaseConfigurationImpl->getShardingMode());
+    EXPECT_EQ(1U, databaseConfigurationImpl->getConnectionsPerShard());
+}
+
+TEST_F(DatabaseConfigurationImplTest, CanApplyAndReturnShardingMode)
+{
+    databaseConfigurationImpl->checkAndApplyShardingMode("key");
+    EXPECT_EQ(DatabaseConfiguration::ShardingMode::KEY, databaseConfigurationImpl->getShardingMode());
+    databaseConfigurationImpl->checkAndApplyShardingMode("namespace");
+    EXPECT_EQ(DatabaseConfiguration::ShardingMode::NAMESPACE, databaseConfigurationImpl->getShardingMode());
+}
+
+TEST_F(DatabaseConfigurationImplTest, CanThrowIfIllegalShardingModeIsApplied)
+{
+    EXPECT_THROW(databaseConfigurationImpl->checkAndApplyShardingMode("bad_mode"), DatabaseConfiguration::InvalidShardingMode);
+}
+
+TEST_F(DatabaseConfigurationImplTest, CanApplyAndReturnConnectionsPerShard)
+{
+    databaseConfigurationImpl->checkAndApplyConnectionsPerShard("8");
+    EXPECT_EQ(8U, databaseConfigurationImpl->getConnectionsPerShard());
+}
+
+TEST_F(DatabaseConfigurationImplTest, CanThrowIfIllegalConnectionsPerShardIsApplied)
+{
+    EXPECT_THROW(databaseConfigurationImpl->checkAndApplyConnectionsPerShard("0"), DatabaseConfiguration::InvalidConnectionsPerShard);
+    EXPECT_THROW(databaseConfigurationImpl->checkAndApplyConnectionsPerShard("65"), DatabaseConfiguration::InvalidConnectionsPerShard);
+    EXPECT_THROW(databaseConfigurationImpl->checkAndApplyConnectionsPerShard("many"), DatabaseConfiguration::InvalidConnectionsPerShard);
+    EXPECT_EQ(1U, databaseConfigurationImpl->getConnectionsPerShard());
+}
@@ -310,6 +310,13 @@ namespace
                 .Times(1)
                 .WillOnce(SaveArg<3>(&savedModifyIfAck));
         }
+
+        void expectSubscribeChannelAsync()
+        {
+            EXPECT_CALL(*asyncStorageMockRawPtr, subscribeChannelAsync(ns, _, _))
+                .Times(1)
+                .WillOnce(SaveArg<2>(&savedModifyAck));
+        }
     };
 }
 
@@ -671,6 +678,41 @@ TEST_F(SyncStorageImplTest, RemoveAllCanThrowBackendError)
     EXPECT_THROW(syncStorage->removeAll(ns), BackendError);
 }
 
+TEST_F(SyncStorageImplTest, SubscribeChannelSuccessfully)
+{
+    InSequence dummy;
+    expectSdlReadinessCheck(SyncStorageImpl::NO_TIMEOUT);
+    expectSubscribeChannelAsync();
+    expectPollWait(SyncStorageImpl::NO_TIMEOUT);
+    expectHandleEvents_callModifyAck();
+    syncStorage->subscribeChannel(ns, [](const SyncStorage::Namespace&, const std::string&) { });
+}
+
+TEST_F(SyncStorageImplTest, SubscribeChannelCanThrowBackendError)
+{
+    InSequence dummy;
+    expectSdlReadinessCheck(SyncStorageImpl::NO_TIMEOUT);
+    expectSubscribeChannelAsync();
+    expectPollWait(SyncStorageImpl::NO_TIMEOUT);
+    expectModifyAckWithError();
+    EXPECT_THROW(syncStorage->subscribeChannel(ns, [](const SyncStorage::Namespace&, const std::string&) { }),
+                 BackendError);
+}
+
+TEST_F(SyncStorageImplTest, UnsubscribeChannelIsForwarded)
+{
+    EXPECT_CALL(*asyncStorageMockRawPtr, unsubscribeChannel(ns))
+        .Times(1);
+    syncStorage->unsubscribeChannel(ns);
+}
+
+TEST_F(SyncStorageImplTest, HandleNotificationsWithZeroTimeoutHandlesOnlyPendingEvents)
+{
+    InSequence dummy;
+    expectPollForPendingEvents_ReturnNoEvents();
+    syncStorage->handleNotifications(std::chrono::steady_clock::duration::zero());
+}
+
 TEST_F(SyncStorageImplTest, AllAsyncRedisStorageErrorCodesThrowCorrectException)
 {
     InSequence dummy;
@@ -354,7 +354,7 @@ std::string xapp::Alarm::Get_endpoint( ) const {
 bool xapp::Alarm::Raise( ) {
 	int used;
 	used = build_alarm( ACT_RAISE, msg->Get_payload(), msg->Get_available_size() );
-	msg->Wormhole_send( whid,  RIC_ALARM, xapp::Message::NO_SUBID, used + 1, NULL );
+	return msg->Wormhole_send( whid,  RIC_ALARM, xapp::Message::NO_SUBID, used + 1, NULL );
 }
 
 /*
@@ -368,7 +368,7 @@ bool xapp::Alarm::Raise( int new_severity, int problem, const std::string& cinfo
 	problem_id = problem;
 	info = cinfo;
 
-	Raise();
+	return Raise();
 }
 
 bool xapp::Alarm::Raise( int new_severity, int problem, const std::string& cinfo, const std::string& additional_info ) {
@@ -377,7 +377,7 @@ bool xapp::Alarm::Raise( int new_severity, int problem, const std::string& cinfo
 	info = cinfo;
 	this->add_info = additional_info;
 
-	Raise();
+	return Raise();
 }
 
 /*
@@ -387,7 +387,7 @@ bool xapp::Alarm::Clear( ) {
 	int used;
 
 	used = build_alarm( ACT_CLEAR, msg->Get_payload(), msg->Get_available_size() );
-	msg->Wormhole_send( whid,  RIC_ALARM, xapp::Message::NO_SUBID, used + 1, NULL );
+	return msg->Wormhole_send( whid,  RIC_ALARM, xapp::Message::NO_SUBID, used + 1, NULL );
 }
 
 /*
@@ -401,7 +401,7 @@ bool xapp::Alarm::Clear( int new_severity, int problem, const std::string& cinfo
 	problem_id = problem;
 	info = cinfo;
 
-	Clear();
+	return Clear();
 }
 
 bool xapp::Alarm::Clear( int new_severity, int problem, const std::string& cinfo, const std::string& additional_info ) {
@@ -410,7 +410,7 @@ bool xapp::Alarm::Clear( int new_severity, int problem, const std::string& cinfo
 	info = cinfo;
 	this->add_info = additional_info;
 
-	Clear();
+	return Clear();
 }
 
 
@@ -421,7 +421,7 @@ bool xapp::Alarm::Clear_all( ) {
 	int used;
 
 	used = build_alarm( ACT_CLEAR_ALL, msg->Get_payload(), msg->Get_available_size() );
-	msg->Wormhole_send( whid,  RIC_ALARM, xapp::Message::NO_SUBID, used + 1, NULL );
+	return msg->Wormhole_send( whid,  RIC_ALARM, xapp::Message::NO_SUBID, used + 1, NULL );
 }
 
 
@@ -430,8 +430,10 @@ bool xapp::Alarm::Clear_all( ) {
 	raise message. Alarm contents are not adjusted.
 */
 bool xapp::Alarm::Raise_again( ) {
-	Clear();
-	Raise();
+	bool	state;
+
+	state = Clear();
+	return Raise() && state;
 }
 
 
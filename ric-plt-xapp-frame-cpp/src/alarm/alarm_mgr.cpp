@@ -0,0 +1,460 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	alarm_mgr.cpp
+	Abstract:	The alarm manager. The xAPP raises and clears alarms through
+				the manager which keeps the state of each and sends only the
+				changes, from a flusher thread, at a limited rate.
+
+				Ordering: alarms are queued in the order that their state
+				first changed since the last send, and the flusher sends the
+				state that each has when it is sent. A raise followed by a
+				clear (or the reverse) before the flush results in nothing
+				being sent if the collector already has that state. A clear
+				all is sent before anything raised after it.
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <time.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "message.hpp"
+#include "alarm.hpp"
+#include "alarm_mgr.hpp"
+
+namespace xapp {
+
+// ------ private ----------------------------------------------
+
+/*
+	Return the current (monotonic) time in milliseconds.
+*/
+static long long mono_ms( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ((long long) ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+/*
+	Put the alarm on the pending queue if it is not already there.
+	Caller must hold the lock.
+*/
+void xapp::Alarm_mgr::Queue( const akey_t& key, astate_t& state ) {
+	if( ! state.queued ) {
+		state.queued = true;
+		pending.push_back( key );
+		if( pending.size() == 1 ) {
+			wake.notify_one();					// flusher may sleep until the period pops otherwise
+		}
+	}
+}
+
+/*
+	Send one alarm message either through the user's sender or our alarm.
+*/
+bool xapp::Alarm_mgr::Send( const asend_t& as ) {
+	if( sender != NULL ) {
+		return sender( as.action, as.problem, as.meid, as.severity, as.info, as.add_info, sender_data );
+	}
+
+	if( alarm == NULL ) {
+		return false;
+	}
+
+	if( as.action == Alarm::ACT_CLEAR_ALL ) {
+		return alarm->Clear_all();
+	}
+
+	alarm->Set_meid( as.meid );
+	alarm->Set_problem( as.problem );
+	alarm->Set_severity( as.severity );
+	alarm->Set_info( as.info );
+	alarm->Set_additional( as.add_info );
+
+	if( as.action == Alarm::ACT_CLEAR ) {
+		return alarm->Clear();
+	}
+	return alarm->Raise();
+}
+
+/*
+	Send what is pending. If limit is true, no more messages than the rate
+	allows are sent; anything left stays queued, in order, for the next
+	flush. The work is copied out under the lock and sent without it so
+	that raising never waits on a send. What the collector was told is
+	recorded only once the send succeeds; an alarm whose send failed is put
+	back at the head of the queue, and a failed clear all is flagged again,
+	so that the next flush tries it again. Returns the number sent.
+*/
+int xapp::Alarm_mgr::Flush( bool limit ) {
+	std::unique_lock<std::mutex> slk( send_gate );
+	std::vector<asend_t> work;
+	std::vector<bool> ok;
+	asend_t	as;
+	akey_t	key;
+	long long now;
+	long	budget;
+	long	gen;
+	int		nsent_now = 0;
+	int		nfail_now = 0;
+	size_t	i;
+
+	{
+		std::unique_lock<std::mutex> lk( gate );
+
+		now = mono_ms();
+		tokens += (double) (now - last_fill) * max_rate / 1000.0;
+		if( tokens > max_rate ) {
+			tokens = max_rate;					// burst is one second's worth
+		}
+		last_fill = now;
+		budget = limit ? (long) tokens : pending.size() + 1;
+		gen = clear_gen;
+
+		if( clear_all && budget > 0 ) {
+			as.action = Alarm::ACT_CLEAR_ALL;
+			as.problem = -1;
+			as.severity = Alarm::SEV_CLEAR;
+			work.push_back( as );
+			clear_all = false;
+			budget--;
+		}
+
+		while( budget > 0 && ! pending.empty() ) {
+			auto it = alarms.find( pending.front() );
+			pending.pop_front();
+			if( it == alarms.end() ) {
+				continue;
+			}
+
+			astate_t& st = it->second;
+			st.queued = false;
+			if( st.want == st.sent && (st.want == Alarm::ACT_CLEAR ||
+				(st.severity == st.sent_severity && st.info == st.sent_info && st.add_info == st.sent_add_info)) ) {
+				nabsorbed++;											// changed and changed back; nothing to say
+				if( st.want == Alarm::ACT_CLEAR ) {						// cleared alarms are forgotten
+					alarms.erase( it );
+				}
+			} else {
+				as.action = st.want;
+				as.problem = it->first.problem;
+				as.meid = it->first.meid;
+				as.severity = st.severity;
+				as.info = st.info;
+				as.add_info = st.add_info;
+				work.push_back( as );
+				budget--;
+			}
+		}
+
+		if( limit ) {
+			tokens -= work.size();
+		}
+	}
+
+	for( i = 0; i < work.size(); i++ ) {
+		ok.push_back( Send( work[i] ) );
+		if( ok[i] ) {
+			nsent_now++;
+		} else {
+			nfail_now++;
+		}
+	}
+
+	if( ! work.empty() ) {
+		std::unique_lock<std::mutex> lk( gate );
+		nsent += nsent_now;
+		nfailed += nfail_now;
+
+		if( gen != clear_gen ) {							// cleared while sending; the state we sent from is gone
+			return nsent_now;
+		}
+
+		for( i = work.size(); i-- > 0; ) {					// backwards so that requeued alarms keep their order
+			if( work[i].action == Alarm::ACT_CLEAR_ALL ) {
+				if( ! ok[i] ) {
+					clear_all = true;
+				}
+				continue;
+			}
+
+			key.problem = work[i].problem;
+			key.meid = work[i].meid;
+			auto it = alarms.find( key );
+			if( it == alarms.end() ) {
+				continue;
+			}
+
+			astate_t& st = it->second;
+			if( ! ok[i] ) {
+				if( ! st.queued ) {
+					st.queued = true;
+					pending.push_front( it->first );
+				}
+				continue;
+			}
+
+			st.sent = work[i].action;
+			if( work[i].action == Alarm::ACT_RAISE ) {
+				st.sent_severity = work[i].severity;
+				st.sent_info = work[i].info;
+				st.sent_add_info = work[i].add_info;
+			} else {
+				if( ! st.queued ) {							// cleared alarms are forgotten unless raised again
+					alarms.erase( it );
+				}
+			}
+		}
+	}
+
+	return nsent_now;
+}
+
+/*
+	The flusher: sends what is pending each period, or sooner when the
+	queue goes from empty to not empty.
+*/
+void xapp::Alarm_mgr::Flusher( int period_ms ) {
+	while( ok_2_run ) {
+		{
+			std::unique_lock<std::mutex> lk( gate );
+			if( pending.empty() && ! clear_all && ok_2_run ) {
+				wake.wait_for( lk, std::chrono::milliseconds( period_ms ) );
+			}
+		}
+
+		if( Flush( true ) == 0 && Get_pending() > 0 ) {		// rate exhausted; don't spin
+			std::this_thread::sleep_for( std::chrono::milliseconds( period_ms ) );
+		}
+	}
+}
+
+// --------------- builders  -------------------------------------
+
+/*
+	The alarm is used to send messages and should be one allocated by the
+	framework (Alloc_alarm()); it may be nil if the user supplies a sender.
+	Max rate is the most messages that will be sent in a second.
+*/
+xapp::Alarm_mgr::Alarm_mgr( std::shared_ptr<Alarm> alarm, int max_rate ) :
+	alarm( alarm ),
+	max_rate( max_rate > 0 ? max_rate : DEF_RATE ),
+	ok_2_run( false )
+{
+	tokens = this->max_rate;
+	last_fill = mono_ms();
+}
+
+xapp::Alarm_mgr::~Alarm_mgr( ) {
+	Stop();
+}
+
+// ------------ public API ---------------------------------------------------
+
+/*
+	Send alarms through the user's function rather than the alarm.
+*/
+void xapp::Alarm_mgr::Set_sender( alarm_sender fun, void* data ) {
+	std::unique_lock<std::mutex> slk( send_gate );
+
+	sender = fun;
+	sender_data = data;
+}
+
+/*
+	Raise the alarm for the problem on the managed element. This only
+	updates the manager's state; the message is sent by the flusher. Returns
+	true if the alarm was not already raised with the same severity and
+	information (false if the raise was absorbed as a repeat).
+*/
+bool xapp::Alarm_mgr::Raise( int problem, const std::string& meid, int severity, const std::string& info, const std::string& add_info ) {
+	std::unique_lock<std::mutex> lk( gate );
+	akey_t	key;
+
+	key.problem = problem;
+	key.meid = meid;
+
+	auto it = alarms.find( key );
+	if( it == alarms.end() ) {
+		astate_t ns;
+
+		ns.want = Alarm::ACT_CLEAR;
+		ns.sent = Alarm::ACT_CLEAR;
+		ns.queued = false;
+		ns.severity = -1;
+		ns.sent_severity = -1;
+		it = alarms.emplace( key, ns ).first;
+	}
+
+	astate_t& st = it->second;
+	if( st.want == Alarm::ACT_RAISE && st.severity == severity && st.info == info && st.add_info == add_info ) {
+		nabsorbed++;
+		return false;
+	}
+
+	st.want = Alarm::ACT_RAISE;
+	st.severity = severity;
+	st.info = info;
+	st.add_info = add_info;
+	Queue( it->first, st );
+
+	return true;
+}
+
+bool xapp::Alarm_mgr::Raise( int problem, const std::string& meid, int severity, const std::string& info ) {
+	return Raise( problem, meid, severity, info, "" );
+}
+
+/*
+	Clear the alarm. Returns false if the alarm was not raised (the clear
+	was absorbed).
+*/
+bool xapp::Alarm_mgr::Clear( int problem, const std::string& meid ) {
+	std::unique_lock<std::mutex> lk( gate );
+	akey_t	key;
+
+	key.problem = problem;
+	key.meid = meid;
+
+	auto it = alarms.find( key );
+	if( it == alarms.end() || it->second.want == Alarm::ACT_CLEAR ) {
+		nabsorbed++;
+		return false;
+	}
+
+	it->second.want = Alarm::ACT_CLEAR;
+	Queue( it->first, it->second );
+
+	return true;
+}
+
+/*
+	Clear all alarms. The collector is sent a single clear all message, and
+	anything pending is dropped; alarms raised after this are sent after
+	the clear all.
+*/
+void xapp::Alarm_mgr::Clear_all( ) {
+	std::unique_lock<std::mutex> lk( gate );
+
+	alarms.clear();
+	pending.clear();
+	clear_all = true;
+	clear_gen++;
+	wake.notify_one();
+}
+
+/*
+	Returns true if the alarm is raised (as the xAPP sees it; it may not
+	yet have been sent).
+*/
+bool xapp::Alarm_mgr::Is_raised( int problem, const std::string& meid ) {
+	std::unique_lock<std::mutex> lk( gate );
+	akey_t	key;
+
+	key.problem = problem;
+	key.meid = meid;
+
+	auto it = alarms.find( key );
+	return it != alarms.end() && it->second.want == Alarm::ACT_RAISE;
+}
+
+long xapp::Alarm_mgr::Get_pending( ) {
+	std::unique_lock<std::mutex> lk( gate );
+
+	return (long) pending.size() + (clear_all ? 1 : 0);
+}
+
+long xapp::Alarm_mgr::Get_sent( ) {
+	std::unique_lock<std::mutex> lk( gate );
+
+	return nsent;
+}
+
+long xapp::Alarm_mgr::Get_absorbed( ) {
+	std::unique_lock<std::mutex> lk( gate );
+
+	return nabsorbed;
+}
+
+long xapp::Alarm_mgr::Get_failed( ) {
+	std::unique_lock<std::mutex> lk( gate );
+
+	return nfailed;
+}
+
+/*
+	Send what is pending now, within the rate limit. Returns the number of
+	messages sent.
+*/
+int xapp::Alarm_mgr::Flush( ) {
+	return Flush( true );
+}
+
+/*
+	Start the flusher thread. Returns false if it is already running.
+*/
+bool xapp::Alarm_mgr::Start( int period_ms ) {
+	if( flusher != NULL ) {
+		return false;
+	}
+
+	if( period_ms <= 0 ) {
+		period_ms = DEF_PERIOD;
+	}
+
+	ok_2_run = true;
+	flusher = new std::thread( &Alarm_mgr::Flusher, this, period_ms );
+	return true;
+}
+
+/*
+	Stop the flusher and send everything that is pending without regard
+	to the rate so that the collector has the final state.
+*/
+void xapp::Alarm_mgr::Stop( ) {
+	if( flusher != NULL ) {
+		{
+			std::unique_lock<std::mutex> lk( gate );
+			ok_2_run = false;
+			wake.notify_one();
+		}
+
+		flusher->join();
+		delete flusher;
+		flusher = NULL;
+	}
+
+	Flush( false );
+}
+
+} // namespace
@@ -0,0 +1,164 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	alarm_mgr.hpp
+	Abstract:	Headers for the alarm manager. The manager keeps the state of
+				each alarm (problem id, managed element) that the xAPP raises
+				or clears and sends only changes in that state to the alarm
+				collector. Raising and clearing update the local state and
+				queue the alarm; messages are built and sent by a flusher
+				thread at no more than a configured rate. Repeated raises (or
+				clears) of the same alarm are absorbed, and an alarm which is
+				raised and cleared again between flushes is never sent.
+
+	Date:		18 October 2026
+*/
+
+#ifndef _XAPP_ALARM_MGR_HPP
+#define _XAPP_ALARM_MGR_HPP
+
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "message.hpp"
+#include "alarm.hpp"
+
+namespace xapp {
+
+/*
+	A user function which sends an alarm rather than the manager sending
+	through its Alarm. Action is one of the Alarm::ACT_ constants; for
+	clear-all the problem and meid are meaningless. Returns true if the
+	alarm was sent.
+*/
+typedef bool (*alarm_sender)( int action, int problem, const std::string& meid, int severity,
+	const std::string& info, const std::string& add_info, void* data );
+
+// ------------------------------------------------------------------------
+
+class Alarm_mgr {
+	private:
+		/*
+			Alarms are identified by problem and managed element.
+		*/
+		typedef struct akey {
+			int			problem;
+			std::string	meid;
+
+			bool operator==( const struct akey& k ) const { return problem == k.problem && meid == k.meid; }
+		} akey_t;
+
+		struct akey_hash {
+			size_t operator()( const akey_t& k ) const { return std::hash<std::string>()( k.meid ) ^ ((size_t) k.problem * 0x9e3779b97f4a7c15ULL); }
+		};
+
+		typedef struct {
+			int			want;				// ACT_RAISE or ACT_CLEAR; what the xAPP last asked for
+			int			sent;				// what the collector was last told
+			bool		queued;				// key is on the pending queue
+			int			severity;			// SEV_ constant; details the xAPP last raised with
+			std::string	info;
+			std::string	add_info;
+			int			sent_severity;		// details last sent in a raise
+			std::string	sent_info;
+			std::string	sent_add_info;
+		} astate_t;
+
+		/*
+			What is to be sent, copied from the state so that the send happens
+			without holding the lock.
+		*/
+		typedef struct {
+			int			action;
+			int			problem;
+			std::string meid;
+			int			severity;
+			std::string	info;
+			std::string	add_info;
+		} asend_t;
+
+		std::mutex	gate;							// protects the state and the queue
+		std::mutex	send_gate;						// serialises flushes so that sends stay in order
+		std::condition_variable	wake;
+		std::unordered_map<akey_t, astate_t, akey_hash> alarms;
+		std::deque<akey_t>	pending;				// alarms whose state may need to be sent, in order of change
+		bool		clear_all = false;				// a clear all is to be sent before anything pending
+		long		clear_gen = 0;					// bumped by each clear all
+
+		std::shared_ptr<Alarm> alarm;				// sends when there is no user sender
+		alarm_sender	sender = NULL;
+		void*		sender_data = NULL;
+
+		int			max_rate;						// messages/sec; also the burst allowed
+		double		tokens;
+		long long	last_fill = 0;					// ms; last time tokens were added
+
+		long		nsent = 0;						// stats (under gate)
+		long		nabsorbed = 0;
+		long		nfailed = 0;
+
+		std::atomic<bool> ok_2_run;
+		std::thread*	flusher = NULL;
+
+		// copy and assignment are PRIVATE; there is a thread and a lock
+		Alarm_mgr( const Alarm_mgr& soi );
+		Alarm_mgr& operator=( const Alarm_mgr& soi );
+
+		void Queue( const akey_t& key, astate_t& state );
+		bool Send( const asend_t& as );
+		void Flusher( int period_ms );
+		int Flush( bool limit );
+
+	public:
+		static const int DEF_RATE = 100;			// default max messages per second
+		static const int DEF_PERIOD = 100;			// default flush period (ms)
+
+		Alarm_mgr( std::shared_ptr<Alarm> alarm, int max_rate );
+		~Alarm_mgr( );
+
+		void Set_sender( alarm_sender fun, void* data );
+
+		bool Raise( int problem, const std::string& meid, int severity, const std::string& info );
+		bool Raise( int problem, const std::string& meid, int severity, const std::string& info, const std::string& add_info );
+		bool Clear( int problem, const std::string& meid );
+		void Clear_all( );
+
+		bool Is_raised( int problem, const std::string& meid );
+		long Get_pending( );
+		long Get_sent( );
+		long Get_absorbed( );
+		long Get_failed( );
+
+		int Flush( );								// send what is pending now (rate limited)
+		bool Start( int period_ms );				// start the flusher thread
+		void Stop( );								// stop the flusher; send everything pending
+};
+
+} // namespace
+
+#endif
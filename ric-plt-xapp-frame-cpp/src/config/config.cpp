@@ -34,6 +34,13 @@
 				we don't change the json as we're trying to read from it. Locking
 				should be transparent to the user xAPP.
 
+				Controls which are read often (e.g. for every message) should
+				be accessed through handles. The value for each handle is
+				resolved from the json once, when the handle is created and
+				whenever the file is reloaded, into an immutable snapshot; a
+				handle read is then an atomic load of the current snapshot
+				pointer and never locks.
+
     Date:       27 July 2020
     Author:     E. Scott Daniels
 */
@@ -58,6 +65,9 @@
 
 namespace xapp {
 
+// ---------------- C++ buggerd up way of maintining class constants ----------
+const int xapp::Config::SNAP_GRACE_SEC = 10;
+
 
 // ----- private things --------
 /*
@@ -119,13 +129,18 @@ void xapp::Config::Listener( ) {
 
 		ie = (inotify_event *) rbuf;
 		if( ie->len > 0 && strcmp( bname, ie->name ) == 0  ) {
-			// future: lock
-			auto njh = jparse( fname );							// reparse the file
-			// future: unlock
+			auto njh = jparse( fname );							// reparse the file (not under lock; could be slow)
 
-			if( njh != NULL && cb != NULL ) {				// good parse, save and drive user callback
-				jh = njh;
-				cb->Drive_cb( *this, user_cb_data );
+			if( njh != NULL ) {								// good parse, save and publish handle values
+				{
+					std::lock_guard<std::mutex> lk( gate );
+					jh = njh;
+					Publish( );
+				}
+
+				if( cb != NULL ) {							// handles are current before the user hears about it
+					cb->Drive_cb( *this, user_cb_data );
+				}
 			}
 		}
 	}
@@ -199,14 +214,31 @@ std::shared_ptr<xapp::Jhash> xapp::Config::jparse( ) {
 */
 xapp::Config::Config() :
 	jh( jparse() )
-{ /* empty body */ }
+{
+	snap = new config_snapshot_t();
+}
 
 /*
 	Similar, except that it allows the xAPP to supply the filename (testing?)
 */
 xapp::Config::Config( const std::string& fname) :
 	jh( jparse( fname ) )
-{ /* empty body */ }
+{
+	snap = new config_snapshot_t();
+}
+
+/*
+	Destroyer. Handles obtained from this config must not be used after this.
+*/
+xapp::Config::~Config() {
+	unsigned int i;
+
+	for( i = 0; i < old_snaps.size(); i++ ) {
+		delete old_snaps[i].snap;
+	}
+
+	delete snap.load();
+}
 
 
 /*
@@ -239,6 +271,7 @@ std::string xapp::Config::Get_port( const std::string& name ) const {
 	std::string rv = "";		// result value
 	std::string pname;			// element port name in the json
 
+	std::lock_guard<std::mutex> lk( gate );
 	if( jh == NULL ) {
 		return rv;
 	}
@@ -269,8 +302,11 @@ std::string xapp::Config::Get_port( const std::string& name ) const {
 /*
 	Suss out the named string from the controls object. If the resulting value is
 	missing or "", then the default is returned.
+
+	The Get_str(), Get_bool() and Get_value() functions expect the caller to hold
+	the lock; the public Get_control_*() functions take it.
 */
-std::string xapp::Config::Get_control_str( const std::string& name, const std::string& defval ) const {
+std::string xapp::Config::Get_str( const std::string& name, const std::string& defval ) const {
 	std::string value;
 	std::string rv;				// result value
 
@@ -291,6 +327,11 @@ std::string xapp::Config::Get_control_str( const std::string& name, const std::s
 	return rv;
 }
 
+std::string xapp::Config::Get_control_str( const std::string& name, const std::string& defval ) const {
+	std::lock_guard<std::mutex> lk( gate );
+	return Get_str( name, defval );
+}
+
 /*
 	Convenience funciton without default. "" returned if not found.
 	No default value; returns "" if not set.
@@ -303,7 +344,7 @@ std::string xapp::Config::Get_control_str( const std::string& name ) const {
 	Suss out the named field from the controls object with the assumption that it is a boolean.
 	If the resulting value is missing then the defval is used.
 */
-bool xapp::Config::Get_control_bool( const std::string& name, bool defval ) const {
+bool xapp::Config::Get_bool( const std::string& name, bool defval ) const {
 	bool rv;				// result value
 
 	rv = defval;
@@ -321,6 +362,11 @@ bool xapp::Config::Get_control_bool( const std::string& name, bool defval ) cons
 }
 
 
+bool xapp::Config::Get_control_bool( const std::string& name, bool defval ) const {
+	std::lock_guard<std::mutex> lk( gate );
+	return Get_bool( name, defval );
+}
+
 /*
 	Convenience function without default.
 */
@@ -333,7 +379,7 @@ bool xapp::Config::Get_control_bool( const std::string& name ) const {
 	Suss out the named field from the controls object with the assumption that it is a value (float/int).
 	If the resulting value is missing then the defval is used.
 */
-double xapp::Config::Get_control_value( const std::string& name, double defval ) const {
+double xapp::Config::Get_value( const std::string& name, double defval ) const {
 
 	auto rv = defval;				// return value; set to default
 	if( jh == NULL ) {
@@ -350,6 +396,11 @@ double xapp::Config::Get_control_value( const std::string& name, double defval )
 }
 
 
+double xapp::Config::Get_control_value( const std::string& name, double defval ) const {
+	std::lock_guard<std::mutex> lk( gate );
+	return Get_value( name, defval );
+}
+
 /*
 	Convenience function. If value is undefined, then 0 is returned.
 */
@@ -358,6 +409,124 @@ double xapp::Config::Get_control_value( const std::string& name ) const {
 }
 
 
+// ---- handles -----------------------------------------------------------------------------
+
+/*
+	Look up the value for a handle in the current json. Caller holds the lock.
+*/
+xapp::control_value_t xapp::Config::Resolve( const handle_spec_t& hs ) const {
+	control_value_t	cv;
+
+	cv = hs.defval;
+	switch( hs.type ) {
+		case HT_VALUE:
+			cv.value = Get_value( hs.name, hs.defval.value );
+			break;
+
+		case HT_BOOL:
+			cv.flag = Get_bool( hs.name, hs.defval.flag );
+			break;
+
+		case HT_STR:
+			cv.str = Get_str( hs.name, hs.defval.str );
+			break;
+
+		default:
+			break;
+	}
+
+	return cv;
+}
+
+/*
+	Build a new snapshot with the values for all handles from the current json
+	and make it the one that handles read. Caller holds the lock.
+
+	Readers load the pointer and index it without any other synchronisation,
+	so a replaced snapshot cannot be freed while a reader might still be using
+	it. A reader holds the pointer only for the load, the index and the copy
+	of one value, so rather than tracking readers, a replaced snapshot is kept
+	for a grace period (SNAP_GRACE_SEC) and freed by a later publish. Only the
+	snapshots replaced within the last grace period are ever retained.
+*/
+void xapp::Config::Publish( ) {
+	config_snapshot_t*	ns;
+	retired_snap_t	rs;
+	unsigned int i;
+
+	ns = new config_snapshot_t();
+	ns->reserve( hspecs.size() );
+	for( i = 0; i < hspecs.size(); i++ ) {
+		ns->push_back( Resolve( hspecs[i] ) );
+	}
+
+	rs.retired = std::chrono::steady_clock::now();
+	rs.snap = snap.exchange( ns, std::memory_order_acq_rel );
+
+	for( i = 0; i < old_snaps.size(); i++ ) {			// retired in order, so the expired ones are at the front
+		if( rs.retired - old_snaps[i].retired < std::chrono::seconds( SNAP_GRACE_SEC ) ) {
+			break;
+		}
+		delete old_snaps[i].snap;
+	}
+	old_snaps.erase( old_snaps.begin(), old_snaps.begin() + i );
+	old_snaps.push_back( rs );
+}
+
+/*
+	Register a handle and publish a snapshot which includes it; returns the
+	handle's index into the snapshot.
+*/
+int xapp::Config::Add_handle( const std::string& name, int type, const control_value_t& defval ) {
+	handle_spec_t	hs;
+
+	hs.name = name;
+	hs.type = type;
+	hs.defval = defval;
+
+	std::lock_guard<std::mutex> lk( gate );
+	hspecs.push_back( hs );
+	Publish( );
+
+	return (int) hspecs.size() - 1;
+}
+
+/*
+	Create a handle for a value (float/int) in the controls object. The
+	default is returned by the handle when the control is missing.
+*/
+xapp::Config::Handle<double> xapp::Config::Get_value_handle( const std::string& name, double defval ) {
+	control_value_t	dv;
+
+	dv.value = defval;
+	dv.flag = false;
+	return Handle<double>( &snap, Add_handle( name, HT_VALUE, dv ) );
+}
+
+/*
+	Create a handle for a boolean in the controls object.
+*/
+xapp::Config::Handle<bool> xapp::Config::Get_bool_handle( const std::string& name, bool defval ) {
+	control_value_t	dv;
+
+	dv.value = 0.0;
+	dv.flag = defval;
+	return Handle<bool>( &snap, Add_handle( name, HT_BOOL, dv ) );
+}
+
+/*
+	Create a handle for a string in the controls object. The default is
+	returned when the control is missing or empty.
+*/
+xapp::Config::Handle<std::string> xapp::Config::Get_str_handle( const std::string& name, const std::string& defval ) {
+	control_value_t	dv;
+
+	dv.value = 0.0;
+	dv.flag = false;
+	dv.str = defval;
+	return Handle<std::string>( &snap, Add_handle( name, HT_STR, dv ) );
+}
+
 // ---- notification support ---------------------------------------------------------------
 
 
@@ -366,10 +535,15 @@ double xapp::Config::Get_control_value( const std::string& name ) const {
 	something unknown), and stash that as a callback.
 
 	The fact that the user xAPP registers a callback also triggers the creation
-	of a thread to listen for changes on the config file.
+	of a thread to listen for changes on the config file. A nil function
+	still starts the listener so that handles follow the file.
 */
 void xapp::Config::Set_callback( notify_callback usr_func, void* usr_data ) {
-	cb = std::unique_ptr<Config_cb>( new Config_cb( usr_func, usr_data ) );
+	if( usr_func != NULL ) {
+		cb = std::unique_ptr<Config_cb>( new Config_cb( usr_func, usr_data ) );
+	} else {
+		cb = NULL;
+	}
 	user_cb_data = usr_data;
 
 	if( listener == NULL ) {				// start thread if needed
@@ -30,8 +30,13 @@
 #define XAPP_CONFIG_HPP
 
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "jhash.hpp"
 #include "config.hpp"
@@ -41,23 +46,102 @@ namespace xapp {
 
 #define MAX_PFNAME	(4096 + 256)		// max path name and max filname + nil for buffer allocation
 
-class Config {
-	std::string	fname = "";					// the file name that we'll listen to
-	std::thread* listener = NULL;			// listener thread info
+/*
+	A control value as resolved when a snapshot was built. Only the field
+	matching the handle type is meaningful.
+*/
+typedef struct {
+	double		value;
+	bool		flag;
+	std::string	str;
+} control_value_t;
+
+/*
+	Immutable set of resolved control values; one element for each handle
+	that has been created, indexed by the handle. A new snapshot is built and
+	published whenever a handle is added or the config file is reloaded.
+*/
+typedef std::vector<control_value_t> config_snapshot_t;
 
-	std::shared_ptr<Jhash>	jh = NULL;		// the currently parsed json from the config
-	std::unique_ptr<Config_cb> cb = NULL;	// info needed to drive user code when config change noticed
-	void*	user_cb_data = NULL;			// data that the caller wants passed on notification callback
+class Config {
+	public:
+		/*
+			A handle for a control which was looked up once, when the handle
+			was created. Reading it is a single atomic pointer load of the
+			current snapshot and an index; it does not touch the json and
+			may be used from any number of threads. A handle always returns
+			the value from the most recently loaded config (or its default).
+			It may not be used after the config has been destroyed.
+		*/
+		template <class T> class Handle {
+			private:
+				const std::atomic<const config_snapshot_t*>* snap;
+				int		idx;
+
+			public:
+				Handle( ) : snap( NULL ), idx( -1 ) { }
+				Handle( const std::atomic<const config_snapshot_t*>* snap, int idx ) : snap( snap ), idx( idx ) { }
+
+				T Get( ) const;
+		};
 
-	// -----------------------------------------------------------------------
 	private:
+		/*
+			What we need to resolve a handle when building a snapshot.
+		*/
+		typedef struct {
+			std::string	name;
+			int			type;				// HT_ constant
+			control_value_t defval;
+		} handle_spec_t;
+
+		static const int HT_VALUE = 0;
+		static const int HT_BOOL = 1;
+		static const int HT_STR = 2;
+
+		/*
+			A snapshot which has been replaced, and when. It is freed once it
+			has been out of use for the grace period.
+		*/
+		typedef struct {
+			const config_snapshot_t* snap;
+			std::chrono::steady_clock::time_point retired;
+		} retired_snap_t;
+
+		static const int SNAP_GRACE_SEC;		// far longer than any handle read holds a snapshot
+
+		std::string	fname = "";					// the file name that we'll listen to
+		std::thread* listener = NULL;			// listener thread info
+
+		std::shared_ptr<Jhash>	jh = NULL;		// the currently parsed json from the config
+		std::unique_ptr<Config_cb> cb = NULL;	// info needed to drive user code when config change noticed
+		void*	user_cb_data = NULL;			// data that the caller wants passed on notification callback
+
+		mutable std::mutex gate;				// serialises use of jh (Jhash is not thread safe) and handle setup
+		std::vector<handle_spec_t> hspecs;		// handles created, index matches snapshot index
+		std::atomic<const config_snapshot_t*> snap;	// current snapshot; readers never lock
+		std::vector<retired_snap_t> old_snaps;	// replaced; readers may still be looking
+
 		std::shared_ptr<xapp::Jhash>  jparse( std::string fname );
 		std::shared_ptr<xapp::Jhash>  jparse( );
 		void Listener( );
 
+		void Publish( );
+		control_value_t Resolve( const handle_spec_t& hs ) const;
+		int Add_handle( const std::string& name, int type, const control_value_t& defval );
+
+		std::string Get_str( const std::string& name, const std::string& defval ) const;
+		bool Get_bool( const std::string& name, bool defval ) const;
+		double Get_value( const std::string& name, double defval ) const;
+
 	public:
 		Config();						// builders
 		Config( const std::string& fname);
+		~Config();
+
+		Handle<double> Get_value_handle( const std::string& name, double defval );	// pre-resolved control access
+		Handle<bool> Get_bool_handle( const std::string& name, bool defval );
+		Handle<std::string> Get_str_handle( const std::string& name, const std::string& defval );
 
 		bool Get_control_bool( const std::string& name, bool defval ) const;
 		bool Get_control_bool( const std::string& name ) const;
@@ -75,6 +159,18 @@ class Config {
 		void Set_callback( notify_callback usr_func, void* usr_data );
 };
 
+template<> inline double Config::Handle<double>::Get( ) const {
+	return snap == NULL ? 0.0 : (*(*snap).load( std::memory_order_acquire ))[idx].value;
+}
+
+template<> inline bool Config::Handle<bool>::Get( ) const {
+	return snap == NULL ? false : (*(*snap).load( std::memory_order_acquire ))[idx].flag;
+}
+
+template<> inline std::string Config::Handle<std::string>::Get( ) const {
+	return snap == NULL ? "" : (*(*snap).load( std::memory_order_acquire ))[idx].str;
+}
+
 
 } // namespace
 
@@ -24,14 +24,24 @@
 				a hashtable, and exposes various functions that can be used
 				to read the data from the hash.
 
+				Originally the json was parsed by jsmn and each object loaded
+				into an RMR symbol table (jwrapper.c). That allocated and copied
+				for every object and member on every parse, and the cost of
+				parsing each message was far larger than the cost of the
+				few lookups made on the result. The parsing is now done by a
+				Jindex which makes one pass over the json and builds a flat
+				node array; names are resolved only when looked up.
+
 	Date:		26 June 2020
 	Author:		E. Scott Daniels
 */
 
 
+#include <stdio.h>
+
 #include <string>
 
-#include "jwrapper.h"
+#include "jindex.hpp"
 #include "jhash.hpp"
 
 
@@ -40,7 +50,17 @@ namespace xapp {
 
 // ------------------------------------------------------------------------
 
+/*
+	Find the named array in the current blob and return the node for the
+	element at eidx, or -1.
+*/
+int xapp::Jhash::Element( const char* name, int eidx ) {
+	if( ji == NULL || blob < 0 ) {
+		return -1;
+	}
 
+	return ji->Element( ji->Find( blob, name ), eidx );
+}
 
 // ----------- construction/destruction housekeeping things -------------------
 /*
@@ -49,19 +69,21 @@ namespace xapp {
 	suss out the values.
 */
 xapp::Jhash::Jhash( const char* jbuf ) :
-	st( jw_new( jbuf ) )
-{ /* empty body */ }
+	ji( new Jindex() )
+{
+	Parse( jbuf );
+}
 
 
 /*
 	Move constructor.
 */
 Jhash::Jhash( Jhash&& soi ) :
-	master_st( soi.master_st ),
-	st( soi.st )
+	ji( soi.ji ),
+	blob( soi.blob )
 {
-	soi.st = NULL;						// prevent closing of RMR stuff on soi destroy
-	soi.master_st = NULL;
+	soi.ji = NULL;						// prevent free of the index on soi destroy
+	soi.blob = -1;
 }
 
 /*
@@ -69,11 +91,13 @@ Jhash::Jhash( Jhash&& soi ) :
 */
 Jhash& Jhash::operator=( Jhash&& soi ) {
 	if( this != &soi ) {						// cannot do self assignment
-		master_st = soi.master_st;
-		st = soi.st;
+		delete ji;
+
+		ji = soi.ji;
+		blob = soi.blob;
 
-		soi.st = NULL;						// prevent closing of RMR stuff on soi destroy
-		soi.master_st = NULL;
+		soi.ji = NULL;						// prevent free of the index on soi destroy
+		soi.blob = -1;
 	}
 
 	return *this;
@@ -83,20 +107,30 @@ Jhash& Jhash::operator=( Jhash&& soi ) {
 	Blow it away.
 */
 xapp::Jhash::~Jhash() {
-	if( master_st != NULL ) {		// revert blob set if needed
-		st = master_st;
-	}
-
-	jw_nuke( st );
-	st = NULL;
-	master_st = NULL;
+	delete ji;
+	ji = NULL;
 }
 
 
 // ------------ public API ---------------------------------------------------
 
-// IMPORTANT: all underlying jwrapper functions check for nil st and name pointers
-//				so that is NOT needed in this code.
+// IMPORTANT: all underlying Jindex functions check for bad node indexes and
+//				nil name pointers so that is NOT needed in this code.
+
+/*
+	Parse new json, discarding what was parsed before. The storage used for
+	the previous json is reused, so an xAPP that parses every message it
+	receives can keep one Jhash rather than creating a new one for each.
+	Returns true if the json parsed. Any blob selection is cleared.
+*/
+bool xapp::Jhash::Parse( const char* jblob ) {
+	if( ji == NULL ) {						// moved away; start over
+		ji = new Jindex();
+	}
+
+	blob = ji->Parse( jblob ) ? 0 : -1;		// the root object is always node 0
+	return blob == 0;
+}
 
 
 // --- root control ----------------------------------------------------------
@@ -110,14 +144,15 @@ xapp::Jhash::~Jhash() {
 	return to the top level.
 */
 bool xapp::Jhash::Set_blob( const char* name ) {
-	void*	bst;						// blob symbol table
+	int		n;
 
-	if( master_st == NULL ) {			// must capture master
-		master_st = st;
+	if( ji == NULL || blob < 0 ) {
+		return false;
 	}
 
-	if( (bst = jw_blob( st, name )) != NULL ) {
-		st = bst;
+	n = ji->Find( blob, name );
+	if( ji->Type( n ) == Jindex::JT_OBJECT ) {
+		blob = n;
 		return true;
 	}
 
@@ -128,8 +163,8 @@ bool xapp::Jhash::Set_blob( const char* name ) {
 	Return the suss root (blob root) to the root of the symtab.
 */
 void xapp::Jhash::Unset_blob( ) {
-	if( master_st != NULL ) {
-		st = master_st;
+	if( blob > 0 ) {
+		blob = 0;
 	}
 }
 
@@ -137,19 +172,46 @@ void xapp::Jhash::Unset_blob( ) {
 /*
 	Returns true if there were parse errors which resulted in an empty
 	or non-existant hash.
-
-	Right now we don't have much to work with other than checking for a
-	nil table.
 */
 const bool xapp::Jhash::Parse_errors( ) {
-	return st == NULL;
+	return ji == NULL || blob < 0;
 }
 
 /*
 	Dump the selected blob as much as we can.
 */
 void xapp::Jhash::Dump() {
-	jw_dump( st );
+	const char*	s;
+	const char*	sv;
+	int		n;
+	int		len;
+	int		slen;
+
+	if( ji == NULL || blob < 0 ) {
+		return;
+	}
+
+	for( n = ji->First( blob ); n >= 0; n = ji->Next( n ) ) {
+		s = ji->Key( n, &len );
+		switch( ji->Type( n ) ) {
+			case Jindex::JT_OBJECT:
+				fprintf( stderr, "<DUMP> %.*s is object\n", len, s );
+				break;
+
+			case Jindex::JT_ARRAY:
+				fprintf( stderr, "<DUMP> %.*s is array of %d elements\n", len, s, ji->Nchildren( n ) );
+				break;
+
+			case Jindex::JT_STRING:
+				sv = ji->String( n, &slen );
+				fprintf( stderr, "<DUMP> %.*s is string (%.*s)\n", len, s, slen, sv );
+				break;
+
+			default:
+				fprintf( stderr, "<DUMP> %.*s is primative (%.3f)\n", len, s, ji->Value( n ) );
+				break;
+		}
+	}
 }
 
 // ---------------- type testing -----------------------------------------
@@ -159,19 +221,19 @@ void xapp::Jhash::Dump() {
 	is the indicated type
 */
 bool xapp::Jhash::Is_value( const char* name ) {
-	return jw_is_value( st, name ) == 1;
+	return ji != NULL && ji->Type( ji->Find( blob, name ) ) == Jindex::JT_VALUE;
 }
 
 bool xapp::Jhash::Is_bool( const char* name ) {
-	return jw_is_bool( st, name ) == 1;
+	return ji != NULL && ji->Type( ji->Find( blob, name ) ) == Jindex::JT_BOOL;
 }
 
 bool xapp::Jhash::Is_null( const char* name ) {
-	return jw_is_null( st, name ) == 1;
+	return ji != NULL && ji->Type( ji->Find( blob, name ) ) == Jindex::JT_NULL;
 }
 
 bool xapp::Jhash::Is_string( const char* name ) {
-	return jw_is_string( st, name ) == 1;
+	return ji != NULL && ji->Type( ji->Find( blob, name ) ) == Jindex::JT_STRING;
 }
 
 /*
@@ -179,19 +241,19 @@ bool xapp::Jhash::Is_string( const char* name ) {
 	<name> is the indicated type.
 */
 bool xapp::Jhash::Is_string_ele( const char* name, int eidx ) {
-	return jw_is_string_ele( st, name, eidx ) == 1;
+	return ji != NULL && ji->Type( Element( name, eidx ) ) == Jindex::JT_STRING;
 }
 
 bool xapp::Jhash::Is_value_ele( const char* name, int eidx ) {
-	return jw_is_value_ele( st, name, eidx ) == 1;
+	return ji != NULL && ji->Type( Element( name, eidx ) ) == Jindex::JT_VALUE;
 }
 
 bool xapp::Jhash::Is_bool_ele( const char* name, int eidx ) {
-	return jw_is_bool_ele( st, name, eidx ) == 1;
+	return ji != NULL && ji->Type( Element( name, eidx ) ) == Jindex::JT_BOOL;
 }
 
 bool xapp::Jhash::Is_null_ele( const char* name, int eidx ) {
-	return jw_is_null_ele( st, name, eidx ) == 1;
+	return ji != NULL && ji->Type( Element( name, eidx ) ) == Jindex::JT_NULL;
 }
 
 
@@ -200,14 +262,14 @@ bool xapp::Jhash::Is_null_ele( const char* name, int eidx ) {
 	Returns true if the named element is in the hash.
 */
 bool xapp::Jhash::Exists( const char* name ) {
-	return jw_exists( st, name ) == 1;
+	return ji != NULL && ji->Find( blob, name ) >= 0;
 }
 
 /*
 	Returns true if the named element is not in the hash.
 */
 bool xapp::Jhash::Is_missing( const char* name ) {
-	return jw_missing( st, name ) == 1;
+	return ji != NULL && name != NULL && ! Parse_errors() && ji->Find( blob, name ) < 0;
 }
 
 // ---------------- value sussing ----------------------------------------
@@ -215,12 +277,12 @@ bool xapp::Jhash::Is_missing( const char* name ) {
 /*
 	Returns the boolean value for the object if it is a bool; false otherwise.
 
-	Symtab saves bool values as 1 for true and doesn't provide a bool fetch
-	function. So, fetch the value and return true if it is 1.
+	Bool values are kept as 1 for true, so fetch the value and return true
+	if it is 1.
 */
 bool xapp::Jhash::Bool( const char* name ) {
 	int v;
-	v = (int) jw_value( st, name );
+	v = (int) Value( name );
 
 	return v == 1;
 }
@@ -230,14 +292,14 @@ bool xapp::Jhash::Bool( const char* name ) {
 	in the hash an empty string is returned.
 */
 std::string xapp::Jhash::String( const char* name ) {
-	std::string rv = "";
-	const char*	hashv;
+	const char*	s;
+	int		len;
 
-	if( (hashv = jw_string( st, name )) != NULL ) {
-		rv = std::string( hashv );
+	if( ji != NULL && (s = ji->String( ji->Find( blob, name ), &len )) != NULL ) {
+		return std::string( s, len );
 	}
 
-	return rv;
+	return std::string( "" );
 }
 
 
@@ -246,7 +308,11 @@ std::string xapp::Jhash::String( const char* name ) {
 	in the hash 0 is returned.
 */
 double xapp::Jhash::Value( const char* name ) {
-	return jw_value( st, name );
+	if( ji == NULL ) {
+		return 0.0;
+	}
+
+	return ji->Value( ji->Find( blob, name ) );
 }
 
 // ------ array related things --------------------------------------------
@@ -255,7 +321,13 @@ double xapp::Jhash::Value( const char* name ) {
 	Return the length of the named array, or -1 if it doesn't exist.
 */
 int xapp::Jhash::Array_len( const char* name ) {
-	return jw_array_len( st, name );
+	int		n;
+
+	if( ji == NULL || ji->Type( n = ji->Find( blob, name ) ) != Jindex::JT_ARRAY ) {
+		return -1;
+	}
+
+	return ji->Nchildren( n );
 }
 
 
@@ -263,14 +335,15 @@ int xapp::Jhash::Array_len( const char* name ) {
 	Sets the blob in the array <name>[eidx] to the current reference blob.
 */
 bool xapp::Jhash::Set_blob_ele( const char* name, int eidx ) {
-	void*	bst;
+	int		n;
 
-	if( (bst = jw_obj_ele( st, name, eidx )) != NULL ) {
-		if( master_st == NULL ) {			// must capture master
-			master_st = st;
-		}
+	if( ji == NULL ) {
+		return false;
+	}
 
-		st = bst;
+	n = Element( name, eidx );
+	if( ji->Type( n ) == Jindex::JT_OBJECT ) {
+		blob = n;
 		return true;
 	}
 
@@ -280,28 +353,39 @@ bool xapp::Jhash::Set_blob_ele( const char* name, int eidx ) {
 	Return the string at index eidx in the array <name>.
 */
 std::string xapp::Jhash::String_ele( const char* name, int eidx ) {
-	std::string rv = "";
-	const char*	hashv;
+	const char*	s;
+	int		len;
 
-	if( (hashv = jw_string_ele( st, name, eidx )) != NULL ) {
-		rv = std::string( hashv );
+	if( ji != NULL && (s = ji->String( Element( name, eidx ), &len )) != NULL ) {
+		return std::string( s, len );
 	}
 
-	return rv;
+	return std::string( "" );
 }
 
 /*
-	Return the value at index eidx in the array <name>.
+	Return the value at index eidx in the array <name>; 0 if the element
+	is not a value.
 */
 double xapp::Jhash::Value_ele( const char* name, int eidx ) {
-	return jw_value_ele( st, name, eidx );
+	int		n;
+
+	if( ji == NULL || ji->Type( n = Element( name, eidx ) ) != Jindex::JT_VALUE ) {
+		return 0.0;
+	}
+
+	return ji->Value( n );
 }
 
 /*
 	Return the bool value at index eidx in the array <name>.
 */
 bool xapp::Jhash::Bool_ele( const char* name, int eidx ) {
-	return jw_bool_ele( st, name, eidx ) == 1;
+	if( ji == NULL ) {
+		return false;
+	}
+
+	return ((int) ji->Value( Element( name, eidx ) )) != 0;
 }
 
 
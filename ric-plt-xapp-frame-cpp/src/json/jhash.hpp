@@ -22,7 +22,9 @@
 	Mnemonic:	jhash.hpp
 	Abstract:	This class provides the ability to parse a json string into
 				a hashtable, and exposes various functions that can be used
-				to read the data from the hash.
+				to read the data from the hash. The parsing and lookup are
+				done by a Jindex (jindex.hpp); a Jhash may be reused for
+				new json with Parse() which reuses the storage of the index.
 
 	Date:		26 June 2020
 	Author:		E. Scott Daniels
@@ -36,16 +38,20 @@
 
 namespace xapp {
 
+class Jindex;
+
 // ------------------------------------------------------------------------
 
 class Jhash {
 	private:
-		void*	st = NULL;							// the resulting symbol table generated by parse
-		void*	master_st = NULL;					// if user switches to a sub-blob; this tracks the original root st
+		Jindex*	ji = NULL;							// the parsed json
+		int		blob = -1;							// index node of the current blob; -1 if parse failed
 
-		Jhash& operator=( const Jhash& soi );	// jhashes cannot be copied because of underlying symbol table goo
+		Jhash& operator=( const Jhash& soi );	// jhashes cannot be copied; the index is not shared
 		Jhash( const Jhash& soi );
 
+		int Element( const char* name, int eidx );
+
 	public:
 
 		Jhash( const char* jblob );					// builder
@@ -53,6 +59,8 @@ class Jhash {
 		Jhash& operator=( Jhash&& soi );			// move operator
 		~Jhash();									// destruction
 
+		bool Parse( const char* jblob );					// reuse for new json
+
 		bool Set_blob( const char* name );					// blob/root selection
 		void Unset_blob( );
 		bool Set_blob_ele( const char* name, int eidx );	// set from an array element
@@ -0,0 +1,478 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	jindex.cpp
+	Abstract:	Json parser and lazy index used by Jhash (see jindex.hpp).
+
+				The parser accepts what the jsmn based parser (jwrapper.c)
+				accepted, so existing xAPP json keeps working: commas are
+				optional, unquoted primitives are taken as they are and typed
+				by their first character (t/f are booleans, n is null, anything
+				else is converted as a number), and escapes in strings are left
+				as they are. Nested arrays, which jwrapper rejected, are indexed
+				but cannot be reached through the Jhash API. When a name
+				appears more than once in an object, the last one is used.
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "jindex.hpp"
+
+namespace xapp {
+
+// ---------------- C++ buggerd up way of maintining class constants ----------
+const int xapp::Jindex::HASH_MIN = 8;
+const int xapp::Jindex::ELE_MIN = 8;
+
+
+// ------ private ----------------------------------------------
+
+/*
+	FNV-1a over the bytes of a name.
+*/
+static inline unsigned int name_hash( const char* name, int len ) {
+	unsigned int h = 2166136261u;
+	int		i;
+
+	for( i = 0; i < len; i++ ) {
+		h ^= (unsigned char) name[i];
+		h *= 16777619u;
+	}
+
+	return h;
+}
+
+static inline bool is_ws( char c ) {
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',';		// commas are optional; treat as space
+}
+
+/*
+	Add a node and return its index. Node index is used rather than a pointer
+	as the vector may move.
+*/
+int xapp::Jindex::Add_node( int type, int off, int len, int key_off, int key_len ) {
+	jnode_t n;
+
+	n.type = type;
+	n.key_off = key_off;
+	n.key_len = key_len;
+	n.off = off;
+	n.len = len;
+	n.child = -1;
+	n.nchild = 0;
+	n.next = -1;
+	n.tab = -1;
+	n.have_fv = 0;
+	n.fv = 0.0;
+
+	nodes.push_back( n );
+	return (int) nodes.size() - 1;
+}
+
+/*
+	Pos is at the opening quote. Returns the position just past the closing
+	quote and sets len to the length of the contents, or -1 if the string
+	is not terminated.
+*/
+int xapp::Jindex::Scan_string( int pos, int* len ) {
+	const char*	s;
+	const char*	e;
+
+	s = json.c_str() + pos + 1;
+	for( e = s; *e != '"'; e++ ) {
+		if( *e == 0 ) {
+			return -1;
+		}
+		if( *e == '\\' && *(e+1) != 0 ) {
+			e++;
+		}
+	}
+
+	*len = (int) (e - s);
+	return (int) (e - json.c_str()) + 1;
+}
+
+/*
+	Pos is at the first character of an unquoted primitive. Returns the
+	position just past it, setting the length and type.
+*/
+int xapp::Jindex::Scan_prim( int pos, int* len, int* type ) {
+	const char*	s;
+	const char*	e;
+
+	s = json.c_str() + pos;
+	for( e = s; *e != 0 && ! is_ws( *e ) && *e != ']' && *e != '}' && *e != ':'; e++ );
+
+	switch( *s ) {
+		case 't':
+		case 'T':
+		case 'f':
+		case 'F':
+			*type = JT_BOOL;
+			break;
+
+		case 'n':
+		case 'N':
+			*type = JT_NULL;
+			break;
+
+		default:
+			*type = JT_VALUE;
+			break;
+	}
+
+	*len = (int) (e - s);
+	return (int) (e - json.c_str());
+}
+
+/*
+	Build the open addressed name hash for an object. Members are added in
+	order and replace an earlier member with the same name.
+*/
+void xapp::Jindex::Build_hash( int obj ) {
+	unsigned int size;
+	unsigned int h;
+	int		base;
+	int		c;
+	int		e;
+	const char*	js;
+
+	for( size = 16; size < (unsigned int) nodes[obj].nchild * 2; size <<= 1 );
+
+	base = (int) tabs.size();
+	tabs.push_back( (int) size - 1 );						// first slot is the mask
+	tabs.resize( base + 1 + size, -1 );
+
+	js = json.c_str();
+	for( c = nodes[obj].child; c >= 0; c = nodes[c].next ) {
+		h = name_hash( js + nodes[c].key_off, nodes[c].key_len ) & (size - 1);
+		while( (e = tabs[base + 1 + h]) >= 0 ) {
+			if( nodes[e].key_len == nodes[c].key_len && memcmp( js + nodes[e].key_off, js + nodes[c].key_off, nodes[c].key_len ) == 0 ) {
+				break;										// replace the earlier one
+			}
+			h = (h + 1) & (size - 1);
+		}
+		tabs[base + 1 + h] = c;
+	}
+
+	nodes[obj].tab = base;
+}
+
+/*
+	Build the table of element node indexes for an array.
+*/
+void xapp::Jindex::Build_elements( int arr ) {
+	int		c;
+
+	nodes[arr].tab = (int) tabs.size();
+	for( c = nodes[arr].child; c >= 0; c = nodes[c].next ) {
+		tabs.push_back( c );
+	}
+}
+
+// --------------- builders  -------------------------------------
+
+xapp::Jindex::Jindex( ) { /* empty body */ }
+
+// ------------ public API ---------------------------------------------------
+
+/*
+	Parse the json. The root must be an object; it is node 0. Returns false
+	if the json is not well formed (nothing can be found after a failure).
+	Storage from the previous parse is reused.
+*/
+bool xapp::Jindex::Parse( const char* jblob ) {
+	const char*	js;
+	int		pos = 0;
+	int		top;				// open container
+	int		n;
+	int		len;
+	int		type;
+	int		key_off;
+	int		key_len;
+	int		last;
+
+	nodes.clear();
+	tabs.clear();
+	stack.clear();
+
+	if( jblob == NULL ) {
+		return false;
+	}
+	json.assign( jblob );
+	js = json.c_str();
+
+	while( is_ws( js[pos] ) ) {
+		pos++;
+	}
+	if( js[pos] != '{' ) {
+		fprintf( stderr, "[WARN] jhash: badly formed json; initial opening bracket ({) not detected\n" );
+		return false;
+	}
+
+	stack.push_back( Add_node( JT_OBJECT, pos, 0, 0, 0 ) );
+	stack.push_back( -1 );							// stack holds pairs: container, last child
+	pos++;
+
+	while( ! stack.empty() ) {
+		top = stack[stack.size() - 2];
+		while( is_ws( js[pos] ) ) {
+			pos++;
+		}
+
+		if( js[pos] == '}' || js[pos] == ']' ) {		// close the container
+			if( (js[pos] == '}') != (nodes[top].type == JT_OBJECT) ) {
+				break;
+			}
+			nodes[top].len = pos - nodes[top].off + 1;
+			stack.resize( stack.size() - 2 );
+			pos++;
+			continue;
+		}
+
+		key_off = 0;
+		key_len = 0;
+		if( nodes[top].type == JT_OBJECT ) {				// object members must be named
+			if( js[pos] != '"' || (pos = Scan_string( pos, &key_len )) < 0 ) {
+				break;
+			}
+			key_off = pos - key_len - 1;
+
+			while( js[pos] == ' ' || js[pos] == '\t' || js[pos] == '\n' || js[pos] == '\r' ) {
+				pos++;
+			}
+			if( js[pos] != ':' ) {
+				break;
+			}
+			pos++;
+			while( is_ws( js[pos] ) ) {
+				pos++;
+			}
+		}
+
+		switch( js[pos] ) {
+			case '{':
+				n = Add_node( JT_OBJECT, pos, 0, key_off, key_len );
+				pos++;
+				break;
+
+			case '[':
+				n = Add_node( JT_ARRAY, pos, 0, key_off, key_len );
+				pos++;
+				break;
+
+			case '"':
+				if( (pos = Scan_string( pos, &len )) < 0 ) {
+					n = -1;
+					break;
+				}
+				n = Add_node( JT_STRING, pos - len - 1, len, key_off, key_len );
+				break;
+
+			case 0:
+			case '}':
+			case ']':
+			case ':':
+				n = -1;									// missing value
+				break;
+
+			default:
+				len = 0;
+				n = Add_node( JT_VALUE, pos, 0, key_off, key_len );
+				pos = Scan_prim( pos, &len, &type );
+				nodes[n].len = len;
+				nodes[n].type = type;
+				break;
+		}
+
+		if( n < 0 ) {
+			break;
+		}
+
+		last = stack[stack.size() - 1];					// link to the parent
+		if( last < 0 ) {
+			nodes[top].child = n;
+		} else {
+			nodes[last].next = n;
+		}
+		stack[stack.size() - 1] = n;
+		nodes[top].nchild++;
+
+		if( nodes[n].type == JT_OBJECT || nodes[n].type == JT_ARRAY ) {
+			stack.push_back( n );
+			stack.push_back( -1 );
+		}
+	}
+
+	if( ! stack.empty() ) {
+		fprintf( stderr, "[WARN] jhash: badly formed json near offset %d\n", pos );
+		nodes.clear();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Return the node of the named member of the object, or -1 if obj is not
+	an object or has no such member.
+*/
+int xapp::Jindex::Find( int obj, const char* name ) {
+	const char*	js;
+	unsigned int mask;
+	unsigned int h;
+	int		len;
+	int		base;
+	int		c;
+	int		found = -1;
+
+	if( obj < 0 || obj >= (int) nodes.size() || nodes[obj].type != JT_OBJECT || name == NULL ) {
+		return -1;
+	}
+
+	js = json.c_str();
+	len = strlen( name );
+
+	if( nodes[obj].nchild <= HASH_MIN ) {						// small: a scan is faster than hashing
+		for( c = nodes[obj].child; c >= 0; c = nodes[c].next ) {
+			if( nodes[c].key_len == len && memcmp( js + nodes[c].key_off, name, len ) == 0 ) {
+				found = c;										// keep going; last one wins
+			}
+		}
+
+		return found;
+	}
+
+	if( nodes[obj].tab < 0 ) {
+		Build_hash( obj );
+	}
+
+	base = nodes[obj].tab;
+	mask = (unsigned int) tabs[base];
+	h = name_hash( name, len ) & mask;
+	while( (c = tabs[base + 1 + h]) >= 0 ) {
+		if( nodes[c].key_len == len && memcmp( js + nodes[c].key_off, name, len ) == 0 ) {
+			return c;
+		}
+		h = (h + 1) & mask;
+	}
+
+	return -1;
+}
+
+/*
+	Return the node for element idx of the array, or -1 if not an array or
+	idx is out of range.
+*/
+int xapp::Jindex::Element( int arr, int idx ) {
+	int		c;
+
+	if( arr < 0 || arr >= (int) nodes.size() || nodes[arr].type != JT_ARRAY || idx < 0 || idx >= nodes[arr].nchild ) {
+		return -1;
+	}
+
+	if( nodes[arr].nchild <= ELE_MIN ) {
+		for( c = nodes[arr].child; idx > 0; idx-- ) {
+			c = nodes[c].next;
+		}
+		return c;
+	}
+
+	if( nodes[arr].tab < 0 ) {
+		Build_elements( arr );
+	}
+
+	return tabs[nodes[arr].tab + idx];
+}
+
+/*
+	Return a pointer to the member name of the node, setting len. The name
+	is NOT nil terminated.
+*/
+const char* xapp::Jindex::Key( int n, int* len ) const {
+	if( n < 0 || n >= (int) nodes.size() ) {
+		*len = 0;
+		return NULL;
+	}
+
+	*len = nodes[n].key_len;
+	return json.c_str() + nodes[n].key_off;
+}
+
+/*
+	Return a pointer to the contents of a string node (no quotes), setting
+	len; nil if the node is not a string. NOT nil terminated.
+*/
+const char* xapp::Jindex::String( int n, int* len ) const {
+	if( n < 0 || n >= (int) nodes.size() || nodes[n].type != JT_STRING ) {
+		*len = 0;
+		return NULL;
+	}
+
+	*len = nodes[n].len;
+	return json.c_str() + nodes[n].off;
+}
+
+/*
+	Return the numeric value of a primitive: the number for a value, 1 or 0
+	for a boolean, and 0 for null or anything which is not a primitive. The
+	conversion is done on the first request and kept.
+*/
+double xapp::Jindex::Value( int n ) {
+	char	wbuf[64];
+	int		len;
+
+	if( n < 0 || n >= (int) nodes.size() ) {
+		return 0.0;
+	}
+
+	if( ! nodes[n].have_fv ) {
+		switch( nodes[n].type ) {
+			case JT_VALUE:
+				len = nodes[n].len < (int) sizeof( wbuf ) - 1 ? nodes[n].len : (int) sizeof( wbuf ) - 1;
+				memcpy( wbuf, json.c_str() + nodes[n].off, len );		// text is not terminated in the json
+				wbuf[len] = 0;
+				nodes[n].fv = strtod( wbuf, NULL );
+				break;
+
+			case JT_BOOL:
+				nodes[n].fv = (json[nodes[n].off] == 't' || json[nodes[n].off] == 'T') ? 1.0 : 0.0;
+				break;
+
+			default:
+				nodes[n].fv = 0.0;
+				break;
+		}
+
+		nodes[n].have_fv = 1;
+	}
+
+	return nodes[n].fv;
+}
+
+} // namespace
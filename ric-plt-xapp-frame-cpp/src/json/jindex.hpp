@@ -0,0 +1,107 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	jindex.hpp
+	Abstract:	The parser behind Jhash. A single pass over the json builds a
+				flat array of nodes; each node refers to its key and value by
+				offset into the (one) copy of the json that the index keeps, so
+				no string is copied or allocated while parsing. Objects and
+				arrays link their children as a sibling chain; a hash of the
+				member names (or a table of the elements of an array) is built
+				only when the object or array is first searched and is large
+				enough to need one. The node array, the copy of the json and
+				the lookup tables are kept across parses so that an index which
+				is reused does not allocate once it has grown to fit.
+
+	Date:		18 October 2026
+*/
+
+#ifndef _JINDEX_HPP
+#define _JINDEX_HPP
+
+
+#include <string>
+#include <vector>
+
+namespace xapp {
+
+// ------------------------------------------------------------------------
+
+/*
+	One json thing. Offsets are into the index's copy of the json.
+*/
+typedef struct {
+	int		type;			// JT_ constant
+	int		key_off;		// member name (object members only)
+	int		key_len;
+	int		off;			// string contents (without quotes) or primitive text
+	int		len;
+	int		child;			// first child of an object or array; -1 if none
+	int		nchild;
+	int		next;			// next sibling; -1 if last
+	int		tab;			// object/array: offset of the lookup table in tabs; -1 until built
+	int		have_fv;		// value: fv has been converted
+	double	fv;
+} jnode_t;
+
+class Jindex {
+	private:
+		std::string	json;					// our copy of the input; nodes point into it
+		std::vector<jnode_t> nodes;
+		std::vector<int> tabs;				// lazily built name hashes and element tables
+		std::vector<int> stack;				// open containers while parsing
+
+		static const int HASH_MIN;			// objects with more members than this are hashed on first search
+		static const int ELE_MIN;			// arrays with more elements than this get an element table
+
+		int Add_node( int type, int off, int len, int key_off, int key_len );
+		int Scan_string( int pos, int* len );
+		int Scan_prim( int pos, int* len, int* type );
+		void Build_hash( int obj );
+		void Build_elements( int arr );
+
+	public:
+		static const int JT_OBJECT = 1;		// node types
+		static const int JT_ARRAY = 2;
+		static const int JT_STRING = 3;
+		static const int JT_VALUE = 4;
+		static const int JT_BOOL = 5;
+		static const int JT_NULL = 6;
+
+		Jindex( );
+
+		bool Parse( const char* jblob );	// parse; the previous parse is discarded
+
+		int Find( int obj, const char* name );		// node for the member of obj; -1 if not there
+		int Element( int arr, int idx );			// node for arr[idx]; -1 if not there
+
+		inline int Type( int n ) const { return n < 0 ? 0 : nodes[n].type; }
+		inline int Nchildren( int n ) const { return n < 0 ? -1 : nodes[n].nchild; }
+		inline int First( int n ) const { return n < 0 ? -1 : nodes[n].child; }
+		inline int Next( int n ) const { return n < 0 ? -1 : nodes[n].next; }
+
+		const char* Key( int n, int* len ) const;			// zero copy views; not nil terminated
+		const char* String( int n, int* len ) const;
+		double Value( int n );
+};
+
+} // namespace
+#endif
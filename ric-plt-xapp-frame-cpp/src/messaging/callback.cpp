@@ -38,7 +38,19 @@ namespace xapp {
 */
 Callback::Callback( user_callback ufun, void* data ) :		// builder
 	user_fun( ufun ),
-	udata( data )
+	udata( data ),
+	borrow_msg( false )
+{ /* empty body */ }
+
+/*
+	Builder for a callback which borrows the message. The message (and the
+	underlying RMR buffer) is valid only until the callback returns; the
+	listener then hands the buffer straight back to RMR for the next receive.
+*/
+Callback::Callback( user_callback ufun, void* data, bool borrow ) :
+	user_fun( ufun ),
+	udata( data ),
+	borrow_msg( borrow )
 { /* empty body */ }
 
 /*
@@ -55,6 +67,74 @@ void xapp::Callback::Drive_cb( Message& m ) {
 	}
 }
 
+bool xapp::Callback::Borrows_msg( ) const {
+	return borrow_msg;
+}
+
+// --------------- callback table ----------------------------------------------
+
+const int xapp::Callback_table::MAX_DENSE = 32768;
+
+/*
+	Build the table from the map of registered callbacks; the callback
+	registered with default_type (if any) is the default. The callback
+	objects are referenced, not copied, and remain owned by the caller.
+*/
+xapp::Callback_table::Callback_table( const std::map<int,Callback*>& cbs, int default_type ) :
+	dense( NULL ),
+	ndense( 0 ),
+	dcb( NULL )
+{
+	std::map<int,Callback*>::const_iterator mi;
+	int	i;
+
+	for( mi = cbs.begin(); mi != cbs.end(); mi++ ) {
+		if( mi->first == default_type ) {
+			dcb = mi->second;
+		} else {
+			if( mi->first >= 0 && mi->first < MAX_DENSE ) {
+				if( mi->first >= ndense ) {
+					ndense = mi->first + 1;				// map is ordered, but don't depend on it
+				}
+			} else {
+				sparse[mi->first] = mi->second;
+			}
+		}
+	}
+
+	if( ndense > 0 ) {
+		dense = new Callback*[ndense];
+		for( i = 0; i < ndense; i++ ) {
+			dense[i] = dcb;
+		}
+
+		for( mi = cbs.begin(); mi != cbs.end(); mi++ ) {
+			if( mi->first != default_type && mi->first >= 0 && mi->first < ndense ) {
+				dense[mi->first] = mi->second;
+			}
+		}
+	}
+}
+
+xapp::Callback_table::~Callback_table() {
+	if( dense != NULL ) {
+		delete[] dense;
+	}
+}
+
+/*
+	Lookup for a type outside of the dense array.
+*/
+xapp::Callback* xapp::Callback_table::Find_sparse( int mtype ) const {
+	std::map<int,Callback*>::const_iterator mi;
+
+	if( ! sparse.empty() && (mi = sparse.find( mtype )) != sparse.end() ) {
+		return mi->second;
+	}
+
+	return dcb;
+}
+
 
 
 } // namespace
@@ -29,6 +29,7 @@
 #ifndef _CALLBACK_HPP
 #define _CALLBACK_HPP
 
+#include <map>
 #include <memory>
 
 #include "msg_component.hpp"
@@ -40,16 +41,60 @@ class Messenger;
 class Message;
 
 typedef void(*user_callback)( xapp::Message& m, int mtype, int subid, int payload_len, xapp::Msg_component payload, void* usr_data );
+typedef void(*user_batch_callback)( xapp::Message** msgs, int nmsgs, void* usr_data );
 
 class Callback {
 
 	private:
 		user_callback user_fun;
 		void*	udata;									// user data
+		bool	borrow_msg;								// message is only lent to the callback
 
 	public:
 		Callback( user_callback, void* data );			// builder
+		Callback( user_callback, void* data, bool borrow_msg );
 		void Drive_cb( Message& m );					// invoker
+		bool Borrows_msg( ) const;
+};
+
+/*
+	An immutable map of message type to callback built from the registered
+	callbacks. Types from 0 up to the largest registered type (limited to
+	MAX_DENSE) index an array directly; the slots of types without a
+	callback hold the default callback, so a lookup is a bounds check and an
+	index. Larger (or negative) types are kept in a map which is searched
+	only when one was registered.
+*/
+class Callback_table {
+	private:
+		Callback**	dense;								// indexed by message type
+		int			ndense;
+		std::map<int,Callback*> sparse;					// types which don't fit in the dense array
+		Callback*	dcb;								// default callback; nil if none
+
+		// copy and assignment are PRIVATE; tables are shared by pointer only
+		Callback_table( const Callback_table& soi );
+		Callback_table& operator=( const Callback_table& soi );
+
+	public:
+		static const int MAX_DENSE;						// largest type which goes in the array is MAX_DENSE-1
+
+		Callback_table( const std::map<int,Callback*>& cbs, int default_type );
+		~Callback_table();
+
+		/*
+			Return the callback to drive for the type: the registered callback,
+			the default if there isn't one, or nil.
+		*/
+		inline Callback* Find( int mtype ) const {
+			if( (unsigned int) mtype < (unsigned int) ndense ) {
+				return dense[mtype];
+			}
+
+			return Find_sparse( mtype );
+		}
+
+		Callback* Find_sparse( int mtype ) const;
 };
 
 } // namespace
@@ -0,0 +1,439 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	dispatcher.cpp
+	Abstract:	Hands messages from the receive thread(s) to a pool of worker
+				threads. Each worker has a bounded lock free queue; the worker
+				for a message is selected using the key returned by the user's
+				key function so that messages with the same key are processed
+				in order by a single worker, while a slow callback for one
+				key does not hold up messages for keys assigned to the other
+				workers.
+
+				Workers spin briefly when their queue is empty and then sleep
+				on a condition; a receiver only touches the mutex when it sees
+				that the worker is sleeping.
+
+	Date:		18 October 2026
+*/
+
+#include <string.h>
+
+#include <rmr/rmr.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "message.hpp"
+#include "metrics.hpp"
+#include "dispatcher.hpp"
+
+namespace xapp {
+
+// --------------- supplied key functions ---------------------------------------
+
+/*
+	Key on the managed entity ID (FNV-1a hash of the string).
+*/
+unsigned long Meid_key( Message& m, void* data ) {
+	unsigned char meid[RMR_MAX_MEID];
+	unsigned long hash = 14695981039346656037UL;
+	int	i;
+
+	if( m.Get_meid( meid, sizeof( meid ) ) == NULL ) {
+		return 0;
+	}
+
+	for( i = 0; i < RMR_MAX_MEID && meid[i] != 0; i++ ) {
+		hash ^= meid[i];
+		hash *= 1099511628211UL;
+	}
+
+	return hash;
+}
+
+/*
+	Key on the subscription ID.
+*/
+unsigned long Subid_key( Message& m, void* data ) {
+	return (unsigned long) m.Get_subid();
+}
+
+/*
+	Key on the message type; all messages of one type are serialised.
+*/
+unsigned long Mtype_key( Message& m, void* data ) {
+	return (unsigned long) m.Get_mtype();
+}
+
+// --------------- queue --------------------------------------------------------
+
+/*
+	The queue is a ring of cells, each with a sequence number which indicates
+	whether the cell is free for the producer at that position, or holds a
+	buffer for the consumer. Producers claim a slot by advancing the head with
+	a CAS, so more than one receive thread may push to the same queue. The
+	size is rounded up to a power of two.
+*/
+xapp::Dispatch_queue::Dispatch_queue( int size ) {
+	unsigned long qsize = 2;
+	unsigned long i;
+
+	while( qsize < (unsigned long) size ) {
+		qsize <<= 1;
+	}
+
+	mask = qsize - 1;
+	cells = new cell_t[qsize];
+	for( i = 0; i < qsize; i++ ) {
+		cells[i].seq.store( i, std::memory_order_relaxed );
+		cells[i].mbuf = NULL;
+	}
+
+	head.store( 0, std::memory_order_relaxed );
+	tail.store( 0, std::memory_order_relaxed );
+}
+
+/*
+	Destroyer. Any buffers still queued are given back to RMR.
+*/
+xapp::Dispatch_queue::~Dispatch_queue( ) {
+	rmr_mbuf_t*	mbuf;
+
+	while( (mbuf = Pop()) != NULL ) {
+		rmr_free_msg( mbuf );
+	}
+
+	delete[] cells;
+}
+
+/*
+	Add a buffer to the queue. Returns false if the queue is full.
+*/
+bool xapp::Dispatch_queue::Push( rmr_mbuf_t* mbuf ) {
+	cell_t*	cell;
+	unsigned long pos;
+	unsigned long seq;
+	long	diff;
+
+	pos = head.load( std::memory_order_relaxed );
+	for( ;; ) {
+		cell = &cells[pos & mask];
+		seq = cell->seq.load( std::memory_order_acquire );
+		diff = (long) seq - (long) pos;
+		if( diff == 0 ) {
+			if( head.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		} else {
+			if( diff < 0 ) {
+				return false;									// consumer has not freed this cell; full
+			}
+
+			pos = head.load( std::memory_order_relaxed );		// another producer got it, try again
+		}
+	}
+
+	cell->mbuf = mbuf;
+	cell->seq.store( pos + 1, std::memory_order_release );
+
+	return true;
+}
+
+/*
+	Remove the next buffer from the queue. Returns nil if the queue is empty.
+	Only the owning worker pops, but the same CAS protocol is used so that
+	the destructor can drain safely.
+*/
+rmr_mbuf_t* xapp::Dispatch_queue::Pop( ) {
+	cell_t*	cell;
+	rmr_mbuf_t*	mbuf;
+	unsigned long pos;
+	unsigned long seq;
+	long	diff;
+
+	pos = tail.load( std::memory_order_relaxed );
+	for( ;; ) {
+		cell = &cells[pos & mask];
+		seq = cell->seq.load( std::memory_order_acquire );
+		diff = (long) seq - (long) (pos + 1);
+		if( diff == 0 ) {
+			if( tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+				break;
+			}
+		} else {
+			if( diff < 0 ) {
+				return NULL;									// producer has not filled this cell; empty
+			}
+
+			pos = tail.load( std::memory_order_relaxed );
+		}
+	}
+
+	mbuf = cell->mbuf;
+	cell->seq.store( pos + mask + 1, std::memory_order_release );
+
+	return mbuf;
+}
+
+/*
+	Number of buffers queued. This is a snapshot and may be stale by the
+	time the caller looks at it.
+*/
+long xapp::Dispatch_queue::Get_depth( ) const {
+	long depth;
+
+	depth = (long) (head.load( std::memory_order_relaxed ) - tail.load( std::memory_order_relaxed ));
+	return depth < 0 ? 0 : depth;
+}
+
+int xapp::Dispatch_queue::Get_size( ) const {
+	return (int) mask + 1;
+}
+
+// ---------------- C++ buggerd up way of maintining class constants ----------
+const int xapp::Dispatcher::BLOCK = 0;
+const int xapp::Dispatcher::DROP = 1;
+const int xapp::Dispatcher::DEFAULT_QUEUE_SIZE = 1024;
+
+// --------------- builders -----------------------------------------------
+
+/*
+	Create a dispatcher with nworkers queues of queue_size entries. The full
+	action is either Dispatcher::BLOCK, in which case a receiver waits for
+	room (pushing back on RMR, which will start to drop when its own ring
+	fills), or Dispatcher::DROP where the message is freed and counted. If the
+	key function is nil, messages are keyed on the MEID.
+*/
+xapp::Dispatcher::Dispatcher( int nworkers, int queue_size, int full_action, dispatch_key key_fun, void* key_data ) {
+	int i;
+
+	if( nworkers < 1 ) {
+		nworkers = 1;
+	}
+	if( queue_size < 1 ) {
+		queue_size = DEFAULT_QUEUE_SIZE;
+	}
+
+	this->nworkers = nworkers;
+	this->full_action = full_action;
+	this->key_fun = key_fun == NULL ? Meid_key : key_fun;
+	this->key_data = key_data;
+
+	workers = new worker_t[nworkers];
+	for( i = 0; i < nworkers; i++ ) {
+		workers[i].queue = new Dispatch_queue( queue_size );
+		workers[i].sleeping = false;
+		workers[i].max_depth = 0;
+	}
+
+	dispatched = 0;
+	dropped = 0;
+	stalls = 0;
+	ok_2_run = true;
+}
+
+/*
+	Destroyer. Worker threads must have been stopped and joined.
+*/
+xapp::Dispatcher::~Dispatcher( ) {
+	int i;
+
+	for( i = 0; i < nworkers; i++ ) {
+		delete workers[i].queue;
+	}
+
+	delete[] workers;
+}
+
+// --------------- dispatching --------------------------------------------------
+
+/*
+	Return the worker which should process the message.
+*/
+int xapp::Dispatcher::Select_worker( Message& m ) const {
+	if( nworkers == 1 ) {
+		return 0;
+	}
+
+	return (int) (key_fun( m, key_data ) % (unsigned long) nworkers);
+}
+
+/*
+	Queue the buffer for the worker. Returns true if the buffer was queued
+	(the caller must no longer reference it). If the queue is full and the
+	full action is DROP, false is returned and the buffer still belongs to
+	the caller. With BLOCK this does not return until the buffer is queued
+	or the dispatcher is stopped.
+*/
+bool xapp::Dispatcher::Dispatch( int worker, rmr_mbuf_t* mbuf ) {
+	worker_t*	w;
+	long		depth;
+	long		max;
+
+	w = &workers[worker];
+	if( ! w->queue->Push( mbuf ) ) {
+		if( full_action == DROP ) {
+			dropped++;
+			return false;
+		}
+
+		stalls++;
+		while( ! w->queue->Push( mbuf ) ) {
+			if( ! ok_2_run ) {
+				dropped++;
+				return false;
+			}
+
+			std::this_thread::sleep_for( std::chrono::microseconds( 50 ) );
+		}
+	}
+
+	dispatched++;
+	depth = w->queue->Get_depth();
+	max = w->max_depth.load( std::memory_order_relaxed );
+	while( depth > max && ! w->max_depth.compare_exchange_weak( max, depth, std::memory_order_relaxed ) );
+
+	std::atomic_thread_fence( std::memory_order_seq_cst );		// push must be visible before we look at the flag
+	if( w->sleeping.load( std::memory_order_relaxed ) ) {
+		std::lock_guard<std::mutex> lk( w->gate );
+		w->wake.notify_one();
+	}
+
+	return true;
+}
+
+/*
+	Return the next buffer for the worker, blocking until there is one. Nil
+	is returned only once the dispatcher has been stopped and the queue is
+	empty, so everything accepted is processed before workers exit.
+*/
+rmr_mbuf_t* xapp::Dispatcher::Next( int worker ) {
+	worker_t*	w;
+	rmr_mbuf_t*	mbuf;
+	int			spins;
+
+	w = &workers[worker];
+	for( ;; ) {
+		for( spins = 0; spins < 100; spins++ ) {
+			if( (mbuf = w->queue->Pop()) != NULL ) {
+				return mbuf;
+			}
+
+			std::this_thread::yield();
+		}
+
+		if( ! ok_2_run ) {
+			return w->queue->Pop();
+		}
+
+		std::unique_lock<std::mutex> lk( w->gate );
+		w->sleeping.store( true, std::memory_order_relaxed );
+		std::atomic_thread_fence( std::memory_order_seq_cst );	// flag must be visible before we look at the queue
+		if( (mbuf = w->queue->Pop()) == NULL && ok_2_run ) {
+			w->wake.wait_for( lk, std::chrono::milliseconds( 100 ) );
+		}
+		w->sleeping.store( false, std::memory_order_relaxed );
+
+		if( mbuf != NULL ) {
+			return mbuf;
+		}
+	}
+}
+
+/*
+	Stop the dispatcher. Workers drain their queues and then Next() returns
+	nil to them. Receive threads should be stopped first.
+*/
+void xapp::Dispatcher::Stop( ) {
+	int i;
+
+	ok_2_run = false;
+	for( i = 0; i < nworkers; i++ ) {
+		std::lock_guard<std::mutex> lk( workers[i].gate );
+		workers[i].wake.notify_all();
+	}
+}
+
+// --------------- stats --------------------------------------------------------
+
+int xapp::Dispatcher::Get_nworkers( ) const {
+	return nworkers;
+}
+
+/*
+	Total number of messages waiting across all workers.
+*/
+long xapp::Dispatcher::Get_queue_depth( ) const {
+	long depth = 0;
+	int i;
+
+	for( i = 0; i < nworkers; i++ ) {
+		depth += workers[i].queue->Get_depth();
+	}
+
+	return depth;
+}
+
+/*
+	Number of messages waiting for one worker; -1 if worker is out of range.
+*/
+long xapp::Dispatcher::Get_queue_depth( int worker ) const {
+	if( worker < 0 || worker >= nworkers ) {
+		return -1;
+	}
+
+	return workers[worker].queue->Get_depth();
+}
+
+long xapp::Dispatcher::Get_dropped( ) const {
+	return dropped;
+}
+
+/*
+	Add the dispatcher's values to the metrics object. The caller sends the
+	metrics when it is ready. The high water mark is reset so that each
+	push reports the deepest queue seen since the previous one.
+*/
+void xapp::Dispatcher::Push_metrics( xapp::Metrics& metrics ) {
+	long max = 0;
+	long wmax;
+	int i;
+
+	for( i = 0; i < nworkers; i++ ) {
+		wmax = workers[i].max_depth.exchange( 0 );
+		if( wmax > max ) {
+			max = wmax;
+		}
+	}
+
+	metrics.Push_data( "dispatch_queue_depth", (double) Get_queue_depth() );
+	metrics.Push_data( "dispatch_queue_depth_max", (double) max );
+	metrics.Push_data( "dispatch_messages", (double) dispatched );
+	metrics.Push_data( "dispatch_dropped", (double) dropped );
+	metrics.Push_data( "dispatch_stalls", (double) stalls );
+}
+
+} // namespace
@@ -0,0 +1,137 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	dispatcher.hpp
+	Abstract:	Headers for the dispatcher class. The dispatcher sits between
+				the receive thread(s) and a pool of worker threads which drive
+				the callbacks. Each received message is assigned to a worker
+				using a key extracted from the message so that all messages
+				with the same key are processed, in order, by the same worker.
+
+	Date:		18 October 2026
+*/
+
+#ifndef _xapp_dispatcher_hpp
+#define _xapp_dispatcher_hpp
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+#include <rmr/rmr.h>
+
+#include "message.hpp"
+#include "metrics.hpp"
+
+namespace xapp {
+
+/*
+	A key function is given each message as it is received and returns the
+	value used to select the worker. Messages which return the same key are
+	always processed by the same worker, in the order received.
+*/
+typedef unsigned long (*dispatch_key)( Message& m, void* data );
+
+extern unsigned long Meid_key( Message& m, void* data );			// supplied key functions
+extern unsigned long Subid_key( Message& m, void* data );
+extern unsigned long Mtype_key( Message& m, void* data );
+
+/*
+	A bounded, lock free, multi producer single consumer ring of message
+	buffers. One of these is allocated for each worker.
+*/
+class Dispatch_queue {
+	private:
+		typedef struct {
+			std::atomic<unsigned long>	seq;		// cell sequence; tells producer/consumer who owns it
+			rmr_mbuf_t*	mbuf;
+		} cell_t;
+
+		cell_t*	cells;
+		unsigned long mask;							// size is a power of 2, so this is size-1
+		char	pad1[64];							// keep producer and consumer indexes on their own cache lines
+		std::atomic<unsigned long> head;			// next slot to insert into
+		char	pad2[64];
+		std::atomic<unsigned long> tail;			// next slot to remove from
+		char	pad3[64];
+
+		// copy and assignment are PRIVATE; queues are never copied
+		Dispatch_queue( const Dispatch_queue& soi );
+		Dispatch_queue& operator=( const Dispatch_queue& soi );
+
+	public:
+		Dispatch_queue( int size );
+		~Dispatch_queue( );
+
+		bool Push( rmr_mbuf_t* mbuf );
+		rmr_mbuf_t* Pop( );
+		long Get_depth( ) const;
+		int Get_size( ) const;
+};
+
+class Dispatcher {
+	private:
+		typedef struct {
+			Dispatch_queue*	queue;
+			std::mutex	gate;						// protects the sleep/wake handshake only
+			std::condition_variable	wake;
+			std::atomic<bool>	sleeping;
+			std::atomic<long>	max_depth;			// high water mark since last metrics push
+		} worker_t;
+
+		worker_t*	workers;
+		int			nworkers;
+		int			full_action;					// what to do when a worker's queue is full
+		dispatch_key key_fun;
+		void*		key_data;
+		std::atomic<bool>	ok_2_run;
+		std::atomic<long>	dispatched;				// counters reported by Push_metrics
+		std::atomic<long>	dropped;
+		std::atomic<long>	stalls;					// times a receiver waited for room
+
+		// copy and assignment are PRIVATE; threads hold pointers to us
+		Dispatcher( const Dispatcher& soi );
+		Dispatcher& operator=( const Dispatcher& soi );
+
+	public:
+		static const int BLOCK;						// full actions: receiver waits for room
+		static const int DROP;						// message is dropped when queue is full
+		static const int DEFAULT_QUEUE_SIZE;
+
+		Dispatcher( int nworkers, int queue_size, int full_action, dispatch_key key_fun, void* key_data );
+		~Dispatcher( );
+
+		int Select_worker( Message& m ) const;
+		bool Dispatch( int worker, rmr_mbuf_t* mbuf );
+		rmr_mbuf_t* Next( int worker );
+		void Stop( );
+
+		int Get_nworkers( ) const;
+		long Get_queue_depth( ) const;
+		long Get_queue_depth( int worker ) const;
+		long Get_dropped( ) const;
+		void Push_metrics( xapp::Metrics& metrics );
+};
+
+} // namespace
+
+#endif
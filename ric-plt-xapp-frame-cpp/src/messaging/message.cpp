@@ -47,6 +47,35 @@ namespace xapp {
 
 // --------------- private ------------------------------------------------
 
+/*
+	Give a (received) RMR buffer to an existing wrapper. The listener keeps one
+	wrapper per thread and attaches each received buffer to it so that no
+	wrapper is allocated per message. A buffer that is still attached (the
+	callback did not lend it back) is released first.
+*/
+void xapp::Message::Attach( rmr_mbuf_t* new_mbuf, void* new_mrc ) {
+	if( mbuf != NULL && mbuf != new_mbuf ) {
+		rmr_free_msg( mbuf );
+	}
+
+	mbuf = new_mbuf;
+	mrc = new_mrc;
+}
+
+/*
+	Take the buffer away from the wrapper without releasing it; the caller
+	becomes responsible for it (e.g. hands it back to RMR for the next receive).
+	The return is nil if the buffer was moved out of the wrapper.
+*/
+rmr_mbuf_t* xapp::Message::Detach( ) {
+	rmr_mbuf_t* old_mbuf;
+
+	old_mbuf = mbuf;
+	mbuf = NULL;
+
+	return old_mbuf;
+}
+
 // --------------- builders/operators  -------------------------------------
 
 /*
@@ -164,6 +193,21 @@ std::unique_ptr<unsigned char> xapp::Message::Copy_payload( ){
 	return NULL;
 }
 
+/*
+	Copy the payload bytes into a buffer supplied by the caller, avoiding the
+	allocation made by the smart pointer version. Returns the number of bytes
+	copied, or -1 if there is no message or the buffer is too small for the
+	used portion of the payload (see Get_len()).
+*/
+int xapp::Message::Copy_payload( unsigned char* dest, int dest_len ) const {
+	if( mbuf == NULL || dest == NULL || dest_len < mbuf->len ) {
+		return -1;
+	}
+
+	memcpy( dest, mbuf->payload, mbuf->len );
+	return mbuf->len;
+}
+
 /*
 	Makes a copy of the MEID and returns a smart pointer to it.
 */
@@ -176,6 +220,20 @@ std::unique_ptr<unsigned char> xapp::Message::Get_meid() const {
 	return std::unique_ptr<unsigned char>( m );
 }
 
+/*
+	Copies the MEID into a buffer supplied by the caller which must be at least
+	RMR_MAX_MEID bytes. Returns dest, or nil if the buffer is too small or there
+	is no message. Nothing is allocated, so this is safe to use on the receive
+	path at high message rates.
+*/
+unsigned char* xapp::Message::Get_meid( unsigned char* dest, int dest_len ) const {
+	if( mbuf == NULL || dest == NULL || dest_len < RMR_MAX_MEID ) {
+		return NULL;
+	}
+
+	return rmr_get_meid( mbuf, dest );
+}
+
 /*
 	Return the total size of the payload (the amount that can be written to
 	as opposed to the portion of the payload which is currently in use.
@@ -209,6 +267,19 @@ std::unique_ptr<unsigned char> xapp::Message::Get_src() const {
 	return std::unique_ptr<unsigned char>( m );
 }
 
+/*
+	Copies the source into a buffer supplied by the caller which must be at
+	least RMR_MAX_SRC bytes. Returns dest, or nil if the buffer is too small or
+	there is no message.
+*/
+unsigned char* xapp::Message::Get_src( unsigned char* dest, int dest_len ) const {
+	if( mbuf == NULL || dest == NULL || dest_len < RMR_MAX_SRC ) {
+		return NULL;
+	}
+
+	return rmr_get_src( mbuf, dest );
+}
+
 int	xapp::Message::Get_state( ) const {
 	int state = INVALID_STATUS;
 
@@ -59,6 +59,10 @@ class Message {
 		void*		mrc;					// message router context
 		std::shared_ptr<char> psp;			// shared pointer to the payload to give out
 
+		friend class Messenger;				// listener reuses a wrapper rather than allocating one per message
+		void Attach( rmr_mbuf_t* new_mbuf, void* new_mrc );
+		rmr_mbuf_t* Detach( );
+
 	public:
 		static const int	NO_CHANGE = -99;			// indicates no change to a send/reply parameter
 		static const int	NO_WHID = -1;				// no wormhole id applies
@@ -80,13 +84,16 @@ class Message {
 		~Message();									// destroyer
 
 		std::unique_ptr<unsigned char>  Copy_payload( );		// copy the payload; deletable smart pointer
+		int Copy_payload( unsigned char* dest, int dest_len ) const;	// copy the payload to caller's buffer (no allocation)
 
 		std::unique_ptr<unsigned char> Get_meid() const;				// returns a copy of the meid bytes
+		unsigned char* Get_meid( unsigned char* dest, int dest_len ) const;	// meid to caller's buffer (no allocation)
 		int Get_available_size() const;
 		int Get_len() const;
 		int Get_mtype() const;
 		Msg_component Get_payload() const;
 		std::unique_ptr<unsigned char>  Get_src() const;
+		unsigned char* Get_src( unsigned char* dest, int dest_len ) const;	// src to caller's buffer (no allocation)
 		int	Get_state( ) const;
 		int	Get_subid() const;
 
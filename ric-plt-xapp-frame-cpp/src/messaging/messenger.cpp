@@ -38,12 +38,15 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 #include "callback.hpp"
 #include "default_cb.hpp"		// default callback prototypes
 #include "message.hpp"
 #include "messenger.hpp"
+#include "dispatcher.hpp"
 #include "alarm.hpp"
+#include "alarm_mgr.hpp"
 #include "metrics.hpp"
 
 namespace xapp {
@@ -72,6 +75,12 @@ xapp::Messenger::Messenger( const char* uport, bool wait4table ) {
 	}
 
 	gate = new std::mutex();
+	cb_table = new Callback_table( cb_hash, DEFAULT_CALLBACK );
+	dispatch_qsize = Dispatcher::DEFAULT_QUEUE_SIZE;
+	dispatch_full = Dispatcher::BLOCK;
+	batch_fun = NULL;
+	batch_data = NULL;
+	batch_max = 0;
 	mrc = rmr_init( listen_port, Messenger::MAX_PAYLOAD, 0 );
 
 	if( wait4table ) {
@@ -95,11 +104,24 @@ xapp::Messenger::Messenger( Messenger&& soi ) :
 	listen_port(  soi.listen_port ),
 	ok_2_run(  soi.ok_2_run ),
 	gate(  soi.gate ),
-	cb_hash(  soi.cb_hash )			// this seems dodgy
+	cb_hash(  soi.cb_hash ),
+	cb_table( soi.cb_table.load() ),
+	old_tables( soi.old_tables ),
+	old_cbs( soi.old_cbs ),
+	dispatcher( soi.dispatcher ),
+	dispatch_qsize( soi.dispatch_qsize ),
+	dispatch_full( soi.dispatch_full ),
+	batch_fun( soi.batch_fun ),
+	batch_data( soi.batch_data ),
+	batch_max( soi.batch_max )
 {
 	soi.gate = NULL;
 	soi.listen_port = NULL;
 	soi.mrc = NULL;
+	soi.cb_hash.clear();				// callbacks and tables are ours now
+	soi.cb_table = NULL;
+	soi.old_tables.clear();
+	soi.old_cbs.clear();
 }
 
 /*
@@ -115,15 +137,30 @@ xapp::Messenger& Messenger::operator=( Messenger&& soi ) {
 			delete( listen_port );
 		}
 
+		Free_callbacks( );
+
 		mrc = soi.mrc;
 		listen_port = soi.listen_port;
 		ok_2_run = soi.ok_2_run;
 		gate = soi.gate;
-			cb_hash = soi.cb_hash;				// this seems dodgy
+		cb_hash = soi.cb_hash;
+		cb_table = soi.cb_table.load();
+		old_tables = soi.old_tables;
+		old_cbs = soi.old_cbs;
+		dispatcher = soi.dispatcher;
+		dispatch_qsize = soi.dispatch_qsize;
+		dispatch_full = soi.dispatch_full;
+		batch_fun = soi.batch_fun;
+		batch_data = soi.batch_data;
+		batch_max = soi.batch_max;
 
 		soi.gate = NULL;
 		soi.listen_port = NULL;
 		soi.mrc = NULL;
+		soi.cb_hash.clear();
+		soi.cb_table = NULL;
+		soi.old_tables.clear();
+		soi.old_cbs.clear();
 	}
 
 	return *this;
@@ -140,6 +177,34 @@ xapp::Messenger::~Messenger() {
 	if( listen_port != NULL ) {
 		delete( listen_port );
 	}
+
+	Free_callbacks( );
+}
+
+/*
+	Release the callback table(s) and the callbacks. Only safe when nothing
+	is listening.
+*/
+void xapp::Messenger::Free_callbacks( ) {
+	std::map<int,Callback*>::iterator mi;
+	unsigned int i;
+
+	for( mi = cb_hash.begin(); mi != cb_hash.end(); mi++ ) {
+		delete mi->second;
+	}
+	cb_hash.clear();
+
+	for( i = 0; i < old_cbs.size(); i++ ) {
+		delete old_cbs[i];
+	}
+	old_cbs.clear();
+
+	for( i = 0; i < old_tables.size(); i++ ) {
+		delete old_tables[i];
+	}
+	old_tables.clear();
+
+	delete cb_table.exchange( NULL );
 }
 
 /*
@@ -153,14 +218,74 @@ xapp::Messenger::~Messenger() {
 	passing Messenger::DEFAULT_CALLBACK as the mtype. If no other callback
 	is defined for a message type, the default callback function is invoked.
 	If a default is not provided, a non-matching message is silently dropped.
+
+	Callbacks may be added, or replaced, while listeners are running.
 */
 void xapp::Messenger::Add_msg_cb( int mtype, user_callback fun_name, void* data ) {
+	Add_msg_cb( mtype, fun_name, data, false );
+}
+
+/*
+	Register a callback and indicate whether it borrows the message. When
+	borrow_msg is true the message passed to the callback is valid only until
+	the callback returns (it must not be moved out, or referenced later) and
+	the listener hands the RMR buffer directly back to RMR for the next
+	receive. Together with the per-listener message wrapper this results in
+	no heap allocation per message in the framework.
+*/
+void xapp::Messenger::Add_msg_cb( int mtype, user_callback fun_name, void* data, bool borrow_msg ) {
+	std::map<int,Callback*>::iterator mi;
+	Callback_table*	old_table;
 	Callback*	cb;
 
-	cb = new Callback( fun_name, data );
+	cb = new Callback( fun_name, data, borrow_msg );
+
+	std::lock_guard<std::mutex> lk( *gate );		// serialise registrations; listeners never lock
+
+	mi = cb_hash.find( mtype );
+	if( mi != cb_hash.end() ) {
+		old_cbs.push_back( mi->second );			// a listener may be driving it right now
+	}
 	cb_hash[mtype] = cb;
 
-	callbacks = true;
+	/*
+		Listeners pick up the table with a single atomic load per message and
+		so see either the old table or the new one, never one being built.
+		Registration after Run() is rare, so rather than tracking when every
+		listener has let go of the old table it is kept until we are destroyed.
+	*/
+	old_table = cb_table.exchange( new Callback_table( cb_hash, DEFAULT_CALLBACK ), std::memory_order_acq_rel );
+	if( old_table != NULL ) {
+		old_tables.push_back( old_table );
+	}
+}
+
+/*
+	Register a batch callback. Once registered, listeners receive up to
+	max_batch messages each time they wake and pass them all, regardless of
+	message type, to the batch callback; the per type callbacks are not
+	driven. The exception is the message types the framework answers itself
+	(health check requests) which are taken out of the batch and passed to
+	their registered callback. The messages are lent to the callback: they are valid until it
+	returns and are then reused for the next batch, so the callback must not
+	keep references to them. The callback may send or reply with them (see
+	Send_batch() and Reply_batch()) as it would any other message.
+
+	Must be registered before listening starts.
+*/
+void xapp::Messenger::Add_batch_cb( user_batch_callback fun_name, void* data, int max_batch ) {
+	batch_data = data;
+	batch_max = max_batch > 0 ? max_batch : 1;
+	batch_fun = fun_name;
+}
+
+/*
+	Return the callback which should be driven for the message type; the
+	default callback if there isn't one registered for the type, or nil if
+	there is no default either.
+*/
+Callback* xapp::Messenger::Find_cb( int mtype ) {
+	return cb_table.load( std::memory_order_acquire )->Find( mtype );
 }
 
 /*
@@ -200,6 +325,20 @@ std::unique_ptr<xapp::Alarm> xapp::Messenger::Alloc_alarm( ) {
 	return Alloc_alarm( -1, "" );
 }
 
+/*
+	Allocate an alarm manager which sends through an alarm allocated here
+	(so it has a wormhole to the collector), sending no more than max_rate
+	messages per second. The manager's flusher is started.
+*/
+std::unique_ptr<xapp::Alarm_mgr> xapp::Messenger::Alloc_alarm_mgr( int max_rate ) {
+	Alarm_mgr*	am;
+
+	am = new Alarm_mgr( Alloc_alarm(), max_rate );
+	am->Start( Alarm_mgr::DEF_PERIOD );
+
+	return std::unique_ptr<Alarm_mgr>( am );
+}
+
 
 // ------------------ metrics support --------------------------------------------------
 std::unique_ptr<xapp::Metrics> xapp::Messenger::Alloc_metrics( ) {
@@ -233,36 +372,43 @@ std::unique_ptr<xapp::Metrics> xapp::Messenger::Alloc_metrics( const std::string
 	expect to have controll returned in the calling thread.
 
 	Concurrently executing listeners are allowed.
+
+	Each listener keeps a single message wrapper which is reused for every
+	message received by the thread (callbacks are driven synchronously, so one
+	is all that is ever needed). If the selected callback borrows the message,
+	or there is no callback, the RMR buffer is handed back to RMR on the next
+	receive; otherwise the buffer stays with the wrapper until the next
+	message arrives, as it always has.
 */
 void xapp::Messenger::Listen( ) {
 	rmr_mbuf_t*	mbuf = NULL;
-	std::map<int,Callback*>::iterator mi;	// map iterator; silly indirect way to point at the value
-	Callback*	dcb = NULL;					// default callback so we don't search
 	Callback*	sel_cb;						// callback selected to invoke
-	std::unique_ptr<Message> m;
+	Message		m( (rmr_mbuf_t *) NULL, mrc );	// this listener's reusable wrapper
 
 	if( mrc == NULL ) {
 		return;
 	}
 
-	mi = cb_hash.find( DEFAULT_CALLBACK );
-	if( mi != cb_hash.end() ) {
-		dcb = mi->second;					// oddly named second field is the address of the callback block
+	if( batch_fun != NULL ) {
+		Listen_batch( );
+		return;
 	}
 
 	while( ok_2_run ) {
 		mbuf = rmr_torcv_msg( mrc, mbuf, 2000 );		// come up for air every 2 sec to check ok2run
 		if( mbuf != NULL ) {
 			if( mbuf->state == RMR_OK ) {
-				m = std::unique_ptr<Message>( new Message( mbuf, mrc ) );	// auto delteted when scope terminates
+				sel_cb = cb_table.load( std::memory_order_acquire )->Find( mbuf->mtype );	// registered, or default
 
-				sel_cb = dcb;											// start with default
-				if( callbacks  && ((mi = cb_hash.find( mbuf->mtype )) != cb_hash.end()) ) {
-					sel_cb = mi->second;								// override with user callback
-				}
+				m.Attach( mbuf, mrc );									// releases previous buffer if still held
+				mbuf = NULL;											// not safe to use after given to cb
 				if( sel_cb != NULL ) {
-					sel_cb->Drive_cb( *m );							// drive the selected one
-					mbuf = NULL;									// not safe to use after given to cb
+					sel_cb->Drive_cb( m );								// drive the selected one
+					if( sel_cb->Borrows_msg() ) {
+						mbuf = m.Detach();								// lent only; reuse (nil if cb moved it out)
+					}
+				} else {
+					mbuf = m.Detach();									// nobody saw it; just reuse
 				}
 			} else {
 				if( mbuf->state != RMR_ERR_TIMEOUT ) {
@@ -271,6 +417,279 @@ void xapp::Messenger::Listen( ) {
 			}
 		}
 	}
+
+	if( mbuf != NULL ) {
+		rmr_free_msg( mbuf );				// lent buffer not yet given back to RMR
+	}
+}
+
+// ------------------- dispatcher (worker pool) support --------------------------------
+
+/*
+	Set the size of each worker's queue and what happens when a queue is full
+	(Dispatcher::BLOCK or Dispatcher::DROP). Must be called before the
+	dispatcher is started to have any effect.
+*/
+void xapp::Messenger::Set_dispatch_queue( int queue_size, int full_action ) {
+	dispatch_qsize = queue_size;
+	dispatch_full = full_action;
+}
+
+/*
+	Create the dispatcher which will hand messages to nworkers workers
+	using the key function to select the worker. If key_fun is nil, messages
+	are keyed on the MEID. Dispatch_work() must be started for each worker,
+	and one or more Dispatch_listen() threads feed them (order per key is kept
+	only when there is one).
+*/
+void xapp::Messenger::Start_dispatcher( int nworkers, dispatch_key key_fun, void* key_data ) {
+	dispatcher = std::shared_ptr<Dispatcher>( new Dispatcher( nworkers, dispatch_qsize, dispatch_full, key_fun, key_data ) );
+}
+
+/*
+	Receive loop for dispatcher mode. Rather than driving the callback, the
+	message is queued for the worker selected by its key; the receive thread
+	is immediately free to read the next message so that a slow callback
+	delays only the messages which share its worker. Messages without a
+	callback, and those dropped because a queue is full, are handed back to
+	RMR for reuse. Returns when the ok to run flag is cleared.
+*/
+void xapp::Messenger::Dispatch_listen( ) {
+	rmr_mbuf_t*	mbuf = NULL;
+	Message		m( (rmr_mbuf_t *) NULL, mrc );	// presents the message to the key function
+	int			worker;
+
+	if( mrc == NULL || dispatcher == NULL ) {
+		return;
+	}
+
+	while( ok_2_run ) {
+		mbuf = rmr_torcv_msg( mrc, mbuf, 2000 );		// come up for air every 2 sec to check ok2run
+		if( mbuf != NULL ) {
+			if( mbuf->state == RMR_OK ) {
+				if( Find_cb( mbuf->mtype ) == NULL ) {
+					continue;											// nobody wants it; just reuse
+				}
+
+				m.Attach( mbuf, mrc );
+				worker = dispatcher->Select_worker( m );
+				mbuf = m.Detach();
+				if( dispatcher->Dispatch( worker, mbuf ) ) {
+					mbuf = NULL;										// belongs to the worker now
+				}
+			} else {
+				if( mbuf->state != RMR_ERR_TIMEOUT ) {
+					fprintf( stderr, "<LISTENER> got  bad status: %d\n", mbuf->state );
+				}
+			}
+		}
+	}
+
+	if( mbuf != NULL ) {
+		rmr_free_msg( mbuf );
+	}
+}
+
+/*
+	Worker loop for dispatcher mode. Drives the callback for each message
+	queued for this worker, in the order they were received, and returns once
+	the dispatcher is stopped and the queue is empty. As with the listener,
+	a single message wrapper is reused; the buffer of a message lent to a
+	borrowing callback is released as soon as the callback returns.
+*/
+void xapp::Messenger::Dispatch_work( int worker ) {
+	std::shared_ptr<Dispatcher> disp;		// keep ours should the dispatcher be replaced
+	rmr_mbuf_t*	mbuf;
+	Callback*	sel_cb;
+	Message		m( (rmr_mbuf_t *) NULL, mrc );
+
+	disp = dispatcher;
+	if( disp == NULL || worker < 0 || worker >= disp->Get_nworkers() ) {
+		return;
+	}
+
+	while( (mbuf = disp->Next( worker )) != NULL ) {
+		sel_cb = Find_cb( mbuf->mtype );
+		m.Attach( mbuf, mrc );								// releases previous buffer if still held
+		if( sel_cb != NULL ) {
+			sel_cb->Drive_cb( m );
+			if( sel_cb->Borrows_msg() && (mbuf = m.Detach()) != NULL ) {
+				rmr_free_msg( mbuf );
+			}
+		}
+	}
+}
+
+/*
+	Stop the workers. The receive threads must be stopped (Stop()) first;
+	the workers finish the messages already queued before returning.
+*/
+void xapp::Messenger::Stop_dispatcher( ) {
+	if( dispatcher != NULL ) {
+		dispatcher->Stop();
+	}
+}
+
+/*
+	Return the number of messages queued to workers (0 when not in
+	dispatcher mode).
+*/
+long xapp::Messenger::Get_dispatch_depth( ) const {
+	if( dispatcher == NULL ) {
+		return 0;
+	}
+
+	return dispatcher->Get_queue_depth();
+}
+
+/*
+	Add the dispatcher queue depth and counters to the metrics object; the
+	caller is expected to Send() them.
+*/
+void xapp::Messenger::Push_dispatch_metrics( xapp::Metrics& metrics ) {
+	if( dispatcher != NULL ) {
+		dispatcher->Push_metrics( metrics );
+	}
+}
+
+/*
+	Listener used when a batch callback is registered. Each listener has its
+	own set of message wrappers which, along with their RMR buffers, are
+	reused for every batch.
+*/
+void xapp::Messenger::Listen_batch( ) {
+	Message**	msgs;
+	int			nmsgs;
+	int			i;
+
+	msgs = new Message*[batch_max];
+	for( i = 0; i < batch_max; i++ ) {
+		msgs[i] = new Message( (rmr_mbuf_t *) NULL, mrc );
+	}
+
+	while( ok_2_run ) {
+		nmsgs = Receive_batch( msgs, batch_max, 2000 );		// come up for air every 2 sec to check ok2run
+		if( nmsgs > 0 && (nmsgs = Drive_owned( msgs, nmsgs )) > 0 ) {
+			batch_fun( msgs, nmsgs, batch_data );
+		}
+	}
+
+	for( i = 0; i < batch_max; i++ ) {
+		delete msgs[i];
+	}
+	delete[] msgs;
+}
+
+/*
+	Drive the registered callback for each message in the batch whose type
+	the framework answers (health check requests) so that they are not left
+	to the batch callback, which knows nothing of them. The message objects
+	of those driven are moved to the end of the array, keeping the order of
+	the others, and the number left for the batch callback is returned.
+	These are rare, so the shuffle is of no concern.
+*/
+int xapp::Messenger::Drive_owned( Message** msgs, int nmsgs ) {
+	Callback*	sel_cb;
+	Message*	m;
+	int			i;
+	int			j;
+
+	i = 0;
+	while( i < nmsgs ) {
+		if( msgs[i]->Get_mtype() != RIC_HEALTH_CHECK_REQ || (sel_cb = Find_cb( RIC_HEALTH_CHECK_REQ )) == NULL ) {
+			i++;
+			continue;
+		}
+
+		m = msgs[i];
+		sel_cb->Drive_cb( *m );
+
+		nmsgs--;
+		for( j = i; j < nmsgs; j++ ) {
+			msgs[j] = msgs[j+1];
+		}
+		msgs[nmsgs] = m;								// still ours to reuse for the next receive
+	}
+
+	return nmsgs;
+}
+
+/*
+	Receive up to nmsgs messages into the existing message objects, waiting
+	up to timeout ms for the first one. RMR has no call which returns more
+	than one message, so once the first message has arrived the rest are
+	collected by polling the receive ring with a zero timeout; this does not
+	block (or touch the ring's semaphore wait) and stops as soon as the ring
+	is empty. The buffers already held by the message objects are given to
+	RMR for reuse, so nothing is allocated per message when the same objects
+	are passed each time.
+
+	Returns the number of messages received; msgs[0] through msgs[n-1] have
+	a state of RMR_OK.
+*/
+int xapp::Messenger::Receive_batch( Message** msgs, int nmsgs, int timeout ) {
+	rmr_mbuf_t*	mbuf;
+	int			n;
+
+	if( mrc == NULL || msgs == NULL || nmsgs <= 0 ) {
+		return 0;
+	}
+
+	for( n = 0; n < nmsgs; n++ ) {
+		mbuf = rmr_torcv_msg( mrc, msgs[n]->Detach(), n == 0 ? timeout : 0 );
+		msgs[n]->Attach( mbuf, mrc );
+		if( mbuf == NULL || mbuf->state != RMR_OK ) {
+			break;
+		}
+	}
+
+	return n;
+}
+
+/*
+	Send, or return to sender, a set of messages which have been prepared
+	(type, subscription id, length and payload set in place). Each message
+	object is updated with the buffer RMR returns, so the state of each send
+	can be checked with Get_state(), and the objects can be reused. Returns
+	the number of messages which were sent successfully.
+
+	RMR offers no multi-message send, so this is a loop over the single
+	message calls; messages whose payloads were built in place are sent
+	without any copy or reallocation check.
+*/
+int xapp::Messenger::Send_batch( Message** msgs, int nmsgs, int stype ) {
+	rmr_mbuf_t*	mbuf;
+	int			i;
+	int			sent = 0;
+
+	if( mrc == NULL || msgs == NULL ) {
+		return 0;
+	}
+
+	for( i = 0; i < nmsgs; i++ ) {
+		if( (mbuf = msgs[i]->Detach()) != NULL ) {
+			if( stype == Message::RESPONSE ) {
+				mbuf = rmr_rts_msg( mrc, mbuf );
+			} else {
+				mbuf = rmr_send_msg( mrc, mbuf );
+			}
+
+			msgs[i]->Attach( mbuf, mrc );
+			if( mbuf != NULL && mbuf->state == RMR_OK ) {
+				sent++;
+			}
+		}
+	}
+
+	return sent;
+}
+
+int xapp::Messenger::Send_batch( Message** msgs, int nmsgs ) {
+	return Send_batch( msgs, nmsgs, Message::MESSAGE );
+}
+
+int xapp::Messenger::Reply_batch( Message** msgs, int nmsgs ) {
+	return Send_batch( msgs, nmsgs, Message::RESPONSE );
 }
 
 /*
@@ -291,6 +710,26 @@ std::unique_ptr<Message>  xapp::Messenger::Receive( int timeout ) {
 	return m;
 }
 
+/*
+	Wait for the next message, up to a max timeout, and receive it into an
+	existing message object. The RMR buffer currently held by msg (if any) is
+	given to RMR for reuse, so a polling loop which reuses the same message
+	does not allocate per message. Returns true if a message was received
+	(state is RMR_OK); on timeout msg holds the buffer with a timeout state.
+*/
+bool xapp::Messenger::Receive( Message& msg, int timeout ) {
+	rmr_mbuf_t*	mbuf;
+
+	if( mrc == NULL ) {
+		return false;
+	}
+
+	mbuf = rmr_torcv_msg( mrc, msg.Detach(), timeout );
+	msg.Attach( mbuf, mrc );
+
+	return mbuf != NULL && mbuf->state == RMR_OK;
+}
+
 /*
 	Called to gracefully stop all listeners.
 */
@@ -31,16 +31,20 @@
 #define _messenger_hpp
 
 
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <rmr/rmr.h>
 
 #include "message.hpp"
+#include "dispatcher.hpp"
 #include "alarm.hpp"
+#include "alarm_mgr.hpp"
 #include "metrics.hpp"
 
 #ifndef RMR_FALSE
@@ -54,13 +58,29 @@ namespace xapp {
 class Messenger {
 
 	private:
-		std::map<int,Callback*> cb_hash;	// callback functions associated with message types
+		std::map<int,Callback*> cb_hash;	// callback functions associated with message types (under gate)
+		std::atomic<Callback_table*> cb_table;	// lookup table built from cb_hash; replaced, never changed
+		std::vector<Callback_table*> old_tables;	// replaced tables and callbacks; listeners may still
+		std::vector<Callback*> old_cbs;			// reference them so they live until we are destroyed
 		std::mutex*	gate;					// overall mutex should we need searialisation
 		bool		ok_2_run;
-		bool		callbacks = false;		// true if callbacks are defined
 		void*		mrc;					// message router context
 		char*		listen_port;			// port we ask msg router to listen on
 
+		std::shared_ptr<Dispatcher> dispatcher;	// nil unless running in dispatcher mode
+		int			dispatch_qsize;			// queue size and full action used when dispatcher is started
+		int			dispatch_full;
+
+		user_batch_callback	batch_fun;		// when set, listeners receive and deliver messages in batches
+		void*		batch_data;
+		int			batch_max;
+
+		Callback* Find_cb( int mtype );
+		void Free_callbacks( );
+		void Listen_batch( );
+		int Drive_owned( Message** msgs, int nmsgs );
+		int Send_batch( Message** msgs, int nmsgs, int stype );
+
 		// copy and assignment are PRIVATE so that they fail if xapp tries; messenger cannot be copied!
 		Messenger( const Messenger& soi );
 		Messenger& operator=( const Messenger& soi );
@@ -76,12 +96,15 @@ class Messenger {
 		~Messenger();								// destroyer
 
 		void Add_msg_cb( int mtype, user_callback fun_name, void* data );
+		void Add_msg_cb( int mtype, user_callback fun_name, void* data, bool borrow_msg );
+		void Add_batch_cb( user_batch_callback fun_name, void* data, int max_batch );
 
 		std::unique_ptr<Message> Alloc_msg( int payload_size );			// message allocation
 
 		std::unique_ptr<xapp::Alarm> Alloc_alarm( );					// alarm allocation
 		std::unique_ptr<xapp::Alarm> Alloc_alarm( const std::string& meid );
 		std::unique_ptr<xapp::Alarm> Alloc_alarm( int prob_id, const std::string& meid );
+		std::unique_ptr<xapp::Alarm_mgr> Alloc_alarm_mgr( int max_rate );	// coalescing, asynchronous alarms
 
 		std::unique_ptr<xapp::Metrics> Alloc_metrics( );					// metrics allocation
 		std::unique_ptr<xapp::Metrics> Alloc_metrics( const std::string& source );
@@ -89,9 +112,21 @@ class Messenger {
 
 		void Listen( );													// lisen driver
 		std::unique_ptr<Message> Receive( int timeout );				// receive 1 message
+		bool Receive( Message& msg, int timeout );						// receive 1 message reusing msg (no allocation)
+		int Receive_batch( Message** msgs, int nmsgs, int timeout );	// receive up to nmsgs reusing msgs
+		int Send_batch( Message** msgs, int nmsgs );					// send/reply several prepared messages
+		int Reply_batch( Message** msgs, int nmsgs );
 		void Stop( );													// force to stop
 		bool Wait_for_cts( int max_wait );
 
+		void Set_dispatch_queue( int queue_size, int full_action );	// dispatcher (worker pool) mode
+		void Start_dispatcher( int nworkers, dispatch_key key_fun, void* key_data );
+		void Dispatch_listen( );										// receive and queue to workers
+		void Dispatch_work( int worker );								// worker: drive callbacks for queued messages
+		void Stop_dispatcher( );
+		long Get_dispatch_depth( ) const;
+		void Push_dispatch_metrics( xapp::Metrics& metrics );
+
 		int	Wormhole_open( const std::string& endpoint );
 };
 
@@ -31,6 +31,7 @@
 	Author:		E. Scott Daniels
 */
 
+#include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <time.h>
@@ -115,6 +116,11 @@ int xapp::Metrics::build_payload( xapp::Msg_component payload, int max_len ) {
 			data.c_str()
 	);
 
+	if( used >= max_len ) {								// snprintf gives what it would have used; never report past the buffer
+		fprintf( stderr, "[WARN] metrics: payload of %d bytes truncated to %d\n", used, max_len - 1 );
+		used = max_len > 0 ? max_len - 1 : 0;
+	}
+
 	return used;
 }
 
@@ -256,6 +262,20 @@ void xapp::Metrics::Push_data( std::string key, double value ) {
 
 // ------------------- getters ------------------------------------
 
+/*
+	Returns true if a further nbytes of pushed data would still fit in the
+	message payload along with the data already pushed and the json which
+	wraps it. The overhead allows for the field names, the timestamp and the
+	reporter and generator strings.
+*/
+bool xapp::Metrics::Has_room( int nbytes ) {
+	int overhead;
+
+	overhead = 96 + (int) reporter.size() + (int) (source.compare( "" ) == 0 ? reporter.size() : source.size());
+
+	return overhead + (int) data.size() + nbytes < msg->Get_available_size() - 1;
+}
+
 
 // ------- message sending ---------------------------------------
 
@@ -92,6 +92,7 @@ class Metrics {
 		void Set_source( std::string new_source );
 		void Set_reporter( std::string new_reporter );
 		void Push_data( std::string key, double value );
+		bool Has_room( int nbytes );
 
 
 		bool Send( );
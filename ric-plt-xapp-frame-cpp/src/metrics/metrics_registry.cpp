@@ -0,0 +1,696 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	metrics_registry.cpp
+	Abstract:	Implementation of the metrics registry (see metrics_registry.hpp).
+				Everything here is off the recording path: adding series,
+				attaching threads, and aggregating the per thread cells for the
+				periodic flush and for the Prometheus exposition.
+
+				A thread's block lives until the registry is destroyed, so the
+				counts of threads which have exited are not lost. An xAPP which
+				creates many short lived threads that record should use a pool.
+
+	Date:		18 October 2026
+*/
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <iostream>
+
+#include "message.hpp"
+#include "metrics.hpp"
+#include "metrics_registry.hpp"
+
+namespace xapp {
+
+// ---------------- C++ buggerd up way of maintining class constants ----------
+thread_local Metrics_registry::tl_cache_t Metrics_registry::tl_cache = { 0, NULL };
+thread_local std::map<long,Metrics_registry::block_t*> Metrics_registry::tl_blocks;
+std::atomic<long> Metrics_registry::next_id( 1 );
+
+
+// ------ private ----------------------------------------------
+
+/*
+	Names for the Prometheus exposition must be [a-zA-Z_:][a-zA-Z0-9_:]*;
+	anything else is mapped to an underbar.
+*/
+static std::string prom_name( const std::string& name ) {
+	std::string	pn = name;
+	unsigned int i;
+
+	for( i = 0; i < pn.size(); i++ ) {
+		if( ! (isalnum( pn[i] ) || pn[i] == '_' || pn[i] == ':') || (i == 0 && isdigit( pn[i] )) ) {
+			pn[i] = '_';
+		}
+	}
+
+	return pn;
+}
+
+/*
+	Given bucket counts, return the largest value in the bucket which holds
+	the pct percentile, capped by max. Zero if there are no counts.
+*/
+static unsigned long percentile( const unsigned long* counts, unsigned long total, unsigned long max, double pct ) {
+	unsigned long target;
+	unsigned long seen = 0;
+	unsigned long v;
+	int		i;
+
+	if( total == 0 ) {
+		return 0;
+	}
+
+	target = (unsigned long) ((pct / 100.0) * (double) total);
+	if( target < 1 ) {
+		target = 1;
+	}
+	if( target > total ) {
+		target = total;
+	}
+
+	for( i = 0; i < Metrics_registry::HBUCKETS; i++ ) {
+		seen += counts[i];
+		if( seen >= target ) {
+			v = Metrics_registry::Bucket_max( i );
+			return v > max ? max : v;
+		}
+	}
+
+	return max;
+}
+
+/*
+	Push a value onto the metrics message, first sending what has been pushed
+	if the value would not fit in the payload. A pushed entry is the name and
+	at most 64 bytes of json and value. State is cleared if a send fails.
+*/
+static void push_bounded( Metrics& m, const std::string& name, double value, bool* state ) {
+	if( ! m.Has_room( (int) name.size() + 64 ) ) {
+		if( ! m.Send( ) ) {
+			*state = false;
+		}
+	}
+
+	m.Push_data( name, value );
+}
+
+/*
+	Write all of len bytes to the fd, continuing after partial writes and
+	interrupts. Returns false on error (including the send timeout).
+*/
+static bool write_all( int fd, const char* buf, size_t len ) {
+	ssize_t	n;
+
+	while( len > 0 ) {
+		if( (n = write( fd, buf, len )) < 0 ) {
+			if( errno == EINTR ) {
+				continue;
+			}
+			return false;
+		}
+
+		buf += n;
+		len -= (size_t) n;
+	}
+
+	return true;
+}
+
+/*
+	Called when the cached block is not for this registry. Find the block the
+	calling thread already has for this registry, or add a new one, and cache
+	it. Entries for registries which have been destroyed are never looked up
+	again as ids are not reused.
+*/
+Metrics_registry::block_t* xapp::Metrics_registry::Attach_thread( ) {
+	std::map<long,block_t*>::iterator bi;
+	block_t* b;
+
+	if( (bi = tl_blocks.find( id )) != tl_blocks.end() ) {
+		b = bi->second;
+	} else {
+		b = new block_t();						// value init zeros the cells
+		{
+			std::lock_guard<std::mutex> lk( gate );
+			blocks.push_back( b );
+		}
+		tl_blocks[id] = b;
+	}
+
+	tl_cache.reg_id = id;
+	tl_cache.block = b;
+	return b;
+}
+
+/*
+	Allocate the cells for a histogram in the calling thread's block. Only
+	the owner allocates, the release pairs with the flusher's acquire.
+*/
+Metrics_registry::hist_cells_t* xapp::Metrics_registry::Alloc_hist( block_t* b, int hidx ) {
+	hist_cells_t* h;
+
+	h = new hist_cells_t();
+	b->hists[hidx].store( h, std::memory_order_release );
+	return h;
+}
+
+/*
+	Sum the cells for a histogram across all threads. Caller holds the lock.
+	Counts must have room for HBUCKETS values.
+*/
+void xapp::Metrics_registry::Merge_hist( int hidx, unsigned long* counts, unsigned long* sum, unsigned long* max ) {
+	hist_cells_t* h;
+	unsigned long v;
+	unsigned int b;
+	int		i;
+
+	memset( counts, 0, sizeof( *counts ) * HBUCKETS );
+	*sum = 0;
+	*max = 0;
+
+	for( b = 0; b < blocks.size(); b++ ) {
+		if( (h = blocks[b]->hists[hidx].load( std::memory_order_acquire )) != NULL ) {
+			for( i = 0; i < HBUCKETS; i++ ) {
+				counts[i] += h->counts[i].load( std::memory_order_relaxed );
+			}
+			*sum += h->sum.load( std::memory_order_relaxed );
+			if( (v = h->max.load( std::memory_order_relaxed )) > *max ) {
+				*max = v;
+			}
+		}
+	}
+}
+
+// --------------- builders/operators  -------------------------------------
+
+xapp::Metrics_registry::Metrics_registry( ) :
+	id( next_id++ ),
+	ok_2_run( true )
+{
+	int i;
+
+	for( i = 0; i <= MAX_GAUGES; i++ ) {
+		gauges[i] = 0.0;
+	}
+}
+
+/*
+	Destroyer. Stops the flush and exposition threads and frees all cells.
+*/
+xapp::Metrics_registry::~Metrics_registry( ) {
+	unsigned int i;
+	int		j;
+
+	Stop( );
+
+	for( i = 0; i < blocks.size(); i++ ) {
+		for( j = 0; j <= MAX_HISTOGRAMS; j++ ) {
+			delete blocks[i]->hists[j].load();
+		}
+		delete blocks[i];
+	}
+
+	for( i = 0; i < hist_prev.size(); i++ ) {
+		delete[] hist_prev[i];
+	}
+}
+
+/*
+	Return the process wide registry; created on first use.
+*/
+Metrics_registry& xapp::Metrics_registry::Get_registry( ) {
+	static Metrics_registry reg;
+
+	return reg;
+}
+
+// ---- adding series ------------------------------------------------------
+
+/*
+	Add a counter, or return the existing one with the name. If the registry
+	is full, the handle returned is valid, but its counts are discarded.
+*/
+Counter xapp::Metrics_registry::Add_counter( const std::string& name ) {
+	std::map<std::string,int>::iterator mi;
+	int		idx;
+
+	std::lock_guard<std::mutex> lk( gate );
+	if( (mi = cnames.find( name )) != cnames.end() ) {
+		return Counter( this, mi->second );
+	}
+
+	if( (idx = (int) counter_names.size()) >= MAX_COUNTERS ) {
+		fprintf( stderr, "[WARN] metrics registry: counter capacity reached, %s will not be reported\n", name.c_str() );
+		return Counter( this, MAX_COUNTERS );
+	}
+
+	counter_names.push_back( name );
+	cnames[name] = idx;
+	return Counter( this, idx );
+}
+
+Gauge xapp::Metrics_registry::Add_gauge( const std::string& name ) {
+	std::map<std::string,int>::iterator mi;
+	int		idx;
+
+	std::lock_guard<std::mutex> lk( gate );
+	if( (mi = gnames.find( name )) != gnames.end() ) {
+		return Gauge( this, mi->second );
+	}
+
+	if( (idx = (int) gauge_names.size()) >= MAX_GAUGES ) {
+		fprintf( stderr, "[WARN] metrics registry: gauge capacity reached, %s will not be reported\n", name.c_str() );
+		return Gauge( this, MAX_GAUGES );
+	}
+
+	gauge_names.push_back( name );
+	gnames[name] = idx;
+	return Gauge( this, idx );
+}
+
+Histogram xapp::Metrics_registry::Add_histogram( const std::string& name ) {
+	std::map<std::string,int>::iterator mi;
+	int		idx;
+
+	std::lock_guard<std::mutex> lk( gate );
+	if( (mi = hnames.find( name )) != hnames.end() ) {
+		return Histogram( this, mi->second );
+	}
+
+	if( (idx = (int) hist_names.size()) >= MAX_HISTOGRAMS ) {
+		fprintf( stderr, "[WARN] metrics registry: histogram capacity reached, %s will not be reported\n", name.c_str() );
+		return Histogram( this, MAX_HISTOGRAMS );
+	}
+
+	hist_names.push_back( name );
+	hist_prev.push_back( new unsigned long[HBUCKETS]() );
+	hnames[name] = idx;
+	return Histogram( this, idx );
+}
+
+// ------------------- getters ------------------------------------
+
+/*
+	Return the largest value which maps to the bucket.
+*/
+unsigned long xapp::Metrics_registry::Bucket_max( int bucket ) {
+	int		e;
+	unsigned long width;
+
+	if( bucket < HSUB ) {
+		return (unsigned long) bucket;
+	}
+	if( bucket >= HBUCKETS - 1 ) {
+		return ULONG_MAX;
+	}
+
+	e = (bucket >> HSUB_BITS) + HSUB_BITS - 1;
+	width = 1UL << (e - HSUB_BITS);
+	return ((unsigned long) (HSUB + (bucket & (HSUB - 1))) * width) + width - 1;
+}
+
+/*
+	Return the sum of the named counter across all threads; 0 if unknown.
+*/
+unsigned long xapp::Metrics_registry::Get_counter( const std::string& name ) {
+	std::map<std::string,int>::iterator mi;
+	unsigned long total = 0;
+	unsigned int i;
+
+	std::lock_guard<std::mutex> lk( gate );
+	if( (mi = cnames.find( name )) != cnames.end() ) {
+		for( i = 0; i < blocks.size(); i++ ) {
+			total += blocks[i]->counters[mi->second].load( std::memory_order_relaxed );
+		}
+	}
+
+	return total;
+}
+
+double xapp::Metrics_registry::Get_gauge( const std::string& name ) {
+	std::map<std::string,int>::iterator mi;
+
+	std::lock_guard<std::mutex> lk( gate );
+	if( (mi = gnames.find( name )) != gnames.end() ) {
+		return gauges[mi->second].load( std::memory_order_relaxed );
+	}
+
+	return 0.0;
+}
+
+/*
+	Return the pct percentile of everything recorded in the named histogram.
+*/
+double xapp::Metrics_registry::Get_percentile( const std::string& name, double pct ) {
+	std::map<std::string,int>::iterator mi;
+	unsigned long counts[HBUCKETS];
+	unsigned long total = 0;
+	unsigned long sum;
+	unsigned long max;
+	int		i;
+
+	std::lock_guard<std::mutex> lk( gate );
+	if( (mi = hnames.find( name )) == hnames.end() ) {
+		return 0.0;
+	}
+
+	Merge_hist( mi->second, counts, &sum, &max );
+	for( i = 0; i < HBUCKETS; i++ ) {
+		total += counts[i];
+	}
+
+	return (double) percentile( counts, total, max, pct );
+}
+
+unsigned long xapp::Metrics_registry::Get_hist_count( const std::string& name ) {
+	std::map<std::string,int>::iterator mi;
+	unsigned long counts[HBUCKETS];
+	unsigned long total = 0;
+	unsigned long sum;
+	unsigned long max;
+	int		i;
+
+	std::lock_guard<std::mutex> lk( gate );
+	if( (mi = hnames.find( name )) == hnames.end() ) {
+		return 0;
+	}
+
+	Merge_hist( mi->second, counts, &sum, &max );
+	for( i = 0; i < HBUCKETS; i++ ) {
+		total += counts[i];
+	}
+
+	return total;
+}
+
+/*
+	Return the number of threads which have recorded into the registry.
+*/
+int xapp::Metrics_registry::Get_thread_count( ) {
+	std::lock_guard<std::mutex> lk( gate );
+	return (int) blocks.size();
+}
+
+// ------- flush and exposition ---------------------------------------
+
+/*
+	Aggregate every series and send them using the metrics message. Counters,
+	and the count and sum of histograms, are totals since the start; histogram
+	percentiles are for the samples recorded since the previous flush, and the
+	max is the largest ever seen. When the series do not fit in one payload
+	they are split over as many messages as needed, each a complete json
+	document. Returns false if any send failed.
+*/
+bool xapp::Metrics_registry::Flush( Metrics& m ) {
+	unsigned long counts[HBUCKETS];
+	unsigned long delta[HBUCKETS];
+	unsigned long total;
+	unsigned long ntotal;
+	unsigned long sum;
+	unsigned long max;
+	unsigned int i;
+	unsigned int b;
+	int		j;
+	bool	state = true;
+
+	{
+		std::lock_guard<std::mutex> lk( gate );
+
+		for( i = 0; i < counter_names.size(); i++ ) {
+			total = 0;
+			for( b = 0; b < blocks.size(); b++ ) {
+				total += blocks[b]->counters[i].load( std::memory_order_relaxed );
+			}
+			push_bounded( m, counter_names[i], (double) total, &state );
+		}
+
+		for( i = 0; i < gauge_names.size(); i++ ) {
+			push_bounded( m, gauge_names[i], gauges[i].load( std::memory_order_relaxed ), &state );
+		}
+
+		for( i = 0; i < hist_names.size(); i++ ) {
+			Merge_hist( i, counts, &sum, &max );
+			total = 0;
+			ntotal = 0;
+			for( j = 0; j < HBUCKETS; j++ ) {
+				delta[j] = counts[j] - hist_prev[i][j];
+				total += counts[j];
+				ntotal += delta[j];
+				hist_prev[i][j] = counts[j];
+			}
+
+			push_bounded( m, hist_names[i] + "_count", (double) total, &state );
+			push_bounded( m, hist_names[i] + "_sum", (double) sum, &state );
+			push_bounded( m, hist_names[i] + "_p50", (double) percentile( delta, ntotal, max, 50.0 ), &state );
+			push_bounded( m, hist_names[i] + "_p90", (double) percentile( delta, ntotal, max, 90.0 ), &state );
+			push_bounded( m, hist_names[i] + "_p99", (double) percentile( delta, ntotal, max, 99.0 ), &state );
+			push_bounded( m, hist_names[i] + "_max", (double) max, &state );
+		}
+	}
+
+	if( ! m.Send( ) ) {
+		state = false;
+	}
+
+	return state;
+}
+
+/*
+	Flush thread: send the aggregate every period_ms until stopped.
+*/
+void xapp::Metrics_registry::Flusher( std::shared_ptr<Metrics> m, int period_ms ) {
+	int		waited;
+
+	while( ok_2_run ) {
+		for( waited = 0; ok_2_run && waited < period_ms; waited += 100 ) {		// short naps so stop is timely
+			std::this_thread::sleep_for( std::chrono::milliseconds( period_ms - waited < 100 ? period_ms - waited : 100 ) );
+		}
+
+		if( ok_2_run ) {
+			Flush( *m );
+		}
+	}
+}
+
+/*
+	Start a thread which sends the aggregated metrics every period_ms using
+	the metrics instance (allocated by the xAPP with Alloc_metrics()). Returns
+	false if a flusher is already running.
+*/
+bool xapp::Metrics_registry::Start_flush( std::shared_ptr<Metrics> m, int period_ms ) {
+	std::lock_guard<std::mutex> lk( gate );
+
+	if( flusher != NULL || m == NULL ) {
+		return false;
+	}
+	if( period_ms < 100 ) {
+		period_ms = 100;
+	}
+
+	ok_2_run = true;
+	flusher = new std::thread( &Metrics_registry::Flusher, this, m, period_ms );
+	return true;
+}
+
+/*
+	Build the Prometheus text exposition (version 0.0.4) for all series.
+	Histogram buckets are given at each power of two, cumulative as
+	Prometheus expects, up to the largest one with a sample.
+*/
+std::string xapp::Metrics_registry::Prometheus_text( ) {
+	std::string	out = "";
+	std::string pn;
+	char	wbuf[256];
+	unsigned long counts[HBUCKETS];
+	unsigned long total;
+	unsigned long cum;
+	unsigned long sum;
+	unsigned long max;
+	unsigned int i;
+	unsigned int b;
+	int		j;
+
+	std::lock_guard<std::mutex> lk( gate );
+
+	for( i = 0; i < counter_names.size(); i++ ) {
+		total = 0;
+		for( b = 0; b < blocks.size(); b++ ) {
+			total += blocks[b]->counters[i].load( std::memory_order_relaxed );
+		}
+		pn = prom_name( counter_names[i] );
+		snprintf( wbuf, sizeof( wbuf ), " counter\n%s %lu\n", pn.c_str(), total );
+		out += "# TYPE " + pn + wbuf;
+	}
+
+	for( i = 0; i < gauge_names.size(); i++ ) {
+		pn = prom_name( gauge_names[i] );
+		snprintf( wbuf, sizeof( wbuf ), " gauge\n%s %.17g\n", pn.c_str(), gauges[i].load( std::memory_order_relaxed ) );
+		out += "# TYPE " + pn + wbuf;
+	}
+
+	for( i = 0; i < hist_names.size(); i++ ) {
+		Merge_hist( i, counts, &sum, &max );
+		total = 0;
+		for( j = 0; j < HBUCKETS; j++ ) {
+			total += counts[j];
+		}
+
+		pn = prom_name( hist_names[i] );
+		out += "# TYPE " + pn + " histogram\n";
+		cum = 0;
+		for( j = 0; j < HBUCKETS - 1 && cum < total; j++ ) {
+			cum += counts[j];
+			if( (j & (HSUB - 1)) == HSUB - 1 ) {
+				snprintf( wbuf, sizeof( wbuf ), "%s_bucket{le=\"%lu\"} %lu\n", pn.c_str(), Bucket_max( j ), cum );
+				out += wbuf;
+			}
+		}
+		snprintf( wbuf, sizeof( wbuf ), "%s_bucket{le=\"+Inf\"} %lu\n%s_sum %lu\n%s_count %lu\n",
+			pn.c_str(), total, pn.c_str(), sum, pn.c_str(), total );
+		out += wbuf;
+	}
+
+	return out;
+}
+
+/*
+	Exposition thread: answer every request on the socket with the text
+	exposition. The request itself is not interpreted. Reads and writes on
+	the accepted connection time out so that a scraper which connects and
+	goes quiet cannot hold the thread (and Stop()) for more than a second.
+*/
+void xapp::Metrics_registry::Exposer( ) {
+	struct pollfd pfd;
+	struct timeval tv;
+	char	rbuf[4096];
+	char	hbuf[256];
+	std::string body;
+	int		fd;
+	int		hlen;
+
+	pfd.fd = expose_fd;
+	pfd.events = POLLIN;
+
+	while( ok_2_run ) {
+		if( poll( &pfd, 1, 250 ) <= 0 ) {					// timeout lets us see a stop
+			continue;
+		}
+
+		if( (fd = accept( expose_fd, NULL, NULL )) < 0 ) {
+			continue;
+		}
+
+		tv.tv_sec = 1;
+		tv.tv_usec = 0;
+		setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+		setsockopt( fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof( tv ) );
+
+		if( read( fd, rbuf, sizeof( rbuf ) ) > 0 ) {			// one read; requests are small and we ignore them
+			body = Prometheus_text();
+			hlen = snprintf( hbuf, sizeof( hbuf ),
+				"HTTP/1.1 200 OK\r\n"
+				"Content-Type: text/plain; version=0.0.4\r\n"
+				"Content-Length: %d\r\n"
+				"Connection: close\r\n\r\n", (int) body.size() );
+
+			if( ! write_all( fd, hbuf, hlen ) || ! write_all( fd, body.c_str(), body.size() ) ) {
+				fprintf( stderr, "[WARN] metrics registry: write to scraper failed: %s\n", strerror( errno ) );
+			}
+		}
+
+		close( fd );
+	}
+}
+
+/*
+	Start a thread listening on the port (all interfaces) which serves the
+	Prometheus text exposition to any request. Returns false if the port
+	cannot be bound or the exposition is already running.
+*/
+bool xapp::Metrics_registry::Start_exposition( int port ) {
+	struct sockaddr_in addr;
+	int		on = 1;
+
+	std::lock_guard<std::mutex> lk( gate );
+	if( exposer != NULL ) {
+		return false;
+	}
+
+	if( (expose_fd = socket( AF_INET, SOCK_STREAM, 0 )) < 0 ) {
+		return false;
+	}
+	setsockopt( expose_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof( on ) );
+
+	memset( &addr, 0, sizeof( addr ) );
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl( INADDR_ANY );
+	addr.sin_port = htons( port );
+	if( bind( expose_fd, (struct sockaddr *) &addr, sizeof( addr ) ) < 0 || listen( expose_fd, 16 ) < 0 ) {
+		fprintf( stderr, "[WARN] metrics registry: unable to listen on port %d: %s\n", port, strerror( errno ) );
+		close( expose_fd );
+		expose_fd = -1;
+		return false;
+	}
+
+	ok_2_run = true;
+	exposer = new std::thread( &Metrics_registry::Exposer, this );
+	return true;
+}
+
+/*
+	Stop the flush and exposition threads. Recording is not affected.
+*/
+void xapp::Metrics_registry::Stop( ) {
+	ok_2_run = false;
+
+	if( flusher != NULL ) {
+		flusher->join();
+		delete flusher;
+		flusher = NULL;
+	}
+
+	if( exposer != NULL ) {
+		exposer->join();
+		delete exposer;
+		exposer = NULL;
+	}
+
+	if( expose_fd >= 0 ) {
+		close( expose_fd );
+		expose_fd = -1;
+	}
+}
+
+
+} // namespace
@@ -0,0 +1,279 @@
+// vi: ts=4 sw=4 noet:
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	metrics_registry.hpp
+	Abstract:	Headers for the metrics registry. The registry holds named
+				counters, gauges and latency histograms which the xAPP updates
+				as things happen, and which are aggregated and sent as a single
+				metrics message on a timer (and optionally exposed in the
+				Prometheus text format) rather than the xAPP building and
+				sending a metrics message for each event.
+
+				Counters and histograms are kept per thread: each thread which
+				records a sample gets its own block of cells, written only by
+				that thread, so recording is a thread local lookup and a plain
+				add with no lock and no shared cache line. The flusher sums the
+				blocks of all threads. Histograms are log-linear (8 linear sub
+				buckets for each power of two) so the memory is fixed and the
+				error on a reported percentile is under 12.5%.
+
+	Date:		18 October 2026
+*/
+
+#ifndef _XAPP_METRICS_REGISTRY_HPP
+#define _XAPP_METRICS_REGISTRY_HPP
+
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "message.hpp"
+#include "metrics.hpp"
+
+namespace xapp {
+
+class Metrics_registry;
+
+// ------------------------------------------------------------------------
+
+/*
+	Handles returned to the xAPP when a series is added. They are small and
+	may be copied freely and used from any thread; they must not be used after
+	the registry is destroyed.
+*/
+class Counter {
+	private:
+		Metrics_registry*	reg;
+		int		idx;
+
+	public:
+		Counter( Metrics_registry* reg, int idx ) : reg( reg ), idx( idx ) { }
+
+		inline void Inc( );
+		inline void Add( unsigned long n );
+};
+
+class Gauge {
+	private:
+		Metrics_registry*	reg;
+		int		idx;
+
+	public:
+		Gauge( Metrics_registry* reg, int idx ) : reg( reg ), idx( idx ) { }
+
+		inline void Set( double value );
+};
+
+class Histogram {
+	private:
+		Metrics_registry*	reg;
+		int		idx;
+
+	public:
+		Histogram( Metrics_registry* reg, int idx ) : reg( reg ), idx( idx ) { }
+
+		inline void Record( unsigned long value );
+};
+
+// ------------------------------------------------------------------------
+
+class Metrics_registry {
+	public:
+		static const int MAX_COUNTERS = 256;		// series capacity; adds past these go to a discard slot
+		static const int MAX_GAUGES = 64;
+		static const int MAX_HISTOGRAMS = 32;
+
+		static const int HSUB_BITS = 3;				// histogram: 2^HSUB_BITS linear buckets per power of two
+		static const int HSUB = 1 << HSUB_BITS;
+		static const int HMAX_EXP = 40;				// values >= 2^HMAX_EXP land in the overflow bucket
+		static const int HBUCKETS = ((HMAX_EXP - HSUB_BITS + 1) * HSUB) + 1;
+
+	private:
+		/*
+			The cells for one histogram in one thread.
+		*/
+		typedef struct {
+			std::atomic<unsigned long> counts[HBUCKETS];
+			std::atomic<unsigned long> sum;
+			std::atomic<unsigned long> max;
+		} hist_cells_t;
+
+		/*
+			A thread's cells. Written only by the owning thread; read by the
+			flusher. The +1 is the discard slot used by handles for series
+			which could not be added.
+		*/
+		typedef struct {
+			std::atomic<unsigned long> counters[MAX_COUNTERS+1];
+			std::atomic<hist_cells_t*> hists[MAX_HISTOGRAMS+1];		// allocated on the thread's first record
+		} block_t;
+
+		/*
+			Each thread caches the block for the registry it used last, and
+			keeps the blocks for all registries it has recorded into so that
+			alternating between registries does not attach it again. The id
+			is unique to a registry instance and never reused.
+		*/
+		typedef struct {
+			long		reg_id;
+			block_t*	block;
+		} tl_cache_t;
+
+		static thread_local tl_cache_t tl_cache;
+		static thread_local std::map<long,block_t*> tl_blocks;
+		static std::atomic<long> next_id;
+
+		long	id;
+		std::mutex gate;							// protects everything but the cells
+		std::vector<block_t*> blocks;				// one per thread which has recorded
+		std::atomic<double> gauges[MAX_GAUGES+1];
+
+		std::map<std::string,int> cnames;			// name to index maps
+		std::map<std::string,int> gnames;
+		std::map<std::string,int> hnames;
+		std::vector<std::string> counter_names;		// index to name
+		std::vector<std::string> gauge_names;
+		std::vector<std::string> hist_names;
+		std::vector<unsigned long*> hist_prev;		// merged counts at the last flush, for interval percentiles
+
+		std::atomic<bool> ok_2_run;
+		std::thread* flusher = NULL;
+		std::thread* exposer = NULL;
+		int		expose_fd = -1;
+
+		// copy and assignment are PRIVATE; handles point at the instance
+		Metrics_registry( const Metrics_registry& soi );
+		Metrics_registry& operator=( const Metrics_registry& soi );
+
+		block_t* Attach_thread( );
+		hist_cells_t* Alloc_hist( block_t* b, int hidx );
+		void Merge_hist( int hidx, unsigned long* counts, unsigned long* sum, unsigned long* max );
+		void Flusher( std::shared_ptr<Metrics> m, int period_ms );
+		void Exposer( );
+
+	public:
+		Metrics_registry( );
+		~Metrics_registry( );
+
+		static Metrics_registry& Get_registry( );		// the process wide registry
+
+		Counter Add_counter( const std::string& name );
+		Gauge Add_gauge( const std::string& name );
+		Histogram Add_histogram( const std::string& name );
+
+		unsigned long Get_counter( const std::string& name );		// aggregated values
+		double Get_gauge( const std::string& name );
+		double Get_percentile( const std::string& name, double pct );
+		unsigned long Get_hist_count( const std::string& name );
+		int Get_thread_count( );									// threads which have recorded
+
+		bool Flush( Metrics& m );
+		bool Start_flush( std::shared_ptr<Metrics> m, int period_ms );
+		std::string Prometheus_text( );
+		bool Start_exposition( int port );
+		void Stop( );
+
+		/*
+			Map a value to its histogram bucket, and a bucket to the largest
+			value which maps to it.
+		*/
+		static inline int Bucket( unsigned long value ) {
+			int e;
+
+			if( value < (unsigned long) HSUB ) {
+				return (int) value;
+			}
+
+			e = 63 - __builtin_clzl( value );
+			if( e >= HMAX_EXP ) {
+				return HBUCKETS - 1;
+			}
+
+			return ((e - HSUB_BITS + 1) << HSUB_BITS) + (int) ((value >> (e - HSUB_BITS)) & (HSUB - 1));
+		}
+
+		static unsigned long Bucket_max( int bucket );
+
+	private:
+		/*
+			Return the calling thread's cells, attaching the thread if this is
+			the first sample it has recorded for this registry.
+		*/
+		inline block_t* Get_block( ) {
+			if( tl_cache.reg_id == id ) {
+				return tl_cache.block;
+			}
+
+			return Attach_thread( );
+		}
+
+		friend class Counter;
+		friend class Gauge;
+		friend class Histogram;
+};
+
+// ---- recording; these are the hot paths -------------------------------
+
+/*
+	The cells have a single writer so the add does not need a locked
+	instruction; the atomic type only keeps the flusher's read whole.
+*/
+inline void Counter::Add( unsigned long n ) {
+	std::atomic<unsigned long>* c;
+
+	c = &reg->Get_block()->counters[idx];
+	c->store( c->load( std::memory_order_relaxed ) + n, std::memory_order_relaxed );
+}
+
+inline void Counter::Inc( ) {
+	Add( 1 );
+}
+
+inline void Gauge::Set( double value ) {
+	reg->gauges[idx].store( value, std::memory_order_relaxed );
+}
+
+inline void Histogram::Record( unsigned long value ) {
+	Metrics_registry::block_t*	b;
+	Metrics_registry::hist_cells_t*	h;
+	std::atomic<unsigned long>* c;
+
+	b = reg->Get_block();
+	if( (h = b->hists[idx].load( std::memory_order_relaxed )) == NULL ) {
+		h = reg->Alloc_hist( b, idx );
+	}
+
+	c = &h->counts[Metrics_registry::Bucket( value )];
+	c->store( c->load( std::memory_order_relaxed ) + 1, std::memory_order_relaxed );
+	h->sum.store( h->sum.load( std::memory_order_relaxed ) + value, std::memory_order_relaxed );
+	if( value > h->max.load( std::memory_order_relaxed ) ) {
+		h->max.store( value, std::memory_order_relaxed );
+	}
+}
+
+} // namespace
+
+#endif
@@ -20,8 +20,10 @@ namespace xapp
 {
 	void cpprestclient::SetbaseUrl(std::string url)
 	{
+		std::lock_guard<std::mutex> lk(pool_gate);
 		this->baseUrl = utility::conversions::to_string_t(url);
 		this->Baseurl = url;
+		pool = nullptr;		//next async call connects to the new base url
 	}
 	cpprestclient::cpprestclient(std::string base_url) {
 		this->baseUrl = utility::conversions::to_string_t(base_url);
@@ -179,10 +181,9 @@ namespace xapp
 	{
 		int status_code=0;
 		auto delJson = pplx::create_task([&]() {
-			web::uri_builder uri(this->baseUrl + utility::conversions::to_string_t(path));
+			web::uri_builder uri(this->baseUrl + utility::conversions::to_string_t(path + Id));	//the Id is the last part of the path, as in do_del_async
 			auto addr = uri.to_uri().to_string();
 			web::http::client::http_client client(addr);
-			addr.append(utility::conversions::to_string_t(Id));
 			//ucout << utility::string_t(U("making requests at: ")) << addr << std::endl;
 			return client.request(web::http::methods::DEL);
 		})
@@ -343,10 +344,9 @@ namespace xapp
 		res.status_code = 0;
 		res.body = utility::conversions::to_string_t("");
 		auto delJson = pplx::create_task([&]() {
-			web::uri_builder uri(this->baseUrl + utility::conversions::to_string_t(path));
+			web::uri_builder uri(this->baseUrl + utility::conversions::to_string_t(path + Id));	//the Id is the last part of the path, as in do_del_async
 			auto addr = uri.to_uri().to_string();
 			web::http::client::http_client client(addr);
-			addr.append(utility::conversions::to_string_t(Id));
 			//ucout << utility::string_t(U("making requests at: ")) << addr << std::endl;
 			return client.request(web::http::methods::DEL);
 		})
@@ -417,6 +417,106 @@ namespace xapp
 		}
 		return res;
 	}
-}
-
 
+	/*
+		The pooled client is created on first use and kept for the life of the
+		object (or until the base url changes). cpprest keeps the connections
+		of a client open between requests, so async calls do not pay for a
+		connect and handshake each time as the sync calls do.
+	*/
+	std::shared_ptr<web::http::client::http_client> cpprestclient::get_pool()
+	{
+		std::lock_guard<std::mutex> lk(pool_gate);
+		if (pool == nullptr)
+		{
+			web::http::client::http_client_config cfg;
+			cfg.set_timeout(std::chrono::seconds(30));
+			pool = std::make_shared<web::http::client::http_client>(this->baseUrl, cfg);
+		}
+		return pool;
+	}
+	/*
+		Send the request on the pooled client and build the response without
+		blocking. Transport errors give a status code of 0; a body which is not
+		json is left empty. Nothing is printed, these are meant for busy paths.
+		Rel is the path relative to the base url, used as given for all methods.
+	*/
+	pplx::task<response_t> cpprestclient::send_async(const web::http::method & mtd, const utility::string_t & rel, const utility::string_t & body)
+	{
+		web::http::http_request req(mtd);
+		req.set_request_uri(rel);
+		if (!body.empty())
+		{
+			req.set_body(body, U("application/json"));
+		}
+		auto client = get_pool();	//task holds a reference; the client outlives the request
+
+		return client->request(req).then([client](web::http::http_response response) {
+			web::http::status_code status = response.status_code();
+			return response.extract_utf8string(true).then([status](std::string s) {	//chained, the body is not waited for on a pool thread
+				response_t res;
+				res.status_code = status;
+				if (!s.empty())
+				{
+					res.body = nlohmann::json::parse(s, nullptr, false);
+					if (res.body.is_discarded())
+					{
+						res.body = nullptr;
+					}
+				}
+				return res;
+			});
+		}).then([](pplx::task<response_t> t) {	//task based continuation; sees a failure in the request or the extraction
+			try
+			{
+				return t.get();
+			}
+			catch (const std::exception& e)
+			{
+				response_t res;
+				res.status_code = 0;
+				return res;
+			}
+		});
+	}
+	std::future<response_t> cpprestclient::do_get_async(std::string path)
+	{
+		auto prom = std::make_shared<std::promise<response_t>>();
+		send_async(web::http::methods::GET, utility::conversions::to_string_t(path), U(""))
+			.then([prom](response_t res) { prom->set_value(res); });
+		return prom->get_future();
+	}
+	std::future<response_t> cpprestclient::do_post_async(const nlohmann::json & json, std::string path)
+	{
+		auto prom = std::make_shared<std::promise<response_t>>();
+		send_async(web::http::methods::POST, utility::conversions::to_string_t(path), utility::conversions::to_string_t(json.dump()))
+			.then([prom](response_t res) { prom->set_value(res); });
+		return prom->get_future();
+	}
+	std::future<response_t> cpprestclient::do_del_async(std::string Id, std::string path)
+	{
+		auto prom = std::make_shared<std::promise<response_t>>();
+		send_async(web::http::methods::DEL, utility::conversions::to_string_t(path + Id), U(""))
+			.then([prom](response_t res) { prom->set_value(res); });
+		return prom->get_future();
+	}
+	/*
+		Callback flavours; the callback is driven on a cpprest worker thread
+		when the response (or an error) arrives and must not block.
+	*/
+	void cpprestclient::do_get_async(std::string path, response_cb cb)
+	{
+		send_async(web::http::methods::GET, utility::conversions::to_string_t(path), U(""))
+			.then([cb](response_t res) { cb(res); });
+	}
+	void cpprestclient::do_post_async(const nlohmann::json & json, std::string path, response_cb cb)
+	{
+		send_async(web::http::methods::POST, utility::conversions::to_string_t(path), utility::conversions::to_string_t(json.dump()))
+			.then([cb](response_t res) { cb(res); });
+	}
+	void cpprestclient::do_del_async(std::string Id, std::string path, response_cb cb)
+	{
+		send_async(web::http::methods::DEL, utility::conversions::to_string_t(path + Id), U(""))
+			.then([cb](response_t res) { cb(res); });
+	}
+}
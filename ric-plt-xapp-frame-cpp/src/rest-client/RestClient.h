@@ -31,6 +31,9 @@
 #include<thread>
 #include <chrono>
 #include <pthread.h>
+#include <future>
+#include <memory>
+#include <mutex>
 
 
 namespace xapp
@@ -48,11 +51,18 @@ namespace xapp
 		std::string SubscriptionId;
 	}oresponse_t;
 
+	typedef std::function<void(response_t)> response_cb;
+
 	class cpprestclient
 	{
 	protected:
 		utility::string_t baseUrl;
 		std::string Baseurl;
+		//one client (and so one pool of keep-alive connections) shared by all async calls to the base url
+		std::shared_ptr<web::http::client::http_client> pool;
+		std::mutex pool_gate;
+		std::shared_ptr<web::http::client::http_client> get_pool();
+		pplx::task<response_t> send_async(const web::http::method & mtd, const utility::string_t & rel, const utility::string_t & body);
 		//utility::string_t resp_url=U("http://0.0.0.0:8080/ric/v1/subscriptions/response");
 		std::string resp_url = "http://0.0.0.0:8080/ric/v1/subscriptions/response";//default response url
 		web::http::experimental::listener::http_listener listener;
@@ -73,6 +83,15 @@ namespace xapp
 		virtual response_t do_post(const nlohmann::json & json, std::string path);
 		virtual response_t do_del(std::string Id, std::string path);
 		//virtual response_t do_post(const web::json::value & json, std::string path);
+
+		//async api calls; nothing blocks and requests share the pooled connections
+		std::future<response_t> do_get_async(std::string path);
+		std::future<response_t> do_post_async(const nlohmann::json & json, std::string path);
+		std::future<response_t> do_del_async(std::string Id, std::string path);
+		void do_get_async(std::string path, response_cb cb);
+		void do_post_async(const nlohmann::json & json, std::string path, response_cb cb);
+		void do_del_async(std::string Id, std::string path, response_cb cb);
+
 		cpprestclient(std::string base_url, std::function<void(web::http::http_request)>callback);
 		cpprestclient(std::string base_url,std::string response_url, std::function<void(web::http::http_request)>callback);
 		cpprestclient(std::string base_url);
@@ -20,7 +20,7 @@ namespace xapp
 {
  
 	pistacheserver::pistacheserver(Pistache::Address addr,std::vector<std::string> method,std::vector<bool> static_routing,std::vector<bool> dynamic_routing)
-        : httpEndpoint(std::make_shared<Pistache::Http::Endpoint>(addr))
+        : httpEndpoint(std::make_shared<Pistache::Http::Endpoint>(addr)), addr(addr)
     { 
 	this->t=new std::thread*[1];
         this->method=method;
@@ -75,8 +75,45 @@ void pistacheserver::add_dynamic_cb(std::unordered_map<int,usr_callback> cb)
 
     void pistacheserver::init(size_t thr = 2) 
     {
-       		 auto opts = Pistache::Http::Endpoint::options().threads(thr).flags(Pistache::Tcp::Options::ReuseAddr)/*.flags(Pistache::Tcp::Options::ReusePort)*/; // how many threads for the server
-       		 httpEndpoint->init(opts);
+	init(thr, 1, DEF_KEEPALIVE);
+    }
+
+    /*
+	Multi-reactor setup. Each of the nlisteners endpoints binds the same address with
+	SO_REUSEPORT so that the kernel spreads new connections across their accept loops,
+	and each runs thr/nlisteners reactor (epoll) threads. With a single listener (and
+	so the legacy init) only ReuseAddr is set, as before; another process bound to the
+	port is then an error rather than silently sharing the connections. All endpoints share the one
+	router. Connections are kept open between requests for keepalive_sec seconds so that
+	pooling clients do not pay a connect for every request.
+    */
+    void pistacheserver::init(size_t thr, size_t nlisteners, int keepalive_sec)
+    {
+		if (nlisteners < 1)
+			nlisteners = 1;
+		if (thr < nlisteners)
+			thr = nlisteners;
+		if (keepalive_sec <= 0)
+			keepalive_sec = DEF_KEEPALIVE;
+
+		Pistache::Flags<Pistache::Tcp::Options> flags = Pistache::Tcp::Options::ReuseAddr;
+		if (nlisteners > 1)
+			flags = Pistache::Tcp::Options::ReuseAddr | Pistache::Tcp::Options::ReusePort;
+
+		auto opts = Pistache::Http::Endpoint::options()
+			.threads(thr / nlisteners)
+			.flags(flags)
+			.keepaliveTimeout(std::chrono::seconds(keepalive_sec));
+
+		httpEndpoint->init(opts);
+		reactors.clear();
+		for (size_t i = 1; i < nlisteners; i++)
+		{
+			auto ep = std::make_shared<Pistache::Http::Endpoint>(addr);
+			ep->init(opts);
+			reactors.push_back(ep);
+		}
+
 		assert(route_static.size()==stat_sz && route_dynamic.size()==dyn_sz); //no of true in satatic_routing and dynamic_routig should match with size of route_static and  route_dynamic respectively. 
 
 		assert(cb_static.size()==stat_sz && cb_dynamic.size()==dyn_sz); //no of true in satatic_routing and dynamic_routig should match with size of cb_static and cb_dynamic respectively.
@@ -109,6 +146,11 @@ void pistacheserver::add_dynamic_cb(std::unordered_map<int,usr_callback> cb)
     void pistacheserver::start()
     {
 	httpEndpoint->setHandler(router.handler());
+	for (auto& ep : reactors)
+	{
+		ep->setHandler(router.handler());
+		ep->serveThreaded();
+	}
         t[0]=new std::thread(&pistacheserver::thread_start,this);
 	t[0]->detach();
     }
@@ -120,6 +162,10 @@ void pistacheserver::add_dynamic_cb(std::unordered_map<int,usr_callback> cb)
 
     void pistacheserver::shutdown()
     {
+	for (auto& ep : reactors)
+	{
+		ep->shutdown();
+	}
         httpEndpoint->shutdown();
     }
 
@@ -37,6 +37,8 @@ namespace xapp
     {
         private:
             std::shared_ptr<Pistache::Http::Endpoint> httpEndpoint;
+            Pistache::Address addr;
+            std::vector<std::shared_ptr<Pistache::Http::Endpoint>> reactors;	// extra listeners sharing the port (SO_REUSEPORT)
             Pistache::Rest::Router router;
             void setupRoutes_get(int index);
             void setupRoutes_post(int index);
@@ -66,7 +68,10 @@ namespace xapp
         		response.send(Pistache::Http::Code::Not_Found, "The requested method does not exist");
    		 }
 
+            static const int DEF_KEEPALIVE = 60;		// seconds an idle keep-alive connection is held
+
             void init(size_t thr);
+            void init(size_t thr, size_t nlisteners, int keepalive_sec);
             void setup_base_url(std::string base);
             void setup_static_route(std::unordered_map<int,std::string> route);//routing path
 	    void setup_dynamic_route(std::unordered_map<int,std::string> route);
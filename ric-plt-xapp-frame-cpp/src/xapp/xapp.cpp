@@ -90,6 +90,63 @@ void Xapp::Run( int nthreads ) {
 	delete[] tinfo;
 }
 
+/*
+	Run in dispatcher mode: nreceivers threads receive messages and queue
+	them to nworkers worker threads which drive the callbacks. The worker for
+	each message is selected by the key function (e.g. xapp::Meid_key,
+	xapp::Subid_key, or a user function which digs the key out of the
+	payload) so that messages with the same key go to the same worker. With
+	a single receiver they are processed in the order received; with more,
+	two messages with the same key taken by different receivers may be
+	queued in either order, so a second receiver should be added only when
+	per key order does not matter. Queue size and the action taken when a
+	queue is full are set with Set_dispatch_queue() before calling.
+
+	As with Run(), the last receiver runs in the calling thread and this
+	function returns only after the xapp is halted and the workers have
+	finished what was already queued.
+*/
+void Xapp::Run( int nreceivers, int nworkers, xapp::dispatch_key key_fun, void* key_data ) {
+	int i;
+	std::thread** rinfo;				// receive threads
+	std::thread** winfo;				// worker threads
+
+	if( nreceivers < 1 ) {
+		nreceivers = 1;
+	}
+	if( nworkers < 1 ) {
+		nworkers = 1;
+	}
+
+	this->Start_dispatcher( nworkers, key_fun, key_data );
+
+	winfo = new std::thread* [nworkers];
+	for( i = 0; i < nworkers; i++ ) {
+		winfo[i] = new std::thread( &Xapp::Dispatch_work, this, i );
+	}
+
+	rinfo = new std::thread* [nreceivers-1];
+	for( i = 0; i < nreceivers - 1; i++ ) {				// thread for each n-1; last runs here
+		rinfo[i] = new std::thread( &Xapp::Dispatch_listen, this );
+	}
+
+	this->Dispatch_listen();			// will return only when halted
+
+	for( i = 0; i < nreceivers - 1; i++ ) {				// receivers first so nothing more is queued
+		rinfo[i]->join();
+		delete rinfo[i];
+	}
+
+	this->Stop_dispatcher();
+	for( i = 0; i < nworkers; i++ ) {
+		winfo[i]->join();
+		delete winfo[i];
+	}
+
+	delete[] rinfo;
+	delete[] winfo;
+}
+
 /*
 	Halt the xapp. This will drive the messenger's stop function to prevent any
 	active listeners from running, and will shut things down.
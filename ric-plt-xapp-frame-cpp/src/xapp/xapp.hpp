@@ -57,6 +57,7 @@ class Xapp : public xapp::Messenger {
 		~Xapp();									// destroyer
 
 		void Run( int nthreads );					// message listen driver
+		void Run( int nreceivers, int nworkers, xapp::dispatch_key key_fun, void* key_data );	// worker pool driver
 		void Halt( );								// force to stop
 };
 
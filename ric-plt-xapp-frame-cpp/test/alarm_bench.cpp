@@ -0,0 +1,138 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	alarm_bench.cpp
+	Abstract:	Alarm storm: every one of a set of E2 nodes flaps (its alarm
+				is raised and cleared over and over, with repeated raises in
+				between). Compares the cost to the caller, and the number of
+				messages sent, when the xAPP raises and clears through an
+				Alarm (a message built and sent on every call) with doing so
+				through the alarm manager.
+
+				The RMR emulation makes a send nearly free; with the real
+				RMR each of the direct sends is also a system call on the
+				caller's thread.
+
+				Usage:
+					alarm_bench [-n nodes] [-f flaps] [-r max-rate]
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/alarm/alarm.hpp"
+#include "../src/alarm/alarm_mgr.hpp"
+#include "../src/xapp/xapp.hpp"
+
+static double mono_sec( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void report( const char* label, long calls, long sent, double elapsed ) {
+	fprintf( stdout, "%-24s %10ld calls %10ld msgs sent  %8.1f ns/call\n", label, calls, sent, (elapsed * 1000000000.0) / (double) calls );
+}
+
+int main( int argc, char** argv ) {
+	int		nnodes = 2000;
+	int		nflaps = 50;
+	int		max_rate = 1000;
+	int		opt;
+	int		i;
+	int		j;
+	long	calls;
+	long	sent;
+	double	start;
+	Xapp*	x;
+	std::vector<std::string> meids;
+	std::unique_ptr<xapp::Alarm> a;
+	std::unique_ptr<xapp::Alarm_mgr> am;
+
+	while( (opt = getopt( argc, argv, "n:f:r:" )) != -1 ) {
+		switch( opt ) {
+			case 'n':	nnodes = atoi( optarg ); break;
+			case 'f':	nflaps = atoi( optarg ); break;
+			case 'r':	max_rate = atoi( optarg ); break;
+			default:
+				fprintf( stderr, "usage: %s [-n nodes] [-f flaps] [-r max-rate]\n", argv[0] );
+				exit( 1 );
+		}
+	}
+
+	for( i = 0; i < nnodes; i++ ) {
+		meids.push_back( "e2node-" + std::to_string( i ) );
+	}
+
+	x = new Xapp( "4560", false );
+
+	// ---- direct: each raise and clear builds and sends a message ---------------------------
+	a = x->Alloc_alarm();
+	calls = 0;
+	sent = 0;
+	start = mono_sec();
+	for( j = 0; j < nflaps; j++ ) {
+		for( i = 0; i < nnodes; i++ ) {
+			a->Set_meid( meids[i] );
+			sent += a->Raise( xapp::Alarm::SEV_CRIT, 101, "E2 connection lost" );
+			sent += a->Raise( xapp::Alarm::SEV_CRIT, 101, "E2 connection lost" );		// repeated by another path
+			sent += a->Clear( xapp::Alarm::SEV_CRIT, 101, "E2 connection lost" );
+			calls += 3;
+		}
+	}
+	report( "alarm, direct", calls, sent, mono_sec() - start );
+
+	// ---- manager: state updates only; the flusher sends changes at the rate ---------------
+	am = x->Alloc_alarm_mgr( max_rate );
+	calls = 0;
+	start = mono_sec();
+	for( j = 0; j < nflaps; j++ ) {
+		for( i = 0; i < nnodes; i++ ) {
+			am->Raise( 101, meids[i], xapp::Alarm::SEV_CRIT, "E2 connection lost" );
+			am->Raise( 101, meids[i], xapp::Alarm::SEV_CRIT, "E2 connection lost" );
+			am->Clear( 101, meids[i] );
+			calls += 3;
+		}
+	}
+	report( "alarm manager", calls, am->Get_sent(), mono_sec() - start );
+	am->Stop();
+	fprintf( stdout, "%-24s %10s       %10ld msgs sent after stop; %ld absorbed\n", "", "", am->Get_sent(), am->Get_absorbed() );
+
+	am = NULL;
+	a = NULL;
+	delete x;
+
+	return 0;
+}
@@ -0,0 +1,314 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	alarm_mgr_test.cpp
+	Abstract:	Unit test for the alarm manager: absorbing repeated raises and
+				clears, the order in which raise/clear transitions are sent,
+				clear all, the rate limit, the flusher thread, and sending
+				through an alarm allocated by the framework.
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/default_cb.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/xapp/xapp.hpp"
+
+#include "../src/alarm/alarm_mgr.hpp"			// pull the code under test in directly for coverage
+#include "../src/alarm/alarm_mgr.cpp"
+
+#include "ut_support.cpp"
+
+/*
+	Sends are recorded as "A:problem:meid:severity" where A is R, C or X
+	(clear all).
+*/
+static bool record( int action, int problem, const std::string& meid, int severity,
+		const std::string& info, const std::string& add_info, void* data ) {
+
+	std::vector<std::string>* log = (std::vector<std::string> *) data;
+	const char*	a;
+
+	switch( action ) {
+		case xapp::Alarm::ACT_RAISE:	a = "R"; break;
+		case xapp::Alarm::ACT_CLEAR:	a = "C"; break;
+		default:						a = "X"; break;
+	}
+
+	if( action == xapp::Alarm::ACT_CLEAR_ALL ) {
+		log->push_back( "X" );
+	} else {
+		log->push_back( std::string( a ) + ":" + std::to_string( problem ) + ":" + meid + ":" + std::to_string( severity ) );
+	}
+
+	return true;
+}
+
+/*
+	Records like record() but fails every send while fail_sends is set.
+*/
+static bool fail_sends = false;
+
+static bool flaky( int action, int problem, const std::string& meid, int severity,
+		const std::string& info, const std::string& add_info, void* data ) {
+
+	if( fail_sends ) {
+		return false;
+	}
+
+	return record( action, problem, meid, severity, info, add_info, data );
+}
+
+/*
+	Compare the log with the expected sends (comma separated) and clear it.
+*/
+static int expect( std::vector<std::string>& log, const std::string& want, const char* what ) {
+	std::string got = "";
+	size_t	i;
+
+	for( i = 0; i < log.size(); i++ ) {
+		got += (i > 0 ? "," : "") + log[i];
+	}
+	log.clear();
+
+	if( got != want ) {
+		fprintf( stderr, "<FAIL> %s: expected (%s) got (%s)\n", what, want.c_str(), got.c_str() );
+		return 1;
+	}
+
+	return 0;
+}
+
+int main( int argc, char** argv ) {
+	int		errors = 0;
+	int		i;
+	int		j;
+	std::vector<std::string> log;
+	std::string	want;
+	xapp::Alarm_mgr*	am;
+
+	set_test_name( "alarm_mgr_test" );
+
+	am = new xapp::Alarm_mgr( NULL, 1000 );
+	am->Set_sender( record, &log );
+
+	// ---- repeats are absorbed ---------------------------------------------------
+	errors += fail_if_false( am->Raise( 10, "meid-1", xapp::Alarm::SEV_MAJOR, "link down" ), "first raise not accepted" );
+	errors += fail_if_false( am->Is_raised( 10, "meid-1" ), "raised alarm not reported as raised" );
+	errors += fail_if( am->Raise( 10, "meid-1", xapp::Alarm::SEV_MAJOR, "link down" ), "repeated raise was not absorbed" );
+	errors += fail_if( am->Get_pending() != 1, "pending count not 1 after raise" );
+	errors += fail_if( am->Flush() != 1, "flush did not send one message" );
+	errors += expect( log, "R:10:meid-1:2", "first raise" );
+
+	errors += fail_if( am->Raise( 10, "meid-1", xapp::Alarm::SEV_MAJOR, "link down" ), "raise after send was not absorbed" );
+	errors += fail_if( am->Flush() != 0, "flush sent something for an absorbed raise" );
+	errors += expect( log, "", "absorbed raise" );
+
+	// ---- a change of severity is sent as a new raise ------------------------------------
+	errors += fail_if_false( am->Raise( 10, "meid-1", xapp::Alarm::SEV_CRIT, "link down" ), "raise with new severity not accepted" );
+	am->Flush();
+	errors += expect( log, "R:10:meid-1:1", "severity change" );
+
+	// ---- clear and raise again, with the same details, between flushes sends nothing ---------
+	errors += fail_if_false( am->Clear( 10, "meid-1" ), "clear of raised alarm not accepted" );
+	errors += fail_if( am->Is_raised( 10, "meid-1" ), "cleared alarm reported as raised" );
+	am->Raise( 10, "meid-1", xapp::Alarm::SEV_CRIT, "link down" );
+	am->Flush();
+	errors += expect( log, "", "clear then raise before flush" );
+
+	// ---- but with different details the raise is sent ------------------------------------
+	am->Clear( 10, "meid-1" );
+	am->Raise( 10, "meid-1", xapp::Alarm::SEV_MINOR, "link down" );
+	am->Flush();
+	errors += expect( log, "R:10:meid-1:3", "clear then raise with new severity" );
+
+	// ---- clear is sent; clear of a clear alarm is absorbed -----------------------------------
+	am->Clear( 10, "meid-1" );
+	errors += fail_if( am->Clear( 10, "meid-1" ), "second clear was not absorbed" );
+	am->Flush();
+	errors += expect( log, "C:10:meid-1:3", "clear" );
+	errors += fail_if( am->Clear( 10, "meid-1" ), "clear of unknown alarm not absorbed" );
+
+	// ---- raise and clear between flushes is never sent ---------------------------------------
+	am->Raise( 11, "meid-2", xapp::Alarm::SEV_WARN, "flap" );
+	am->Clear( 11, "meid-2" );
+	am->Raise( 11, "meid-2", xapp::Alarm::SEV_WARN, "flap" );
+	am->Clear( 11, "meid-2" );
+	am->Flush();
+	errors += expect( log, "", "raise/clear before flush" );
+
+	// ---- transitions are sent in the order that alarms first changed ------------------------
+	am->Raise( 1, "a", xapp::Alarm::SEV_WARN, "" );
+	am->Raise( 1, "b", xapp::Alarm::SEV_WARN, "" );
+	am->Raise( 2, "a", xapp::Alarm::SEV_WARN, "" );			// same meid, different problem is a different alarm
+	am->Raise( 1, "a", xapp::Alarm::SEV_MAJOR, "" );		// already queued; keeps its place
+	am->Flush();
+	errors += expect( log, "R:1:a:2,R:1:b:4,R:2:a:4", "order of raises" );
+
+	am->Clear( 1, "b" );
+	am->Clear( 2, "a" );
+	am->Clear( 1, "a" );
+	am->Flush();
+	errors += expect( log, "C:1:b:4,C:2:a:4,C:1:a:2", "order of clears" );
+
+	// ---- clear all goes before anything raised after it; pending alarms are dropped ----------
+	am->Raise( 3, "c", xapp::Alarm::SEV_WARN, "" );
+	am->Clear_all();
+	errors += fail_if( am->Is_raised( 3, "c" ), "alarm reported raised after clear all" );
+	am->Raise( 3, "d", xapp::Alarm::SEV_WARN, "" );
+	errors += fail_if( am->Get_pending() != 2, "pending count not 2 after clear all and raise" );
+	am->Flush();
+	errors += expect( log, "X,R:3:d:4", "clear all ordering" );
+	am->Clear( 3, "d" );
+	am->Flush();
+	log.clear();
+	delete am;
+
+	// ---- rate limit: the burst is sent, the rest stays queued in order until stop -------------
+	am = new xapp::Alarm_mgr( NULL, 10 );
+	am->Set_sender( record, &log );
+	want = "";
+	for( i = 0; i < 50; i++ ) {
+		am->Raise( 7, "node-" + std::to_string( i ), xapp::Alarm::SEV_MAJOR, "storm" );
+		want += (i > 0 ? "," : "") + std::string( "R:7:node-" ) + std::to_string( i ) + ":2";
+	}
+	errors += fail_if( am->Flush() != 10, "rate limited flush did not send the burst" );
+	errors += fail_if( am->Get_pending() != 40, "rate limited flush did not leave 40 pending" );
+	am->Stop();												// final state is sent regardless of rate
+	errors += fail_if( am->Get_pending() != 0, "stop did not send everything pending" );
+	errors += fail_if( am->Get_sent() != 50, "sent count after stop not 50" );
+	errors += expect( log, want, "rate limited sends" );
+	delete am;
+
+	// ---- storm with the flusher running: every node ends raised, nothing out of order ---------
+	am = new xapp::Alarm_mgr( NULL, 100000 );
+	am->Set_sender( record, &log );
+	am->Start( 1 );
+	errors += fail_if( am->Start( 1 ), "second start did not fail" );
+	for( j = 0; j < 50; j++ ) {
+		for( i = 0; i < 200; i++ ) {
+			am->Raise( 9, "e2-" + std::to_string( i ), xapp::Alarm::SEV_CRIT, "e2 node down" );
+			if( j < 49 ) {
+				am->Clear( 9, "e2-" + std::to_string( i ) );
+			}
+		}
+	}
+	am->Stop();
+	errors += fail_if( (long) log.size() != am->Get_sent(), "log size and sent count differ" );
+	errors += fail_if( am->Get_sent() > 50 * 200 * 2, "storm sent more than the transitions" );
+	for( i = 0; i < 200; i++ ) {						// the last word on each node must be a raise
+		std::string rn = "R:9:e2-" + std::to_string( i ) + ":1";
+		std::string cn = "C:9:e2-" + std::to_string( i ) + ":1";
+
+		for( j = (int) log.size() - 1; j >= 0; j-- ) {
+			if( log[j] == rn || log[j] == cn ) {
+				break;
+			}
+		}
+		if( j < 0 || log[j] != rn ) {
+			errors++;
+			fprintf( stderr, "<FAIL> storm: node e2-%d did not end raised\n", i );
+			break;
+		}
+	}
+	fprintf( stderr, "<INFO> storm: %ld sent for %d transitions, %ld absorbed\n", am->Get_sent(), 50 * 200 * 2 - 200, am->Get_absorbed() );
+	log.clear();
+	delete am;
+
+	// ---- the flusher sends without an explicit flush -----------------------------------------
+	am = new xapp::Alarm_mgr( NULL, 0 );					// default rate
+	am->Set_sender( record, &log );
+	am->Start( 0 );
+	am->Raise( 5, "meid-5", xapp::Alarm::SEV_WARN, "info", "more info" );
+	for( i = 0; i < 100 && am->Get_sent() == 0; i++ ) {
+		usleep( 10000 );
+	}
+	errors += fail_if( am->Get_sent() != 1, "flusher did not send the raise" );
+	errors += expect( log, "R:5:meid-5:4", "flusher send" );
+	delete am;
+
+	// ---- through the framework; sends go via the alarm's wormhole ----------------------------
+	auto x = new Xapp( "4560", false );
+	std::unique_ptr<xapp::Alarm_mgr> fam = x->Alloc_alarm_mgr( 100 );
+	fam->Raise( 15, "meid-x", xapp::Alarm::SEV_CRIT, "framework" );
+	fam->Clear_all();
+	fam->Raise( 16, "meid-x", xapp::Alarm::SEV_CRIT, "framework" );
+	fam->Clear( 16, "meid-y" );
+	fam->Stop();
+	errors += fail_if( fam->Get_sent() != 2, "framework manager did not send clear all and raise" );
+	errors += fail_if( fam->Get_failed() != 0, "framework manager reported failed sends" );
+	fam = NULL;
+
+	// ---- a failed send is not taken as told; it stays queued and is sent again -------
+	am = new xapp::Alarm_mgr( NULL, 1000 );
+	am->Set_sender( flaky, &log );
+	std::string maj = std::to_string( xapp::Alarm::SEV_MAJOR );
+	am->Raise( 20, "f", xapp::Alarm::SEV_MAJOR, "a" );
+	am->Raise( 21, "f", xapp::Alarm::SEV_MAJOR, "b" );
+	fail_sends = true;
+	errors += fail_if( am->Flush() != 0, "flush reported sends which failed" );
+	errors += fail_if( am->Get_failed() != 2, "failed sends not counted" );
+	errors += fail_if( am->Get_pending() != 2, "alarms whose send failed were not requeued" );
+	fail_sends = false;
+	errors += fail_if( am->Flush() != 2, "requeued alarms were not sent on the next flush" );
+	errors += expect( log, "R:20:f:" + maj + ",R:21:f:" + maj, "requeued alarms not sent in order" );
+	errors += fail_if( am->Flush() != 0, "alarms sent again after a good send" );
+
+	am->Clear( 20, "f" );
+	fail_sends = true;
+	am->Flush();
+	errors += fail_if( am->Get_pending() != 1, "clear whose send failed was not requeued" );
+	fail_sends = false;
+	am->Flush();
+	errors += expect( log, "C:20:f:" + maj, "clear whose send failed not sent again" );
+
+	am->Clear_all();
+	fail_sends = true;
+	am->Flush();
+	errors += fail_if( am->Get_pending() != 1, "clear all whose send failed was not kept" );
+	fail_sends = false;
+	am->Flush();
+	errors += expect( log, "X", "clear all whose send failed not sent again" );
+	delete am;
+
+	am = new xapp::Alarm_mgr( NULL, 10 );				// no alarm and no sender: sends fail
+	am->Raise( 1, "m", xapp::Alarm::SEV_WARN, "" );
+	am->Stop();
+	errors += fail_if( am->Get_failed() != 1, "send without alarm or sender not counted as failed" );
+	delete am;
+
+	delete x;
+
+	announce_results( errors );
+	return !!errors;
+}
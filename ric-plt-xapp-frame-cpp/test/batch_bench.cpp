@@ -0,0 +1,181 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	batch_bench.cpp
+	Abstract:	Compares messages per CPU second for the single message
+				receive/reply paths with the batch paths: the listener driving
+				a callback which replies to each message against the listener
+				driving a batch callback which replies with Reply_batch(), and
+				a polling loop using Receive()/Reply() against one using
+				Receive_batch()/Reply_batch().
+
+				The RMR emulation makes a receive nearly free, so these show
+				the framework's own per message cost. Linked with the real RMR,
+				the batch receive also avoids the semaphore wait that every
+				blocking receive does, as the ring is drained with zero
+				timeout polls once the first message has arrived.
+
+				Usage:
+					batch_bench [-n msgs] [-b batch-size]
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <memory>
+
+#include <rmr/RIC_message_types.h>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/xapp/xapp.hpp"
+
+typedef struct {
+	Xapp*	x;
+	long	nmsgs;
+	long	count;
+} bench_t;
+
+static double cpu_sec( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts );
+	return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void report( const char* label, long count, double cpu ) {
+	fprintf( stdout, "%-28s %10ld msgs  %8.3f cpu-s  %12.0f msgs/cpu-s\n", label, count, cpu, (double) count / cpu );
+}
+
+void reply_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	bench_t*	bd = (bench_t *) data;
+
+	m.Reply();
+	if( ++bd->count >= bd->nmsgs ) {
+		bd->x->Halt();
+	}
+}
+
+void batch_reply_cb( xapp::Message** msgs, int nmsgs, void* data ) {
+	bench_t*	bd = (bench_t *) data;
+
+	bd->x->Reply_batch( msgs, nmsgs );
+	bd->count += nmsgs;
+	if( bd->count >= bd->nmsgs ) {
+		bd->x->Halt();
+	}
+}
+
+/*
+	Run the listener with either the per message or the batch callback.
+*/
+static void listen( const char* label, long nmsgs, int batch_size ) {
+	bench_t	bd;
+	double	start;
+
+	memset( &bd, 0, sizeof( bd ) );
+	bd.x = new Xapp( "4560", false );
+	bd.nmsgs = nmsgs;
+
+	if( batch_size > 0 ) {
+		bd.x->Add_batch_cb( batch_reply_cb, &bd, batch_size );
+	} else {
+		bd.x->Add_msg_cb( bd.x->DEFAULT_CALLBACK, reply_cb, &bd, true );
+		bd.x->Add_msg_cb( RIC_HEALTH_CHECK_REQ, reply_cb, &bd, true );
+	}
+
+	start = cpu_sec();
+	bd.x->Listen();
+	report( label, bd.count, cpu_sec() - start );
+
+	delete bd.x;
+}
+
+int main( int argc, char** argv ) {
+	long	nmsgs = 5000000;
+	int		batch_size = 32;
+	int		opt;
+	int		i;
+	long	count;
+	double	start;
+	Xapp*	x;
+	std::unique_ptr<xapp::Message> msg;
+	std::unique_ptr<xapp::Message>* bmsgs;
+	xapp::Message**	batch;
+
+	while( (opt = getopt( argc, argv, "n:b:" )) != -1 ) {
+		switch( opt ) {
+			case 'n':	nmsgs = atol( optarg ); break;
+			case 'b':	batch_size = atoi( optarg ); break;
+			default:
+				fprintf( stderr, "usage: %s [-n msgs] [-b batch-size]\n", argv[0] );
+				exit( 1 );
+		}
+	}
+	if( batch_size < 1 ) {
+		batch_size = 1;
+	}
+
+	fprintf( stdout, "batch size %d\n", batch_size );
+	listen( "listen, reply each", nmsgs, 0 );
+	listen( "listen batch, reply batch", nmsgs, batch_size );
+
+	// ---- polling loops -------------------------------------------------------------
+	x = new Xapp( "4560", false );
+	msg = x->Alloc_msg( 2048 );
+	start = cpu_sec();
+	for( count = 0; count < nmsgs; count++ ) {
+		if( x->Receive( *msg, 100 ) ) {
+			msg->Reply();
+		}
+	}
+	report( "receive, reply each", count, cpu_sec() - start );
+
+	bmsgs = new std::unique_ptr<xapp::Message>[batch_size];
+	batch = new xapp::Message*[batch_size];
+	for( i = 0; i < batch_size; i++ ) {
+		bmsgs[i] = x->Alloc_msg( 2048 );
+		batch[i] = bmsgs[i].get();
+	}
+
+	start = cpu_sec();
+	count = 0;
+	while( count < nmsgs ) {
+		i = x->Receive_batch( batch, batch_size, 100 );
+		x->Reply_batch( batch, i );
+		count += i;
+	}
+	report( "receive batch, reply batch", count, cpu_sec() - start );
+
+	delete[] batch;
+	delete[] bmsgs;
+	msg = NULL;
+	delete x;
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	cb_dispatch_bench.cpp
+	Abstract:	Measures the cost of selecting the callback for a message.
+				The callback table lookup is compared with the map search the
+				listener used to make (find the type, else find the default),
+				using a set of types typical of an xApp (health check, E2 and
+				A1 types, one very large type) and a mix of registered and
+				unregistered types. The listener is then run with the RMR
+				emulation and a borrowing callback which does nothing, giving
+				the framework overhead per message.
+
+				Usage:
+					cb_dispatch_bench [-n lookups] [-m msgs]
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+
+#include <rmr/RIC_message_types.h>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/xapp/xapp.hpp"
+
+static long now_ns( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (ts.tv_sec * 1000000000L) + ts.tv_nsec;
+}
+
+typedef struct {
+	Xapp*	x;
+	long	nmsgs;
+	long	count;
+} bench_t;
+
+void nothing_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	bench_t*	bd = (bench_t *) data;
+
+	if( bd != NULL && ++bd->count == bd->nmsgs ) {
+		bd->x->Halt();
+	}
+}
+
+/*
+	The lookup the listener did before the table: search for the type, and
+	if not found use the default found before the loop.
+*/
+static xapp::Callback* map_find( std::map<int,xapp::Callback*>& cbs, xapp::Callback* dcb, int mtype ) {
+	std::map<int,xapp::Callback*>::iterator mi;
+
+	if( (mi = cbs.find( mtype )) != cbs.end() ) {
+		return mi->second;
+	}
+
+	return dcb;
+}
+
+int main( int argc, char** argv ) {
+	static int reg_types[] = { 100, 101, 12010, 12011, 12012, 12020, 12021, 12022, 12040, 12041, 12050, 20010, 20011, 20012, 60000 };
+	int		ntypes = sizeof( reg_types ) / sizeof( int );
+	long	nlookups = 20000000;
+	long	nmsgs = 2000000;
+	std::map<int,xapp::Callback*> cbs;
+	xapp::Callback*	dcb;
+	xapp::Callback_table*	t;
+	xapp::Callback*	volatile sink;
+	int*	mtypes;
+	int		nmtypes = 4096;
+	int		opt;
+	int		i;
+	long	j;
+	long	start;
+	double	map_ns;
+	double	table_ns;
+	bench_t	bd;
+	Xapp*	x;
+
+	while( (opt = getopt( argc, argv, "n:m:" )) != -1 ) {
+		switch( opt ) {
+			case 'n':	nlookups = atol( optarg ); break;
+			case 'm':	nmsgs = atol( optarg ); break;
+			default:
+				fprintf( stderr, "usage: %s [-n lookups] [-m msgs]\n", argv[0] );
+				exit( 1 );
+		}
+	}
+
+	// ---- lookup only ---------------------------------------------------------------
+	for( i = 0; i < ntypes; i++ ) {
+		cbs[reg_types[i]] = new xapp::Callback( nothing_cb, NULL );
+	}
+	dcb = new xapp::Callback( nothing_cb, NULL );
+	cbs[-1] = dcb;
+
+	srand( 7 );
+	mtypes = (int *) malloc( sizeof( int ) * nmtypes );
+	for( i = 0; i < nmtypes; i++ ) {
+		if( i % 8 == 0 ) {
+			mtypes[i] = rand() % 30000;							// mostly unregistered
+		} else {
+			mtypes[i] = reg_types[rand() % ntypes];
+		}
+	}
+
+	start = now_ns();
+	for( j = 0; j < nlookups; j++ ) {
+		sink = map_find( cbs, dcb, mtypes[j & (nmtypes-1)] );
+	}
+	map_ns = (double) (now_ns() - start) / nlookups;
+
+	t = new xapp::Callback_table( cbs, -1 );
+	start = now_ns();
+	for( j = 0; j < nlookups; j++ ) {
+		sink = t->Find( mtypes[j & (nmtypes-1)] );
+	}
+	table_ns = (double) (now_ns() - start) / nlookups;
+
+	fprintf( stdout, "%d registered types, %ld lookups\n", ntypes, nlookups );
+	fprintf( stdout, "map search:     %8.2f ns/lookup\n", map_ns );
+	fprintf( stdout, "callback table: %8.2f ns/lookup\n", table_ns );
+
+	delete t;
+	free( mtypes );
+
+	// ---- listener, emulated receive, empty borrowing callback ----------------------
+	memset( &bd, 0, sizeof( bd ) );
+	x = new Xapp( "4560", false );
+	bd.x = x;
+	bd.nmsgs = nmsgs;
+	for( i = 0; i < ntypes; i++ ) {
+		x->Add_msg_cb( reg_types[i], nothing_cb, &bd, true );
+	}
+	x->Add_msg_cb( x->DEFAULT_CALLBACK, nothing_cb, &bd, true );
+
+	start = now_ns();
+	x->Listen();
+	fprintf( stdout, "listener:       %8.2f ns/message (%ld messages, includes emulated receive)\n",
+		(double) (now_ns() - start) / bd.count, bd.count );
+
+	delete x;
+	return 0;
+}
@@ -0,0 +1,152 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	cb_table_test.cpp
+	Abstract:	Unit test for the callback table: lookup of dense, sparse,
+				and unregistered types, and registration of callbacks while
+				a listener is running.
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <thread>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/default_cb.hpp"
+#include "../src/messaging/dispatcher.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/xapp/xapp.hpp"
+
+#include "../src/messaging/callback.cpp"		// pull the code under test in directly for coverage
+#include "../src/messaging/default_cb.cpp"
+#include "../src/messaging/dispatcher.cpp"
+#include "../src/messaging/message.cpp"
+#include "../src/messaging/messenger.cpp"
+#include "../src/xapp/xapp.cpp"
+
+#include "ut_support.cpp"
+
+static std::atomic<long> dflt_count( 0 );
+static std::atomic<long> late_count( 0 );
+static std::atomic<int> late_errs( 0 );
+
+void dflt_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	dflt_count++;
+}
+
+/*
+	Registered while listening; data is the type it was registered for.
+*/
+void late_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	if( mtype != (int) (long) data ) {
+		late_errs++;
+	}
+	late_count++;
+}
+
+void listener( Xapp* x ) {
+	x->Listen();
+}
+
+int main( int argc, char** argv ) {
+	int		errors = 0;
+	int		i;
+	std::map<int,xapp::Callback*> cbs;
+	xapp::Callback*	cb[5];
+	xapp::Callback_table*	t;
+	std::thread*	tinfo;
+	Xapp*	x;
+
+	set_test_name( "cb_table_test" );
+
+	for( i = 0; i < 5; i++ ) {
+		cb[i] = new xapp::Callback( dflt_cb, NULL );
+	}
+
+	// ---- lookups ------------------------------------------------------------------
+	cbs[1] = cb[0];
+	cbs[100] = cb[1];
+	cbs[xapp::Callback_table::MAX_DENSE + 10] = cb[2];			// too large for the array
+	cbs[-5] = cb[3];
+
+	t = new xapp::Callback_table( cbs, -1 );					// no default
+	errors += fail_if( t->Find( 1 ) != cb[0], "dense lookup of type 1 did not return its callback" );
+	errors += fail_if( t->Find( 100 ) != cb[1], "dense lookup of type 100 did not return its callback" );
+	errors += fail_if( t->Find( xapp::Callback_table::MAX_DENSE + 10 ) != cb[2], "sparse lookup did not return its callback" );
+	errors += fail_if( t->Find( -5 ) != cb[3], "negative type lookup did not return its callback" );
+	errors += fail_if( t->Find( 2 ) != NULL, "lookup of unregistered type without default was not nil" );
+	errors += fail_if( t->Find( 200 ) != NULL, "lookup past dense array without default was not nil" );
+	delete t;
+
+	cbs[-1] = cb[4];
+	t = new xapp::Callback_table( cbs, -1 );
+	errors += fail_if( t->Find( 1 ) != cb[0], "dense lookup with default did not return its callback" );
+	errors += fail_if( t->Find( 0 ) != cb[4], "unregistered dense type did not return default" );
+	errors += fail_if( t->Find( 99 ) != cb[4], "unregistered dense type did not return default" );
+	errors += fail_if( t->Find( 200 ) != cb[4], "type past dense array did not return default" );
+	errors += fail_if( t->Find( -7 ) != cb[4], "unregistered negative type did not return default" );
+	errors += fail_if( t->Find( xapp::Callback_table::MAX_DENSE + 10 ) != cb[2], "sparse lookup with default did not return its callback" );
+	delete t;
+
+	cbs.clear();
+	t = new xapp::Callback_table( cbs, -1 );					// empty table must be safe
+	errors += fail_if( t->Find( 1 ) != NULL, "empty table lookup was not nil" );
+	delete t;
+
+	for( i = 0; i < 5; i++ ) {
+		delete cb[i];
+	}
+
+	// ---- registration while listening ---------------------------------------------
+	x = new Xapp( "4560", false );
+	x->Add_msg_cb( x->DEFAULT_CALLBACK, dflt_cb, NULL );
+	tinfo = new std::thread( listener, x );
+
+	for( i = 0; i < 2000; i++ ) {								// replace callbacks for all types over and over
+		x->Add_msg_cb( i % 100, late_cb, (void *) (long) (i % 100) );
+		if( i % 100 == 0 ) {
+			usleep( 1000 );
+		}
+	}
+	usleep( 10000 );
+
+	x->Halt();
+	tinfo->join();
+	delete tinfo;
+
+	errors += fail_if( late_count == 0, "callbacks registered while listening were never driven" );
+	errors += fail_if( late_errs > 0, "callback registered while listening driven for wrong type" );
+	errors += fail_if( dflt_count == 0, "default callback never driven" );
+	delete x;
+
+	announce_results( errors );
+	return errors > 0;
+}
@@ -0,0 +1,136 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	config_bench.cpp
+	Abstract:	Compares the cost of reading a control value by name with
+				Get_control_value(), which takes the config lock and searches
+				the parsed json, with reading the same control through a
+				handle, for an increasing number of threads all reading at
+				once (as callbacks in a multi-threaded xApp would).
+
+				Usage:
+					config_bench [-f config-file] [-n reads] [-t max-threads]
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../src/config/config.hpp"
+
+static std::atomic<long> sink( 0 );			// keep the reads from being optimised away
+
+static long now_ns( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (ts.tv_sec * 1000000000L) + ts.tv_nsec;
+}
+
+static void by_name( xapp::Config* c, long nreads ) {
+	long	i;
+	double	total = 0;
+
+	for( i = 0; i < nreads; i++ ) {
+		total += c->Get_control_value( "measurement_interval", 0.0 );
+	}
+	sink += (long) total;
+}
+
+static void by_handle( xapp::Config::Handle<double> h, long nreads ) {
+	long	i;
+	double	total = 0;
+
+	for( i = 0; i < nreads; i++ ) {
+		total += h.Get();
+	}
+	sink += (long) total;
+}
+
+/*
+	Run nthreads readers, each doing nreads, and print the results.
+*/
+static void run( const char* label, xapp::Config* c, xapp::Config::Handle<double>* h, int nthreads, long nreads ) {
+	std::vector<std::thread*> threads;
+	long	start;
+	double	elapsed;
+	int		i;
+
+	start = now_ns();
+	for( i = 0; i < nthreads; i++ ) {
+		if( h != NULL ) {
+			threads.push_back( new std::thread( by_handle, *h, nreads ) );
+		} else {
+			threads.push_back( new std::thread( by_name, c, nreads ) );
+		}
+	}
+	for( i = 0; i < nthreads; i++ ) {
+		threads[i]->join();
+		delete threads[i];
+	}
+	elapsed = (double) (now_ns() - start);
+
+	fprintf( stdout, "%-8s threads=%-2d  %8.2f ns/read  %14.0f reads/s\n",
+		label, nthreads, elapsed / nreads, (double) (nreads * nthreads) / (elapsed / 1000000000.0) );
+}
+
+int main( int argc, char** argv ) {
+	std::string	fname = "config1.json";
+	long	nreads = 1000000;
+	int		max_threads = 8;
+	int		opt;
+	int		i;
+	xapp::Config*	c;
+
+	while( (opt = getopt( argc, argv, "f:n:t:" )) != -1 ) {
+		switch( opt ) {
+			case 'f':	fname = std::string( optarg ); break;
+			case 'n':	nreads = atol( optarg ); break;
+			case 't':	max_threads = atoi( optarg ); break;
+			default:
+				fprintf( stderr, "usage: %s [-f config-file] [-n reads] [-t max-threads]\n", argv[0] );
+				exit( 1 );
+		}
+	}
+
+	c = new xapp::Config( fname );
+	auto h = c->Get_value_handle( "measurement_interval", 0.0 );
+	if( h.Get() == 0.0 ) {
+		fprintf( stderr, "<WARN> measurement_interval not found in %s; reading defaults\n", fname.c_str() );
+	}
+
+	fprintf( stdout, "%ld reads per thread\n", nreads );
+	for( i = 1; i <= max_threads; i *= 2 ) {
+		run( "by name", c, NULL, i, nreads );
+		run( "handle", c, &h, i, nreads );
+	}
+
+	delete c;
+	return 0;
+}
@@ -66,6 +66,27 @@ void ncb( xapp::Config& c, void* data ) {
 	callback_driven = true;
 }
 
+/*
+	Write a small config with the given measurement interval for the handle
+	reload test.
+*/
+static void write_handle_config( const char* fname, int interval ) {
+	FILE*	f;
+
+	if( (f = fopen( fname, "w" )) != NULL ) {
+		fprintf( f, "{ \"controls\": { \"measurement_interval\": %d, \"debug_mode\": true }, \"version\": \"1.0.0\" }\n", interval );
+		fclose( f );
+	}
+}
+
+/*
+	Callback for the handle reload test; nothing to do, the handles are
+	updated before it is driven.
+*/
+void hcb( xapp::Config& c, void* data ) {
+	*((bool *) data) = true;
+}
+
 int main( int argc, char** argv ) {
 	int		errors = 0;
 
@@ -105,6 +126,28 @@ int main( int argc, char** argv ) {
 	auto b = c->Get_control_bool( "debug_mode" );
 	errors += fail_if( b == false, "epxected debug mode control boolean not found or had wrong value" );
 
+	// ----- handles; resolved once, then a pointer load to read ---------------------
+	auto vh = c->Get_value_handle( "measurement_interval", 0.0 );
+	errors += fail_if( vh.Get() != v, "value handle did not match control value" );
+
+	auto bh = c->Get_bool_handle( "debug_mode", false );
+	errors += fail_if( ! bh.Get(), "bool handle did not match control boolean" );
+
+	auto sh = c->Get_str_handle( "ves_collector_address", "" );
+	errors += fail_if( sh.Get().compare( c->Get_control_str( "ves_collector_address" ) ) != 0, "string handle did not match control string" );
+
+	auto mvh = c->Get_value_handle( "no-such-control", 42.0 );
+	errors += fail_if( mvh.Get() != 42.0, "value handle for missing control was not default" );
+	auto mbh = c->Get_bool_handle( "no-such-control", true );
+	errors += fail_if( ! mbh.Get(), "bool handle for missing control was not default" );
+	auto msh = c->Get_str_handle( "no-such-control", "dflt" );
+	errors += fail_if( msh.Get().compare( "dflt" ) != 0, "string handle for missing control was not default" );
+
+	errors += fail_if( vh.Get() != v, "value handle changed after more handles were added" );
+
+	xapp::Config::Handle<double> eh;										// never bound to a config
+	errors += fail_if( eh.Get() != 0.0, "unbound value handle did not return 0" );
+
 	auto cs = c->Get_contents();
 	if( fail_if( cs.empty(), "get contents returned an empty string" ) == 0 ) {
 		fprintf( stderr, "<INFO> contents from file: %s\n", cs.c_str() );
@@ -166,6 +209,39 @@ int main( int argc, char** argv ) {
 	}
 
 
+	// -------------- handles see a reloaded file ---------------------------------------
+	fprintf( stderr, "<INFO> handle reload test\n" );
+	bool	reloaded = false;
+	write_handle_config( "./handle-config.json", 100 );
+	auto hc = new xapp::Config( "./handle-config.json" );
+	auto rh = hc->Get_value_handle( "measurement_interval", 0.0 );
+	errors += fail_if( rh.Get() != 100.0, "handle value before reload was not from the file" );
+
+	hc->Set_callback( hcb, &reloaded );
+	sleep( 1 );
+	write_handle_config( "./handle-config.json", 200 );
+	for( int i = 0; i < 30 && ! reloaded; i++ ) {
+		usleep( 100000 );
+	}
+	errors += fail_if( ! reloaded, "handle config reload callback not driven" );
+	errors += fail_if( rh.Get() != 200.0, "handle value after reload was not from the new file" );
+	unlink( "./handle-config.json" );
+
+	// ------------- handles follow the file with no user function ----------------------
+	fprintf( stderr, "<INFO> handle reload without a callback function\n" );
+	write_handle_config( "./handle-config.json", 100 );
+	auto nc = new xapp::Config( "./handle-config.json" );
+	auto nh = nc->Get_value_handle( "measurement_interval", 0.0 );
+	nc->Set_callback( NULL, NULL );
+	sleep( 1 );
+	write_handle_config( "./handle-config.json", 300 );
+	for( int i = 0; i < 30 && nh.Get() != 300.0; i++ ) {
+		usleep( 100000 );
+	}
+	errors += fail_if( nh.Get() != 300.0, "handle value not reloaded when no callback function was given" );
+	unlink( "./handle-config.json" );
+
+
 	// ----- force errors where we can -----------------------------------------
 	fprintf( stderr, "<INFO> json parse errors expected to be reported now\n" );
 	c = new xapp::Config( "not-there.json" );						// json parse will fail
@@ -182,6 +258,9 @@ int main( int argc, char** argv ) {
 	s = c->Get_port( "rmr-data-out" );
 	errors += fail_if( !s.empty(), "get port from bad jsonfile returned value" );
 
+	vh = c->Get_value_handle( "measurement_interval", 999 );
+	errors += fail_if( vh.Get() != 999.0, "value handle from non-existant file wasn't default" );
+
 	// ---------------------------- end housekeeping ---------------------------
 	announce_results( cb_errors + errors );
 	return !!errors;
@@ -0,0 +1,153 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	dispatch_bench.cpp
+	Abstract:	Compares throughput of the classic listener threads (Run(n))
+				with the dispatcher worker pool (Run(r, n, ...)) when some
+				callbacks are slow. Messages are supplied by the RMR emulation
+				as fast as they are asked for, so the numbers are the
+				framework's and the callbacks' cost only.
+
+				One message type in every ten is "slow" and sleeps for the
+				given number of microseconds in the callback. A single
+				listener keeps messages in order, but every message waits
+				behind the slow ones; several listeners are faster but give
+				no ordering at all. The dispatcher keys on message type, so
+				order is kept for each type while only the types which share
+				a worker with a slow type are held up.
+
+				Usage:
+					dispatch_bench [-n msgs] [-t threads] [-s slow-us] [-q qsize] [-r receivers]
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+
+#include <rmr/RIC_message_types.h>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/dispatcher.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/xapp/xapp.hpp"
+
+typedef struct {
+	Xapp*	x;
+	long	nmsgs;
+	int		slow_us;
+	std::atomic<long> count;
+} bench_t;
+
+static long now_ns( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (ts.tv_sec * 1000000000L) + ts.tv_nsec;
+}
+
+void bench_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	bench_t*	bd = (bench_t *) data;
+
+	if( mtype % 10 == 0 ) {
+		usleep( bd->slow_us );
+	}
+
+	if( ++bd->count == bd->nmsgs ) {
+		bd->x->Halt();
+	}
+}
+
+/*
+	Run one test and print the results.
+*/
+static void run( const char* label, int nreceivers, int nthreads, int qsize, long nmsgs, int slow_us ) {
+	bench_t	bd;
+	Xapp*	x;
+	long	start;
+	double	elapsed;
+
+	memset( (void *) &bd, 0, sizeof( bd ) );
+	bd.nmsgs = nmsgs;
+	bd.slow_us = slow_us;
+
+	x = new Xapp( "4560", false );
+	bd.x = x;
+
+	x->Add_msg_cb( x->DEFAULT_CALLBACK, bench_cb, &bd, true );
+	x->Add_msg_cb( RIC_HEALTH_CHECK_REQ, bench_cb, &bd, true );		// emulation generates these too
+
+	start = now_ns();
+	if( nreceivers > 0 ) {
+		x->Set_dispatch_queue( qsize, xapp::Dispatcher::BLOCK );
+		x->Run( nreceivers, nthreads, xapp::Mtype_key, NULL );
+	} else {
+		x->Run( nthreads );
+	}
+	elapsed = (double) (now_ns() - start) / 1000000000.0;
+
+	fprintf( stdout, "%-10s threads=%-2d  %8ld msgs  %8.3f s  %10.0f msg/s  %s\n",
+		label, nthreads, bd.count.load(), elapsed, (double) bd.count / elapsed,
+		nreceivers > 0 ? "ordered per type" : (nthreads == 1 ? "ordered" : "unordered") );
+
+	delete x;
+}
+
+int main( int argc, char** argv ) {
+	long	nmsgs = 200000;
+	int		nthreads = 4;
+	int		slow_us = 100;
+	int		qsize = 1024;
+	int		nreceivers = 1;
+	int		opt;
+
+	while( (opt = getopt( argc, argv, "n:t:s:q:r:" )) != -1 ) {
+		switch( opt ) {
+			case 'n':	nmsgs = atol( optarg ); break;
+			case 't':	nthreads = atoi( optarg ); break;
+			case 's':	slow_us = atoi( optarg ); break;
+			case 'q':	qsize = atoi( optarg ); break;
+			case 'r':	nreceivers = atoi( optarg ); break;
+			default:
+				fprintf( stderr, "usage: %s [-n msgs] [-t threads] [-s slow-us] [-q qsize] [-r receivers]\n", argv[0] );
+				exit( 1 );
+		}
+	}
+
+	if( nreceivers < 1 ) {
+		nreceivers = 1;
+	}
+
+	fprintf( stdout, "%ld messages, 1 in 10 slow (%d us), %d threads\n", nmsgs, slow_us, nthreads );
+	run( "listen", 0, 1, qsize, nmsgs, slow_us );
+	run( "listen", 0, nthreads, qsize, nmsgs, slow_us );
+	run( "dispatch", nreceivers, nthreads, qsize, nmsgs, slow_us );
+
+	return 0;
+}
@@ -0,0 +1,236 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	dispatch_test.cpp
+	Abstract:	Unit test for the dispatcher (worker pool) mode. The queue is
+				exercised directly for order and full handling, then the xapp
+				is run with a receiver and a pool of workers. The key function
+				runs in the receive thread in receive order, so it stamps
+				a per key sequence number into the payload which the workers
+				verify; any reordering, or two workers running the same key
+				at once, is an error.
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/default_cb.hpp"
+#include "../src/messaging/dispatcher.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/xapp/xapp.hpp"
+
+#include "../src/messaging/callback.cpp"		// pull the code under test in directly for coverage
+#include "../src/messaging/default_cb.cpp"
+#include "../src/messaging/dispatcher.cpp"
+#include "../src/messaging/message.cpp"
+#include "../src/messaging/messenger.cpp"
+#include "../src/xapp/xapp.cpp"
+
+#include "ut_support.cpp"
+
+#define NKEYS		7
+#define TEST_MSGS	20000
+
+typedef struct {
+	Xapp*	x;
+	long	next_seq[NKEYS];			// receive side: next sequence to stamp (receive thread only)
+	long	expect[NKEYS];				// worker side: next sequence expected
+	std::atomic<int> active[NKEYS];		// callbacks running for the key; never more than 1
+	std::atomic<long> count;
+	std::atomic<int> order_errs;
+	std::atomic<int> overlap_errs;
+	int		slow_key;					// this key sleeps a bit in the callback
+} test_data_t;
+
+/*
+	Key on mtype, and stamp the sequence for the key into the payload.
+*/
+unsigned long stamp_key( xapp::Message& m, void* data ) {
+	test_data_t*	td = (test_data_t *) data;
+	long*	seq;
+	int		key;
+
+	key = m.Get_mtype() % NKEYS;
+	seq = (long *) m.Get_payload().get();
+	*seq = td->next_seq[key]++;
+
+	return (unsigned long) key;
+}
+
+void check_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	test_data_t*	td = (test_data_t *) data;
+	long	seq;
+	int		key;
+
+	key = mtype % NKEYS;
+	if( td->active[key]++ != 0 ) {
+		td->overlap_errs++;
+	}
+
+	seq = *((long *) payload.get());
+	if( seq != td->expect[key] ) {
+		td->order_errs++;
+	}
+	td->expect[key] = seq + 1;
+
+	if( key == td->slow_key ) {
+		usleep( 10 );
+	}
+
+	td->active[key]--;
+
+	if( ++td->count == TEST_MSGS ) {
+		td->x->Halt();
+	}
+}
+
+/*
+	Run the xapp in dispatcher mode with the given number of workers and
+	return the number of errors.
+*/
+static int run_pool( int nworkers, bool borrow ) {
+	test_data_t	td;
+	Xapp*	x;
+	int		errors = 0;
+	int		i;
+	std::unique_ptr<xapp::Metrics> metrics;
+
+	memset( (void *) &td, 0, sizeof( td ) );
+	for( i = 0; i < NKEYS; i++ ) {
+		td.active[i] = 0;
+	}
+	td.count = 0;
+	td.order_errs = 0;
+	td.overlap_errs = 0;
+	td.slow_key = 3;
+
+	x = new Xapp( "4560", false );
+	td.x = x;
+	x->Add_msg_cb( x->DEFAULT_CALLBACK, check_cb, &td, borrow );
+	x->Add_msg_cb( RIC_HEALTH_CHECK_REQ, check_cb, &td, borrow );	// emulation generates these too
+
+	x->Set_dispatch_queue( 64, xapp::Dispatcher::BLOCK );
+	x->Run( 1, nworkers, stamp_key, &td );					// returns after halt and drain
+
+	errors += fail_if( td.count < TEST_MSGS, "dispatcher did not process all messages" );
+	errors += fail_if( td.order_errs > 0, "dispatcher delivered messages out of order for a key" );
+	errors += fail_if( td.overlap_errs > 0, "dispatcher ran same key in two workers" );
+	errors += fail_if( x->Get_dispatch_depth() != 0, "dispatcher queues not empty after run" );
+
+	metrics = x->Alloc_metrics( );
+	x->Push_dispatch_metrics( *metrics );
+	errors += fail_if_false( metrics->Send(), "send of dispatcher metrics failed" );
+
+	if( errors ) {
+		fprintf( stderr, "<INFO> workers=%d count=%ld order=%d overlap=%d\n", nworkers, td.count.load(), td.order_errs.load(), td.overlap_errs.load() );
+	}
+
+	delete x;
+	return errors;
+}
+
+int main( int argc, char** argv ) {
+	int		errors = 0;
+	int		i;
+	int		bad;
+	rmr_mbuf_t*	mbufs[10];
+	rmr_mbuf_t*	mbuf;
+	xapp::Dispatch_queue*	q;
+	xapp::Dispatcher*	d;
+
+	set_test_name( "dispatch_test" );
+
+	// ---- queue is fifo and refuses when full --------------------------------------
+	q = new xapp::Dispatch_queue( 3 );						// should round to 4
+	errors += fail_if( q->Get_size() != 4, "queue size not rounded to power of 2" );
+	for( i = 0; i < 5; i++ ) {
+		mbufs[i] = rmr_alloc_msg( NULL, 128 );
+	}
+	for( i = 0; i < 4; i++ ) {
+		errors += fail_if_false( q->Push( mbufs[i] ), "push to non-full queue failed" );
+	}
+	errors += fail_if( q->Push( mbufs[4] ), "push to full queue did not fail" );
+	errors += fail_if( q->Get_depth() != 4, "queue depth not 4 when full" );
+
+	bad = 0;
+	for( i = 0; i < 4; i++ ) {
+		if( q->Pop() != mbufs[i] ) {
+			bad++;
+		}
+	}
+	errors += fail_if( bad > 0, "queue did not return buffers in order" );
+	errors += fail_if( q->Pop() != NULL, "pop from empty queue did not return nil" );
+
+	for( i = 0; i < 10; i++ ) {								// wrap a few times
+		q->Push( mbufs[i % 5] );
+		errors += fail_if( q->Pop() != mbufs[i % 5], "pop after wrap returned wrong buffer" );
+	}
+	errors += fail_if( q->Get_depth() != 0, "queue depth not 0 when empty" );
+
+	q->Push( mbufs[0] );									// destructor must free what is left
+	delete q;
+	for( i = 1; i < 5; i++ ) {
+		rmr_free_msg( mbufs[i] );
+	}
+
+	// ---- dispatcher drop action and drain on stop ---------------------------------
+	d = new xapp::Dispatcher( 2, 2, xapp::Dispatcher::DROP, xapp::Mtype_key, NULL );
+	for( i = 0; i < 3; i++ ) {
+		mbuf = rmr_alloc_msg( NULL, 128 );
+		if( ! d->Dispatch( 1, mbuf ) ) {
+			rmr_free_msg( mbuf );
+		}
+	}
+	errors += fail_if( d->Get_dropped() != 1, "dispatcher with drop action did not drop when full" );
+	errors += fail_if( d->Get_queue_depth( 1 ) != 2, "worker queue depth not 2" );
+	errors += fail_if( d->Get_queue_depth( 0 ) != 0, "idle worker queue depth not 0" );
+	errors += fail_if( d->Get_queue_depth( 2 ) != -1, "out of range worker depth not -1" );
+	errors += fail_if( d->Get_queue_depth() != 2, "total queue depth not 2" );
+
+	d->Stop();
+	bad = 0;
+	while( (mbuf = d->Next( 1 )) != NULL ) {				// stopped: drained, then nil
+		rmr_free_msg( mbuf );
+		bad++;
+	}
+	errors += fail_if( bad != 2, "stopped dispatcher did not drain worker queue" );
+	errors += fail_if( d->Next( 0 ) != NULL, "stopped dispatcher with empty queue did not return nil" );
+	delete d;
+
+	// ---- full runs: order is kept per key with any number of workers ----
+	errors += run_pool( 2, false );
+	errors += run_pool( 4, false );
+	errors += run_pool( 3, true );
+
+	announce_results( errors );
+	return errors > 0;
+}
@@ -0,0 +1,203 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	jhash_bench.cpp
+	Abstract:	Compares the cost of parsing json and fetching a few fields
+				using the jsmn/symtab parser (jwrapper.c) with the Jhash
+				parser, both creating a new Jhash for each document and
+				reusing one Jhash with Parse(). Documents are test.json and
+				synthetic ones: a wide object with many members, and an
+				array of records (a policy or indication list). The jwrapper
+				parser is limited to 4096 tokens so the largest document is
+				parsed only by Jhash.
+
+				Usage:
+					jhash_bench [-n iterations]
+
+	Date:		18 October 2026
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "../src/json/jwrapper.h"
+#include "../src/json/jhash.hpp"
+
+static double cpu_sec( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts );
+	return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void report( const char* doc, const char* label, long count, double cpu, size_t size ) {
+	fprintf( stdout, "%-10s %-20s %10.0f ns/doc  %8.1f MiB/s\n", doc, label,
+		(cpu * 1000000000.0) / (double) count, ((double) size * count) / (cpu * 1024.0 * 1024.0) );
+}
+
+static std::string read_file( const char* fname ) {
+	std::string rv;
+	char	rbuf[4096];
+	int		fd;
+	int		len;
+
+	if( (fd = open( fname, O_RDONLY, 0 )) < 0 ) {
+		fprintf( stderr, "<ABORT> can't open test file: %s: %s\n", fname, strerror( errno ) );
+		exit( 1 );
+	}
+
+	while( (len = read( fd, rbuf, sizeof( rbuf ) )) > 0 ) {
+		rv.append( rbuf, len );
+	}
+	close( fd );
+
+	return rv;
+}
+
+/*
+	An object with n numeric members; the last is "last".
+*/
+static std::string mk_wide( int n ) {
+	std::string rv = "{ ";
+	char	wbuf[128];
+	int		i;
+
+	for( i = 0; i < n; i++ ) {
+		snprintf( wbuf, sizeof( wbuf ), "\"field_%d\": %d.5, ", i, i );
+		rv += wbuf;
+	}
+	rv += "\"last\": \"done\" }";
+
+	return rv;
+}
+
+/*
+	An array of n records, each a small object.
+*/
+static std::string mk_records( int n ) {
+	std::string rv = "{ \"records\": [ ";
+	char	wbuf[256];
+	int		i;
+
+	for( i = 0; i < n; i++ ) {
+		snprintf( wbuf, sizeof( wbuf ), "%s{ \"ue_id\": %d, \"cell\": \"cell-%04d\", \"rsrp\": -%d.25, \"active\": %s }",
+			i > 0 ? ", " : "", i, i % 100, 60 + (i % 40), (i & 1) ? "true" : "false" );
+		rv += wbuf;
+	}
+	rv += " ], \"count\": " + std::to_string( n ) + " }";		// jwrapper needs something after the last object
+
+	return rv;
+}
+
+/*
+	Run the document through each parser; the fetch is what an xAPP would
+	do after parsing: a couple of top level fields, or the walk of the
+	records.
+*/
+static void bench( const char* doc, const std::string& json, long iters, bool with_jw ) {
+	xapp::Jhash*	jh;
+	xapp::Jhash		rjh( "{}" );
+	void*	st;
+	void*	ost;
+	double	start;
+	double	sum = 0;
+	long	i;
+	int		j;
+	int		len;
+
+	if( with_jw ) {
+		start = cpu_sec();
+		for( i = 0; i < iters; i++ ) {
+			if( (st = jw_new( json.c_str() )) != NULL ) {
+				sum += jw_value( st, "lodge_number" ) + jw_value( st, "field_7" ) + jw_value( st, "count" );
+				len = jw_array_len( st, "records" );
+				for( j = 0; j < len; j++ ) {
+					if( (ost = jw_obj_ele( st, "records", j )) != NULL ) {
+						sum += jw_value( ost, "rsrp" );
+					}
+				}
+				jw_nuke( st );
+			}
+		}
+		report( doc, "jsmn/symtab", iters, cpu_sec() - start, json.size() );
+	}
+
+	start = cpu_sec();
+	for( i = 0; i < iters; i++ ) {
+		jh = new xapp::Jhash( json.c_str() );
+		sum += jh->Value( "lodge_number" ) + jh->Value( "field_7" ) + jh->Value( "count" );
+		len = jh->Array_len( "records" );
+		for( j = 0; j < len; j++ ) {
+			if( jh->Set_blob_ele( "records", j ) ) {
+				sum += jh->Value( "rsrp" );
+				jh->Unset_blob();
+			}
+		}
+		delete jh;
+	}
+	report( doc, "jhash new each", iters, cpu_sec() - start, json.size() );
+
+	start = cpu_sec();
+	for( i = 0; i < iters; i++ ) {
+		rjh.Parse( json.c_str() );
+		sum += rjh.Value( "lodge_number" ) + rjh.Value( "field_7" ) + rjh.Value( "count" );
+		len = rjh.Array_len( "records" );
+		for( j = 0; j < len; j++ ) {
+			if( rjh.Set_blob_ele( "records", j ) ) {
+				sum += rjh.Value( "rsrp" );
+				rjh.Unset_blob();
+			}
+		}
+	}
+	report( doc, "jhash reused", iters, cpu_sec() - start, json.size() );
+
+	if( sum == 0.12345 ) {			// keep the fetches from being optimised away
+		fprintf( stdout, "\n" );
+	}
+}
+
+int main( int argc, char** argv ) {
+	long	iters = 200000;
+	int		opt;
+
+	while( (opt = getopt( argc, argv, "n:" )) != -1 ) {
+		switch( opt ) {
+			case 'n':	iters = atol( optarg ); break;
+			default:
+				fprintf( stderr, "usage: %s [-n iterations]\n", argv[0] );
+				exit( 1 );
+		}
+	}
+
+	bench( "test.json", read_file( "test.json" ), iters, true );
+	bench( "wide-1k", mk_wide( 1000 ), iters / 100, true );
+	bench( "recs-300", mk_records( 300 ), iters / 100, true );
+	bench( "recs-50k", mk_records( 50000 ), iters / 20000 + 1, false );
+
+	return 0;
+}
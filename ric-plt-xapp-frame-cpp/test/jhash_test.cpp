@@ -73,6 +73,9 @@ static char* read_jstring( char* fname ) {
 // this also tests jwrapper.c but that is built as a special object to link in
 // rather than including here.
 //
+#include "../src/json/jwrapper.h"
+#include "../src/json/jindex.hpp"
+#include "../src/json/jindex.cpp"
 #include "../src/json/jhash.hpp"
 #include "../src/json/jhash.cpp"
 
@@ -88,6 +91,9 @@ int main( int argc, char** argv ) {
 	int		i;
 	int		len;
 	int		true_count = 0;
+	void*	st;
+	std::string	big;
+	char	wbuf[128];
 
 	set_test_name( "jhash_test" );
 	jstr = read_jstring( (char *) "test.json" );			// read and parse the json
@@ -258,11 +264,75 @@ int main( int argc, char** argv ) {
 
 	delete jh;
 
-	fprintf( stderr, "<INFO> testing for failures; jwrapper error and warning messages expected\n" );
-	// ---- these shouild all fail to parse, generate warnings to stderr, and drive error handling coverage ----
-    jh = new xapp::Jhash( (char *) "{ \"bad\": [ [ 1, 2, 3 ], [ 3, 4, 5]] }" );		// drive the exception process for bad json
+	// ---- a jhash can be reused; the second parse must not see anything from the first --------
+	jh = new xapp::Jhash( (char *) "{ \"first\": 1, \"blob\": { \"inner\": 2 } }" );
+	state = jh->Set_blob( (char *) "blob" );
+	errors += fail_if( !state, "reuse: set blob on first parse failed" );
+
+	state = jh->Parse( (char *) "{ \"second\": \"two\", \"inner\": 3 }" );
+	errors += fail_if( !state, "reuse: second parse reported failure" );
+	errors += fail_if( jh->Parse_errors(), "reuse: second parse has parse errors" );
+	errors += fail_if( jh->Exists( (char *) "first" ), "reuse: field from the first parse was found after the second" );
+	errors += fail_if( jh->String( (char *) "second" ) != "two", "reuse: string from second parse was not right" );
+	errors += fail_if( jh->Value( (char *) "inner" ) != 3.0, "reuse: blob selection was not reset by parse" );
+
+	state = jh->Parse( (char *) "{ \"bad\": " );
+	errors += fail_if( state, "reuse: parse of truncated json reported success" );
+	errors += fail_if( !jh->Parse_errors(), "reuse: parse errors not reported for truncated json" );
+	errors += fail_if( jh->Exists( (char *) "second" ), "reuse: field found after failed parse" );
+
+	state = jh->Parse( (char *) "{ \"third\": 3 }" );
+	errors += fail_if( !state || jh->Value( (char *) "third" ) != 3.0, "reuse: parse after a failed parse did not work" );
 	delete jh;
 
+	// ---- large objects and arrays are indexed on first lookup; last duplicate wins ----------
+	big = "{ ";
+	for( i = 0; i < 500; i++ ) {
+		snprintf( wbuf, sizeof( wbuf ), "\"f%d\": %d, ", i, i );
+		big += wbuf;
+	}
+	big += "\"f7\": 1007, \"list\": [";
+	for( i = 0; i < 100; i++ ) {
+		snprintf( wbuf, sizeof( wbuf ), "%s%d", i > 0 ? ", " : "", i * 2 );
+		big += wbuf;
+	}
+	big += "], \"q\": \"say \\\"hi\\\"\" }";
+
+	jh = new xapp::Jhash( big.c_str() );
+	errors += fail_if( jh->Parse_errors(), "large: parse errors reported" );
+	errors += fail_if( jh->Value( (char *) "f0" ) != 0.0, "large: value for f0 was not right" );
+	errors += fail_if( jh->Value( (char *) "f499" ) != 499.0, "large: value for f499 was not right" );
+	errors += fail_if( jh->Value( (char *) "f7" ) != 1007.0, "large: duplicate name did not return last value" );
+	errors += fail_if( jh->Exists( (char *) "f500" ), "large: non-existant field reported as existing" );
+	errors += fail_if( jh->Array_len( (char *) "list" ) != 100, "large: array length was not right" );
+	errors += fail_if( jh->Value_ele( (char *) "list", 99 ) != 198.0, "large: array element 99 was not right" );
+	errors += fail_if( jh->Value_ele( (char *) "list", 100 ) != 0.0, "large: out of range element was not 0" );
+	errors += fail_if( jh->String( (char *) "q" ) != "say \\\"hi\\\"", "large: string with escaped quotes was not right" );
+	errors += fail_if( jh->Array_len( (char *) "f1" ) != -1, "large: array length of non-array was not -1" );
+	delete jh;
+
+	// ---- nested arrays are parsed, but the inner arrays are not values ---------------------
+	jh = new xapp::Jhash( (char *) "{ \"bad\": [ [ 1, 2, 3 ], [ 3, 4, 5]] }" );
+	errors += fail_if( jh->Parse_errors(), "nested arrays reported parse errors" );
+	errors += fail_if( jh->Array_len( (char *) "bad" ) != 2, "nested array length was not right" );
+	errors += fail_if( jh->Is_value_ele( (char *) "bad", 0 ), "nested array element reported as value" );
+	errors += fail_if( jh->Set_blob_ele( (char *) "bad", 0 ), "set blob to nested array element returned true" );
+	delete jh;
+
+	// ---- the C api in jwrapper is still available --------------------------------------------
+	jstr = read_jstring( (char *) "test.json" );
+	st = jw_new( jstr );
+	errors += fail_if( st == NULL, "jwrapper: parse of test.json failed" );
+	if( st != NULL ) {
+		errors += fail_if( strcmp( jw_string( st, "meeting_day" ), "Tuesday" ) != 0, "jwrapper: meeting day string was not right" );
+		errors += fail_if( jw_value( st, "lodge_number" ) != 41.0, "jwrapper: lodge number was not right" );
+		errors += fail_if( jw_array_len( st, "members" ) != 4, "jwrapper: members array length was not right" );
+		jw_nuke( st );
+	}
+	free( jstr );
+
+	fprintf( stderr, "<INFO> testing for failures; jwrapper error and warning messages expected\n" );
+	// ---- these shouild all fail to parse, generate warnings to stderr, and drive error handling coverage ----
     jh = new xapp::Jhash( (char *) " \"bad\":  5 }" );			// no opening brace
 	state = jh->Parse_errors();
 	errors += fail_if( !state, "parse errors check returned false when known errors exist" );
@@ -271,11 +341,21 @@ int main( int argc, char** argv ) {
     jh = new xapp::Jhash( (char *) "{ \"bad\":  fred }" );		// no quotes
 	delete jh;
 
-    jh = new xapp::Jhash( (char *) "{ \"bad:  456, \"good\": 100 }" );			// missing quote; impossible to detect error
-	jh->Dump();																// but dump should provide details
+    jh = new xapp::Jhash( (char *) "{ \"bad:  456, \"good\": 100 }" );			// missing quote; detected as the colon is missing
+	state = jh->Parse_errors();
+	errors += fail_if( !state, "parse errors check returned false for missing quote" );
+	jh->Dump();																// dump should be safe
 	fprintf( stderr, "<INFO> good value=%d\n", (int) val );
 	delete jh;
 
+    jh = new xapp::Jhash( (char *) "{ \"bad\":  \"no end }" );			// unterminated string
+	errors += fail_if( !jh->Parse_errors(), "parse errors check returned false for unterminated string" );
+	delete jh;
+
+    jh = new xapp::Jhash( (char *) "{ \"bad\":  [ 1, 2 } " );				// mismatched close
+	errors += fail_if( !jh->Parse_errors(), "parse errors check returned false for mismatched brackets" );
+	delete jh;
+
 
 	// ---------------------------- end housekeeping ---------------------------
 	announce_results( errors );
@@ -0,0 +1,284 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	metrics_reg_test.cpp
+	Abstract:	Unit test for the metrics registry: histogram bucket mapping,
+				counters recorded from several threads, gauges, percentiles,
+				capacity overflow, the flush to a metrics message (split
+				when a full registry does not fit in one payload), and the
+				Prometheus exposition (text and over a socket).
+
+	Date:		18 October 2026
+*/
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/default_cb.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/xapp/xapp.hpp"
+#include "../src/json/jhash.hpp"
+
+#include "../src/metrics/metrics_registry.hpp"		// pull the code under test in directly for coverage
+#include "../src/metrics/metrics_registry.cpp"
+
+#include "ut_support.cpp"
+
+#define NTHREADS	4
+#define NINCS		100000
+
+extern "C" {
+	void rmr_em_set_send_cb( void (*cb)( unsigned char* payload, int len, int size ) );
+}
+
+/*
+	Counts of what the flush sent; each payload must fit in the message and
+	be a json document which parses.
+*/
+static int sent_msgs = 0;
+static int sent_entries = 0;
+static int sent_bad = 0;
+
+static void check_sent( unsigned char* payload, int len, int size ) {
+	xapp::Jhash*	jh;
+
+	sent_msgs++;
+	if( len > size || len < 1 || payload[len-1] != 0 ) {
+		fprintf( stderr, "<FAIL> sent len %d is not a terminated string in a payload of %d\n", len, size );
+		sent_bad++;
+		return;
+	}
+
+	jh = new xapp::Jhash( (const char *) payload );
+	if( jh->Parse_errors() || ! jh->Exists( "data" ) ) {
+		fprintf( stderr, "<FAIL> sent payload did not parse: %s\n", (char *) payload );
+		sent_bad++;
+	} else {
+		sent_entries += jh->Array_len( "data" );
+	}
+	delete jh;
+}
+
+void bump( xapp::Counter c, xapp::Histogram h ) {
+	int		i;
+
+	for( i = 0; i < NINCS; i++ ) {
+		c.Inc();
+		h.Record( 100 );
+	}
+}
+
+/*
+	Connect to the exposition port and return what it sends; empty on error.
+*/
+static std::string scrape( int port ) {
+	struct sockaddr_in addr;
+	std::string	rv = "";
+	char	buf[4096];
+	int		fd;
+	int		n;
+
+	if( (fd = socket( AF_INET, SOCK_STREAM, 0 )) < 0 ) {
+		return rv;
+	}
+
+	memset( &addr, 0, sizeof( addr ) );
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons( port );
+	addr.sin_addr.s_addr = inet_addr( "127.0.0.1" );
+	if( connect( fd, (struct sockaddr *) &addr, sizeof( addr ) ) == 0 ) {
+		if( write( fd, "GET /metrics HTTP/1.1\r\n\r\n", 25 ) == 25 ) {
+			while( (n = read( fd, buf, sizeof( buf ) - 1 )) > 0 ) {
+				buf[n] = 0;
+				rv += buf;
+			}
+		}
+	}
+
+	close( fd );
+	return rv;
+}
+
+int main( int argc, char** argv ) {
+	int		errors = 0;
+	int		i;
+	int		bad;
+	unsigned long v;
+	double	p;
+	std::thread*	threads[NTHREADS];
+	xapp::Metrics_registry*	reg;
+	std::string	text;
+	char	wbuf[128];
+
+	set_test_name( "metrics_reg_test" );
+
+	// ---- bucket mapping --------------------------------------------------------
+	bad = 0;
+	for( v = 0; v < 100000; v += (v < 1000 ? 1 : 997) ) {
+		i = xapp::Metrics_registry::Bucket( v );
+		if( xapp::Metrics_registry::Bucket_max( i ) < v ) {						// value must not be over its bucket max
+			bad++;
+		}
+		if( i > 0 && xapp::Metrics_registry::Bucket_max( i - 1 ) >= v ) {		// nor fit in the one below
+			bad++;
+		}
+	}
+	errors += fail_if( bad > 0, "value not mapped to the bucket which covers it" );
+
+	bad = 0;
+	for( i = 0; i < xapp::Metrics_registry::HBUCKETS - 1; i++ ) {
+		if( xapp::Metrics_registry::Bucket( xapp::Metrics_registry::Bucket_max( i ) ) != i ) {
+			bad++;
+		}
+	}
+	errors += fail_if( bad > 0, "bucket max did not map back to the bucket" );
+	errors += fail_if( xapp::Metrics_registry::Bucket( 1UL << 50 ) != xapp::Metrics_registry::HBUCKETS - 1, "huge value not in overflow bucket" );
+
+	// ---- counters from several threads, gauges, histograms ---------------------
+	reg = new xapp::Metrics_registry();
+	auto c = reg->Add_counter( "msgs_received" );
+	auto h = reg->Add_histogram( "hist_threads" );
+	for( i = 0; i < NTHREADS; i++ ) {
+		threads[i] = new std::thread( bump, c, h );
+	}
+	for( i = 0; i < NTHREADS; i++ ) {
+		threads[i]->join();
+		delete threads[i];
+	}
+	errors += fail_if( reg->Get_counter( "msgs_received" ) != NTHREADS * NINCS, "counter total across threads was wrong" );
+	errors += fail_if( reg->Get_hist_count( "hist_threads" ) != NTHREADS * NINCS, "histogram count across threads was wrong" );
+
+	auto c2 = reg->Add_counter( "msgs_received" );							// same name is the same series
+	c2.Add( 10 );
+	errors += fail_if( reg->Get_counter( "msgs_received" ) != NTHREADS * NINCS + 10, "adding existing name did not return the same counter" );
+	errors += fail_if( reg->Get_counter( "no_such_counter" ) != 0, "unknown counter was not 0" );
+
+	auto g = reg->Add_gauge( "queue_depth" );
+	g.Set( 42.5 );
+	errors += fail_if( reg->Get_gauge( "queue_depth" ) != 42.5, "gauge value was wrong" );
+
+	auto lat = reg->Add_histogram( "latency_us" );
+	for( v = 1; v <= 1000; v++ ) {
+		lat.Record( v );
+	}
+	p = reg->Get_percentile( "latency_us", 50.0 );
+	errors += fail_if( p < 500.0 || p > 500.0 * 1.125, "p50 of 1..1000 not within bucket error" );
+	p = reg->Get_percentile( "latency_us", 99.0 );
+	errors += fail_if( p < 990.0 || p > 1000.0, "p99 of 1..1000 not within bucket error or over max" );
+	p = reg->Get_percentile( "latency_us", 100.0 );
+	errors += fail_if( p != 1000.0, "p100 was not the max" );
+	errors += fail_if( reg->Get_percentile( "no_such_hist", 50.0 ) != 0.0, "unknown histogram percentile was not 0" );
+
+	// ---- capacity ---------------------------------------------------------------
+	for( i = 0; i < xapp::Metrics_registry::MAX_COUNTERS + 2; i++ ) {
+		snprintf( wbuf, sizeof( wbuf ), "filler_%d", i );
+		auto fc = reg->Add_counter( wbuf );
+		fc.Inc();															// must be safe past capacity
+	}
+	errors += fail_if( reg->Get_counter( wbuf ) != 0, "counter past capacity was reported" );
+	errors += fail_if( reg->Get_counter( "filler_0" ) != 1, "counter within capacity not reported" );
+
+	// ---- prometheus text ---------------------------------------------------------
+	text = reg->Prometheus_text();
+	errors += fail_if( text.find( "# TYPE msgs_received counter\nmsgs_received 400010\n" ) == std::string::npos, "prometheus text missing counter" );
+	errors += fail_if( text.find( "# TYPE queue_depth gauge\nqueue_depth 42.5\n" ) == std::string::npos, "prometheus text missing gauge" );
+	errors += fail_if( text.find( "latency_us_bucket{le=\"+Inf\"} 1000\n" ) == std::string::npos, "prometheus text missing histogram inf bucket" );
+	errors += fail_if( text.find( "latency_us_bucket{le=\"511\"} 511\n" ) == std::string::npos, "prometheus text missing power of two bucket" );
+	errors += fail_if( text.find( "latency_us_count 1000\n" ) == std::string::npos, "prometheus text missing histogram count" );
+
+	// ---- flush to a metrics message, and the threads -------------------------------
+	auto x = new Xapp( "4560", false );
+	std::shared_ptr<xapp::Metrics> m = x->Alloc_metrics( );
+	errors += fail_if_false( reg->Flush( *m ), "flush send failed" );
+	errors += fail_if_false( reg->Start_flush( m, 100 ), "start flush failed" );
+	errors += fail_if( reg->Start_flush( m, 100 ), "second start flush did not fail" );
+
+	if( reg->Start_exposition( 43090 ) ) {
+		text = scrape( 43090 );
+		errors += fail_if( text.find( "HTTP/1.1 200 OK" ) == std::string::npos, "exposition response was not ok" );
+		errors += fail_if( text.find( "msgs_received 400010" ) == std::string::npos, "exposition response missing counter" );
+	} else {
+		fprintf( stderr, "<WARN> unable to start exposition on 43090; socket test skipped\n" );
+	}
+
+	usleep( 300000 );
+	reg->Stop();
+	delete reg;
+
+	// ---- a full registry is split over messages which each parse ------------------
+	reg = new xapp::Metrics_registry();
+	for( i = 0; i < xapp::Metrics_registry::MAX_HISTOGRAMS; i++ ) {
+		snprintf( wbuf, sizeof( wbuf ), "e2_setup_response_latency_us_%d", i );
+		auto fh = reg->Add_histogram( wbuf );
+		fh.Record( 123456789 );
+	}
+	for( i = 0; i < xapp::Metrics_registry::MAX_COUNTERS; i++ ) {
+		snprintf( wbuf, sizeof( wbuf ), "indications_received_from_node_%d", i );
+		auto fc = reg->Add_counter( wbuf );
+		fc.Add( 1000000000000UL );
+	}
+
+	rmr_em_set_send_cb( check_sent );
+	errors += fail_if_false( reg->Flush( *m ), "flush of a full registry failed" );
+	rmr_em_set_send_cb( NULL );
+	errors += fail_if( sent_bad > 0, "flush of a full registry sent a payload which was not valid json" );
+	errors += fail_if( sent_msgs < 2, "flush of a full registry was not split" );
+	errors += fail_if( sent_entries != xapp::Metrics_registry::MAX_COUNTERS + (6 * xapp::Metrics_registry::MAX_HISTOGRAMS),
+		"flush of a full registry did not send every series" );
+	delete reg;
+
+	// ---- one thread alternating between two registries keeps one block in each ---
+	auto areg1 = new xapp::Metrics_registry();
+	auto areg2 = new xapp::Metrics_registry();
+	std::thread alt( []( xapp::Counter a, xapp::Counter b ) {
+		for( int i = 0; i < 1000; i++ ) {
+			a.Inc();
+			b.Inc();
+		}
+	}, areg1->Add_counter( "alternate" ), areg2->Add_counter( "alternate" ) );
+	alt.join();
+	errors += fail_if( areg1->Get_thread_count() != 1 || areg2->Get_thread_count() != 1, "alternating thread attached more than once to a registry" );
+	errors += fail_if( areg1->Get_counter( "alternate" ) != 1000 || areg2->Get_counter( "alternate" ) != 1000, "alternating counts were wrong" );
+	delete areg1;
+	delete areg2;
+
+	auto& preg = xapp::Metrics_registry::Get_registry();					// process wide instance
+	auto pc = preg.Add_counter( "process_counter" );
+	pc.Inc();
+	errors += fail_if( xapp::Metrics_registry::Get_registry().Get_counter( "process_counter" ) != 1, "process registry was not the same instance" );
+
+	delete x;
+
+	announce_results( errors );
+	return errors > 0;
+}
@@ -0,0 +1,324 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	msg_alloc_test.cpp
+	Abstract:	Unit test which verifies that the receive paths do not allocate
+				from the heap per message once in steady state. All calls to
+				malloc() (and thus new) are counted by wrapping the libc
+				allocator; the count is sampled after a warm up period and
+				again after a burst of messages has been processed.
+
+				The RMR emulation reuses the buffer handed to the receive
+				function, so any allocation seen in the borrowed listen,
+				batch listen and the receive-into paths is made by the
+				framework.
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <memory>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/default_cb.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/xapp/xapp.hpp"
+
+#include "../src/messaging/callback.cpp"		// pull the code under test in directly for coverage
+#include "../src/messaging/default_cb.cpp"
+#include "../src/messaging/message.cpp"
+#include "../src/messaging/messenger.cpp"
+#include "../src/xapp/xapp.cpp"
+
+#include "ut_support.cpp"
+
+// ------------------ allocation counting ---------------------------------------------
+
+static std::atomic<long> heap_allocs( 0 );
+
+extern "C" {
+	extern void* __libc_malloc( size_t size );
+	extern void* __libc_calloc( size_t n, size_t size );
+	extern void* __libc_realloc( void* p, size_t size );
+
+	void* malloc( size_t size ) {
+		heap_allocs++;
+		return __libc_malloc( size );
+	}
+
+	void* calloc( size_t n, size_t size ) {
+		heap_allocs++;
+		return __libc_calloc( n, size );
+	}
+
+	void* realloc( void* p, size_t size ) {
+		heap_allocs++;
+		return __libc_realloc( p, size );
+	}
+}
+
+// ------------------------------------------------------------------------------------
+
+#define WARMUP_MSGS	1000
+#define TEST_MSGS	10000
+#define BATCH_SIZE	16
+
+typedef struct {
+	Xapp*	x;
+	int		count;				// messages seen by the callback
+	int		bad;				// accessor failures
+	long	allocs_start;		// allocation count at end of warmup
+	long	allocs_end;			// allocation count after TEST_MSGS more
+	int		nhealth;			// health checks seen outside of the batch
+} cb_data_t;
+
+/*
+	Callback which uses the non-allocating accessors on every message and
+	stops the listener after the test burst.
+*/
+void counting_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	cb_data_t*	cbd = (cb_data_t *) data;
+	unsigned char meid[RMR_MAX_MEID];
+	unsigned char src[RMR_MAX_SRC];
+	unsigned char pbuf[2048];
+
+	if( m.Get_meid( meid, sizeof( meid ) ) == NULL ||
+		m.Get_src( src, sizeof( src ) ) == NULL ||
+		m.Copy_payload( pbuf, sizeof( pbuf ) ) != len ) {
+		cbd->bad++;
+	}
+
+	cbd->count++;
+	if( cbd->count == WARMUP_MSGS ) {
+		cbd->allocs_start = heap_allocs;
+	} else {
+		if( cbd->count == WARMUP_MSGS + TEST_MSGS ) {
+			cbd->allocs_end = heap_allocs;
+			cbd->x->Halt();
+		}
+	}
+}
+
+/*
+	Batch callback; same checks as the counting callback for every message
+	in the batch, and the whole batch is replied to.
+*/
+void batch_cb( xapp::Message** msgs, int nmsgs, void* data ) {
+	cb_data_t*	cbd = (cb_data_t *) data;
+	unsigned char meid[RMR_MAX_MEID];
+	int		i;
+
+	for( i = 0; i < nmsgs; i++ ) {
+		if( msgs[i]->Get_meid( meid, sizeof( meid ) ) == NULL || msgs[i]->Get_state() != RMR_OK ) {
+			cbd->bad++;
+		}
+		if( msgs[i]->Get_mtype() == RIC_HEALTH_CHECK_REQ ) {
+			cbd->bad++;									// the framework's to answer, not the batch's
+		}
+	}
+
+	if( cbd->x->Reply_batch( msgs, nmsgs ) != nmsgs ) {
+		cbd->bad++;
+	}
+
+	cbd->count += nmsgs;
+	if( cbd->allocs_start == 0 && cbd->count >= WARMUP_MSGS ) {
+		cbd->allocs_start = heap_allocs;
+	} else {
+		if( cbd->allocs_end == 0 && cbd->count >= WARMUP_MSGS + TEST_MSGS ) {
+			cbd->allocs_end = heap_allocs;
+			cbd->x->Halt();
+		}
+	}
+}
+
+/*
+	Health check callback for the batch listener; counts the checks which
+	were taken out of the batch.
+*/
+void health_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	cb_data_t*	cbd = (cb_data_t *) data;
+
+	cbd->nhealth++;
+}
+
+/*
+	Drive the listener with a callback which borrows (or not) the message for
+	all message types, and return the number of allocations made during the
+	test burst.
+*/
+static long listen_allocs( bool borrow, int* bad ) {
+	cb_data_t	cbd;
+	Xapp*		x;
+	long		allocs;
+
+	memset( &cbd, 0, sizeof( cbd ) );
+	x = new Xapp( "4560", false );
+	cbd.x = x;
+	x->Add_msg_cb( x->DEFAULT_CALLBACK, counting_cb, &cbd, borrow );
+	x->Add_msg_cb( RIC_HEALTH_CHECK_REQ, counting_cb, &cbd, borrow );	// emulation generates these too
+
+	x->Listen( );							// returns when the callback halts us
+
+	allocs = cbd.allocs_end - cbd.allocs_start;
+	*bad = cbd.bad;
+	delete x;
+
+	return allocs;
+}
+
+int main( int argc, char** argv ) {
+	int		errors = 0;
+	int		bad;
+	int		i;
+	long	allocs;
+	long	start;
+	std::unique_ptr<xapp::Message> msg;
+	std::unique_ptr<unsigned char> ucs;
+	unsigned char small[4];
+	unsigned char meid[RMR_MAX_MEID];
+	unsigned char src[RMR_MAX_SRC];
+	unsigned char pbuf[2048];
+	std::unique_ptr<xapp::Message> bmsgs[BATCH_SIZE];
+	xapp::Message*	batch[BATCH_SIZE];
+	cb_data_t	cbd;
+	Xapp*	x;
+
+	set_test_name( "msg_alloc_test" );
+
+	// ---- non-allocating accessors return the same things as the allocating ones ----
+	x = new Xapp( "4560", false );
+	msg = x->Alloc_msg( 2048 );
+	snprintf( (char *) msg->Get_payload().get(), 2048, "Hello from the pool" );
+	msg->Set_len( strlen( "Hello from the pool" ) + 1 );
+
+	ucs = msg->Get_meid();
+	errors += fail_if( msg->Get_meid( meid, sizeof( meid ) ) != meid, "get meid into buffer failed" );
+	errors += fail_if( strncmp( (char *) meid, (char *) ucs.get(), RMR_MAX_MEID ) != 0, "meid in buffer differs from copy" );
+	errors += fail_if( msg->Get_meid( small, sizeof( small ) ) != NULL, "get meid into small buffer did not fail" );
+
+	ucs = msg->Get_src();
+	errors += fail_if( msg->Get_src( src, sizeof( src ) ) != src, "get src into buffer failed" );
+	errors += fail_if( strncmp( (char *) src, (char *) ucs.get(), RMR_MAX_SRC ) != 0, "src in buffer differs from copy" );
+	errors += fail_if( msg->Get_src( small, sizeof( small ) ) != NULL, "get src into small buffer did not fail" );
+
+	errors += fail_if( msg->Copy_payload( pbuf, sizeof( pbuf ) ) != msg->Get_len(), "copy payload into buffer returned bad len" );
+	errors += fail_if( strcmp( (char *) pbuf, "Hello from the pool" ) != 0, "copy payload into buffer has wrong contents" );
+	errors += fail_if( msg->Copy_payload( small, sizeof( small ) ) != -1, "copy payload into small buffer did not fail" );
+
+	// ---- receive into an existing message reuses the buffer -----------------------
+	for( i = 0; i < WARMUP_MSGS; i++ ) {
+		x->Receive( *msg, 100 );
+	}
+	start = heap_allocs;
+	bad = 0;
+	for( i = 0; i < TEST_MSGS; i++ ) {
+		if( ! x->Receive( *msg, 100 ) || msg->Get_len() <= 0 ) {
+			bad++;
+		}
+	}
+	allocs = heap_allocs - start;
+	errors += fail_if( bad > 0, "receive into existing message did not return a message" );
+	if( fail_if( allocs != 0, "receive into existing message allocated" ) ) {
+		errors++;
+		fprintf( stderr, "<INFO> %ld allocations for %d received messages\n", allocs, TEST_MSGS );
+	}
+	msg = NULL;
+	delete x;
+
+	// ---- listener with borrowing callback: nothing allocated in steady state ------
+	allocs = listen_allocs( true, &bad );
+	errors += fail_if( bad > 0, "non-allocating accessors failed in borrowed callback" );
+	if( fail_if( allocs != 0, "listener with borrowing callback allocated" ) ) {
+		errors++;
+		fprintf( stderr, "<INFO> %ld allocations for %d messages\n", allocs, TEST_MSGS );
+	}
+
+	/*
+		Without borrowing the buffer is released when the next message arrives
+		and RMR has to supply a new one; the emulation allocates two blocks for
+		each, but the framework must not add its own (the message wrapper).
+	*/
+	allocs = listen_allocs( false, &bad );
+	errors += fail_if( bad > 0, "non-allocating accessors failed in callback" );
+	if( fail_if( allocs > 2 * TEST_MSGS, "listener allocated more than RMR buffers" ) ) {
+		errors++;
+		fprintf( stderr, "<INFO> %ld allocations for %d messages\n", allocs, TEST_MSGS );
+	}
+
+	// ---- batch receive and send reuse the message objects -----------------------
+	x = new Xapp( "4560", false );
+	for( i = 0; i < BATCH_SIZE; i++ ) {
+		bmsgs[i] = x->Alloc_msg( 2048 );
+		batch[i] = bmsgs[i].get();
+	}
+	for( i = 0; i < WARMUP_MSGS / BATCH_SIZE; i++ ) {
+		x->Receive_batch( batch, BATCH_SIZE, 100 );
+	}
+
+	start = heap_allocs;
+	bad = 0;
+	for( i = 0; i < TEST_MSGS / BATCH_SIZE; i++ ) {
+		if( x->Receive_batch( batch, BATCH_SIZE, 100 ) != BATCH_SIZE ) {		// emulation always has more
+			bad++;
+		}
+		if( x->Send_batch( batch, BATCH_SIZE ) != BATCH_SIZE ) {
+			bad++;
+		}
+	}
+	allocs = heap_allocs - start;
+	errors += fail_if( bad > 0, "batch receive or send did not handle a full batch" );
+	if( fail_if( allocs != 0, "batch receive and send allocated" ) ) {
+		errors++;
+		fprintf( stderr, "<INFO> %ld allocations for %d messages\n", allocs, TEST_MSGS );
+	}
+	errors += fail_if( x->Receive_batch( batch, 0, 100 ) != 0, "batch receive of 0 messages did not return 0" );
+	errors += fail_if( x->Send_batch( NULL, 4 ) != 0, "batch send of nil did not return 0" );
+
+	for( i = 0; i < BATCH_SIZE; i++ ) {
+		bmsgs[i] = NULL;
+	}
+	delete x;
+
+	// ---- batch listener: messages and wrappers reused for every batch ------------
+	memset( &cbd, 0, sizeof( cbd ) );
+	x = new Xapp( "4560", false );
+	cbd.x = x;
+	x->Add_batch_cb( batch_cb, &cbd, BATCH_SIZE );
+	x->Add_msg_cb( RIC_HEALTH_CHECK_REQ, health_cb, &cbd );	// emulation generates these too
+	x->Listen( );
+	errors += fail_if( cbd.bad > 0, "batch callback saw bad message, a health check, or reply failed" );
+	errors += fail_if( cbd.nhealth == 0, "health checks not driven through their callback with a batch callback" );
+	if( fail_if( cbd.allocs_end - cbd.allocs_start != 0, "batch listener allocated" ) ) {
+		errors++;
+		fprintf( stderr, "<INFO> %ld allocations for %d messages\n", cbd.allocs_end - cbd.allocs_start, TEST_MSGS );
+	}
+	delete x;
+
+	announce_results( errors );
+	return errors > 0;
+}
@@ -0,0 +1,209 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	rest_bench.cpp
+	Abstract:	Loopback load test for the REST server and client. A server
+				with a GET and a POST route is started on the loopback
+				interface and driven by the client: first with the blocking
+				calls (a new connection for each request), then with the
+				async calls on the pooled client keeping a number of requests
+				in flight. Requests per second and the median and p99
+				latencies are reported for each.
+
+				Usage:
+					rest_bench [-n requests] [-c in-flight] [-t threads] [-l listeners] [-p port]
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/rest-server/pistacheserver.h"
+#include "../src/rest-client/RestClient.h"
+
+static double mono_sec( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static void get_cb( const Pistache::Rest::Request &request, Pistache::Http::ResponseWriter response ) {
+	response.send( Pistache::Http::Code::Ok, "{\"state\": \"ok\"}" );
+}
+
+static void post_cb( const Pistache::Rest::Request &request, Pistache::Http::ResponseWriter response ) {
+	response.send( Pistache::Http::Code::Created, request.body() );
+}
+
+/*
+	Sort the latencies (seconds) and report rate, p50 and p99.
+*/
+static void report( const char* label, std::vector<double>& lat, long errors, double elapsed ) {
+	if( lat.empty() ) {
+		fprintf( stdout, "%-28s no responses; %ld errors\n", label, errors );
+		return;
+	}
+
+	std::sort( lat.begin(), lat.end() );
+	fprintf( stdout, "%-28s %8ld req %10.0f req/s  p50 %8.1f us  p99 %8.1f us  %ld errors\n", label,
+		(long) lat.size(), (double) lat.size() / elapsed,
+		lat[lat.size() / 2] * 1000000.0, lat[(lat.size() * 99) / 100] * 1000000.0, errors );
+}
+
+int main( int argc, char** argv ) {
+	int		nreq = 10000;
+	int		inflight = 64;
+	int		nthreads = 4;
+	int		nlisteners = 2;
+	int		port = 43086;
+	int		opt;
+	int		i;
+	long	errors;
+	double	start;
+	std::vector<double> lat;
+
+	while( (opt = getopt( argc, argv, "n:c:t:l:p:" )) != -1 ) {
+		switch( opt ) {
+			case 'n':	nreq = atoi( optarg ); break;
+			case 'c':	inflight = atoi( optarg ); break;
+			case 't':	nthreads = atoi( optarg ); break;
+			case 'l':	nlisteners = atoi( optarg ); break;
+			case 'p':	port = atoi( optarg ); break;
+			default:
+				fprintf( stderr, "usage: %s [-n requests] [-c in-flight] [-t threads] [-l listeners] [-p port]\n", argv[0] );
+				exit( 1 );
+		}
+	}
+	if( inflight < 1 ) {
+		inflight = 1;
+	}
+
+	// ---- server: GET and POST on /ric/v1/bench --------------------------------------------
+	Pistache::Address addr( Pistache::Ipv4::loopback(), Pistache::Port( port ) );
+	std::vector<std::string> methods = { "get", "post" };
+	std::vector<bool> stat = { true, true };
+	std::vector<bool> dyn = { false, false };
+	xapp::pistacheserver srv( addr, methods, stat, dyn );
+
+	srv.setup_static_route( std::unordered_map<int,std::string>{ { 1, "/bench" }, { 2, "/bench" } } );
+	srv.add_static_cb( std::unordered_map<int,xapp::usr_callback>{ { 1, get_cb }, { 2, post_cb } } );
+	srv.init( nthreads, nlisteners, xapp::pistacheserver::DEF_KEEPALIVE );
+	srv.start();
+	sleep( 1 );
+
+	xapp::cpprestclient client( "http://127.0.0.1:" + std::to_string( port ) );
+	nlohmann::json body = { { "subscription", "bench" }, { "count", 1 } };
+
+	// ---- blocking calls; each is a new connection ------------------------------------------
+	int nsync = nreq / 10 > 0 ? nreq / 10 : 1;				// slow and noisy; a sample is enough
+	errors = 0;
+	lat.clear();
+	start = mono_sec();
+	for( i = 0; i < nsync; i++ ) {
+		double rs = mono_sec();
+		xapp::response_t res = client.do_get( "/ric/v1/bench" );
+		if( res.status_code != 200 ) {
+			errors++;
+		} else {
+			lat.push_back( mono_sec() - rs );
+		}
+	}
+	report( "sync get", lat, errors, mono_sec() - start );
+
+	// ---- async futures, pooled; a window of requests in flight ----------------------------
+	{
+		std::vector<std::future<xapp::response_t>> fut( inflight );
+		std::vector<double> sent( inflight );
+		int		slot;
+
+		errors = 0;
+		lat.clear();
+		start = mono_sec();
+		for( i = 0; i < nreq + inflight; i++ ) {
+			slot = i % inflight;
+			if( i >= inflight ) {								// wait on the oldest before reusing its slot
+				xapp::response_t res = fut[slot].get();
+				if( res.status_code != 200 ) {
+					errors++;
+				} else {
+					lat.push_back( mono_sec() - sent[slot] );
+				}
+			}
+			if( i < nreq ) {
+				sent[slot] = mono_sec();
+				fut[slot] = client.do_get_async( "/ric/v1/bench" );
+			}
+		}
+		report( "async get (futures)", lat, errors, mono_sec() - start );
+	}
+
+	// ---- async callbacks, pooled; POST ------------------------------------------------------
+	{
+		std::mutex	mtx;
+		std::condition_variable	cv;
+		std::atomic<int> outstanding( 0 );
+		std::atomic<long> cb_errors( 0 );
+
+		lat.clear();
+		start = mono_sec();
+		for( i = 0; i < nreq; i++ ) {
+			{
+				std::unique_lock<std::mutex> lk( mtx );
+				cv.wait( lk, [&]{ return outstanding.load() < inflight; } );
+			}
+			outstanding++;
+
+			double rs = mono_sec();
+			client.do_post_async( body, "/ric/v1/bench", [&, rs]( xapp::response_t res ) {
+				double now = mono_sec();
+				std::unique_lock<std::mutex> lk( mtx );
+				if( res.status_code != 201 ) {
+					cb_errors++;
+				} else {
+					lat.push_back( now - rs );
+				}
+				outstanding--;
+				cv.notify_one();
+			} );
+		}
+		{
+			std::unique_lock<std::mutex> lk( mtx );
+			cv.wait( lk, [&]{ return outstanding.load() == 0; } );
+		}
+		report( "async post (callbacks)", lat, cb_errors, mono_sec() - start );
+	}
+
+	srv.shutdown();
+	return 0;
+}
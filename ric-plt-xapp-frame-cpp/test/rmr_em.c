@@ -22,6 +22,16 @@
 	Mnemonic:	rmr_em.c
 	Abstract:	RMR emulation for testing
 
+				For benchmarks a load can be set (rmr_em_set_load()) which
+				changes receive to deliver a fixed number of messages of a
+				given type, size and content at a controlled rate, and has
+				return to sender and send record the time from when each
+				message was due to arrive to the reply. Without a load the
+				emulation behaves as it always has.
+
+				A test may also register a function (rmr_em_set_send_cb())
+				which is given the payload of every message sent.
+
 	Date:		20 March
 	Author:		E. Scott Daniels
 */
@@ -29,6 +39,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <malloc.h>
+#include <time.h>
 
 
 /*
@@ -60,8 +71,38 @@ typedef struct {
 typedef struct {
 	char meid[32];
 	char src[32];
+	long long stamp;			// load: ns when the message was due to arrive; 0 once replied to
 } header_t;
 
+/*
+	Load generator state; see rmr_em_set_load().
+*/
+static struct {
+	int			on;
+	long		nmsgs;				// messages to deliver
+	int			rate;				// msgs/sec; 0 is as fast as asked for
+	int			mtype;
+	int			len;
+	unsigned char* tmpl;			// payload copied into each message
+	long long	start;				// ns; the first message is due
+	long		next;				// next message slot (atomic)
+	long		nreplies;			// messages replied to (atomic)
+	long long*	lat;				// ns from due to reply, one per reply
+} load;
+
+/*
+	Called with each sent payload, its length and the payload size; see
+	rmr_em_set_send_cb().
+*/
+static void (*send_cb)( unsigned char* payload, int len, int size ) = NULL;
+
+static long long em_now_ns( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ((long long) ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+}
+
 
 void* rmr_init( char* port, int flags ) {
 	return malloc( sizeof( char ) * 100 );
@@ -89,12 +130,10 @@ rmr_mbuf_t* rmr_alloc_msg( void* mrc, int payload_len ) {
 	memset( mbuf, 0, sizeof( rmr_mbuf_t ) );
 
 	mbuf->tp_buf = p;
-	mbuf->payload = (char *)p + sizeof( header_t );
-
+	mbuf->payload = (char *)p + sizeof( header_t );		// after the header so writes don't trash meid/src
 
 	mbuf->len = 0;
 	mbuf->alloc_len = payload_len;
-	mbuf->payload = (void *) p;
 	strncpy( h->src, "host:ip", 8 );
 	strncpy( h->meid, "EniMeini", 9 );
 
@@ -167,9 +206,39 @@ int rmr_str2meid( rmr_mbuf_t* mbuf, unsigned char* s ) {
 	return 1;
 }
 
+/*
+	When a load is running, record the latency of the first reply to a
+	generated message.
+*/
+static void em_reply_stamp( rmr_mbuf_t* mbuf ) {
+	header_t*	h;
+	long		i;
+
+	h = (header_t *) mbuf->tp_buf;
+	if( load.on && h->stamp != 0 ) {
+		i = __atomic_fetch_add( &load.nreplies, 1, __ATOMIC_RELAXED );
+		if( i < load.nmsgs ) {
+			load.lat[i] = em_now_ns() - h->stamp;
+		}
+		h->stamp = 0;
+	}
+}
+
+/*
+	Register a function to be driven with the payload of each message sent
+	(nil turns it off).
+*/
+void rmr_em_set_send_cb( void (*cb)( unsigned char* payload, int len, int size ) ) {
+	send_cb = cb;
+}
+
 rmr_mbuf_t* rmr_send_msg( void* mrc, rmr_mbuf_t* mbuf ) {
 
 	if( mbuf != NULL ) {
+		em_reply_stamp( mbuf );
+		if( send_cb != NULL ) {
+			send_cb( mbuf->payload, mbuf->len, mbuf->alloc_len );
+		}
 		mbuf->state = 0;
 	}
 
@@ -179,6 +248,7 @@ rmr_mbuf_t* rmr_send_msg( void* mrc, rmr_mbuf_t* mbuf ) {
 rmr_mbuf_t* rmr_rts_msg( void* mrc, rmr_mbuf_t* mbuf ) {
 
 	if( mbuf != NULL ) {
+		em_reply_stamp( mbuf );
 		mbuf->state = 0;
 	}
 
@@ -212,10 +282,102 @@ void rmr_close( void*  mrc ) {
 	return;
 }
 
+/*
+	Receive when a load is set. Each message takes the next slot; with a rate
+	the slot is due at start + slot/rate and the caller is held until then, so
+	a framework which falls behind accumulates the delay in the latencies of
+	later messages (it is not hidden by the generator slowing down). Once all
+	have been delivered the receive times out after a short nap.
+*/
+static rmr_mbuf_t* em_load_rcv( rmr_mbuf_t* mbuf, int timeout ) {
+	struct timespec ts;
+	header_t*	h;
+	long		slot;
+	long long	due;
+
+	if( mbuf != NULL && mbuf->alloc_len < load.len ) {
+		rmr_free_msg( mbuf );
+		mbuf = NULL;
+	}
+	if( mbuf == NULL ) {
+		mbuf = rmr_alloc_msg( NULL, load.len > 2048 ? load.len : 2048 );
+	}
+
+	slot = __atomic_fetch_add( &load.next, 1, __ATOMIC_RELAXED );
+	if( slot >= load.nmsgs ) {
+		usleep( timeout > 0 ? 1000 : 0 );
+		mbuf->state = 12;					// RMR_ERR_TIMEOUT
+		mbuf->len = 0;
+		return mbuf;
+	}
+
+	if( load.rate > 0 ) {
+		due = load.start + (slot * 1000000000LL) / load.rate;
+		ts.tv_sec = due / 1000000000LL;
+		ts.tv_nsec = due % 1000000000LL;
+		while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL ) != 0 );
+	} else {
+		due = em_now_ns();
+	}
+
+	memcpy( mbuf->payload, load.tmpl, load.len );
+	h = (header_t *) mbuf->tp_buf;
+	h->stamp = due;
+	mbuf->state = 0;
+	mbuf->len = load.len;
+	mbuf->mtype = load.mtype;
+	mbuf->sub_id = -1;
+
+	return mbuf;
+}
+
+/*
+	Set a load: nmsgs messages of type mtype carrying the len bytes of
+	payload, delivered at rate msgs/sec (0 for as fast as they are received).
+	Starts now; any previous load's latencies are discarded. Nmsgs of 0
+	turns the load off.
+*/
+void rmr_em_set_load( long nmsgs, int rate, int mtype, const unsigned char* payload, int len ) {
+	free( load.tmpl );
+	free( load.lat );
+	memset( &load, 0, sizeof( load ) );
+
+	if( nmsgs <= 0 ) {
+		return;
+	}
+
+	load.nmsgs = nmsgs;
+	load.rate = rate;
+	load.mtype = mtype;
+	load.len = len;
+	load.tmpl = (unsigned char *) malloc( len > 0 ? len : 1 );
+	memcpy( load.tmpl, payload, len );
+	load.lat = (long long *) malloc( sizeof( long long ) * nmsgs );
+	load.start = em_now_ns();
+	load.on = 1;
+}
+
+/*
+	Return the number of generated messages replied to, and the latency
+	(ns) of each in the order that the replies were made. The array is
+	owned by the emulation and valid until the load is next set.
+*/
+long rmr_em_load_replies( ) {
+	return __atomic_load_n( &load.nreplies, __ATOMIC_RELAXED );
+}
+
+long long* rmr_em_load_latencies( ) {
+	return load.lat;
+}
+
 rmr_mbuf_t* rmr_torcv_msg( void* mrc, rmr_mbuf_t* mbuf, int timeout ) {
 	static int max2receive = 500;
 	static int mtype = 0;
 
+	if( load.on ) {
+		return em_load_rcv( mbuf, timeout );
+	}
+
 	if( mbuf == NULL ) {
 		mbuf = rmr_alloc_msg( NULL, 2048 );
 	}
@@ -272,9 +434,9 @@ extern rmr_mbuf_t* rmr_wh_send_msg( void* vctx, rmr_whid_t whid, rmr_mbuf_t* mbu
 	if( mbuf != NULL ) {
 		if( whid >= 0 ) {
 			mbuf->state = 0;
+		} else {
+			mbuf->state = 7;
 		}
-
-		mbuf->state = 7;
 	}
 
 	return mbuf;
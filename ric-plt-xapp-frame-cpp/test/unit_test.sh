@@ -118,7 +118,7 @@ echo "tests successfully built" >&2
 spew="cat"
 
 # order here is important to ensure coverage files accumulate
-tests="metrics_test jhash_test config_test  unit_test"
+tests="metrics_test jhash_test config_test  unit_test msg_alloc_test dispatch_test cb_table_test metrics_reg_test alarm_mgr_test"
 
 #run everything, then generate coverage stats after all have run
 for x in $tests
@@ -0,0 +1,275 @@
+// vim: ts=4 sw=4 noet :
+/*
+==================================================================================
+	Copyright (c) 2020 Nokia
+	Copyright (c) 2020 AT&T Intellectual Property.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+==================================================================================
+*/
+
+/*
+	Mnemonic:	xapp_bench.cpp
+	Abstract:	End to end framework benchmark. An Xapp is driven by the RMR
+				emulation's load generator (rmr_em.c) with a fixed number of
+				messages of a given size, optionally at a fixed rate, and
+				each message is replied to from its callback. For each
+				callback flavour and each Run(nthreads) setting the
+				throughput, the process CPU used per message, and the
+				latency from when the message was due to arrive until the
+				reply was sent are reported.
+
+				Callback flavours:
+					echo	reply only: receive, dispatch, wrap and reply
+					json	parse the payload (a reused Jhash per thread) and
+							pick a value out of it before replying
+					full	json plus a counter and a histogram update in
+							a metrics registry
+
+				With a rate the generator is open loop; messages are due on
+				schedule whether or not the xAPP has kept up, so queueing
+				shows in the percentiles. Without a rate the numbers are the
+				framework's best case cost. Rated runs also include the time
+				the generator takes to wake for each message, which is the
+				floor of the latencies reported.
+
+				Nothing here needs RMR or a network, so runs are repeatable
+				and can be compared between builds.
+
+				Usage:
+					xapp_bench [-n msgs] [-r rate] [-s size] [-t threads,...] [-m flavour,...]
+
+	Date:		18 October 2026
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/messaging/callback.hpp"
+#include "../src/messaging/message.hpp"
+#include "../src/messaging/messenger.hpp"
+#include "../src/messaging/msg_component.hpp"
+#include "../src/metrics/metrics.hpp"
+#include "../src/metrics/metrics_registry.hpp"
+#include "../src/json/jhash.hpp"
+#include "../src/xapp/xapp.hpp"
+
+extern "C" {
+	void rmr_em_set_load( long nmsgs, int rate, int mtype, const unsigned char* payload, int len );
+	long rmr_em_load_replies( );
+	long long* rmr_em_load_latencies( );
+}
+
+#define BENCH_MTYPE	30000
+
+#define FL_ECHO		0
+#define FL_JSON		1
+#define FL_FULL		2
+
+typedef struct {
+	Xapp*	x;
+	long	nmsgs;
+	int		flavour;
+	xapp::Counter*	count;
+	xapp::Histogram* sizes;
+} bench_t;
+
+static double mono_sec( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+static double cpu_sec( ) {
+	struct timespec ts;
+
+	clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts );
+	return (double) ts.tv_sec + ((double) ts.tv_nsec / 1000000000.0);
+}
+
+/*
+	The callback. Each listener thread keeps its own jhash (and buffer) and
+	reparses into it; this is what an xAPP handling json payloads should do.
+*/
+static void bench_cb( xapp::Message& m, int mtype, int subid, int len, xapp::Msg_component payload, void* data ) {
+	static thread_local std::unique_ptr<xapp::Jhash> jh;
+	static thread_local std::string buf;
+	bench_t*	bd = (bench_t *) data;
+	double		v = 0;
+
+	if( bd->flavour != FL_ECHO ) {
+		buf.assign( (const char *) payload.get(), len );			// payload isn't nil terminated
+		if( jh == NULL ) {
+			jh = std::unique_ptr<xapp::Jhash>( new xapp::Jhash( buf.c_str() ) );
+		} else {
+			jh->Parse( buf.c_str() );
+		}
+
+		if( jh->Set_blob( "kpi" ) ) {
+			v = jh->Value( "prb" );
+			jh->Unset_blob();
+		}
+		if( v < 0 ) {
+			fprintf( stderr, "<BENCH> bad prb value\n" );
+		}
+
+		if( bd->flavour == FL_FULL ) {
+			bd->count->Inc();
+			bd->sizes->Record( len );
+		}
+	}
+
+	m.Reply();
+	if( rmr_em_load_replies() >= bd->nmsgs ) {
+		bd->x->Halt();
+	}
+}
+
+/*
+	Build the payload: a small json document padded out to size bytes.
+*/
+static std::string mk_payload( int size ) {
+	std::string	pl;
+	int		pad;
+
+	pl = "{ \"meid\": \"gnb-0001\", \"seq\": 4217, \"kpi\": { \"prb\": 42, \"thp\": 1234.5, \"ues\": 17 }, \"pad\": \"";
+	pad = size - (int) pl.size() - 3;
+	if( pad > 0 ) {
+		pl += std::string( pad, 'x' );
+	}
+	pl += "\" }";
+
+	return pl;
+}
+
+/*
+	Run one flavour with nthreads listeners and report.
+*/
+static void run( const char* label, int flavour, int nthreads, long nmsgs, int rate, const std::string& pl ) {
+	xapp::Metrics_registry reg;
+	xapp::Counter	count = reg.Add_counter( "bench_msgs" );
+	xapp::Histogram	sizes = reg.Add_histogram( "bench_size" );
+	bench_t	bd;
+	double	start;
+	double	cpu;
+	double	elapsed;
+	long	n;
+	std::vector<long long> lat;
+
+	bd.x = new Xapp( "4560", false );
+	bd.nmsgs = nmsgs;
+	bd.flavour = flavour;
+	bd.count = &count;
+	bd.sizes = &sizes;
+	bd.x->Add_msg_cb( BENCH_MTYPE, bench_cb, &bd, true );
+
+	rmr_em_set_load( nmsgs, rate, BENCH_MTYPE, (const unsigned char *) pl.c_str(), (int) pl.size() );
+	cpu = cpu_sec();
+	start = mono_sec();
+	bd.x->Run( nthreads );
+	elapsed = mono_sec() - start;
+	cpu = cpu_sec() - cpu;
+
+	n = rmr_em_load_replies();
+	if( n > nmsgs ) {
+		n = nmsgs;
+	}
+	lat.assign( rmr_em_load_latencies(), rmr_em_load_latencies() + n );
+	std::sort( lat.begin(), lat.end() );
+	rmr_em_set_load( 0, 0, 0, NULL, 0 );
+
+	if( n > 0 ) {
+		fprintf( stdout, "%-6s %3d thr %9ld msgs %11.0f msgs/s %8.2f cpu-us/msg   p50 %9.1f  p99 %9.1f  p99.9 %9.1f  max %9.1f us\n",
+			label, nthreads, n, (double) n / elapsed, (cpu * 1000000.0) / (double) n,
+			lat[n / 2] / 1000.0, lat[(n * 99) / 100] / 1000.0, lat[(n * 999) / 1000] / 1000.0, lat[n - 1] / 1000.0 );
+	}
+
+	delete bd.x;
+}
+
+/*
+	Split a comma separated list.
+*/
+static std::vector<std::string> split( const char* s ) {
+	std::vector<std::string> v;
+	std::stringstream ss( s );
+	std::string tok;
+
+	while( std::getline( ss, tok, ',' ) ) {
+		if( ! tok.empty() ) {
+			v.push_back( tok );
+		}
+	}
+
+	return v;
+}
+
+int main( int argc, char** argv ) {
+	long	nmsgs = 200000;
+	int		rate = 0;
+	int		size = 256;
+	int		opt;
+	const char*	threads = "1,2,4";
+	const char*	flavours = "echo,json,full";
+	std::string	pl;
+
+	while( (opt = getopt( argc, argv, "n:r:s:t:m:" )) != -1 ) {
+		switch( opt ) {
+			case 'n':	nmsgs = atol( optarg ); break;
+			case 'r':	rate = atoi( optarg ); break;
+			case 's':	size = atoi( optarg ); break;
+			case 't':	threads = optarg; break;
+			case 'm':	flavours = optarg; break;
+			default:
+				fprintf( stderr, "usage: %s [-n msgs] [-r rate] [-s size] [-t threads,...] [-m echo,json,full]\n", argv[0] );
+				exit( 1 );
+		}
+	}
+
+	pl = mk_payload( size );
+	fprintf( stdout, "%ld msgs of %d bytes, rate %s\n", nmsgs, (int) pl.size(), rate > 0 ? std::to_string( rate ).c_str() : "unlimited" );
+
+	for( auto& f : split( flavours ) ) {
+		int flavour;
+
+		if( f == "echo" ) {
+			flavour = FL_ECHO;
+		} else if( f == "json" ) {
+			flavour = FL_JSON;
+		} else if( f == "full" ) {
+			flavour = FL_FULL;
+		} else {
+			fprintf( stderr, "unknown flavour: %s\n", f.c_str() );
+			continue;
+		}
+
+		for( auto& t : split( threads ) ) {
+			int nthreads = atoi( t.c_str() );
+			if( nthreads > 0 ) {
+				run( f.c_str(), flavour, nthreads, nmsgs, rate, pl );
+			}
+		}
+	}
+
+	return 0;
+}